@@ -8,14 +8,46 @@
 #include <hobbycad/core.h>
 #include <hobbycad/brep_io.h>
 #include <hobbycad/document.h>
+#include <hobbycad/memory.h>
+#include <hobbycad/png_writer.h>
+#include <hobbycad/project.h>
+#include <hobbycad/snapshot.h>
+#include <hobbycad/step_io.h>
+#include <hobbycad/stl_io.h>
+#include <hobbycad/thumbnail.h>
+#include <hobbycad/brep/clash.h>
+#include <hobbycad/brep/operations.h>
+#include <hobbycad/brep/slice.h>
+#include <hobbycad/mesh/clash.h>
+#include <hobbycad/mesh/repair.h>
+#include <hobbycad/mesh/slice.h>
+#include <hobbycad/sketch/contour_fit.h>
+#include <hobbycad/sketch/export.h>
+#include <hobbycad/sketch/lint.h>
 #include <hobbycad/sketch/parsing.h>
+#include <hobbycad/sketch/profiles.h>
 
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QRegularExpression>
 #include <QTextStream>
 
+#include <BRepBndLib.hxx>
+#include <BRep_Builder.hxx>
+#include <Bnd_Box.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS_Compound.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <unordered_map>
+
 namespace hobbycad {
 
 CliEngine::CliEngine(CliHistory& history)
@@ -34,7 +66,16 @@ QStringList CliEngine::commandNames() const
         QStringLiteral("save"),
         QStringLiteral("convert"),
         QStringLiteral("script"),
+        QStringLiteral("snapshot"),
+        QStringLiteral("thumbnail"),
+        QStringLiteral("repair"),
+        QStringLiteral("extrude"),
+        QStringLiteral("revolve"),
+        QStringLiteral("lint"),
+        QStringLiteral("clash"),
+        QStringLiteral("slice"),
         QStringLiteral("info"),
+        QStringLiteral("stats"),
         QStringLiteral("new"),
         QStringLiteral("cd"),
         QStringLiteral("pwd"),
@@ -312,16 +353,19 @@ QStringList CliEngine::completeArguments(const QStringList& tokens,
     if (cmd == QLatin1String("convert")) {
         if (argIndex == 1) {
             if (prefix.isEmpty()) {
-                return { QStringLiteral("?<input>  Input file (.brep, .hcad, or directory)") };
+                return { QStringLiteral("?<input>  Input file (.brep, .step, .stl, .hcad, or directory)") };
             }
             if (prefix == QLatin1String("--")) {
-                return { QStringLiteral("--format"), QStringLiteral("--help") };
+                return { QStringLiteral("--format"), QStringLiteral("--max-triangles"),
+                         QStringLiteral("--max-error"), QStringLiteral("--no-dedup"),
+                         QStringLiteral("--help") };
             }
         }
         else if (argIndex == 2) {
             // Check if previous arg was --format
             if (tokens.size() > 1 && tokens[tokens.size()-1] == QLatin1String("--format")) {
-                return { QStringLiteral("brep"), QStringLiteral("hcad") };
+                return { QStringLiteral("brep"), QStringLiteral("hcad"), QStringLiteral("step"),
+                         QStringLiteral("stl") };
             }
             if (prefix.isEmpty()) {
                 return { QStringLiteral("?<output>  Output file or directory") };
@@ -330,6 +374,210 @@ QStringList CliEngine::completeArguments(const QStringList& tokens,
         return {};
     }
 
+    // ---- snapshot command ----
+    if (cmd == QLatin1String("snapshot")) {
+        if (argIndex == 1) {
+            if (prefix.isEmpty()) {
+                return { QStringLiteral("?<project>  Project directory") };
+            }
+            if (prefix.startsWith(QLatin1Char('-'))) {
+                return { QStringLiteral("--help") };
+            }
+        }
+        else if (argIndex == 2) {
+            QStringList actions = { QStringLiteral("list"), QStringLiteral("take"),
+                                    QStringLiteral("restore"), QStringLiteral("diff") };
+            QStringList matches;
+            for (const auto& a : actions) {
+                if (a.startsWith(prefix)) matches.append(a);
+            }
+            return matches;
+        }
+        else if (argIndex >= 3 && prefix.isEmpty() && tokens.size() > 2) {
+            QString action = tokens[2];
+            if (action == QLatin1String("take"))
+                return { QStringLiteral("?[message]  Snapshot message") };
+            if (action == QLatin1String("restore"))
+                return { QStringLiteral("?<id>  Snapshot id (see 'snapshot <project> list')") };
+            if (action == QLatin1String("diff"))
+                return { QStringLiteral("?<from> <to>  Snapshot ids to compare") };
+        }
+        return {};
+    }
+
+    // ---- thumbnail command ----
+    if (cmd == QLatin1String("thumbnail")) {
+        // The previous word decides what an option value should be
+        int previousIndex = prefix.isEmpty() ? tokens.size() - 1 : tokens.size() - 2;
+        QString previous = previousIndex >= 1 ? tokens[previousIndex] : QString();
+        if (previous == QLatin1String("--view")) {
+            QStringList views = { QStringLiteral("iso"), QStringLiteral("front"),
+                                  QStringLiteral("back"), QStringLiteral("left"),
+                                  QStringLiteral("right"), QStringLiteral("top"),
+                                  QStringLiteral("bottom") };
+            QStringList matches;
+            for (const auto& v : views) {
+                if (v.startsWith(prefix)) matches.append(v);
+            }
+            return matches;
+        }
+        if (previous == QLatin1String("--size") && prefix.isEmpty())
+            return { QStringLiteral("?<W>x<H>  Image size in pixels (e.g. 512x384)") };
+        if (previous == QLatin1String("--background") && prefix.isEmpty())
+            return { QStringLiteral("?<#RRGGBB|transparent>  Background colour") };
+        if (prefix.startsWith(QLatin1Char('-'))) {
+            QStringList options = { QStringLiteral("--size"), QStringLiteral("--view"),
+                                    QStringLiteral("--azimuth"), QStringLiteral("--elevation"),
+                                    QStringLiteral("--supersample"), QStringLiteral("--background"),
+                                    QStringLiteral("--no-edges"), QStringLiteral("--no-sketches"),
+                                    QStringLiteral("--single-thread"), QStringLiteral("--help") };
+            QStringList matches;
+            for (const auto& o : options) {
+                if (o.startsWith(prefix)) matches.append(o);
+            }
+            return matches;
+        }
+        if (prefix.isEmpty()) {
+            return { QStringLiteral("?<input> <output.png>  Project, .brep or .step file and image path") };
+        }
+        return {};
+    }
+
+    // ---- repair command ----
+    if (cmd == QLatin1String("repair")) {
+        if (prefix.startsWith(QLatin1Char('-'))) {
+            QStringList options = { QStringLiteral("--tolerance"), QStringLiteral("--max-hole"),
+                                    QStringLiteral("--min-component"), QStringLiteral("--keep-largest"),
+                                    QStringLiteral("--no-fill"), QStringLiteral("--no-self-intersections"),
+                                    QStringLiteral("--ascii"), QStringLiteral("--single-thread"),
+                                    QStringLiteral("--help") };
+            QStringList matches;
+            for (const auto& o : options) {
+                if (o.startsWith(prefix)) matches.append(o);
+            }
+            return matches;
+        }
+        if (prefix.isEmpty()) {
+            return { QStringLiteral("?<input.stl> [output]  Mesh to repair, and .stl or .brep to write") };
+        }
+        return {};
+    }
+
+    // ---- extrude / revolve commands ----
+    if (cmd == QLatin1String("extrude") || cmd == QLatin1String("revolve")) {
+        bool revolve = cmd == QLatin1String("revolve");
+        if (prefix.startsWith(QLatin1Char('-'))) {
+            QStringList options = { QStringLiteral("--sketch"), QStringLiteral("--compare"),
+                                    QStringLiteral("--help") };
+            if (revolve) {
+                options << QStringLiteral("--axis") << QStringLiteral("--angle");
+            } else {
+                options << QStringLiteral("--distance") << QStringLiteral("--symmetric")
+                        << QStringLiteral("--reverse");
+            }
+            QStringList matches;
+            for (const auto& o : options) {
+                if (o.startsWith(prefix)) matches.append(o);
+            }
+            return matches;
+        }
+        if (prefix.isEmpty()) {
+            return { QStringLiteral("?<project> [output]  Project, and .brep, .step or .stl to write") };
+        }
+        return {};
+    }
+
+    // ---- lint command ----
+    if (cmd == QLatin1String("lint")) {
+        if (prefix.startsWith(QLatin1Char('-'))) {
+            QStringList options = { QStringLiteral("--sketch"), QStringLiteral("--near"),
+                                    QStringLiteral("--gap"), QStringLiteral("--angle"),
+                                    QStringLiteral("--fix"), QStringLiteral("--no-dedupe"),
+                                    QStringLiteral("--no-merge"), QStringLiteral("--no-weld"),
+                                    QStringLiteral("--limit"), QStringLiteral("--help") };
+            QStringList matches;
+            for (const auto& o : options) {
+                if (o.startsWith(prefix)) matches.append(o);
+            }
+            return matches;
+        }
+        if (prefix.isEmpty()) {
+            return { QStringLiteral("?<input> [output]  Project or .dxf to check, and where to write fixes") };
+        }
+        return {};
+    }
+
+    // ---- clash command ----
+    if (cmd == QLatin1String("clash")) {
+        if (prefix.startsWith(QLatin1Char('-'))) {
+            QStringList options = { QStringLiteral("--clearance"), QStringLiteral("--tolerance"),
+                                    QStringLiteral("--mesh"), QStringLiteral("--no-volumes"),
+                                    QStringLiteral("--limit"), QStringLiteral("--single-thread"),
+                                    QStringLiteral("--help") };
+            QStringList matches;
+            for (const auto& o : options) {
+                if (o.startsWith(prefix)) matches.append(o);
+            }
+            return matches;
+        }
+        if (prefix.isEmpty()) {
+            return { QStringLiteral("?<input>  Project, .brep, .step or .stl with the bodies to check") };
+        }
+        return {};
+    }
+
+    // ---- slice command ----
+    if (cmd == QLatin1String("slice")) {
+        if (prefix.startsWith(QLatin1Char('-'))) {
+            QStringList options = { QStringLiteral("--axis"), QStringLiteral("--count"),
+                                    QStringLiteral("--step"), QStringLiteral("--from"),
+                                    QStringLiteral("--to"), QStringLiteral("--format"),
+                                    QStringLiteral("--mesh"), QStringLiteral("--tolerance"),
+                                    QStringLiteral("--no-arcs"), QStringLiteral("--single-thread"),
+                                    QStringLiteral("--help") };
+            QStringList matches;
+            for (const auto& o : options) {
+                if (o.startsWith(prefix)) matches.append(o);
+            }
+            return matches;
+        }
+        if (prefix.isEmpty()) {
+            return { QStringLiteral("?<input> [output]  Bodies to slice, and the layer directory or project") };
+        }
+        return {};
+    }
+
+    // ---- stats command ----
+    if (cmd == QLatin1String("stats")) {
+        int previousIndex = prefix.isEmpty() ? tokens.size() - 1 : tokens.size() - 2;
+        QString previous = previousIndex >= 1 ? tokens[previousIndex] : QString();
+        if (previous == QLatin1String("--budget")) {
+            QStringList counters;
+            for (int i = 0; i < memory::kTagCount; ++i) {
+                counters.append(QString::fromLatin1(memory::tagName(static_cast<memory::Tag>(i))));
+            }
+            counters << QStringLiteral("total") << QStringLiteral("heap") << QStringLiteral("rss");
+            QStringList matches;
+            for (const auto& c : counters) {
+                if (c.startsWith(prefix)) matches.append(c + QLatin1Char('='));
+            }
+            return matches;
+        }
+        if (prefix.startsWith(QLatin1Char('-'))) {
+            QStringList options = { QStringLiteral("--budget"), QStringLiteral("--json"),
+                                    QStringLiteral("--reset-peaks"), QStringLiteral("--help") };
+            QStringList matches;
+            for (const auto& o : options) {
+                if (o.startsWith(prefix)) matches.append(o);
+            }
+            return matches;
+        }
+        if (prefix.isEmpty()) {
+            return { QStringLiteral("?[input]  Project, .brep, .step or .stl file to load first") };
+        }
+        return {};
+    }
+
     // ---- script command ----
     if (cmd == QLatin1String("script")) {
         if (argIndex == 1) {
@@ -678,6 +926,15 @@ CliResult CliEngine::execute(const QString& line)
     if (cmd == QLatin1String("save"))    return cmdSave(tokens.mid(1));
     if (cmd == QLatin1String("convert")) return cmdConvert(tokens.mid(1));
     if (cmd == QLatin1String("script"))  return cmdScript(tokens.mid(1));
+    if (cmd == QLatin1String("snapshot")) return cmdSnapshot(tokens.mid(1));
+    if (cmd == QLatin1String("thumbnail")) return cmdThumbnail(tokens.mid(1));
+    if (cmd == QLatin1String("repair"))  return cmdRepair(tokens.mid(1));
+    if (cmd == QLatin1String("extrude")) return cmdExtrude(tokens.mid(1));
+    if (cmd == QLatin1String("revolve")) return cmdRevolve(tokens.mid(1));
+    if (cmd == QLatin1String("lint"))    return cmdLint(tokens.mid(1));
+    if (cmd == QLatin1String("clash"))   return cmdClash(tokens.mid(1));
+    if (cmd == QLatin1String("slice"))   return cmdSlice(tokens.mid(1));
+    if (cmd == QLatin1String("stats"))   return cmdStats(tokens.mid(1));
     if (cmd == QLatin1String("cd"))      return cmdCd(tokens.mid(1));
     if (cmd == QLatin1String("pwd"))     return cmdPwd();
     if (cmd == QLatin1String("info"))    return cmdInfo();
@@ -724,11 +981,20 @@ CliResult CliEngine::cmdHelp() const
         "  save <file>             Save to a BREP file (.brep added if no extension)\n"
         "  convert <in> <out>      Convert between file formats\n"
         "  script <file>           Execute a script file\n"
+        "  snapshot <dir> [action] List, take, restore or diff project snapshots\n"
+        "  thumbnail <in> <out>    Render a project or model to a PNG image\n"
+        "  repair <in> [out]       Check and heal an STL mesh\n"
+        "  extrude <dir> [out]     Extrude a project sketch, holes included\n"
+        "  revolve <dir> [out]     Revolve a project sketch, holes included\n"
+        "  lint <in> [out]         Find and fix duplicates, overlaps and gaps in sketches\n"
+        "  clash <in>              Find bodies that interfere, touch or are too close\n"
+        "  slice <in> [out]        Cut bodies into layers as DXF, SVG or sketches\n"
         "\n"
         "Information:\n"
         "  help                    Show this help message\n"
         "  version                 Show HobbyCAD version\n"
         "  info                    Show current document info\n"
+        "  stats [file]            Show memory use by owner and check budgets\n"
         "\n"
         "Navigation:\n"
         "  cd [dir]                Change working directory (no arg = home)\n"
@@ -880,14 +1146,22 @@ CliResult CliEngine::cmdConvert(const QStringList& args)
             "Options:\n"
             "  -h, --help               Show this help message\n"
             "  --format <fmt>           Force output format (auto-detected from extension)\n"
+            "  --max-triangles <n>      Decimate meshes to at most n triangles\n"
+            "  --max-error <d>          Limit decimation error to d model units\n"
+            "  --no-dedup               Write every STEP body as its own part\n"
             "\n"
             "Supported Formats:\n"
             "  .hcad                    HobbyCAD project\n"
             "  .brep, .brp              OpenCASCADE BREP\n"
+            "  .step, .stp              STEP (written as an assembly)\n"
+            "  .stl                     STL mesh (binary)\n"
             "\n"
             "Examples:\n"
             "  convert model.brep project/\n"
-            "  convert myproject/ export.brep");
+            "  convert myproject/ export.brep\n"
+            "  convert scan.stl reduced.stl --max-triangles 200000\n"
+            "  convert model.brep model.stl --max-error 0.05\n"
+            "  convert pattern.brep pattern.step");
         return r;
     }
 
@@ -896,9 +1170,31 @@ CliResult CliEngine::cmdConvert(const QStringList& args)
     QString outputPath;
     QString format;
 
+    int maxTriangles = 0;
+    double maxError = 0.0;
+    bool deduplicate = true;
+
     for (int i = 0; i < args.size(); ++i) {
         if (args[i] == QLatin1String("--format") && i + 1 < args.size()) {
             format = args[++i];
+        } else if (args[i] == QLatin1String("--max-triangles") && i + 1 < args.size()) {
+            bool ok = false;
+            maxTriangles = args[++i].toInt(&ok);
+            if (!ok || maxTriangles <= 0) {
+                r.exitCode = 1;
+                r.error = QStringLiteral("Invalid triangle count: ") + args[i];
+                return r;
+            }
+        } else if (args[i] == QLatin1String("--max-error") && i + 1 < args.size()) {
+            bool ok = false;
+            maxError = args[++i].toDouble(&ok);
+            if (!ok || maxError <= 0.0) {
+                r.exitCode = 1;
+                r.error = QStringLiteral("Invalid error bound: ") + args[i];
+                return r;
+            }
+        } else if (args[i] == QLatin1String("--no-dedup")) {
+            deduplicate = false;
         } else if (!args[i].startsWith(QLatin1Char('-'))) {
             if (inputPath.isEmpty()) {
                 inputPath = args[i];
@@ -930,23 +1226,31 @@ CliResult CliEngine::cmdConvert(const QStringList& args)
                           inputPath.endsWith(QStringLiteral(".hcad"), Qt::CaseInsensitive);
     bool inputIsBrep = inputPath.endsWith(QStringLiteral(".brep"), Qt::CaseInsensitive) ||
                        inputPath.endsWith(QStringLiteral(".brp"), Qt::CaseInsensitive);
+    bool inputIsStl = stl_io::isStlFile(inputPath.toStdString());
+    bool inputIsStep = step_io::isStepFile(inputPath.toStdString());
 
     // Determine output type (from format flag or extension)
     bool outputIsProject = false;
     bool outputIsBrep = false;
+    bool outputIsStl = false;
+    bool outputIsStep = false;
 
     if (!format.isEmpty()) {
         outputIsProject = format.toLower() == QLatin1String("hcad");
         outputIsBrep = format.toLower() == QLatin1String("brep");
+        outputIsStl = format.toLower() == QLatin1String("stl");
+        outputIsStep = format.toLower() == QLatin1String("step");
     } else {
         outputIsProject = outputPath.endsWith(QStringLiteral("/")) ||
                           outputPath.endsWith(QStringLiteral(".hcad"), Qt::CaseInsensitive);
         outputIsBrep = outputPath.endsWith(QStringLiteral(".brep"), Qt::CaseInsensitive) ||
                        outputPath.endsWith(QStringLiteral(".brp"), Qt::CaseInsensitive);
+        outputIsStl = stl_io::isStlFile(outputPath.toStdString());
+        outputIsStep = step_io::isStepFile(outputPath.toStdString());
     }
 
     // Default to BREP if no format detected
-    if (!outputIsProject && !outputIsBrep) {
+    if (!outputIsProject && !outputIsBrep && !outputIsStl && !outputIsStep) {
         outputIsBrep = true;
         if (!outputPath.contains(QLatin1Char('.'))) {
             outputPath += QStringLiteral(".brep");
@@ -956,14 +1260,41 @@ CliResult CliEngine::cmdConvert(const QStringList& args)
     // Read input
     std::vector<TopoDS_Shape> shapes;
     std::string err;
-
-    if (inputIsBrep) {
+    Handle(Poly_Triangulation) inputMesh;
+    int decimatedFrom = 0;
+
+    if (inputIsStl) {
+        // Meshes are decimated on import, so every output format
+        // gets the reduced mesh
+        stl_io::ReadOptions options;
+        options.decimate = maxTriangles > 0 || maxError > 0.0;
+        options.decimateOptions.targetTriangles = maxTriangles;
+        options.decimateOptions.maxError = maxError;
+
+        stl_io::ReadResult read = stl_io::readStl(inputPath.toStdString(), options);
+        if (!read.success) {
+            r.exitCode = 1;
+            r.error = QStringLiteral("Failed to read input: ") +
+                      QString::fromStdString(read.errorMessage);
+            return r;
+        }
+        inputMesh = read.mesh;
+        decimatedFrom = read.decimatedFrom;
+        shapes.push_back(read.shape);
+    } else if (inputIsBrep) {
         shapes = brep_io::readBrep(inputPath.toStdString(), &err);
         if (shapes.empty() && !err.empty()) {
             r.exitCode = 1;
             r.error = QStringLiteral("Failed to read input: ") + QString::fromStdString(err);
             return r;
         }
+    } else if (inputIsStep) {
+        shapes = step_io::readStep(inputPath.toStdString(), &err);
+        if (shapes.empty()) {
+            r.exitCode = 1;
+            r.error = QStringLiteral("Failed to read input: ") + QString::fromStdString(err);
+            return r;
+        }
     } else if (inputIsProject) {
         // TODO: Load from project
         r.exitCode = 1;
@@ -976,7 +1307,45 @@ CliResult CliEngine::cmdConvert(const QStringList& args)
     }
 
     // Write output
-    if (outputIsBrep) {
+    QString partSummary;
+    if (outputIsStep) {
+        std::vector<step_io::AssemblyBody> bodies;
+        for (const TopoDS_Shape& shape : shapes) {
+            step_io::AssemblyBody body;
+            body.shape = shape;
+            bodies.push_back(body);
+        }
+        step_io::AssemblyOptions options;
+        options.deduplicate = deduplicate;
+
+        step_io::WriteResult written =
+            step_io::writeStepAssembly(outputPath.toStdString(), bodies, options);
+        if (!written.success) {
+            r.exitCode = 1;
+            r.error = QStringLiteral("Failed to write output: ") +
+                      QString::fromStdString(written.errorMessage);
+            return r;
+        }
+        partSummary = QStringLiteral("\nParts: %1 (%2 instance(s))")
+                          .arg(written.partCount).arg(written.instanceCount);
+    } else if (outputIsStl) {
+        stl_io::WriteResult written;
+        if (!inputMesh.IsNull()) {
+            written = stl_io::writeStlMesh(outputPath.toStdString(), inputMesh);
+        } else {
+            stl_io::MeshQuality quality = stl_io::defaultQuality();
+            quality.maxTriangles = maxTriangles;
+            quality.maxError = maxError;
+            written = stl_io::writeStl(outputPath.toStdString(), shapes,
+                                       stl_io::StlFormat::Binary, quality);
+        }
+        if (!written.success) {
+            r.exitCode = 1;
+            r.error = QStringLiteral("Failed to write output: ") +
+                      QString::fromStdString(written.errorMessage);
+            return r;
+        }
+    } else if (outputIsBrep) {
         if (!brep_io::writeBrep(outputPath.toStdString(), shapes, &err)) {
             r.exitCode = 1;
             r.error = QStringLiteral("Failed to write output: ") + QString::fromStdString(err);
@@ -991,6 +1360,1632 @@ CliResult CliEngine::cmdConvert(const QStringList& args)
 
     r.output = QStringLiteral("Converted: %1 -> %2 (%3 shape(s))")
                    .arg(inputPath, outputPath).arg(shapes.size());
+    r.output += partSummary;
+    if (decimatedFrom > 0) {
+        r.output += QStringLiteral("\nDecimated: %1 -> %2 triangles")
+                        .arg(decimatedFrom).arg(inputMesh->NbTriangles());
+    }
+    return r;
+}
+
+CliResult CliEngine::cmdSnapshot(const QStringList& args)
+{
+    CliResult r;
+
+    if (args.isEmpty() || args[0] == QLatin1String("--help") ||
+                          args[0] == QLatin1String("-h")) {
+        r.output = QStringLiteral(
+            "Usage: snapshot <project> [list [n] | take [message] |\n"
+            "                           restore <id> | diff <from> <to>]\n"
+            "\n"
+            "Manage the content-addressed snapshot history of a project.\n"
+            "\n"
+            "Actions:\n"
+            "  list [n]                 List the newest n snapshots (default: all)\n"
+            "  take [message]           Record the project's saved state\n"
+            "  restore <id>             Restore project files to a snapshot\n"
+            "  diff <from> <to>         Summarize file changes between snapshots\n"
+            "\n"
+            "Examples:\n"
+            "  snapshot myproject/ list 10\n"
+            "  snapshot myproject/ take \"Before fillets\"\n"
+            "  snapshot myproject/ diff 1a2b3c4 5d6e7f8");
+        if (args.isEmpty()) r.exitCode = 1;
+        return r;
+    }
+
+    if (!snapshot::SnapshotStore::isAvailable()) {
+        r.exitCode = 1;
+        r.error = QStringLiteral("Snapshot history is not available (built without libgit2).");
+        return r;
+    }
+
+    // Accept the manifest path as well as the project directory
+    QString projectDir = args[0];
+    if (projectDir.endsWith(QStringLiteral(".hcad"), Qt::CaseInsensitive) &&
+        QFileInfo(projectDir).isFile()) {
+        projectDir = QFileInfo(projectDir).absolutePath();
+    }
+
+    snapshot::SnapshotStore store;
+    std::string err;
+    if (!store.open(projectDir.toStdString(), &err)) {
+        r.exitCode = 1;
+        r.error = QStringLiteral("Error: ") + QString::fromStdString(err);
+        return r;
+    }
+
+    QString action = args.size() > 1 ? args[1].toLower() : QStringLiteral("list");
+    QStringList lines;
+
+    if (action == QLatin1String("list")) {
+        int maxCount = args.size() > 2 ? args[2].toInt() : -1;
+        const auto snapshots = store.listSnapshots(maxCount > 0 ? maxCount : -1);
+        if (snapshots.empty()) {
+            r.output = QStringLiteral("No snapshots.");
+            return r;
+        }
+        for (const auto& info : snapshots) {
+            lines << QStringLiteral("%1  %2  %3")
+                         .arg(QString::fromStdString(info.shortId),
+                              QDateTime::fromSecsSinceEpoch(info.time)
+                                  .toString(QStringLiteral("yyyy-MM-dd HH:mm:ss")),
+                              QString::fromStdString(info.message));
+        }
+        r.output = lines.join(QLatin1Char('\n'));
+        return r;
+    }
+
+    if (action == QLatin1String("take")) {
+        QString message = args.size() > 2 ? args.mid(2).join(QLatin1Char(' '))
+                                          : QStringLiteral("Snapshot");
+        auto result = store.takeSnapshot(message.toStdString());
+        if (!result.success) {
+            r.exitCode = 1;
+            r.error = QStringLiteral("Error: ") + QString::fromStdString(result.errorMessage);
+            return r;
+        }
+        QString shortId = QString::fromStdString(result.id).left(7);
+        if (result.created) {
+            r.output = QStringLiteral("Snapshot %1: %2 file(s), %3 new to the store")
+                           .arg(shortId).arg(result.filesTotal).arg(result.filesStored);
+        } else {
+            r.output = QStringLiteral("No changes since snapshot %1").arg(shortId);
+        }
+        return r;
+    }
+
+    if (action == QLatin1String("restore")) {
+        if (args.size() < 3) {
+            r.exitCode = 1;
+            r.error = QStringLiteral("Usage: snapshot <project> restore <id>");
+            return r;
+        }
+        if (!store.restoreSnapshot(args[2].toStdString(), &err)) {
+            r.exitCode = 1;
+            r.error = QStringLiteral("Error: ") + QString::fromStdString(err);
+            return r;
+        }
+        r.output = QStringLiteral("Restored snapshot %1").arg(args[2]);
+        return r;
+    }
+
+    if (action == QLatin1String("diff")) {
+        if (args.size() < 4) {
+            r.exitCode = 1;
+            r.error = QStringLiteral("Usage: snapshot <project> diff <from> <to>");
+            return r;
+        }
+        auto summary = store.diff(args[2].toStdString(), args[3].toStdString());
+        if (!summary.success) {
+            r.exitCode = 1;
+            r.error = QStringLiteral("Error: ") + QString::fromStdString(summary.errorMessage);
+            return r;
+        }
+        lines << QStringLiteral("%1 added, %2 modified, %3 deleted, %4 renamed")
+                     .arg(summary.added).arg(summary.modified)
+                     .arg(summary.deleted).arg(summary.renamed);
+        for (const auto& change : summary.changes) {
+            QString line = QStringLiteral("  ") +
+                QString::fromStdString(snapshot::changeKindName(change.kind)).leftJustified(9) +
+                QString::fromStdString(change.path);
+            if (change.kind == snapshot::ChangeKind::Renamed) {
+                line += QStringLiteral(" (from %1)").arg(QString::fromStdString(change.oldPath));
+            }
+            lines << line;
+        }
+        r.output = lines.join(QLatin1Char('\n'));
+        return r;
+    }
+
+    r.exitCode = 1;
+    r.error = QStringLiteral("Unknown snapshot action: ") + action +
+              QStringLiteral("\nRun 'snapshot --help' for usage.");
+    return r;
+}
+
+CliResult CliEngine::cmdThumbnail(const QStringList& args)
+{
+    CliResult r;
+
+    // Check for help flag
+    if (!args.isEmpty() && (args[0] == QLatin1String("--help") ||
+                            args[0] == QLatin1String("-h"))) {
+        r.output = QStringLiteral(
+            "Usage: thumbnail [options] <input> <output.png>\n"
+            "\n"
+            "Render a project or model to a PNG image without opening a window.\n"
+            "\n"
+            "Arguments:\n"
+            "  <input>                  Project (.hcad or directory), .brep or .step file\n"
+            "  <output.png>             Image to write (.png added if no extension)\n"
+            "\n"
+            "Options:\n"
+            "  -h, --help               Show this help message\n"
+            "  --size <W>x<H>           Image size in pixels (default: 256x256)\n"
+            "  --view <name>            iso, front, back, left, right, top, bottom\n"
+            "                           (default: iso)\n"
+            "  --azimuth <deg>          Custom view: angle around Z from +X\n"
+            "  --elevation <deg>        Custom view: angle above the XY plane\n"
+            "  --supersample <n>        Anti-aliasing samples per axis, 1-4 (default: 2)\n"
+            "  --background <colour>    #RRGGBB or 'transparent' (default)\n"
+            "  --no-edges               Do not draw model edges\n"
+            "  --no-sketches            Do not draw project sketches\n"
+            "  --single-thread          Render on the calling thread only\n"
+            "\n"
+            "Examples:\n"
+            "  thumbnail myproject/ preview.png\n"
+            "  thumbnail --size 512x384 --view top part.step top.png\n"
+            "  thumbnail --background #ffffff --azimuth 30 --elevation 20 model.brep model.png");
+        return r;
+    }
+
+    thumbnail::RenderOptions options;
+    QString inputPath;
+    QString outputPath;
+    bool customAngle = false;
+
+    auto fail = [&r](const QString& message) {
+        r.exitCode = 1;
+        r.error = message;
+        return r;
+    };
+
+    for (int i = 0; i < args.size(); ++i) {
+        const QString& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+
+        if (arg == QLatin1String("--size") && hasValue) {
+            QStringList parts = args[++i].toLower().split(QLatin1Char('x'));
+            bool okW = false, okH = false;
+            if (parts.size() == 2) {
+                options.width = parts[0].toInt(&okW);
+                options.height = parts[1].toInt(&okH);
+            }
+            if (!okW || !okH || options.width <= 0 || options.height <= 0)
+                return fail(QStringLiteral("Invalid size: ") + args[i] +
+                            QStringLiteral(" (expected <W>x<H>, e.g. 512x384)"));
+        } else if (arg == QLatin1String("--view") && hasValue) {
+            if (!thumbnail::viewDirectionFromName(args[++i].toStdString(), &options.view))
+                return fail(QStringLiteral("Unknown view: ") + args[i]);
+        } else if ((arg == QLatin1String("--azimuth") ||
+                    arg == QLatin1String("--elevation")) && hasValue) {
+            bool ok = false;
+            double degrees = args[++i].toDouble(&ok);
+            if (!ok) return fail(QStringLiteral("Invalid angle: ") + args[i]);
+            if (arg == QLatin1String("--azimuth")) options.azimuth = degrees;
+            else options.elevation = degrees;
+            customAngle = true;
+        } else if (arg == QLatin1String("--supersample") && hasValue) {
+            bool ok = false;
+            options.supersample = args[++i].toInt(&ok);
+            if (!ok || options.supersample < 1 || options.supersample > 4)
+                return fail(QStringLiteral("Supersample must be between 1 and 4"));
+        } else if (arg == QLatin1String("--background") && hasValue) {
+            QString colour = args[++i];
+            if (colour.compare(QLatin1String("transparent"), Qt::CaseInsensitive) == 0) {
+                options.background.a = 0;
+            } else {
+                bool ok = false;
+                uint rgb = colour.startsWith(QLatin1Char('#')) && colour.size() == 7
+                               ? colour.mid(1).toUInt(&ok, 16) : 0;
+                if (!ok) return fail(QStringLiteral("Invalid colour: ") + colour +
+                                     QStringLiteral(" (expected #RRGGBB or 'transparent')"));
+                options.background = { static_cast<uint8_t>(rgb >> 16),
+                                       static_cast<uint8_t>(rgb >> 8),
+                                       static_cast<uint8_t>(rgb), 255 };
+            }
+        } else if (arg == QLatin1String("--no-edges")) {
+            options.drawEdges = false;
+        } else if (arg == QLatin1String("--no-sketches")) {
+            options.drawSketches = false;
+        } else if (arg == QLatin1String("--single-thread")) {
+            options.parallel = false;
+        } else if (!arg.startsWith(QLatin1Char('-'))) {
+            if (inputPath.isEmpty()) {
+                inputPath = arg;
+            } else if (outputPath.isEmpty()) {
+                outputPath = arg;
+            }
+        }
+    }
+
+    if (inputPath.isEmpty() || outputPath.isEmpty()) {
+        return fail(QStringLiteral(
+            "Usage: thumbnail [options] <input> <output.png>\n"
+            "\n"
+            "Run 'thumbnail --help' for more options."));
+    }
+    if (customAngle) options.view = thumbnail::ViewDirection::Custom;
+    if (QFileInfo(outputPath).suffix().isEmpty()) outputPath += QStringLiteral(".png");
+
+    QFileInfo inputInfo(inputPath);
+    if (!inputInfo.exists())
+        return fail(QStringLiteral("Input file not found: ") + inputPath);
+
+    // Read input and render
+    std::string err;
+    thumbnail::RenderResult result;
+
+    if (inputInfo.isDir() ||
+        inputPath.endsWith(QStringLiteral(".hcad"), Qt::CaseInsensitive)) {
+        Project project;
+        if (!project.load(inputPath.toStdString(), &err))
+            return fail(QStringLiteral("Failed to load project: ") + QString::fromStdString(err));
+        result = thumbnail::renderProject(project, options);
+    } else {
+        std::vector<TopoDS_Shape> shapes;
+        if (inputPath.endsWith(QStringLiteral(".brep"), Qt::CaseInsensitive) ||
+            inputPath.endsWith(QStringLiteral(".brp"), Qt::CaseInsensitive)) {
+            shapes = brep_io::readBrep(inputPath.toStdString(), &err);
+        } else if (step_io::isStepFile(inputPath.toStdString())) {
+            shapes = step_io::readStep(inputPath.toStdString(), &err);
+        } else {
+            return fail(QStringLiteral("Unknown input format: ") + inputPath);
+        }
+        if (shapes.empty() && !err.empty())
+            return fail(QStringLiteral("Failed to read input: ") + QString::fromStdString(err));
+        result = thumbnail::renderShapes(shapes, options);
+    }
+
+    if (!result.success)
+        return fail(QStringLiteral("Render failed: ") + QString::fromStdString(result.errorMessage));
+
+    if (!writePng(outputPath.toStdString(), result.image, &err))
+        return fail(QStringLiteral("Failed to write image: ") + QString::fromStdString(err));
+
+    r.output = QStringLiteral("Wrote %1 (%2x%3, %4 triangles, %5 ms)")
+                   .arg(outputPath)
+                   .arg(result.image.width)
+                   .arg(result.image.height)
+                   .arg(result.triangleCount)
+                   .arg(result.milliseconds, 0, 'f', 0);
+    return r;
+}
+
+CliResult CliEngine::cmdRepair(const QStringList& args)
+{
+    CliResult r;
+
+    // Check for help flag
+    if (!args.isEmpty() && (args[0] == QLatin1String("--help") ||
+                            args[0] == QLatin1String("-h"))) {
+        r.output = QStringLiteral(
+            "Usage: repair [options] <input.stl> [output]\n"
+            "\n"
+            "Check an STL mesh for defects and optionally write a healed copy.\n"
+            "Without an output file only the defect report is printed.\n"
+            "\n"
+            "Arguments:\n"
+            "  <input.stl>              Mesh to check\n"
+            "  [output]                 .stl (repaired mesh) or .brep (solid)\n"
+            "\n"
+            "Options:\n"
+            "  -h, --help               Show this help message\n"
+            "  --tolerance <mm>         Vertex weld distance (default: 1e-6 of size)\n"
+            "  --max-hole <edges>       Leave holes with more edges open\n"
+            "  --min-component <n>      Drop components with fewer triangles\n"
+            "  --keep-largest           Keep only the largest component\n"
+            "  --no-fill                Do not fill holes\n"
+            "  --no-self-intersections  Do not remove self-intersections\n"
+            "  --ascii                  Write ASCII STL (default: binary)\n"
+            "  --single-thread          Repair on the calling thread only\n"
+            "\n"
+            "Examples:\n"
+            "  repair scan.stl\n"
+            "  repair --keep-largest scan.stl fixed.stl\n"
+            "  repair --max-hole 200 part.stl part.brep");
+        return r;
+    }
+
+    mesh::RepairOptions options;
+    bool ascii = false;
+    QString inputPath;
+    QString outputPath;
+
+    auto fail = [&r](const QString& message) {
+        r.exitCode = 1;
+        r.error = message;
+        return r;
+    };
+
+    for (int i = 0; i < args.size(); ++i) {
+        const QString& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        bool ok = true;
+
+        if (arg == QLatin1String("--tolerance") && hasValue) {
+            options.weldTolerance = args[++i].toDouble(&ok);
+            if (!ok || options.weldTolerance < 0.0)
+                return fail(QStringLiteral("Invalid tolerance: ") + args[i]);
+        } else if (arg == QLatin1String("--max-hole") && hasValue) {
+            options.maxHoleEdges = args[++i].toInt(&ok);
+            if (!ok || options.maxHoleEdges < 0)
+                return fail(QStringLiteral("Invalid hole size: ") + args[i]);
+        } else if (arg == QLatin1String("--min-component") && hasValue) {
+            options.minComponentTriangles = args[++i].toInt(&ok);
+            if (!ok || options.minComponentTriangles < 0)
+                return fail(QStringLiteral("Invalid component size: ") + args[i]);
+        } else if (arg == QLatin1String("--keep-largest")) {
+            options.keepLargestComponentOnly = true;
+        } else if (arg == QLatin1String("--no-fill")) {
+            options.fillHoles = false;
+        } else if (arg == QLatin1String("--no-self-intersections")) {
+            options.removeSelfIntersections = false;
+        } else if (arg == QLatin1String("--ascii")) {
+            ascii = true;
+        } else if (arg == QLatin1String("--single-thread")) {
+            options.parallel = false;
+        } else if (!arg.startsWith(QLatin1Char('-'))) {
+            if (inputPath.isEmpty()) {
+                inputPath = arg;
+            } else if (outputPath.isEmpty()) {
+                outputPath = arg;
+            }
+        }
+    }
+
+    if (inputPath.isEmpty()) {
+        return fail(QStringLiteral(
+            "Usage: repair [options] <input.stl> [output]\n"
+            "\n"
+            "Run 'repair --help' for more options."));
+    }
+    if (!QFileInfo::exists(inputPath))
+        return fail(QStringLiteral("Input file not found: ") + inputPath);
+    if (!stl_io::isStlFile(inputPath.toStdString()))
+        return fail(QStringLiteral("Unknown input format: ") + inputPath +
+                    QStringLiteral(" (expected .stl)"));
+
+    stl_io::ReadResult read = stl_io::readStl(inputPath.toStdString());
+    if (!read.success)
+        return fail(QStringLiteral("Failed to read input: ") +
+                    QString::fromStdString(read.errorMessage));
+
+    mesh::TriangleMesh input = mesh::fromTriangulation(read.mesh);
+
+    auto line = [](const char* label, int value) {
+        return QStringLiteral("  ") + QString::fromLatin1(label).leftJustified(26) +
+               QString::number(value) + QLatin1Char('\n');
+    };
+
+    // Report only
+    if (outputPath.isEmpty()) {
+        mesh::DefectSummary s = mesh::analyze(input, options);
+        QString out = QStringLiteral("%1: %2 triangles, %3 vertices\n")
+                          .arg(inputPath).arg(s.inputTriangles).arg(s.inputVertices);
+        out += line("Coincident vertices:", s.weldedVertices);
+        out += line("Degenerate triangles:", s.degenerateTriangles);
+        out += line("Duplicate triangles:", s.duplicateTriangles);
+        out += line("Non-manifold edges:", s.nonManifoldEdges);
+        out += line("Components:", s.components);
+        out += line("Misoriented triangles:", s.flippedTriangles);
+        out += line("Self-intersecting tris:", s.selfIntersectingTriangles);
+        out += line("Holes:", s.holes);
+        out += line("Open edges:", s.openEdges);
+        out += s.watertight ? QStringLiteral("Mesh is watertight.")
+                            : QStringLiteral("Mesh needs repair.");
+        r.output = out;
+        return r;
+    }
+
+    mesh::RepairResult result = mesh::repair(input, options);
+    if (!result.success)
+        return fail(QStringLiteral("Repair failed: ") + QString::fromStdString(result.errorMessage));
+
+    std::string err;
+    if (outputPath.endsWith(QStringLiteral(".brep"), Qt::CaseInsensitive) ||
+        outputPath.endsWith(QStringLiteral(".brp"), Qt::CaseInsensitive)) {
+        TopoDS_Shape solid = mesh::toSolid(result.mesh, &err);
+        if (solid.IsNull() || !brep_io::writeBrep(outputPath.toStdString(), solid, &err))
+            return fail(QStringLiteral("Failed to write output: ") + QString::fromStdString(err));
+    } else {
+        if (QFileInfo(outputPath).suffix().isEmpty()) outputPath += QStringLiteral(".stl");
+        stl_io::WriteResult written = stl_io::writeStlMesh(
+            outputPath.toStdString(), mesh::toTriangulation(result.mesh),
+            ascii ? stl_io::StlFormat::Ascii : stl_io::StlFormat::Binary);
+        if (!written.success)
+            return fail(QStringLiteral("Failed to write output: ") +
+                        QString::fromStdString(written.errorMessage));
+    }
+
+    const mesh::DefectSummary& s = result.summary;
+    QString out = QStringLiteral("Repaired %1 -> %2 (%3 ms)\n")
+                      .arg(inputPath, outputPath)
+                      .arg(result.milliseconds, 0, 'f', 0);
+    out += line("Vertices welded:", s.weldedVertices);
+    out += line("Degenerate removed:", s.degenerateTriangles);
+    out += line("Duplicates removed:", s.duplicateTriangles);
+    out += line("Non-manifold edges fixed:", s.nonManifoldEdges);
+    out += line("Components kept:", s.components - s.removedComponents);
+    out += line("Triangles reoriented:", s.flippedTriangles);
+    out += line("Self-intersections cut:", s.selfIntersectingTriangles);
+    out += line("Holes filled:", s.filledHoles);
+    out += line("Triangles out:", s.outputTriangles);
+    out += s.watertight ? QStringLiteral("Result is watertight.")
+                        : QStringLiteral("Result still has %1 open edge(s).").arg(s.openEdges);
+    r.output = out;
+    return r;
+}
+
+// Shared by 'extrude' and 'revolve': every region of a project sketch,
+// holes included, is built as a single prism or revolution
+static CliResult profileSolidCommand(const QStringList& args, bool revolve)
+{
+    CliResult r;
+
+    auto fail = [&r](const QString& message) {
+        r.exitCode = 1;
+        r.error = message;
+        return r;
+    };
+
+    QString inputPath;
+    QString outputPath;
+    QString sketchName;
+    double distance = 10.0;
+    double angle = 360.0;
+    bool symmetric = false;
+    bool reverse = false;
+    bool compare = false;
+    gp_Dir axisDir(0, 1, 0);
+
+    for (int i = 0; i < args.size(); ++i) {
+        const QString& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        bool ok = true;
+
+        if (arg == QLatin1String("--sketch") && hasValue) {
+            sketchName = args[++i];
+        } else if (!revolve && arg == QLatin1String("--distance") && hasValue) {
+            distance = args[++i].toDouble(&ok);
+            if (!ok || distance <= 0.0)
+                return fail(QStringLiteral("Invalid distance: ") + args[i]);
+        } else if (!revolve && arg == QLatin1String("--symmetric")) {
+            symmetric = true;
+        } else if (!revolve && arg == QLatin1String("--reverse")) {
+            reverse = true;
+        } else if (revolve && arg == QLatin1String("--axis") && hasValue) {
+            QString axis = args[++i].toLower();
+            if (axis == QLatin1String("x")) {
+                axisDir = gp_Dir(1, 0, 0);
+            } else if (axis == QLatin1String("y")) {
+                axisDir = gp_Dir(0, 1, 0);
+            } else {
+                return fail(QStringLiteral("Invalid axis: ") + args[i] +
+                            QStringLiteral(" (expected x or y)"));
+            }
+        } else if (revolve && arg == QLatin1String("--angle") && hasValue) {
+            angle = args[++i].toDouble(&ok);
+            if (!ok || angle <= 0.0 || angle > 360.0)
+                return fail(QStringLiteral("Invalid angle: ") + args[i]);
+        } else if (arg == QLatin1String("--compare")) {
+            compare = true;
+        } else if (!arg.startsWith(QLatin1Char('-'))) {
+            if (inputPath.isEmpty()) {
+                inputPath = arg;
+            } else if (outputPath.isEmpty()) {
+                outputPath = arg;
+            }
+        }
+    }
+
+    const QString command = revolve ? QStringLiteral("revolve") : QStringLiteral("extrude");
+    if (inputPath.isEmpty()) {
+        return fail(QStringLiteral("Usage: %1 [options] <project> [output]\n"
+                                   "\n"
+                                   "Run '%1 --help' for more options.").arg(command));
+    }
+
+    QFileInfo inputInfo(inputPath);
+    if (!inputInfo.exists())
+        return fail(QStringLiteral("Input file not found: ") + inputPath);
+    if (!inputInfo.isDir() &&
+        !inputPath.endsWith(QStringLiteral(".hcad"), Qt::CaseInsensitive))
+        return fail(QStringLiteral("Input is not a project: ") + inputPath);
+
+    Project project;
+    std::string err;
+    if (!project.load(inputPath.toStdString(), &err))
+        return fail(QStringLiteral("Failed to load project: ") + QString::fromStdString(err));
+    if (project.sketches().empty())
+        return fail(QStringLiteral("Project has no sketches: ") + inputPath);
+
+    const SketchData* sketch = &project.sketches().front();
+    if (!sketchName.isEmpty()) {
+        sketch = nullptr;
+        for (const SketchData& s : project.sketches()) {
+            if (QString::fromStdString(s.name) == sketchName) {
+                sketch = &s;
+                break;
+            }
+        }
+        if (!sketch)
+            return fail(QStringLiteral("Sketch not found: ") + sketchName);
+    }
+    const std::vector<sketch::Entity>& entities = sketch->entities;
+
+    using Clock = std::chrono::steady_clock;
+    auto millisecondsSince = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
+    // Hole-heavy plates easily exceed the default profile limit
+    sketch::ProfileDetectionOptions options;
+    options.maxProfiles = 100000;
+
+    Clock::time_point start = Clock::now();
+    std::vector<sketch::ProfileRegion> regions = sketch::detectProfileRegions(entities, options);
+    if (regions.empty())
+        return fail(QStringLiteral("No closed profiles in sketch '%1'")
+                        .arg(QString::fromStdString(sketch->name)));
+
+    gp_Dir direction(0, 0, reverse ? -1 : 1);
+    gp_Ax1 axis(gp_Pnt(0, 0, 0), axisDir);
+
+    brep::OperationResult result = revolve
+        ? brep::revolveRegions(regions, entities, axis, angle)
+        : brep::extrudeRegions(regions, entities, direction, distance, symmetric);
+    double milliseconds = millisecondsSince(start);
+    if (!result.success)
+        return fail((revolve ? QStringLiteral("Revolution failed: ")
+                             : QStringLiteral("Extrusion failed: ")) +
+                    QString::fromStdString(result.errorMessage));
+
+    int holes = 0;
+    for (const sketch::ProfileRegion& region : regions) {
+        holes += static_cast<int>(region.holes.size());
+    }
+    double volume = brep::shapeVolume(result.shape);
+
+    QString out = QStringLiteral("Sketch '%1': %2 region(s), %3 hole(s)\n")
+                      .arg(QString::fromStdString(sketch->name))
+                      .arg(regions.size()).arg(holes);
+    out += QStringLiteral("Volume: %1 (%2 ms)").arg(volume, 0, 'f', 3).arg(milliseconds, 0, 'f', 0);
+
+    if (compare) {
+        // One solid per profile and a boolean cut per hole, which is
+        // what a region would cost without inner wires
+        auto single = [&](const sketch::Profile& profile) {
+            return revolve
+                ? brep::revolveProfile(profile, entities, axis, angle)
+                : brep::extrudeProfileSymmetric(profile, entities, direction, distance, symmetric);
+        };
+
+        start = Clock::now();
+        double cutVolume = 0.0;
+        brep::OperationResult body;
+        for (const sketch::ProfileRegion& region : regions) {
+            body = single(region.outer);
+            for (const sketch::Profile& hole : region.holes) {
+                if (!body.success) break;
+                brep::OperationResult tool = single(hole);
+                body = tool.success ? brep::cutShape(body.shape, tool.shape) : tool;
+            }
+            if (!body.success) break;
+            cutVolume += brep::shapeVolume(body.shape);
+        }
+        double cutMilliseconds = millisecondsSince(start);
+
+        if (body.success) {
+            out += QStringLiteral("\nPer-profile cuts: volume %1 (%2 ms, %3x)")
+                       .arg(cutVolume, 0, 'f', 3)
+                       .arg(cutMilliseconds, 0, 'f', 0)
+                       .arg(cutMilliseconds / std::max(milliseconds, 1e-3), 0, 'f', 1);
+            out += QStringLiteral("\nVolume difference: %1").arg(std::abs(volume - cutVolume), 0, 'g', 3);
+        } else {
+            out += QStringLiteral("\nPer-profile cuts failed: ") +
+                   QString::fromStdString(body.errorMessage);
+        }
+    }
+
+    if (!outputPath.isEmpty()) {
+        bool written = false;
+        if (step_io::isStepFile(outputPath.toStdString())) {
+            step_io::WriteResult w = step_io::writeStep(outputPath.toStdString(), result.shape);
+            written = w.success;
+            err = w.errorMessage;
+        } else if (stl_io::isStlFile(outputPath.toStdString())) {
+            stl_io::WriteResult w = stl_io::writeStl(outputPath.toStdString(), result.shape);
+            written = w.success;
+            err = w.errorMessage;
+        } else {
+            if (QFileInfo(outputPath).suffix().isEmpty()) outputPath += QStringLiteral(".brep");
+            written = brep_io::writeBrep(outputPath.toStdString(), result.shape, &err);
+        }
+        if (!written)
+            return fail(QStringLiteral("Failed to write output: ") + QString::fromStdString(err));
+        out += QStringLiteral("\nWrote ") + outputPath;
+    }
+
+    r.output = out;
+    return r;
+}
+
+CliResult CliEngine::cmdExtrude(const QStringList& args)
+{
+    if (!args.isEmpty() && (args[0] == QLatin1String("--help") ||
+                            args[0] == QLatin1String("-h"))) {
+        CliResult r;
+        r.output = QStringLiteral(
+            "Usage: extrude [options] <project> [output]\n"
+            "\n"
+            "Extrude every closed region of a project sketch in one prism.\n"
+            "Profiles inside a region become holes through the solid.\n"
+            "Without an output file only the summary is printed.\n"
+            "\n"
+            "Arguments:\n"
+            "  <project>                Project (.hcad or directory)\n"
+            "  [output]                 .brep, .step or .stl to write\n"
+            "\n"
+            "Options:\n"
+            "  -h, --help               Show this help message\n"
+            "  --sketch <name>          Sketch to extrude (default: the first)\n"
+            "  --distance <d>           Extrusion distance (default: 10)\n"
+            "  --symmetric              Extrude d/2 to each side of the sketch\n"
+            "  --reverse                Extrude along -Z of the sketch\n"
+            "  --compare                Also build one solid per profile with a\n"
+            "                           boolean cut per hole and report both\n"
+            "\n"
+            "Examples:\n"
+            "  extrude myproject/\n"
+            "  extrude --sketch Plate --distance 3 myproject/ plate.step\n"
+            "  extrude --compare --distance 3 myproject/");
+        return r;
+    }
+    return profileSolidCommand(args, false);
+}
+
+CliResult CliEngine::cmdRevolve(const QStringList& args)
+{
+    if (!args.isEmpty() && (args[0] == QLatin1String("--help") ||
+                            args[0] == QLatin1String("-h"))) {
+        CliResult r;
+        r.output = QStringLiteral(
+            "Usage: revolve [options] <project> [output]\n"
+            "\n"
+            "Revolve every closed region of a project sketch in one revolution.\n"
+            "Profiles inside a region become holes through the solid.\n"
+            "Without an output file only the summary is printed.\n"
+            "\n"
+            "Arguments:\n"
+            "  <project>                Project (.hcad or directory)\n"
+            "  [output]                 .brep, .step or .stl to write\n"
+            "\n"
+            "Options:\n"
+            "  -h, --help               Show this help message\n"
+            "  --sketch <name>          Sketch to revolve (default: the first)\n"
+            "  --axis <x|y>             Sketch axis to revolve around (default: y)\n"
+            "  --angle <deg>            Revolution angle, up to 360 (default: 360)\n"
+            "  --compare                Also build one solid per profile with a\n"
+            "                           boolean cut per hole and report both\n"
+            "\n"
+            "Examples:\n"
+            "  revolve myproject/\n"
+            "  revolve --axis x --angle 180 myproject/ half.brep");
+        return r;
+    }
+    return profileSolidCommand(args, true);
+}
+
+CliResult CliEngine::cmdLint(const QStringList& args)
+{
+    CliResult r;
+
+    // Check for help flag
+    if (!args.isEmpty() && (args[0] == QLatin1String("--help") ||
+                            args[0] == QLatin1String("-h"))) {
+        r.output = QStringLiteral(
+            "Usage: lint [options] <input> [output]\n"
+            "\n"
+            "Check sketches for duplicated entities, overlapping collinear lines\n"
+            "and endpoints that nearly meet.  With --fix the problems are fixed;\n"
+            "a project is saved in place unless an output is given.\n"
+            "\n"
+            "Arguments:\n"
+            "  <input>                  Project (.hcad or directory) or .dxf file\n"
+            "  [output]                 Project directory or .dxf file for the fixes\n"
+            "\n"
+            "Options:\n"
+            "  -h, --help               Show this help message\n"
+            "  --sketch <name>          Only check this project sketch\n"
+            "  --near <mm>              Near-duplicate and collinear tolerance (default: 0.001)\n"
+            "  --gap <mm>               Largest endpoint gap reported (default: 0.01)\n"
+            "  --angle <deg>            Largest direction difference of collinear lines\n"
+            "                           (default: 0.0001)\n"
+            "  --fix                    Fix the problems found\n"
+            "  --no-dedupe              With --fix, keep duplicates\n"
+            "  --no-merge               With --fix, keep overlapping lines\n"
+            "  --no-weld                With --fix, leave gaps open\n"
+            "  --limit <n>              Issues listed per sketch (default: 20, 0 = all)\n"
+            "\n"
+            "Examples:\n"
+            "  lint myproject/\n"
+            "  lint --gap 0.05 drawing.dxf\n"
+            "  lint --fix drawing.dxf clean.dxf");
+        return r;
+    }
+
+    sketch::LintOptions options;
+    options.angleTolerance = 0.0001 * M_PI / 180.0;
+    sketch::LintFixOptions fixes;
+    bool fix = false;
+    int limit = 20;
+    QString inputPath;
+    QString outputPath;
+    QString sketchName;
+
+    auto fail = [&r](const QString& message) {
+        r.exitCode = 1;
+        r.error = message;
+        return r;
+    };
+
+    for (int i = 0; i < args.size(); ++i) {
+        const QString& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        bool ok = true;
+
+        if (arg == QLatin1String("--sketch") && hasValue) {
+            sketchName = args[++i];
+        } else if (arg == QLatin1String("--near") && hasValue) {
+            options.nearTolerance = args[++i].toDouble(&ok);
+            if (!ok || options.nearTolerance < 0.0)
+                return fail(QStringLiteral("Invalid tolerance: ") + args[i]);
+        } else if (arg == QLatin1String("--gap") && hasValue) {
+            options.gapTolerance = args[++i].toDouble(&ok);
+            if (!ok || options.gapTolerance < 0.0)
+                return fail(QStringLiteral("Invalid gap: ") + args[i]);
+        } else if (arg == QLatin1String("--angle") && hasValue) {
+            double degrees = args[++i].toDouble(&ok);
+            if (!ok || degrees < 0.0 || degrees >= 90.0)
+                return fail(QStringLiteral("Invalid angle: ") + args[i]);
+            options.angleTolerance = degrees * M_PI / 180.0;
+        } else if (arg == QLatin1String("--fix")) {
+            fix = true;
+        } else if (arg == QLatin1String("--no-dedupe")) {
+            fixes.removeDuplicates = false;
+        } else if (arg == QLatin1String("--no-merge")) {
+            fixes.mergeCollinear = false;
+        } else if (arg == QLatin1String("--no-weld")) {
+            fixes.weldEndpoints = false;
+        } else if (arg == QLatin1String("--limit") && hasValue) {
+            limit = args[++i].toInt(&ok);
+            if (!ok || limit < 0)
+                return fail(QStringLiteral("Invalid limit: ") + args[i]);
+        } else if (!arg.startsWith(QLatin1Char('-'))) {
+            if (inputPath.isEmpty()) {
+                inputPath = arg;
+            } else if (outputPath.isEmpty()) {
+                outputPath = arg;
+            }
+        }
+    }
+
+    if (inputPath.isEmpty()) {
+        return fail(QStringLiteral(
+            "Usage: lint [options] <input> [output]\n"
+            "\n"
+            "Run 'lint --help' for more options."));
+    }
+
+    QFileInfo inputInfo(inputPath);
+    if (!inputInfo.exists())
+        return fail(QStringLiteral("Input file not found: ") + inputPath);
+
+    const bool dxf = !inputInfo.isDir() &&
+                     inputPath.endsWith(QStringLiteral(".dxf"), Qt::CaseInsensitive);
+    if (!dxf && !inputInfo.isDir() &&
+        !inputPath.endsWith(QStringLiteral(".hcad"), Qt::CaseInsensitive))
+        return fail(QStringLiteral("Unknown input format: ") + inputPath +
+                    QStringLiteral(" (expected a project or .dxf)"));
+    if (dxf && fix && outputPath.isEmpty())
+        return fail(QStringLiteral("Fixing a DXF file needs an output file"));
+
+    // A DXF file is linted as a single sketch
+    Project project;
+    std::string err;
+    if (dxf) {
+        sketch::DXFImportResult imported = sketch::importDXFFile(inputPath.toStdString());
+        if (!imported.success)
+            return fail(QStringLiteral("Failed to read input: ") +
+                        QString::fromStdString(imported.errorMessage));
+        SketchData data;
+        data.name = inputInfo.fileName().toStdString();
+        data.entities = std::move(imported.entities);
+        project.addSketch(data);
+    } else if (!project.load(inputPath.toStdString(), &err)) {
+        return fail(QStringLiteral("Failed to load project: ") + QString::fromStdString(err));
+    }
+
+    QString out;
+    int remaining = 0;
+    bool found = sketchName.isEmpty();
+    for (int index = 0; index < static_cast<int>(project.sketches().size()); ++index) {
+        SketchData data = project.sketches()[index];
+        if (!sketchName.isEmpty() && QString::fromStdString(data.name) != sketchName) continue;
+        found = true;
+
+        auto start = std::chrono::steady_clock::now();
+        sketch::LintReport report = sketch::lintSketch(data.entities, options);
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        out += QStringLiteral("Sketch \"%1\": %2 entities, %3 issue(s) (%4 ms)\n")
+                   .arg(QString::fromStdString(data.name))
+                   .arg(data.entities.size())
+                   .arg(report.issues.size())
+                   .arg(ms, 0, 'f', 0);
+        if (report.clean()) continue;
+
+        out += QStringLiteral("  %1 duplicate(s), %2 near duplicate(s), %3 overlap(s), %4 gap(s)\n")
+                   .arg(report.duplicates).arg(report.nearDuplicates)
+                   .arg(report.overlaps).arg(report.gaps);
+        int shown = 0;
+        for (const sketch::LintIssue& issue : report.issues) {
+            if (limit > 0 && shown == limit) {
+                out += QStringLiteral("  ... and %1 more\n").arg(report.issues.size() - shown);
+                break;
+            }
+            out += QStringLiteral("  ") +
+                   QString::fromStdString(sketch::lintIssueMessage(issue, data.entities)) +
+                   QLatin1Char('\n');
+            ++shown;
+        }
+
+        if (!fix) {
+            remaining += static_cast<int>(report.issues.size());
+            continue;
+        }
+
+        // Project constraints are ConstraintData; fixLint only rewrites
+        // their references, so copy those across and back by ID
+        std::vector<sketch::Constraint> constraints;
+        constraints.reserve(data.constraints.size());
+        for (const ConstraintData& c : data.constraints) {
+            sketch::Constraint sc;
+            sc.id = c.id;
+            sc.type = c.type;
+            sc.entityIds = c.entityIds;
+            sc.pointIndices = c.pointIndices;
+            sc.value = c.value;
+            sc.isDriving = c.isDriving;
+            sc.enabled = c.enabled;
+            constraints.push_back(std::move(sc));
+        }
+
+        sketch::LintFixResult fixed = sketch::fixLint(data.entities, constraints, options, fixes);
+        if (!fixed.success)
+            return fail(QStringLiteral("Fix failed: ") + QString::fromStdString(fixed.errorMessage));
+        out += QStringLiteral("  Fixed: %1 duplicate(s) removed, %2 line(s) merged, %3 endpoint(s) welded\n")
+                   .arg(fixed.duplicatesRemoved).arg(fixed.linesMerged).arg(fixed.endpointsWelded);
+        remaining += static_cast<int>(sketch::lintSketch(fixed.entities, options).issues.size());
+
+        std::unordered_map<int, const ConstraintData*> byId;
+        for (const ConstraintData& c : data.constraints) byId[c.id] = &c;
+        std::vector<ConstraintData> kept;
+        kept.reserve(fixed.constraints.size());
+        for (const sketch::Constraint& sc : fixed.constraints) {
+            ConstraintData c = *byId.at(sc.id);
+            c.entityIds = sc.entityIds;
+            c.pointIndices = sc.pointIndices;
+            kept.push_back(std::move(c));
+        }
+
+        data.entities = std::move(fixed.entities);
+        data.constraints = std::move(kept);
+        project.setSketch(index, data);
+    }
+    if (!found)
+        return fail(QStringLiteral("Sketch not found: ") + sketchName);
+
+    if (fix) {
+        if (dxf) {
+            if (!sketch::exportSketchToDXF(project.sketches().front().entities,
+                                           outputPath.toStdString()))
+                return fail(QStringLiteral("Failed to write output: ") + outputPath);
+        } else if (!project.save(outputPath.toStdString(), &err)) {
+            return fail(QStringLiteral("Failed to save project: ") + QString::fromStdString(err));
+        }
+        out += QStringLiteral("Saved %1\n").arg(outputPath.isEmpty() ? inputPath : outputPath);
+    }
+
+    r.output = out.trimmed();
+    if (remaining > 0) {
+        r.exitCode = 1;
+        r.error = QStringLiteral("%1 lint issue(s) remain").arg(remaining);
+    }
+    return r;
+}
+
+CliResult CliEngine::cmdClash(const QStringList& args)
+{
+    CliResult r;
+
+    // Check for help flag
+    if (!args.isEmpty() && (args[0] == QLatin1String("--help") ||
+                            args[0] == QLatin1String("-h"))) {
+        r.output = QStringLiteral(
+            "Usage: clash [options] <input>\n"
+            "\n"
+            "Find bodies that interfere, touch, or come closer than a clearance.\n"
+            "Interfering pairs are listed with the volume they share, the others\n"
+            "with their minimum distance.  Exits with status 1 if any bodies\n"
+            "interfere.\n"
+            "\n"
+            "Arguments:\n"
+            "  <input>                  Project (.hcad or directory), .brep, .step\n"
+            "                           or .stl file; each solid is one body, and\n"
+            "                           each connected part of an STL mesh\n"
+            "\n"
+            "Options:\n"
+            "  -h, --help               Show this help message\n"
+            "  --clearance <mm>         Also report bodies closer than this (default: 0)\n"
+            "  --tolerance <mm>         Gaps and overlaps that count as contact\n"
+            "                           (default: 0.0001)\n"
+            "  --mesh [deflection]      Check tessellations instead of exact geometry\n"
+            "                           (default deflection: 1e-3 of each body's size)\n"
+            "  --no-volumes             Do not compute interference volumes\n"
+            "  --limit <n>              Clashes listed (default: 50, 0 = all)\n"
+            "  --single-thread          Check pairs on the calling thread only\n"
+            "\n"
+            "Examples:\n"
+            "  clash assembly/\n"
+            "  clash --clearance 0.5 gearbox.step\n"
+            "  clash --mesh --no-volumes parts.stl");
+        return r;
+    }
+
+    brep::ClashOptions options;
+    QString inputPath;
+    int limit = 50;
+
+    auto fail = [&r](const QString& message) {
+        r.exitCode = 1;
+        r.error = message;
+        return r;
+    };
+
+    for (int i = 0; i < args.size(); ++i) {
+        const QString& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+
+        if ((arg == QLatin1String("--clearance") ||
+             arg == QLatin1String("--tolerance")) && hasValue) {
+            bool ok = false;
+            double value = args[++i].toDouble(&ok);
+            if (!ok || value < 0.0) return fail(QStringLiteral("Invalid distance: ") + args[i]);
+            if (arg == QLatin1String("--clearance")) options.clearance = value;
+            else options.contactTolerance = value;
+        } else if (arg == QLatin1String("--mesh")) {
+            options.method = brep::ClashMethod::Mesh;
+            // The deflection is optional; take the next word only if it is a number
+            bool ok = false;
+            double deflection = hasValue ? args[i + 1].toDouble(&ok) : 0.0;
+            if (ok) {
+                if (deflection <= 0.0) return fail(QStringLiteral("Invalid deflection: ") + args[i + 1]);
+                options.deflection = deflection;
+                ++i;
+            }
+        } else if (arg == QLatin1String("--no-volumes")) {
+            options.computeVolumes = false;
+        } else if (arg == QLatin1String("--limit") && hasValue) {
+            bool ok = false;
+            limit = args[++i].toInt(&ok);
+            if (!ok || limit < 0) return fail(QStringLiteral("Invalid limit: ") + args[i]);
+        } else if (arg == QLatin1String("--single-thread")) {
+            options.parallel = false;
+        } else if (!arg.startsWith(QLatin1Char('-'))) {
+            if (inputPath.isEmpty()) inputPath = arg;
+        }
+    }
+
+    if (inputPath.isEmpty()) {
+        return fail(QStringLiteral(
+            "Usage: clash [options] <input>\n"
+            "\n"
+            "Run 'clash --help' for more options."));
+    }
+
+    QFileInfo inputInfo(inputPath);
+    if (!inputInfo.exists())
+        return fail(QStringLiteral("Input file not found: ") + inputPath);
+
+    // Read the bodies.  STL holds only triangles, so its connected
+    // parts go straight to the mesh checks.
+    std::string err;
+    std::vector<TopoDS_Shape> shapes;
+    mesh::ClashReport report;
+    bool stl = false;
+    if (inputInfo.isDir() ||
+        inputPath.endsWith(QStringLiteral(".hcad"), Qt::CaseInsensitive)) {
+        Project project;
+        if (!project.load(inputPath.toStdString(), &err))
+            return fail(QStringLiteral("Failed to load project: ") + QString::fromStdString(err));
+        shapes = project.shapes();
+    } else if (inputPath.endsWith(QStringLiteral(".brep"), Qt::CaseInsensitive) ||
+               inputPath.endsWith(QStringLiteral(".brp"), Qt::CaseInsensitive)) {
+        shapes = brep_io::readBrep(inputPath.toStdString(), &err);
+    } else if (step_io::isStepFile(inputPath.toStdString())) {
+        shapes = step_io::readStep(inputPath.toStdString(), &err);
+    } else if (stl_io::isStlFile(inputPath.toStdString())) {
+        stl_io::ReadResult read = stl_io::readStl(inputPath.toStdString());
+        if (!read.success)
+            return fail(QStringLiteral("Failed to read input: ") +
+                        QString::fromStdString(read.errorMessage));
+        mesh::TriangleMesh triangles = mesh::fromTriangulation(read.mesh);
+        mesh::weldVertices(triangles, triangles.diagonal() * 1e-6);
+
+        mesh::ClashOptions meshOptions;
+        meshOptions.clearance = options.clearance;
+        meshOptions.contactTolerance = options.contactTolerance;
+        meshOptions.computeVolumes = options.computeVolumes;
+        meshOptions.parallel = options.parallel;
+        report = mesh::findClashes(mesh::splitComponents(triangles), meshOptions);
+        stl = true;
+    } else {
+        return fail(QStringLiteral("Unknown input format: ") + inputPath);
+    }
+
+    if (!stl) {
+        if (shapes.empty() && !err.empty())
+            return fail(QStringLiteral("Failed to read input: ") + QString::fromStdString(err));
+
+        // Assemblies often arrive as one compound; check its solids
+        // against each other
+        std::vector<TopoDS_Shape> bodies;
+        for (const TopoDS_Shape& shape : shapes) {
+            if (shape.IsNull()) continue;
+            int solids = 0;
+            if (shape.ShapeType() == TopAbs_COMPOUND) {
+                for (TopExp_Explorer exp(shape, TopAbs_SOLID); exp.More(); exp.Next(), ++solids)
+                    bodies.push_back(exp.Current());
+            }
+            if (solids == 0) bodies.push_back(shape);
+        }
+        report = brep::findClashes(bodies, options);
+    }
+
+    if (!report.success)
+        return fail(QStringLiteral("Clash check failed: ") +
+                    QString::fromStdString(report.errorMessage));
+
+    auto point = [](const mesh::MeshPoint& p) {
+        return QStringLiteral("(%1, %2, %3)").arg(p.x, 0, 'g', 6).arg(p.y, 0, 'g', 6).arg(p.z, 0, 'g', 6);
+    };
+
+    const int interferences = report.count(mesh::ClashType::Interference);
+    QString out = QStringLiteral("%1: %2 bodies, %3 candidate pair(s), %4 ms\n")
+                      .arg(inputPath).arg(report.bodies).arg(report.candidatePairs)
+                      .arg(report.milliseconds, 0, 'f', 0);
+    int shown = 0;
+    for (const mesh::ClashPair& c : report.clashes) {
+        if (limit > 0 && shown == limit) {
+            out += QStringLiteral("  ... %1 more\n").arg(static_cast<int>(report.clashes.size()) - limit);
+            break;
+        }
+        ++shown;
+        QString line = QStringLiteral("  Body %1 / body %2: ").arg(c.bodyA + 1).arg(c.bodyB + 1);
+        switch (c.type) {
+        case mesh::ClashType::Interference:
+            line += QStringLiteral("interference at %1").arg(point(c.pointA));
+            if (options.computeVolumes)
+                line += QStringLiteral(", %1 mm^3 shared").arg(c.volume, 0, 'g', 6);
+            break;
+        case mesh::ClashType::Contact:
+            line += QStringLiteral("contact at %1").arg(point(c.pointA));
+            break;
+        case mesh::ClashType::Clearance:
+            line += QStringLiteral("%1 mm apart, %2 to %3")
+                        .arg(c.distance, 0, 'g', 6).arg(point(c.pointA), point(c.pointB));
+            break;
+        }
+        out += line + QLatin1Char('\n');
+    }
+    out += QStringLiteral("%1 interference(s), %2 contact(s), %3 clearance violation(s)")
+               .arg(interferences)
+               .arg(report.count(mesh::ClashType::Contact))
+               .arg(report.count(mesh::ClashType::Clearance));
+
+    r.output = out;
+    if (interferences > 0) {
+        r.exitCode = 1;
+        r.error = QStringLiteral("%1 pair(s) of bodies interfere").arg(interferences);
+    }
+    return r;
+}
+
+CliResult CliEngine::cmdSlice(const QStringList& args)
+{
+    CliResult r;
+
+    // Check for help flag
+    if (!args.isEmpty() && (args[0] == QLatin1String("--help") ||
+                            args[0] == QLatin1String("-h"))) {
+        r.output = QStringLiteral(
+            "Usage: slice [options] <input> [output]\n"
+            "\n"
+            "Cut bodies into layers with evenly spaced parallel planes and write\n"
+            "each section as lines, arcs and circles: one DXF or SVG file per\n"
+            "layer, or one new sketch per layer in a project.  Each plane sits in\n"
+            "the middle of its layer, so a stack of cut layers rebuilds the part.\n"
+            "\n"
+            "Arguments:\n"
+            "  <input>                  Project (.hcad or directory), .brep, .step\n"
+            "                           or .stl file\n"
+            "  [output]                 Directory for the layer files, or the project\n"
+            "                           for the sketches (default: the input project)\n"
+            "\n"
+            "Options:\n"
+            "  -h, --help               Show this help message\n"
+            "  --axis <x|y|z>           Plane normal (default: z)\n"
+            "  --count <n>              Number of layers (default: 10)\n"
+            "  --step <mm>              Layer thickness, instead of --count\n"
+            "  --from <mm>              Start of the sliced range along the axis\n"
+            "  --to <mm>                End of the sliced range (default: the extent\n"
+            "                           of the bodies)\n"
+            "  --format <dxf|svg|sketch>  Layer files or project sketches (default: dxf)\n"
+            "  --mesh [deflection]      Cut the tessellation instead of exact geometry\n"
+            "                           (default deflection: 1e-3 of the model size)\n"
+            "  --tolerance <mm>         Largest deviation of fitted lines and arcs\n"
+            "                           (default: 0.001)\n"
+            "  --no-arcs                Fit lines only\n"
+            "  --single-thread          Cut planes on the calling thread only\n"
+            "\n"
+            "Examples:\n"
+            "  slice --step 3 bracket.step layers/\n"
+            "  slice --axis y --count 5 --format svg myproject/ sections/\n"
+            "  slice --format sketch --count 4 myproject/\n"
+            "  slice --mesh --step 0.2 model.stl preview/");
+        return r;
+    }
+
+    brep::SliceOptions options;
+    QString inputPath;
+    QString outputPath;
+    QString format = QStringLiteral("dxf");
+    QChar axis = QLatin1Char('z');
+    int count = 10;
+    double step = 0.0;
+    double from = 0.0, to = 0.0;
+    bool hasFrom = false, hasTo = false;
+
+    auto fail = [&r](const QString& message) {
+        r.exitCode = 1;
+        r.error = message;
+        return r;
+    };
+
+    for (int i = 0; i < args.size(); ++i) {
+        const QString& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        bool ok = true;
+
+        if (arg == QLatin1String("--axis") && hasValue) {
+            const QString value = args[++i].toLower();
+            if (value != QLatin1String("x") && value != QLatin1String("y") &&
+                value != QLatin1String("z"))
+                return fail(QStringLiteral("Invalid axis: ") + args[i]);
+            axis = value[0];
+        } else if (arg == QLatin1String("--count") && hasValue) {
+            count = args[++i].toInt(&ok);
+            if (!ok || count < 1) return fail(QStringLiteral("Invalid count: ") + args[i]);
+            step = 0.0;
+        } else if (arg == QLatin1String("--step") && hasValue) {
+            step = args[++i].toDouble(&ok);
+            if (!ok || step <= 0.0) return fail(QStringLiteral("Invalid step: ") + args[i]);
+        } else if (arg == QLatin1String("--from") && hasValue) {
+            from = args[++i].toDouble(&ok);
+            if (!ok) return fail(QStringLiteral("Invalid position: ") + args[i]);
+            hasFrom = true;
+        } else if (arg == QLatin1String("--to") && hasValue) {
+            to = args[++i].toDouble(&ok);
+            if (!ok) return fail(QStringLiteral("Invalid position: ") + args[i]);
+            hasTo = true;
+        } else if (arg == QLatin1String("--format") && hasValue) {
+            format = args[++i].toLower();
+            if (format != QLatin1String("dxf") && format != QLatin1String("svg") &&
+                format != QLatin1String("sketch"))
+                return fail(QStringLiteral("Invalid format: ") + args[i]);
+        } else if (arg == QLatin1String("--mesh")) {
+            options.method = brep::SliceMethod::Mesh;
+            // The deflection is optional; take the next word only if it is a number
+            double deflection = hasValue ? args[i + 1].toDouble(&ok) : 0.0;
+            if (hasValue && ok) {
+                if (deflection <= 0.0) return fail(QStringLiteral("Invalid deflection: ") + args[i + 1]);
+                options.deflection = deflection;
+                ++i;
+            }
+        } else if (arg == QLatin1String("--tolerance") && hasValue) {
+            options.fit.tolerance = args[++i].toDouble(&ok);
+            if (!ok || options.fit.tolerance <= 0.0)
+                return fail(QStringLiteral("Invalid tolerance: ") + args[i]);
+        } else if (arg == QLatin1String("--no-arcs")) {
+            options.fit.recoverArcs = false;
+        } else if (arg == QLatin1String("--single-thread")) {
+            options.parallel = false;
+        } else if (!arg.startsWith(QLatin1Char('-'))) {
+            if (inputPath.isEmpty()) {
+                inputPath = arg;
+            } else if (outputPath.isEmpty()) {
+                outputPath = arg;
+            }
+        }
+    }
+
+    if (inputPath.isEmpty()) {
+        return fail(QStringLiteral(
+            "Usage: slice [options] <input> [output]\n"
+            "\n"
+            "Run 'slice --help' for more options."));
+    }
+
+    QFileInfo inputInfo(inputPath);
+    if (!inputInfo.exists())
+        return fail(QStringLiteral("Input file not found: ") + inputPath);
+    const bool inputIsProject = inputInfo.isDir() ||
+        inputPath.endsWith(QStringLiteral(".hcad"), Qt::CaseInsensitive);
+    const bool sketches = format == QLatin1String("sketch");
+    if (outputPath.isEmpty() && !(sketches && inputIsProject))
+        return fail(QStringLiteral("Slicing needs an output ") +
+                    (sketches ? QStringLiteral("project") : QStringLiteral("directory")));
+
+    // Read the bodies.  STL holds only triangles, so it is cut on the
+    // mesh whatever the method.
+    Project project;
+    std::string err;
+    std::vector<TopoDS_Shape> shapes;
+    mesh::TriangleMesh triangles;
+    bool stl = false;
+    if (inputIsProject) {
+        if (!project.load(inputPath.toStdString(), &err))
+            return fail(QStringLiteral("Failed to load project: ") + QString::fromStdString(err));
+        shapes = project.shapes();
+    } else if (inputPath.endsWith(QStringLiteral(".brep"), Qt::CaseInsensitive) ||
+               inputPath.endsWith(QStringLiteral(".brp"), Qt::CaseInsensitive)) {
+        shapes = brep_io::readBrep(inputPath.toStdString(), &err);
+    } else if (step_io::isStepFile(inputPath.toStdString())) {
+        shapes = step_io::readStep(inputPath.toStdString(), &err);
+    } else if (stl_io::isStlFile(inputPath.toStdString())) {
+        stl_io::ReadResult read = stl_io::readStl(inputPath.toStdString());
+        if (!read.success)
+            return fail(QStringLiteral("Failed to read input: ") +
+                        QString::fromStdString(read.errorMessage));
+        triangles = mesh::fromTriangulation(read.mesh);
+        stl = true;
+    } else {
+        return fail(QStringLiteral("Unknown input format: ") + inputPath);
+    }
+
+    // All bodies are cut together, as one compound
+    TopoDS_Compound compound;
+    BRep_Builder builder;
+    builder.MakeCompound(compound);
+    Bnd_Box box;
+    if (!stl) {
+        for (const TopoDS_Shape& shape : shapes) {
+            if (shape.IsNull()) continue;
+            builder.Add(compound, shape);
+            BRepBndLib::Add(shape, box);
+        }
+        if (box.IsVoid()) {
+            return fail(err.empty() ? QStringLiteral("No bodies to slice in ") + inputPath
+                                    : QStringLiteral("Failed to read input: ") +
+                                          QString::fromStdString(err));
+        }
+    } else {
+        for (const mesh::MeshPoint& v : triangles.vertices) box.Add(gp_Pnt(v.x, v.y, v.z));
+        if (box.IsVoid()) return fail(QStringLiteral("No triangles in ") + inputPath);
+    }
+
+    // Sketch planes: YZ, XZ and XY have their normals along X, Y and Z,
+    // and slices come back in those planes' coordinates
+    mesh::MeshPoint normal(0.0, 0.0, 1.0);
+    SketchPlane plane = SketchPlane::XY;
+    double lo[3], hi[3];
+    box.Get(lo[0], lo[1], lo[2], hi[0], hi[1], hi[2]);
+    int k = 2;
+    if (axis == QLatin1Char('x')) {
+        normal = {1.0, 0.0, 0.0};
+        plane = SketchPlane::YZ;
+        k = 0;
+    } else if (axis == QLatin1Char('y')) {
+        normal = {0.0, 1.0, 0.0};
+        plane = SketchPlane::XZ;
+        k = 1;
+    }
+    if (!hasFrom) from = lo[k];
+    if (!hasTo) to = hi[k];
+    if (to <= from)
+        return fail(QStringLiteral("Empty range: %1 to %2").arg(from).arg(to));
+
+    // Planes in the middle of each layer
+    double thickness = (to - from) / count;
+    if (step > 0.0) {
+        count = std::max(1, static_cast<int>(std::floor((to - from) / step + 1e-9)));
+        thickness = step;
+    }
+    const mesh::SlicePlanes planes = mesh::SlicePlanes::evenlySpaced(
+        normal, from + 0.5 * thickness, from + (count - 0.5) * thickness, count);
+
+    brep::SliceResult result;
+    if (stl) {
+        auto start = std::chrono::steady_clock::now();
+        const auto sections = mesh::sliceMesh(triangles, planes, options.parallel);
+        for (const mesh::MeshSection& section : sections) {
+            brep::SliceLayer layer;
+            layer.offset = section.offset;
+            layer.contours = sketch::buildContours(section.loops, section.chains, options.fit);
+            for (const sketch::Contour& c : layer.contours)
+                if (!c.closed) ++result.openContours;
+            result.layers.push_back(std::move(layer));
+        }
+        result.success = true;
+        result.milliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    } else {
+        result = brep::sliceShape(compound, planes, options);
+    }
+    if (!result.success)
+        return fail(QStringLiteral("Slicing failed: ") + QString::fromStdString(result.errorMessage));
+
+    if (!sketches && !QDir().mkpath(outputPath))
+        return fail(QStringLiteral("Failed to create directory: ") + outputPath);
+
+    const QString axisName = QString(axis.toUpper());
+    const int digits = std::max(3, static_cast<int>(QString::number(count).size()));
+    QString out = QStringLiteral("%1: %2 layer(s) along %3, %4 ms\n")
+                      .arg(inputPath).arg(result.layers.size()).arg(axisName)
+                      .arg(result.milliseconds, 0, 'f', 0);
+    for (int i = 0; i < static_cast<int>(result.layers.size()); ++i) {
+        const brep::SliceLayer& layer = result.layers[i];
+        std::vector<sketch::Entity> entities;
+        for (const sketch::Contour& c : layer.contours)
+            entities.insert(entities.end(), c.entities.begin(), c.entities.end());
+
+        QString target;
+        if (sketches) {
+            SketchData data;
+            data.name = QStringLiteral("Slice %1=%2").arg(axisName).arg(layer.offset, 0, 'g', 6)
+                            .toStdString();
+            data.plane = plane;
+            data.planeOffset = layer.offset;
+            data.entities = std::move(entities);
+            project.addSketch(data);
+            target = QString::fromStdString(data.name);
+        } else {
+            target = QDir(outputPath).filePath(
+                QStringLiteral("layer_%1.%2").arg(i + 1, digits, 10, QLatin1Char('0')).arg(format));
+            const bool written = format == QLatin1String("svg")
+                ? sketch::exportSketchToSVG(entities, {}, target.toStdString())
+                : sketch::exportSketchToDXF(entities, target.toStdString());
+            if (!written) return fail(QStringLiteral("Failed to write output: ") + target);
+        }
+        out += QStringLiteral("  %1=%2: %3 contour(s), %4 mm^2 -> %5\n")
+                   .arg(axisName).arg(layer.offset, 0, 'g', 6)
+                   .arg(layer.contours.size()).arg(layer.area(), 0, 'g', 6).arg(target);
+    }
+
+    if (sketches) {
+        if (!project.save(outputPath.toStdString(), &err))
+            return fail(QStringLiteral("Failed to save project: ") + QString::fromStdString(err));
+        out += QStringLiteral("Saved %1\n").arg(outputPath.isEmpty() ? inputPath : outputPath);
+    }
+    if (result.openContours > 0)
+        out += QStringLiteral("Warning: %1 contour(s) did not close\n").arg(result.openContours);
+
+    r.output = out.trimmed();
+    return r;
+}
+
+CliResult CliEngine::cmdStats(const QStringList& args)
+{
+    CliResult r;
+
+    // Check for help flag
+    if (!args.isEmpty() && (args[0] == QLatin1String("--help") ||
+                            args[0] == QLatin1String("-h"))) {
+        r.output = QStringLiteral(
+            "Usage: stats [options] [input]\n"
+            "\n"
+            "Show how much memory the project bodies, sketches, undo history,\n"
+            "background images and tessellations hold, with their peaks.\n"
+            "With an input file it is loaded first and kept until the\n"
+            "counters have been read.\n"
+            "\n"
+            "Arguments:\n"
+            "  [input]                  Project (.hcad or directory), .brep,\n"
+            "                           .step or .stl file\n"
+            "\n"
+            "Options:\n"
+            "  -h, --help               Show this help message\n"
+            "  --budget <name>=<size>   Fail if a counter peaked above size\n"
+            "                           (repeatable; size in bytes or K/M/G)\n"
+            "  --json                   Print the counters as JSON\n"
+            "  --reset-peaks            Restart peak tracking first\n"
+            "\n"
+            "Counters:\n"
+            "  bodies, entities, undo, backgrounds, tessellations,\n"
+            "  total (all of these), heap (allocation hooks), rss (process)\n"
+            "\n"
+            "Examples:\n"
+            "  stats\n"
+            "  stats myproject/\n"
+            "  stats --budget bodies=256M --budget rss=2G part.step");
+        return r;
+    }
+
+    std::vector<memory::Budget> budgets;
+    bool json = false;
+    bool resetPeaks = false;
+    QString inputPath;
+
+    auto fail = [&r](const QString& message) {
+        r.exitCode = 1;
+        r.error = message;
+        return r;
+    };
+
+    for (int i = 0; i < args.size(); ++i) {
+        const QString& arg = args[i];
+
+        if (arg == QLatin1String("--budget") && i + 1 < args.size()) {
+            memory::Budget budget;
+            std::string err;
+            if (!memory::parseBudget(args[++i].toStdString(), &budget, &err))
+                return fail(QStringLiteral("Invalid budget: ") + QString::fromStdString(err));
+            budgets.push_back(budget);
+        } else if (arg == QLatin1String("--json")) {
+            json = true;
+        } else if (arg == QLatin1String("--reset-peaks")) {
+            resetPeaks = true;
+        } else if (!arg.startsWith(QLatin1Char('-')) && inputPath.isEmpty()) {
+            inputPath = arg;
+        }
+    }
+
+    if (resetPeaks) memory::resetPeaks();
+
+    // The project owns the loaded data and its charges, so it must
+    // outlive the snapshot
+    Project project;
+    if (!inputPath.isEmpty()) {
+        QFileInfo inputInfo(inputPath);
+        if (!inputInfo.exists())
+            return fail(QStringLiteral("Input file not found: ") + inputPath);
+
+        std::string err;
+        if (inputInfo.isDir() ||
+            inputPath.endsWith(QStringLiteral(".hcad"), Qt::CaseInsensitive)) {
+            if (!project.load(inputPath.toStdString(), &err))
+                return fail(QStringLiteral("Failed to load project: ") + QString::fromStdString(err));
+        } else {
+            std::vector<TopoDS_Shape> shapes;
+            if (inputPath.endsWith(QStringLiteral(".brep"), Qt::CaseInsensitive) ||
+                inputPath.endsWith(QStringLiteral(".brp"), Qt::CaseInsensitive)) {
+                shapes = brep_io::readBrep(inputPath.toStdString(), &err);
+            } else if (step_io::isStepFile(inputPath.toStdString())) {
+                shapes = step_io::readStep(inputPath.toStdString(), &err);
+            } else if (stl_io::isStlFile(inputPath.toStdString())) {
+                stl_io::ReadResult read = stl_io::readStl(inputPath.toStdString());
+                if (!read.success) err = read.errorMessage;
+                else shapes.push_back(read.shape);
+            } else {
+                return fail(QStringLiteral("Unknown input format: ") + inputPath);
+            }
+            if (shapes.empty() && !err.empty())
+                return fail(QStringLiteral("Failed to read input: ") + QString::fromStdString(err));
+            project.setShapes(shapes);
+        }
+    }
+
+    // Triangulations already attached to the loaded shapes (STL input,
+    // meshes saved in .brep files) count as tessellations
+    memory::Charge tessellations(memory::Tag::Tessellations,
+                                 memory::shapeFootprint(project.shapes()).tessellationBytes);
+
+    const memory::Stats stats = memory::snapshot();
+    const std::vector<memory::BudgetViolation> violations = memory::checkBudgets(stats, budgets);
+
+    auto size = [](std::int64_t bytes) {
+        return QString::fromStdString(memory::formatBytes(bytes));
+    };
+
+    if (json) {
+        auto counter = [](std::int64_t bytes, std::int64_t peak) {
+            QJsonObject o;
+            o[QStringLiteral("bytes")] = static_cast<double>(bytes);
+            o[QStringLiteral("peak")] = static_cast<double>(peak);
+            return o;
+        };
+
+        QJsonObject tags;
+        for (const memory::TagStats& t : stats.tags) {
+            QJsonObject o = counter(t.bytes, t.peakBytes);
+            o[QStringLiteral("owners")] = static_cast<double>(t.owners);
+            tags[QString::fromLatin1(memory::tagName(t.tag))] = o;
+        }
+
+        QJsonObject root;
+        root[QStringLiteral("tags")] = tags;
+        root[QStringLiteral("total")] = counter(stats.totalBytes, stats.peakTotalBytes);
+        if (stats.heap.enabled) {
+            QJsonObject heap = counter(stats.heap.bytes, stats.heap.peakBytes);
+            heap[QStringLiteral("allocations")] = static_cast<double>(stats.heap.allocations);
+            root[QStringLiteral("heap")] = heap;
+        }
+        if (stats.process.available) {
+            root[QStringLiteral("rss")] = counter(stats.process.residentBytes,
+                                                  stats.process.peakResidentBytes);
+        }
+
+        QJsonArray exceeded;
+        for (const memory::BudgetViolation& v : violations) {
+            exceeded.append(QString::fromStdString(v.key));
+        }
+        root[QStringLiteral("exceeded")] = exceeded;
+
+        r.output = QString::fromUtf8(QJsonDocument(root).toJson(QJsonDocument::Indented)).trimmed();
+    } else {
+        auto row = [&size](const QString& label, std::int64_t bytes, std::int64_t peak,
+                           const QString& owners) {
+            return QStringLiteral("  ") + label.leftJustified(20) +
+                   size(bytes).rightJustified(12) + size(peak).rightJustified(12) +
+                   owners.rightJustified(8) + QLatin1Char('\n');
+        };
+
+        QString out;
+        if (!inputPath.isEmpty()) out += QStringLiteral("Loaded %1\n").arg(inputPath);
+        out += QStringLiteral("  ") + QStringLiteral("Counter").leftJustified(20) +
+               QStringLiteral("Current").rightJustified(12) +
+               QStringLiteral("Peak").rightJustified(12) +
+               QStringLiteral("Owners").rightJustified(8) + QLatin1Char('\n');
+        for (const memory::TagStats& t : stats.tags) {
+            out += row(QString::fromLatin1(memory::tagDisplayName(t.tag)),
+                       t.bytes, t.peakBytes, QString::number(t.owners));
+        }
+        out += row(QStringLiteral("Total"), stats.totalBytes, stats.peakTotalBytes, QString());
+        if (stats.heap.enabled) {
+            out += row(QStringLiteral("Heap (hooked)"), stats.heap.bytes, stats.heap.peakBytes,
+                       QString());
+        }
+        if (stats.process.available) {
+            out += row(QStringLiteral("Process resident"), stats.process.residentBytes,
+                       stats.process.peakResidentBytes, QString());
+        }
+        r.output = out.trimmed();
+    }
+
+    if (!violations.empty()) {
+        QString message = QStringLiteral("Memory budget exceeded:");
+        for (const memory::BudgetViolation& v : violations) {
+            message += QStringLiteral("\n  %1 peaked at %2 (budget %3)")
+                           .arg(QString::fromStdString(v.key), size(v.peakBytes),
+                                size(v.limitBytes));
+        }
+        r.exitCode = 1;
+        r.error = message;
+    }
     return r;
 }
 
@@ -88,6 +88,15 @@ private:
     CliResult cmdSave(const QStringList& args);
     CliResult cmdConvert(const QStringList& args);
     CliResult cmdScript(const QStringList& args);
+    CliResult cmdSnapshot(const QStringList& args);
+    CliResult cmdThumbnail(const QStringList& args);
+    CliResult cmdRepair(const QStringList& args);
+    CliResult cmdExtrude(const QStringList& args);
+    CliResult cmdRevolve(const QStringList& args);
+    CliResult cmdLint(const QStringList& args);
+    CliResult cmdClash(const QStringList& args);
+    CliResult cmdSlice(const QStringList& args);
+    CliResult cmdStats(const QStringList& args);
     CliResult cmdCd(const QStringList& args);
     CliResult cmdPwd() const;
     CliResult cmdInfo() const;
@@ -0,0 +1,248 @@
+// =====================================================================
+//  src/hobbycad/gui/backgroundjobs.cpp — Background job queue
+// =====================================================================
+
+#include "backgroundjobs.h"
+
+#include <Message_ProgressIndicator.hxx>
+#include <Message_ProgressScope.hxx>
+#include <Standard_Failure.hxx>
+
+#include <QMetaObject>
+#include <QPointer>
+#include <QRunnable>
+
+#include <atomic>
+#include <cmath>
+
+namespace hobbycad {
+
+// ---- Shared job control ---------------------------------------------
+
+/// State shared between the GUI thread and the worker running a job
+struct BackgroundJobManager::Control {
+    std::atomic<bool> cancelRequested{false};
+    std::atomic<int>  permille{0};           ///< Progress in 1/1000ths
+    std::atomic<bool> updatePending{false};  ///< A progress update is queued
+};
+
+namespace {
+
+/// Progress indicator that records the position for the GUI and
+/// reports cancellation requests back to OCCT algorithms.
+class JobProgressIndicator : public Message_ProgressIndicator {
+public:
+    using Notify = std::function<void()>;
+
+    JobProgressIndicator(std::shared_ptr<BackgroundJobManager::Control> control,
+                         Notify notify)
+        : m_control(std::move(control))
+        , m_notify(std::move(notify))
+    {
+    }
+
+    Standard_Boolean UserBreak() override
+    {
+        return m_control->cancelRequested.load();
+    }
+
+    void Show(const Message_ProgressScope& /*scope*/, const Standard_Boolean isForce) override
+    {
+        int permille = static_cast<int>(std::lround(GetPosition() * 1000.0));
+        if (permille == m_control->permille.load() && !isForce) return;
+        m_control->permille.store(permille);
+
+        // Coalesce: post at most one update until the GUI has consumed it
+        if (!m_control->updatePending.exchange(true)) {
+            m_notify();
+        }
+    }
+
+private:
+    std::shared_ptr<BackgroundJobManager::Control> m_control;
+    Notify m_notify;
+};
+
+}  // namespace
+
+// ---- BackgroundJobManager -------------------------------------------
+
+BackgroundJobManager::BackgroundJobManager(QObject* parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+BackgroundJobManager::~BackgroundJobManager()
+{
+    cancelAllAndWait();
+}
+
+int BackgroundJobManager::submit(const QString& title, Work work, Done done)
+{
+    const int id = m_nextId++;
+
+    JobInfo info;
+    info.id = id;
+    info.title = title;
+    m_jobs[id] = info;
+
+    auto control = std::make_shared<Control>();
+    m_controls[id] = control;
+    if (done) m_callbacks[id] = std::move(done);
+
+    QPointer<BackgroundJobManager> self(this);
+    auto* runnable = QRunnable::create([self, id, control, work = std::move(work)]() {
+        // Dropped while still queued
+        if (control->cancelRequested.load()) {
+            JobOutcome outcome;
+            outcome.cancelled = true;
+            QMetaObject::invokeMethod(self, [self, id, outcome]() {
+                if (self) self->onFinished(id, outcome);
+            }, Qt::QueuedConnection);
+            return;
+        }
+
+        QMetaObject::invokeMethod(self, [self, id]() {
+            if (self) self->onStarted(id);
+        }, Qt::QueuedConnection);
+
+        Handle(JobProgressIndicator) indicator = new JobProgressIndicator(control, [self, id]() {
+            QMetaObject::invokeMethod(self, [self, id]() {
+                if (self) self->onProgress(id);
+            }, Qt::QueuedConnection);
+        });
+
+        JobOutcome outcome;
+        try {
+            outcome = work(indicator->Start());
+        } catch (const Standard_Failure& e) {
+            outcome = JobOutcome{};
+            outcome.message = QString::fromUtf8(e.GetMessageString());
+        } catch (const std::exception& e) {
+            outcome = JobOutcome{};
+            outcome.message = QString::fromUtf8(e.what());
+        }
+        if (control->cancelRequested.load()) {
+            outcome.cancelled = true;
+        }
+
+        QMetaObject::invokeMethod(self, [self, id, outcome]() {
+            if (self) self->onFinished(id, outcome);
+        }, Qt::QueuedConnection);
+    });
+
+    emit jobAdded(id);
+    m_pool.start(runnable);
+    return id;
+}
+
+void BackgroundJobManager::cancel(int id)
+{
+    auto it = m_controls.find(id);
+    if (it != m_controls.end()) {
+        it->second->cancelRequested.store(true);
+    }
+}
+
+void BackgroundJobManager::cancelAllAndWait()
+{
+    for (auto& [id, control] : m_controls) {
+        control->cancelRequested.store(true);
+    }
+    m_pool.waitForDone();
+}
+
+bool BackgroundJobManager::hasActiveJobs() const
+{
+    return !m_controls.empty();
+}
+
+QList<JobInfo> BackgroundJobManager::jobs() const
+{
+    QList<JobInfo> list;
+    for (const auto& [id, info] : m_jobs) {
+        list.append(info);
+    }
+    return list;
+}
+
+JobInfo BackgroundJobManager::job(int id) const
+{
+    auto it = m_jobs.find(id);
+    return it != m_jobs.end() ? it->second : JobInfo{};
+}
+
+void BackgroundJobManager::clearFinished()
+{
+    for (auto it = m_jobs.begin(); it != m_jobs.end();) {
+        JobState state = it->second.state;
+        if (state == JobState::Finished || state == JobState::Failed ||
+            state == JobState::Cancelled) {
+            it = m_jobs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    emit jobsCleared();
+}
+
+QString BackgroundJobManager::stateName(JobState state)
+{
+    switch (state) {
+    case JobState::Queued:    return tr("Queued");
+    case JobState::Running:   return tr("Running");
+    case JobState::Finished:  return tr("Done");
+    case JobState::Failed:    return tr("Failed");
+    case JobState::Cancelled: return tr("Cancelled");
+    }
+    return QString();
+}
+
+void BackgroundJobManager::onStarted(int id)
+{
+    auto it = m_jobs.find(id);
+    if (it == m_jobs.end() || it->second.state != JobState::Queued) return;
+    it->second.state = JobState::Running;
+    emit jobChanged(id);
+}
+
+void BackgroundJobManager::onProgress(int id)
+{
+    auto control = m_controls.find(id);
+    auto it = m_jobs.find(id);
+    if (control == m_controls.end() || it == m_jobs.end()) return;
+
+    control->second->updatePending.store(false);
+    it->second.progress = control->second->permille.load() / 1000.0;
+    emit jobChanged(id);
+}
+
+void BackgroundJobManager::onFinished(int id, const JobOutcome& outcome)
+{
+    m_controls.erase(id);
+
+    auto it = m_jobs.find(id);
+    if (it != m_jobs.end()) {
+        if (outcome.cancelled) {
+            it->second.state = JobState::Cancelled;
+        } else if (outcome.success) {
+            it->second.state = JobState::Finished;
+            it->second.progress = 1.0;
+        } else {
+            it->second.state = JobState::Failed;
+        }
+        it->second.message = outcome.message;
+    }
+
+    auto cb = m_callbacks.find(id);
+    if (cb != m_callbacks.end()) {
+        Done done = std::move(cb->second);
+        m_callbacks.erase(cb);
+        done(outcome);
+    }
+
+    emit jobChanged(id);
+}
+
+}  // namespace hobbycad
@@ -0,0 +1,123 @@
+// =====================================================================
+//  src/hobbycad/gui/backgroundjobs.h — Background job queue
+// =====================================================================
+//
+//  Runs long file operations (STEP/STL import and export) on a worker
+//  thread so the main window stays responsive.  Each job receives an
+//  OCCT Message_ProgressRange; progress and cancellation flow through
+//  a Message_ProgressIndicator owned by the job.  Completion callbacks
+//  run on the GUI thread.
+//
+//  Jobs run one at a time in submission order: OCCT's STEP translators
+//  share process-wide static state, so running them concurrently would
+//  gain little and risk interference.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_BACKGROUNDJOBS_H
+#define HOBBYCAD_BACKGROUNDJOBS_H
+
+#include <Message_ProgressRange.hxx>
+#include <TopoDS_Shape.hxx>
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace hobbycad {
+
+/// Outcome returned by a job's work function
+struct JobOutcome {
+    bool success = false;
+    bool cancelled = false;
+    QString message;                    ///< Summary on success, error otherwise
+    std::vector<TopoDS_Shape> shapes;   ///< Shapes produced (imports)
+};
+
+/// Lifecycle state of a background job
+enum class JobState {
+    Queued,
+    Running,
+    Finished,
+    Failed,
+    Cancelled
+};
+
+/// Snapshot of a job for display
+struct JobInfo {
+    int id = 0;
+    QString title;
+    JobState state = JobState::Queued;
+    double progress = 0.0;              ///< 0.0 .. 1.0
+    QString message;                    ///< Outcome message once finished
+};
+
+/// Queue of background jobs with progress reporting and cancellation.
+class BackgroundJobManager : public QObject {
+    Q_OBJECT
+
+public:
+    /// Work function, called on the worker thread
+    using Work = std::function<JobOutcome(const Message_ProgressRange&)>;
+
+    /// Completion callback, called on the GUI thread
+    using Done = std::function<void(const JobOutcome&)>;
+
+    explicit BackgroundJobManager(QObject* parent = nullptr);
+    ~BackgroundJobManager() override;
+
+    /// Queue a job.  Returns its id.
+    int submit(const QString& title, Work work, Done done = {});
+
+    /// Request cancellation.  A queued job is dropped; a running job
+    /// stops at the next progress checkpoint.
+    void cancel(int id);
+
+    /// Cancel every queued and running job and wait for the worker.
+    void cancelAllAndWait();
+
+    /// True while any job is queued or running
+    bool hasActiveJobs() const;
+
+    /// All known jobs, oldest first
+    QList<JobInfo> jobs() const;
+
+    /// Information about one job (default JobInfo if unknown)
+    JobInfo job(int id) const;
+
+    /// Forget finished, failed and cancelled jobs
+    void clearFinished();
+
+    /// Human-readable state name
+    static QString stateName(JobState state);
+
+signals:
+    void jobAdded(int id);
+    void jobChanged(int id);
+    void jobsCleared();
+
+private:
+    struct Control;
+
+    void onProgress(int id);
+    void onStarted(int id);
+    void onFinished(int id, const JobOutcome& outcome);
+
+    QThreadPool m_pool;
+    int m_nextId = 1;
+    std::map<int, JobInfo> m_jobs;
+    std::map<int, std::shared_ptr<Control>> m_controls;
+    std::map<int, Done> m_callbacks;
+};
+
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_BACKGROUNDJOBS_H
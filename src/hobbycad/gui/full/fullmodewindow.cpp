@@ -44,24 +44,118 @@
 #include <AIS_InteractiveContext.hxx>
 #include <AIS_ListOfInteractive.hxx>
 #include <AIS_Shape.hxx>
-#include <BRep_Builder.hxx>
-#include <BRepBuilderAPI_MakeEdge.hxx>
-#include <BRepBuilderAPI_MakeVertex.hxx>
-#include <GC_MakeArcOfCircle.hxx>
+#include <gp.hxx>
 #include <gp_Ax1.hxx>
-#include <gp_Circ.hxx>
+#include <gp_Ax3.hxx>
 #include <gp_Pnt.hxx>
 #include <gp_Trsf.hxx>
 #include <Prs3d_Drawer.hxx>
 #include <Prs3d_LineAspect.hxx>
 #include <Quantity_Color.hxx>
 #include <Standard_Type.hxx>
-#include <TopoDS_Compound.hxx>
-#include <TopoDS_Edge.hxx>
+#include <TopLoc_Location.hxx>
 #include <TopoDS_Shape.hxx>
 
 namespace hobbycad {
 
+namespace {
+
+/// Timeline item for a project feature type
+/// @return false for types the timeline does not show (Origin)
+bool timelineFeatureFor(FeatureType type, TimelineFeature* feature)
+{
+    switch (type) {
+    case FeatureType::Sketch:
+        *feature = TimelineFeature::Sketch;
+        return true;
+    case FeatureType::Extrude:
+        *feature = TimelineFeature::Extrude;
+        return true;
+    case FeatureType::Revolve:
+        *feature = TimelineFeature::Revolve;
+        return true;
+    case FeatureType::Fillet:
+        *feature = TimelineFeature::Fillet;
+        return true;
+    case FeatureType::Chamfer:
+        *feature = TimelineFeature::Chamfer;
+        return true;
+    case FeatureType::Hole:
+        *feature = TimelineFeature::Hole;
+        return true;
+    case FeatureType::Mirror:
+        *feature = TimelineFeature::Mirror;
+        return true;
+    case FeatureType::Pattern:
+        *feature = TimelineFeature::Pattern;
+        return true;
+    case FeatureType::Box:
+        *feature = TimelineFeature::Box;
+        return true;
+    case FeatureType::Cylinder:
+        *feature = TimelineFeature::Cylinder;
+        return true;
+    case FeatureType::Sphere:
+        *feature = TimelineFeature::Sphere;
+        return true;
+    case FeatureType::Move:
+        *feature = TimelineFeature::Move;
+        return true;
+    case FeatureType::Join:
+        *feature = TimelineFeature::Join;
+        return true;
+    case FeatureType::Cut:
+        *feature = TimelineFeature::Cut;
+        return true;
+    case FeatureType::Intersect:
+        *feature = TimelineFeature::Intersect;
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// Project feature type of a timeline item
+FeatureType featureTypeFor(TimelineFeature feature)
+{
+    switch (feature) {
+    case TimelineFeature::Sketch:
+        return FeatureType::Sketch;
+    case TimelineFeature::Extrude:
+        return FeatureType::Extrude;
+    case TimelineFeature::Revolve:
+        return FeatureType::Revolve;
+    case TimelineFeature::Fillet:
+        return FeatureType::Fillet;
+    case TimelineFeature::Chamfer:
+        return FeatureType::Chamfer;
+    case TimelineFeature::Hole:
+        return FeatureType::Hole;
+    case TimelineFeature::Mirror:
+        return FeatureType::Mirror;
+    case TimelineFeature::Pattern:
+        return FeatureType::Pattern;
+    case TimelineFeature::Box:
+        return FeatureType::Box;
+    case TimelineFeature::Cylinder:
+        return FeatureType::Cylinder;
+    case TimelineFeature::Sphere:
+        return FeatureType::Sphere;
+    case TimelineFeature::Move:
+        return FeatureType::Move;
+    case TimelineFeature::Join:
+        return FeatureType::Join;
+    case TimelineFeature::Cut:
+        return FeatureType::Cut;
+    case TimelineFeature::Intersect:
+        return FeatureType::Intersect;
+    default:
+        return FeatureType::Origin;
+    }
+}
+
+}  // anonymous namespace
+
 FullModeWindow::FullModeWindow(const OpenGLInfo& glInfo, QWidget* parent)
     : MainWindow(glInfo, parent)
 {
@@ -320,10 +414,17 @@ void FullModeWindow::onDocumentLoaded()
     if (!m_project.isNew()) {
         loadProjectData();
     }
+
+    // Undo starts over from the loaded project
+    m_history.reset(captureModelState());
+    updateHistoryActions();
 }
 
 void FullModeWindow::onDocumentClosed()
 {
+    m_history.reset({});
+    updateHistoryActions();
+
     if (!m_viewport || m_viewport->context().IsNull()) return;
 
     auto ctx = m_viewport->context();
@@ -339,6 +440,7 @@ void FullModeWindow::onDocumentClosed()
 
     ctx->UpdateCurrentViewer();
     m_viewport->resetCamera();
+    updateTessellationCharge();
 }
 
 SketchCanvas* FullModeWindow::activeSketchCanvas() const
@@ -420,6 +522,11 @@ void FullModeWindow::applyPreferences()
         orbitSelectedAction()->setChecked(orbitSelected);
     }
 
+    // Undo memory budget (0 = unlimited); lowering it drops old steps
+    int undoBudgetMiB = s.value(QStringLiteral("undoBudgetMiB"), 256).toInt();
+    m_history.setMemoryBudget(static_cast<std::int64_t>(qMax(0, undoBudgetMiB)) << 20);
+    updateHistoryActions();
+
     s.endGroup();
 
     // Update axis label
@@ -581,6 +688,23 @@ void FullModeWindow::displayShapes()
     }
 
     m_viewport->context()->UpdateCurrentViewer();
+    updateTessellationCharge();
+}
+
+void FullModeWindow::updateTessellationCharge()
+{
+    if (!m_viewport || m_viewport->context().IsNull()) return;
+
+    // Displaying a shape meshes it, and the triangulations stay attached
+    // to its faces; shapes shown twice (shaded and wireframe) share them
+    std::vector<TopoDS_Shape> shapes;
+    AIS_ListOfInteractive displayed;
+    m_viewport->context()->DisplayedObjects(displayed);
+    for (auto it = displayed.begin(); it != displayed.end(); ++it) {
+        if (Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(*it))
+            shapes.push_back(aisShape->Shape());
+    }
+    m_tessellationCharge.set(memory::shapeFootprint(shapes).tessellationBytes);
 }
 
 void FullModeWindow::onCreateSketchClicked()
@@ -816,6 +940,7 @@ void FullModeWindow::onConstructionPlaneSelected(int planeId)
 void FullModeWindow::enterSketchMode(SketchPlane plane)
 {
     MainWindow::enterSketchMode(plane);
+    updateHistoryActions();
 
     // Determine if we're creating a new sketch or editing existing
     bool isNewSketch = (m_currentSketchIndex < 0);
@@ -877,6 +1002,9 @@ void FullModeWindow::exitSketchMode()
 
     // Switch back to 3D viewport
     m_viewportStack->setCurrentWidget(m_viewport);
+
+    // Edit > Undo acts on the model history again
+    updateHistoryActions();
 }
 
 void FullModeWindow::onSketchEntityModified(int entityId)
@@ -936,21 +1064,41 @@ void FullModeWindow::showSketchProperties()
     propsTree->expandAll();
 }
 
-Handle(AIS_Shape) FullModeWindow::createSketchWireframe(const CompletedSketch& sketch)
+brep::SketchEdgeCache& FullModeWindow::sketchEdges(CompletedSketch& sketch)
 {
-    BRep_Builder builder;
-    TopoDS_Compound compound;
-    builder.MakeCompound(compound);
+    if (!sketch.edgeCache) {
+        sketch.edgeCache = std::make_shared<brep::SketchEdgeCache>();
+    }
+    sketch.edgeCache->update(toLibraryEntities(sketch.entities));
+    return *sketch.edgeCache;
+}
 
-    // Build transformation for custom angled plane
-    // For standard planes, we just apply offset
-    // For custom planes, we rotate around the specified axis then apply offset
+Handle(AIS_Shape) FullModeWindow::createSketchWireframe(CompletedSketch& sketch)
+{
+    // The cached edges lie on the XY plane in sketch coordinates.  Place
+    // them on the sketch plane with a location rather than rebuilding
+    // them in 3D, so the displayed edges are the ones used for 3D
+    // operations.  Offset is applied along the plane's normal axis.
     double off = sketch.planeOffset;
-    gp_Trsf customTransform;
-    bool useCustomTransform = (sketch.plane == SketchPlane::Custom);
-
-    if (useCustomTransform) {
-        // Start with XY plane, then rotate around the specified axis
+    gp_Pnt origin(0, 0, off);
+    gp_Dir planeNormal(0, 0, 1);
+    gp_Dir planeXDir(1, 0, 0);
+    switch (sketch.plane) {
+    case SketchPlane::XY:
+        break;
+    case SketchPlane::XZ:
+        // Sketch Y runs along +Z
+        origin = gp_Pnt(0, off, 0);
+        planeNormal = gp_Dir(0, -1, 0);
+        break;
+    case SketchPlane::YZ:
+        origin = gp_Pnt(off, 0, 0);
+        planeNormal = gp_Dir(1, 0, 0);
+        planeXDir = gp_Dir(0, 1, 0);
+        break;
+    case SketchPlane::Custom: {
+        // Start with XY plane orientation, then rotate around the
+        // specified axis
         gp_Ax1 rotAxis;
         switch (sketch.rotationAxis) {
         case PlaneRotationAxis::X:
@@ -963,160 +1111,19 @@ Handle(AIS_Shape) FullModeWindow::createSketchWireframe(const CompletedSketch& s
             rotAxis = gp_Ax1(gp_Pnt(0, 0, 0), gp_Dir(0, 0, 1));
             break;
         }
-        double angleRad = sketch.rotationAngle * M_PI / 180.0;
-        customTransform.SetRotation(rotAxis, angleRad);
-    }
-
-    // Transform 2D point to 3D based on sketch plane and offset
-    // Offset is applied along the plane's normal axis
-    auto to3D = [&sketch, off, useCustomTransform, &customTransform](const QPointF& p) -> gp_Pnt {
-        gp_Pnt pt;
-        switch (sketch.plane) {
-        case SketchPlane::XY:
-            pt = gp_Pnt(p.x(), p.y(), off);  // Z offset
-            break;
-        case SketchPlane::XZ:
-            pt = gp_Pnt(p.x(), off, p.y());  // Y offset
-            break;
-        case SketchPlane::YZ:
-            pt = gp_Pnt(off, p.x(), p.y());  // X offset
-            break;
-        case SketchPlane::Custom:
-            // Start on XY plane at Z=0, then transform
-            pt = gp_Pnt(p.x(), p.y(), 0);
-            pt.Transform(customTransform);
-            // Apply offset along transformed normal (Z after rotation)
-            if (!qFuzzyIsNull(off)) {
-                gp_Dir normal(0, 0, 1);
-                normal.Transform(customTransform);
-                pt.SetX(pt.X() + normal.X() * off);
-                pt.SetY(pt.Y() + normal.Y() * off);
-                pt.SetZ(pt.Z() + normal.Z() * off);
-            }
-            break;
-        default:
-            pt = gp_Pnt(p.x(), p.y(), off);
-            break;
-        }
-        return pt;
-    };
-
-    // Get the plane normal and axes for circles/arcs
-    // Note: plane normal direction determines which way positive offset goes
-    gp_Dir planeNormal, planeXDir;
-    switch (sketch.plane) {
-    case SketchPlane::XY:
-        planeNormal = gp_Dir(0, 0, 1);  // +Z normal
-        planeXDir = gp_Dir(1, 0, 0);
-        break;
-    case SketchPlane::XZ:
-        planeNormal = gp_Dir(0, 1, 0);  // +Y normal
-        planeXDir = gp_Dir(1, 0, 0);
-        break;
-    case SketchPlane::YZ:
-        planeNormal = gp_Dir(1, 0, 0);  // +X normal
-        planeXDir = gp_Dir(0, 1, 0);
-        break;
-    case SketchPlane::Custom:
-        // Start with XY plane orientation, then rotate
-        planeNormal = gp_Dir(0, 0, 1);
-        planeXDir = gp_Dir(1, 0, 0);
-        planeNormal.Transform(customTransform);
-        planeXDir.Transform(customTransform);
-        break;
-    default:
-        planeNormal = gp_Dir(0, 0, 1);
-        planeXDir = gp_Dir(1, 0, 0);
+        gp_Trsf rotation;
+        rotation.SetRotation(rotAxis, sketch.rotationAngle * M_PI / 180.0);
+        planeNormal.Transform(rotation);
+        planeXDir.Transform(rotation);
+        origin = gp_Pnt(planeNormal.XYZ() * off);
         break;
     }
-
-    for (const SketchEntity& entity : sketch.entities) {
-        switch (entity.type) {
-        case SketchEntityType::Point:
-            if (!entity.points.empty()) {
-                gp_Pnt pt = to3D(entity.points[0]);
-                BRepBuilderAPI_MakeVertex mv(pt);
-                if (mv.IsDone()) {
-                    builder.Add(compound, mv.Vertex());
-                }
-            }
-            break;
-
-        case SketchEntityType::Line:
-            if (entity.points.size() >= 2) {
-                gp_Pnt p1 = to3D(entity.points[0]);
-                gp_Pnt p2 = to3D(entity.points[1]);
-                if (p1.Distance(p2) > 1e-6) {
-                    BRepBuilderAPI_MakeEdge me(p1, p2);
-                    if (me.IsDone()) {
-                        TopoDS_Shape edge = me.Edge();
-                        builder.Add(compound, edge);
-                    }
-                }
-            }
-            break;
-
-        case SketchEntityType::Rectangle:
-            if (entity.points.size() >= 2) {
-                gp_Pnt p1 = to3D(entity.points[0]);
-                gp_Pnt p2 = to3D(QPointF(entity.points[1].x, entity.points[0].y));
-                gp_Pnt p3 = to3D(entity.points[1]);
-                gp_Pnt p4 = to3D(QPointF(entity.points[0].x, entity.points[1].y));
-
-                auto addEdge = [&](const gp_Pnt& a, const gp_Pnt& b) {
-                    if (a.Distance(b) > 1e-6) {
-                        BRepBuilderAPI_MakeEdge me(a, b);
-                        if (me.IsDone()) {
-                            TopoDS_Shape edge = me.Edge();
-                            builder.Add(compound, edge);
-                        }
-                    }
-                };
-                addEdge(p1, p2);
-                addEdge(p2, p3);
-                addEdge(p3, p4);
-                addEdge(p4, p1);
-            }
-            break;
-
-        case SketchEntityType::Circle:
-            if (!entity.points.empty() && entity.radius > 1e-6) {
-                gp_Pnt center = to3D(entity.points[0]);
-                gp_Ax2 axis(center, planeNormal, planeXDir);
-                gp_Circ circle(axis, entity.radius);
-                BRepBuilderAPI_MakeEdge me(circle);
-                if (me.IsDone()) {
-                    TopoDS_Shape edge = me.Edge();
-                    builder.Add(compound, edge);
-                }
-            }
-            break;
-
-        case SketchEntityType::Arc:
-            if (!entity.points.empty() && entity.radius > 1e-6 &&
-                std::abs(entity.sweepAngle) > 1e-6) {
-                gp_Pnt center = to3D(entity.points[0]);
-                gp_Ax2 axis(center, planeNormal, planeXDir);
-                gp_Circ circle(axis, entity.radius);
-
-                // Convert angles to radians
-                double startRad = entity.startAngle * M_PI / 180.0;
-                double endRad = (entity.startAngle + entity.sweepAngle) * M_PI / 180.0;
-
-                BRepBuilderAPI_MakeEdge me(circle, startRad, endRad);
-                if (me.IsDone()) {
-                    TopoDS_Shape edge = me.Edge();
-                    builder.Add(compound, edge);
-                }
-            }
-            break;
-
-        default:
-            // TODO: Handle splines, text, dimensions
-            break;
-        }
     }
 
+    gp_Trsf placement;
+    placement.SetDisplacement(gp_Ax3(gp::XOY()), gp_Ax3(origin, planeNormal, planeXDir));
+    TopoDS_Shape compound = sketchEdges(sketch).wireframe().Moved(TopLoc_Location(placement));
+
     Handle(AIS_Shape) aisShape = new AIS_Shape(compound);
 
     // Set wireframe display mode with a distinct color
@@ -1193,6 +1200,11 @@ void FullModeWindow::saveCurrentSketch()
     sketch.rotationAngle = m_pendingRotationAngle;
     sketch.entities = m_sketchCanvas->entities();
 
+    // Keep the edges of entities the edit left alone
+    if (!isNewSketch) {
+        sketch.edgeCache = m_completedSketches[m_currentSketchIndex].edgeCache;
+    }
+
     // Create and display the 3D wireframe
     sketch.aisShape = createSketchWireframe(sketch);
     if (!sketch.aisShape.IsNull() && m_viewport) {
@@ -1235,8 +1247,9 @@ void FullModeWindow::saveCurrentSketch()
         sketchIndex = m_currentSketchIndex;
         CompletedSketch& existing = m_completedSketches[sketchIndex];
 
-        // Preserve the feature ID when editing
+        // Preserve the feature ID and suppression when editing
         sketch.featureId = existing.featureId;
+        sketch.suppressed = existing.suppressed;
 
         if (!existing.aisShape.IsNull() && m_viewport) {
             Handle(AIS_InteractiveContext) ctx = m_viewport->context();
@@ -1256,6 +1269,9 @@ void FullModeWindow::saveCurrentSketch()
     m_currentSketchIndex = -1;
     m_pendingSketchTimelineIdx = -1;
 
+    recordHistory(isNewSketch ? tr("Create '%1'").arg(sketchName)
+                              : tr("Edit '%1'").arg(sketchName));
+
     statusBar()->showMessage(
         tr("Sketch '%1' saved with %2 entities")
             .arg(sketchName)
@@ -1374,21 +1390,24 @@ FullModeWindow::getSelectedSketchProfiles(const QString& operationName)
         return std::nullopt;
     }
 
-    const CompletedSketch& sketch = m_completedSketches[sketchIdx];
+    CompletedSketch& sketch = m_completedSketches[sketchIdx];
     std::vector<sketch::Entity> libEntities = toLibraryEntities(sketch.entities);
+    brep::SketchEdgeCache& edges = sketchEdges(sketch);
 
     sketch::ProfileDetectionOptions options;
     options.excludeConstruction = true;
-    std::vector<sketch::Profile> profiles = sketch::detectProfiles(libEntities, options);
+    options.maxProfiles = 10000;  // Plates with hundreds of holes are common
+    std::vector<sketch::ProfileRegion> regions =
+        sketch::detectProfileRegions(libEntities, options);
 
-    if (profiles.empty()) {
+    if (regions.empty()) {
         QMessageBox::warning(this, operationName,
             tr("No closed profiles found in the sketch.\n"
                "Make sure the sketch contains a closed loop."));
         return std::nullopt;
     }
 
-    return SketchProfilesResult{&sketch, std::move(libEntities), std::move(profiles)};
+    return SketchProfilesResult{&sketch, &edges, std::move(regions)};
 }
 
 void FullModeWindow::onEditFeature(int index)
@@ -1456,6 +1475,7 @@ void FullModeWindow::onRenameFeature(int index)
             int sketchIdx = sketchIndexFromTimelineIndex(index);
             if (sketchIdx >= 0 && sketchIdx < m_completedSketches.size()) {
                 m_completedSketches[sketchIdx].name = newName;
+                m_completedSketches[sketchIdx].historyData.reset();
 
                 // Rebuild the timeline and tree with the new name
                 // (A cleaner approach would be to add a rename method to TimelineWidget)
@@ -1467,6 +1487,7 @@ void FullModeWindow::onRenameFeature(int index)
 
                 // Mark project as modified
                 m_project.setModified(true);
+                recordHistory(tr("Rename '%1'").arg(currentName));
 
                 statusBar()->showMessage(
                     tr("Renamed to '%1'").arg(newName), 3000);
@@ -1486,8 +1507,7 @@ void FullModeWindow::onDeleteFeature(int index)
     // Confirm deletion
     QMessageBox::StandardButton reply = QMessageBox::question(this,
         tr("Delete Feature"),
-        tr("Are you sure you want to delete '%1'?\n\n"
-           "This action cannot be undone.").arg(featureName),
+        tr("Are you sure you want to delete '%1'?").arg(featureName),
         QMessageBox::Yes | QMessageBox::No,
         QMessageBox::No);
 
@@ -1518,6 +1538,7 @@ void FullModeWindow::onDeleteFeature(int index)
 
             // Mark project as modified
             m_project.setModified(true);
+            recordHistory(tr("Delete '%1'").arg(featureName));
 
             statusBar()->showMessage(
                 tr("Deleted '%1'").arg(featureName), 3000);
@@ -1537,6 +1558,8 @@ void FullModeWindow::onSuppressFeature(int index, bool suppress)
         int sketchIdx = sketchIndexFromTimelineIndex(index);
         if (sketchIdx >= 0 && sketchIdx < m_completedSketches.size()) {
             CompletedSketch& sketch = m_completedSketches[sketchIdx];
+            sketch.suppressed = suppress;
+            m_timeline->setFeatureSuppressed(index, suppress);
 
             if (suppress) {
                 // Hide the sketch from viewport
@@ -1558,9 +1581,11 @@ void FullModeWindow::onSuppressFeature(int index, bool suppress)
 
             // Mark project as modified
             m_project.setModified(true);
+            recordHistory(suppress ? tr("Suppress '%1'").arg(featureName)
+                                   : tr("Unsuppress '%1'").arg(featureName));
         }
     }
-    // TODO: Handle other feature types, store suppression state
+    // TODO: Handle other feature types
 }
 
 void FullModeWindow::onExportSketchDXF(int index)
@@ -1705,6 +1730,10 @@ void FullModeWindow::onFeatureMoved(int fromIndex, int toIndex)
 
     // If the moved item isn't a sketch, we don't need to do anything yet
     // (no other feature types have backing data structures currently)
+
+    if (fromIndex != toIndex) {
+        recordHistory(tr("Move '%1'").arg(m_timeline->nameAt(toIndex)));
+    }
 }
 
 void FullModeWindow::onRollbackChanged(int index)
@@ -1835,55 +1864,8 @@ void FullModeWindow::populateTimeline()
             continue;
 
         TimelineFeature tlFeature;
-        switch (feature.type) {
-        case FeatureType::Sketch:
-            tlFeature = TimelineFeature::Sketch;
-            break;
-        case FeatureType::Extrude:
-            tlFeature = TimelineFeature::Extrude;
-            break;
-        case FeatureType::Revolve:
-            tlFeature = TimelineFeature::Revolve;
-            break;
-        case FeatureType::Fillet:
-            tlFeature = TimelineFeature::Fillet;
-            break;
-        case FeatureType::Chamfer:
-            tlFeature = TimelineFeature::Chamfer;
-            break;
-        case FeatureType::Hole:
-            tlFeature = TimelineFeature::Hole;
-            break;
-        case FeatureType::Mirror:
-            tlFeature = TimelineFeature::Mirror;
-            break;
-        case FeatureType::Pattern:
-            tlFeature = TimelineFeature::Pattern;
-            break;
-        case FeatureType::Box:
-            tlFeature = TimelineFeature::Box;
-            break;
-        case FeatureType::Cylinder:
-            tlFeature = TimelineFeature::Cylinder;
-            break;
-        case FeatureType::Sphere:
-            tlFeature = TimelineFeature::Sphere;
-            break;
-        case FeatureType::Move:
-            tlFeature = TimelineFeature::Move;
-            break;
-        case FeatureType::Join:
-            tlFeature = TimelineFeature::Join;
-            break;
-        case FeatureType::Cut:
-            tlFeature = TimelineFeature::Cut;
-            break;
-        case FeatureType::Intersect:
-            tlFeature = TimelineFeature::Intersect;
-            break;
-        default:
+        if (!timelineFeatureFor(feature.type, &tlFeature))
             continue;  // Skip unknown types
-        }
 
         m_timeline->addItem(tlFeature, QString::fromStdString(feature.name));
     }
@@ -1894,38 +1876,7 @@ void FullModeWindow::loadSketchesFromProject()
     const auto& projectSketches = m_project.sketches();
 
     for (const auto& sketchData : projectSketches) {
-        CompletedSketch sketch;
-        sketch.name = QString::fromStdString(sketchData.name);
-        sketch.plane = sketchData.plane;
-        sketch.planeOffset = sketchData.planeOffset;
-        sketch.rotationAxis = sketchData.rotationAxis;
-        sketch.rotationAngle = sketchData.rotationAngle;
-
-        // Convert SketchEntityData to SketchEntity
-        for (const auto& entityData : sketchData.entities) {
-            SketchEntity entity;
-            entity.id = entityData.id;
-            entity.type = entityData.type;
-            entity.points = entityData.points;
-            entity.radius = entityData.radius;
-            entity.startAngle = entityData.startAngle;
-            entity.sweepAngle = entityData.sweepAngle;
-            entity.sides = entityData.sides;
-            entity.majorRadius = entityData.majorRadius;
-            entity.minorRadius = entityData.minorRadius;
-            entity.text = entityData.text;
-            entity.fontFamily = entityData.fontFamily;
-            entity.fontSize = entityData.fontSize;
-            entity.fontBold = entityData.fontBold;
-            entity.fontItalic = entityData.fontItalic;
-            entity.textRotation = entityData.textRotation;
-            entity.arcFlipped = entityData.arcFlipped;
-            entity.constrained = entityData.constrained;
-            entity.isConstruction = entityData.isConstruction;
-            entity.selected = false;
-
-            sketch.entities.append(entity);
-        }
+        CompletedSketch sketch = completedSketchFromData(sketchData);
 
         // Create the 3D wireframe representation
         sketch.aisShape = createSketchWireframe(sketch);
@@ -1934,6 +1885,43 @@ void FullModeWindow::loadSketchesFromProject()
     }
 }
 
+CompletedSketch FullModeWindow::completedSketchFromData(const SketchData& sketchData) const
+{
+    CompletedSketch sketch;
+    sketch.name = QString::fromStdString(sketchData.name);
+    sketch.plane = sketchData.plane;
+    sketch.planeOffset = sketchData.planeOffset;
+    sketch.rotationAxis = sketchData.rotationAxis;
+    sketch.rotationAngle = sketchData.rotationAngle;
+
+    // Convert SketchEntityData to SketchEntity
+    for (const auto& entityData : sketchData.entities) {
+        SketchEntity entity;
+        entity.id = entityData.id;
+        entity.type = entityData.type;
+        entity.points = entityData.points;
+        entity.radius = entityData.radius;
+        entity.startAngle = entityData.startAngle;
+        entity.sweepAngle = entityData.sweepAngle;
+        entity.sides = entityData.sides;
+        entity.majorRadius = entityData.majorRadius;
+        entity.minorRadius = entityData.minorRadius;
+        entity.text = entityData.text;
+        entity.fontFamily = entityData.fontFamily;
+        entity.fontSize = entityData.fontSize;
+        entity.fontBold = entityData.fontBold;
+        entity.fontItalic = entityData.fontItalic;
+        entity.textRotation = entityData.textRotation;
+        entity.arcFlipped = entityData.arcFlipped;
+        entity.constrained = entityData.constrained;
+        entity.isConstruction = entityData.isConstruction;
+        entity.selected = false;
+
+        sketch.entities.append(entity);
+    }
+    return sketch;
+}
+
 void FullModeWindow::loadParametersFromProject()
 {
     const auto& projectParams = m_project.parameters();
@@ -2045,8 +2033,8 @@ void FullModeWindow::performExtrude()
     if (!sketchData) return;
 
     const CompletedSketch& sketch = *sketchData->sketch;
-    auto& profiles = sketchData->profiles;
-    auto& libEntities = sketchData->libEntities;
+    auto& regions = sketchData->regions;
+    brep::SketchEdgeCache& edges = *sketchData->edges;
 
     // Show extrude dialog
     ExtrudeDialog dialog(this);
@@ -2080,16 +2068,10 @@ void FullModeWindow::performExtrude()
         extrudeDir.Reverse();
     }
 
-    // Perform extrusion using library
-    brep::OperationResult result;
-
-    if (direction == ExtrudeDirection::TwoSided) {
-        result = brep::extrudeProfileSymmetric(
-            profiles[0], libEntities, extrudeDir, distance, true);
-    } else {
-        result = brep::extrudeProfile(
-            profiles[0], libEntities, extrudeDir, distance);
-    }
+    // Extrude every region, holes included, in one prism
+    brep::OperationResult result = brep::extrudeRegions(
+        regions, edges, extrudeDir, distance,
+        direction == ExtrudeDirection::TwoSided);
 
     if (!result.success) {
         QMessageBox::critical(this, tr("Extrude Failed"),
@@ -2123,6 +2105,7 @@ void FullModeWindow::performExtrude()
             // Replace the last body
             m_solidBodies.last() = boolResult.shape;
             finalShape = boolResult.shape;
+            syncDocumentBodies({existingBody});
 
             // Update display
             Handle(AIS_InteractiveContext) ctx = m_viewport->context();
@@ -2144,6 +2127,7 @@ void FullModeWindow::performExtrude()
         Handle(AIS_InteractiveContext) ctx = m_viewport->context();
         ctx->Display(aisShape, Standard_True);
     }
+    updateTessellationCharge();
 
     // Add extrude feature to timeline
     int featureId = m_nextFeatureId++;
@@ -2151,6 +2135,7 @@ void FullModeWindow::performExtrude()
         tr("Extrude%1").arg(m_solidBodies.size()));
     m_timeline->setFeatureId(insertIdx, featureId);
     m_timeline->setDependencies(insertIdx, {sketch.featureId});
+    recordHistory(m_timeline->nameAt(insertIdx));
 
     // Fit view to show the new solid
     m_viewport->fitAll();
@@ -2164,8 +2149,8 @@ void FullModeWindow::performRevolve()
     if (!sketchData) return;
 
     const CompletedSketch& sketch = *sketchData->sketch;
-    auto& profiles = sketchData->profiles;
-    auto& libEntities = sketchData->libEntities;
+    auto& regions = sketchData->regions;
+    brep::SketchEdgeCache& edges = *sketchData->edges;
 
     // Show revolve dialog
     RevolveDialog dialog(this);
@@ -2231,9 +2216,9 @@ void FullModeWindow::performRevolve()
     }
     }
 
-    // Perform revolution
-    brep::OperationResult result = brep::revolveProfile(
-        profiles[0], libEntities, axis, angle);
+    // Revolve every region, holes included, in one revolution
+    brep::OperationResult result = brep::revolveRegions(
+        regions, edges, axis, angle);
 
     if (!result.success) {
         QMessageBox::critical(this, tr("Revolve Failed"),
@@ -2265,6 +2250,7 @@ void FullModeWindow::performRevolve()
         if (boolResult.success) {
             m_solidBodies.last() = boolResult.shape;
             finalShape = boolResult.shape;
+            syncDocumentBodies({existingBody});
 
             Handle(AIS_InteractiveContext) ctx = m_viewport->context();
             ctx->Remove(m_solidAisShapes.last(), Standard_False);
@@ -2284,6 +2270,7 @@ void FullModeWindow::performRevolve()
         Handle(AIS_InteractiveContext) ctx = m_viewport->context();
         ctx->Display(aisShape, Standard_True);
     }
+    updateTessellationCharge();
 
     // Add revolve feature to timeline
     int featureId = m_nextFeatureId++;
@@ -2291,11 +2278,225 @@ void FullModeWindow::performRevolve()
         tr("Revolve%1").arg(m_solidBodies.size()));
     m_timeline->setFeatureId(insertIdx, featureId);
     m_timeline->setDependencies(insertIdx, {sketch.featureId});
+    recordHistory(m_timeline->nameAt(insertIdx));
 
     m_viewport->fitAll();
 
     statusBar()->showMessage(tr("Revolution completed"), 3000);
 }
 
+// ---- Project History ------------------------------------------------
+
+history::ModelState FullModeWindow::captureModelState()
+{
+    history::ModelState state;
+    state.bodies.assign(m_solidBodies.begin(), m_solidBodies.end());
+
+    // Sketches the last operation left alone reuse their recorded data
+    for (CompletedSketch& sketch : m_completedSketches) {
+        if (!sketch.historyData) {
+            auto data = std::make_shared<SketchData>();
+            data->name = sketch.name.toStdString();
+            data->plane = sketch.plane;
+            data->planeOffset = sketch.planeOffset;
+            data->rotationAxis = sketch.rotationAxis;
+            data->rotationAngle = sketch.rotationAngle;
+            data->entities = toLibraryEntities(sketch.entities);
+            sketch.historyData = std::move(data);
+        }
+        state.sketches.push_back({sketch.featureId, sketch.historyData});
+    }
+
+    // Timeline after the Origin
+    for (int i = 1; i < m_timeline->itemCount(); ++i) {
+        FeatureData feature;
+        feature.id = m_timeline->featureIdAt(i);
+        feature.type = featureTypeFor(m_timeline->featureAt(i));
+        feature.name = m_timeline->nameAt(i).toStdString();
+        const QVector<int> deps = m_timeline->dependenciesAt(i);
+        feature.dependsOn.assign(deps.begin(), deps.end());
+        feature.suppressed = m_timeline->isFeatureSuppressed(i);
+        feature.state = m_timeline->featureStateAt(i);
+        state.features.push_back(std::move(feature));
+    }
+
+    state.nextFeatureId = m_nextFeatureId;
+    return state;
+}
+
+void FullModeWindow::recordHistory(const QString& description)
+{
+    m_history.record(description.toStdString(), captureModelState());
+    updateHistoryActions();
+}
+
+void FullModeWindow::restoreModelState(const history::ModelState& state)
+{
+    Handle(AIS_InteractiveContext) ctx;
+    if (m_viewport) ctx = m_viewport->context();
+
+    // Bodies the step left alone keep their presentation (and mesh)
+    const QVector<TopoDS_Shape> previousBodies = m_solidBodies;
+    QVector<Handle(AIS_Shape)> bodyShapes;
+    for (const TopoDS_Shape& body : state.bodies) {
+        Handle(AIS_Shape) aisShape;
+        for (int i = 0; i < m_solidBodies.size(); ++i) {
+            if (m_solidBodies[i].IsSame(body) && !m_solidAisShapes[i].IsNull()) {
+                aisShape = m_solidAisShapes[i];
+                m_solidAisShapes[i].Nullify();
+                break;
+            }
+        }
+        if (aisShape.IsNull()) {
+            aisShape = new AIS_Shape(body);
+            if (!ctx.IsNull()) ctx->Display(aisShape, Standard_False);
+        }
+        bodyShapes.append(aisShape);
+    }
+    for (const Handle(AIS_Shape)& aisShape : m_solidAisShapes) {
+        if (!aisShape.IsNull() && !ctx.IsNull()) ctx->Remove(aisShape, Standard_False);
+    }
+    m_solidBodies = QVector<TopoDS_Shape>(state.bodies.begin(), state.bodies.end());
+    m_solidAisShapes = bodyShapes;
+    syncDocumentBodies(previousBodies);
+
+    // Unchanged sketches keep their wireframe and edge cache
+    QVector<CompletedSketch> sketches;
+    for (const history::SketchState& recorded : state.sketches) {
+        if (!recorded.data) continue;
+        CompletedSketch sketch;
+        bool reused = false;
+        for (CompletedSketch& existing : m_completedSketches) {
+            if (existing.historyData == recorded.data) {
+                sketch = existing;
+                existing = CompletedSketch();
+                reused = true;
+                break;
+            }
+        }
+        if (!reused) {
+            sketch = completedSketchFromData(*recorded.data);
+            sketch.historyData = recorded.data;
+            sketch.aisShape = createSketchWireframe(sketch);
+        }
+        sketch.featureId = recorded.featureId;
+        sketches.append(sketch);
+    }
+    for (const CompletedSketch& sketch : m_completedSketches) {
+        if (!sketch.aisShape.IsNull() && !ctx.IsNull()) ctx->Remove(sketch.aisShape, Standard_False);
+    }
+    m_completedSketches = sketches;
+
+    // Rebuild the timeline after the Origin.  Removing items walks the
+    // rollback marker back, so remember where it was.
+    const int rollback = m_timeline->rollbackPosition();
+    while (m_timeline->itemCount() > 1) {
+        m_timeline->removeItem(m_timeline->itemCount() - 1);
+    }
+    for (const FeatureData& feature : state.features) {
+        TimelineFeature tlFeature;
+        if (!timelineFeatureFor(feature.type, &tlFeature))
+            continue;
+        m_timeline->addItem(tlFeature, QString::fromStdString(feature.name));
+        int index = m_timeline->itemCount() - 1;
+        m_timeline->setFeatureId(index, feature.id);
+        m_timeline->setDependencies(index,
+            QVector<int>(feature.dependsOn.begin(), feature.dependsOn.end()));
+        m_timeline->setFeatureSuppressed(index, feature.suppressed);
+        m_timeline->setFeatureState(index, feature.state);
+    }
+    m_nextFeatureId = state.nextFeatureId;
+    const int restoredRollback = rollback < m_timeline->itemCount() ? rollback : -1;
+
+    // Show sketches unless suppressed or past the rollback marker
+    for (int i = 0; i < m_completedSketches.size(); ++i) {
+        CompletedSketch& sketch = m_completedSketches[i];
+        int timelineIdx = timelineIndexFromSketchIndex(i);
+        sketch.suppressed = timelineIdx >= 0 && m_timeline->isFeatureSuppressed(timelineIdx);
+        if (sketch.aisShape.IsNull() || ctx.IsNull())
+            continue;
+        bool rolledBack = restoredRollback >= 0 && timelineIdx > restoredRollback;
+        if (sketch.suppressed || rolledBack) {
+            if (ctx->IsDisplayed(sketch.aisShape))
+                ctx->Erase(sketch.aisShape, Standard_False);
+        } else if (!ctx->IsDisplayed(sketch.aisShape)) {
+            ctx->Display(sketch.aisShape, Standard_False);
+        }
+    }
+
+    clearSketchesInTree();
+    for (int i = 0; i < m_completedSketches.size(); ++i) {
+        addSketchToTree(m_completedSketches[i].name, i);
+    }
+
+    if (!ctx.IsNull()) ctx->UpdateCurrentViewer();
+    m_timeline->setRollbackPosition(restoredRollback);
+    updateTessellationCharge();
+    m_project.setModified(true);
+    updateHistoryActions();
+}
+
+void FullModeWindow::undoModel()
+{
+    QString description = QString::fromStdString(m_history.undoDescription());
+    const history::ModelState* state = m_history.undo();
+    if (!state) return;
+
+    restoreModelState(*state);
+    statusBar()->showMessage(tr("Undid %1").arg(description), 3000);
+}
+
+void FullModeWindow::redoModel()
+{
+    QString description = QString::fromStdString(m_history.redoDescription());
+    const history::ModelState* state = m_history.redo();
+    if (!state) return;
+
+    restoreModelState(*state);
+    statusBar()->showMessage(tr("Redid %1").arg(description), 3000);
+}
+
+void FullModeWindow::updateHistoryActions()
+{
+    // In sketch mode the actions follow the sketch's own undo stack
+    if (m_inSketchMode) {
+        if (undoAction()) undoAction()->setText(tr("&Undo"));
+        if (redoAction()) redoAction()->setText(tr("&Redo"));
+        return;
+    }
+
+    if (undoAction()) {
+        undoAction()->setEnabled(m_history.canUndo());
+        undoAction()->setText(m_history.canUndo()
+            ? tr("&Undo %1").arg(QString::fromStdString(m_history.undoDescription()))
+            : tr("&Undo"));
+    }
+    if (redoAction()) {
+        redoAction()->setEnabled(m_history.canRedo());
+        redoAction()->setText(m_history.canRedo()
+            ? tr("&Redo %1").arg(QString::fromStdString(m_history.redoDescription()))
+            : tr("&Redo"));
+    }
+}
+
+void FullModeWindow::syncDocumentBodies(const QVector<TopoDS_Shape>& previous)
+{
+    // Keep the document's other shapes (loaded or imported) in place and
+    // append the current bodies in place of the previous ones
+    std::vector<TopoDS_Shape> shapes;
+    for (const TopoDS_Shape& shape : m_document.shapes()) {
+        bool isBody = false;
+        for (const TopoDS_Shape& body : previous) {
+            if (body.IsSame(shape)) {
+                isBody = true;
+                break;
+            }
+        }
+        if (!isBody) shapes.push_back(shape);
+    }
+    shapes.insert(shapes.end(), m_solidBodies.begin(), m_solidBodies.end());
+    m_document.setShapes(shapes);
+}
+
 }  // namespace hobbycad
 
@@ -12,12 +12,16 @@
 #include "gui/timelinewidget.h"
 #include "gui/full/aissketchplane.h"
 
+#include <hobbycad/brep/edge_cache.h>
+#include <hobbycad/history.h>
+#include <hobbycad/memory.h>
 #include <hobbycad/sketch/profiles.h>
 
 #include <AIS_Shape.hxx>
 #include <TopoDS_Shape.hxx>
 
 #include <QList>
+#include <memory>
 #include <optional>
 
 class QLabel;
@@ -40,6 +44,12 @@ struct CompletedSketch {
     QVector<SketchEntity> entities;
     Handle(AIS_Shape) aisShape;  ///< 3D wireframe for viewport display
     bool suppressed = false;    ///< True if suppressed in timeline
+    /// Edges shared by the wireframe and 3D operations; kept across
+    /// edits so only changed entities are rebuilt
+    std::shared_ptr<brep::SketchEdgeCache> edgeCache;
+    /// This sketch as recorded in the undo history; shared with it
+    /// until the sketch is edited or renamed
+    std::shared_ptr<const SketchData> historyData;
 };
 
 class FullModeWindow : public MainWindow {
@@ -58,6 +68,8 @@ protected:
     void onDocumentClosed() override;
     void applyPreferences() override;
     SketchCanvas* activeSketchCanvas() const override;
+    void undoModel() override;
+    void redoModel() override;
     bool getSelectedSketchForExport(
         QVector<sketch::Entity>& outEntities,
         QVector<sketch::Constraint>& outConstraints) const override;
@@ -94,8 +106,10 @@ private:
 
     void createTimeline();
     void displayShapes();
+    void updateTessellationCharge();
     void showSketchProperties();
-    Handle(AIS_Shape) createSketchWireframe(const CompletedSketch& sketch);
+    Handle(AIS_Shape) createSketchWireframe(CompletedSketch& sketch);
+    brep::SketchEdgeCache& sketchEdges(CompletedSketch& sketch);
 
     // Sketch plane visualization
     void showSketchPlane(SketchPlane plane, double offset,
@@ -111,6 +125,14 @@ private:
     void loadParametersFromProject();
     void loadConstructionPlanesFromProject();
     void clearProjectData();
+    CompletedSketch completedSketchFromData(const SketchData& data) const;
+
+    // Project-level undo/redo
+    history::ModelState captureModelState();
+    void recordHistory(const QString& description);
+    void restoreModelState(const history::ModelState& state);
+    void updateHistoryActions();
+    void syncDocumentBodies(const QVector<TopoDS_Shape>& previous);
 
     // Construction plane display
     void displayConstructionPlane(int planeId);
@@ -125,12 +147,13 @@ private:
     std::optional<TimelineFeature> validateFeatureAction(
         int index, const QString& actionVerb) const;
 
-    /// Retrieve a selected sketch's profiles for 3D operations (extrude/revolve).
+    /// Retrieve a selected sketch's profile regions (outer profiles with
+    /// their holes) for 3D operations (extrude/revolve).
     /// Returns std::nullopt with appropriate error messages on failure.
     struct SketchProfilesResult {
         const CompletedSketch* sketch = nullptr;
-        std::vector<sketch::Entity> libEntities;
-        std::vector<sketch::Profile> profiles;
+        brep::SketchEdgeCache* edges = nullptr;
+        std::vector<sketch::ProfileRegion> regions;
     };
     std::optional<SketchProfilesResult> getSelectedSketchProfiles(
         const QString& operationName);
@@ -154,6 +177,12 @@ private:
     // 3D solid bodies from extrude/revolve operations
     QVector<TopoDS_Shape> m_solidBodies;
     QVector<Handle(AIS_Shape)> m_solidAisShapes;
+
+    // Triangulations of the displayed shapes (memory accounting)
+    memory::Charge m_tessellationCharge{memory::Tag::Tessellations};
+
+    // Feature-level undo/redo of bodies, sketches and the timeline
+    history::ProjectHistory m_history;
 };
 
 }  // namespace hobbycad
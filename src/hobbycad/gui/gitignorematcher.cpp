@@ -0,0 +1,121 @@
+// =====================================================================
+//  src/hobbycad/gui/gitignorematcher.cpp — Compiled .gitignore matcher
+// =====================================================================
+
+#include "gitignorematcher.h"
+
+namespace hobbycad {
+
+GitIgnoreMatcher::GitIgnoreMatcher(const QStringList& patterns)
+{
+    for (QString line : patterns) {
+        line = line.trimmed();
+        if (line.isEmpty() || line.startsWith(QLatin1Char('#'))) continue;
+
+        Rule rule;
+        if (line.startsWith(QLatin1Char('!'))) {
+            rule.negated = true;
+            line.remove(0, 1);
+        } else if (line.startsWith(QLatin1String("\\!")) ||
+                   line.startsWith(QLatin1String("\\#"))) {
+            line.remove(0, 1);  // Escaped literal '!' or '#'
+        }
+
+        if (line.endsWith(QLatin1Char('/'))) {
+            rule.dirOnly = true;
+            line.chop(1);
+        }
+        if (line.isEmpty()) continue;
+
+        // A slash anywhere but the end anchors the pattern to the root;
+        // otherwise it matches a name at any depth
+        bool anchored = line.contains(QLatin1Char('/'));
+        if (line.startsWith(QLatin1Char('/'))) line.remove(0, 1);
+
+        QString regex = globToRegex(line);
+        if (!anchored) regex.prepend(QStringLiteral("(?:.*/)?"));
+
+        rule.regex.setPattern(QStringLiteral("^") + regex + QStringLiteral("$"));
+        rule.regex.optimize();
+        if (rule.regex.isValid()) {
+            m_rules.append(rule);
+        }
+    }
+}
+
+bool GitIgnoreMatcher::isIgnored(const QString& relativePath, bool isDir) const
+{
+    if (m_rules.isEmpty() || relativePath.isEmpty()) return false;
+
+    // Git cannot re-include a file whose parent directory is excluded,
+    // so any ignored ancestor decides the result
+    int slash = relativePath.indexOf(QLatin1Char('/'));
+    while (slash > 0) {
+        if (evaluate(relativePath.left(slash), true) == 1) return true;
+        slash = relativePath.indexOf(QLatin1Char('/'), slash + 1);
+    }
+
+    return evaluate(relativePath, isDir) == 1;
+}
+
+int GitIgnoreMatcher::evaluate(const QString& path, bool isDir) const
+{
+    // Last matching rule wins
+    for (int i = m_rules.size() - 1; i >= 0; --i) {
+        const Rule& rule = m_rules[i];
+        if (rule.dirOnly && !isDir) continue;
+        if (rule.regex.match(path).hasMatch()) {
+            return rule.negated ? 0 : 1;
+        }
+    }
+    return -1;
+}
+
+QString GitIgnoreMatcher::globToRegex(const QString& glob)
+{
+    QString out;
+    const int n = glob.size();
+
+    for (int i = 0; i < n; ++i) {
+        const QChar c = glob[i];
+
+        if (c == QLatin1Char('*')) {
+            bool doubleStar = i + 1 < n && glob[i + 1] == QLatin1Char('*');
+            bool atSegmentStart = i == 0 || glob[i - 1] == QLatin1Char('/');
+            if (doubleStar && atSegmentStart) {
+                if (i + 2 == n) {
+                    out += QStringLiteral(".*");                 // trailing "**"
+                    i += 1;
+                    continue;
+                }
+                if (glob[i + 2] == QLatin1Char('/')) {
+                    out += QStringLiteral("(?:.*/)?");           // "**/" — zero or more dirs
+                    i += 2;
+                    continue;
+                }
+            }
+            out += QStringLiteral("[^/]*");
+        } else if (c == QLatin1Char('?')) {
+            out += QStringLiteral("[^/]");
+        } else if (c == QLatin1Char('[')) {
+            int close = glob.indexOf(QLatin1Char(']'), i + 1);
+            if (close < 0) {
+                out += QStringLiteral("\\[");
+                continue;
+            }
+            QString cls = glob.mid(i + 1, close - i - 1);
+            if (cls.startsWith(QLatin1Char('!'))) cls[0] = QLatin1Char('^');
+            cls.replace(QLatin1String("\\"), QLatin1String("\\\\"));
+            out += QLatin1Char('[') + cls + QLatin1Char(']');
+            i = close;
+        } else if (c == QLatin1Char('\\') && i + 1 < n) {
+            out += QRegularExpression::escape(QString(glob[++i]));
+        } else {
+            out += QRegularExpression::escape(QString(c));
+        }
+    }
+
+    return out;
+}
+
+}  // namespace hobbycad
@@ -0,0 +1,58 @@
+// =====================================================================
+//  src/hobbycad/gui/gitignorematcher.h — Compiled .gitignore matcher
+// =====================================================================
+//
+//  Compiles .gitignore patterns once into regular expressions and
+//  answers "is this path ignored?" following git's rules: last match
+//  wins, '!' re-includes, a trailing '/' matches directories only,
+//  patterns containing '/' are anchored to the project root, and a
+//  file inside an ignored directory is ignored.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_GITIGNOREMATCHER_H
+#define HOBBYCAD_GITIGNOREMATCHER_H
+
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace hobbycad {
+
+class GitIgnoreMatcher {
+public:
+    GitIgnoreMatcher() = default;
+
+    /// Compile a list of raw .gitignore lines (comments and blank
+    /// lines are skipped).
+    explicit GitIgnoreMatcher(const QStringList& patterns);
+
+    /// True if no rules were compiled
+    bool isEmpty() const { return m_rules.isEmpty(); }
+
+    /// Check a path relative to the project root ('/' separators).
+    /// @param relativePath Path to test (e.g., "build/out.stl")
+    /// @param isDir True if the path names a directory
+    bool isIgnored(const QString& relativePath, bool isDir) const;
+
+private:
+    struct Rule {
+        QRegularExpression regex;
+        bool negated = false;
+        bool dirOnly = false;
+    };
+
+    /// Result of the last matching rule: 1 ignored, 0 re-included, -1 no match
+    int evaluate(const QString& path, bool isDir) const;
+
+    static QString globToRegex(const QString& glob);
+
+    QVector<Rule> m_rules;
+};
+
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_GITIGNOREMATCHER_H
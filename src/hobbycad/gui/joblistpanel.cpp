@@ -0,0 +1,142 @@
+// =====================================================================
+//  src/hobbycad/gui/joblistpanel.cpp — Background job list panel
+// =====================================================================
+
+#include "joblistpanel.h"
+#include "backgroundjobs.h"
+
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QSet>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+namespace hobbycad {
+
+namespace {
+
+// Tree column indices
+constexpr int kColTitle    = 0;
+constexpr int kColState    = 1;
+constexpr int kColProgress = 2;
+
+}  // namespace
+
+JobListPanel::JobListPanel(BackgroundJobManager* manager, QWidget* parent)
+    : QWidget(parent)
+    , m_manager(manager)
+{
+    setObjectName(QStringLiteral("JobListPanel"));
+
+    auto* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    m_tree = new QTreeWidget;
+    m_tree->setHeaderLabels({tr("Job"), tr("Status"), tr("Progress")});
+    m_tree->setRootIsDecorated(false);
+    m_tree->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_tree->header()->setSectionResizeMode(kColTitle, QHeaderView::Stretch);
+    layout->addWidget(m_tree);
+
+    auto* buttonRow = new QHBoxLayout;
+    buttonRow->addStretch();
+    m_cancelBtn = new QPushButton(tr("Cancel Job"));
+    m_cancelBtn->setEnabled(false);
+    buttonRow->addWidget(m_cancelBtn);
+    m_clearBtn = new QPushButton(tr("Clear Finished"));
+    buttonRow->addWidget(m_clearBtn);
+    layout->addLayout(buttonRow);
+
+    connect(m_manager, &BackgroundJobManager::jobAdded,
+            this, &JobListPanel::onJobAdded);
+    connect(m_manager, &BackgroundJobManager::jobChanged,
+            this, &JobListPanel::onJobChanged);
+    connect(m_manager, &BackgroundJobManager::jobsCleared,
+            this, &JobListPanel::onJobsCleared);
+    connect(m_tree, &QTreeWidget::itemSelectionChanged,
+            this, &JobListPanel::updateButtons);
+    connect(m_cancelBtn, &QPushButton::clicked,
+            this, &JobListPanel::onCancelClicked);
+    connect(m_clearBtn, &QPushButton::clicked,
+            m_manager, &BackgroundJobManager::clearFinished);
+
+    for (const JobInfo& info : m_manager->jobs()) {
+        onJobAdded(info.id);
+    }
+}
+
+void JobListPanel::onJobAdded(int id)
+{
+    auto* item = new QTreeWidgetItem(m_tree);
+    item->setData(kColTitle, Qt::UserRole, id);
+
+    auto* bar = new QProgressBar;
+    bar->setRange(0, 1000);
+    bar->setTextVisible(false);
+    bar->setMaximumHeight(14);
+    m_tree->setItemWidget(item, kColProgress, bar);
+
+    m_items.insert(id, item);
+    updateItem(item, id);
+}
+
+void JobListPanel::onJobChanged(int id)
+{
+    if (QTreeWidgetItem* item = m_items.value(id)) {
+        updateItem(item, id);
+    }
+    updateButtons();
+}
+
+void JobListPanel::onJobsCleared()
+{
+    const QList<JobInfo> remaining = m_manager->jobs();
+    QSet<int> keep;
+    for (const JobInfo& info : remaining) keep.insert(info.id);
+
+    for (auto it = m_items.begin(); it != m_items.end();) {
+        if (!keep.contains(it.key())) {
+            delete it.value();
+            it = m_items.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    updateButtons();
+}
+
+void JobListPanel::onCancelClicked()
+{
+    const auto selected = m_tree->selectedItems();
+    if (selected.isEmpty()) return;
+    m_manager->cancel(selected.first()->data(kColTitle, Qt::UserRole).toInt());
+}
+
+void JobListPanel::updateButtons()
+{
+    const auto selected = m_tree->selectedItems();
+    bool canCancel = false;
+    if (!selected.isEmpty()) {
+        JobState state = m_manager->job(
+            selected.first()->data(kColTitle, Qt::UserRole).toInt()).state;
+        canCancel = state == JobState::Queued || state == JobState::Running;
+    }
+    m_cancelBtn->setEnabled(canCancel);
+}
+
+void JobListPanel::updateItem(QTreeWidgetItem* item, int id)
+{
+    const JobInfo info = m_manager->job(id);
+    item->setText(kColTitle, info.title);
+    item->setText(kColState, BackgroundJobManager::stateName(info.state));
+    item->setToolTip(kColTitle, info.message.isEmpty() ? info.title : info.message);
+    item->setToolTip(kColState, info.message);
+
+    if (auto* bar = qobject_cast<QProgressBar*>(m_tree->itemWidget(item, kColProgress))) {
+        bar->setValue(static_cast<int>(info.progress * 1000.0));
+    }
+}
+
+}  // namespace hobbycad
@@ -0,0 +1,52 @@
+// =====================================================================
+//  src/hobbycad/gui/joblistpanel.h — Background job list panel
+// =====================================================================
+//
+//  Lists queued, running and finished background jobs with a progress
+//  bar per job.  The selected job can be cancelled; finished entries
+//  can be cleared.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_JOBLISTPANEL_H
+#define HOBBYCAD_JOBLISTPANEL_H
+
+#include <QHash>
+#include <QWidget>
+
+class QPushButton;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+namespace hobbycad {
+
+class BackgroundJobManager;
+
+class JobListPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit JobListPanel(BackgroundJobManager* manager, QWidget* parent = nullptr);
+
+private slots:
+    void onJobAdded(int id);
+    void onJobChanged(int id);
+    void onJobsCleared();
+    void onCancelClicked();
+    void updateButtons();
+
+private:
+    void updateItem(QTreeWidgetItem* item, int id);
+
+    BackgroundJobManager* m_manager = nullptr;
+    QTreeWidget* m_tree      = nullptr;
+    QPushButton* m_cancelBtn = nullptr;
+    QPushButton* m_clearBtn  = nullptr;
+    QHash<int, QTreeWidgetItem*> m_items;
+};
+
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_JOBLISTPANEL_H
@@ -4,10 +4,13 @@
 
 #include "mainwindow.h"
 #include "aboutdialog.h"
+#include "backgroundjobs.h"
 #include "bindingsdialog.h"
 #include "changelogpanel.h"
 #include "clipanel.h"
 #include "formulafield.h"
+#include "joblistpanel.h"
+#include "memorypanel.h"
 #include "modeltoolbar.h"
 #include "parametersdialog.h"
 #include "preferencesdialog.h"
@@ -15,6 +18,7 @@
 #include "sketchactionbar.h"
 #include "sketchplanedialog.h"
 #include "sketchtoolbar.h"
+#include "snapshotdialog.h"
 #include "timelinewidget.h"
 
 #include "sketchcanvas.h"
@@ -25,6 +29,8 @@
 #include <hobbycad/stl_io.h>
 #include <hobbycad/units.h>
 
+#include <BRepBuilderAPI_Copy.hxx>
+
 #include <QAction>
 #include <QActionGroup>
 #include <QKeySequence>
@@ -279,6 +285,10 @@ void MainWindow::finalizeLayout()
         m_actionToggleTerminal->setChecked(!m_terminalDock->isHidden());
     if (m_actionToggleChangelog && m_changelogDock)
         m_actionToggleChangelog->setChecked(!m_changelogDock->isHidden());
+    if (m_actionToggleJobs && m_jobsDock)
+        m_actionToggleJobs->setChecked(!m_jobsDock->isHidden());
+    if (m_actionToggleMemory && m_memoryDock)
+        m_actionToggleMemory->setChecked(!m_memoryDock->isHidden());
 
     // Apply keyboard bindings from settings
     applyBindings();
@@ -344,6 +354,13 @@ void MainWindow::createMenus()
 
     fileMenu->addSeparator();
 
+    m_actionSnapshotHistory = fileMenu->addAction(tr("Snapshot &History..."),
+        this, &MainWindow::onFileSnapshotHistory);
+    m_actionSnapshotHistory->setToolTip(tr("Browse and restore saved project snapshots"));
+    m_actionSnapshotHistory->setEnabled(snapshot::SnapshotStore::isAvailable());
+
+    fileMenu->addSeparator();
+
     m_actionQuit = fileMenu->addAction(tr("&Quit"), this, &MainWindow::onFileQuit);
     m_actionQuit->setShortcut(QKeySequence::Quit);
 
@@ -424,6 +441,14 @@ void MainWindow::createMenus()
     m_actionToggleChangelog->setCheckable(true);
     m_actionToggleChangelog->setChecked(false);
 
+    m_actionToggleJobs = viewMenu->addAction(tr("&Jobs"));
+    m_actionToggleJobs->setCheckable(true);
+    m_actionToggleJobs->setChecked(false);
+
+    m_actionToggleMemory = viewMenu->addAction(tr("&Memory"));
+    m_actionToggleMemory->setCheckable(true);
+    m_actionToggleMemory->setChecked(false);
+
     viewMenu->addSeparator();
 
     // Workspace submenu
@@ -758,6 +783,43 @@ void MainWindow::createDockPanels()
     connect(m_changelogDock, &QDockWidget::visibilityChanged,
             m_actionToggleChangelog, &QAction::setChecked);
 
+    // Background job list
+    m_jobManager = new BackgroundJobManager(this);
+
+    m_jobsDock = new QDockWidget(tr("Jobs"), this);
+    m_jobsDock->setObjectName(QStringLiteral("JobsDock"));
+    m_jobsDock->setAllowedAreas(Qt::AllDockWidgetAreas);
+    m_jobsDock->setWidget(new JobListPanel(m_jobManager, m_jobsDock));
+
+    addDockWidget(Qt::RightDockWidgetArea, m_jobsDock);
+
+    // Start hidden — shown when a job is queued or via View > Jobs
+    m_jobsDock->setVisible(false);
+
+    connect(m_actionToggleJobs, &QAction::toggled,
+            m_jobsDock, &QDockWidget::setVisible);
+    connect(m_jobsDock, &QDockWidget::visibilityChanged,
+            m_actionToggleJobs, &QAction::setChecked);
+    connect(m_jobManager, &BackgroundJobManager::jobAdded, this, [this]() {
+        m_jobsDock->setVisible(true);
+    });
+
+    // Memory diagnostics
+    m_memoryDock = new QDockWidget(tr("Memory"), this);
+    m_memoryDock->setObjectName(QStringLiteral("MemoryDock"));
+    m_memoryDock->setAllowedAreas(Qt::AllDockWidgetAreas);
+    m_memoryDock->setWidget(new MemoryPanel(m_memoryDock));
+
+    addDockWidget(Qt::RightDockWidgetArea, m_memoryDock);
+
+    // Start hidden — toggled via View > Memory
+    m_memoryDock->setVisible(false);
+
+    connect(m_actionToggleMemory, &QAction::toggled,
+            m_memoryDock, &QDockWidget::setVisible);
+    connect(m_memoryDock, &QDockWidget::visibilityChanged,
+            m_actionToggleMemory, &QAction::setChecked);
+
     // Embedded terminal panel
     m_terminalDock = new QDockWidget(tr("Terminal"), this);
     m_terminalDock->setObjectName(QStringLiteral("TerminalDock"));
@@ -815,6 +877,7 @@ void MainWindow::onFileNew()
 {
     if (!maybeSave()) return;
 
+    ++m_documentGeneration;
     m_document.clear();
     m_document.setModified(false);  // New document starts unmodified
     updateTitle();
@@ -844,6 +907,7 @@ void MainWindow::onFileOpen()
         std::string errorMsg;
         if (m_project.load(path.toStdString(), &errorMsg)) {
             // Sync document shapes from project
+            ++m_documentGeneration;
             m_document.clear();
             for (const auto& shape : m_project.shapes()) {
                 m_document.addShape(shape);
@@ -875,6 +939,7 @@ void MainWindow::onFileOpen()
 
         if (m_document.loadBrep(path.toStdString())) {
             // Clear project state since we're loading raw geometry only
+            ++m_documentGeneration;
             m_project.close();
 
             updateTitle();
@@ -894,8 +959,9 @@ void MainWindow::onFileSave()
     if (!m_project.isNew()) {
         // Save to existing project
         std::string errorMsg;
-        if (m_project.save({}, &errorMsg)) {
+        if (saveProject({}, &errorMsg)) {
             m_document.setModified(false);
+            takeAutoSnapshot();
             updateTitle();
             m_statusLabel->setText(tr("Saved project: %1").arg(QString::fromStdString(m_project.name())));
         } else {
@@ -955,8 +1021,9 @@ void MainWindow::onFileSaveAs()
         m_project.setName(info.fileName().toStdString());
 
         std::string errorMsg;
-        if (m_project.save(path.toStdString(), &errorMsg)) {
+        if (saveProject(path.toStdString(), &errorMsg)) {
             m_document.setModified(false);
+            takeAutoSnapshot();
 
             // Update project browser with new path
             if (m_projectBrowser) {
@@ -1002,25 +1069,52 @@ void MainWindow::onFileImportStep()
         return;
     }
 
-    // Read the STEP file
-    step_io::ReadResult result = step_io::readStep(filePath.toStdString());
+    // Read the STEP file in the background; shapes are added to the
+    // document when the job completes, unless the document has been
+    // replaced (New, Open, Close) in the meantime
+    const QString fileName = QFileInfo(filePath).fileName();
+    const std::string path = filePath.toStdString();
+    const quint64 generation = m_documentGeneration;
+
+    m_jobManager->submit(tr("Import %1").arg(fileName),
+        [path](const Message_ProgressRange& progress) {
+            step_io::ReadResult result = step_io::readStep(path, progress);
+            JobOutcome outcome;
+            outcome.success = result.success;
+            outcome.cancelled = result.cancelled;
+            outcome.message = QString::fromStdString(result.errorMessage);
+            outcome.shapes = std::move(result.shapes);
+            return outcome;
+        },
+        [this, fileName, generation](const JobOutcome& outcome) {
+            if (outcome.cancelled) {
+                statusBar()->showMessage(tr("Import of %1 cancelled").arg(fileName), 5000);
+                return;
+            }
+            if (generation != m_documentGeneration) {
+                statusBar()->showMessage(
+                    tr("Import of %1 discarded: the document was replaced").arg(fileName), 5000);
+                return;
+            }
+            if (!outcome.success) {
+                QMessageBox::critical(this, tr("Import Failed"),
+                    tr("Failed to import STEP file:\n%1").arg(outcome.message));
+                return;
+            }
 
-    if (!result.success) {
-        QMessageBox::critical(this, tr("Import Failed"),
-            tr("Failed to import STEP file:\n%1").arg(QString::fromStdString(result.errorMessage)));
-        return;
-    }
+            // Add shapes to the document
+            for (const TopoDS_Shape& shape : outcome.shapes) {
+                m_document.addShape(shape);
+            }
 
-    // Add shapes to the document
-    for (const TopoDS_Shape& shape : result.shapes) {
-        m_document.addShape(shape);
-    }
+            m_document.setModified(true);
+            onDocumentLoaded();
 
-    m_document.setModified(true);
-    onDocumentLoaded();
+            statusBar()->showMessage(
+                tr("Imported %1 shape(s) from %2").arg(outcome.shapes.size()).arg(fileName), 5000);
+        });
 
-    statusBar()->showMessage(
-        tr("Imported %1 shape(s) from STEP file").arg(result.shapeCount), 5000);
+    statusBar()->showMessage(tr("Importing %1...").arg(fileName), 5000);
 }
 
 void MainWindow::onFileExportStep()
@@ -1050,17 +1144,45 @@ void MainWindow::onFileExportStep()
         filePath += QStringLiteral(".step");
     }
 
-    // Write the STEP file
-    step_io::WriteResult result = step_io::writeStep(filePath.toStdString(), shapes);
-
-    if (!result.success) {
-        QMessageBox::critical(this, tr("Export Failed"),
-            tr("Failed to export STEP file:\n%1").arg(QString::fromStdString(result.errorMessage)));
-        return;
-    }
+    // Write the STEP file in the background.  The shape handles are
+    // copied, so later document edits (or a different document being
+    // opened) do not affect the export; completion only reports status.
+    // Identical bodies are written once as a shared part.
+    const QString fileName = QFileInfo(filePath).fileName();
+    const std::string path = filePath.toStdString();
+    std::vector<step_io::AssemblyBody> bodies;
+    for (const TopoDS_Shape& shape : shapes) {
+        step_io::AssemblyBody body;
+        body.shape = shape;
+        bodies.push_back(body);
+    }
+
+    m_jobManager->submit(tr("Export %1").arg(fileName),
+        [path, bodies](const Message_ProgressRange& progress) {
+            step_io::WriteResult result = step_io::writeStepAssembly(
+                path, bodies, step_io::AssemblyOptions(), progress);
+            JobOutcome outcome;
+            outcome.success = result.success;
+            outcome.cancelled = result.cancelled;
+            outcome.message = result.success
+                ? tr("Exported %1 shape(s) as %2 part(s)")
+                      .arg(result.shapeCount).arg(result.partCount)
+                : QString::fromStdString(result.errorMessage);
+            return outcome;
+        },
+        [this, fileName](const JobOutcome& outcome) {
+            if (outcome.cancelled) {
+                statusBar()->showMessage(tr("Export of %1 cancelled").arg(fileName), 5000);
+            } else if (!outcome.success) {
+                QMessageBox::critical(this, tr("Export Failed"),
+                    tr("Failed to export STEP file:\n%1").arg(outcome.message));
+            } else {
+                statusBar()->showMessage(
+                    tr("%1 to %2").arg(outcome.message, fileName), 5000);
+            }
+        });
 
-    statusBar()->showMessage(
-        tr("Exported %1 shape(s) to STEP file").arg(result.shapeCount), 5000);
+    statusBar()->showMessage(tr("Exporting %1...").arg(fileName), 5000);
 }
 
 void MainWindow::onFileExportStl()
@@ -1089,16 +1211,45 @@ void MainWindow::onFileExportStl()
         filePath += QStringLiteral(".stl");
     }
 
-    // Write the STL file with default quality
-    stl_io::WriteResult result = stl_io::writeStl(filePath.toStdString(), shapes);
+    // Mesh and write the STL file in the background with default quality.
+    // As with STEP export, the job owns copies of the shape handles, so
+    // it writes the document as it was when the export was requested.
+    const QString fileName = QFileInfo(filePath).fileName();
+    const std::string path = filePath.toStdString();
+    std::vector<TopoDS_Shape> exportShapes = shapes;
+
+    m_jobManager->submit(tr("Export %1").arg(fileName),
+        [path, exportShapes](const Message_ProgressRange& progress) {
+            // Meshing attaches triangulations to faces; mesh a private
+            // copy so the viewer's shapes are never modified off-thread
+            std::vector<TopoDS_Shape> copies;
+            copies.reserve(exportShapes.size());
+            for (const TopoDS_Shape& shape : exportShapes) {
+                if (!shape.IsNull()) {
+                    copies.push_back(BRepBuilderAPI_Copy(shape, Standard_True, Standard_False).Shape());
+                }
+            }
 
-    if (!result.success) {
-        QMessageBox::critical(this, tr("Export Failed"),
-            tr("Failed to export STL file:\n%1").arg(QString::fromStdString(result.errorMessage)));
-        return;
-    }
+            stl_io::WriteResult result = stl_io::writeStl(
+                path, copies, stl_io::StlFormat::Binary, stl_io::defaultQuality(), progress);
+            JobOutcome outcome;
+            outcome.success = result.success;
+            outcome.cancelled = result.cancelled;
+            outcome.message = QString::fromStdString(result.errorMessage);
+            return outcome;
+        },
+        [this, fileName](const JobOutcome& outcome) {
+            if (outcome.cancelled) {
+                statusBar()->showMessage(tr("Export of %1 cancelled").arg(fileName), 5000);
+            } else if (!outcome.success) {
+                QMessageBox::critical(this, tr("Export Failed"),
+                    tr("Failed to export STL file:\n%1").arg(outcome.message));
+            } else {
+                statusBar()->showMessage(tr("Exported geometry to %1").arg(fileName), 5000);
+            }
+        });
 
-    statusBar()->showMessage(tr("Exported geometry to STL file"), 5000);
+    statusBar()->showMessage(tr("Exporting %1...").arg(fileName), 5000);
 }
 
 void MainWindow::setSketchExportEnabled(bool enabled)
@@ -1249,9 +1400,11 @@ void MainWindow::onFileClose()
 {
     if (!maybeSave()) return;
 
+    ++m_documentGeneration;
     m_document.clear();
     m_document.setModified(false);
     m_project.close();
+    m_snapshotStore.close();
     updateTitle();
     onDocumentClosed();
     m_statusLabel->setText(tr("Document closed"));
@@ -1261,7 +1414,25 @@ void MainWindow::onFileClose()
 
 void MainWindow::closeEvent(QCloseEvent* event)
 {
+    // Ask about running jobs and unsaved changes before cancelling
+    // anything, so backing out of either prompt leaves jobs running
+    const bool jobsActive = m_jobManager && m_jobManager->hasActiveJobs();
+    if (jobsActive) {
+        auto answer = QMessageBox::question(this,
+            tr("Jobs Running"),
+            tr("Background imports or exports are still running.\n"
+               "Cancel them and quit?"));
+        if (answer != QMessageBox::Yes) {
+            event->ignore();
+            return;
+        }
+    }
+
     if (maybeSave()) {
+        if (jobsActive) {
+            m_jobManager->cancelAllAndWait();
+        }
+
         // Save window geometry and dock/toolbar state
         QSettings settings;
 
@@ -1336,12 +1507,13 @@ bool MainWindow::maybeSave()
         if (!m_project.isNew()) {
             // Save to existing project
             std::string errorMsg;
-            if (!m_project.save({}, &errorMsg)) {
+            if (!saveProject({}, &errorMsg)) {
                 QMessageBox::warning(this,
                     tr("Save Failed"),
                     tr("Could not save project:\n%1").arg(QString::fromStdString(errorMsg)));
                 return false;
             }
+            takeAutoSnapshot();
         } else if (!m_document.isNew()) {
             // Save to existing BREP file
             if (!m_document.saveBrep()) {
@@ -1374,12 +1546,13 @@ bool MainWindow::maybeSave()
                 m_project.setName(info.baseName().replace(QStringLiteral(".hcad"), QString()).toStdString());
 
                 std::string errorMsg;
-                if (!m_project.save(path.toStdString(), &errorMsg)) {
+                if (!saveProject(path.toStdString(), &errorMsg)) {
                     QMessageBox::warning(this,
                         tr("Save Failed"),
                         tr("Could not save project:\n%1").arg(QString::fromStdString(errorMsg)));
                     return false;
                 }
+                takeAutoSnapshot();
             } else {
                 path = ensureBrepExtension(path, selectedFilter);
                 if (!m_document.saveBrep(path.toStdString())) {
@@ -1396,12 +1569,91 @@ bool MainWindow::maybeSave()
     return true;
 }
 
+bool MainWindow::saveProject(const std::string& path, std::string* errorMsg)
+{
+    QSettings settings;
+    settings.beginGroup(QStringLiteral("preferences"));
+    bool asJson = settings.value(QStringLiteral("sketchesAsJson"), false).toBool();
+    settings.endGroup();
+
+    m_project.setSketchFileFormat(asJson ? SketchFileFormat::Json
+                                         : SketchFileFormat::Binary);
+    return m_project.save(path, errorMsg);
+}
+
+void MainWindow::takeAutoSnapshot()
+{
+    if (!snapshot::SnapshotStore::isAvailable() || m_project.isNew()) return;
+
+    QSettings settings;
+    settings.beginGroup(QStringLiteral("preferences"));
+    bool enabled = settings.value(QStringLiteral("autoSnapshot"), true).toBool();
+    settings.endGroup();
+    if (!enabled) return;
+
+    const std::string projectDir = m_project.projectPath();
+    if (!m_snapshotStore.isOpen() || m_snapshotStore.projectDir() != projectDir) {
+        std::string errorMsg;
+        if (!m_snapshotStore.open(projectDir, &errorMsg)) {
+            qWarning("Snapshot store unavailable: %s", errorMsg.c_str());
+            return;
+        }
+    }
+
+    // A failed snapshot must never fail the save itself
+    auto result = m_snapshotStore.takeSnapshot("Save");
+    if (!result.success) {
+        qWarning("Snapshot failed: %s", result.errorMessage.c_str());
+    }
+}
+
 void MainWindow::onHelpAbout()
 {
     AboutDialog dlg(m_glInfo, this);
     dlg.exec();
 }
 
+void MainWindow::onFileSnapshotHistory()
+{
+    if (m_project.isNew()) {
+        QMessageBox::information(this,
+            tr("Snapshot History"),
+            tr("Save the project first — snapshots are recorded for saved projects."));
+        return;
+    }
+
+    // The dialog opens its own store; release ours so the stat cache
+    // does not go stale when files are restored underneath it
+    m_snapshotStore.close();
+
+    SnapshotDialog dlg(QString::fromStdString(m_project.projectPath()), this);
+    connect(&dlg, &SnapshotDialog::snapshotRestored, this, [this]() {
+        std::string errorMsg;
+        if (!m_project.load(m_project.projectPath(), &errorMsg)) {
+            QMessageBox::warning(this,
+                tr("Restore Failed"),
+                tr("Could not reload project:\n%1").arg(QString::fromStdString(errorMsg)));
+            return;
+        }
+
+        ++m_documentGeneration;
+        m_document.clear();
+        for (const auto& shape : m_project.shapes()) {
+            m_document.addShape(shape);
+        }
+        m_document.setModified(false);
+
+        if (m_projectBrowser) {
+            m_projectBrowser->setProject(&m_project);
+        }
+
+        updateTitle();
+        onDocumentLoaded();
+        m_statusLabel->setText(tr("Restored project snapshot"));
+    });
+    dlg.exec();
+}
+
 void MainWindow::onEditPreferences()
 {
     PreferencesDialog dlg(this);
@@ -1879,6 +2131,10 @@ void MainWindow::enterSketchMode(SketchPlane plane)
     m_sketchCanvas->setSketchSelected(true);
     m_viewportStack->setCurrentWidget(m_sketchCanvas);
 
+    // Undo/redo now act on the sketch being edited
+    if (undoAction()) undoAction()->setEnabled(m_sketchCanvas->canUndo());
+    if (redoAction()) redoAction()->setEnabled(m_sketchCanvas->canRedo());
+
     // Update status bar and focus canvas
     statusBar()->showMessage(tr("Sketch mode - Draw entities or press Escape to finish"));
     m_sketchCanvas->setFocus();
@@ -1901,6 +2157,11 @@ void MainWindow::exitSketchMode()
     // Switch back to normal toolbar
     m_toolbarStack->setCurrentWidget(m_toolbar);
 
+    // Undo/redo return to the model (subclasses with a model history
+    // re-enable them)
+    if (undoAction()) undoAction()->setEnabled(false);
+    if (redoAction()) redoAction()->setEnabled(false);
+
     // Hide the Save/Cancel action bar
     setSketchActionBarVisible(false);
 
@@ -1933,18 +2194,27 @@ void MainWindow::initSketchConnections()
             tr("X: %1  Y: %2").arg(pos.x(), 0, 'f', 2).arg(pos.y(), 0, 'f', 2));
     });
 
-    // Undo/redo wiring
+    // Undo/redo wiring: the sketch's own stack in sketch mode, the
+    // model history otherwise
     if (undoAction()) {
-        connect(undoAction(), &QAction::triggered,
-                m_sketchCanvas, &SketchCanvas::undo);
+        connect(undoAction(), &QAction::triggered, this, [this]() {
+            if (m_inSketchMode) m_sketchCanvas->undo();
+            else undoModel();
+        });
         connect(m_sketchCanvas, &SketchCanvas::undoAvailabilityChanged,
-                undoAction(), &QAction::setEnabled);
+                this, [this](bool available) {
+            if (m_inSketchMode) undoAction()->setEnabled(available);
+        });
     }
     if (redoAction()) {
-        connect(redoAction(), &QAction::triggered,
-                m_sketchCanvas, &SketchCanvas::redo);
+        connect(redoAction(), &QAction::triggered, this, [this]() {
+            if (m_inSketchMode) m_sketchCanvas->redo();
+            else redoModel();
+        });
         connect(m_sketchCanvas, &SketchCanvas::redoAvailabilityChanged,
-                redoAction(), &QAction::setEnabled);
+                this, [this](bool available) {
+            if (m_inSketchMode) redoAction()->setEnabled(available);
+        });
     }
 
     // Changelog panel
@@ -18,6 +18,7 @@
 #include <hobbycad/document.h>
 #include <hobbycad/opengl_info.h>
 #include <hobbycad/project.h>
+#include <hobbycad/snapshot.h>
 #include <hobbycad/units.h>
 
 #include <QMainWindow>
@@ -37,6 +38,7 @@ struct Entity;
 struct Constraint;
 }  // namespace sketch
 
+class BackgroundJobManager;
 class ChangelogPanel;
 class CliPanel;
 class ProjectBrowserWidget;
@@ -91,6 +93,12 @@ protected:
     /// Override to provide the active sketch canvas (for sketch export).
     virtual class SketchCanvas* activeSketchCanvas() const { return nullptr; }
 
+    /// Override to undo the last model operation (Edit > Undo outside sketch mode).
+    virtual void undoModel() {}
+
+    /// Override to redo the last undone model operation.
+    virtual void redoModel() {}
+
     /// Initialize shared sketch signal/slot connections.
     /// Call from subclass constructor after creating widgets.
     void initSketchConnections();
@@ -295,6 +303,7 @@ private slots:
     void onFileExportStl();
     void onFileExportDXF();
     void onFileExportSVG();
+    void onFileSnapshotHistory();
     void onEditPreferences();
     void onHelpAbout();
 
@@ -311,6 +320,14 @@ private:
     /// Returns false if the user cancelled.
     bool maybeSave();
 
+    /// Record the just-saved project in its snapshot history, if the
+    /// "autoSnapshot" preference is on and libgit2 support is built in.
+    void takeAutoSnapshot();
+
+    /// Save m_project, choosing the sketch encoding from the
+    /// "sketchesAsJson" preference.
+    bool saveProject(const std::string& path, std::string* errorMsg);
+
     // Menus
     QAction* m_actionNew    = nullptr;
     QAction* m_actionOpen   = nullptr;
@@ -322,6 +339,7 @@ private:
     QAction* m_actionExportStl = nullptr;
     QAction* m_actionExportDXF = nullptr;
     QAction* m_actionExportSVG = nullptr;
+    QAction* m_actionSnapshotHistory = nullptr;
     QAction* m_actionQuit   = nullptr;
     QAction* m_actionUndo   = nullptr;
     QAction* m_actionRedo   = nullptr;
@@ -337,6 +355,8 @@ private:
     QAction* m_actionToggleProperties = nullptr;
     QAction* m_actionToggleToolbar = nullptr;
     QAction* m_actionToggleChangelog = nullptr;
+    QAction* m_actionToggleJobs = nullptr;
+    QAction* m_actionToggleMemory = nullptr;
     QAction* m_actionResetView = nullptr;
     QAction* m_actionRotateLeft = nullptr;
     QAction* m_actionRotateRight = nullptr;
@@ -357,10 +377,14 @@ private:
     QDockWidget* m_propertiesDock  = nullptr;
     QDockWidget* m_terminalDock    = nullptr;
     QDockWidget* m_changelogDock   = nullptr;
+    QDockWidget* m_jobsDock        = nullptr;
+    QDockWidget* m_memoryDock      = nullptr;
     CliPanel*    m_cliPanel        = nullptr;
     QTreeWidget* m_propertiesTree  = nullptr;
     SketchActionBar* m_sketchActionBar = nullptr;
     ChangelogPanel*  m_changelogPanel  = nullptr;
+    BackgroundJobManager* m_jobManager = nullptr;  // STEP/STL import/export jobs
+    quint64 m_documentGeneration = 0;  // Bumped when the document is replaced; stale imports are dropped
     ProjectBrowserWidget* m_projectBrowser = nullptr;  // In Project panel's Files tab
 
     // Feature tree container items
@@ -368,6 +392,10 @@ private:
     QTreeWidgetItem* m_bodiesTreeItem = nullptr;
     QTreeWidgetItem* m_constructionTreeItem = nullptr;
 
+    // Snapshot store kept open across saves so unchanged files are
+    // recognised by size/mtime without rehashing
+    snapshot::SnapshotStore m_snapshotStore;
+
     // Current unit system (0=mm, 1=cm, 2=m, 3=in, 4=ft)
     int m_currentUnits = 0;
 
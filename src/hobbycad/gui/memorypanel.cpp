@@ -0,0 +1,137 @@
+// =====================================================================
+//  src/hobbycad/gui/memorypanel.cpp — Memory diagnostics panel
+// =====================================================================
+
+#include "memorypanel.h"
+
+#include <hobbycad/memory.h>
+
+#include <QFont>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QTimer>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+namespace hobbycad {
+
+namespace {
+
+// Tree column indices
+constexpr int kColOwner   = 0;
+constexpr int kColCurrent = 1;
+constexpr int kColPeak    = 2;
+constexpr int kColCount   = 3;
+
+constexpr int kRefreshMs = 1000;
+
+QString sizeText(std::int64_t bytes)
+{
+    return QString::fromStdString(memory::formatBytes(bytes));
+}
+
+}  // namespace
+
+MemoryPanel::MemoryPanel(QWidget* parent)
+    : QWidget(parent)
+{
+    setObjectName(QStringLiteral("MemoryPanel"));
+
+    auto* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    m_tree = new QTreeWidget;
+    m_tree->setHeaderLabels({tr("Owner"), tr("Current"), tr("Peak"), tr("Objects")});
+    m_tree->setRootIsDecorated(false);
+    m_tree->setSelectionMode(QAbstractItemView::NoSelection);
+    m_tree->header()->setSectionResizeMode(kColOwner, QHeaderView::Stretch);
+    layout->addWidget(m_tree);
+
+    auto* buttonRow = new QHBoxLayout;
+    buttonRow->addStretch();
+    m_resetBtn = new QPushButton(tr("Reset Peaks"));
+    buttonRow->addWidget(m_resetBtn);
+    layout->addLayout(buttonRow);
+
+    // One row per tag, then the totals
+    for (int i = 0; i < memory::kTagCount; ++i) {
+        auto* item = new QTreeWidgetItem(m_tree);
+        item->setText(kColOwner, QString::fromLatin1(
+            memory::tagDisplayName(static_cast<memory::Tag>(i))));
+    }
+    auto* total = new QTreeWidgetItem(m_tree);
+    total->setText(kColOwner, tr("Total"));
+    QFont bold = total->font(kColOwner);
+    bold.setBold(true);
+    for (int col = kColOwner; col <= kColCount; ++col) total->setFont(col, bold);
+
+    auto* heap = new QTreeWidgetItem(m_tree);
+    heap->setText(kColOwner, tr("Heap (allocation hooks)"));
+    heap->setToolTip(kColOwner, tr("Available in builds configured with HOBBYCAD_MEMORY_HOOKS"));
+    auto* process = new QTreeWidgetItem(m_tree);
+    process->setText(kColOwner, tr("Process resident"));
+
+    for (int row = 0; row < m_tree->topLevelItemCount(); ++row) {
+        QTreeWidgetItem* item = m_tree->topLevelItem(row);
+        for (int col = kColCurrent; col <= kColCount; ++col) {
+            item->setTextAlignment(col, Qt::AlignRight | Qt::AlignVCenter);
+        }
+    }
+
+    m_timer = new QTimer(this);
+    m_timer->setInterval(kRefreshMs);
+
+    connect(m_timer, &QTimer::timeout, this, &MemoryPanel::refresh);
+    connect(m_resetBtn, &QPushButton::clicked,
+            this, &MemoryPanel::onResetPeaksClicked);
+}
+
+void MemoryPanel::refresh()
+{
+    const memory::Stats stats = memory::snapshot();
+
+    int row = 0;
+    for (const memory::TagStats& t : stats.tags) {
+        QTreeWidgetItem* item = m_tree->topLevelItem(row++);
+        item->setText(kColCurrent, sizeText(t.bytes));
+        item->setText(kColPeak, sizeText(t.peakBytes));
+        item->setText(kColCount, QString::number(t.owners));
+    }
+
+    QTreeWidgetItem* total = m_tree->topLevelItem(row++);
+    total->setText(kColCurrent, sizeText(stats.totalBytes));
+    total->setText(kColPeak, sizeText(stats.peakTotalBytes));
+
+    QTreeWidgetItem* heap = m_tree->topLevelItem(row++);
+    heap->setHidden(!stats.heap.enabled);
+    heap->setText(kColCurrent, sizeText(stats.heap.bytes));
+    heap->setText(kColPeak, sizeText(stats.heap.peakBytes));
+    heap->setText(kColCount, QString::number(stats.heap.allocations - stats.heap.deallocations));
+
+    QTreeWidgetItem* process = m_tree->topLevelItem(row++);
+    process->setHidden(!stats.process.available);
+    process->setText(kColCurrent, sizeText(stats.process.residentBytes));
+    process->setText(kColPeak, sizeText(stats.process.peakResidentBytes));
+}
+
+void MemoryPanel::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    m_timer->start();
+}
+
+void MemoryPanel::hideEvent(QHideEvent* event)
+{
+    QWidget::hideEvent(event);
+    m_timer->stop();
+}
+
+void MemoryPanel::onResetPeaksClicked()
+{
+    memory::resetPeaks();
+    refresh();
+}
+
+}  // namespace hobbycad
@@ -0,0 +1,49 @@
+// =====================================================================
+//  src/hobbycad/gui/memorypanel.h — Memory diagnostics panel
+// =====================================================================
+//
+//  Shows the libhobbycad memory accounting counters: bytes held by
+//  project bodies, sketch entities, undo history, background images
+//  and tessellations, with their peaks, plus the process resident
+//  size.  Refreshes once a second while visible.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_MEMORYPANEL_H
+#define HOBBYCAD_MEMORYPANEL_H
+
+#include <QWidget>
+
+class QPushButton;
+class QTimer;
+class QTreeWidget;
+
+namespace hobbycad {
+
+class MemoryPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit MemoryPanel(QWidget* parent = nullptr);
+
+public slots:
+    void refresh();
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private slots:
+    void onResetPeaksClicked();
+
+private:
+    QTreeWidget* m_tree     = nullptr;
+    QPushButton* m_resetBtn = nullptr;
+    QTimer*      m_timer    = nullptr;
+};
+
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_MEMORYPANEL_H
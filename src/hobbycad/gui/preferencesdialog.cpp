@@ -5,6 +5,9 @@
 #include "preferencesdialog.h"
 #include "bindingsdialog.h"
 
+#include <hobbycad/snapshot.h>
+#include <hobbycad/sketch/solver.h>
+
 #include <QCheckBox>
 #include <QComboBox>
 #include <QDialogButtonBox>
@@ -240,6 +243,58 @@ QWidget* PreferencesDialog::createGeneralPage()
     orbitForm->addRow(m_orbitSelected);
 
     layout->addWidget(orbitGroup);
+
+    // Project history group
+    auto* historyGroup = new QGroupBox(tr("Project History"));
+    auto* historyForm = new QFormLayout(historyGroup);
+
+    m_autoSnapshot = new QCheckBox(tr("Take a snapshot on every project save"));
+    m_autoSnapshot->setToolTip(
+        tr("When checked, each save records the project in its\n"
+           "snapshot history (File > Snapshot History...).\n"
+           "Unchanged files are stored only once."));
+    m_autoSnapshot->setEnabled(snapshot::SnapshotStore::isAvailable());
+    historyForm->addRow(m_autoSnapshot);
+
+    m_sketchesAsJson = new QCheckBox(tr("Save sketches as readable JSON"));
+    m_sketchesAsJson->setToolTip(
+        tr("When checked, sketches are saved as JSON, which is\n"
+           "larger and slower to load but can be read and diffed\n"
+           "as text.  Otherwise a compact binary form is used.\n"
+           "Projects open in either form."));
+    historyForm->addRow(m_sketchesAsJson);
+
+    m_undoBudgetMiB = new QSpinBox;
+    m_undoBudgetMiB->setRange(0, 65536);
+    m_undoBudgetMiB->setSuffix(tr(" MiB"));
+    m_undoBudgetMiB->setSingleStep(64);
+    m_undoBudgetMiB->setSpecialValueText(tr("Unlimited"));
+    m_undoBudgetMiB->setToolTip(
+        tr("Memory kept for undoing model operations.  Bodies\n"
+           "and sketches an operation leaves alone are shared\n"
+           "between steps; the oldest steps are dropped first."));
+    historyForm->addRow(tr("Undo memory:"), m_undoBudgetMiB);
+
+    layout->addWidget(historyGroup);
+
+    // Sketch solver group
+    auto* solverGroup = new QGroupBox(tr("Constraint Solver"));
+    auto* solverForm = new QFormLayout(solverGroup);
+
+    m_solverBackend = new QComboBox;
+    m_solverBackend->addItem(tr("Automatic"), QStringLiteral("auto"));
+    m_solverBackend->addItem(tr("Built-in"), QStringLiteral("native"));
+    m_solverBackend->addItem(tr("SolveSpace (libslvs)"), QStringLiteral("solvespace"));
+    if (!sketch::Solver::isBackendAvailable(sketch::SolverBackend::SolveSpace)) {
+        m_solverBackend->setItemText(2, tr("SolveSpace (not built in)"));
+    }
+    m_solverBackend->setToolTip(
+        tr("Which solver enforces sketch constraints.\n"
+           "Automatic uses SolveSpace when it is built in and\n"
+           "the built-in solver otherwise."));
+    solverForm->addRow(tr("Backend:"), m_solverBackend);
+
+    layout->addWidget(solverGroup);
     layout->addStretch();
 
     return page;
@@ -275,6 +330,16 @@ void PreferencesDialog::loadSettings()
         s.value(QStringLiteral("zUpOrientation"), true).toBool());
     m_orbitSelected->setChecked(
         s.value(QStringLiteral("orbitSelected"), false).toBool());
+    m_autoSnapshot->setChecked(
+        s.value(QStringLiteral("autoSnapshot"), true).toBool());
+    m_sketchesAsJson->setChecked(
+        s.value(QStringLiteral("sketchesAsJson"), false).toBool());
+    m_undoBudgetMiB->setValue(
+        s.value(QStringLiteral("undoBudgetMiB"), 256).toInt());
+
+    int backendIdx = m_solverBackend->findData(
+        s.value(QStringLiteral("solverBackend"), QStringLiteral("auto")).toString());
+    m_solverBackend->setCurrentIndex(backendIdx >= 0 ? backendIdx : 0);
 
     s.endGroup();
 }
@@ -300,6 +365,13 @@ void PreferencesDialog::saveSettings()
               m_zUpOrientation->isChecked());
     s.setValue(QStringLiteral("orbitSelected"),
               m_orbitSelected->isChecked());
+    s.setValue(QStringLiteral("autoSnapshot"),
+              m_autoSnapshot->isChecked());
+    s.setValue(QStringLiteral("sketchesAsJson"),
+              m_sketchesAsJson->isChecked());
+    s.setValue(QStringLiteral("undoBudgetMiB"), m_undoBudgetMiB->value());
+    s.setValue(QStringLiteral("solverBackend"),
+              m_solverBackend->currentData().toString());
 
     s.endGroup();
     s.sync();
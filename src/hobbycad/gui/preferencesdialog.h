@@ -71,6 +71,10 @@ private:
     QCheckBox*      m_restoreSession   = nullptr;
     QCheckBox*      m_zUpOrientation   = nullptr;
     QCheckBox*      m_orbitSelected    = nullptr;
+    QCheckBox*      m_autoSnapshot     = nullptr;
+    QCheckBox*      m_sketchesAsJson   = nullptr;
+    QSpinBox*       m_undoBudgetMiB    = nullptr;
+    QComboBox*      m_solverBackend    = nullptr;
 };
 
 }  // namespace hobbycad
@@ -21,7 +21,9 @@
 #include <QUrl>
 #include <QProcess>
 #include <QFile>
+#include <QFileSystemWatcher>
 #include <QTextStream>
+#include <QTimer>
 #include <QDir>
 #include <QFileInfo>
 #include <QMimeData>
@@ -33,6 +35,17 @@
 
 namespace hobbycad {
 
+namespace {
+
+/// Project subdirectories whose files are CAD files (see project.h)
+const char* const kCadDirs[] = { "geometry", "sketches", "construction", "features" };
+
+/// Quiet period before watched changes are applied, so a project save
+/// that rewrites dozens of files costs one rescan per directory
+constexpr int kRescanDebounceMs = 250;
+
+}  // namespace
+
 // =====================================================================
 //  ProjectFileModel
 // =====================================================================
@@ -68,14 +81,78 @@ void ProjectFileModel::setForeignFiles(const QVector<ForeignFileEntry>& files)
     }
 }
 
-void ProjectFileModel::setGitIgnoredFiles(const QStringList& files)
+void ProjectFileModel::addCadFiles(const QStringList& files)
 {
-    m_gitIgnoredFiles.clear();
     for (const QString& file : files) {
-        m_gitIgnoredFiles.insert(file);
+        m_cadFiles.insert(file);
     }
 }
 
+void ProjectFileModel::removeCadFiles(const QStringList& files)
+{
+    for (const QString& file : files) {
+        m_cadFiles.remove(file);
+    }
+}
+
+void ProjectFileModel::setGitIgnoreMatcher(const GitIgnoreMatcher& matcher)
+{
+    m_gitIgnore = matcher;
+    m_ignoreCache.clear();
+}
+
+void ProjectFileModel::notifyStatusChanged(const QStringList& relativePaths)
+{
+    for (const QString& rel : relativePaths) {
+        QModelIndex idx = loadedIndex(rel);
+        if (idx.isValid()) {
+            emit dataChanged(idx, idx, {Qt::ForegroundRole, Qt::FontRole, Qt::ToolTipRole});
+        }
+    }
+}
+
+void ProjectFileModel::notifyAllStatusChanged()
+{
+    if (m_projectRoot.isEmpty()) return;
+    notifySubtree(index(m_projectRoot));
+}
+
+void ProjectFileModel::notifySubtree(const QModelIndex& parent)
+{
+    // rowCount() only reports children that are already loaded, so this
+    // never forces a directory read
+    const int rows = rowCount(parent);
+    if (rows == 0) return;
+
+    emit dataChanged(index(0, 0, parent), index(rows - 1, 0, parent),
+                     {Qt::ForegroundRole, Qt::FontRole, Qt::ToolTipRole});
+    for (int row = 0; row < rows; ++row) {
+        notifySubtree(index(row, 0, parent));
+    }
+}
+
+QModelIndex ProjectFileModel::loadedIndex(const QString& relativePath) const
+{
+    if (m_projectRoot.isEmpty()) return QModelIndex();
+
+    QModelIndex current = index(m_projectRoot);
+    const QStringList parts = relativePath.split(QLatin1Char('/'), Qt::SkipEmptyParts);
+    for (const QString& part : parts) {
+        QModelIndex next;
+        const int rows = rowCount(current);
+        for (int row = 0; row < rows; ++row) {
+            QModelIndex child = index(row, 0, current);
+            if (fileName(child) == part) {
+                next = child;
+                break;
+            }
+        }
+        if (!next.isValid()) return QModelIndex();
+        current = next;
+    }
+    return current;
+}
+
 void ProjectFileModel::refresh()
 {
     // Force model to re-read directory
@@ -126,7 +203,7 @@ ProjectFileStatus ProjectFileModel::fileStatus(const QString& relativePath) cons
     }
 
     // Check git ignore
-    if (m_gitIgnoredFiles.contains(relativePath)) {
+    if (isGitIgnored(relativePath)) {
         return ProjectFileStatus::GitIgnored;
     }
 
@@ -154,7 +231,17 @@ bool ProjectFileModel::isForeignFile(const QString& relativePath) const
 
 bool ProjectFileModel::isGitIgnored(const QString& relativePath) const
 {
-    return m_gitIgnoredFiles.contains(relativePath);
+    if (m_gitIgnore.isEmpty() || relativePath.isEmpty()) return false;
+
+    auto it = m_ignoreCache.constFind(relativePath);
+    if (it != m_ignoreCache.constEnd()) return it.value();
+
+    // Directory-ness comes from the model's cached node, not a stat()
+    QModelIndex idx = loadedIndex(relativePath);
+    bool dir = idx.isValid() && isDir(idx);
+    bool ignored = m_gitIgnore.isIgnored(relativePath, dir);
+    m_ignoreCache.insert(relativePath, ignored);
+    return ignored;
 }
 
 QVariant ProjectFileModel::data(const QModelIndex& index, int role) const
@@ -251,6 +338,18 @@ ProjectBrowserWidget::ProjectBrowserWidget(QWidget* parent)
     setupUi();
     setupToolbar();
     setupContextMenu();
+
+    m_watcher = new QFileSystemWatcher(this);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged,
+            this, &ProjectBrowserWidget::onWatchedPathChanged);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged,
+            this, &ProjectBrowserWidget::onWatchedPathChanged);
+
+    m_rescanTimer = new QTimer(this);
+    m_rescanTimer->setSingleShot(true);
+    m_rescanTimer->setInterval(kRescanDebounceMs);
+    connect(m_rescanTimer, &QTimer::timeout,
+            this, &ProjectBrowserWidget::applyPendingChanges);
 }
 
 void ProjectBrowserWidget::setupUi()
@@ -391,7 +490,7 @@ void ProjectBrowserWidget::setupContextMenu()
         QString relPath = selectedRelativePath();
         if (!relPath.isEmpty()) {
             addToForeignFiles(relPath);
-            refresh();
+            updateToolbarState();
             emit foreignFilesChanged();
         }
     });
@@ -402,7 +501,7 @@ void ProjectBrowserWidget::setupContextMenu()
         QString relPath = selectedRelativePath();
         if (!relPath.isEmpty()) {
             removeFromForeignFiles(relPath);
-            refresh();
+            updateToolbarState();
             emit foreignFilesChanged();
         }
     });
@@ -416,7 +515,7 @@ void ProjectBrowserWidget::setupContextMenu()
         QString relPath = selectedRelativePath();
         if (!relPath.isEmpty()) {
             addToGitIgnore(relPath);
-            refresh();
+            updateToolbarState();
             emit gitIgnoreChanged();
         }
     });
@@ -427,7 +526,7 @@ void ProjectBrowserWidget::setupContextMenu()
         QString relPath = selectedRelativePath();
         if (!relPath.isEmpty()) {
             removeFromGitIgnore(relPath);
-            refresh();
+            updateToolbarState();
             emit gitIgnoreChanged();
         }
     });
@@ -466,8 +565,10 @@ void ProjectBrowserWidget::setProject(Project* project)
         m_treeView->setRootIndex(m_model->index(m_projectRoot));
         loadProjectFiles();
         loadGitIgnore();
+        startWatching();
         m_treeView->expandToDepth(0);
     } else {
+        stopWatching();
         m_projectRoot.clear();
         m_model->setProjectRoot(QString());
     }
@@ -477,11 +578,17 @@ void ProjectBrowserWidget::setProject(Project* project)
 
 void ProjectBrowserWidget::refresh()
 {
-    if (m_project) {
-        loadProjectFiles();
-        loadGitIgnore();
-        m_model->refresh();
+    if (!m_project || m_projectRoot.isEmpty()) return;
+
+    // Re-check every watched directory now instead of waiting for the
+    // debounce; unchanged directories produce an empty diff
+    m_pendingDirs.insert(QString());
+    for (const char* dir : kCadDirs) {
+        m_pendingDirs.insert(QString::fromLatin1(dir));
     }
+    m_gitIgnoreDirty = true;
+    applyPendingChanges();
+    loadForeignFiles();
 }
 
 QString ProjectBrowserWidget::selectedFilePath() const
@@ -604,109 +711,187 @@ void ProjectBrowserWidget::loadProjectFiles()
 {
     if (!m_project) return;
 
+    // Build the CAD file index from the known subdirectories (the
+    // manifest lists these files; see project.h)
+    m_cadIndex.clear();
+    for (const char* dir : kCadDirs) {
+        rescanCadDir(QString::fromLatin1(dir), nullptr, nullptr);
+    }
+    rescanCadDir(QString(), nullptr, nullptr);
+
     QStringList cadFiles;
+    for (auto it = m_cadIndex.constBegin(); it != m_cadIndex.constEnd(); ++it) {
+        const QString prefix = it.key().isEmpty() ? QString() : it.key() + QLatin1Char('/');
+        for (const QString& file : it.value()) {
+            cadFiles.append(prefix + file);
+        }
+    }
+    m_model->setCadFiles(cadFiles);
 
-    // Collect all CAD file paths from the project
-    // Geometry files
-    for (const auto& shape : m_project->shapes()) {
-        Q_UNUSED(shape);
-        // Geometry files are in geometry/ subdirectory
+    loadForeignFiles();
+}
+
+void ProjectBrowserWidget::loadForeignFiles()
+{
+    if (!m_project) return;
+
+    QVector<ForeignFileEntry> foreignFiles;
+
+    // Get foreign files from project
+    const auto& projectForeignFiles = m_project->foreignFiles();
+    for (const ForeignFileData& data : projectForeignFiles) {
+        foreignFiles.append({QString::fromStdString(data.path),
+                             QString::fromStdString(data.description),
+                             QString::fromStdString(data.category)});
     }
 
-    // Get the file lists from the project (these are stored in manifest)
-    // For now, we'll build the list from known subdirectories
-    QDir projectDir(m_projectRoot);
+    m_model->setForeignFiles(foreignFiles);
+    m_model->notifyAllStatusChanged();
+}
+
+QString ProjectBrowserWidget::manifestName() const
+{
+    return QDir(m_projectRoot).dirName() + QStringLiteral(".hcad");
+}
 
-    // Geometry files
-    QDir geomDir(m_projectRoot + QStringLiteral("/geometry"));
-    if (geomDir.exists()) {
-        for (const QString& file : geomDir.entryList(QDir::Files)) {
-            cadFiles.append(QStringLiteral("geometry/") + file);
+bool ProjectBrowserWidget::rescanCadDir(const QString& dirName,
+                                        QStringList* added, QStringList* removed)
+{
+    QSet<QString> current;
+    if (dirName.isEmpty()) {
+        // Project root: only the manifest counts as a CAD file
+        const QString manifest = manifestName();
+        if (QFileInfo::exists(absolutePath(manifest))) {
+            current.insert(manifest);
         }
+    } else {
+        const QStringList entries = QDir(absolutePath(dirName)).entryList(QDir::Files);
+        current = QSet<QString>(entries.begin(), entries.end());
     }
 
-    // Sketch files
-    QDir sketchDir(m_projectRoot + QStringLiteral("/sketches"));
-    if (sketchDir.exists()) {
-        for (const QString& file : sketchDir.entryList(QDir::Files)) {
-            cadFiles.append(QStringLiteral("sketches/") + file);
+    const QSet<QString> previous = m_cadIndex.value(dirName);
+    if (current == previous) return false;
+
+    const QString prefix = dirName.isEmpty() ? QString() : dirName + QLatin1Char('/');
+    if (added) {
+        for (const QString& file : current) {
+            if (!previous.contains(file)) added->append(prefix + file);
         }
     }
-
-    // Construction planes
-    QDir constDir(m_projectRoot + QStringLiteral("/construction"));
-    if (constDir.exists()) {
-        for (const QString& file : constDir.entryList(QDir::Files)) {
-            cadFiles.append(QStringLiteral("construction/") + file);
+    if (removed) {
+        for (const QString& file : previous) {
+            if (!current.contains(file)) removed->append(prefix + file);
         }
     }
 
-    // Features
-    QDir featDir(m_projectRoot + QStringLiteral("/features"));
-    if (featDir.exists()) {
-        for (const QString& file : featDir.entryList(QDir::Files)) {
-            cadFiles.append(QStringLiteral("features/") + file);
-        }
+    m_cadIndex.insert(dirName, current);
+    return true;
+}
+
+void ProjectBrowserWidget::startWatching()
+{
+    stopWatching();
+    updateWatchedPaths();
+}
+
+void ProjectBrowserWidget::stopWatching()
+{
+    m_rescanTimer->stop();
+    m_pendingDirs.clear();
+    m_gitIgnoreDirty = false;
+
+    const QStringList watched = m_watcher->directories() + m_watcher->files();
+    if (!watched.isEmpty()) {
+        m_watcher->removePaths(watched);
     }
+}
 
-    // Manifest file
-    QString manifestName = projectDir.dirName() + QStringLiteral(".hcad");
-    if (QFileInfo::exists(m_projectRoot + QStringLiteral("/") + manifestName)) {
-        cadFiles.append(manifestName);
+void ProjectBrowserWidget::updateWatchedPaths()
+{
+    if (m_projectRoot.isEmpty()) return;
+
+    // Directories and files appear and disappear (a first save creates
+    // geometry/, editors replace .gitignore), so re-add what exists
+    QStringList wanted = { m_projectRoot };
+    for (const char* dir : kCadDirs) {
+        QString path = absolutePath(QString::fromLatin1(dir));
+        if (QFileInfo(path).isDir()) wanted.append(path);
     }
+    QString gitIgnorePath = absolutePath(QStringLiteral(".gitignore"));
+    if (QFileInfo::exists(gitIgnorePath)) wanted.append(gitIgnorePath);
 
-    m_model->setCadFiles(cadFiles);
+    const QStringList watched = m_watcher->directories() + m_watcher->files();
+    QStringList toAdd;
+    for (const QString& path : wanted) {
+        if (!watched.contains(path)) toAdd.append(path);
+    }
+    if (!toAdd.isEmpty()) {
+        m_watcher->addPaths(toAdd);
+    }
+}
 
-    // Load foreign files from project
-    QVector<ForeignFileEntry> foreignFiles;
+void ProjectBrowserWidget::onWatchedPathChanged(const QString& path)
+{
+    if (m_projectRoot.isEmpty()) return;
 
-    // Get foreign files from project
-    const auto& projectForeignFiles = m_project->foreignFiles();
-    for (const ForeignFileData& data : projectForeignFiles) {
-        foreignFiles.append({QString::fromStdString(data.path),
-                             QString::fromStdString(data.description),
-                             QString::fromStdString(data.category)});
+    if (path == m_projectRoot) {
+        // Root changes may add/remove the manifest, .gitignore or a CAD directory
+        m_pendingDirs.insert(QString());
+        m_gitIgnoreDirty = true;
+    } else if (path == absolutePath(QStringLiteral(".gitignore"))) {
+        m_gitIgnoreDirty = true;
+    } else {
+        m_pendingDirs.insert(QFileInfo(path).fileName());
     }
 
-    // Also detect common files that might not be tracked yet
-    // These are shown as "suggested" but not added automatically
-    auto addIfExists = [&](const QString& path, const QString& cat) {
-        if (QFileInfo::exists(m_projectRoot + QStringLiteral("/") + path)) {
-            // Only add if not already tracked
-            bool found = false;
-            for (const ForeignFileEntry& e : foreignFiles) {
-                if (e.path == path) {
-                    found = true;
-                    break;
-                }
-            }
-            if (!found) {
-                // Don't auto-add, but the file will show as untracked
-                // User can add it via context menu
+    m_rescanTimer->start();  // (Re)start the debounce window
+}
+
+void ProjectBrowserWidget::applyPendingChanges()
+{
+    if (!m_project || m_projectRoot.isEmpty()) return;
+
+    const QSet<QString> dirs = m_pendingDirs;
+    m_pendingDirs.clear();
+
+    QStringList added;
+    QStringList removed;
+    for (const QString& dir : dirs) {
+        rescanCadDir(dir, &added, &removed);
+        if (dir.isEmpty()) {
+            // A CAD directory may have been created or removed
+            for (const char* cadDir : kCadDirs) {
+                rescanCadDir(QString::fromLatin1(cadDir), &added, &removed);
             }
         }
-    };
+    }
+
+    if (!added.isEmpty() || !removed.isEmpty()) {
+        m_model->addCadFiles(added);
+        m_model->removeCadFiles(removed);
+        m_model->notifyStatusChanged(added + removed);
+        updateToolbarState();
+    }
 
-    addIfExists(QStringLiteral(".git/"), QStringLiteral("version_control"));
-    addIfExists(QStringLiteral(".gitignore"), QStringLiteral("version_control"));
-    addIfExists(QStringLiteral("README.md"), QStringLiteral("documentation"));
-    addIfExists(QStringLiteral("LICENSE"), QStringLiteral("documentation"));
+    if (m_gitIgnoreDirty) {
+        m_gitIgnoreDirty = false;
+        QStringList patterns = parseGitIgnore();
+        if (patterns != m_gitIgnorePatterns) {
+            loadGitIgnore();
+            emit gitIgnoreChanged();
+        }
+    }
 
-    m_model->setForeignFiles(foreignFiles);
+    updateWatchedPaths();
 }
 
 void ProjectBrowserWidget::loadGitIgnore()
 {
     m_gitIgnorePatterns = parseGitIgnore();
 
-    QStringList ignoredFiles;
-    for (const QString& pattern : m_gitIgnorePatterns) {
-        // Simple pattern matching - just exact matches for now
-        // TODO: Implement proper gitignore glob matching
-        ignoredFiles.append(pattern);
-    }
-
-    m_model->setGitIgnoredFiles(ignoredFiles);
+    // Compile once; the model caches per-path results
+    m_model->setGitIgnoreMatcher(GitIgnoreMatcher(m_gitIgnorePatterns));
+    m_model->notifyAllStatusChanged();
 }
 
 void ProjectBrowserWidget::saveGitIgnore()
@@ -769,7 +954,7 @@ bool ProjectBrowserWidget::addToForeignFiles(const QString& relativePath,
     m_project->setModified(true);
 
     // Reload foreign files into model
-    loadProjectFiles();
+    loadForeignFiles();
 
     return true;
 }
@@ -783,7 +968,7 @@ bool ProjectBrowserWidget::removeFromForeignFiles(const QString& relativePath)
     m_project->setModified(true);
 
     // Reload foreign files into model
-    loadProjectFiles();
+    loadForeignFiles();
 
     return true;
 }
@@ -918,7 +1103,7 @@ void ProjectBrowserWidget::onToggleForeignFile()
         addToForeignFiles(relPath);
     }
 
-    refresh();
+    updateToolbarState();
     emit foreignFilesChanged();
 }
 
@@ -933,13 +1118,18 @@ void ProjectBrowserWidget::onToggleGitIgnore()
         addToGitIgnore(relPath);
     }
 
-    refresh();
+    updateToolbarState();
     emit gitIgnoreChanged();
 }
 
 void ProjectBrowserWidget::onRefresh()
 {
+    // Explicit user refresh also re-reads the whole directory tree
     refresh();
+    m_model->refresh();
+    if (!m_projectRoot.isEmpty()) {
+        m_treeView->setRootIndex(m_model->index(m_projectRoot));
+    }
 }
 
 void ProjectBrowserWidget::onOpenInExternalEditor()
@@ -10,6 +10,9 @@
 //
 //  Features:
 //  - Tree view of project directory
+//  - Incremental updates: CAD subdirectories and .gitignore are
+//    watched, and changes are applied as debounced per-directory diffs
+//    instead of full rescans
 //  - Right-click context menu for file operations
 //  - Toolbar with common actions
 //  - Drag-and-drop support for adding files
@@ -22,14 +25,20 @@
 #ifndef HOBBYCAD_PROJECTBROWSERWIDGET_H
 #define HOBBYCAD_PROJECTBROWSERWIDGET_H
 
+#include "gitignorematcher.h"
+
 #include <QWidget>
 #include <QTreeView>
 #include <QFileSystemModel>
 #include <QToolBar>
 #include <QMenu>
+#include <QHash>
 #include <QSet>
 #include <QStringList>
 
+class QFileSystemWatcher;
+class QTimer;
+
 namespace hobbycad {
 
 class Project;
@@ -63,10 +72,19 @@ public:
     // Project file tracking
     void setProjectRoot(const QString& path);
     void setCadFiles(const QStringList& files);
+    void addCadFiles(const QStringList& files);
+    void removeCadFiles(const QStringList& files);
     void setForeignFiles(const QVector<ForeignFileEntry>& files);
-    void setGitIgnoredFiles(const QStringList& files);
+    void setGitIgnoreMatcher(const GitIgnoreMatcher& matcher);
     void refresh();
 
+    /// Repaint the given paths (relative) if they are already loaded.
+    /// Never triggers directory fetches.
+    void notifyStatusChanged(const QStringList& relativePaths);
+
+    /// Repaint every loaded row (e.g., after .gitignore changed)
+    void notifyAllStatusChanged();
+
     // Query file status
     ProjectFileStatus fileStatus(const QString& relativePath) const;
     bool isCadFile(const QString& relativePath) const;
@@ -77,10 +95,17 @@ private:
     QString m_projectRoot;
     QSet<QString> m_cadFiles;
     QSet<QString> m_foreignFiles;
-    QSet<QString> m_gitIgnoredFiles;
     QVector<ForeignFileEntry> m_foreignFileEntries;
+    GitIgnoreMatcher m_gitIgnore;
+    mutable QHash<QString, bool> m_ignoreCache;   ///< Matcher results per path
 
     QString relativePath(const QModelIndex& index) const;
+
+    /// Find an already-loaded index for a relative path without fetching
+    QModelIndex loadedIndex(const QString& relativePath) const;
+
+    /// Emit dataChanged for an index and its loaded descendants
+    void notifySubtree(const QModelIndex& parent);
 };
 
 /// Project Files Browser widget
@@ -145,15 +170,27 @@ private slots:
     void onShowProperties();
     void onRevealInFileManager();
 
+    // Filesystem watching
+    void onWatchedPathChanged(const QString& path);
+    void applyPendingChanges();
+
 private:
     void setupUi();
     void setupToolbar();
     void setupContextMenu();
     void updateToolbarState();
     void loadProjectFiles();
+    void loadForeignFiles();
     void loadGitIgnore();
     void saveGitIgnore();
 
+    // Incremental CAD file index
+    void startWatching();
+    void stopWatching();
+    void updateWatchedPaths();
+    bool rescanCadDir(const QString& dirName, QStringList* added, QStringList* removed);
+    QString manifestName() const;
+
     // File operations
     bool addToForeignFiles(const QString& relativePath, const QString& category = QString());
     bool removeFromForeignFiles(const QString& relativePath);
@@ -198,6 +235,14 @@ private:
 
     // Git ignore patterns (cached)
     QStringList m_gitIgnorePatterns;
+
+    // Incremental index: CAD file names per managed directory
+    // ("" holds the manifest in the project root)
+    QHash<QString, QSet<QString>> m_cadIndex;
+    QFileSystemWatcher* m_watcher = nullptr;
+    QTimer* m_rescanTimer = nullptr;
+    QSet<QString> m_pendingDirs;        ///< Directories (relative) awaiting rescan
+    bool m_gitIgnoreDirty = false;
 };
 
 }  // namespace hobbycad
@@ -716,6 +716,7 @@ void SketchCanvas::clear()
     m_nextId = 1;
     m_nextConstraintId = 1;
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     cancelEntity();
     emit selectionChanged(-1);
     update();
@@ -739,6 +740,7 @@ void SketchCanvas::setEntities(const QVector<SketchEntity>& entities)
     m_nextConstraintId = 1;  // Reset constraints
 
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     emit selectionChanged(-1);
     update();
 }
@@ -893,10 +895,14 @@ QPointF SketchCanvas::snapPoint(const QPointF& world) const
         double tolerance = m_entitySnapTolerance / m_zoom;  // Convert pixels to world units
         int excludeId = m_isDraggingHandle ? m_selectedId : -1;
 
-        // Delegate to the library for all snap evaluation
-        std::vector<sketch::Entity> libEntities = toLibraryEntities(m_entities);
+        // Delegate to the library for all snap evaluation.  The store
+        // is refilled only after entity edits, not on every query.
+        if (m_snapStoreRevision != m_entityRevision) {
+            m_snapStore.assign(m_entities.cbegin(), m_entities.cend());
+            m_snapStoreRevision = m_entityRevision;
+        }
         sketch::SnapResult result = sketch::findBestSnap(
-            libEntities, world, tolerance, excludeId);
+            m_snapStore, world, tolerance, excludeId);
 
         if (result.found) {
             self->m_activeSnap = result.snap;
@@ -4666,7 +4672,9 @@ void SketchCanvas::mousePressEvent(QMouseEvent* event)
                     m_selectedId = handleEntityId;
                 }
 
-                // Start dragging the handle
+                // Start dragging the handle (the drag solver is built
+                // lazily on the first frame that needs it)
+                endDragSolve();
                 m_isDraggingHandle = true;
                 m_dragHandleIndex = handleIdx;
                 m_dragStartWorld = worldPos;
@@ -6993,41 +7001,20 @@ void SketchCanvas::mouseMoveEvent(QMouseEvent* event)
                         }
                     }
 
-                    // Add temporary FixedPoint constraint on the non-dragged
-                    // endpoint, solve, then remove it.
+                    // Solve with a temporary FixedPoint pin on the
+                    // non-dragged endpoint (held by the drag session).
                     if (!m_constraints.isEmpty()) {
-                        SketchConstraint pinConstraint;
-                        pinConstraint.id = -999;  // temporary ID
-                        pinConstraint.type = ConstraintType::FixedPoint;
-                        pinConstraint.entityIds.push_back(sel->id);
-                        pinConstraint.pointIndices.push_back(fixedIdx);
-                        pinConstraint.isDriving = true;
-                        pinConstraint.enabled = true;
-                        pinConstraint.satisfied = true;
-                        pinConstraint.labelVisible = false;
-
-                        m_constraints.append(pinConstraint);
-                        solveConstraints();
-                        // Remove the temporary constraint
-                        m_constraints.erase(
-                            std::remove_if(m_constraints.begin(), m_constraints.end(),
-                                           [](const SketchConstraint& c) { return c.id == -999; }),
-                            m_constraints.end());
+                        solveDragStep(sel->id, m_dragHandleIndex, fixedIdx);
                     }
 
                     // Reposition label from FINAL line orientation
                     if (distConstraint) {
-                        // Re-find distConstraint — pointer may be stale after
-                        // m_constraints append/erase
-                        distConstraint = findDrivingConstraint(sel->id, ConstraintType::Distance);
-                        if (distConstraint) {
-                            QPointF newAlong = sel->points[1] - sel->points[0];
-                            double newLen = std::sqrt(newAlong.x() * newAlong.x() + newAlong.y() * newAlong.y());
-                            if (newLen > 1e-6) {
-                                QPointF newPerp(-newAlong.y() / newLen, newAlong.x() / newLen);
-                                QPointF newMid = (sel->points[0] + sel->points[1]) / 2.0;
-                                distConstraint->labelPosition = newMid + newPerp * labelPerpOffset;
-                            }
+                        QPointF newAlong = sel->points[1] - sel->points[0];
+                        double newLen = std::sqrt(newAlong.x() * newAlong.x() + newAlong.y() * newAlong.y());
+                        if (newLen > 1e-6) {
+                            QPointF newPerp(-newAlong.y() / newLen, newAlong.x() / newLen);
+                            QPointF newMid = (sel->points[0] + sel->points[1]) / 2.0;
+                            distConstraint->labelPosition = newMid + newPerp * labelPerpOffset;
                         }
                     }
                 }
@@ -7055,7 +7042,7 @@ void SketchCanvas::mouseMoveEvent(QMouseEvent* event)
                 sel->points[m_dragHandleIndex] = finalPos;
             }
 
-            // Non-line entities: run solver normally
+            // Non-line entities: run the drag solver without a pin
             // (Lines use temporary FixedPoint pins above.)
             // Skip solver for tangent arcs during handle drag — the solver
             // doesn't know about the tangency relationship and would move
@@ -7065,8 +7052,9 @@ void SketchCanvas::mouseMoveEvent(QMouseEvent* event)
                     && !m_constraints.isEmpty()
                     && !(sel->type == SketchEntityType::Arc
                          && sel->tangentEntityId >= 0)) {
-                solveConstraints();
+                solveDragStep(sel->id, m_dragHandleIndex);
             }
+            markEntitiesChanged();
 
             // Emit real-time property update
             if (m_selectedId >= 0) {
@@ -7177,6 +7165,8 @@ void SketchCanvas::mouseReleaseEvent(QMouseEvent* event)
                 emit entityModified(m_selectedId);
             }
             // Re-solve constraints so dimensions are enforced after resize
+            // (full solve: reports DOF and failures the drag steps skip)
+            endDragSolve();
             solveConstraints();
 
             // Re-establish tangency for tangent arcs after solver.
@@ -7898,6 +7888,7 @@ void SketchCanvas::applyCtrlSnapToHandle()
     if (sel->groupId >= 0) {
         solveConstraints();
     }
+    markEntitiesChanged();
 
     if (m_selectedId >= 0) {
         emit entityDragging(m_selectedId);
@@ -8445,6 +8436,7 @@ void SketchCanvas::keyPressEvent(QKeyEvent* event)
             m_selectedId = -1;
             m_selectedIds.clear();
             m_profilesCacheDirty = true;
+            markEntitiesChanged();
             emit selectionChanged(-1);
             update();
         }
@@ -8909,6 +8901,7 @@ void SketchCanvas::contextMenuEvent(QContextMenuEvent* event)
                     if (ent) ent->isConstruction = false;
                 }
                 m_profilesCacheDirty = true;
+                markEntitiesChanged();
                 emit selectionChanged(m_selectedId);
                 update();
             });
@@ -8920,6 +8913,7 @@ void SketchCanvas::contextMenuEvent(QContextMenuEvent* event)
                     if (ent) ent->isConstruction = true;
                 }
                 m_profilesCacheDirty = true;
+                markEntitiesChanged();
                 emit selectionChanged(m_selectedId);
                 update();
             });
@@ -8932,6 +8926,7 @@ void SketchCanvas::contextMenuEvent(QContextMenuEvent* event)
                     if (ent) ent->isConstruction = false;
                 }
                 m_profilesCacheDirty = true;
+                markEntitiesChanged();
                 emit selectionChanged(m_selectedId);
                 update();
             });
@@ -8943,6 +8938,7 @@ void SketchCanvas::contextMenuEvent(QContextMenuEvent* event)
                     if (ent) ent->isConstruction = true;
                 }
                 m_profilesCacheDirty = true;
+                markEntitiesChanged();
                 emit selectionChanged(m_selectedId);
                 update();
             });
@@ -9051,6 +9047,7 @@ void SketchCanvas::contextMenuEvent(QContextMenuEvent* event)
                 if (ent) {
                     ent->isConstruction = !ent->isConstruction;
                     m_profilesCacheDirty = true;
+                    markEntitiesChanged();
                     emit entityModified(entityId);
                     update();
                 }
@@ -9145,6 +9142,7 @@ void SketchCanvas::contextMenuEvent(QContextMenuEvent* event)
                     emit selectionChanged(-1);
                 }
                 m_profilesCacheDirty = true;
+                markEntitiesChanged();
                 update();
             });
 
@@ -9398,6 +9396,7 @@ void SketchCanvas::deleteSelectedEntities()
     m_selectedId = -1;
     m_selectedIds.clear();
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     emit selectionChanged(-1);
     update();
 }
@@ -9554,6 +9553,7 @@ void SketchCanvas::transformSelectedEntities(TransformType type)
     }
 
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     solveConstraints();
     update();
 }
@@ -9692,6 +9692,7 @@ void SketchCanvas::alignSelectedEntities(AlignmentType type)
     }
 
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     solveConstraints();
     update();
 }
@@ -11325,6 +11326,7 @@ void SketchCanvas::finishEntity()
             // Decomposition succeeded: 4 lines + constraints + group already added
             // to m_entities, m_constraints, m_groups by the decompose function.
             m_profilesCacheDirty = true;
+            markEntitiesChanged();
             pushUndoCommand(compoundCmd);
 
             // Emit signals for each created entity
@@ -11339,6 +11341,7 @@ void SketchCanvas::finishEntity()
             // --- Normal (non-decomposable) entity path ---
             m_entities.append(m_pendingEntity);
             m_profilesCacheDirty = true;
+            markEntitiesChanged();
 
             // Push undo command for entity creation
             pushUndoCommand(sketch::UndoCommand::addEntity(m_pendingEntity));
@@ -11440,6 +11443,7 @@ bool SketchCanvas::decomposeCompoundEntity(
     compoundCmd = sketch::UndoCommand::compound(subs, typeName.toStdString());
 
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     return true;
 }
 
@@ -11666,6 +11670,7 @@ void SketchCanvas::createLockedConstraints(int entityId)
                 // Add to state
                 m_entities.append(line1);
                 m_entities.append(line2);
+                markEntitiesChanged();
                 m_constraints.append(angleC);
                 m_groups.append(group);
 
@@ -11881,6 +11886,7 @@ void SketchCanvas::setEntityConstruction(int entityId, bool isConstruction)
     if (entity) {
         entity->isConstruction = isConstruction;
         m_profilesCacheDirty = true;  // Construction status affects profile detection
+        markEntitiesChanged();
         emit entityModified(entityId);
         update();
     }
@@ -11888,6 +11894,7 @@ void SketchCanvas::setEntityConstruction(int entityId, bool isConstruction)
 
 void SketchCanvas::notifyEntityChanged(int entityId)
 {
+    markEntitiesChanged();
     solveConstraints();
 
     // Re-establish tangency for tangent arcs after solver
@@ -11937,6 +11944,7 @@ void SketchCanvas::notifyEntityPointChanged(int entityId, int pointIndex)
     tempFixed.isDriving = true;
     tempFixed.satisfied = true;
 
+    markEntitiesChanged();
     m_constraints.append(tempFixed);
     solveConstraints();
     m_constraints.removeLast();  // Remove the temporary constraint
@@ -12033,6 +12041,7 @@ void SketchCanvas::syncSweepAngleConstructionLines(const SketchEntity& arc)
             if (lineCount >= 2) break;
         }
     }
+    if (lineCount > 0) markEntitiesChanged();
 
     // Update the Angle constraint's anchorPoint and labelPosition to follow the arc
     for (int cid : group->constraintIds) {
@@ -12066,6 +12075,7 @@ void SketchCanvas::reestablishTangency(SketchEntity& arc)
         arc.points = result.arc.points;
         arc.startAngle = result.arc.startAngle;
         // radius and sweepAngle preserved by library
+        markEntitiesChanged();
     }
 }
 
@@ -12079,6 +12089,7 @@ void SketchCanvas::ensureTextRotationHandle(SketchEntity& entity)
     QPointF anchor(entity.points[0]);
     entity.points.push_back({anchor.x() + dist * std::cos(rad),
                              anchor.y() + dist * std::sin(rad)});
+    markEntitiesChanged();
 }
 
 void SketchCanvas::recomputeTextRotationHandle(SketchEntity& entity)
@@ -12505,6 +12516,7 @@ void SketchCanvas::setConstraintValue(int constraintId, double newValue)
                         arc->points[2] = {
                             arc->points[0].x + arc->radius * std::cos(endRad),
                             arc->points[0].y + arc->radius * std::sin(endRad)};
+                        markEntitiesChanged();
                         reestablishTangency(*arc);
                         syncSweepAngleConstructionLines(*arc);
                         constraint->supplementary = (std::abs(newSweep) > 180.0);
@@ -12540,6 +12552,7 @@ void SketchCanvas::setConstraintValue(int constraintId, double newValue)
             double newRadius = (constraint->type == ConstraintType::Diameter)
                                ? newValue / 2.0 : newValue;
             ent->radius = newRadius;
+            markEntitiesChanged();
             reestablishTangency(*ent);
             syncSweepAngleConstructionLines(*ent);
             for (const auto& g : m_groups) {
@@ -12654,7 +12667,57 @@ void SketchCanvas::solveConstraints()
 
     SketchSolver solver;
     SolveResult result = solver.solve(m_entities, m_constraints);
+    markEntitiesChanged();
+    applySolveResult(result);
+}
 
+void SketchCanvas::solveDragStep(int entityId, int pointIndex, int pinnedPointIndex)
+{
+    if (m_constraints.isEmpty()) return;
+
+    // The system is built once per gesture: later frames only move the
+    // dragged point and warm-start from the previous frame's solution
+    if (!m_dragSolver) {
+        m_dragSolver = std::make_unique<SketchSolver>();
+    }
+    if (!m_dragSolver->isDragging()) {
+        QVector<SketchConstraint> constraints = m_constraints;
+        if (pinnedPointIndex >= 0) {
+            SketchConstraint pinConstraint;
+            pinConstraint.id = -999;  // temporary ID
+            pinConstraint.type = ConstraintType::FixedPoint;
+            pinConstraint.entityIds.push_back(entityId);
+            pinConstraint.pointIndices.push_back(pinnedPointIndex);
+            pinConstraint.isDriving = true;
+            pinConstraint.enabled = true;
+            pinConstraint.satisfied = true;
+            pinConstraint.labelVisible = false;
+            constraints.append(pinConstraint);
+        }
+        m_dragSolver->beginDrag(m_entities, constraints, entityId, pointIndex);
+    }
+
+    // A frame that runs out of iterations keeps its best iterate and
+    // continues next frame; failures are reported by the full solve
+    // on release, so constraints don't flash red mid-drag
+    SolveResult result = m_dragSolver->dragStep(m_entities);
+    markEntitiesChanged();
+    if (result.success) {
+        applySolveResult(result);
+    } else {
+        update();
+    }
+}
+
+void SketchCanvas::endDragSolve()
+{
+    if (m_dragSolver) {
+        m_dragSolver->endDrag();
+    }
+}
+
+void SketchCanvas::applySolveResult(const SolveResult& result)
+{
     if (result.success) {
         // Mark all driving constraints as satisfied
         for (SketchConstraint& c : m_constraints) {
@@ -12765,6 +12828,7 @@ void SketchCanvas::deleteConstraintById(int constraintId)
     refreshConstrainedFlags();
     solveConstraints();
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     emit constraintDeleted(constraintId);
     update();
 }
@@ -13313,6 +13377,7 @@ bool SketchCanvas::trimEntityAt(int entityId, const QPointF& clickPoint)
     }
 
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     update();
     return true;
 }
@@ -13335,6 +13400,7 @@ bool SketchCanvas::extendEntityTo(int entityId, const QPointF& clickPoint)
     if (result.success) {
         entity->points = result.entity.points;
         m_profilesCacheDirty = true;
+        markEntitiesChanged();
         emit entityModified(entityId);
         update();
         return true;
@@ -13387,6 +13453,7 @@ QVector<int> SketchCanvas::splitEntityAtIntersections(int entityId)
     }
 
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     update();
     return newIds;
 }
@@ -13421,6 +13488,7 @@ QVector<int> SketchCanvas::splitEntityAt(int entityId, const QPointF& splitPoint
     }
 
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     update();
     return newIds;
 }
@@ -13509,6 +13577,7 @@ QVector<int> SketchCanvas::splitEntityNearClick(int entityId, const QPointF& cli
     }
 
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     update();
     return newIds;
 }
@@ -13595,6 +13664,7 @@ int SketchCanvas::rejoinCollinearSegments()
     selectEntity(newId);
 
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     refreshConstrainedFlags();
     update();
     emit entityCreated(newId);
@@ -13693,6 +13763,7 @@ void SketchCanvas::offsetEntity(int entityId, double distance, const QPointF& cl
     m_entities.append(newEntity);
     emit entityCreated(newEntity.id);
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     update();
 }
 
@@ -13728,6 +13799,7 @@ void SketchCanvas::filletCorner(int lineId1, int lineId2, double radius)
     emit entityModified(lineId2);
 
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     update();
 }
 
@@ -13763,6 +13835,7 @@ void SketchCanvas::chamferCorner(int lineId1, int lineId2, double distance)
     emit entityModified(lineId2);
 
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     update();
 }
 
@@ -13831,6 +13904,7 @@ void SketchCanvas::createRectangularPattern()
     }
 
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     update();
 }
 
@@ -13898,6 +13972,7 @@ void SketchCanvas::createCircularPattern()
     }
 
     m_profilesCacheDirty = true;
+    markEntitiesChanged();
     update();
 }
 
@@ -14269,12 +14344,14 @@ void SketchCanvas::undoSingleCommand(const sketch::UndoCommand& cmd)
             m_selectedId = -1;
         }
         m_profilesCacheDirty = true;
+        markEntitiesChanged();
         break;
 
     case sketch::CommandType::DeleteEntity:
         // Undo delete = restore the entity
         m_entities.append(SketchEntity(cmd.entity));
         m_profilesCacheDirty = true;
+        markEntitiesChanged();
         break;
 
     case sketch::CommandType::ModifyEntity:
@@ -14290,6 +14367,7 @@ void SketchCanvas::undoSingleCommand(const sketch::UndoCommand& cmd)
             }
         }
         m_profilesCacheDirty = true;
+        markEntitiesChanged();
         break;
 
     case sketch::CommandType::AddConstraint:
@@ -14359,6 +14437,7 @@ void SketchCanvas::redoSingleCommand(const sketch::UndoCommand& cmd)
         // Redo add = add the entity back
         m_entities.append(SketchEntity(cmd.entity));
         m_profilesCacheDirty = true;
+        markEntitiesChanged();
         break;
 
     case sketch::CommandType::DeleteEntity:
@@ -14374,6 +14453,7 @@ void SketchCanvas::redoSingleCommand(const sketch::UndoCommand& cmd)
             m_selectedId = -1;
         }
         m_profilesCacheDirty = true;
+        markEntitiesChanged();
         break;
 
     case sketch::CommandType::ModifyEntity:
@@ -14389,6 +14469,7 @@ void SketchCanvas::redoSingleCommand(const sketch::UndoCommand& cmd)
             }
         }
         m_profilesCacheDirty = true;
+        markEntitiesChanged();
         break;
 
     case sketch::CommandType::AddConstraint:
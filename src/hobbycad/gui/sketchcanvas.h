@@ -26,8 +26,10 @@
 #include <hobbycad/geometry/utils.h>
 #include <hobbycad/sketch/background.h>
 #include <hobbycad/sketch/entity.h>
+#include <hobbycad/sketch/entity_store.h>
 #include <hobbycad/sketch/group.h>
 #include <hobbycad/sketch/snap.h>
+#include <hobbycad/sketch/solver.h>
 #include <hobbycad/sketch/undo.h>
 #include <hobbycad/units.h>
 
@@ -38,6 +40,7 @@
 #include <QKeySequence>
 #include <QHash>
 
+#include <memory>
 #include <optional>
 
 class QContextMenuEvent;
@@ -45,6 +48,7 @@ class QContextMenuEvent;
 namespace hobbycad {
 
 class ParameterEngine;  // Forward declaration (defined in parameters.h)
+class SketchSolver;     // Forward declaration (defined in sketchsolver.h)
 
 // Use types from project.h for consistency
 // SketchEntityType and SketchPlane are defined in hobbycad/project.h
@@ -530,6 +534,9 @@ private:
     void finishConstraintCreation();
     void deleteConstraintById(int constraintId);  // Delete a constraint with full cleanup + undo
     void solveConstraints();
+    void solveDragStep(int entityId, int pointIndex, int pinnedPointIndex = -1);
+    void endDragSolve();
+    void applySolveResult(const sketch::SolveResult& result);
     void refreshConstrainedFlags();  // Recompute entity.constrained from remaining constraints
     void updateDrivenDimensions();   // Update Driven dimension values from geometry
     void updateConstraintLabelPositions(); // Reposition labels to track geometry after solving
@@ -735,6 +742,7 @@ private:
     QPointF m_dragHandleOriginal2;   ///< Second point for circles (radius point)
     double m_dragOriginalRadius = 0; ///< Original radius for circles/arcs
     sketch::Entity m_dragOriginalEntity; ///< Full entity snapshot before drag (for undo)
+    std::unique_ptr<SketchSolver> m_dragSolver; ///< Warm-started solver for the current handle drag
     QPointF m_lastRawMouseWorld;     ///< Last raw (unsnapped) mouse position
     bool m_shiftWasPressed = false;  ///< Track Shift state for snap-to-grid during drag
     bool m_ctrlWasPressed = false;   ///< Track Ctrl state for axis constraint during drag
@@ -784,6 +792,15 @@ private:
     void drawProfiles(QPainter& painter) const;
     void invalidateProfileCache() { m_profilesCacheDirty = true; }
 
+    // Snapping — compact copy of m_entities, refilled (without
+    // reallocating) on the first snap query after an entity edit.
+    // Every change to entity geometry or to the entity set must call
+    // markEntitiesChanged(), or snapping sees stale geometry.
+    mutable sketch::EntityStore m_snapStore;
+    mutable quint64 m_snapStoreRevision = ~quint64(0);
+    quint64 m_entityRevision = 0;
+    void markEntitiesChanged() { ++m_entityRevision; }
+
     // Background image
     sketch::BackgroundImage m_backgroundImage;
     mutable QImage m_cachedBackgroundImage;  ///< Cached adjusted image for rendering
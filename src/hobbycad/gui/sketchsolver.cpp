@@ -11,6 +11,8 @@
 #include "sketchcanvas.h"
 #include "sketchutils.h"
 
+#include <QSettings>
+
 namespace hobbycad {
 
 // =====================================================================
@@ -53,6 +55,7 @@ void updateGuiEntitiesFromSolution(
 
 SketchSolver::SketchSolver()
 {
+    m_solver.setBackend(preferredBackend());
 }
 
 SketchSolver::~SketchSolver()
@@ -64,6 +67,16 @@ bool SketchSolver::isAvailable()
     return sketch::Solver::isAvailable();
 }
 
+sketch::SolverBackend SketchSolver::preferredBackend()
+{
+    QSettings settings;
+    QString name = settings.value(QStringLiteral("preferences/solverBackend"),
+                                  QStringLiteral("auto")).toString();
+    sketch::SolverBackend backend = sketch::SolverBackend::Automatic;
+    sketch::solverBackendFromName(name.toStdString(), &backend);
+    return backend;
+}
+
 SolveResult SketchSolver::solve(
     QVector<SketchEntity>& entities,
     const QVector<SketchConstraint>& constraints)
@@ -138,6 +151,37 @@ OverConstraintInfo SketchSolver::checkOverConstrain(
     return m_solver.checkOverConstrain(libEntities, libConstraints, libNewConstraint);
 }
 
+void SketchSolver::beginDrag(
+    const QVector<SketchEntity>& entities,
+    const QVector<SketchConstraint>& constraints,
+    int entityId, int pointIndex)
+{
+    sketch::DraggedPoint dragged;
+    dragged.entityId = entityId;
+    dragged.pointIndex = pointIndex;
+    m_drag.begin(toStdLibEntities(entities), toStdLibConstraints(constraints), {dragged});
+}
+
+SolveResult SketchSolver::dragStep(QVector<SketchEntity>& entities)
+{
+    std::vector<sketch::Entity> libEntities = toStdLibEntities(entities);
+    SolveResult result = m_drag.step(libEntities);
+
+    QVector<sketch::Entity> qLibEntities(libEntities.begin(), libEntities.end());
+    updateGuiEntitiesFromSolution(entities, qLibEntities);
+    return result;
+}
+
+void SketchSolver::endDrag()
+{
+    m_drag.end();
+}
+
+bool SketchSolver::isDragging() const
+{
+    return m_drag.isActive();
+}
+
 int SketchSolver::degreesOfFreedom(
     const QVector<SketchEntity>& entities,
     const QVector<SketchConstraint>& constraints)
@@ -13,6 +13,7 @@
 #define HOBBYCAD_SKETCHSOLVER_H
 
 #include <hobbycad/sketch/solver.h>
+#include <hobbycad/sketch/drag_session.h>
 
 #include <QVector>
 #include <QPointF>
@@ -67,11 +68,37 @@ public:
         const QVector<SketchConstraint>& constraints
     );
 
-    /// Check if solver is available (libslvs compiled in)
+    /// Check if solver is available
     static bool isAvailable();
 
+    /// Backend chosen by the "solverBackend" preference
+    static sketch::SolverBackend preferredBackend();
+
+    // ---- Interactive drag ----
+
+    /// Start a drag gesture on one point.  The constraint system is
+    /// built once and reused by every dragStep() until endDrag().
+    void beginDrag(
+        const QVector<SketchEntity>& entities,
+        const QVector<SketchConstraint>& constraints,
+        int entityId, int pointIndex
+    );
+
+    /// Solve one frame of the drag, warm-started from the previous
+    /// frame, with the dragged point already moved in entities.
+    /// Entities are updated with the best solution found within the
+    /// per-frame iteration budget.
+    SolveResult dragStep(QVector<SketchEntity>& entities);
+
+    /// Finish the drag gesture
+    void endDrag();
+
+    /// True between beginDrag() and endDrag()
+    bool isDragging() const;
+
 private:
     sketch::Solver m_solver;
+    sketch::DragSession m_drag;
 };
 
 }  // namespace hobbycad
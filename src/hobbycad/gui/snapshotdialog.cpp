@@ -0,0 +1,200 @@
+// =====================================================================
+//  src/hobbycad/gui/snapshotdialog.cpp — Project snapshot history dialog
+// =====================================================================
+
+#include "snapshotdialog.h"
+
+#include <QDateTime>
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QInputDialog>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QSplitter>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+namespace hobbycad {
+
+namespace {
+
+// Tree column indices
+constexpr int kColId      = 0;
+constexpr int kColTime    = 1;
+constexpr int kColMessage = 2;
+constexpr int kColAuthor  = 3;
+
+}  // namespace
+
+SnapshotDialog::SnapshotDialog(const QString& projectDir, QWidget* parent)
+    : QDialog(parent)
+{
+    setObjectName(QStringLiteral("SnapshotDialog"));
+    setWindowTitle(tr("Snapshot History"));
+    resize(640, 460);
+
+    auto* layout = new QVBoxLayout(this);
+
+    auto* splitter = new QSplitter(Qt::Vertical);
+
+    m_list = new QTreeWidget;
+    m_list->setObjectName(QStringLiteral("SnapshotList"));
+    m_list->setHeaderLabels({tr("Snapshot"), tr("Date"), tr("Message"), tr("Author")});
+    m_list->setRootIsDecorated(false);
+    m_list->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_list->header()->setSectionResizeMode(kColMessage, QHeaderView::Stretch);
+    splitter->addWidget(m_list);
+
+    m_changes = new QPlainTextEdit;
+    m_changes->setObjectName(QStringLiteral("SnapshotChanges"));
+    m_changes->setReadOnly(true);
+    m_changes->setPlaceholderText(tr("Select a snapshot to see which files it changed."));
+    splitter->addWidget(m_changes);
+    splitter->setStretchFactor(0, 3);
+    splitter->setStretchFactor(1, 1);
+    layout->addWidget(splitter);
+
+    m_statusLabel = new QLabel;
+    layout->addWidget(m_statusLabel);
+
+    auto* buttonRow = new QHBoxLayout;
+    m_takeBtn = new QPushButton(tr("Take Snapshot..."));
+    m_takeBtn->setToolTip(tr("Record the project as it is currently saved on disk"));
+    buttonRow->addWidget(m_takeBtn);
+
+    m_restoreBtn = new QPushButton(tr("Restore"));
+    m_restoreBtn->setToolTip(tr("Restore the project files to the selected snapshot"));
+    m_restoreBtn->setEnabled(false);
+    buttonRow->addWidget(m_restoreBtn);
+    buttonRow->addStretch();
+
+    auto* buttonBox = new QDialogButtonBox(QDialogButtonBox::Close);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    buttonRow->addWidget(buttonBox);
+    layout->addLayout(buttonRow);
+
+    connect(m_list, &QTreeWidget::itemSelectionChanged,
+            this, &SnapshotDialog::onSelectionChanged);
+    connect(m_takeBtn, &QPushButton::clicked, this, &SnapshotDialog::onTakeSnapshot);
+    connect(m_restoreBtn, &QPushButton::clicked, this, &SnapshotDialog::onRestore);
+
+    std::string errorMsg;
+    if (!m_store.open(projectDir.toStdString(), &errorMsg)) {
+        m_statusLabel->setText(QString::fromStdString(errorMsg));
+        m_takeBtn->setEnabled(false);
+        return;
+    }
+
+    refreshList();
+}
+
+void SnapshotDialog::refreshList()
+{
+    m_list->clear();
+
+    const auto snapshots = m_store.listSnapshots();
+    for (const auto& info : snapshots) {
+        auto* item = new QTreeWidgetItem(m_list);
+        item->setText(kColId, QString::fromStdString(info.shortId));
+        item->setText(kColTime, QDateTime::fromSecsSinceEpoch(info.time)
+                                    .toString(QStringLiteral("yyyy-MM-dd HH:mm:ss")));
+        item->setText(kColMessage, QString::fromStdString(info.message));
+        item->setText(kColAuthor, QString::fromStdString(info.author));
+        item->setData(kColId, Qt::UserRole, QString::fromStdString(info.id));
+        item->setData(kColId, Qt::UserRole + 1, QString::fromStdString(info.parentId));
+    }
+
+    for (int col = 0; col < m_list->columnCount(); ++col) {
+        if (col != kColMessage) m_list->resizeColumnToContents(col);
+    }
+
+    m_statusLabel->setText(tr("%n snapshot(s)", nullptr, static_cast<int>(snapshots.size())));
+    m_changes->clear();
+    m_restoreBtn->setEnabled(false);
+}
+
+void SnapshotDialog::onSelectionChanged()
+{
+    const auto selected = m_list->selectedItems();
+    m_restoreBtn->setEnabled(!selected.isEmpty());
+    m_changes->clear();
+    if (selected.isEmpty()) return;
+
+    const QString id = selected.first()->data(kColId, Qt::UserRole).toString();
+    const QString parentId = selected.first()->data(kColId, Qt::UserRole + 1).toString();
+    if (parentId.isEmpty()) {
+        m_changes->setPlainText(tr("First snapshot of this project."));
+        return;
+    }
+
+    const auto summary = m_store.diff(parentId.toStdString(), id.toStdString());
+    if (!summary.success) {
+        m_changes->setPlainText(QString::fromStdString(summary.errorMessage));
+        return;
+    }
+
+    QStringList lines;
+    lines << tr("%1 added, %2 modified, %3 deleted, %4 renamed")
+                 .arg(summary.added).arg(summary.modified)
+                 .arg(summary.deleted).arg(summary.renamed);
+    for (const auto& change : summary.changes) {
+        QString line = QStringLiteral("  %1  %2")
+            .arg(QString::fromStdString(snapshot::changeKindName(change.kind)), -9)
+            .arg(QString::fromStdString(change.path));
+        if (change.kind == snapshot::ChangeKind::Renamed) {
+            line += tr(" (from %1)").arg(QString::fromStdString(change.oldPath));
+        }
+        lines << line;
+    }
+    m_changes->setPlainText(lines.join(QLatin1Char('\n')));
+}
+
+void SnapshotDialog::onTakeSnapshot()
+{
+    bool ok = false;
+    QString message = QInputDialog::getText(this,
+        tr("Take Snapshot"), tr("Snapshot message:"),
+        QLineEdit::Normal, tr("Manual snapshot"), &ok);
+    if (!ok) return;
+
+    const auto result = m_store.takeSnapshot(message.toStdString());
+    if (!result.success) {
+        QMessageBox::warning(this, tr("Snapshot Failed"),
+            QString::fromStdString(result.errorMessage));
+        return;
+    }
+
+    refreshList();
+    if (!result.created) {
+        m_statusLabel->setText(tr("No changes since the last snapshot"));
+    }
+}
+
+void SnapshotDialog::onRestore()
+{
+    const auto selected = m_list->selectedItems();
+    if (selected.isEmpty()) return;
+
+    const QString id = selected.first()->data(kColId, Qt::UserRole).toString();
+    auto answer = QMessageBox::question(this, tr("Restore Snapshot"),
+        tr("Restore the project to snapshot %1?\n\n"
+           "Project files on disk will be replaced and any unsaved\n"
+           "changes will be lost.")
+            .arg(selected.first()->text(kColId)));
+    if (answer != QMessageBox::Yes) return;
+
+    std::string errorMsg;
+    if (!m_store.restoreSnapshot(id.toStdString(), &errorMsg)) {
+        QMessageBox::warning(this, tr("Restore Failed"),
+            QString::fromStdString(errorMsg));
+        return;
+    }
+
+    emit snapshotRestored();
+    m_statusLabel->setText(tr("Restored snapshot %1").arg(selected.first()->text(kColId)));
+}
+
+}  // namespace hobbycad
@@ -0,0 +1,59 @@
+// =====================================================================
+//  src/hobbycad/gui/snapshotdialog.h — Project snapshot history dialog
+// =====================================================================
+//
+//  Lists the snapshots recorded for the open project, shows which
+//  files changed in each one, and restores the project to a chosen
+//  snapshot.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_SNAPSHOTDIALOG_H
+#define HOBBYCAD_SNAPSHOTDIALOG_H
+
+#include <hobbycad/snapshot.h>
+
+#include <QDialog>
+
+class QLabel;
+class QPlainTextEdit;
+class QPushButton;
+class QTreeWidget;
+
+namespace hobbycad {
+
+/// Dialog for browsing and restoring project snapshots.
+class SnapshotDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    /// @param projectDir Directory of the open project
+    explicit SnapshotDialog(const QString& projectDir, QWidget* parent = nullptr);
+
+signals:
+    /// Emitted after the project files were restored from a snapshot.
+    /// The receiver must reload the project from disk.
+    void snapshotRestored();
+
+private slots:
+    void onSelectionChanged();
+    void onTakeSnapshot();
+    void onRestore();
+
+private:
+    void refreshList();
+
+    snapshot::SnapshotStore m_store;
+
+    QTreeWidget*    m_list        = nullptr;
+    QPlainTextEdit* m_changes     = nullptr;
+    QLabel*         m_statusLabel = nullptr;
+    QPushButton*    m_takeBtn     = nullptr;
+    QPushButton*    m_restoreBtn  = nullptr;
+};
+
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_SNAPSHOTDIALOG_H
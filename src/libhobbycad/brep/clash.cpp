@@ -0,0 +1,313 @@
+// =====================================================================
+//  src/libhobbycad/brep/clash.cpp — Clash detection for B-rep bodies
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/brep/clash.h>
+#include <hobbycad/mesh/types.h>
+
+#include <BRepAlgoAPI_Common.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepClass3d_SolidClassifier.hxx>
+#include <BRepExtrema_DistShapeShape.hxx>
+#include <BRepGProp.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <Bnd_Box.hxx>
+#include <GProp_GProps.hxx>
+#include <IMeshTools_Parameters.hxx>
+#include <OSD_Parallel.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_ListOfShape.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <set>
+#include <string>
+#include <utility>
+
+namespace hobbycad {
+namespace brep {
+
+namespace {
+
+/// Default mesh deflection as a fraction of the body diagonal
+constexpr double kRelativeDeflection = 1e-3;
+
+/// Angular deflection for clash meshes (radians)
+constexpr double kAngularDeflection = 0.35;
+
+mesh::MeshBox toMeshBox(const Bnd_Box& box)
+{
+    mesh::MeshBox b;
+    if (box.IsVoid()) return b;
+    double x0, y0, z0, x1, y1, z1;
+    box.Get(x0, y0, z0, x1, y1, z1);
+    b.add(mesh::MeshPoint(x0, y0, z0));
+    b.add(mesh::MeshPoint(x1, y1, z1));
+    return b;
+}
+
+mesh::MeshPoint toMeshPoint(const gp_Pnt& p)
+{
+    return {p.X(), p.Y(), p.Z()};
+}
+
+/// Faces of a body and a hierarchy over their boxes
+struct BodyFaces {
+    std::vector<TopoDS_Face> faces;
+    mesh::BoxTree tree;
+    mesh::MeshBox box;
+    bool solid = false;
+};
+
+BodyFaces collectFaces(const TopoDS_Shape& shape)
+{
+    BodyFaces body;
+    if (shape.IsNull()) return body;
+    std::vector<mesh::MeshBox> boxes;
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        Bnd_Box box;
+        BRepBndLib::Add(exp.Current(), box);
+        if (box.IsVoid()) continue;
+        body.faces.push_back(TopoDS::Face(exp.Current()));
+        boxes.push_back(toMeshBox(box));
+        body.box.add(boxes.back());
+    }
+    body.tree.build(boxes);
+    body.solid = TopExp_Explorer(shape, TopAbs_SOLID).More();
+    return body;
+}
+
+/// Compound of the faces with the given indices
+TopoDS_Compound faceCompound(const std::vector<TopoDS_Face>& faces, const std::set<int>& which)
+{
+    BRep_Builder builder;
+    TopoDS_Compound compound;
+    builder.MakeCompound(compound);
+    for (int i : which) builder.Add(compound, faces[i]);
+    return compound;
+}
+
+/// True if the first vertex of inner lies inside the solid outer
+bool firstVertexInside(const TopoDS_Shape& inner, const TopoDS_Shape& outer,
+                       const mesh::MeshBox& outerBox, double tolerance, gp_Pnt& at)
+{
+    TopExp_Explorer exp(inner, TopAbs_VERTEX);
+    if (!exp.More()) return false;
+    at = BRep_Tool::Pnt(TopoDS::Vertex(exp.Current()));
+    mesh::MeshBox point;
+    point.add(toMeshPoint(at));
+    if (!outerBox.overlaps(point)) return false;
+    BRepClass3d_SolidClassifier classifier(outer, at, tolerance);
+    return classifier.State() == TopAbs_IN;
+}
+
+/// Volume and centre of the shared part of two bodies.  Runs
+/// non-destructively so pairs can share input shapes across threads.
+bool commonVolume(const TopoDS_Shape& a, const TopoDS_Shape& b, double& volume, gp_Pnt& centre)
+{
+    try {
+        TopTools_ListOfShape arguments, tools;
+        arguments.Append(a);
+        tools.Append(b);
+        BRepAlgoAPI_Common common;
+        common.SetArguments(arguments);
+        common.SetTools(tools);
+        common.SetNonDestructive(Standard_True);
+        common.SetRunParallel(Standard_False);
+        common.Build();
+        if (!common.IsDone()) return false;
+        GProp_GProps props;
+        BRepGProp::VolumeProperties(common.Shape(), props);
+        volume = std::abs(props.Mass());
+        if (volume > 0.0) centre = props.CentreOfMass();
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+/// Volume below which touching faces are contact: the overlap must be
+/// thicker than the tolerance across its largest face
+double contactVolume(const mesh::MeshBox& a, const mesh::MeshBox& b, double tolerance)
+{
+    const double dx = std::min(a.max.x, b.max.x) - std::max(a.min.x, b.min.x);
+    const double dy = std::min(a.max.y, b.max.y) - std::max(a.min.y, b.min.y);
+    const double dz = std::min(a.max.z, b.max.z) - std::max(a.min.z, b.min.z);
+    if (dx < 0.0 || dy < 0.0 || dz < 0.0) return 0.0;
+    return tolerance * std::max({dx * dy, dy * dz, dz * dx});
+}
+
+/// Check one candidate pair on the exact geometry
+bool classifyExact(const TopoDS_Shape& shapeA, const BodyFaces& a,
+                   const TopoDS_Shape& shapeB, const BodyFaces& b,
+                   const ClashOptions& options, mesh::ClashPair& clash)
+{
+    const double tol = options.contactTolerance;
+    const double reach = std::max(options.clearance, tol);
+
+    // Only faces whose boxes come within reach can set the distance
+    std::set<int> nearA, nearB;
+    for (const auto& [i, j] : a.tree.pairs(b.tree, reach)) {
+        nearA.insert(i);
+        nearB.insert(j);
+    }
+
+    double distance = -1.0;
+    if (!nearA.empty()) {
+        BRepExtrema_DistShapeShape extrema(faceCompound(a.faces, nearA),
+                                           faceCompound(b.faces, nearB));
+        if (extrema.IsDone() && extrema.NbSolution() > 0) {
+            distance = extrema.Value();
+            clash.pointA = toMeshPoint(extrema.PointOnShape1(1));
+            clash.pointB = toMeshPoint(extrema.PointOnShape2(1));
+        }
+    }
+
+    if (distance >= 0.0 && distance <= tol) {
+        // Crossing or touching faces; the boolean tells them apart
+        double volume = 0.0;
+        gp_Pnt centre;
+        if (a.solid && b.solid && commonVolume(shapeA, shapeB, volume, centre) &&
+            volume > contactVolume(a.box, b.box, tol)) {
+            clash.type = mesh::ClashType::Interference;
+            clash.pointA = clash.pointB = toMeshPoint(centre);
+            clash.volume = options.computeVolumes ? volume : 0.0;
+        } else {
+            clash.type = mesh::ClashType::Contact;
+            clash.distance = distance;
+        }
+        return true;
+    }
+
+    // Faces apart: one body may still lie inside the other
+    if (a.solid && b.solid) {
+        gp_Pnt at;
+        const TopoDS_Shape* inner = nullptr;
+        if (firstVertexInside(shapeA, shapeB, b.box, tol, at)) inner = &shapeA;
+        else if (firstVertexInside(shapeB, shapeA, a.box, tol, at)) inner = &shapeB;
+        if (inner) {
+            clash.type = mesh::ClashType::Interference;
+            clash.pointA = clash.pointB = toMeshPoint(at);
+            if (options.computeVolumes) {
+                GProp_GProps props;
+                BRepGProp::VolumeProperties(*inner, props);
+                clash.volume = std::abs(props.Mass());
+                clash.pointA = clash.pointB = toMeshPoint(props.CentreOfMass());
+            }
+            return true;
+        }
+    }
+
+    if (distance >= 0.0 && distance <= options.clearance) {
+        clash.type = mesh::ClashType::Clearance;
+        clash.distance = distance;
+        return true;
+    }
+    return false;
+}
+
+/// Tessellate the bodies (reusing finer triangulations already on the
+/// faces) and run the triangle-level checks
+mesh::ClashReport findClashesOnMeshes(const std::vector<TopoDS_Shape>& bodies,
+                                      const ClashOptions& options)
+{
+    mesh::ClashReport report;
+    std::vector<mesh::TriangleMesh> meshes(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        if (bodies[i].IsNull()) continue;
+        try {
+            Bnd_Box box;
+            BRepBndLib::Add(bodies[i], box);
+            if (box.IsVoid()) continue;
+            IMeshTools_Parameters params;
+            params.Deflection = options.deflection > 0.0
+                ? options.deflection
+                : kRelativeDeflection * std::sqrt(box.SquareExtent());
+            params.Angle = kAngularDeflection;
+            params.InParallel = options.parallel ? Standard_True : Standard_False;
+            BRepMesh_IncrementalMesh mesher(bodies[i], params);
+            if (!mesher.IsDone()) {
+                report.errorMessage = "Failed to mesh body " + std::to_string(i + 1);
+                return report;
+            }
+        } catch (...) {
+            report.errorMessage = "Exception while meshing body " + std::to_string(i + 1);
+            return report;
+        }
+        meshes[i] = mesh::fromShape(bodies[i]);
+    }
+
+    mesh::ClashOptions meshOptions;
+    meshOptions.clearance = options.clearance;
+    meshOptions.contactTolerance = options.contactTolerance;
+    meshOptions.computeVolumes = options.computeVolumes;
+    meshOptions.parallel = options.parallel;
+    return mesh::findClashes(meshes, meshOptions);
+}
+
+}  // anonymous namespace
+
+mesh::ClashReport findClashes(const std::vector<TopoDS_Shape>& bodies, const ClashOptions& options)
+{
+    const auto start = std::chrono::steady_clock::now();
+    mesh::ClashReport report;
+    report.bodies = static_cast<int>(bodies.size());
+
+    if (options.clearance < 0.0 || options.contactTolerance < 0.0) {
+        report.errorMessage = "Clearance and contact tolerance must not be negative";
+        return report;
+    }
+
+    if (options.method == ClashMethod::Mesh) {
+        report = findClashesOnMeshes(bodies, options);
+    } else {
+        const int n = static_cast<int>(bodies.size());
+        std::vector<BodyFaces> faces(n);
+        std::vector<mesh::MeshBox> boxes(n);
+        OSD_Parallel::For(0, n, [&](int i) {
+            faces[i] = collectFaces(bodies[i]);
+            boxes[i] = faces[i].box;
+        }, !options.parallel);
+
+        // Broad phase over the body boxes, then face boxes per pair
+        const double reach = std::max(options.clearance, options.contactTolerance);
+        const auto candidates = mesh::BoxTree(boxes).selfPairs(reach);
+        report.candidatePairs = static_cast<int>(candidates.size());
+
+        std::vector<mesh::ClashPair> found(candidates.size());
+        std::vector<char> hit(candidates.size(), 0);
+        OSD_Parallel::For(0, static_cast<int>(candidates.size()), [&](int k) {
+            const auto [i, j] = candidates[k];
+            found[k].bodyA = i;
+            found[k].bodyB = j;
+            try {
+                hit[k] = classifyExact(bodies[i], faces[i], bodies[j], faces[j],
+                                       options, found[k]);
+            } catch (...) {
+                hit[k] = 0;
+            }
+        }, !options.parallel);
+
+        for (size_t k = 0; k < candidates.size(); ++k)
+            if (hit[k]) report.clashes.push_back(found[k]);
+        report.success = true;
+    }
+
+    report.bodies = static_cast<int>(bodies.size());
+    report.milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+}  // namespace brep
+}  // namespace hobbycad
@@ -0,0 +1,530 @@
+// =====================================================================
+//  src/libhobbycad/brep/edge_cache.cpp — Sketch edge cache
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/brep/edge_cache.h>
+#include <hobbycad/brep/operations.h>
+#include <hobbycad/sketch/text.h>
+
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <BRepBuilderAPI_MakeEdge.hxx>
+#include <BRepBuilderAPI_MakeVertex.hxx>
+#include <BRepBuilderAPI_MakeWire.hxx>
+#include <Geom_BSplineCurve.hxx>
+#include <Precision.hxx>
+#include <TColStd_Array1OfInteger.hxx>
+#include <TColStd_Array1OfReal.hxx>
+#include <TColgp_Array1OfPnt.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopExp_Explorer.hxx>
+#include <gp_Ax2.hxx>
+#include <gp_Circ.hxx>
+#include <gp_Elips.hxx>
+#include <gp_Pnt.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace hobbycad {
+namespace brep {
+
+namespace {
+
+/// Convert a sketch point to 3D (on the XY plane at Z=0)
+gp_Pnt toPoint3D(const Point2D& p)
+{
+    return gp_Pnt(p.x, p.y, 0.0);
+}
+
+/// Exact OpenCASCADE copy of a kernel spline (same poles, weights and
+/// knots), or a null handle if OpenCASCADE rejects the definition
+Handle(Geom_BSplineCurve) toGeomCurve(const geometry::BSplineCurve2D& spline)
+{
+    if (!spline.isValid()) return Handle(Geom_BSplineCurve)();
+
+    const std::vector<Point2D>& poles = spline.poles();
+    std::vector<double> knotValues;
+    std::vector<int> mults;
+    spline.knotMultiplicities(&knotValues, &mults);
+
+    TColgp_Array1OfPnt occPoles(1, static_cast<int>(poles.size()));
+    for (size_t i = 0; i < poles.size(); ++i)
+        occPoles.SetValue(static_cast<int>(i) + 1, toPoint3D(poles[i]));
+
+    TColStd_Array1OfReal occKnots(1, static_cast<int>(knotValues.size()));
+    TColStd_Array1OfInteger occMults(1, static_cast<int>(mults.size()));
+    for (size_t i = 0; i < knotValues.size(); ++i) {
+        occKnots.SetValue(static_cast<int>(i) + 1, knotValues[i]);
+        occMults.SetValue(static_cast<int>(i) + 1, mults[i]);
+    }
+
+    try {
+        if (!spline.isRational())
+            return new Geom_BSplineCurve(occPoles, occKnots, occMults, spline.degree());
+
+        TColStd_Array1OfReal occWeights(1, static_cast<int>(poles.size()));
+        for (size_t i = 0; i < poles.size(); ++i)
+            occWeights.SetValue(static_cast<int>(i) + 1, spline.weights()[i]);
+        return new Geom_BSplineCurve(occPoles, occWeights, occKnots, occMults, spline.degree());
+    } catch (...) {
+        return Handle(Geom_BSplineCurve)();
+    }
+}
+
+/// Hash of a weld cell.  Collisions only cost a few extra distance
+/// checks, since vertices are matched by position within the cell.
+std::int64_t cellKey(long long cx, long long cy)
+{
+    return static_cast<std::int64_t>(cx) * 73856093LL ^ static_cast<std::int64_t>(cy) * 19349663LL;
+}
+
+/// True if two entities produce the same edges
+bool sameGeometry(const sketch::Entity& a, const sketch::Entity& b)
+{
+    if (a.type != b.type || a.points.size() != b.points.size()) return false;
+    for (size_t i = 0; i < a.points.size(); ++i) {
+        if (a.points[i].x != b.points[i].x || a.points[i].y != b.points[i].y) return false;
+    }
+    return a.radius == b.radius &&
+           a.startAngle == b.startAngle &&
+           a.sweepAngle == b.sweepAngle &&
+           a.sides == b.sides &&
+           a.majorRadius == b.majorRadius &&
+           a.minorRadius == b.minorRadius &&
+           a.text == b.text &&
+           a.fontFamily == b.fontFamily &&
+           a.fontSize == b.fontSize &&
+           a.fontBold == b.fontBold &&
+           a.fontItalic == b.fontItalic &&
+           a.textRotation == b.textRotation;
+}
+
+const std::vector<TopoDS_Edge> kNoEdges;
+
+}  // anonymous namespace
+
+// =====================================================================
+//  Entity Set
+// =====================================================================
+
+SketchEdgeCache::SketchEdgeCache(const std::vector<sketch::Entity>& entities, double tolerance)
+    : m_tolerance(std::max(tolerance, Precision::Confusion()))
+{
+    update(entities);
+}
+
+int SketchEdgeCache::update(const std::vector<sketch::Entity>& entities)
+{
+    int invalidated = 0;
+
+    std::unordered_set<int> present;
+    present.reserve(entities.size());
+    m_order.clear();
+    m_order.reserve(entities.size());
+
+    for (const sketch::Entity& entity : entities) {
+        present.insert(entity.id);
+        m_order.push_back(entity.id);
+
+        auto it = m_slots.find(entity.id);
+        if (it == m_slots.end()) {
+            Slot slot;
+            slot.entity = entity;
+            m_slots.emplace(entity.id, std::move(slot));
+            continue;
+        }
+
+        Slot& slot = it->second;
+        if (!sameGeometry(slot.entity, entity)) {
+            if (slot.built) ++invalidated;
+            release(slot);
+        }
+        slot.entity = entity;
+    }
+
+    for (auto it = m_slots.begin(); it != m_slots.end();) {
+        if (present.count(it->first) == 0) {
+            if (it->second.built) ++invalidated;
+            release(it->second);
+            it = m_slots.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    return invalidated;
+}
+
+void SketchEdgeCache::invalidate(int entityId)
+{
+    auto it = m_slots.find(entityId);
+    if (it != m_slots.end()) {
+        release(it->second);
+    }
+}
+
+void SketchEdgeCache::invalidateAll()
+{
+    for (auto& entry : m_slots) {
+        entry.second.edges.clear();
+        entry.second.vertices.clear();
+        entry.second.built = false;
+    }
+    m_vertices.clear();
+}
+
+const sketch::Entity* SketchEdgeCache::entity(int entityId) const
+{
+    auto it = m_slots.find(entityId);
+    return it != m_slots.end() ? &it->second.entity : nullptr;
+}
+
+// =====================================================================
+//  Edges and Wires
+// =====================================================================
+
+const std::vector<TopoDS_Edge>& SketchEdgeCache::edges(int entityId)
+{
+    auto it = m_slots.find(entityId);
+    if (it == m_slots.end()) return kNoEdges;
+
+    Slot& slot = it->second;
+    if (!slot.built) {
+        build(slot);
+    }
+    return slot.edges;
+}
+
+TopoDS_Wire SketchEdgeCache::wire(const sketch::Profile& profile)
+{
+    BRepBuilderAPI_MakeWire wireBuilder;
+
+    for (size_t i = 0; i < profile.entityIds.size(); ++i) {
+        bool reversed = (i < profile.reversed.size()) ? profile.reversed[i] : false;
+        const std::vector<TopoDS_Edge>& entityEdges = edges(profile.entityIds[i]);
+
+        // A reversed entity is traversed backwards: its edges in the
+        // opposite order, each with flipped orientation, so the wire
+        // still uses the shared edges
+        if (reversed) {
+            for (auto e = entityEdges.rbegin(); e != entityEdges.rend(); ++e) {
+                wireBuilder.Add(TopoDS::Edge(e->Reversed()));
+            }
+        } else {
+            for (const TopoDS_Edge& e : entityEdges) {
+                wireBuilder.Add(e);
+            }
+        }
+    }
+
+    if (wireBuilder.IsDone()) {
+        return wireBuilder.Wire();
+    }
+
+    return TopoDS_Wire();
+}
+
+TopoDS_Shape SketchEdgeCache::wireframe()
+{
+    BRep_Builder builder;
+    TopoDS_Compound compound;
+    builder.MakeCompound(compound);
+
+    for (int id : m_order) {
+        Slot& slot = m_slots[id];
+        if (!slot.built) {
+            build(slot);
+        }
+
+        if (slot.entity.type == sketch::EntityType::Point) {
+            for (const auto& used : slot.vertices) {
+                builder.Add(compound, used.second);
+            }
+        }
+        for (const TopoDS_Edge& e : slot.edges) {
+            builder.Add(compound, e);
+        }
+    }
+
+    return compound;
+}
+
+EdgeCacheStats SketchEdgeCache::stats() const
+{
+    EdgeCacheStats s;
+    s.entities = m_slots.size();
+    s.builtEntities = m_builtEntities;
+    for (const auto& entry : m_slots) {
+        s.edges += entry.second.edges.size();
+    }
+    for (const auto& cell : m_vertices) {
+        s.vertices += cell.second.size();
+    }
+    return s;
+}
+
+// =====================================================================
+//  Building
+// =====================================================================
+
+TopoDS_Vertex SketchEdgeCache::vertexAt(const Point2D& p, Slot& slot)
+{
+    const long long cx = static_cast<long long>(std::floor(p.x / m_tolerance));
+    const long long cy = static_cast<long long>(std::floor(p.y / m_tolerance));
+
+    // A vertex within tolerance is in this cell or a neighbour
+    SharedVertex* best = nullptr;
+    std::int64_t bestKey = 0;
+    double bestDist = m_tolerance;
+    for (long long dy = -1; dy <= 1; ++dy) {
+        for (long long dx = -1; dx <= 1; ++dx) {
+            std::int64_t key = cellKey(cx + dx, cy + dy);
+            auto it = m_vertices.find(key);
+            if (it == m_vertices.end()) continue;
+            for (SharedVertex& v : it->second) {
+                double d = std::hypot(v.position.x - p.x, v.position.y - p.y);
+                if (d <= bestDist) {
+                    best = &v;
+                    bestKey = key;
+                    bestDist = d;
+                }
+            }
+        }
+    }
+
+    if (best) {
+        // Widen the vertex to cover this endpoint, as sewing would
+        if (bestDist > BRep_Tool::Tolerance(best->vertex)) {
+            BRep_Builder().UpdateVertex(best->vertex, bestDist + Precision::Confusion());
+        }
+        ++best->users;
+        slot.vertices.emplace_back(bestKey, best->vertex);
+        return best->vertex;
+    }
+
+    SharedVertex v;
+    v.position = p;
+    v.vertex = BRepBuilderAPI_MakeVertex(toPoint3D(p));
+    v.users = 1;
+
+    std::int64_t key = cellKey(cx, cy);
+    m_vertices[key].push_back(v);
+    slot.vertices.emplace_back(key, v.vertex);
+    return v.vertex;
+}
+
+void SketchEdgeCache::release(Slot& slot)
+{
+    for (const auto& used : slot.vertices) {
+        auto it = m_vertices.find(used.first);
+        if (it == m_vertices.end()) continue;
+
+        std::vector<SharedVertex>& cell = it->second;
+        for (size_t i = 0; i < cell.size(); ++i) {
+            if (cell[i].vertex.IsSame(used.second)) {
+                if (--cell[i].users <= 0) {
+                    cell.erase(cell.begin() + static_cast<std::ptrdiff_t>(i));
+                }
+                break;
+            }
+        }
+        if (cell.empty()) {
+            m_vertices.erase(it);
+        }
+    }
+
+    slot.vertices.clear();
+    slot.edges.clear();
+    slot.built = false;
+}
+
+void SketchEdgeCache::build(Slot& slot)
+{
+    const sketch::Entity& entity = slot.entity;
+    std::vector<TopoDS_Edge>& out = slot.edges;
+
+    slot.built = true;
+    ++m_builtEntities;
+
+    // Straight edge between two welded vertices
+    auto addSegment = [&](const Point2D& a, const Point2D& b) {
+        TopoDS_Vertex va = vertexAt(a, slot);
+        TopoDS_Vertex vb = vertexAt(b, slot);
+        if (va.IsSame(vb)) return;
+        BRepBuilderAPI_MakeEdge makeEdge(va, vb);
+        if (makeEdge.IsDone()) out.push_back(makeEdge.Edge());
+    };
+
+    // Circular arc from startDeg sweeping sweepDeg (either sign),
+    // ending on welded vertices
+    auto addArc = [&](const Point2D& center, double r, double startDeg, double sweepDeg) {
+        double a0 = startDeg * M_PI / 180.0;
+        double a1 = (startDeg + sweepDeg) * M_PI / 180.0;
+        Point2D p0(center.x + r * std::cos(a0), center.y + r * std::sin(a0));
+        Point2D p1(center.x + r * std::cos(a1), center.y + r * std::sin(a1));
+        TopoDS_Vertex v0 = vertexAt(p0, slot);
+        TopoDS_Vertex v1 = vertexAt(p1, slot);
+
+        gp_Circ circle(gp_Ax2(toPoint3D(center), gp_Dir(0, 0, 1)), r);
+
+        // The circle runs counter-clockwise; a clockwise arc is built
+        // from its end and flipped so the edge still runs start to end
+        if (sweepDeg >= 0.0) {
+            BRepBuilderAPI_MakeEdge makeEdge(circle, v0, v1, a0, a1);
+            if (makeEdge.IsDone()) out.push_back(makeEdge.Edge());
+        } else {
+            BRepBuilderAPI_MakeEdge makeEdge(circle, v1, v0, a1, a0);
+            if (makeEdge.IsDone()) out.push_back(TopoDS::Edge(makeEdge.Edge().Reversed()));
+        }
+    };
+
+    auto addPolyline = [&](const std::vector<Point2D>& corners) {
+        for (size_t i = 0; i < corners.size(); ++i) {
+            addSegment(corners[i], corners[(i + 1) % corners.size()]);
+        }
+    };
+
+    switch (entity.type) {
+    case sketch::EntityType::Point:
+        if (!entity.points.empty()) {
+            vertexAt(entity.points[0], slot);
+        }
+        break;
+
+    case sketch::EntityType::Line:
+        if (entity.points.size() >= 2) {
+            addSegment(entity.points[0], entity.points[1]);
+        }
+        break;
+
+    case sketch::EntityType::Arc:
+        if (!entity.points.empty() && entity.radius > Precision::Confusion() &&
+            std::abs(entity.sweepAngle) > 1e-9) {
+            if (std::abs(entity.sweepAngle) >= 360.0) {
+                gp_Circ circle(gp_Ax2(toPoint3D(entity.points[0]), gp_Dir(0, 0, 1)), entity.radius);
+                BRepBuilderAPI_MakeEdge makeEdge(circle);
+                if (makeEdge.IsDone()) out.push_back(makeEdge.Edge());
+            } else {
+                addArc(entity.points[0], entity.radius, entity.startAngle, entity.sweepAngle);
+            }
+        }
+        break;
+
+    case sketch::EntityType::Circle:
+        if (!entity.points.empty() && entity.radius > Precision::Confusion()) {
+            gp_Circ circle(gp_Ax2(toPoint3D(entity.points[0]), gp_Dir(0, 0, 1)), entity.radius);
+            BRepBuilderAPI_MakeEdge makeEdge(circle);
+            if (makeEdge.IsDone()) out.push_back(makeEdge.Edge());
+        }
+        break;
+
+    case sketch::EntityType::Ellipse:
+        if (!entity.points.empty() && entity.minorRadius > Precision::Confusion() &&
+            entity.majorRadius > Precision::Confusion()) {
+            // gp_Elips requires major >= minor; a taller ellipse puts
+            // its major axis along Y instead
+            bool tall = entity.minorRadius > entity.majorRadius;
+            gp_Ax2 axis(toPoint3D(entity.points[0]), gp_Dir(0, 0, 1),
+                        tall ? gp_Dir(0, 1, 0) : gp_Dir(1, 0, 0));
+            gp_Elips ellipse(axis, std::max(entity.majorRadius, entity.minorRadius),
+                             std::min(entity.majorRadius, entity.minorRadius));
+            BRepBuilderAPI_MakeEdge makeEdge(ellipse);
+            if (makeEdge.IsDone()) out.push_back(makeEdge.Edge());
+        }
+        break;
+
+    case sketch::EntityType::Spline:
+        if (auto spline = entity.splineCurve()) {
+            // The kernel's exact B-spline (the curve the sketch shows),
+            // ending on welded vertices
+            Handle(Geom_BSplineCurve) curve = toGeomCurve(*spline);
+            if (!curve.IsNull()) {
+                TopoDS_Vertex v0 = vertexAt(entity.points.front(), slot);
+                TopoDS_Vertex v1 = vertexAt(entity.points.back(), slot);
+                BRepBuilderAPI_MakeEdge makeEdge(curve, v0, v1,
+                                                 curve->FirstParameter(), curve->LastParameter());
+                if (makeEdge.IsDone()) out.push_back(makeEdge.Edge());
+            }
+        }
+        break;
+
+    case sketch::EntityType::Rectangle:
+    case sketch::EntityType::Parallelogram:
+        if (entity.points.size() >= 4) {
+            addPolyline({entity.points[0], entity.points[1], entity.points[2], entity.points[3]});
+        } else if (entity.type == sketch::EntityType::Rectangle && entity.points.size() >= 2) {
+            const Point2D& p1 = entity.points[0];
+            const Point2D& p3 = entity.points[1];
+            addPolyline({p1, Point2D(p3.x, p1.y), p3, Point2D(p1.x, p3.y)});
+        }
+        break;
+
+    case sketch::EntityType::Polygon:
+        if (!entity.points.empty() && entity.sides >= 3) {
+            const Point2D& center = entity.points[0];
+            std::vector<Point2D> corners;
+            for (int i = 0; i < entity.sides; ++i) {
+                double angle = 2.0 * M_PI * i / entity.sides - M_PI / 2.0;  // Start at top
+                corners.push_back(Point2D(center.x + entity.radius * std::cos(angle),
+                                          center.y + entity.radius * std::sin(angle)));
+            }
+            addPolyline(corners);
+        }
+        break;
+
+    case sketch::EntityType::Slot:
+        // Linear slot: two arc centres joined by straight sides.  Arc
+        // slots (three points) have no edge representation yet.
+        if (entity.points.size() == 2) {
+            const Point2D& c1 = entity.points[0];
+            const Point2D& c2 = entity.points[1];
+            double r = entity.radius;
+
+            Point2D dir = c2 - c1;
+            double len = std::hypot(dir.x, dir.y);
+            if (len < 1e-6 || r <= Precision::Confusion()) break;
+
+            dir = dir / len;
+            Point2D perp(-dir.y, dir.x);
+            double side = std::atan2(perp.y, perp.x) * 180.0 / M_PI;
+
+            addSegment(c1 + perp * r, c2 + perp * r);
+            addArc(c2, r, side, -180.0);
+            addSegment(c2 - perp * r, c1 - perp * r);
+            addArc(c1, r, side + 180.0, -180.0);
+        }
+        break;
+
+    case sketch::EntityType::Text:
+        // Glyph outlines; their vertices are not welded to other
+        // geometry, since glyphs never share endpoints with it
+        {
+            sketch::TextOutline outline = sketch::textOutline(entity);
+            for (const sketch::OutlineContour& contour : outline.contours) {
+                TopoDS_Wire contourWire = buildContourWire(contour);
+                for (TopExp_Explorer exp(contourWire, TopAbs_EDGE); exp.More(); exp.Next()) {
+                    out.push_back(TopoDS::Edge(exp.Current()));
+                }
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+}  // namespace brep
+}  // namespace hobbycad
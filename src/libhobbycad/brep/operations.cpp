@@ -8,6 +8,8 @@
 // =====================================================================
 
 #include <hobbycad/brep/operations.h>
+#include <hobbycad/brep/edge_cache.h>
+#include <hobbycad/geometry/utils.h>
 
 // OpenCASCADE includes
 #include <BRepGProp.hxx>
@@ -16,10 +18,14 @@
 #include <BRepBndLib.hxx>
 #include <TopExp_Explorer.hxx>
 #include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
+#include <BRep_Builder.hxx>
+#include <BRepTools.hxx>
 
 // Wire/Edge building
 #include <BRepBuilderAPI_MakeWire.hxx>
 #include <BRepBuilderAPI_MakeEdge.hxx>
+#include <BRepBuilderAPI_MakeVertex.hxx>
 #include <BRepBuilderAPI_MakeFace.hxx>
 
 // 3D operations
@@ -40,17 +46,14 @@
 #include <BRepOffsetAPI_MakeOffsetShape.hxx>
 
 // Geometry
+#include <gp.hxx>
 #include <gp_Pnt.hxx>
 #include <gp_Vec.hxx>
-#include <gp_Circ.hxx>
-#include <gp_Elips.hxx>
-#include <gp_Ax2.hxx>
-#include <GC_MakeArcOfCircle.hxx>
-#include <Geom_BSplineCurve.hxx>
+#include <gp_Pln.hxx>
+#include <gp_Trsf.hxx>
+#include <TopLoc_Location.hxx>
+#include <Geom_BezierCurve.hxx>
 #include <TColgp_Array1OfPnt.hxx>
-#include <TColStd_Array1OfReal.hxx>
-#include <TColStd_Array1OfInteger.hxx>
-#include <GeomAPI_Interpolate.hxx>
 
 // Lists for thick solid
 #include <TopTools_ListOfShape.hxx>
@@ -71,353 +74,120 @@ namespace brep {
 
 namespace {
 
-/// Find entity by ID in entity list
-const sketch::Entity* findEntity(int id, const std::vector<sketch::Entity>& entities)
-{
-    for (const sketch::Entity& e : entities) {
-        if (e.id == id) return &e;
-    }
-    return nullptr;
-}
-
-/// Convert 2D sketch point to 3D point (on XY plane at Z=0)
-gp_Pnt toPoint3D(const Point2D& p2d, double z = 0.0)
-{
-    return gp_Pnt(p2d.x, p2d.y, z);
-}
-
-/// Build an edge from a sketch entity
-/// Returns null edge if entity type not supported
-TopoDS_Edge buildEdge(const sketch::Entity& entity, bool reversed = false)
+/// Build a face from a wire
+TopoDS_Face buildFaceFromWire(const TopoDS_Wire& wire)
 {
-    TopoDS_Edge edge;
-
-    switch (entity.type) {
-    case sketch::EntityType::Line:
-        if (entity.points.size() >= 2) {
-            gp_Pnt p1 = toPoint3D(entity.points[reversed ? 1 : 0]);
-            gp_Pnt p2 = toPoint3D(entity.points[reversed ? 0 : 1]);
-            edge = BRepBuilderAPI_MakeEdge(p1, p2);
-        }
-        break;
-
-    case sketch::EntityType::Arc:
-        if (!entity.points.empty()) {
-            gp_Pnt center = toPoint3D(entity.points[0]);
-            gp_Dir zDir(0, 0, 1);
-            gp_Ax2 axis(center, zDir);
-            gp_Circ circle(axis, entity.radius);
-
-            double startRad = entity.startAngle * M_PI / 180.0;
-            double endRad = (entity.startAngle + entity.sweepAngle) * M_PI / 180.0;
-
-            if (reversed) {
-                std::swap(startRad, endRad);
-            }
-
-            BRepBuilderAPI_MakeEdge makeEdge(circle, startRad, endRad);
-            if (makeEdge.IsDone()) {
-                edge = makeEdge.Edge();
-            }
-        }
-        break;
-
-    case sketch::EntityType::Circle:
-        if (!entity.points.empty()) {
-            gp_Pnt center = toPoint3D(entity.points[0]);
-            gp_Dir zDir(0, 0, 1);
-            gp_Ax2 axis(center, zDir);
-            gp_Circ circle(axis, entity.radius);
-
-            BRepBuilderAPI_MakeEdge makeEdge(circle);
-            if (makeEdge.IsDone()) {
-                edge = makeEdge.Edge();
-            }
-        }
-        break;
-
-    case sketch::EntityType::Ellipse:
-        if (!entity.points.empty()) {
-            gp_Pnt center = toPoint3D(entity.points[0]);
-            gp_Dir zDir(0, 0, 1);
-            gp_Ax2 axis(center, zDir);
-            // gp_Elips requires major >= minor
-            double majorR = std::max(entity.majorRadius, entity.minorRadius);
-            double minorR = std::min(entity.majorRadius, entity.minorRadius);
-            gp_Elips ellipse(axis, majorR, minorR);
-
-            BRepBuilderAPI_MakeEdge makeEdge(ellipse);
-            if (makeEdge.IsDone()) {
-                edge = makeEdge.Edge();
-            }
-        }
-        break;
-
-    case sketch::EntityType::Spline:
-        if (entity.points.size() >= 2) {
-            // Build B-Spline through control points
-            int nPts = static_cast<int>(entity.points.size());
-            TColgp_Array1OfPnt pts(1, nPts);
-            for (int i = 0; i < nPts; ++i) {
-                int idx = reversed ? (nPts - 1 - i) : i;
-                pts.SetValue(i + 1, toPoint3D(entity.points[idx]));
-            }
-
-            Handle(TColgp_HArray1OfPnt) hPts = new TColgp_HArray1OfPnt(pts);
-            GeomAPI_Interpolate interp(hPts, Standard_False, 1e-6);
-            interp.Perform();
-
-            if (interp.IsDone()) {
-                Handle(Geom_BSplineCurve) curve = interp.Curve();
-                BRepBuilderAPI_MakeEdge makeEdge(curve);
-                if (makeEdge.IsDone()) {
-                    edge = makeEdge.Edge();
-                }
-            }
-        }
-        break;
-
-    case sketch::EntityType::Rectangle:
-        // Rectangle is actually 4 edges - handled specially in wire building
-        break;
-
-    case sketch::EntityType::Polygon:
-        // Polygon is multiple edges - handled specially in wire building
-        break;
-
-    case sketch::EntityType::Slot:
-        // Slot is 2 arcs + 2 lines - handled specially in wire building
-        break;
+    if (wire.IsNull()) return TopoDS_Face();
 
-    default:
-        break;
+    BRepBuilderAPI_MakeFace faceBuilder(wire, Standard_True);  // planar = true
+    if (faceBuilder.IsDone()) {
+        return faceBuilder.Face();
     }
 
-    return edge;
+    return TopoDS_Face();
 }
 
-/// Build multiple edges for rectangle entity
-std::vector<TopoDS_Edge> buildRectangleEdges(const sketch::Entity& entity, bool reversed = false)
+/// Build a face on the sketch plane bounded by a profile.  The face
+/// is made inside the wire whichever way the profile runs, so its
+/// normal is always +Z.
+TopoDS_Face buildPlanarFace(
+    const sketch::Profile& profile,
+    SketchEdgeCache& edges)
 {
-    std::vector<TopoDS_Edge> edges;
-
-    if (entity.type != sketch::EntityType::Rectangle || entity.points.size() < 2)
-        return edges;
-
-    Point2D p1 = entity.points[0];
-    Point2D p3 = entity.points[1];
-    Point2D p2(p3.x, p1.y);
-    Point2D p4(p1.x, p3.y);
-
-    std::vector<Point2D> corners = {p1, p2, p3, p4};
-    if (reversed) {
-        std::reverse(corners.begin(), corners.end());
-    }
+    TopoDS_Wire wire = edges.wire(profile);
+    if (wire.IsNull()) return TopoDS_Face();
 
-    for (int i = 0; i < 4; ++i) {
-        int j = (i + 1) % 4;
-        gp_Pnt pt1 = toPoint3D(corners[i]);
-        gp_Pnt pt2 = toPoint3D(corners[j]);
-        TopoDS_Edge edge = BRepBuilderAPI_MakeEdge(pt1, pt2);
-        edges.push_back(edge);
+    BRepBuilderAPI_MakeFace faceBuilder(gp_Pln(gp::Origin(), gp::DZ()), wire, Standard_True);
+    if (faceBuilder.IsDone()) {
+        return faceBuilder.Face();
     }
 
-    return edges;
+    return TopoDS_Face();
 }
 
-/// Build multiple edges for polygon entity
-std::vector<TopoDS_Edge> buildPolygonEdges(const sketch::Entity& entity, bool reversed = false)
+/// Build the face of a region: the outer profile with each hole as an
+/// inner wire
+TopoDS_Face buildRegionFace(
+    const sketch::ProfileRegion& region,
+    SketchEdgeCache& edges,
+    std::string& errorMessage)
 {
-    std::vector<TopoDS_Edge> edges;
-
-    if (entity.type != sketch::EntityType::Polygon || entity.points.empty())
-        return edges;
-
-    Point2D center = entity.points[0];
-    int n = entity.sides;
-    double r = entity.radius;
-
-    std::vector<Point2D> vertices;
-    for (int i = 0; i < n; ++i) {
-        double angle = 2.0 * M_PI * i / n - M_PI / 2.0;  // Start at top
-        vertices.push_back(Point2D(center.x + r * std::cos(angle),
-                                   center.y + r * std::sin(angle)));
+    TopoDS_Face outer = buildPlanarFace(region.outer, edges);
+    if (outer.IsNull()) {
+        errorMessage = "Failed to build face from profile " + std::to_string(region.outer.id);
+        return TopoDS_Face();
     }
 
-    if (reversed) {
-        std::reverse(vertices.begin(), vertices.end());
+    if (region.holes.empty()) {
+        return outer;
     }
 
-    for (int i = 0; i < n; ++i) {
-        int j = (i + 1) % n;
-        gp_Pnt pt1 = toPoint3D(vertices[i]);
-        gp_Pnt pt2 = toPoint3D(vertices[j]);
-        TopoDS_Edge edge = BRepBuilderAPI_MakeEdge(pt1, pt2);
-        edges.push_back(edge);
+    BRepBuilderAPI_MakeFace faceBuilder(outer);
+    for (const sketch::Profile& hole : region.holes) {
+        // A hole's face has the same +Z normal as the outer face, so
+        // its boundary reversed bounds the outer face from inside
+        TopoDS_Face holeFace = buildPlanarFace(hole, edges);
+        if (holeFace.IsNull()) {
+            errorMessage = "Failed to build hole from profile " + std::to_string(hole.id);
+            return TopoDS_Face();
+        }
+        faceBuilder.Add(TopoDS::Wire(BRepTools::OuterWire(holeFace).Reversed()));
     }
 
-    return edges;
-}
-
-/// Build multiple edges for slot entity
-std::vector<TopoDS_Edge> buildSlotEdges(const sketch::Entity& entity, bool reversed = false)
-{
-    std::vector<TopoDS_Edge> edges;
-
-    if (entity.type != sketch::EntityType::Slot || entity.points.size() < 2)
-        return edges;
-
-    Point2D c1 = entity.points[0];
-    Point2D c2 = entity.points[1];
-    double r = entity.radius;
-
-    // Direction from c1 to c2
-    Point2D dir = c2 - c1;
-    double len = std::sqrt(dir.x * dir.x + dir.y * dir.y);
-    if (len < 1e-6) return edges;
-
-    dir = dir / len;
-    Point2D perp(-dir.y, dir.x);
-
-    // Four key points on the slot outline
-    Point2D p1 = c1 + perp * r;
-    Point2D p2 = c2 + perp * r;
-    Point2D p3 = c2 - perp * r;
-    Point2D p4 = c1 - perp * r;
-
-    // Two straight lines and two arcs
-    // Arc angles
-    double angle1 = std::atan2(perp.y, perp.x) * 180.0 / M_PI;
-    double angle2 = angle1 + 180.0;
-
-    if (!reversed) {
-        // Line from p1 to p2
-        edges.push_back(BRepBuilderAPI_MakeEdge(toPoint3D(p1), toPoint3D(p2)));
-
-        // Arc at c2 from p2 to p3
-        gp_Ax2 axis2(toPoint3D(c2), gp_Dir(0, 0, 1));
-        gp_Circ circ2(axis2, r);
-        double start2 = angle1 * M_PI / 180.0;
-        double end2 = angle2 * M_PI / 180.0;
-        edges.push_back(BRepBuilderAPI_MakeEdge(circ2, start2, end2));
-
-        // Line from p3 to p4
-        edges.push_back(BRepBuilderAPI_MakeEdge(toPoint3D(p3), toPoint3D(p4)));
-
-        // Arc at c1 from p4 to p1
-        gp_Ax2 axis1(toPoint3D(c1), gp_Dir(0, 0, 1));
-        gp_Circ circ1(axis1, r);
-        double start1 = angle2 * M_PI / 180.0;
-        double end1 = (angle1 + 360.0) * M_PI / 180.0;
-        edges.push_back(BRepBuilderAPI_MakeEdge(circ1, start1, end1));
-    } else {
-        // Reversed order
-        gp_Ax2 axis1(toPoint3D(c1), gp_Dir(0, 0, 1));
-        gp_Circ circ1(axis1, r);
-        double start1 = (angle1 + 360.0) * M_PI / 180.0;
-        double end1 = angle2 * M_PI / 180.0;
-        edges.push_back(BRepBuilderAPI_MakeEdge(circ1, end1, start1));
-
-        edges.push_back(BRepBuilderAPI_MakeEdge(toPoint3D(p4), toPoint3D(p3)));
-
-        gp_Ax2 axis2(toPoint3D(c2), gp_Dir(0, 0, 1));
-        gp_Circ circ2(axis2, r);
-        double start2 = angle2 * M_PI / 180.0;
-        double end2 = angle1 * M_PI / 180.0;
-        edges.push_back(BRepBuilderAPI_MakeEdge(circ2, end2, start2));
-
-        edges.push_back(BRepBuilderAPI_MakeEdge(toPoint3D(p2), toPoint3D(p1)));
+    if (!faceBuilder.IsDone()) {
+        errorMessage = "Failed to add holes to profile " + std::to_string(region.outer.id);
+        return TopoDS_Face();
     }
 
-    return edges;
+    return faceBuilder.Face();
 }
 
-/// Build a wire from a profile
-TopoDS_Wire buildWireFromProfile(
-    const sketch::Profile& profile,
-    const std::vector<sketch::Entity>& entities)
+/// Sweep planar faces along a vector in one prism
+OperationResult extrudeFaces(
+    const TopoDS_Shape& faces,
+    const gp_Dir& direction,
+    double distance,
+    bool symmetric)
 {
-    BRepBuilderAPI_MakeWire wireBuilder;
+    OperationResult result;
 
-    for (size_t i = 0; i < profile.entityIds.size(); ++i) {
-        int entityId = profile.entityIds[i];
-        bool reversed = (i < profile.reversed.size()) ? profile.reversed[i] : false;
+    gp_Vec extrusionVec(direction);
+    extrusionVec.Scale(distance);
 
-        const sketch::Entity* entity = findEntity(entityId, entities);
-        if (!entity) continue;
+    try {
+        TopoDS_Shape base = faces;
+        if (symmetric) {
+            // Start half the distance back instead of fusing two prisms
+            gp_Trsf shift;
+            shift.SetTranslation(extrusionVec * -0.5);
+            base = base.Moved(TopLoc_Location(shift));
+        }
 
-        // Handle multi-edge entities
-        if (entity->type == sketch::EntityType::Rectangle) {
-            auto edges = buildRectangleEdges(*entity, reversed);
-            for (const auto& edge : edges) {
-                if (!edge.IsNull()) wireBuilder.Add(edge);
-            }
-        } else if (entity->type == sketch::EntityType::Polygon) {
-            auto edges = buildPolygonEdges(*entity, reversed);
-            for (const auto& edge : edges) {
-                if (!edge.IsNull()) wireBuilder.Add(edge);
-            }
-        } else if (entity->type == sketch::EntityType::Slot) {
-            auto edges = buildSlotEdges(*entity, reversed);
-            for (const auto& edge : edges) {
-                if (!edge.IsNull()) wireBuilder.Add(edge);
-            }
+        BRepPrimAPI_MakePrism prism(base, extrusionVec, Standard_True);  // copy = true
+        if (prism.IsDone()) {
+            result.shape = prism.Shape();
+            result.success = true;
         } else {
-            TopoDS_Edge edge = buildEdge(*entity, reversed);
-            if (!edge.IsNull()) {
-                wireBuilder.Add(edge);
-            }
+            result.errorMessage = "Extrusion operation failed";
         }
+    } catch (...) {
+        result.errorMessage = "Exception during extrusion";
     }
 
-    if (wireBuilder.IsDone()) {
-        return wireBuilder.Wire();
-    }
-
-    return TopoDS_Wire();
-}
-
-/// Build a face from a wire
-TopoDS_Face buildFaceFromWire(const TopoDS_Wire& wire)
-{
-    if (wire.IsNull()) return TopoDS_Face();
-
-    BRepBuilderAPI_MakeFace faceBuilder(wire, Standard_True);  // planar = true
-    if (faceBuilder.IsDone()) {
-        return faceBuilder.Face();
-    }
-
-    return TopoDS_Face();
+    return result;
 }
 
 /// Build a wire from a sequence of entities (for sweep path, etc.)
 TopoDS_Wire buildWireFromEntities(const std::vector<sketch::Entity>& pathEntities)
 {
+    SketchEdgeCache edges(pathEntities);
     BRepBuilderAPI_MakeWire wireBuilder;
 
     for (const sketch::Entity& entity : pathEntities) {
         if (entity.isConstruction) continue;
 
-        if (entity.type == sketch::EntityType::Rectangle) {
-            auto edges = buildRectangleEdges(entity, false);
-            for (const auto& edge : edges) {
-                if (!edge.IsNull()) wireBuilder.Add(edge);
-            }
-        } else if (entity.type == sketch::EntityType::Polygon) {
-            auto edges = buildPolygonEdges(entity, false);
-            for (const auto& edge : edges) {
-                if (!edge.IsNull()) wireBuilder.Add(edge);
-            }
-        } else if (entity.type == sketch::EntityType::Slot) {
-            auto edges = buildSlotEdges(entity, false);
-            for (const auto& edge : edges) {
-                if (!edge.IsNull()) wireBuilder.Add(edge);
-            }
-        } else {
-            TopoDS_Edge edge = buildEdge(entity, false);
-            if (!edge.IsNull()) {
-                wireBuilder.Add(edge);
-            }
+        for (const TopoDS_Edge& edge : edges.edges(entity.id)) {
+            wireBuilder.Add(edge);
         }
     }
 
@@ -443,7 +213,8 @@ OperationResult extrudeProfile(
     OperationResult result;
 
     // Build wire from profile
-    TopoDS_Wire wire = buildWireFromProfile(profile, entities);
+    SketchEdgeCache edges(entities);
+    TopoDS_Wire wire = edges.wire(profile);
     if (wire.IsNull()) {
         result.errorMessage = "Failed to build wire from profile";
         return result;
@@ -486,7 +257,8 @@ OperationResult extrudeProfileSymmetric(
     OperationResult result;
 
     // Build wire from profile
-    TopoDS_Wire wire = buildWireFromProfile(profile, entities);
+    SketchEdgeCache edges(entities);
+    TopoDS_Wire wire = edges.wire(profile);
     if (wire.IsNull()) {
         result.errorMessage = "Failed to build wire from profile";
         return result;
@@ -554,7 +326,8 @@ OperationResult revolveProfile(
     OperationResult result;
 
     // Build wire from profile
-    TopoDS_Wire wire = buildWireFromProfile(profile, entities);
+    SketchEdgeCache edges(entities);
+    TopoDS_Wire wire = edges.wire(profile);
     if (wire.IsNull()) {
         result.errorMessage = "Failed to build wire from profile";
         return result;
@@ -594,7 +367,8 @@ OperationResult sweepProfile(
     OperationResult result;
 
     // Build profile wire
-    TopoDS_Wire profileWire = buildWireFromProfile(profile, entities);
+    SketchEdgeCache edges(entities);
+    TopoDS_Wire profileWire = edges.wire(profile);
     if (profileWire.IsNull()) {
         result.errorMessage = "Failed to build profile wire";
         return result;
@@ -640,8 +414,10 @@ OperationResult loftProfiles(
         BRepOffsetAPI_ThruSections loft(solid ? Standard_True : Standard_False,
                                          Standard_False);  // ruled = false
 
+        // One cache for all sections so profiles sharing entities share edges
+        SketchEdgeCache edges(entities);
         for (const sketch::Profile& profile : profiles) {
-            TopoDS_Wire wire = buildWireFromProfile(profile, entities);
+            TopoDS_Wire wire = edges.wire(profile);
             if (wire.IsNull()) {
                 result.errorMessage = "Failed to build wire for profile";
                 return result;
@@ -663,6 +439,269 @@ OperationResult loftProfiles(
     return result;
 }
 
+// =====================================================================
+//  Region Faces
+// =====================================================================
+
+OperationResult buildRegionFaces(
+    const std::vector<sketch::ProfileRegion>& regions,
+    const std::vector<sketch::Entity>& entities)
+{
+    SketchEdgeCache edges(entities);
+    return buildRegionFaces(regions, edges);
+}
+
+OperationResult buildRegionFaces(
+    const std::vector<sketch::ProfileRegion>& regions,
+    SketchEdgeCache& edges)
+{
+    OperationResult result;
+
+    if (regions.empty()) {
+        result.errorMessage = "No regions to build";
+        return result;
+    }
+
+    try {
+        BRep_Builder builder;
+        TopoDS_Compound compound;
+        builder.MakeCompound(compound);
+
+        TopoDS_Face face;
+        for (const sketch::ProfileRegion& region : regions) {
+            face = buildRegionFace(region, edges, result.errorMessage);
+            if (face.IsNull()) {
+                return result;
+            }
+            builder.Add(compound, face);
+        }
+
+        if (regions.size() == 1) {
+            result.shape = face;
+        } else {
+            result.shape = compound;
+        }
+        result.success = true;
+    } catch (...) {
+        result.errorMessage = "Exception while building region faces";
+    }
+
+    return result;
+}
+
+OperationResult extrudeRegions(
+    const std::vector<sketch::ProfileRegion>& regions,
+    const std::vector<sketch::Entity>& entities,
+    const gp_Dir& direction,
+    double distance,
+    bool symmetric)
+{
+    SketchEdgeCache edges(entities);
+    return extrudeRegions(regions, edges, direction, distance, symmetric);
+}
+
+OperationResult extrudeRegions(
+    const std::vector<sketch::ProfileRegion>& regions,
+    SketchEdgeCache& edges,
+    const gp_Dir& direction,
+    double distance,
+    bool symmetric)
+{
+    OperationResult faces = buildRegionFaces(regions, edges);
+    if (!faces.success) {
+        return faces;
+    }
+
+    return extrudeFaces(faces.shape, direction, distance, symmetric);
+}
+
+OperationResult revolveRegions(
+    const std::vector<sketch::ProfileRegion>& regions,
+    const std::vector<sketch::Entity>& entities,
+    const gp_Ax1& axis,
+    double angleDegrees)
+{
+    SketchEdgeCache edges(entities);
+    return revolveRegions(regions, edges, axis, angleDegrees);
+}
+
+OperationResult revolveRegions(
+    const std::vector<sketch::ProfileRegion>& regions,
+    SketchEdgeCache& edges,
+    const gp_Ax1& axis,
+    double angleDegrees)
+{
+    OperationResult faces = buildRegionFaces(regions, edges);
+    if (!faces.success) {
+        return faces;
+    }
+
+    OperationResult result;
+
+    // Convert angle to radians
+    double angleRad = angleDegrees * M_PI / 180.0;
+
+    try {
+        BRepPrimAPI_MakeRevol revol(faces.shape, axis, angleRad, Standard_True);  // copy = true
+        if (revol.IsDone()) {
+            result.shape = revol.Shape();
+            result.success = true;
+        } else {
+            result.errorMessage = "Revolution operation failed";
+        }
+    } catch (...) {
+        result.errorMessage = "Exception during revolution";
+    }
+
+    return result;
+}
+
+// =====================================================================
+//  Text
+// =====================================================================
+
+TopoDS_Wire buildContourWire(const sketch::OutlineContour& contour)
+{
+    if (contour.segments.empty()) return TopoDS_Wire();
+
+    auto toPnt = [](const Point2D& p) { return gp_Pnt(p.x, p.y, 0.0); };
+
+    try {
+        // Consecutive segments share the vertex between them and the
+        // last segment ends on the first one's start vertex
+        TopoDS_Vertex first = BRepBuilderAPI_MakeVertex(toPnt(contour.segments.front().start));
+        TopoDS_Vertex current = first;
+
+        BRepBuilderAPI_MakeWire wireBuilder;
+        for (size_t i = 0; i < contour.segments.size(); ++i) {
+            const sketch::OutlineSegment& seg = contour.segments[i];
+            bool last = (i + 1 == contour.segments.size());
+            TopoDS_Vertex next = last ? first : TopoDS_Vertex(BRepBuilderAPI_MakeVertex(toPnt(seg.end)));
+
+            TopoDS_Edge edge;
+            if (seg.type == sketch::OutlineSegmentType::Line) {
+                BRepBuilderAPI_MakeEdge makeEdge(current, next);
+                if (makeEdge.IsDone()) edge = makeEdge.Edge();
+            } else {
+                bool cubic = (seg.type == sketch::OutlineSegmentType::Cubic);
+                TColgp_Array1OfPnt poles(1, cubic ? 4 : 3);
+                poles.SetValue(1, toPnt(seg.start));
+                poles.SetValue(2, toPnt(seg.control1));
+                if (cubic) poles.SetValue(3, toPnt(seg.control2));
+                poles.SetValue(poles.Upper(), toPnt(seg.end));
+
+                Handle(Geom_BezierCurve) curve = new Geom_BezierCurve(poles);
+                BRepBuilderAPI_MakeEdge makeEdge(curve, current, next);
+                if (makeEdge.IsDone()) edge = makeEdge.Edge();
+            }
+
+            if (edge.IsNull()) return TopoDS_Wire();
+            wireBuilder.Add(edge);
+            current = next;
+        }
+
+        if (wireBuilder.IsDone()) {
+            return wireBuilder.Wire();
+        }
+    } catch (...) {
+    }
+
+    return TopoDS_Wire();
+}
+
+OperationResult buildTextFaces(const sketch::TextOutline& outline)
+{
+    OperationResult result;
+
+    if (!outline.success) {
+        result.errorMessage = outline.errorMessage.empty() ? "Text has no outline" : outline.errorMessage;
+        return result;
+    }
+
+    const std::vector<sketch::OutlineContour>& contours = outline.contours;
+    if (contours.empty()) {
+        result.errorMessage = "Text has no glyph outlines";
+        return result;
+    }
+
+    try {
+        BRep_Builder builder;
+        TopoDS_Compound compound;
+        builder.MakeCompound(compound);
+
+        // Contours of a glyph are consecutive, so holes only need to be
+        // matched against the outer contours of their own glyph
+        size_t begin = 0;
+        while (begin < contours.size()) {
+            size_t end = begin;
+            while (end < contours.size() && contours[end].glyph == contours[begin].glyph) ++end;
+
+            std::vector<std::vector<Point2D>> polygons;
+            for (size_t i = begin; i < end; ++i) {
+                polygons.push_back(sketch::contourToPolygon(contours[i]));
+            }
+
+            for (size_t i = begin; i < end; ++i) {
+                if (contours[i].isHole) continue;
+
+                TopoDS_Wire outer = buildContourWire(contours[i]);
+                if (outer.IsNull()) continue;  // Degenerate contour; skip it
+
+                BRepBuilderAPI_MakeFace faceBuilder(gp_Pln(gp::Origin(), gp::DZ()), outer, Standard_True);
+                if (!faceBuilder.IsDone()) continue;
+
+                // A hole belongs to the smallest outer contour around it
+                // (an island inside a counter has a face of its own)
+                for (size_t h = begin; h < end; ++h) {
+                    if (!contours[h].isHole || polygons[h - begin].empty()) continue;
+
+                    const Point2D& probe = polygons[h - begin].front();
+                    if (!geometry::pointInPolygon(probe, polygons[i - begin])) continue;
+
+                    bool nearer = false;
+                    for (size_t j = begin; j < end && !nearer; ++j) {
+                        nearer = j != i && !contours[j].isHole &&
+                                 std::abs(contours[j].area) < std::abs(contours[i].area) &&
+                                 geometry::pointInPolygon(probe, polygons[j - begin]);
+                    }
+                    if (nearer) continue;
+
+                    // Holes run clockwise, so they bound the face from inside as is
+                    TopoDS_Wire hole = buildContourWire(contours[h]);
+                    if (!hole.IsNull()) faceBuilder.Add(hole);
+                }
+
+                if (faceBuilder.IsDone()) {
+                    builder.Add(compound, faceBuilder.Face());
+                }
+            }
+
+            begin = end;
+        }
+
+        result.shape = compound;
+        result.success = true;
+    } catch (...) {
+        result.errorMessage = "Exception while building text faces";
+    }
+
+    return result;
+}
+
+OperationResult extrudeText(
+    const sketch::TextOutline& outline,
+    const gp_Dir& direction,
+    double distance,
+    bool symmetric)
+{
+    OperationResult faces = buildTextFaces(outline);
+    if (!faces.success) {
+        return faces;
+    }
+
+    return extrudeFaces(faces.shape, direction, distance, symmetric);
+}
+
 // =====================================================================
 //  Boolean Operations
 // =====================================================================
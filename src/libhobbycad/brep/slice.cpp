@@ -0,0 +1,176 @@
+// =====================================================================
+//  src/libhobbycad/brep/slice.cpp — Multi-plane slicing of solids
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/brep/slice.h>
+#include <hobbycad/mesh/types.h>
+
+#include <BRepAdaptor_Curve.hxx>
+#include <BRepAlgoAPI_Section.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRep_Tool.hxx>
+#include <Bnd_Box.hxx>
+#include <GCPnts_TangentialDeflection.hxx>
+#include <IMeshTools_Parameters.hxx>
+#include <OSD_Parallel.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <gp_Pln.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+
+namespace hobbycad {
+namespace brep {
+
+namespace {
+
+/// Default deflection as a fraction of the bounding-box diagonal
+constexpr double kRelativeDeflection = 1e-3;
+
+/// Angular deflection for section curves and slice meshes (radians)
+constexpr double kAngularDeflection = 0.3;
+
+/// Section edges of one plane as polylines in plane coordinates.
+/// Runs non-destructively so planes can share the input across threads.
+bool sectionPieces(const TopoDS_Shape& shape, const gp_Pln& plane, double deflection,
+                   const mesh::MeshPoint& xDir, const mesh::MeshPoint& yDir,
+                   std::vector<std::vector<Point2D>>& pieces)
+{
+    BRepAlgoAPI_Section section(shape, plane, Standard_False);
+    section.SetNonDestructive(Standard_True);
+    section.SetRunParallel(Standard_False);
+    section.Approximation(Standard_True);
+    section.Build();
+    if (!section.IsDone()) return false;
+
+    for (TopExp_Explorer exp(section.Shape(), TopAbs_EDGE); exp.More(); exp.Next()) {
+        const TopoDS_Edge& edge = TopoDS::Edge(exp.Current());
+        if (BRep_Tool::Degenerated(edge)) continue;
+        BRepAdaptor_Curve curve(edge);
+        GCPnts_TangentialDeflection points(curve, kAngularDeflection, deflection);
+        if (points.NbPoints() < 2) continue;
+        std::vector<Point2D> piece;
+        piece.reserve(points.NbPoints());
+        for (int k = 1; k <= points.NbPoints(); ++k) {
+            const gp_Pnt p = points.Value(k);
+            const mesh::MeshPoint q(p.X(), p.Y(), p.Z());
+            piece.emplace_back(q.dot(xDir), q.dot(yDir));
+        }
+        pieces.push_back(std::move(piece));
+    }
+    return true;
+}
+
+}  // anonymous namespace
+
+SliceResult sliceShape(const TopoDS_Shape& shape, const mesh::SlicePlanes& planes,
+                       const SliceOptions& options)
+{
+    const auto start = std::chrono::steady_clock::now();
+    SliceResult result;
+
+    if (shape.IsNull()) {
+        result.errorMessage = "Shape is empty";
+        return result;
+    }
+    const double normalLength = planes.normal.length();
+    if (normalLength <= 0.0) {
+        result.errorMessage = "Slice normal has zero length";
+        return result;
+    }
+
+    Bnd_Box box;
+    BRepBndLib::Add(shape, box);
+    if (box.IsVoid()) {
+        result.errorMessage = "Shape has no geometry";
+        return result;
+    }
+    const double deflection = options.deflection > 0.0
+        ? options.deflection
+        : kRelativeDeflection * std::sqrt(box.SquareExtent());
+
+    const int planeCount = static_cast<int>(planes.offsets.size());
+    result.layers.resize(planeCount);
+    for (int i = 0; i < planeCount; ++i) result.layers[i].offset = planes.offsets[i];
+
+    if (options.method == SliceMethod::Mesh) {
+        try {
+            IMeshTools_Parameters params;
+            params.Deflection = deflection;
+            params.Angle = kAngularDeflection;
+            params.InParallel = options.parallel ? Standard_True : Standard_False;
+            BRepMesh_IncrementalMesh mesher(shape, params);
+            if (!mesher.IsDone()) {
+                result.errorMessage = "Failed to mesh shape";
+                return result;
+            }
+        } catch (...) {
+            result.errorMessage = "Exception while meshing shape";
+            return result;
+        }
+
+        // Section points lie on the tessellation, up to the deflection
+        // away from the true curves
+        sketch::ContourFitOptions fit = options.fit;
+        fit.tolerance = std::max(fit.tolerance, deflection);
+
+        const auto sections = mesh::sliceMesh(mesh::fromShape(shape), planes, options.parallel);
+        // Each task writes only its own layer
+        OSD_Parallel::For(0, planeCount, [&](int i) {
+            result.layers[i].contours = sketch::buildContours(sections[i].loops,
+                                                              sections[i].chains, fit);
+        }, !options.parallel);
+    } else {
+        const mesh::MeshPoint n = planes.normal * (1.0 / normalLength);
+        mesh::MeshPoint xDir, yDir;
+        mesh::planeAxes(n, xDir, yDir);
+        const gp_Dir dir(n.x, n.y, n.z);
+
+        std::vector<char> failed(planeCount, 0);
+        // Each task writes only its own layer
+        OSD_Parallel::For(0, planeCount, [&](int i) {
+            const mesh::MeshPoint at = planes.origin + n * planes.offsets[i];
+            std::vector<std::vector<Point2D>> pieces;
+            try {
+                if (!sectionPieces(shape, gp_Pln(gp_Pnt(at.x, at.y, at.z), dir), deflection,
+                                   xDir, yDir, pieces)) {
+                    failed[i] = 1;
+                    return;
+                }
+            } catch (...) {
+                failed[i] = 1;
+                return;
+            }
+            result.layers[i].contours = sketch::buildContours({}, pieces, options.fit);
+        }, !options.parallel);
+
+        const auto bad = std::find(failed.begin(), failed.end(), 1);
+        if (bad != failed.end()) {
+            result.errorMessage = "Section failed at offset " +
+                std::to_string(planes.offsets[bad - failed.begin()]);
+            result.layers.clear();
+            return result;
+        }
+    }
+
+    for (const SliceLayer& layer : result.layers)
+        for (const sketch::Contour& c : layer.contours)
+            if (!c.closed) ++result.openContours;
+
+    result.success = true;
+    result.milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+}  // namespace brep
+}  // namespace hobbycad
@@ -32,6 +32,12 @@ void Document::addShape(const TopoDS_Shape& shape)
     m_modified = true;
 }
 
+void Document::setShapes(const std::vector<TopoDS_Shape>& shapes)
+{
+    m_shapes = shapes;
+    m_modified = true;
+}
+
 void Document::clear()
 {
     m_shapes.clear();
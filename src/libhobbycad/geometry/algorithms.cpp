@@ -3,6 +3,7 @@
 // =====================================================================
 
 #include <hobbycad/geometry/algorithms.h>
+#include <hobbycad/geometry/scratch.h>
 #include <hobbycad/geometry/utils.h>
 
 #include <algorithm>
@@ -23,14 +24,13 @@ namespace geometry {
 //  Convex Hull - Andrew's Monotone Chain Algorithm
 // =====================================================================
 
-std::vector<Point2D> convexHull(const std::vector<Point2D>& points)
-{
-    if (points.size() < 3) {
-        return points;
-    }
+namespace {
 
+// Sorts the scratch copy of the input in place and writes the hull
+// (or the deduplicated points, if fewer than three remain) to hull
+void monotoneChain(ScratchVector<Point2D>& sorted, std::vector<Point2D>& hull)
+{
     // Sort points lexicographically
-    std::vector<Point2D> sorted = points;
     std::sort(sorted.begin(), sorted.end(), [](const Point2D& a, const Point2D& b) {
         return a.x < b.x || (a.x == b.x && a.y < b.y);
     });
@@ -42,10 +42,11 @@ std::vector<Point2D> convexHull(const std::vector<Point2D>& points)
         }), sorted.end());
 
     if (sorted.size() < 3) {
-        return sorted;
+        hull.assign(sorted.begin(), sorted.end());
+        return;
     }
 
-    std::vector<Point2D> hull;
+    hull.clear();
     hull.reserve(sorted.size() * 2);
 
     // Build lower hull
@@ -71,6 +72,20 @@ std::vector<Point2D> convexHull(const std::vector<Point2D>& points)
     }
 
     hull.pop_back();  // Remove duplicate of first point
+}
+
+}  // anonymous namespace
+
+std::vector<Point2D> convexHull(const std::vector<Point2D>& points)
+{
+    if (points.size() < 3) {
+        return points;
+    }
+
+    ScratchArena arena;
+    ScratchVector<Point2D> sorted(points.begin(), points.end(), arena.resource());
+    std::vector<Point2D> hull;
+    monotoneChain(sorted, hull);
     return hull;
 }
 
@@ -121,11 +136,12 @@ double perpendicularDistance(const Point2D& point, const Point2D& lineStart, con
     return length(point - projection);
 }
 
+template<typename Points, typename Keep>
 void douglasPeuckerRecursive(
-    const std::vector<Point2D>& points,
+    const Points& points,
     int start, int end,
     double epsilon,
-    std::vector<bool>& keep)
+    Keep& keep)
 {
     double maxDist = 0;
     int maxIdx = start;
@@ -152,7 +168,8 @@ std::vector<Point2D> simplifyPolyline(const std::vector<Point2D>& points, double
     if (points.size() < 3) return points;
     if (epsilon <= 0) return points;
 
-    std::vector<bool> keep(points.size(), false);
+    ScratchArena arena;
+    ScratchVector<bool> keep(points.size(), false, arena.resource());
     keep[0] = true;
     keep[points.size() - 1] = true;
 
@@ -172,12 +189,13 @@ std::vector<Point2D> simplifyPolygon(const std::vector<Point2D>& polygon, double
 
     // For polygon, we need to handle the wrap-around
     // Double the polygon, simplify, then take the relevant portion
-    std::vector<Point2D> doubled;
+    ScratchArena arena;
+    ScratchVector<Point2D> doubled(arena.resource());
     doubled.reserve(polygon.size() * 2);
     doubled.insert(doubled.end(), polygon.begin(), polygon.end());
     doubled.insert(doubled.end(), polygon.begin(), polygon.end());
 
-    std::vector<bool> keep(doubled.size(), false);
+    ScratchVector<bool> keep(doubled.size(), false, arena.resource());
 
     // Find the point farthest from opposite point to use as anchor
     int anchor = 0;
@@ -492,13 +510,14 @@ BoundingBox obbToAABB(const OrientedBoundingBox& obb)
 namespace {
 
 // Sutherland-Hodgman polygon clipping (for convex clipping polygons)
-std::vector<Point2D> clipPolygonByEdge(
-    const std::vector<Point2D>& polygon,
-    const Point2D& edgeStart, const Point2D& edgeEnd)
+void clipPolygonByEdge(
+    const ScratchVector<Point2D>& polygon,
+    const Point2D& edgeStart, const Point2D& edgeEnd,
+    ScratchVector<Point2D>& output)
 {
-    if (polygon.empty()) return {};
+    output.clear();
+    if (polygon.empty()) return;
 
-    std::vector<Point2D> output;
     Point2D edgeDir = edgeEnd - edgeStart;
 
     auto inside = [&](const Point2D& p) {
@@ -529,8 +548,31 @@ std::vector<Point2D> clipPolygonByEdge(
             output.push_back(intersect(current, next));
         }
     }
+}
 
-    return output;
+// Clip a polygon against each edge of a convex clipping polygon in
+// turn, reversing the edges to keep the part outside the clipper.
+// Stops early and returns an empty result once nothing is left.
+void clipPolygon(
+    const std::vector<Point2D>& subject,
+    const std::vector<Point2D>& clipper,
+    bool keepOutside,
+    ScratchVector<Point2D>& clipped)
+{
+    clipped.assign(subject.begin(), subject.end());
+    ScratchVector<Point2D> next(clipped.get_allocator());
+    for (size_t i = 0; i < clipper.size(); ++i) {
+        const Point2D& a = clipper[i];
+        const Point2D& b = clipper[(i + 1) % clipper.size()];
+        next.reserve(clipped.size() + 1);
+        if (keepOutside) {
+            clipPolygonByEdge(clipped, b, a, next);
+        } else {
+            clipPolygonByEdge(clipped, a, b, next);
+        }
+        clipped.swap(next);
+        if (clipped.empty()) return;
+    }
 }
 
 // Find all intersection points between two polygon edges
@@ -543,11 +585,12 @@ struct EdgeIntersection {
     bool entering;  // True if entering poly2 from outside
 };
 
-std::vector<EdgeIntersection> findPolygonIntersections(
+void findPolygonIntersections(
     const std::vector<Point2D>& poly1,
-    const std::vector<Point2D>& poly2)
+    const std::vector<Point2D>& poly2,
+    ScratchVector<EdgeIntersection>& intersections)
 {
-    std::vector<EdgeIntersection> intersections;
+    intersections.clear();
 
     for (size_t i = 0; i < poly1.size(); ++i) {
         const Point2D& a1 = poly1[i];
@@ -577,21 +620,20 @@ std::vector<EdgeIntersection> findPolygonIntersections(
             }
         }
     }
-
-    return intersections;
 }
 
 // Build result polygon by walking edges (Weiler-Atherton style)
-std::vector<Point2D> walkPolygonBoundary(
+void walkPolygonBoundary(
     const std::vector<Point2D>& poly1,
     const std::vector<Point2D>& poly2,
-    const std::vector<EdgeIntersection>& intersections,
-    bool walkInside)  // true for intersection, false for union exterior
+    const ScratchVector<EdgeIntersection>& intersections,
+    bool walkInside,  // true for intersection, false for union exterior
+    ScratchVector<Point2D>& result)
 {
-    if (intersections.empty()) return {};
+    result.clear();
+    if (intersections.empty()) return;
 
-    std::vector<Point2D> result;
-    std::vector<bool> visited(intersections.size(), false);
+    ScratchVector<bool> visited(intersections.size(), false, result.get_allocator());
 
     // Find first unvisited entering intersection
     int startIdx = -1;
@@ -601,7 +643,7 @@ std::vector<Point2D> walkPolygonBoundary(
             break;
         }
     }
-    if (startIdx < 0) return {};
+    if (startIdx < 0) return;
 
     int currentIdx = startIdx;
     bool onPoly1 = true;
@@ -663,8 +705,6 @@ std::vector<Point2D> walkPolygonBoundary(
         onPoly1 = !onPoly1;
 
     } while (currentIdx != startIdx && result.size() < 1000);
-
-    return result;
 }
 
 }  // anonymous namespace
@@ -708,20 +748,16 @@ BooleanResult polygonIntersection(const std::vector<Point2D>& poly1, const std::
         return result;
     }
 
-    // Use Sutherland-Hodgman clipping
-    std::vector<Point2D> clipped = poly1;
-    for (size_t i = 0; i < poly2.size(); ++i) {
-        clipped = clipPolygonByEdge(clipped, poly2[i], poly2[(i + 1) % poly2.size()]);
-        if (clipped.empty()) {
-            result.success = true;  // No intersection is a valid result
-            return result;
-        }
-    }
+    // Use Sutherland-Hodgman clipping (an empty result is a valid
+    // result: the polygons do not overlap)
+    ScratchArena arena;
+    ScratchVector<Point2D> clipped(arena.resource());
+    clipPolygon(poly1, poly2, false, clipped);
 
     if (clipped.size() >= 3) {
         PolygonWithHoles pwh;
-        pwh.outer = clipped;
-        result.polygons.push_back(pwh);
+        pwh.outer.assign(clipped.begin(), clipped.end());
+        result.polygons.push_back(std::move(pwh));
     }
 
     result.success = true;
@@ -768,7 +804,9 @@ BooleanResult polygonUnion(const std::vector<Point2D>& poly1, const std::vector<
     }
 
     // Find intersections
-    auto intersections = findPolygonIntersections(poly1, poly2);
+    ScratchArena arena;
+    ScratchVector<EdgeIntersection> intersections(arena.resource());
+    findPolygonIntersections(poly1, poly2, intersections);
 
     if (intersections.empty()) {
         // No intersections and no containment - disjoint polygons
@@ -782,21 +820,23 @@ BooleanResult polygonUnion(const std::vector<Point2D>& poly1, const std::vector<
     }
 
     // Build union boundary
-    std::vector<Point2D> unionBoundary = walkPolygonBoundary(poly1, poly2, intersections, false);
+    ScratchVector<Point2D> unionBoundary(arena.resource());
+    walkPolygonBoundary(poly1, poly2, intersections, false, unionBoundary);
 
     if (unionBoundary.size() >= 3) {
         PolygonWithHoles pwh;
-        pwh.outer = unionBoundary;
-        result.polygons.push_back(pwh);
+        pwh.outer.assign(unionBoundary.begin(), unionBoundary.end());
+        result.polygons.push_back(std::move(pwh));
         result.success = true;
     } else {
         // Fallback: return convex hull of both polygons
-        std::vector<Point2D> allPoints;
+        ScratchVector<Point2D> allPoints(arena.resource());
+        allPoints.reserve(poly1.size() + poly2.size());
         allPoints.insert(allPoints.end(), poly1.begin(), poly1.end());
         allPoints.insert(allPoints.end(), poly2.begin(), poly2.end());
         PolygonWithHoles pwh;
-        pwh.outer = convexHull(allPoints);
-        result.polygons.push_back(pwh);
+        monotoneChain(allPoints, pwh.outer);
+        result.polygons.push_back(std::move(pwh));
         result.success = true;
     }
 
@@ -820,7 +860,9 @@ BooleanResult polygonDifference(const std::vector<Point2D>& poly1, const std::ve
         }
     }
     // Also check if any poly2 edges intersect poly1
-    auto intersections = findPolygonIntersections(poly1, poly2);
+    ScratchArena arena;
+    ScratchVector<EdgeIntersection> intersections(arena.resource());
+    findPolygonIntersections(poly1, poly2, intersections);
 
     if (!anyPoly2InPoly1 && intersections.empty()) {
         // poly2 is completely outside - return poly1 unchanged
@@ -868,22 +910,15 @@ BooleanResult polygonDifference(const std::vector<Point2D>& poly1, const std::ve
     }
 
     // Complex case: use clipping
-    // Clip poly1 by the exterior of poly2 (reverse each edge of poly2)
-    std::vector<Point2D> clipped = poly1;
-    for (size_t i = 0; i < poly2.size(); ++i) {
-        // Clip by reversed edge (exterior of poly2)
-        clipped = clipPolygonByEdge(clipped,
-            poly2[(i + 1) % poly2.size()], poly2[i]);
-        if (clipped.empty()) {
-            result.success = true;  // poly1 fully consumed
-            return result;
-        }
-    }
+    // Clip poly1 by the exterior of poly2 (reverse each edge of poly2);
+    // an empty result means poly1 was fully consumed
+    ScratchVector<Point2D> clipped(arena.resource());
+    clipPolygon(poly1, poly2, true, clipped);
 
     if (clipped.size() >= 3) {
         PolygonWithHoles pwh;
-        pwh.outer = clipped;
-        result.polygons.push_back(pwh);
+        pwh.outer.assign(clipped.begin(), clipped.end());
+        result.polygons.push_back(std::move(pwh));
     }
     result.success = true;
     return result;
@@ -922,7 +957,8 @@ std::vector<std::vector<Point2D>> offsetPolygon(
         return {polygon};
     }
 
-    std::vector<Point2D> result;
+    ScratchArena arena;
+    ScratchVector<Point2D> result(arena.resource());
     result.reserve(polygon.size() * (joinType == 1 ? 8 : 1));
 
     for (size_t i = 0; i < polygon.size(); ++i) {
@@ -978,7 +1014,9 @@ std::vector<std::vector<Point2D>> offsetPolygon(
         }
     }
 
-    return {result};
+    std::vector<std::vector<Point2D>> offset(1);
+    offset[0].assign(result.begin(), result.end());
+    return offset;
 }
 
 std::vector<std::vector<Point2D>> offsetPolyline(
@@ -990,7 +1028,8 @@ std::vector<std::vector<Point2D>> offsetPolyline(
     if (polyline.size() < 2) return {};
 
     // Create closed polygon by going forward on left side, backward on right
-    std::vector<Point2D> closed;
+    std::vector<std::vector<Point2D>> result(1);
+    std::vector<Point2D>& closed = result[0];
 
     // Left side (forward)
     for (size_t i = 0; i < polyline.size() - 1; ++i) {
@@ -1041,7 +1080,7 @@ std::vector<std::vector<Point2D>> offsetPolyline(
         closed.push_back(polyline[0] + firstNormal * distance - firstDir * std::abs(distance));
     }
 
-    return {closed};
+    return result;
 }
 
 // =====================================================================
@@ -1050,7 +1089,8 @@ std::vector<std::vector<Point2D>> offsetPolyline(
 
 namespace {
 
-bool isEar(const std::vector<Point2D>& polygon, int i, const std::vector<bool>& removed)
+template<typename Points, typename Removed>
+bool isEar(const Points& polygon, int i, const Removed& removed)
 {
     int n = polygon.size();
 
@@ -1095,12 +1135,13 @@ std::vector<Triangle> triangulatePolygon(const std::vector<Point2D>& polygon)
     if (polygon.size() < 3) return triangles;
 
     // Ensure CCW winding
-    std::vector<Point2D> poly = polygon;
-    if (!polygonIsCCW(poly)) {
+    ScratchArena arena;
+    ScratchVector<Point2D> poly(polygon.begin(), polygon.end(), arena.resource());
+    if (!polygonIsCCW(polygon)) {
         std::reverse(poly.begin(), poly.end());
     }
 
-    std::vector<bool> removed(poly.size(), false);
+    ScratchVector<bool> removed(poly.size(), false, arena.resource());
     int remaining = poly.size();
 
     while (remaining > 3) {
@@ -1126,11 +1167,14 @@ std::vector<Triangle> triangulatePolygon(const std::vector<Point2D>& polygon)
 
     // Add final triangle
     if (remaining == 3) {
-        std::vector<int> indices;
+        int indices[3];
+        int count = 0;
         for (size_t i = 0; i < poly.size(); ++i) {
-            if (!removed[i]) indices.push_back(i);
+            if (removed[i]) continue;
+            if (count < 3) indices[count] = i;
+            ++count;
         }
-        if (indices.size() == 3) {
+        if (count == 3) {
             triangles.push_back({indices[0], indices[1], indices[2]});
         }
     }
@@ -1150,27 +1194,20 @@ std::pair<std::vector<Point2D>, std::vector<Triangle>> triangulatePolygonWithHol
     // Algorithm: For each hole, find the rightmost point, then find a visible
     // point on the outer boundary or another hole, and insert a bridge (two edges)
 
-    std::vector<Point2D> combined;
-    combined.reserve(outer.size() + holes.size() * 2);
-
-    // Ensure outer is CCW
-    std::vector<Point2D> outerCCW = outer;
-    if (!polygonIsCCW(outerCCW)) {
-        std::reverse(outerCCW.begin(), outerCCW.end());
-    }
+    ScratchArena arena;
 
     // Ensure holes are CW (so when combined they work correctly)
-    std::vector<std::vector<Point2D>> holesCW;
+    ScratchVector<ScratchVector<Point2D>> holesCW(arena.resource());
+    holesCW.reserve(holes.size());
     for (const auto& hole : holes) {
-        std::vector<Point2D> h = hole;
-        if (polygonIsCCW(h)) {
-            std::reverse(h.begin(), h.end());
+        holesCW.emplace_back(hole.begin(), hole.end());
+        if (polygonIsCCW(hole)) {
+            std::reverse(holesCW.back().begin(), holesCW.back().end());
         }
-        holesCW.push_back(h);
     }
 
     // Sort holes by rightmost x-coordinate (process right to left)
-    std::vector<int> holeOrder(holesCW.size());
+    ScratchVector<int> holeOrder(holesCW.size(), 0, arena.resource());
     for (size_t i = 0; i < holesCW.size(); ++i) holeOrder[i] = i;
     std::sort(holeOrder.begin(), holeOrder.end(), [&](int a, int b) {
         double maxXa = std::numeric_limits<double>::lowest();
@@ -1180,12 +1217,22 @@ std::pair<std::vector<Point2D>, std::vector<Triangle>> triangulatePolygonWithHol
         return maxXa > maxXb;
     });
 
-    // Start with outer boundary
-    combined = outerCCW;
+    // Start with outer boundary, made CCW
+    size_t totalSize = outer.size();
+    for (const auto& hole : holes) totalSize += hole.size() + 2;
+
+    ScratchVector<Point2D> combined(arena.resource());
+    combined.reserve(totalSize);
+    combined.assign(outer.begin(), outer.end());
+    if (!polygonIsCCW(outer)) {
+        std::reverse(combined.begin(), combined.end());
+    }
+    ScratchVector<Point2D> newCombined(arena.resource());
+    newCombined.reserve(totalSize);
 
     // Insert each hole with a bridge
     for (int hi : holeOrder) {
-        const std::vector<Point2D>& hole = holesCW[hi];
+        const ScratchVector<Point2D>& hole = holesCW[hi];
         if (hole.empty()) continue;
 
         // Find rightmost point of hole
@@ -1236,8 +1283,7 @@ std::pair<std::vector<Point2D>, std::vector<Triangle>> triangulatePolygonWithHol
 
         // Insert hole into combined polygon at bestIdx
         // The bridge goes from combined[bestIdx] to hole[rightmostIdx] and back
-        std::vector<Point2D> newCombined;
-        newCombined.reserve(combined.size() + hole.size() + 2);
+        newCombined.clear();
 
         for (int i = 0; i <= bestIdx; ++i) {
             newCombined.push_back(combined[i]);
@@ -1256,13 +1302,14 @@ std::pair<std::vector<Point2D>, std::vector<Triangle>> triangulatePolygonWithHol
             newCombined.push_back(combined[i]);
         }
 
-        combined = newCombined;
+        combined.swap(newCombined);
     }
 
     // Now triangulate the combined polygon
-    std::vector<Triangle> triangles = triangulatePolygon(combined);
-
-    return {combined, triangles};
+    std::pair<std::vector<Point2D>, std::vector<Triangle>> result;
+    result.first.assign(combined.begin(), combined.end());
+    result.second = triangulatePolygon(result.first);
+    return result;
 }
 
 // =====================================================================
@@ -1323,15 +1370,20 @@ std::vector<Triangle> delaunayTriangulation(const std::vector<Point2D>& points)
     double midY = (bb.minY + bb.maxY) / 2;
 
     // Super-triangle vertices (indices -3, -2, -1 conceptually, stored at end)
-    std::vector<Point2D> allPoints = points;
+    ScratchArena arena;
+    ScratchVector<Point2D> allPoints(arena.resource());
+    allPoints.reserve(points.size() + 3);
+    allPoints.assign(points.begin(), points.end());
     int superIdx = allPoints.size();
     allPoints.push_back(Point2D(midX - dmax, midY - dmax));      // super vertex 0
     allPoints.push_back(Point2D(midX, midY + dmax * 2));          // super vertex 1
     allPoints.push_back(Point2D(midX + dmax * 2, midY - dmax));  // super vertex 2
 
-    std::vector<DelaunayTriangle> triangles;
+    ScratchVector<DelaunayTriangle> triangles(arena.resource());
     triangles.push_back({{superIdx, superIdx + 1, superIdx + 2}, false});
 
+    ScratchVector<Edge> polygon(arena.resource());
+
     // Insert points one at a time
     for (size_t pi = 0; pi < points.size(); ++pi) {
         const Point2D& p = points[pi];
@@ -1345,7 +1397,7 @@ std::vector<Triangle> delaunayTriangulation(const std::vector<Point2D>& points)
         }
 
         // Find boundary of polygonal hole (edges of bad triangles not shared)
-        std::vector<Edge> polygon;
+        polygon.clear();
         for (size_t i = 0; i < triangles.size(); ++i) {
             if (!triangles[i].bad) continue;
 
@@ -1450,7 +1502,8 @@ std::vector<std::vector<Point2D>> voronoiDiagram(
     std::vector<std::vector<Point2D>> cells(points.size());
 
     // Compute circumcenters
-    std::vector<Point2D> circumcenters;
+    ScratchArena arena;
+    ScratchVector<Point2D> circumcenters(arena.resource());
     circumcenters.reserve(delaunay.size());
 
     for (const Triangle& tri : delaunay) {
@@ -1476,8 +1529,9 @@ std::vector<std::vector<Point2D>> voronoiDiagram(
     }
 
     // For each point, find its Voronoi cell
+    ScratchVector<Point2D> cellPoints(arena.resource());
     for (size_t pi = 0; pi < points.size(); ++pi) {
-        std::vector<Point2D> cellPoints;
+        cellPoints.clear();
 
         // Find all triangles containing this point
         for (size_t ti = 0; ti < delaunay.size(); ++ti) {
@@ -1498,7 +1552,7 @@ std::vector<std::vector<Point2D>> voronoiDiagram(
                        std::atan2(b.y - centroid.y, b.x - centroid.x);
             });
 
-            cells[pi] = cellPoints;
+            cells[pi].assign(cellPoints.begin(), cellPoints.end());
         }
     }
 
@@ -1634,10 +1688,12 @@ std::vector<Point2D> smoothPolyline(const std::vector<Point2D>& points, int iter
 {
     if (points.size() < 3 || iterations <= 0) return points;
 
-    std::vector<Point2D> result = points;
+    ScratchArena arena;
+    ScratchVector<Point2D> result(points.begin(), points.end(), arena.resource());
+    ScratchVector<Point2D> newPoints(arena.resource());
 
     for (int iter = 0; iter < iterations; ++iter) {
-        std::vector<Point2D> newPoints;
+        newPoints.clear();
         newPoints.reserve(result.size() * 2);
 
         for (size_t i = 0; i < result.size() - 1; ++i) {
@@ -1647,10 +1703,10 @@ std::vector<Point2D> smoothPolyline(const std::vector<Point2D>& points, int iter
             newPoints.push_back(r);
         }
 
-        result = newPoints;
+        result.swap(newPoints);
     }
 
-    return result;
+    return std::vector<Point2D>(result.begin(), result.end());
 }
 
 // =====================================================================
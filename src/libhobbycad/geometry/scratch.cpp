@@ -0,0 +1,230 @@
+// =====================================================================
+//  src/libhobbycad/geometry/scratch.cpp — Scratch arenas
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/geometry/scratch.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace hobbycad {
+namespace geometry {
+
+#if HOBBYCAD_SCRATCH_PMR
+
+namespace {
+
+/// Size of the first buffer block; later blocks double
+constexpr std::size_t kFirstBlockBytes = 64 * 1024;
+
+/// Blocks a thread keeps, up to and including the one that reaches
+/// this size, once its outermost arena closes
+constexpr std::size_t kRetainBytes = 1024 * 1024;
+
+struct Block {
+    char* data = nullptr;
+    std::size_t size = 0;
+};
+
+/// Blocks owned by one thread.  Allocation bumps offset within
+/// blocks[block] and moves on to the next block when it is full.
+struct ThreadBuffer {
+    std::vector<Block> blocks;
+    std::size_t block = 0;
+    std::size_t offset = 0;
+    ScratchArena* innermost = nullptr;
+    bool bypass = false;                ///< setScratchBypass()
+
+    std::size_t peakUsed = 0;
+    std::size_t heapAllocations = 0;
+
+    ~ThreadBuffer()
+    {
+        for (const Block& b : blocks) {
+            ::operator delete(b.data);
+        }
+    }
+
+    std::size_t used() const
+    {
+        std::size_t bytes = offset;
+        for (std::size_t i = 0; i < block && i < blocks.size(); ++i) {
+            bytes += blocks[i].size;
+        }
+        return bytes;
+    }
+
+    std::size_t reserved() const
+    {
+        std::size_t bytes = 0;
+        for (const Block& b : blocks) {
+            bytes += b.size;
+        }
+        return bytes;
+    }
+
+    void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+        for (;;) {
+            if (block < blocks.size()) {
+                const Block& b = blocks[block];
+                std::uintptr_t base = reinterpret_cast<std::uintptr_t>(b.data);
+                std::uintptr_t p = (base + offset + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+                if (p + bytes <= base + b.size) {
+                    offset = static_cast<std::size_t>(p + bytes - base);
+                    peakUsed = std::max(peakUsed, used());
+                    return reinterpret_cast<void*>(p);
+                }
+                // Leave the tail of this block unused
+                ++block;
+                offset = 0;
+                continue;
+            }
+
+            std::size_t size = blocks.empty() ? kFirstBlockBytes : blocks.back().size * 2;
+            size = std::max(size, bytes + alignment);
+            Block b;
+            b.data = static_cast<char*>(::operator new(size));
+            b.size = size;
+            blocks.push_back(b);
+            ++heapAllocations;
+        }
+    }
+
+    /// Give back the most recent allocation (the usual case when a
+    /// vector grows); anything else is reclaimed by the arena rewind
+    void deallocate(void* p, std::size_t bytes)
+    {
+        if (block >= blocks.size()) return;
+        const Block& b = blocks[block];
+        char* top = b.data + offset;
+        if (static_cast<char*>(p) + bytes == top && static_cast<char*>(p) >= b.data) {
+            offset = static_cast<std::size_t>(static_cast<char*>(p) - b.data);
+        }
+    }
+
+    /// Free blocks beyond the retained size once no arena is open
+    void trim()
+    {
+        std::size_t kept = 0;
+        std::size_t keep = 0;
+        while (keep < blocks.size() && kept < kRetainBytes) {
+            kept += blocks[keep].size;
+            ++keep;
+        }
+        for (std::size_t i = keep; i < blocks.size(); ++i) {
+            ::operator delete(blocks[i].data);
+        }
+        blocks.resize(keep);
+    }
+};
+
+thread_local ThreadBuffer t_buffer;
+
+}  // anonymous namespace
+
+/// Heap allocation made while a nested arena was open.  It cannot come
+/// from the thread buffer because the nested arena would rewind over
+/// it, so it is kept on a list and freed with its own arena.
+struct ScratchArena::Overflow {
+    Overflow* next;
+    void* data;
+    std::size_t bytes;
+    std::size_t alignment;
+};
+
+ScratchArena::ScratchArena()
+{
+    ThreadBuffer& buf = t_buffer;
+    m_parent = buf.innermost;
+    m_block = buf.block;
+    m_offset = buf.offset;
+    m_bypass = buf.bypass;
+    buf.innermost = this;
+}
+
+ScratchArena::~ScratchArena()
+{
+    ThreadBuffer& buf = t_buffer;
+    buf.block = m_block;
+    buf.offset = m_offset;
+    buf.innermost = m_parent;
+
+    while (m_overflow) {
+        Overflow* next = m_overflow->next;
+        std::pmr::new_delete_resource()->deallocate(
+            m_overflow->data, m_overflow->bytes, m_overflow->alignment);
+        delete m_overflow;
+        m_overflow = next;
+    }
+
+    if (!m_parent) {
+        buf.trim();
+    }
+}
+
+void* ScratchArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    ThreadBuffer& buf = t_buffer;
+    if (buf.innermost == this && !m_bypass) {
+        return buf.allocate(bytes, alignment);
+    }
+
+    void* data = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    m_overflow = new Overflow{m_overflow, data, bytes, alignment};
+    ++buf.heapAllocations;
+    return data;
+}
+
+void ScratchArena::do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+{
+    (void)alignment;
+    ThreadBuffer& buf = t_buffer;
+    if (buf.innermost == this && !m_bypass) {
+        buf.deallocate(p, bytes);
+    }
+}
+
+bool ScratchArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+ScratchStats scratchStats()
+{
+    const ThreadBuffer& buf = t_buffer;
+    ScratchStats stats;
+    stats.reservedBytes = buf.reserved();
+    stats.usedBytes = buf.used();
+    stats.peakUsedBytes = buf.peakUsed;
+    stats.bufferAllocations = buf.heapAllocations;
+    return stats;
+}
+
+void setScratchBypass(bool bypass)
+{
+    t_buffer.bypass = bypass;
+}
+
+#else
+
+ScratchStats scratchStats()
+{
+    return ScratchStats();
+}
+
+void setScratchBypass(bool bypass)
+{
+    (void)bypass;
+}
+
+#endif
+
+}  // namespace geometry
+}  // namespace hobbycad
@@ -0,0 +1,841 @@
+// =====================================================================
+//  src/libhobbycad/geometry/spline.cpp — B-spline / NURBS curves
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/geometry/spline.h>
+#include <hobbycad/geometry/utils.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <utility>
+
+namespace hobbycad {
+namespace geometry {
+
+namespace {
+
+constexpr int kMaxOrder = MAX_SPLINE_DEGREE + 1;
+
+/// Pole in homogeneous coordinates (x·w, y·w, w)
+struct HomogeneousPoint {
+    double x = 0.0;
+    double y = 0.0;
+    double w = 1.0;
+};
+
+HomogeneousPoint blend(const HomogeneousPoint& a, const HomogeneousPoint& b, double alpha)
+{
+    return {(1.0 - alpha) * a.x + alpha * b.x,
+            (1.0 - alpha) * a.y + alpha * b.y,
+            (1.0 - alpha) * a.w + alpha * b.w};
+}
+
+/// 8-point Gauss-Legendre nodes and weights on [-1, 1]
+constexpr double kGaussNodes[8] = {
+    -0.9602898564975363, -0.7966664774136267, -0.5255324099163290, -0.1834346424956498,
+     0.1834346424956498,  0.5255324099163290,  0.7966664774136267,  0.9602898564975363};
+constexpr double kGaussWeights[8] = {
+    0.1012285362903763, 0.2223810344533745, 0.3137066458778873, 0.3626837833783620,
+    0.3626837833783620, 0.3137066458778873, 0.2223810344533745, 0.1012285362903763};
+
+/// Basis functions and their first nd derivatives at t in knot span k
+/// (The NURBS Book, algorithm A2.3)
+void basisDerivatives(const std::vector<double>& U, int k, double t, int p, int nd,
+                      double ders[3][kMaxOrder])
+{
+    double ndu[kMaxOrder][kMaxOrder];
+    double left[kMaxOrder];
+    double right[kMaxOrder];
+    double a[2][kMaxOrder];
+
+    ndu[0][0] = 1.0;
+    for (int j = 1; j <= p; ++j) {
+        left[j] = t - U[k + 1 - j];
+        right[j] = U[k + j] - t;
+        double saved = 0.0;
+        for (int r = 0; r < j; ++r) {
+            ndu[j][r] = right[r + 1] + left[j - r];
+            double temp = ndu[r][j - 1] / ndu[j][r];
+            ndu[r][j] = saved + right[r + 1] * temp;
+            saved = left[j - r] * temp;
+        }
+        ndu[j][j] = saved;
+    }
+    for (int j = 0; j <= p; ++j) {
+        ders[0][j] = ndu[j][p];
+    }
+
+    for (int r = 0; r <= p; ++r) {
+        int s1 = 0, s2 = 1;
+        a[0][0] = 1.0;
+        for (int kk = 1; kk <= nd; ++kk) {
+            double d = 0.0;
+            int rk = r - kk;
+            int pk = p - kk;
+            if (r >= kk) {
+                a[s2][0] = a[s1][0] / ndu[pk + 1][rk];
+                d = a[s2][0] * ndu[rk][pk];
+            }
+            int j1 = (rk >= -1) ? 1 : -rk;
+            int j2 = (r - 1 <= pk) ? kk - 1 : p - r;
+            for (int j = j1; j <= j2; ++j) {
+                a[s2][j] = (a[s1][j] - a[s1][j - 1]) / ndu[pk + 1][rk + j];
+                d += a[s2][j] * ndu[rk + j][pk];
+            }
+            if (r <= pk) {
+                a[s2][kk] = -a[s1][kk - 1] / ndu[pk + 1][r];
+                d += a[s2][kk] * ndu[r][pk];
+            }
+            ders[kk][r] = d;
+            std::swap(s1, s2);
+        }
+    }
+
+    double factor = p;
+    for (int kk = 1; kk <= nd; ++kk) {
+        for (int j = 0; j <= p; ++j) {
+            ders[kk][j] *= factor;
+        }
+        factor *= (p - kk);
+    }
+}
+
+/// Refine a bracketed sign change of f on [lo, hi] (Illinois variant
+/// of regula falsi, which keeps the bracket and converges superlinearly)
+template <typename F>
+double solveBracket(F& f, double lo, double hi, double flo, double fhi)
+{
+    int side = 0;
+    double t = lo;
+    for (int iter = 0; iter < 60; ++iter) {
+        t = (lo * fhi - hi * flo) / (fhi - flo);
+        if (!(t > lo && t < hi)) t = 0.5 * (lo + hi);
+        double ft = f(t);
+        if (ft == 0.0 || hi - lo < 1e-14 * std::max(1.0, std::abs(hi))) break;
+        if ((ft > 0.0) == (fhi > 0.0)) {
+            hi = t; fhi = ft;
+            if (side == -1) flo *= 0.5;
+            side = -1;
+        } else {
+            lo = t; flo = ft;
+            if (side == 1) fhi *= 0.5;
+            side = 1;
+        }
+    }
+    return t;
+}
+
+/// Parameters where a scalar function of the curve changes sign, on
+/// spans whose hull touches region
+template <typename F>
+std::vector<double> findRoots(const BSplineCurve2D& curve, F f, const BoundingBox& region)
+{
+    std::vector<double> roots;
+    const int samples = 4 * (curve.degree() + 1);
+
+    for (int s : curve.spansInBox(region)) {
+        double t0, t1;
+        curve.spanRange(s, &t0, &t1);
+        double prevT = t0;
+        double prevF = f(t0);
+        if (prevF == 0.0) roots.push_back(t0);
+        for (int i = 1; i <= samples; ++i) {
+            double t = (i == samples) ? t1 : t0 + (t1 - t0) * i / samples;
+            double ft = f(t);
+            if (ft == 0.0) {
+                roots.push_back(t);
+            } else if (prevF != 0.0 && (ft > 0.0) != (prevF > 0.0)) {
+                roots.push_back(solveBracket(f, prevT, t, prevF, ft));
+            }
+            prevT = t;
+            prevF = ft;
+        }
+    }
+
+    // Roots on span boundaries are found from both sides
+    std::sort(roots.begin(), roots.end());
+    double eps = 1e-9 * std::max(1.0, curve.lastParameter() - curve.firstParameter());
+    roots.erase(std::unique(roots.begin(), roots.end(),
+                            [eps](double a, double b) { return b - a < eps; }),
+                roots.end());
+    return roots;
+}
+
+}  // anonymous namespace
+
+// =====================================================================
+//  Construction
+// =====================================================================
+
+BSplineCurve2D::BSplineCurve2D(int degree, std::vector<Point2D> poles,
+                               std::vector<double> knots,
+                               std::vector<double> weights)
+    : m_degree(degree)
+    , m_poles(std::move(poles))
+    , m_knots(std::move(knots))
+    , m_weights(std::move(weights))
+{
+    rebuild();
+}
+
+BSplineCurve2D BSplineCurve2D::fromCatmullRom(const Point2D* points, std::size_t count)
+{
+    if (count < 2) return BSplineCurve2D();
+
+    // Each Catmull-Rom segment is the cubic Bézier (P[i], P[i] + (P[i+1] - P[i-1])/6,
+    // P[i+1] - (P[i+2] - P[i])/6, P[i+1]).  The tangents at a through-point
+    // are symmetric, so the point is the midpoint of its neighbouring inner
+    // poles and a double knot represents the joint exactly.
+    const int n = static_cast<int>(count);
+    std::vector<Point2D> poles;
+    poles.reserve(2 * count);
+    poles.push_back(points[0]);
+    for (int i = 0; i < n - 1; ++i) {
+        const Point2D& p0 = points[i == 0 ? 0 : i - 1];
+        const Point2D& p1 = points[i];
+        const Point2D& p2 = points[i + 1];
+        const Point2D& p3 = points[i == n - 2 ? n - 1 : i + 2];
+        poles.push_back(p1 + (p2 - p0) / 6.0);
+        poles.push_back(p2 - (p3 - p1) / 6.0);
+    }
+    poles.push_back(points[n - 1]);
+
+    std::vector<double> knots;
+    knots.reserve(2 * count + 4);
+    knots.insert(knots.end(), 4, 0.0);
+    for (int i = 1; i < n - 1; ++i) {
+        knots.push_back(i);
+        knots.push_back(i);
+    }
+    knots.insert(knots.end(), 4, static_cast<double>(n - 1));
+
+    return BSplineCurve2D(3, std::move(poles), std::move(knots));
+}
+
+BSplineCurve2D BSplineCurve2D::fromCatmullRom(const std::vector<Point2D>& points)
+{
+    return fromCatmullRom(points.data(), points.size());
+}
+
+void BSplineCurve2D::rebuild()
+{
+    m_spans.clear();
+    m_hulls.clear();
+    m_leafBase = 0;
+    std::atomic_store(&m_lengths, std::shared_ptr<const std::vector<double>>());
+    const int p = m_degree;
+    const int n = static_cast<int>(m_poles.size());
+
+    m_valid = p >= 1 && p <= MAX_SPLINE_DEGREE && n >= p + 1 &&
+              static_cast<int>(m_knots.size()) == n + p + 1 &&
+              (m_weights.empty() || static_cast<int>(m_weights.size()) == n);
+    if (m_valid) {
+        for (std::size_t i = 1; i < m_knots.size(); ++i) {
+            if (!(m_knots[i] >= m_knots[i - 1])) m_valid = false;
+        }
+        for (double w : m_weights) {
+            if (!(w > 0.0)) m_valid = false;
+        }
+        if (m_valid && !(m_knots[n] > m_knots[p])) m_valid = false;
+    }
+    if (!m_valid) return;
+
+    for (int k = p; k < n; ++k) {
+        if (!(m_knots[k + 1] > m_knots[k])) continue;
+        Span span;
+        span.index = k;
+        for (int i = k - p; i <= k; ++i) {
+            span.bounds.include(m_poles[i]);
+        }
+        m_spans.push_back(span);
+    }
+
+    // Hull tree: node i holds the union of nodes 2i and 2i+1; the
+    // leaves from m_leafBase on are the spans
+    m_leafBase = 1;
+    while (m_leafBase < spanCount()) m_leafBase *= 2;
+    m_hulls.assign(m_leafBase, BoundingBox());
+    for (int node = m_leafBase - 1; node >= 1; --node) {
+        m_hulls[node] = hull(2 * node);
+        m_hulls[node].include(hull(2 * node + 1));
+    }
+}
+
+const BoundingBox& BSplineCurve2D::hull(int node) const
+{
+    static const BoundingBox kEmpty;
+    if (node < m_leafBase) return m_hulls[node];
+    int span = node - m_leafBase;
+    return span < spanCount() ? m_spans[span].bounds : kEmpty;
+}
+
+double BSplineCurve2D::firstParameter() const
+{
+    return m_valid ? m_knots[m_degree] : 0.0;
+}
+
+double BSplineCurve2D::lastParameter() const
+{
+    return m_valid ? m_knots[m_poles.size()] : 0.0;
+}
+
+void BSplineCurve2D::spanRange(int span, double* t0, double* t1) const
+{
+    int k = m_spans[span].index;
+    if (t0) *t0 = m_knots[k];
+    if (t1) *t1 = m_knots[k + 1];
+}
+
+int BSplineCurve2D::spanOfParameter(double t) const
+{
+    // Last span whose start is <= t
+    int lo = 0, hi = spanCount() - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (m_knots[m_spans[mid].index] <= t) lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+
+int BSplineCurve2D::findSpan(double t) const
+{
+    return m_spans[spanOfParameter(t)].index;
+}
+
+// =====================================================================
+//  Evaluation
+// =====================================================================
+
+Point2D BSplineCurve2D::point(double t) const
+{
+    if (!m_valid) return Point2D();
+    t = std::clamp(t, firstParameter(), lastParameter());
+
+    // de Boor's algorithm in homogeneous coordinates
+    const int p = m_degree;
+    const int k = findSpan(t);
+    std::array<HomogeneousPoint, kMaxOrder> d;
+    for (int j = 0; j <= p; ++j) {
+        const Point2D& pole = m_poles[k - p + j];
+        double w = m_weights.empty() ? 1.0 : m_weights[k - p + j];
+        d[j] = {pole.x * w, pole.y * w, w};
+    }
+    for (int r = 1; r <= p; ++r) {
+        for (int j = p; j >= r; --j) {
+            double u0 = m_knots[k - p + j];
+            double alpha = (t - u0) / (m_knots[k + 1 + j - r] - u0);
+            d[j] = blend(d[j - 1], d[j], alpha);
+        }
+    }
+    return Point2D(d[p].x / d[p].w, d[p].y / d[p].w);
+}
+
+SplineDerivatives BSplineCurve2D::derivatives(double t) const
+{
+    return evaluate(t, 2);
+}
+
+SplineDerivatives BSplineCurve2D::evaluate(double t, int order) const
+{
+    SplineDerivatives result;
+    if (!m_valid) return result;
+    t = std::clamp(t, firstParameter(), lastParameter());
+
+    const int p = m_degree;
+    const int nd = std::min(order, p);
+    const int k = findSpan(t);
+    double ders[3][kMaxOrder] = {};
+    basisDerivatives(m_knots, k, t, p, nd, ders);
+
+    // Derivatives of the homogeneous curve (A and w)
+    HomogeneousPoint a[3];
+    for (HomogeneousPoint& ad : a) ad = {0.0, 0.0, 0.0};
+    for (int d = 0; d <= nd; ++d) {
+        for (int j = 0; j <= p; ++j) {
+            const Point2D& pole = m_poles[k - p + j];
+            double w = m_weights.empty() ? 1.0 : m_weights[k - p + j];
+            double b = ders[d][j] * w;
+            a[d].x += b * pole.x;
+            a[d].y += b * pole.y;
+            a[d].w += b;
+        }
+    }
+
+    // Quotient rule: C = A/w, C' = (A' - w'C)/w, C'' = (A'' - 2w'C' - w''C)/w
+    double w = a[0].w;
+    result.point = Point2D(a[0].x / w, a[0].y / w);
+    result.first = Point2D((a[1].x - a[1].w * result.point.x) / w,
+                           (a[1].y - a[1].w * result.point.y) / w);
+    if (order >= 2) {
+        result.second = Point2D(
+            (a[2].x - 2.0 * a[1].w * result.first.x - a[2].w * result.point.x) / w,
+            (a[2].y - 2.0 * a[1].w * result.first.y - a[2].w * result.point.y) / w);
+    }
+    return result;
+}
+
+Point2D BSplineCurve2D::tangent(double t) const
+{
+    Point2D d = derivatives(t).first;
+    double len = geometry::length(d);
+    return len > 0.0 ? d / len : Point2D();
+}
+
+// =====================================================================
+//  Arc Length
+// =====================================================================
+
+double BSplineCurve2D::arcLength(double t0, double t1) const
+{
+    if (!(t1 > t0)) return 0.0;
+
+    // Gauss-Legendre on the whole interval and on its halves; split
+    // further where they disagree (cusps, tight bends)
+    auto gauss = [this](double a, double b) {
+        double half = 0.5 * (b - a);
+        double mid = 0.5 * (a + b);
+        double sum = 0.0;
+        for (int i = 0; i < 8; ++i) {
+            sum += kGaussWeights[i] * geometry::length(evaluate(mid + half * kGaussNodes[i], 1).first);
+        }
+        return sum * half;
+    };
+
+    struct Interval { double a, b, whole; int depth; };
+    Interval stack[32];
+    int top = 0;
+    stack[top++] = {t0, t1, gauss(t0, t1), 0};
+    double total = 0.0;
+    while (top > 0) {
+        Interval iv = stack[--top];
+        double mid = 0.5 * (iv.a + iv.b);
+        double left = gauss(iv.a, mid);
+        double right = gauss(mid, iv.b);
+        double split = left + right;
+        if (iv.depth >= 12 || top >= 30 ||
+            std::abs(split - iv.whole) <= 1e-8 * std::max(split, 1e-6)) {
+            total += split;
+        } else {
+            stack[top++] = {iv.a, mid, left, iv.depth + 1};
+            stack[top++] = {mid, iv.b, right, iv.depth + 1};
+        }
+    }
+    return total;
+}
+
+const std::vector<double>& BSplineCurve2D::lengthTable() const
+{
+    // Built on first use; concurrent first calls may both build it,
+    // which is harmless since the results are identical
+    auto table = std::atomic_load(&m_lengths);
+    if (!table) {
+        auto built = std::make_shared<std::vector<double>>();
+        built->reserve(m_spans.size() + 1);
+        double total = 0.0;
+        built->push_back(total);
+        for (const Span& span : m_spans) {
+            total += arcLength(m_knots[span.index], m_knots[span.index + 1]);
+            built->push_back(total);
+        }
+        table = built;
+        std::atomic_store(&m_lengths, table);
+    }
+    return *table;
+}
+
+double BSplineCurve2D::length() const
+{
+    if (m_spans.empty()) return 0.0;
+    return lengthTable().back();
+}
+
+double BSplineCurve2D::lengthAt(double t) const
+{
+    if (m_spans.empty()) return 0.0;
+    t = std::clamp(t, firstParameter(), lastParameter());
+    int s = spanOfParameter(t);
+    return lengthTable()[s] + arcLength(m_knots[m_spans[s].index], t);
+}
+
+double BSplineCurve2D::parameterAtLength(double s) const
+{
+    if (m_spans.empty()) return 0.0;
+    const std::vector<double>& lengths = lengthTable();
+    if (s <= 0.0) return firstParameter();
+    if (s >= lengths.back()) return lastParameter();
+
+    // Span containing the length, then Newton on L(t) - s with a
+    // bisection fallback inside the span
+    int span = static_cast<int>(std::upper_bound(lengths.begin(), lengths.end(), s) - lengths.begin()) - 1;
+    span = std::clamp(span, 0, spanCount() - 1);
+    double a = m_knots[m_spans[span].index];
+    double b = m_knots[m_spans[span].index + 1];
+    double spanLength = lengths[span + 1] - lengths[span];
+    double target = s - lengths[span];
+    if (spanLength <= 0.0) return a;
+
+    double t = a + (b - a) * target / spanLength;
+    double tLo = a, tHi = b;
+    for (int iter = 0; iter < 30; ++iter) {
+        double f = arcLength(a, t) - target;
+        if (std::abs(f) <= 1e-10 * std::max(spanLength, 1e-9)) break;
+        if (f > 0.0) tHi = t; else tLo = t;
+        double speed = geometry::length(evaluate(t, 1).first);
+        double next = speed > 0.0 ? t - f / speed : 0.5 * (tLo + tHi);
+        if (!(next > tLo && next < tHi)) next = 0.5 * (tLo + tHi);
+        t = next;
+    }
+    return t;
+}
+
+// =====================================================================
+//  Bounds
+// =====================================================================
+
+BoundingBox BSplineCurve2D::boundingBox() const
+{
+    return m_spans.empty() ? BoundingBox() : hull(1);
+}
+
+std::vector<int> BSplineCurve2D::spansInBox(const BoundingBox& region) const
+{
+    std::vector<int> spans;
+    if (m_spans.empty()) return spans;
+
+    int stack[64];
+    int top = 0;
+    stack[top++] = 1;
+    while (top > 0) {
+        int node = stack[--top];
+        if (!hull(node).intersects(region)) continue;
+        if (node >= m_leafBase) {
+            spans.push_back(node - m_leafBase);
+        } else {
+            stack[top++] = 2 * node + 1;
+            stack[top++] = 2 * node;
+        }
+    }
+    return spans;
+}
+
+// =====================================================================
+//  Queries
+// =====================================================================
+
+double BSplineCurve2D::refineClosest(const Point2D& p, double lo, double hi, double t) const
+{
+    // Newton on f(t) = (C(t) - p)·C'(t), kept inside a bracket that
+    // shrinks by the sign of f; bisect where Newton misbehaves (sharp
+    // bends make f' negative)
+    for (int iter = 0; iter < 40; ++iter) {
+        SplineDerivatives d = derivatives(t);
+        Point2D diff = d.point - p;
+        double f = geometry::dot(diff, d.first);
+        double df = geometry::dot(d.first, d.first) + geometry::dot(diff, d.second);
+        if (f == 0.0) break;
+        if (f < 0.0) lo = t; else hi = t;
+        double next = (df > 0.0) ? t - f / df : 0.5 * (lo + hi);
+        if (!(next > lo && next < hi)) next = 0.5 * (lo + hi);
+        if (std::abs(next - t) <= 1e-13 * std::max(1.0, std::abs(t)) || hi - lo <= 1e-13) {
+            t = next;
+            break;
+        }
+        t = next;
+    }
+    return t;
+}
+
+Point2D BSplineCurve2D::closestPoint(const Point2D& p, double* parameter) const
+{
+    if (m_spans.empty()) {
+        if (parameter) *parameter = 0.0;
+        return Point2D();
+    }
+
+    // Lower bound of the squared distance to each span from its hull box
+    auto hullDistance2 = [&p](const BoundingBox& box) {
+        double dx = std::max({box.minX - p.x, 0.0, p.x - box.maxX});
+        double dy = std::max({box.minY - p.y, 0.0, p.y - box.maxY});
+        return dx * dx + dy * dy;
+    };
+    auto distance2 = [&p](const Point2D& q) {
+        return (q.x - p.x) * (q.x - p.x) + (q.y - p.y) * (q.y - p.y);
+    };
+
+    const int samples = 2 * m_degree + 2;
+    double bestDist2 = std::numeric_limits<double>::max();
+    double bestT = firstParameter();
+    Point2D best;
+
+    // Sample each span and refine every local minimum of the samples;
+    // a span can bend back on itself, so the nearest sample alone can
+    // sit beside the wrong minimum
+    auto searchSpan = [&](int s) {
+        double t0 = m_knots[m_spans[s].index];
+        double t1 = m_knots[m_spans[s].index + 1];
+        std::array<double, 2 * kMaxOrder + 1> dist2;
+        for (int i = 0; i <= samples; ++i) {
+            dist2[i] = distance2(point(t0 + (t1 - t0) * i / samples));
+        }
+        for (int i = 0; i <= samples; ++i) {
+            if ((i > 0 && dist2[i - 1] < dist2[i]) || (i < samples && dist2[i + 1] < dist2[i])) {
+                continue;
+            }
+            double sampleT = t0 + (t1 - t0) * i / samples;
+            double t = refineClosest(p, t0 + (t1 - t0) * std::max(i - 1, 0) / samples,
+                                     t0 + (t1 - t0) * std::min(i + 1, samples) / samples,
+                                     sampleT);
+            Point2D q = point(t);
+            double d2 = distance2(q);
+            if (dist2[i] < d2) {
+                t = sampleT;
+                q = point(t);
+                d2 = dist2[i];
+            }
+            if (d2 < bestDist2) {
+                bestDist2 = d2;
+                bestT = t;
+                best = q;
+            }
+        }
+    };
+
+    // Branch and bound down the hull tree, nearer child first
+    int stack[64];
+    int top = 0;
+    stack[top++] = 1;
+    while (top > 0) {
+        int node = stack[--top];
+        const BoundingBox& box = hull(node);
+        if (!box.valid || hullDistance2(box) >= bestDist2) continue;
+        if (node >= m_leafBase) {
+            searchSpan(node - m_leafBase);
+            continue;
+        }
+        int nearChild = 2 * node;
+        int farChild = 2 * node + 1;
+        if (hull(farChild).valid &&
+            (!hull(nearChild).valid || hullDistance2(hull(farChild)) < hullDistance2(hull(nearChild)))) {
+            std::swap(nearChild, farChild);
+        }
+        stack[top++] = farChild;
+        stack[top++] = nearChild;
+    }
+
+    if (parameter) *parameter = bestT;
+    return best;
+}
+
+double BSplineCurve2D::distanceTo(const Point2D& p) const
+{
+    Point2D q = closestPoint(p);
+    return std::hypot(q.x - p.x, q.y - p.y);
+}
+
+std::vector<double> BSplineCurve2D::intersectSegment(const Point2D& a, const Point2D& b) const
+{
+    Point2D dir = b - a;
+    double len2 = geometry::dot(dir, dir);
+    if (!m_valid || len2 <= 0.0) return {};
+
+    BoundingBox region(a.x, a.y, b.x, b.y);
+    auto side = [&](double t) { return geometry::cross(dir, point(t) - a); };
+    std::vector<double> roots = findRoots(*this, side, region);
+
+    // Keep crossings of the segment itself, not of its supporting line
+    const double eps = 1e-9;
+    roots.erase(std::remove_if(roots.begin(), roots.end(), [&](double t) {
+                    double u = geometry::dot(point(t) - a, dir) / len2;
+                    return u < -eps || u > 1.0 + eps;
+                }),
+                roots.end());
+    return roots;
+}
+
+std::vector<double> BSplineCurve2D::intersectCircle(const Point2D& center, double radius) const
+{
+    if (!m_valid || radius <= 0.0) return {};
+
+    BoundingBox region(center.x - radius, center.y - radius,
+                       center.x + radius, center.y + radius);
+    auto power = [&](double t) {
+        Point2D d = point(t) - center;
+        return geometry::dot(d, d) - radius * radius;
+    };
+    return findRoots(*this, power, region);
+}
+
+std::vector<Point2D> BSplineCurve2D::tessellate(double tolerance) const
+{
+    std::vector<Point2D> result;
+    if (m_spans.empty()) return result;
+    tolerance = std::max(tolerance, 1e-6);
+
+    const int p = m_degree;
+    result.push_back(point(firstParameter()));
+    for (const Span& span : m_spans) {
+        const int k = span.index;
+        double t0 = m_knots[k];
+        double t1 = m_knots[k + 1];
+
+        // Bound |C''| on the span: for a polynomial curve by the poles
+        // of its second derivative (convex hull), for a rational one by
+        // sampling with a safety factor
+        double maxSecond = 0.0;
+        if (p >= 2 && m_weights.empty()) {
+            std::array<Point2D, kMaxOrder> q;
+            for (int i = k - p; i < k; ++i) {
+                q[i - (k - p)] = (m_poles[i + 1] - m_poles[i]) * (p / (m_knots[i + p + 1] - m_knots[i + 1]));
+            }
+            for (int i = k - p; i < k - 1; ++i) {
+                Point2D r = (q[i + 1 - (k - p)] - q[i - (k - p)]) *
+                            ((p - 1) / (m_knots[i + p + 1] - m_knots[i + 2]));
+                maxSecond = std::max(maxSecond, geometry::length(r));
+            }
+        } else if (p >= 2) {
+            const int samples = 2 * p + 2;
+            for (int i = 0; i <= samples; ++i) {
+                double t = t0 + (t1 - t0) * i / samples;
+                maxSecond = std::max(maxSecond, geometry::length(derivatives(t).second));
+            }
+            maxSecond *= 1.5;
+        }
+
+        // A chord over a parameter step h deviates at most M·h²/8
+        int segments = 1;
+        if (maxSecond > 0.0) {
+            double steps = (t1 - t0) * std::sqrt(maxSecond / (8.0 * tolerance));
+            segments = static_cast<int>(std::clamp(std::ceil(steps), 1.0, 1024.0));
+        }
+        for (int i = 1; i <= segments; ++i) {
+            result.push_back(point(i == segments ? t1 : t0 + (t1 - t0) * i / segments));
+        }
+    }
+    return result;
+}
+
+// =====================================================================
+//  Modification
+// =====================================================================
+
+int BSplineCurve2D::insertKnot(double t, int times)
+{
+    if (!m_valid || times <= 0) return 0;
+    if (!(t > firstParameter() && t < lastParameter())) return 0;
+
+    // Boehm's algorithm (The NURBS Book, A5.1) on homogeneous poles
+    const int p = m_degree;
+    const int n = static_cast<int>(m_poles.size());
+    const int k = findSpan(t);
+    int s = 0;
+    for (int i = k; i >= 0 && m_knots[i] == t; --i) ++s;
+    const int r = std::min(times, p - s);
+    if (r <= 0) return 0;
+
+    auto homogeneous = [this](int i) {
+        double w = m_weights.empty() ? 1.0 : m_weights[i];
+        return HomogeneousPoint{m_poles[i].x * w, m_poles[i].y * w, w};
+    };
+
+    std::vector<HomogeneousPoint> q(n + r);
+    for (int i = 0; i <= k - p; ++i) q[i] = homogeneous(i);
+    for (int i = k - s; i < n; ++i) q[i + r] = homogeneous(i);
+
+    std::array<HomogeneousPoint, kMaxOrder> rw;
+    for (int i = 0; i <= p - s; ++i) rw[i] = homogeneous(k - p + i);
+
+    int L = k - p;
+    for (int j = 1; j <= r; ++j) {
+        L = k - p + j;
+        for (int i = 0; i <= p - j - s; ++i) {
+            double alpha = (t - m_knots[L + i]) / (m_knots[i + k + 1] - m_knots[L + i]);
+            rw[i] = blend(rw[i], rw[i + 1], alpha);
+        }
+        q[L] = rw[0];
+        q[k + r - j - s] = rw[p - j - s];
+    }
+    for (int i = L + 1; i < k - s; ++i) q[i] = rw[i - L];
+
+    m_knots.insert(m_knots.begin() + k + 1, r, t);
+    m_poles.resize(n + r);
+    if (!m_weights.empty()) m_weights.resize(n + r);
+    for (int i = 0; i < n + r; ++i) {
+        m_poles[i] = Point2D(q[i].x / q[i].w, q[i].y / q[i].w);
+        if (!m_weights.empty()) m_weights[i] = q[i].w;
+    }
+
+    rebuild();
+    return r;
+}
+
+std::vector<std::vector<Point2D>> BSplineCurve2D::bezierSegments() const
+{
+    std::vector<std::vector<Point2D>> segments;
+    if (!m_valid || isRational()) return segments;
+
+    // Clamped curves only: the end knots must already have full multiplicity
+    const int p = m_degree;
+    const int n = static_cast<int>(m_poles.size());
+    for (int i = 0; i < p; ++i) {
+        if (m_knots[i] != m_knots[p] || m_knots[n + 1 + i] != m_knots[n]) return segments;
+    }
+
+    BSplineCurve2D bezier = *this;
+    for (const Span& span : m_spans) {
+        if (span.index == m_spans.front().index) continue;
+        bezier.insertKnot(m_knots[span.index], p);
+    }
+
+    segments.reserve(bezier.m_spans.size());
+    for (const Span& span : bezier.m_spans) {
+        segments.emplace_back(bezier.m_poles.begin() + (span.index - p),
+                              bezier.m_poles.begin() + (span.index + 1));
+    }
+    return segments;
+}
+
+BSplineCurve2D BSplineCurve2D::transformed(const Transform2D& t) const
+{
+    BSplineCurve2D result = *this;
+    for (Point2D& pole : result.m_poles) {
+        pole = t.apply(pole);
+    }
+    result.rebuild();
+    return result;
+}
+
+void BSplineCurve2D::knotMultiplicities(std::vector<double>* values, std::vector<int>* mults) const
+{
+    if (values) values->clear();
+    if (mults) mults->clear();
+    for (std::size_t i = 0; i < m_knots.size(); ++i) {
+        if (i > 0 && m_knots[i] == m_knots[i - 1]) {
+            if (mults) ++mults->back();
+            continue;
+        }
+        if (values) values->push_back(m_knots[i]);
+        if (mults) mults->push_back(1);
+    }
+}
+
+std::size_t BSplineCurve2D::memoryUsage() const
+{
+    return m_poles.capacity() * sizeof(Point2D) +
+           m_knots.capacity() * sizeof(double) +
+           m_weights.capacity() * sizeof(double) +
+           m_spans.capacity() * sizeof(Span) +
+           m_hulls.capacity() * sizeof(BoundingBox) +
+           (m_lengths ? m_lengths->capacity() * sizeof(double) : 0);
+}
+
+}  // namespace geometry
+}  // namespace hobbycad
@@ -0,0 +1,264 @@
+// =====================================================================
+//  src/libhobbycad/history.cpp — Project-level undo/redo
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/history.h>
+
+#include <TopoDS_TShape.hxx>
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace hobbycad {
+namespace history {
+
+namespace {
+
+/// Identity of a body: its TShape, shared by all handles to it
+const void* bodyKey(const TopoDS_Shape& shape)
+{
+    return shape.TShape().get();
+}
+
+/// Geometry and tessellation behind a body
+std::int64_t bodyBytes(const TopoDS_Shape& shape)
+{
+    const memory::ShapeFootprint fp = memory::shapeFootprint(shape);
+    return fp.geometryBytes + fp.tessellationBytes;
+}
+
+/// Same estimate as the project's sketch charge, plus the image
+std::int64_t sketchBytes(const SketchData& sketch)
+{
+    std::int64_t bytes = static_cast<std::int64_t>(sizeof(SketchData)) +
+                         memory::heapBytes(sketch.name);
+    for (const auto& entity : sketch.entities) {
+        bytes += memory::footprint(entity);
+    }
+    for (const auto& constraint : sketch.constraints) {
+        bytes += static_cast<std::int64_t>(sizeof(ConstraintData)) +
+                 memory::heapBytes(constraint.entityIds) +
+                 memory::heapBytes(constraint.pointIndices);
+    }
+    return bytes + memory::footprint(sketch.backgroundImage);
+}
+
+/// Handles, feature records and text held by one step itself
+std::int64_t overheadBytes(const std::string& description, const ModelState& state)
+{
+    std::int64_t bytes = memory::heapBytes(description) +
+                         memory::heapBytes(state.bodies) +
+                         memory::heapBytes(state.sketches) +
+                         memory::heapBytes(state.features);
+    for (const auto& feature : state.features) {
+        bytes += memory::heapBytes(feature.name) +
+                 memory::heapBytes(feature.dependsOn) +
+                 memory::heapBytes(feature.stateMessage);
+    }
+    return bytes;
+}
+
+}  // anonymous namespace
+
+// =====================================================================
+//  Construction and Recording
+// =====================================================================
+
+ProjectHistory::ProjectHistory(std::int64_t memoryBudget, int maxSteps)
+    : m_budget(std::max<std::int64_t>(0, memoryBudget))
+    , m_maxSteps(std::max(1, maxSteps))
+{
+    m_steps.emplace_back();
+}
+
+void ProjectHistory::reset(const ModelState& state)
+{
+    while (!m_steps.empty()) dropBack();
+    append({}, state);
+    m_cursor = 0;
+    m_cleanIndex = 0;
+    updateCharge();
+}
+
+void ProjectHistory::record(const std::string& description, const ModelState& state)
+{
+    while (canRedo()) dropBack();
+    append(description, state);
+    m_cursor = static_cast<int>(m_steps.size()) - 1;
+    enforceLimits();
+    updateCharge();
+}
+
+const ModelState& ProjectHistory::current() const
+{
+    return m_steps[m_cursor].state;
+}
+
+const ModelState* ProjectHistory::undo()
+{
+    if (!canUndo()) return nullptr;
+    --m_cursor;
+    updateCharge();
+    return &m_steps[m_cursor].state;
+}
+
+const ModelState* ProjectHistory::redo()
+{
+    if (!canRedo()) return nullptr;
+    ++m_cursor;
+    updateCharge();
+    return &m_steps[m_cursor].state;
+}
+
+std::string ProjectHistory::undoDescription() const
+{
+    return canUndo() ? m_steps[m_cursor].description : std::string();
+}
+
+std::string ProjectHistory::redoDescription() const
+{
+    return canRedo() ? m_steps[m_cursor + 1].description : std::string();
+}
+
+// =====================================================================
+//  Limits
+// =====================================================================
+
+void ProjectHistory::setMemoryBudget(std::int64_t bytes)
+{
+    m_budget = std::max<std::int64_t>(0, bytes);
+    enforceLimits();
+    updateCharge();
+}
+
+void ProjectHistory::setMaxSteps(int maxSteps)
+{
+    m_maxSteps = std::max(1, maxSteps);
+    enforceLimits();
+    updateCharge();
+}
+
+void ProjectHistory::enforceLimits()
+{
+    while (undoLevels() > m_maxSteps) dropFront();
+    if (m_budget <= 0) return;
+    while (canUndo() && retainedBytes() > m_budget) dropFront();
+    while (canRedo() && retainedBytes() > m_budget) dropBack();
+}
+
+HistoryMemory ProjectHistory::memoryUsage() const
+{
+    HistoryMemory usage;
+    usage.liveBytes = liveBytes();
+    usage.retainedBytes = retainedBytes();
+    usage.bodies = static_cast<int>(m_bodies.size());
+    usage.sketches = static_cast<int>(m_sketches.size());
+    usage.steps = static_cast<int>(m_steps.size());
+    return usage;
+}
+
+// =====================================================================
+//  Shared Storage
+// =====================================================================
+
+void ProjectHistory::append(const std::string& description, const ModelState& state)
+{
+    Step step;
+    step.description = description;
+    step.state = state;
+    step.overheadBytes = overheadBytes(step.description, step.state);
+    acquire(step.state);
+    m_overheadBytes += step.overheadBytes;
+    m_steps.push_back(std::move(step));
+}
+
+void ProjectHistory::dropFront()
+{
+    release(m_steps.front().state);
+    m_overheadBytes -= m_steps.front().overheadBytes;
+    m_steps.pop_front();
+    --m_cursor;
+    if (m_cleanIndex >= 0) --m_cleanIndex;
+}
+
+void ProjectHistory::dropBack()
+{
+    if (m_cleanIndex == static_cast<int>(m_steps.size()) - 1) m_cleanIndex = -1;
+    release(m_steps.back().state);
+    m_overheadBytes -= m_steps.back().overheadBytes;
+    m_steps.pop_back();
+}
+
+void ProjectHistory::acquire(const ModelState& state)
+{
+    for (const auto& body : state.bodies) {
+        if (body.IsNull()) continue;
+        Shared& entry = m_bodies[bodyKey(body)];
+        if (entry.refs++ == 0) {
+            entry.bytes = bodyBytes(body);
+            m_sharedBytes += entry.bytes;
+        }
+    }
+    for (const auto& sketch : state.sketches) {
+        if (!sketch.data) continue;
+        Shared& entry = m_sketches[sketch.data.get()];
+        if (entry.refs++ == 0) {
+            entry.bytes = sketchBytes(*sketch.data);
+            m_sharedBytes += entry.bytes;
+        }
+    }
+}
+
+void ProjectHistory::release(const ModelState& state)
+{
+    for (const auto& body : state.bodies) {
+        if (body.IsNull()) continue;
+        auto it = m_bodies.find(bodyKey(body));
+        if (it != m_bodies.end() && --it->second.refs == 0) {
+            m_sharedBytes -= it->second.bytes;
+            m_bodies.erase(it);
+        }
+    }
+    for (const auto& sketch : state.sketches) {
+        if (!sketch.data) continue;
+        auto it = m_sketches.find(sketch.data.get());
+        if (it != m_sketches.end() && --it->second.refs == 0) {
+            m_sharedBytes -= it->second.bytes;
+            m_sketches.erase(it);
+        }
+    }
+}
+
+std::int64_t ProjectHistory::liveBytes() const
+{
+    const ModelState& state = current();
+    std::unordered_set<const void*> seen;
+    std::int64_t bytes = 0;
+    for (const auto& body : state.bodies) {
+        if (body.IsNull() || !seen.insert(bodyKey(body)).second) continue;
+        bytes += m_bodies.at(bodyKey(body)).bytes;
+    }
+    for (const auto& sketch : state.sketches) {
+        if (!sketch.data || !seen.insert(sketch.data.get()).second) continue;
+        bytes += m_sketches.at(sketch.data.get()).bytes;
+    }
+    return bytes;
+}
+
+std::int64_t ProjectHistory::retainedBytes() const
+{
+    return m_sharedBytes - liveBytes() + m_overheadBytes - m_steps[m_cursor].overheadBytes;
+}
+
+void ProjectHistory::updateCharge()
+{
+    m_charge.set(retainedBytes());
+}
+
+}  // namespace history
+}  // namespace hobbycad
@@ -0,0 +1,65 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/brep/clash.h — Clash detection for B-rep bodies
+// =====================================================================
+//
+//  Finds bodies of an assembly or project that interfere, touch or
+//  come closer than a clearance.  Bounding-volume hierarchies over the
+//  body boxes and then the face boxes of each candidate pair narrow
+//  the search to the faces that can meet; those are checked in
+//  parallel either on the exact geometry (BRepExtrema_DistShapeShape,
+//  with booleans for interference volumes) or on cached tessellations
+//  with the triangle-level tests of mesh/clash.h.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_BREP_CLASH_H
+#define HOBBYCAD_BREP_CLASH_H
+
+#include "../core.h"
+#include "../mesh/clash.h"
+
+#include <TopoDS_Shape.hxx>
+
+#include <vector>
+
+namespace hobbycad {
+namespace brep {
+
+/// How candidate pairs are checked
+enum class ClashMethod {
+    Exact,  ///< Distances on the B-rep faces, booleans for volumes
+    Mesh    ///< Triangle tests on face tessellations; faster, approximate
+};
+
+/// Clash settings
+struct ClashOptions {
+    double clearance = 0.0;          ///< Report pairs closer than this (mm); 0 = touching only
+    double contactTolerance = 1e-4;  ///< Gaps and overlaps below this count as contact (mm)
+    ClashMethod method = ClashMethod::Exact;
+
+    /// Mesh method: linear deflection; 0 uses 1e-3 of each body's
+    /// bounding-box diagonal.  Existing finer triangulations are kept.
+    double deflection = 0.0;
+
+    bool computeVolumes = true;      ///< Report interference volumes
+    bool parallel = true;            ///< Check pairs on OCCT's thread pool
+};
+
+/// Find interfering, touching and too-close pairs of bodies
+///
+/// Interference means the bodies share volume: their faces cross, one
+/// lies inside the other, or touching faces enclose a shared volume
+/// thicker than the contact tolerance.  Interference points are the
+/// centre of the shared volume (Exact) or a point where faces cross
+/// (Mesh).  Bodies are compared by index; a body never clashes with
+/// itself.
+HOBBYCAD_EXPORT mesh::ClashReport findClashes(const std::vector<TopoDS_Shape>& bodies,
+                                              const ClashOptions& options = {});
+
+}  // namespace brep
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_BREP_CLASH_H
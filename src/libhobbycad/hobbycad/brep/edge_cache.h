@@ -0,0 +1,129 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/brep/edge_cache.h — Sketch edge cache
+// =====================================================================
+//
+//  Converts the entities of one sketch to OpenCASCADE edges once and
+//  hands the same edges to every profile wire, face and wireframe
+//  built from the sketch.  Entity endpoints that meet (within the
+//  weld tolerance) share one TopoDS_Vertex, so adjacent profiles are
+//  connected topologically and later booleans and sewing do not have
+//  to rediscover the coincidence.
+//
+//  Edges are built in sketch coordinates on the XY plane; place them
+//  with a location for other sketch planes so the edges stay shared.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_BREP_EDGE_CACHE_H
+#define HOBBYCAD_BREP_EDGE_CACHE_H
+
+#include "../core.h"
+#include "../geometry/types.h"
+#include "../sketch/entity.h"
+#include "../sketch/profiles.h"
+
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_Shape.hxx>
+#include <TopoDS_Vertex.hxx>
+#include <TopoDS_Wire.hxx>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace hobbycad {
+namespace brep {
+
+/// Counters for an edge cache
+struct EdgeCacheStats {
+    std::size_t entities = 0;         ///< Entities in the cache
+    std::size_t builtEntities = 0;    ///< Entities converted to edges so far
+    std::size_t edges = 0;            ///< Edges currently cached
+    std::size_t vertices = 0;         ///< Shared vertices currently cached
+};
+
+/// Per-sketch cache of entity edges with shared endpoint vertices.
+///
+/// Edges are built lazily on first use.  update() keeps the edges of
+/// entities whose geometry did not change, so editing one entity only
+/// rebuilds that entity.  Construction geometry is cached like any
+/// other entity; profile detection already leaves it out of profiles.
+///
+/// @code
+///     brep::SketchEdgeCache cache(entities);
+///     TopoDS_Wire outer = cache.wire(profiles[0]);
+///     TopoDS_Wire hole = cache.wire(profiles[1]);  // shares edges with outer
+/// @endcode
+class HOBBYCAD_EXPORT SketchEdgeCache {
+public:
+    SketchEdgeCache() = default;
+
+    /// @param entities Sketch entities
+    /// @param tolerance Distance within which endpoints share a vertex
+    explicit SketchEdgeCache(const std::vector<sketch::Entity>& entities,
+                             double tolerance = geometry::POINT_TOLERANCE);
+
+    /// Replace the entity set.  Entities whose geometry is unchanged
+    /// keep their edges; changed and removed entities are invalidated.
+    /// @return Number of entities invalidated
+    int update(const std::vector<sketch::Entity>& entities);
+
+    /// Drop the edges of one entity; they are rebuilt on next use
+    void invalidate(int entityId);
+
+    /// Drop all edges and vertices, keeping the entities
+    void invalidateAll();
+
+    /// Entity by ID, or nullptr
+    const sketch::Entity* entity(int entityId) const;
+
+    /// Edges of an entity in its own direction (several for
+    /// rectangles, polygons, slots and text; empty if the entity has no
+    /// edge representation)
+    const std::vector<TopoDS_Edge>& edges(int entityId);
+
+    /// Wire through the cached edges of a profile, honouring its
+    /// per-entity reversed flags
+    /// @return Null wire if the edges do not form a connected wire
+    TopoDS_Wire wire(const sketch::Profile& profile);
+
+    /// Compound of every entity's edges and of sketch points as
+    /// vertices, for wireframe display
+    TopoDS_Shape wireframe();
+
+    EdgeCacheStats stats() const;
+
+private:
+    struct Slot {
+        sketch::Entity entity;
+        std::vector<TopoDS_Edge> edges;
+        std::vector<std::pair<std::int64_t, TopoDS_Vertex>> vertices;  ///< Shared vertices used, by weld cell
+        bool built = false;
+    };
+
+    struct SharedVertex {
+        Point2D position;
+        TopoDS_Vertex vertex;
+        int users = 0;
+    };
+
+    void build(Slot& slot);
+    void release(Slot& slot);
+    TopoDS_Vertex vertexAt(const Point2D& p, Slot& slot);
+
+    double m_tolerance = geometry::POINT_TOLERANCE;
+    std::vector<int> m_order;                          ///< Entity IDs in sketch order
+    std::unordered_map<int, Slot> m_slots;             ///< By entity ID
+    std::unordered_map<std::int64_t, std::vector<SharedVertex>> m_vertices;  ///< By weld cell
+    std::size_t m_builtEntities = 0;
+};
+
+}  // namespace brep
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_BREP_EDGE_CACHE_H
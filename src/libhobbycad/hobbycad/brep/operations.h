@@ -15,9 +15,12 @@
 
 #include "../core.h"
 #include "../sketch/profiles.h"
+#include "../sketch/text.h"
+#include "edge_cache.h"
 
 #include <TopoDS_Shape.hxx>
 #include <TopoDS_Face.hxx>
+#include <TopoDS_Wire.hxx>
 #include <gp_Dir.hxx>
 #include <gp_Ax1.hxx>
 #include <gp_Vec.hxx>
@@ -106,6 +109,103 @@ HOBBYCAD_EXPORT OperationResult loftProfiles(
     const std::vector<sketch::Entity>& entities,
     bool solid = true);
 
+// =====================================================================
+//  Region Faces
+// =====================================================================
+
+/// Build the planar faces of sketch regions
+///
+/// Each region becomes one face bounded by its outer profile, with
+/// every hole added as an inner wire, so a plate with many holes is a
+/// single face rather than a plate and a set of tools to cut away.
+/// @param regions Regions to build (from sketch::detectProfileRegions)
+/// @param entities Entities for building the profile wires
+/// @return Result with the face, or a compound of faces for several
+///         regions
+HOBBYCAD_EXPORT OperationResult buildRegionFaces(
+    const std::vector<sketch::ProfileRegion>& regions,
+    const std::vector<sketch::Entity>& entities);
+
+/// Build region faces from a sketch's edge cache.  Regions that share
+/// entities share the same edges and vertices, and the cache keeps
+/// them for the next operation on the sketch.
+HOBBYCAD_EXPORT OperationResult buildRegionFaces(
+    const std::vector<sketch::ProfileRegion>& regions,
+    SketchEdgeCache& edges);
+
+/// Extrude sketch regions with their holes in a single prism
+/// @param regions Regions to extrude (from sketch::detectProfileRegions)
+/// @param entities Entities for building the profile wires
+/// @param direction Extrusion direction (unit vector)
+/// @param distance Total distance (positive = along direction)
+/// @param symmetric If true, extrude distance/2 in both directions
+/// @return Result with the solid, or a compound of solids for several
+///         regions
+HOBBYCAD_EXPORT OperationResult extrudeRegions(
+    const std::vector<sketch::ProfileRegion>& regions,
+    const std::vector<sketch::Entity>& entities,
+    const gp_Dir& direction,
+    double distance,
+    bool symmetric = false);
+
+/// Extrude sketch regions using a sketch's edge cache
+HOBBYCAD_EXPORT OperationResult extrudeRegions(
+    const std::vector<sketch::ProfileRegion>& regions,
+    SketchEdgeCache& edges,
+    const gp_Dir& direction,
+    double distance,
+    bool symmetric = false);
+
+/// Revolve sketch regions with their holes in a single revolution
+/// @param regions Regions to revolve (from sketch::detectProfileRegions)
+/// @param entities Entities for building the profile wires
+/// @param axis Revolution axis
+/// @param angleDegrees Revolution angle in degrees (360 for full revolution)
+/// @return Result with the solid, or a compound of solids for several
+///         regions
+HOBBYCAD_EXPORT OperationResult revolveRegions(
+    const std::vector<sketch::ProfileRegion>& regions,
+    const std::vector<sketch::Entity>& entities,
+    const gp_Ax1& axis,
+    double angleDegrees);
+
+/// Revolve sketch regions using a sketch's edge cache
+HOBBYCAD_EXPORT OperationResult revolveRegions(
+    const std::vector<sketch::ProfileRegion>& regions,
+    SketchEdgeCache& edges,
+    const gp_Ax1& axis,
+    double angleDegrees);
+
+// =====================================================================
+//  Text
+// =====================================================================
+
+/// Build a wire through one glyph contour, with exact line and
+/// Bézier edges joined at shared vertices
+/// @return Null wire if the contour is empty or degenerate
+HOBBYCAD_EXPORT TopoDS_Wire buildContourWire(const sketch::OutlineContour& contour);
+
+/// Build the planar faces of laid-out text (from sketch::layoutText
+/// or sketch::textOutline)
+///
+/// Each outer glyph contour becomes a face on the sketch plane with
+/// the holes of its glyph inside it as inner wires.
+/// @return Result with a compound of faces
+HOBBYCAD_EXPORT OperationResult buildTextFaces(const sketch::TextOutline& outline);
+
+/// Extrude laid-out text in a single prism, for embossing or (cut
+/// from a body) engraving
+/// @param outline Laid-out text
+/// @param direction Extrusion direction (unit vector)
+/// @param distance Total distance (positive = along direction)
+/// @param symmetric If true, extrude distance/2 in both directions
+/// @return Result with a compound of glyph solids
+HOBBYCAD_EXPORT OperationResult extrudeText(
+    const sketch::TextOutline& outline,
+    const gp_Dir& direction,
+    double distance,
+    bool symmetric = false);
+
 // =====================================================================
 //  Boolean Operations
 // =====================================================================
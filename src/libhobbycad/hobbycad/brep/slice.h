@@ -0,0 +1,85 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/brep/slice.h — Multi-plane slicing of solids
+// =====================================================================
+//
+//  Cuts a shape with a family of parallel planes and returns each
+//  section as sketch contours: closed outer boundaries and holes with
+//  their areas, made of lines, arcs and circles recovered from the
+//  section curves.  Planes are cut in parallel, either exactly with
+//  BRepAlgoAPI_Section or on a tessellation with mesh/slice.h.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_BREP_SLICE_H
+#define HOBBYCAD_BREP_SLICE_H
+
+#include "../core.h"
+#include "../mesh/slice.h"
+#include "../sketch/contour_fit.h"
+
+#include <TopoDS_Shape.hxx>
+
+#include <string>
+#include <vector>
+
+namespace hobbycad {
+namespace brep {
+
+/// How planes are cut
+enum class SliceMethod {
+    Exact,  ///< BRepAlgoAPI_Section on the B-rep
+    Mesh    ///< Mesh-plane cuts of the tessellation; faster, approximate
+};
+
+/// Slicing settings
+struct SliceOptions {
+    SliceMethod method = SliceMethod::Exact;
+
+    /// Linear deflection of section curves (Exact) or of the
+    /// tessellation (Mesh); 0 uses 1e-3 of the bounding-box diagonal.
+    /// Mesh method: existing finer triangulations are kept, and the
+    /// fit tolerance is raised to the deflection so arcs are recovered.
+    double deflection = 0.0;
+
+    sketch::ContourFitOptions fit;  ///< Joining and line/arc fitting
+    bool parallel = true;           ///< Cut planes on OCCT's thread pool
+};
+
+/// Section of the shape by one plane, in the planeAxes() coordinates
+/// of the plane normal
+struct SliceLayer {
+    double offset = 0.0;                     ///< Plane position along the normal
+    std::vector<sketch::Contour> contours;   ///< From sketch::buildContours(); IDs start at 1
+
+    /// Area enclosed by the closed contours (holes subtracted)
+    double area() const
+    {
+        double total = 0.0;
+        for (const auto& c : contours)
+            if (c.closed) total += c.area;
+        return total;
+    }
+};
+
+/// Result of sliceShape()
+struct SliceResult {
+    bool success = false;
+    std::vector<SliceLayer> layers;  ///< In the order of the plane offsets
+    int openContours = 0;            ///< Contours that did not close, over all layers
+    double milliseconds = 0.0;
+    std::string errorMessage;
+};
+
+/// Cut a shape by every plane of the family.  Open contours come from
+/// open shells or from gaps wider than the fit tolerance.
+HOBBYCAD_EXPORT SliceResult sliceShape(const TopoDS_Shape& shape,
+                                       const mesh::SlicePlanes& planes,
+                                       const SliceOptions& options = {});
+
+}  // namespace brep
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_BREP_SLICE_H
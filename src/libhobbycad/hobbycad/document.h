@@ -50,6 +50,9 @@ public:
     /// Add a shape to the document.  Marks document as modified.
     void addShape(const TopoDS_Shape& shape);
 
+    /// Replace all shapes, keeping the file path.  Marks document as modified.
+    void setShapes(const std::vector<TopoDS_Shape>& shapes);
+
     /// Remove all shapes.  Marks document as modified.
     void clear();
 
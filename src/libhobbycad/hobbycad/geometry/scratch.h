@@ -0,0 +1,138 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/geometry/scratch.h — Scratch arenas
+// =====================================================================
+//
+//  Per-thread bump allocation for the short-lived containers inside
+//  geometry and sketch kernels.  A ScratchArena marks the current
+//  position of its thread's buffer on construction and rewinds to it
+//  on destruction, so temporaries built inside a kernel call cost a
+//  pointer bump instead of a trip through the heap, and the buffer is
+//  reused by the next call.
+//
+//  Scratch containers are polymorphic-allocator containers bound to
+//  an arena.  They must not outlive the arena, be shared with another
+//  thread, or be returned to callers; copy into a std::vector for
+//  anything that leaves the kernel.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_GEOMETRY_SCRATCH_H
+#define HOBBYCAD_GEOMETRY_SCRATCH_H
+
+#include "../core.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#if __has_include(<version>)
+#include <version>
+#endif
+
+// Apple's libc++ only provides std::pmr when targeting macOS 14 or
+// later and leaves the feature macro undefined otherwise.  Without it
+// the scratch containers fall back to std::vector with the default
+// allocator, which is slower but behaves identically.
+#if defined(__cpp_lib_memory_resource)
+#define HOBBYCAD_SCRATCH_PMR 1
+#include <memory_resource>
+#else
+#define HOBBYCAD_SCRATCH_PMR 0
+#endif
+
+namespace hobbycad {
+namespace geometry {
+
+#if HOBBYCAD_SCRATCH_PMR
+
+/// Vector allocating from a ScratchArena (or the heap when default
+/// constructed)
+template<typename T>
+using ScratchVector = std::pmr::vector<T>;
+
+/// Scoped allocation from the calling thread's scratch buffer.
+///
+/// Arenas nest: a kernel opens one on entry and passes it to the
+/// scratch containers it declares; kernels it calls open their own.
+/// Memory is released all at once when the arena is destroyed, and
+/// the buffer behind it stays with the thread for the next call.
+///
+/// @code
+///     ScratchArena arena;
+///     ScratchVector<Point2D> pts(arena.resource());
+/// @endcode
+class HOBBYCAD_EXPORT ScratchArena : public std::pmr::memory_resource {
+public:
+    ScratchArena();
+    ~ScratchArena() override;
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    /// Resource to construct scratch containers with
+    std::pmr::memory_resource* resource() { return this; }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    struct Overflow;
+
+    ScratchArena* m_parent = nullptr;   ///< Enclosing arena on this thread
+    std::size_t m_block = 0;            ///< Buffer position at construction
+    std::size_t m_offset = 0;
+    Overflow* m_overflow = nullptr;     ///< Heap blocks taken while nested
+    bool m_bypass = false;              ///< Opened with setScratchBypass(true)
+};
+
+#else
+
+template<typename T>
+using ScratchVector = std::vector<T>;
+
+/// Heap-backed stand-in used when the standard library has no
+/// <memory_resource>; resource() converts to any std::allocator.
+class HOBBYCAD_EXPORT ScratchArena {
+public:
+    struct Resource {
+        template<typename T>
+        operator std::allocator<T>() const { return std::allocator<T>(); }
+    };
+
+    ScratchArena() = default;
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    Resource resource() const { return Resource(); }
+};
+
+#endif
+
+/// Usage counters for the calling thread's scratch buffer
+struct ScratchStats {
+    std::size_t reservedBytes = 0;      ///< Buffer capacity kept by the thread
+    std::size_t usedBytes = 0;          ///< Currently allocated by open arenas
+    std::size_t peakUsedBytes = 0;      ///< High-water mark of usedBytes
+    std::size_t bufferAllocations = 0;  ///< Heap allocations made for scratch memory
+};
+
+/// Counters for the calling thread (all zero without pmr support)
+HOBBYCAD_EXPORT ScratchStats scratchStats();
+
+/// Make arenas opened from now on by the calling thread take every
+/// allocation from the heap instead of the thread's buffer.  Results
+/// do not change; each scratch container becomes its own heap block,
+/// which lets memory checkers see overruns the bump buffer would hide
+/// and gives tests a heap baseline to compare arena results with.
+/// Does nothing without pmr support, where arenas are the heap anyway.
+HOBBYCAD_EXPORT void setScratchBypass(bool bypass);
+
+}  // namespace geometry
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_GEOMETRY_SCRATCH_H
@@ -0,0 +1,204 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/geometry/spline.h — B-spline / NURBS curves
+// =====================================================================
+//
+//  Native 2D B-spline kernel shared by every consumer of spline
+//  geometry: entity queries, snapping, intersections, tessellation,
+//  export and B-rep edge building.  Curves may be rational (NURBS)
+//  and of any degree up to MAX_SPLINE_DEGREE.
+//
+//  A spline sketch entity is a Catmull-Rom curve through its points;
+//  fromCatmullRom() converts it exactly to a C1 cubic B-spline, so
+//  every consumer that goes through this kernel sees the same curve
+//  the canvas draws.
+//
+//  Each curve precomputes per-span bounding hulls (the bounding box
+//  of the span's poles, which contains the span by the convex hull
+//  property); the arc-length table is built on the first length
+//  query.  Closest-point, intersection and culling queries skip spans
+//  whose hull is out of reach, which keeps them fast on curves with
+//  thousands of spans.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_GEOMETRY_SPLINE_H
+#define HOBBYCAD_GEOMETRY_SPLINE_H
+
+#include "types.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace hobbycad {
+namespace geometry {
+
+/// Highest supported spline degree
+constexpr int MAX_SPLINE_DEGREE = 15;
+
+/// Point and derivatives of a curve at one parameter
+struct SplineDerivatives {
+    Point2D point;
+    Point2D first;                  ///< dC/dt
+    Point2D second;                 ///< d²C/dt²
+};
+
+/// A 2D B-spline or NURBS curve
+///
+/// The knot vector is stored flat (repeated knots appear repeatedly)
+/// and must hold poles + degree + 1 non-decreasing values.  The curve
+/// is defined on [knots[degree], knots[poles]].  An empty weight
+/// vector means a non-rational curve.
+///
+/// @code
+///     auto curve = geometry::BSplineCurve2D::fromCatmullRom(points);
+///     double t;
+///     Point2D p = curve.closestPoint(cursor, &t);
+///     Point2D mid = curve.point(curve.parameterAtLength(curve.length() / 2));
+/// @endcode
+class HOBBYCAD_EXPORT BSplineCurve2D {
+public:
+    BSplineCurve2D() = default;
+
+    /// @param degree Polynomial degree (1..MAX_SPLINE_DEGREE)
+    /// @param poles Control points
+    /// @param knots Flat knot vector (poles.size() + degree + 1 values)
+    /// @param weights Pole weights (empty, or one positive weight per pole)
+    BSplineCurve2D(int degree, std::vector<Point2D> poles,
+                   std::vector<double> knots,
+                   std::vector<double> weights = {});
+
+    /// Exact cubic B-spline of the Catmull-Rom curve through points
+    /// (uniform, tension 0.5, end points duplicated) — the curve the
+    /// sketch canvas draws for a spline entity.  Knot i is at point i.
+    static BSplineCurve2D fromCatmullRom(const Point2D* points, std::size_t count);
+    static BSplineCurve2D fromCatmullRom(const std::vector<Point2D>& points);
+
+    /// True if the curve has a consistent definition
+    bool isValid() const { return m_valid; }
+
+    int degree() const { return m_degree; }
+    bool isRational() const { return !m_weights.empty(); }
+    const std::vector<Point2D>& poles() const { return m_poles; }
+    const std::vector<double>& knots() const { return m_knots; }
+    const std::vector<double>& weights() const { return m_weights; }
+
+    double firstParameter() const;
+    double lastParameter() const;
+
+    // ---- Evaluation ----
+
+    /// Point at a parameter (de Boor); parameters outside the domain
+    /// are clamped
+    Point2D point(double t) const;
+
+    /// Point, first and second derivative at a parameter
+    SplineDerivatives derivatives(double t) const;
+
+    /// Unit tangent at a parameter (zero vector where the curve stalls)
+    Point2D tangent(double t) const;
+
+    // ---- Arc length ----
+
+    /// Total arc length
+    double length() const;
+
+    /// Arc length from the start of the curve to a parameter
+    double lengthAt(double t) const;
+
+    /// Parameter at an arc length from the start (clamped to the curve)
+    double parameterAtLength(double s) const;
+
+    // ---- Bounds ----
+
+    /// Bounding box of the poles; contains the curve
+    BoundingBox boundingBox() const;
+
+    /// Number of non-empty knot spans
+    int spanCount() const { return static_cast<int>(m_spans.size()); }
+
+    /// Parameter range of a span
+    void spanRange(int span, double* t0, double* t1) const;
+
+    /// Bounding box of a span's poles; contains the span
+    const BoundingBox& spanBounds(int span) const { return m_spans[span].bounds; }
+
+    /// Spans whose bounding box intersects a region, ascending.  Uses
+    /// a tree of span boxes, so the cost grows with the spans found
+    /// rather than the curve size.
+    std::vector<int> spansInBox(const BoundingBox& region) const;
+
+    // ---- Queries ----
+
+    /// Closest point on the curve
+    /// @param parameter Optional output for the parameter of the result
+    Point2D closestPoint(const Point2D& p, double* parameter = nullptr) const;
+
+    /// Distance from a point to the curve
+    double distanceTo(const Point2D& p) const;
+
+    /// Parameters where the curve crosses a line segment, ascending
+    std::vector<double> intersectSegment(const Point2D& a, const Point2D& b) const;
+
+    /// Parameters where the curve crosses a circle, ascending
+    std::vector<double> intersectCircle(const Point2D& center, double radius) const;
+
+    /// Polyline within tolerance of the curve (first and last points
+    /// are the curve's end points)
+    std::vector<Point2D> tessellate(double tolerance) const;
+
+    // ---- Modification ----
+
+    /// Insert a knot (Boehm's algorithm); the curve's shape is unchanged
+    /// @param times Number of insertions; capped so the knot's
+    ///              multiplicity does not exceed the degree
+    /// @return Number of insertions made
+    int insertKnot(double t, int times = 1);
+
+    /// Bézier pole sets of the spans of a non-rational curve, in order;
+    /// empty for rational curves
+    std::vector<std::vector<Point2D>> bezierSegments() const;
+
+    /// Copy transformed by an affine transform (poles are transformed)
+    BSplineCurve2D transformed(const Transform2D& t) const;
+
+    /// Distinct knots and their multiplicities (the form OpenCASCADE
+    /// and most file formats expect)
+    void knotMultiplicities(std::vector<double>* values, std::vector<int>* mults) const;
+
+    /// Heap bytes held by the curve and its tables
+    std::size_t memoryUsage() const;
+
+private:
+    struct Span {
+        int index = 0;              ///< Knot index k with knots[k] < knots[k+1]
+        BoundingBox bounds;         ///< Bounding box of poles k-degree..k
+    };
+
+    void rebuild();
+    SplineDerivatives evaluate(double t, int order) const;
+    int findSpan(double t) const;
+    int spanOfParameter(double t) const;
+    double arcLength(double t0, double t1) const;
+    const std::vector<double>& lengthTable() const;
+    const BoundingBox& hull(int node) const;
+    double refineClosest(const Point2D& p, double lo, double hi, double t) const;
+
+    int m_degree = 0;
+    std::vector<Point2D> m_poles;
+    std::vector<double> m_knots;
+    std::vector<double> m_weights;
+    std::vector<Span> m_spans;
+    std::vector<BoundingBox> m_hulls;   ///< Inner nodes of the span box tree (root = 1)
+    int m_leafBase = 0;                 ///< Tree node of span 0
+    mutable std::shared_ptr<const std::vector<double>> m_lengths;  ///< Arc length at each span start, then total
+    bool m_valid = false;
+};
+
+}  // namespace geometry
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_GEOMETRY_SPLINE_H
@@ -0,0 +1,188 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/history.h — Project-level undo/redo
+// =====================================================================
+//
+//  Feature-level command history for a whole project: bodies,
+//  sketches and the feature timeline.  Each step records the model
+//  state after an operation, but states share everything the
+//  operation left alone — bodies by TopoDS_Shape handle and sketches
+//  by pointer — so a step costs only what it changed, not the size of
+//  the project.  Memory held for undo and redo is accounted under
+//  memory::Tag::UndoHistory and kept within a configurable budget by
+//  dropping the oldest steps.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_HISTORY_H
+#define HOBBYCAD_HISTORY_H
+
+#include "core.h"
+#include "memory.h"
+#include "project.h"
+
+#include <TopoDS_Shape.hxx>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hobbycad {
+namespace history {
+
+// =====================================================================
+//  Model State
+// =====================================================================
+
+/// A sketch as recorded in the history.  The data is immutable once
+/// recorded; a sketch that was not edited keeps the same pointer from
+/// step to step and is stored once.
+struct SketchState {
+    int featureId = 0;                          ///< Timeline feature ID
+    std::shared_ptr<const SketchData> data;
+};
+
+/// Everything an undo step restores.  Copying a state copies handles,
+/// not geometry: unchanged bodies share their TShape with the states
+/// before and after them.
+struct ModelState {
+    std::vector<TopoDS_Shape> bodies;     ///< Solid bodies in display order
+    std::vector<SketchState> sketches;    ///< Sketches in timeline order
+    std::vector<FeatureData> features;    ///< Timeline after the Origin
+    int nextFeatureId = 1;                ///< Next ID to hand out
+};
+
+/// Memory held by a history
+struct HistoryMemory {
+    std::int64_t liveBytes = 0;      ///< Bodies and sketches of the current state
+    std::int64_t retainedBytes = 0;  ///< Held only for undo and redo (charged to UndoHistory)
+    int bodies = 0;                  ///< Distinct bodies over all steps
+    int sketches = 0;                ///< Distinct sketch versions over all steps
+    int steps = 0;                   ///< Recorded states, including the current one
+};
+
+// =====================================================================
+//  Project History
+// =====================================================================
+
+/// Linear undo/redo over model states
+class HOBBYCAD_EXPORT ProjectHistory {
+public:
+    /// Default memory budget for undo and redo (256 MiB)
+    static constexpr std::int64_t kDefaultBudget = std::int64_t(256) << 20;
+
+    /// Constructor with a memory budget (0 = unlimited) and step limit
+    explicit ProjectHistory(std::int64_t memoryBudget = kDefaultBudget, int maxSteps = 100);
+
+    ProjectHistory(const ProjectHistory&) = delete;
+    ProjectHistory& operator=(const ProjectHistory&) = delete;
+
+    /// Forget all steps and start from a state (e.g. a loaded project).
+    /// The new state is clean.
+    void reset(const ModelState& state);
+
+    /// Record the state after an operation.  Clears the redo steps and
+    /// drops the oldest undo steps beyond the step limit or budget.
+    void record(const std::string& description, const ModelState& state);
+
+    /// The state at the history cursor
+    const ModelState& current() const;
+
+    /// Check if undo is available
+    bool canUndo() const { return m_cursor > 0; }
+
+    /// Check if redo is available
+    bool canRedo() const { return m_cursor + 1 < static_cast<int>(m_steps.size()); }
+
+    /// Get the number of available undo levels
+    int undoLevels() const { return m_cursor; }
+
+    /// Get the number of available redo levels
+    int redoLevels() const { return static_cast<int>(m_steps.size()) - 1 - m_cursor; }
+
+    /// Step back one operation
+    /// @return The state to restore, or nullptr if there is nothing to undo
+    const ModelState* undo();
+
+    /// Step forward one operation
+    /// @return The state to restore, or nullptr if there is nothing to redo
+    const ModelState* redo();
+
+    /// Get the description of the next undo operation
+    std::string undoDescription() const;
+
+    /// Get the description of the next redo operation
+    std::string redoDescription() const;
+
+    /// Get the memory budget for undo and redo (0 = unlimited)
+    std::int64_t memoryBudget() const { return m_budget; }
+
+    /// Set the memory budget.  A lower budget drops the oldest undo
+    /// steps first, then the farthest redo steps.  A single operation
+    /// that retains more than the budget cannot be undone.
+    void setMemoryBudget(std::int64_t bytes);
+
+    /// Get the maximum number of undo levels
+    int maxSteps() const { return m_maxSteps; }
+
+    /// Set the maximum number of undo levels
+    void setMaxSteps(int maxSteps);
+
+    /// Memory held by the current state and by the undo/redo steps.
+    /// A face shared between two different bodies is counted with
+    /// each, so the figures are an upper bound.
+    HistoryMemory memoryUsage() const;
+
+    /// Check if the cursor is at the state marked clean
+    bool isClean() const { return m_cleanIndex == m_cursor; }
+
+    /// Mark the current state clean (e.g. after save)
+    void markClean() { m_cleanIndex = m_cursor; }
+
+private:
+    struct Step {
+        std::string description;       ///< Operation that led to this state
+        ModelState state;
+        std::int64_t overheadBytes = 0;  ///< Handles, feature records and text
+    };
+
+    /// Reference-counted body or sketch, sized once when first recorded
+    struct Shared {
+        int refs = 0;
+        std::int64_t bytes = 0;
+    };
+
+    std::deque<Step> m_steps;
+    int m_cursor = 0;
+    int m_cleanIndex = 0;
+    std::int64_t m_budget = kDefaultBudget;
+    int m_maxSteps = 100;
+
+    std::unordered_map<const void*, Shared> m_bodies;    ///< Keyed by TShape
+    std::unordered_map<const void*, Shared> m_sketches;  ///< Keyed by SketchData
+    std::int64_t m_sharedBytes = 0;     ///< Distinct bodies and sketches over all steps
+    std::int64_t m_overheadBytes = 0;   ///< Step overhead over all steps
+
+    // Memory accounting: bytes retained beyond the current state
+    memory::Charge m_charge{memory::Tag::UndoHistory};
+
+    void append(const std::string& description, const ModelState& state);
+    void dropFront();
+    void dropBack();
+    void acquire(const ModelState& state);
+    void release(const ModelState& state);
+    std::int64_t liveBytes() const;
+    std::int64_t retainedBytes() const;
+    void enforceLimits();
+    void updateCharge();
+};
+
+}  // namespace history
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_HISTORY_H
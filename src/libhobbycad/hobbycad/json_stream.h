@@ -0,0 +1,194 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/json_stream.h — Streaming JSON reader/writer
+// =====================================================================
+//
+//  A small event-driven JSON layer used by both the Qt and non-Qt
+//  builds for project files, parameters and background images.
+//  Values are written straight to a text buffer and read straight
+//  into the caller's structures, so no intermediate document tree
+//  (QJsonObject / nlohmann::json) is ever built.
+//
+//  Reading follows the usual pull pattern:
+//
+//      JsonReader r(text);
+//      std::string key;
+//      if (r.beginObject()) {
+//          while (r.nextKey(key)) {
+//              if (key == "name") data.name = r.readString();
+//              else r.skipValue();
+//          }
+//      }
+//      if (!r.ok()) ... r.errorMessage()
+//
+//  Typed reads are lenient in the same way QJsonValue::toX(default)
+//  is: a value of the wrong type is skipped and the default returned.
+//  Numbers are formatted and parsed independently of the C locale.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_JSON_STREAM_H
+#define HOBBYCAD_JSON_STREAM_H
+
+#include "core.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hobbycad {
+
+// =====================================================================
+//  Writer
+// =====================================================================
+
+/// Streaming JSON writer.  Commas, indentation and string escaping
+/// are handled automatically; the caller only emits structure and
+/// values in order.
+class HOBBYCAD_EXPORT JsonWriter {
+public:
+    /// @param indent Spaces per nesting level; 0 writes compact JSON
+    explicit JsonWriter(int indent = 4);
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    /// Write an object key.  Must be followed by exactly one value.
+    JsonWriter& key(const char* name);
+    JsonWriter& key(const std::string& name);
+
+    void value(const std::string& s);
+    void value(const char* s);
+    void value(double d);
+    void value(int i);
+    void value(bool b);
+    void null();
+
+    /// Insert already-serialized JSON text as a single value
+    void rawValue(const std::string& json);
+
+    /// Shorthand for key(name).value(v)
+    template <typename T>
+    void field(const char* name, const T& v)
+    {
+        key(name);
+        value(v);
+    }
+
+    /// Written text so far
+    const std::string& text() const { return m_out; }
+
+    /// Move the written text out, leaving the writer empty
+    std::string take();
+
+private:
+    void beforeValue();
+    void newline();
+    void writeString(const char* s, size_t n);
+
+    std::string m_out;
+    std::vector<bool> m_hasItems;  ///< Per open container: any item written yet
+    int m_indent;
+    bool m_afterKey = false;
+};
+
+// =====================================================================
+//  Reader
+// =====================================================================
+
+/// Pull-style JSON reader over an in-memory buffer.  The buffer must
+/// outlive the reader.
+class HOBBYCAD_EXPORT JsonReader {
+public:
+    enum class Token {
+        BeginObject,
+        EndObject,
+        BeginArray,
+        EndArray,
+        String,
+        Number,
+        Bool,
+        Null,
+        End,     ///< End of input
+        Invalid  ///< Malformed input (see errorMessage())
+    };
+
+    JsonReader(const char* data, size_t size);
+    explicit JsonReader(const std::string& text);
+    explicit JsonReader(std::string&&) = delete;  ///< Would dangle
+
+    /// Type of the next value without consuming it
+    Token peek();
+
+    /// Consume '{'.  Returns false (and skips the value) if the next
+    /// value is not an object.
+    bool beginObject();
+
+    /// Read the next key of the current object.  Returns false once
+    /// the closing '}' has been consumed, or on error.
+    bool nextKey(std::string& key);
+
+    /// Consume '['.  Returns false (and skips the value) if the next
+    /// value is not an array.
+    bool beginArray();
+
+    /// Advance to the next element of the current array.  Returns
+    /// false once the closing ']' has been consumed, or on error.
+    bool nextElement();
+
+    std::string readString(const std::string& defaultValue = {});
+    double readDouble(double defaultValue = 0.0);
+    int readInt(int defaultValue = 0);
+    bool readBool(bool defaultValue = false);
+
+    /// Skip the next value, including any nested content.  If raw is
+    /// non-null it receives the value's exact source text.
+    bool skipValue(std::string* raw = nullptr);
+
+    /// Check that only whitespace remains after the top-level value
+    bool atEnd();
+
+    /// False once malformed input has been seen
+    bool ok() const { return m_error.empty(); }
+    const std::string& errorMessage() const { return m_error; }
+
+private:
+    void skipWhitespace();
+    bool expect(char c);
+    bool parseString(std::string* out);
+    bool parseNumber(double* out);
+    bool parseLiteral(const char* word);
+    void fail(const char* what);
+
+    /// Handles the comma between container items
+    bool consumeSeparator(char closer);
+
+    const char* m_begin;
+    const char* m_p;
+    const char* m_end;
+    std::vector<bool> m_first;  ///< Per open container: next item is the first
+    std::string m_error;
+};
+
+// =====================================================================
+//  File helpers
+// =====================================================================
+
+/// Read a whole file (UTF-8 path) into a string.
+/// Returns false and sets errorMsg on failure.
+HOBBYCAD_EXPORT bool readTextFile(const std::string& path, std::string& contents,
+                                  std::string* errorMsg = nullptr);
+
+/// Write a string to a file (UTF-8 path), replacing its contents.
+/// Returns false and sets errorMsg on failure.
+HOBBYCAD_EXPORT bool writeTextFile(const std::string& path, const std::string& contents,
+                                   std::string* errorMsg = nullptr);
+
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_JSON_STREAM_H
@@ -0,0 +1,233 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/memory.h — Memory accounting
+// =====================================================================
+//
+//  Lightweight byte accounting for the large owners in a session:
+//  project bodies, sketch entities, undo history, background images
+//  and tessellations.  Owners hold a Charge that adds their estimated
+//  size to a tagged counter; the counters keep a high-water mark so a
+//  workload can be checked against a budget afterwards.
+//
+//  Sizes are estimates of the heap memory behind each owner, not exact
+//  allocator figures.  Builds configured with HOBBYCAD_MEMORY_HOOKS
+//  also replace the global operator new/delete and count every C++
+//  heap allocation in the process.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_MEMORY_H
+#define HOBBYCAD_MEMORY_H
+
+#include "core.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class TopoDS_Shape;
+
+namespace hobbycad {
+
+namespace sketch {
+struct BackgroundImage;
+struct Constraint;
+struct Entity;
+struct Group;
+}  // namespace sketch
+
+namespace memory {
+
+// =====================================================================
+//  Tags and Counters
+// =====================================================================
+
+/// Owner categories with their own byte counter
+enum class Tag {
+    ProjectBodies,      ///< B-rep geometry and topology of project shapes
+    SketchEntities,     ///< Sketch entities and constraints held by projects
+    UndoHistory,        ///< Commands kept by sketch undo/redo stacks
+    BackgroundImages,   ///< Embedded sketch background image data
+    Tessellations,      ///< Triangulations built for display
+    Count
+};
+
+/// Number of tags
+constexpr int kTagCount = static_cast<int>(Tag::Count);
+
+/// Short identifier used on the command line ("bodies", "undo", ...)
+HOBBYCAD_EXPORT const char* tagName(Tag tag);
+
+/// Human-readable name ("Project bodies", "Undo history", ...)
+HOBBYCAD_EXPORT const char* tagDisplayName(Tag tag);
+
+/// Look up a tag by its short identifier
+/// @return false if the name is unknown
+HOBBYCAD_EXPORT bool tagFromName(const std::string& name, Tag* tag);
+
+/// Counter state for one tag
+struct TagStats {
+    Tag tag = Tag::ProjectBodies;
+    std::int64_t bytes = 0;         ///< Currently charged
+    std::int64_t peakBytes = 0;     ///< High-water mark since start or resetPeaks()
+    std::int64_t owners = 0;        ///< Live Charge objects with this tag
+};
+
+/// Heap counters maintained by the optional operator new/delete hooks
+struct HeapStats {
+    bool enabled = false;           ///< Built with HOBBYCAD_MEMORY_HOOKS
+    std::int64_t bytes = 0;         ///< Bytes currently allocated
+    std::int64_t peakBytes = 0;
+    std::int64_t allocations = 0;   ///< Calls to operator new since start
+    std::int64_t deallocations = 0;
+};
+
+/// Resident memory of the whole process, as reported by the OS
+struct ProcessStats {
+    bool available = false;         ///< False on platforms without a query
+    std::int64_t residentBytes = 0;
+    std::int64_t peakResidentBytes = 0;
+};
+
+/// Snapshot of all counters
+struct Stats {
+    TagStats tags[kTagCount];
+    std::int64_t totalBytes = 0;        ///< Sum over all tags
+    std::int64_t peakTotalBytes = 0;    ///< High-water mark of the sum
+    HeapStats heap;
+    ProcessStats process;
+};
+
+/// Add (or with a negative value, remove) bytes charged to a tag.
+/// Thread-safe; prefer a Charge, which undoes itself on destruction.
+HOBBYCAD_EXPORT void adjust(Tag tag, std::int64_t bytes);
+
+/// Current state of one tag
+HOBBYCAD_EXPORT TagStats tagStats(Tag tag);
+
+/// Current state of all counters, the heap hooks and the process
+HOBBYCAD_EXPORT Stats snapshot();
+
+/// Restart peak tracking from the current values
+HOBBYCAD_EXPORT void resetPeaks();
+
+/// Heap counters (enabled is false without HOBBYCAD_MEMORY_HOOKS)
+HOBBYCAD_EXPORT HeapStats heapStats();
+
+/// Resident set size of the process
+HOBBYCAD_EXPORT ProcessStats processStats();
+
+// =====================================================================
+//  Charge
+// =====================================================================
+
+/// Bytes charged to a tag for the lifetime of the object.  Owners keep
+/// one as a member and set() it when their contents change; copying
+/// the owner charges the copy again and destroying it releases the
+/// charge.
+class HOBBYCAD_EXPORT Charge {
+public:
+    explicit Charge(Tag tag, std::int64_t bytes = 0);
+    Charge(const Charge& other);
+    Charge(Charge&& other) noexcept;
+    Charge& operator=(const Charge& other);
+    Charge& operator=(Charge&& other) noexcept;
+    ~Charge();
+
+    Tag tag() const { return m_tag; }
+    std::int64_t bytes() const { return m_bytes; }
+
+    /// Replace the charged size
+    void set(std::int64_t bytes);
+
+    /// Grow (or with a negative value, shrink) the charged size
+    void add(std::int64_t bytes) { set(m_bytes + bytes); }
+
+private:
+    Tag m_tag;
+    std::int64_t m_bytes = 0;
+};
+
+// =====================================================================
+//  Size Estimates
+// =====================================================================
+
+/// Heap bytes behind a string (zero while it fits the inline buffer)
+inline std::int64_t heapBytes(const std::string& s)
+{
+    const char* data = s.data();
+    const char* self = reinterpret_cast<const char*>(&s);
+    if (data >= self && data < self + sizeof(std::string)) return 0;
+    return static_cast<std::int64_t>(s.capacity()) + 1;
+}
+
+/// Heap bytes behind a vector of trivially sized elements
+template<typename T>
+std::int64_t heapBytes(const std::vector<T>& v)
+{
+    return static_cast<std::int64_t>(v.capacity() * sizeof(T));
+}
+
+/// Estimated footprint of a B-rep shape.  Shared sub-shapes, curves,
+/// surfaces and triangulations are counted once.
+struct ShapeFootprint {
+    std::int64_t geometryBytes = 0;      ///< Topology, curves and surfaces
+    std::int64_t tessellationBytes = 0;  ///< Triangulations and edge polygons
+};
+
+HOBBYCAD_EXPORT ShapeFootprint shapeFootprint(const TopoDS_Shape& shape);
+
+/// Footprint of several shapes, counting data they share once
+HOBBYCAD_EXPORT ShapeFootprint shapeFootprint(const std::vector<TopoDS_Shape>& shapes);
+
+/// Estimated size of sketch objects, including the object itself
+HOBBYCAD_EXPORT std::int64_t footprint(const sketch::Entity& entity);
+HOBBYCAD_EXPORT std::int64_t footprint(const sketch::Constraint& constraint);
+HOBBYCAD_EXPORT std::int64_t footprint(const sketch::Group& group);
+
+/// Heap bytes held by a background image (embedded data and strings)
+HOBBYCAD_EXPORT std::int64_t footprint(const sketch::BackgroundImage& image);
+
+// =====================================================================
+//  Budgets
+// =====================================================================
+
+/// Upper bound on a peak counter.  The key is a tag name, "total" (sum
+/// of all tags), "heap" (hooked allocations) or "rss" (process).
+struct Budget {
+    std::string key;
+    std::int64_t limitBytes = 0;
+};
+
+/// A budget whose counter peaked above its limit
+struct BudgetViolation {
+    std::string key;
+    std::int64_t limitBytes = 0;
+    std::int64_t peakBytes = 0;
+};
+
+/// Parse a size such as "512", "64K", "1.5M" or "2G" (powers of 1024)
+/// @return false if the text is not a non-negative size
+HOBBYCAD_EXPORT bool parseByteSize(const std::string& text, std::int64_t* bytes);
+
+/// Format a size for display ("812 B", "4.2 KiB", "1.3 GiB")
+HOBBYCAD_EXPORT std::string formatBytes(std::int64_t bytes);
+
+/// Parse a "key=size" budget specification
+/// @return false (with a message) if the key or size is invalid
+HOBBYCAD_EXPORT bool parseBudget(const std::string& spec, Budget* budget,
+                                 std::string* errorMsg = nullptr);
+
+/// Check peak counters against budgets.  Budgets on counters that are
+/// unavailable in this build ("heap" without hooks, "rss" without an OS
+/// query) never fail.
+HOBBYCAD_EXPORT std::vector<BudgetViolation> checkBudgets(
+    const Stats& stats,
+    const std::vector<Budget>& budgets);
+
+}  // namespace memory
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_MEMORY_H
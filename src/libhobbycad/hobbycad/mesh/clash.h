@@ -0,0 +1,187 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/mesh/clash.h — Clash and clearance detection
+// =====================================================================
+//
+//  Finds bodies that interfere, touch or come closer than a clearance.
+//  A bounding-volume hierarchy over the body boxes picks the candidate
+//  pairs; each pair is then checked in parallel against hierarchies
+//  over its triangles: crossing triangles, minimum distance, and
+//  containment.  Interfering pairs report an estimate of the shared
+//  volume, the others their minimum distance and closest points.
+//
+//  The B-rep front end (brep/clash.h) uses the same hierarchy over face
+//  boxes and can check pairs on the exact geometry instead.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_MESH_CLASH_H
+#define HOBBYCAD_MESH_CLASH_H
+
+#include "types.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hobbycad {
+namespace mesh {
+
+// =====================================================================
+//  Bounding-Volume Hierarchy
+// =====================================================================
+
+/// Axis-aligned box; empty until the first add()
+struct HOBBYCAD_EXPORT MeshBox {
+    MeshPoint min{1e300, 1e300, 1e300};
+    MeshPoint max{-1e300, -1e300, -1e300};
+
+    bool isEmpty() const { return min.x > max.x; }
+    void add(const MeshPoint& p);
+    void add(const MeshBox& b);
+
+    /// True if the boxes are no further apart than margin on every axis
+    bool overlaps(const MeshBox& o, double margin = 0.0) const;
+
+    /// Distance between the boxes (0 if they overlap)
+    double distance(const MeshBox& o) const;
+};
+
+/// Binary hierarchy over a set of boxes, split at the median of the
+/// longest axis.  Nodes are stored flat; node 0 is the root.
+class HOBBYCAD_EXPORT BoxTree {
+public:
+    struct Node {
+        MeshBox box;
+        int left = -1;       ///< Child nodes (-1 in a leaf)
+        int right = -1;
+        int first = 0;       ///< Leaf items are items()[first, first + count)
+        int count = 0;
+
+        bool isLeaf() const { return left < 0; }
+    };
+
+    BoxTree() = default;
+    explicit BoxTree(const std::vector<MeshBox>& boxes) { build(boxes); }
+
+    /// Rebuild over the given boxes; item i is boxes[i]
+    void build(const std::vector<MeshBox>& boxes);
+
+    bool isEmpty() const { return m_nodes.empty(); }
+    const std::vector<Node>& nodes() const { return m_nodes; }
+    const std::vector<int>& items() const { return m_items; }
+    const MeshBox& itemBox(int item) const { return m_boxes[item]; }
+    MeshBox bounds() const { return m_nodes.empty() ? MeshBox() : m_nodes.front().box; }
+
+    /// Pairs of items (i < j) whose boxes are within margin of each other
+    std::vector<std::pair<int, int>> selfPairs(double margin = 0.0) const;
+
+    /// Pairs (item here, item in other) whose boxes are within margin
+    std::vector<std::pair<int, int>> pairs(const BoxTree& other, double margin = 0.0) const;
+
+private:
+    std::vector<MeshBox> m_boxes;
+    std::vector<Node> m_nodes;
+    std::vector<int> m_items;
+};
+
+/// Hierarchy over the triangle boxes of a mesh
+HOBBYCAD_EXPORT BoxTree triangleTree(const TriangleMesh& mesh);
+
+// =====================================================================
+//  Pair Queries
+// =====================================================================
+
+/// Closest approach of two meshes
+struct MeshProximity {
+    bool intersecting = false;  ///< Some triangles cross each other
+    double distance = -1.0;     ///< Minimum distance, -1 if beyond the search limit
+    MeshPoint pointA;           ///< Closest point on the first mesh
+    MeshPoint pointB;           ///< Closest point on the second mesh
+};
+
+/// Check two meshes for crossing triangles and find their minimum
+/// distance up to maxDistance.  Triangles that only touch within
+/// tolerance do not count as crossing.
+HOBBYCAD_EXPORT MeshProximity meshProximity(
+    const TriangleMesh& a, const BoxTree& treeA,
+    const TriangleMesh& b, const BoxTree& treeB,
+    double maxDistance, double tolerance = 1e-9);
+
+/// True if p lies inside the closed, outward-oriented mesh
+HOBBYCAD_EXPORT bool pointInside(const TriangleMesh& mesh, const BoxTree& tree,
+                                 const MeshPoint& p);
+
+/// Estimate the volume shared by two closed, outward-oriented meshes
+/// by casting a samples x samples grid of rays through the overlap of
+/// their boxes
+HOBBYCAD_EXPORT double interferenceVolume(
+    const TriangleMesh& a, const BoxTree& treeA,
+    const TriangleMesh& b, const BoxTree& treeB,
+    int samples = 32);
+
+// =====================================================================
+//  Clash Detection
+// =====================================================================
+
+/// How a pair of bodies clashes
+enum class ClashType {
+    Interference,  ///< The bodies share volume
+    Contact,       ///< The surfaces touch without sharing volume
+    Clearance      ///< Apart, but closer than the clearance
+};
+
+/// Lower-case name of a clash type ("interference", ...)
+HOBBYCAD_EXPORT const char* clashTypeName(ClashType type);
+
+/// Clash settings
+struct ClashOptions {
+    double clearance = 0.0;          ///< Report pairs closer than this (mm); 0 = touching only
+    double contactTolerance = 1e-4;  ///< Gaps and overlaps below this count as contact (mm)
+    bool computeVolumes = true;      ///< Estimate interference volumes
+    int volumeSamples = 32;          ///< Rays per side for volume estimates
+    bool parallel = true;            ///< Check pairs on OCCT's thread pool
+};
+
+/// One clashing pair of bodies
+struct ClashPair {
+    int bodyA = 0;                   ///< Index of the first body
+    int bodyB = 0;                   ///< Index of the second body (bodyA < bodyB)
+    ClashType type = ClashType::Interference;
+    double distance = 0.0;           ///< Minimum distance (0 for interference)
+    MeshPoint pointA;                ///< Closest or deepest point on bodyA
+    MeshPoint pointB;                ///< Closest or deepest point on bodyB
+    double volume = 0.0;             ///< Shared volume, interference only (mm^3)
+};
+
+/// Result of findClashes()
+struct ClashReport {
+    bool success = false;
+    std::vector<ClashPair> clashes;  ///< Sorted by bodyA, then bodyB
+    int bodies = 0;
+    int candidatePairs = 0;          ///< Pairs left by the broad phase
+    double milliseconds = 0.0;
+    std::string errorMessage;
+
+    int count(ClashType type) const {
+        int n = 0;
+        for (const ClashPair& c : clashes) n += c.type == type;
+        return n;
+    }
+};
+
+/// Find interfering, touching and too-close pairs among closed,
+/// outward-oriented meshes (as produced by fromShape() or repair())
+///
+/// A pair interferes when triangles cross, when one mesh lies inside
+/// the other, or when touching surfaces enclose a shared volume
+/// thicker than contactTolerance (e.g. faces lying flush in a slot).
+HOBBYCAD_EXPORT ClashReport findClashes(const std::vector<TriangleMesh>& bodies,
+                                        const ClashOptions& options = {});
+
+}  // namespace mesh
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_MESH_CLASH_H
@@ -0,0 +1,80 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/mesh/decimate.h — Triangle mesh decimation
+// =====================================================================
+//
+//  Reduces oversized meshes (scans, fine STL exports) by repeatedly
+//  collapsing the edge whose removal changes the surface least, as
+//  measured by Garland–Heckbert quadric error metrics.  Open edges,
+//  sharp feature edges and their corners stay in place.  Very large
+//  inputs are split into spatial partitions that are decimated in
+//  parallel with their shared vertices locked, then a final pass over
+//  the merged mesh removes the seams.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_MESH_DECIMATE_H
+#define HOBBYCAD_MESH_DECIMATE_H
+
+#include "types.h"
+
+#include <string>
+
+namespace hobbycad {
+namespace mesh {
+
+// =====================================================================
+//  Options and Results
+// =====================================================================
+
+/// Decimation settings.  At least one of the triangle budget and the
+/// error bound must be set; with both, decimation stops at whichever
+/// is reached first.
+struct DecimateOptions {
+    int targetTriangles = 0;        ///< Triangle budget (0 = use targetRatio)
+    double targetRatio = 0.0;       ///< Fraction of the input to keep (0 = no budget)
+
+    /// Largest allowed quadric error, as a distance in model units
+    /// (0 = unbounded)
+    double maxError = 0.0;
+
+    bool preserveBoundary = true;   ///< Keep open edges and their corners in place
+    bool preserveFeatures = true;   ///< Keep sharp edges and their corners in place
+    double featureAngle = 30.0;     ///< Dihedral angle (degrees) that makes an edge sharp
+
+    /// Inputs larger than this are split into partitions of about this
+    /// many triangles, decimated in parallel
+    int partitionTriangles = 100000;
+    bool parallel = true;           ///< Use OCCT's thread pool for partitions
+};
+
+/// Result of a decimation
+struct DecimateResult {
+    bool success = false;
+    std::string errorMessage;
+    TriangleMesh mesh;
+    int inputTriangles = 0;
+    int outputTriangles = 0;
+    double maxError = 0.0;          ///< Largest quadric error accepted (model units)
+    int partitions = 1;             ///< Partitions decimated in parallel
+    double milliseconds = 0.0;
+};
+
+// =====================================================================
+//  Decimation Functions
+// =====================================================================
+
+/// Decimate a mesh.  Coincident vertices are welded first, so raw STL
+/// triangle soup is accepted.  Collapses that would make the mesh
+/// non-manifold or fold a triangle over are skipped, so a closed
+/// manifold input stays closed and manifold.
+HOBBYCAD_EXPORT DecimateResult decimate(
+    const TriangleMesh& mesh,
+    const DecimateOptions& options = DecimateOptions{});
+
+}  // namespace mesh
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_MESH_DECIMATE_H
@@ -0,0 +1,120 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/mesh/repair.h — Triangle mesh repair
+// =====================================================================
+//
+//  Heals scanned and third-party meshes before they reach sewing and
+//  booleans.  The pipeline welds coincident vertices, removes
+//  degenerate, duplicate and non-manifold triangles, splits the mesh
+//  into connected components and then, for every component in
+//  parallel, makes the orientation consistent, cuts out
+//  self-intersecting triangles and fills the holes left behind.
+//  The result is a closed, consistently oriented mesh wherever the
+//  input allows it, plus a summary of the defects found.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_MESH_REPAIR_H
+#define HOBBYCAD_MESH_REPAIR_H
+
+#include "types.h"
+
+#include <string>
+#include <vector>
+
+namespace hobbycad {
+namespace mesh {
+
+// =====================================================================
+//  Options and Results
+// =====================================================================
+
+/// Repair settings
+struct RepairOptions {
+    /// Distance below which vertices are merged; 0 uses 1e-6 of the
+    /// bounding-box diagonal
+    double weldTolerance = 0.0;
+
+    bool fixOrientation = true;          ///< Make neighbouring triangles agree, normals outward
+    bool removeSelfIntersections = true; ///< Cut out intersecting triangles and refill
+    int selfIntersectionPasses = 3;      ///< Cut/refill rounds, each cutting a wider region
+
+    bool fillHoles = true;
+    int maxHoleEdges = 0;                ///< Leave larger holes open (0 = fill all)
+
+    int minComponentTriangles = 0;       ///< Drop smaller components (e.g. scan debris)
+    bool keepLargestComponentOnly = false;
+
+    bool parallel = true;                ///< Process components on OCCT's thread pool
+};
+
+/// Defects found (and fixed) by analyze() or repair()
+struct DefectSummary {
+    int inputVertices = 0;
+    int inputTriangles = 0;
+
+    int weldedVertices = 0;              ///< Coincident vertices merged
+    int degenerateTriangles = 0;         ///< Zero-area or collapsed triangles
+    int duplicateTriangles = 0;          ///< Triangles repeating another's vertices
+    int nonManifoldEdges = 0;            ///< Edges shared by more than two triangles
+    int nonManifoldTriangles = 0;        ///< Triangles removed to make those edges manifold
+    int components = 0;                  ///< Connected components (after cleanup)
+    int removedComponents = 0;           ///< Components dropped by size filters
+    int flippedTriangles = 0;            ///< Triangles reoriented
+    int selfIntersectingTriangles = 0;   ///< Triangles crossing another triangle
+    int holes = 0;                       ///< Boundary loops found
+    int filledHoles = 0;
+    int fillTriangles = 0;               ///< Triangles added by hole filling
+
+    int openEdges = 0;                   ///< Boundary edges left in the result
+    int outputVertices = 0;
+    int outputTriangles = 0;
+    bool watertight = false;             ///< Closed and manifold, every edge used twice
+
+    /// True if any defect was found
+    bool hasDefects() const {
+        return weldedVertices || degenerateTriangles || duplicateTriangles ||
+               nonManifoldEdges || flippedTriangles || selfIntersectingTriangles ||
+               holes || removedComponents;
+    }
+};
+
+/// Result of a repair
+struct RepairResult {
+    bool success = false;
+    std::string errorMessage;
+    TriangleMesh mesh;
+    DefectSummary summary;
+    double milliseconds = 0.0;
+};
+
+// =====================================================================
+//  Repair Functions
+// =====================================================================
+
+/// Inspect a mesh without changing it.  Vertices are welded with the
+/// options' tolerance first, as raw STL data repeats every vertex.
+/// The output* and watertight fields describe the welded input.
+HOBBYCAD_EXPORT DefectSummary analyze(
+    const TriangleMesh& mesh,
+    const RepairOptions& options = RepairOptions{});
+
+/// Run the full repair pipeline
+HOBBYCAD_EXPORT RepairResult repair(
+    const TriangleMesh& mesh,
+    const RepairOptions& options = RepairOptions{});
+
+/// Split a mesh into edge-connected components, largest first.
+/// Each component has its own compact vertex list.
+HOBBYCAD_EXPORT std::vector<TriangleMesh> splitComponents(const TriangleMesh& mesh);
+
+/// Merge coincident vertices (within tolerance; 0 = exact matches only)
+/// @return Number of vertices removed
+HOBBYCAD_EXPORT int weldVertices(TriangleMesh& mesh, double tolerance);
+
+}  // namespace mesh
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_MESH_REPAIR_H
@@ -0,0 +1,64 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/mesh/slice.h — Multi-plane mesh slicing
+// =====================================================================
+//
+//  Cuts a triangle mesh with a family of parallel planes and returns
+//  the section of each plane as polylines in plane coordinates.  Each
+//  triangle is binned once to the planes it spans, and the planes are
+//  then cut in parallel; segments are chained through the mesh edges
+//  they cross, so a closed mesh gives closed loops without any
+//  distance tolerance.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_MESH_SLICE_H
+#define HOBBYCAD_MESH_SLICE_H
+
+#include "types.h"
+#include "../types.h"
+
+#include <vector>
+
+namespace hobbycad {
+namespace mesh {
+
+/// A family of parallel planes
+struct SlicePlanes {
+    MeshPoint origin;                 ///< Point on the plane at offset 0
+    MeshPoint normal{0.0, 0.0, 1.0};  ///< Plane normal (need not be unit length)
+    std::vector<double> offsets;      ///< Plane positions along the normal from origin
+
+    /// count planes from first to last (inclusive) along normal
+    static SlicePlanes evenlySpaced(const MeshPoint& normal, double first, double last,
+                                    int count);
+};
+
+/// In-plane axes for a normal.  For planes normal to X, Y and Z the
+/// axes follow the YZ, XZ and XY sketch planes, whatever the sign of
+/// the normal, so slices map straight onto sketches.  Other normals
+/// take x along Z x normal and y along normal x x.
+HOBBYCAD_EXPORT void planeAxes(const MeshPoint& normal, MeshPoint& xDir, MeshPoint& yDir);
+
+/// Section of a mesh by one plane.  Points are in plane coordinates:
+/// world positions projected on the planeAxes() of the normal.
+struct MeshSection {
+    double offset = 0.0;
+    std::vector<std::vector<Point2D>> loops;   ///< Closed loops (last point not repeated)
+    std::vector<std::vector<Point2D>> chains;  ///< Open chains, where the mesh has holes
+};
+
+/// Cut a mesh by every plane of the family.  Coincident vertices are
+/// welded first, so meshes built face by face (fromShape()) chain
+/// across face boundaries.  Sections are returned in the order of
+/// planes.offsets.
+HOBBYCAD_EXPORT std::vector<MeshSection> sliceMesh(const TriangleMesh& mesh,
+                                                   const SlicePlanes& planes,
+                                                   bool parallel = true);
+
+}  // namespace mesh
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_MESH_SLICE_H
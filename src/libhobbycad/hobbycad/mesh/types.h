@@ -0,0 +1,101 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/mesh/types.h — Indexed triangle meshes
+// =====================================================================
+//
+//  A plain indexed triangle mesh used by the mesh processing functions
+//  (repair, decimation), plus conversions to and from OCCT's
+//  Poly_Triangulation and B-rep shapes.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_MESH_TYPES_H
+#define HOBBYCAD_MESH_TYPES_H
+
+#include "../core.h"
+
+#include <Poly_Triangulation.hxx>
+#include <TopoDS_Shape.hxx>
+
+#include <array>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace hobbycad {
+namespace mesh {
+
+// =====================================================================
+//  Mesh Types
+// =====================================================================
+
+/// 3D mesh vertex position
+struct MeshPoint {
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+
+    MeshPoint() = default;
+    MeshPoint(double x_, double y_, double z_) : x(x_), y(y_), z(z_) {}
+
+    MeshPoint operator+(const MeshPoint& o) const { return {x + o.x, y + o.y, z + o.z}; }
+    MeshPoint operator-(const MeshPoint& o) const { return {x - o.x, y - o.y, z - o.z}; }
+    MeshPoint operator*(double s) const { return {x * s, y * s, z * s}; }
+    double dot(const MeshPoint& o) const { return x * o.x + y * o.y + z * o.z; }
+    MeshPoint cross(const MeshPoint& o) const {
+        return {y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x};
+    }
+    double length() const { return std::sqrt(dot(*this)); }
+};
+
+/// Triangle as three vertex indices, counter-clockwise seen from outside
+using MeshTriangle = std::array<int, 3>;
+
+/// Indexed triangle mesh (0-based indices)
+struct HOBBYCAD_EXPORT TriangleMesh {
+    std::vector<MeshPoint> vertices;
+    std::vector<MeshTriangle> triangles;
+
+    bool isEmpty() const { return triangles.empty(); }
+    int vertexCount() const { return static_cast<int>(vertices.size()); }
+    int triangleCount() const { return static_cast<int>(triangles.size()); }
+
+    /// Bounding-box diagonal (0 for an empty mesh)
+    double diagonal() const;
+
+    /// Drop vertices no triangle references and renumber the rest
+    void removeUnusedVertices();
+};
+
+// =====================================================================
+//  Conversions
+// =====================================================================
+
+/// Copy a Poly_Triangulation (1-based) into an indexed mesh
+HOBBYCAD_EXPORT TriangleMesh fromTriangulation(const Handle(Poly_Triangulation)& triangulation);
+
+/// Collect the triangulations of all faces of a shape, with face
+/// locations and orientations applied.  Faces without a triangulation
+/// are skipped; mesh the shape first (BRepMesh_IncrementalMesh).
+HOBBYCAD_EXPORT TriangleMesh fromShape(const TopoDS_Shape& shape);
+
+/// Build a Poly_Triangulation from an indexed mesh (null if empty)
+HOBBYCAD_EXPORT Handle(Poly_Triangulation) toTriangulation(const TriangleMesh& mesh);
+
+/// Wrap a mesh as a single face carrying the triangulation, as STL
+/// import does.  Cheap, but the result has no B-rep edges.
+HOBBYCAD_EXPORT TopoDS_Shape toMeshFace(const TriangleMesh& mesh);
+
+/// Build planar B-rep faces that share vertices and edges by index, so
+/// no sewing pass is needed.  A closed, consistently oriented mesh (see
+/// mesh::repair) gives a solid; anything else gives a shell.
+/// @return Null shape (with errorMsg set) on failure
+HOBBYCAD_EXPORT TopoDS_Shape toSolid(const TriangleMesh& mesh,
+                                     std::string* errorMsg = nullptr);
+
+}  // namespace mesh
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_MESH_TYPES_H
@@ -34,14 +34,11 @@
 #include <unordered_set>
 #include <vector>
 
-#if HOBBYCAD_HAS_QT
-#include <QJsonObject>
-#else
-#include <nlohmann/json.hpp>
-#endif
-
 namespace hobbycad {
 
+class JsonReader;
+class JsonWriter;
+
 // =====================================================================
 //  ParametricValue — a value that may be a number, parameter, or formula
 // =====================================================================
@@ -215,19 +212,17 @@ public:
 
     // ---- Import/Export ----
 
-#if HOBBYCAD_HAS_QT
-    /// Export parameters to JSON
-    QJsonObject toJson() const;
+    /// Export parameters to JSON text
+    std::string toJson() const;
+
+    /// Import parameters from JSON text
+    bool fromJson(const std::string& json, std::string* errorMsg = nullptr);
 
-    /// Import parameters from JSON
-    bool fromJson(const QJsonObject& json, std::string* errorMsg = nullptr);
-#else
-    /// Export parameters to JSON (non-Qt fallback using nlohmann/json)
-    nlohmann::json toJson() const;
+    /// Write parameters as a JSON object into an open writer
+    void writeJson(JsonWriter& w) const;
 
-    /// Import parameters from JSON (non-Qt fallback using nlohmann/json)
-    bool fromJson(const nlohmann::json& json, std::string* errorMsg = nullptr);
-#endif
+    /// Read parameters from the next JSON object of a reader
+    bool readJson(JsonReader& r, std::string* errorMsg = nullptr);
 
 private:
     class Impl;
@@ -0,0 +1,41 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/png_writer.h — Dependency-free PNG encoder
+// =====================================================================
+//
+//  Encodes an RGBA ImageBuffer as PNG without Qt, zlib or stb.  Rows
+//  get an adaptive PNG filter and are compressed with a small LZ77 +
+//  fixed-Huffman deflate, which is plenty for rendered thumbnails
+//  (large flat areas).  Used by headless code paths such as the
+//  thumbnail renderer; the GUI keeps using QImage.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_PNG_WRITER_H
+#define HOBBYCAD_PNG_WRITER_H
+
+#include "core.h"
+#include "image_buffer.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hobbycad {
+
+/// Encode an image as an 8-bit RGBA PNG.
+/// Returns an empty vector if the image is invalid.
+HOBBYCAD_EXPORT std::vector<uint8_t> encodePng(const ImageBuffer& image);
+
+/// Encode an image and write it to a file.
+/// @return false (with errorMsg set) if the image is invalid or the
+///         file cannot be written
+HOBBYCAD_EXPORT bool writePng(const std::string& path,
+                              const ImageBuffer& image,
+                              std::string* errorMsg = nullptr);
+
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_PNG_WRITER_H
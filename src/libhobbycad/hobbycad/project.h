@@ -5,7 +5,7 @@
 //  A Project represents a .hcad directory structure containing:
 //    - Project manifest (<dirname>.hcad, e.g., my_widget/my_widget.hcad)
 //    - Geometry bodies (.brep files)
-//    - Sketches (JSON)
+//    - Sketches (compact binary, or JSON for interchange)
 //    - Parameters (JSON)
 //    - Feature tree (JSON)
 //    - Metadata (thumbnails, etc.)
@@ -22,6 +22,7 @@
 #define HOBBYCAD_PROJECT_H
 
 #include "core.h"
+#include "memory.h"
 #include "types.h"
 #include "sketch/background.h"
 #include "sketch/constraint.h"
@@ -40,6 +41,9 @@
 
 namespace hobbycad {
 
+class JsonReader;
+class JsonWriter;
+
 // ---- Sketch types ----
 
 // Use the canonical entity type from the sketch library
@@ -152,6 +156,12 @@ struct SketchData {
     sketch::BackgroundImage backgroundImage;  ///< Optional background image for tracing
 };
 
+/// On-disk encoding used when saving sketches
+enum class SketchFileFormat {
+    Binary,  ///< Compact binary encoding (sketches/sketch_NNN.hsk)
+    Json     ///< Human-readable JSON (sketches/sketch_NNN.json)
+};
+
 // ---- Parameter type ----
 
 /// A single parameter
@@ -311,6 +321,11 @@ public:
 
     // ---- File I/O ----
 
+    /// Encoding used for sketch files on the next save.  Loading
+    /// accepts either format regardless of this setting.
+    SketchFileFormat sketchFileFormat() const { return m_sketchFileFormat; }
+    void setSketchFileFormat(SketchFileFormat fmt) { m_sketchFileFormat = fmt; }
+
     /// Load a project from a .hcad directory
     /// Returns true on success
     bool load(const std::string& path, std::string* errorMsg = nullptr);
@@ -328,45 +343,32 @@ public:
 
     // ---- Static constants ----
 
-    static constexpr int FORMAT_VERSION = 1;
+    /// Newest manifest format this version reads.  Format 2 added
+    /// binary sketch files; it is written only when the project has
+    /// them, so JSON-only projects stay readable by format 1 readers.
+    static constexpr int FORMAT_VERSION = 2;
+    static constexpr int FORMAT_VERSION_JSON_SKETCHES = 1;
     static const char* HOBBYCAD_VERSION;
 
 private:
-#if HOBBYCAD_HAS_QT
-    // JSON serialization helpers (Qt path — QJsonDocument)
-    QJsonObject sketchToJson(const SketchData& sketch) const;
-    SketchData sketchFromJson(const QJsonObject& json) const;
-
-    QJsonObject parametersToJson() const;
-    void parametersFromJson(const QJsonObject& json);
+    // JSON serialization helpers (streaming, shared by all builds)
+    void writeSketchJson(JsonWriter& w, const SketchData& sketch) const;
+    SketchData readSketchJson(JsonReader& r) const;
 
-    QJsonObject featuresToJson() const;
-    void featuresFromJson(const QJsonObject& json);
+    void writeParametersJson(JsonWriter& w) const;
+    void readParametersJson(JsonReader& r);
 
-    QJsonObject constructionPlaneToJson(const ConstructionPlaneData& plane) const;
-    ConstructionPlaneData constructionPlaneFromJson(const QJsonObject& json) const;
+    void writeFeaturesJson(JsonWriter& w) const;
+    void readFeaturesJson(JsonReader& r);
 
-    QJsonObject manifestToJson() const;
-    bool manifestFromJson(const QJsonObject& json, std::string* errorMsg);
-#else
-    // JSON serialization helpers (non-Qt path — nlohmann/json)
-    nlohmann::json sketchToJson(const SketchData& sketch) const;
-    SketchData sketchFromJson(const nlohmann::json& json) const;
+    void writeConstructionPlaneJson(JsonWriter& w, const ConstructionPlaneData& plane) const;
+    ConstructionPlaneData readConstructionPlaneJson(JsonReader& r) const;
 
-    nlohmann::json parametersToJson() const;
-    void parametersFromJson(const nlohmann::json& json);
-
-    nlohmann::json featuresToJson() const;
-    void featuresFromJson(const nlohmann::json& json);
-
-    nlohmann::json constructionPlaneToJson(const ConstructionPlaneData& plane) const;
-    ConstructionPlaneData constructionPlaneFromJson(const nlohmann::json& json) const;
-
-    nlohmann::json manifestToJson() const;
-    bool manifestFromJson(const nlohmann::json& json, std::string* errorMsg);
-#endif
+    void writeManifestJson(JsonWriter& w) const;
+    bool readManifestJson(JsonReader& r, std::string* errorMsg);
 
     // File I/O helpers
+    std::string sketchFilePath(int index) const;
     bool saveManifest(const std::string& dir, std::string* errorMsg);
     bool saveGeometry(const std::string& dir, std::string* errorMsg);
     bool saveConstructionPlanes(const std::string& dir, std::string* errorMsg);
@@ -392,6 +394,7 @@ private:
     // Project state
     std::string m_projectPath;
     bool m_modified_flag = false;
+    SketchFileFormat m_sketchFileFormat = SketchFileFormat::Binary;
 
     // Content
     std::vector<TopoDS_Shape> m_shapes;
@@ -405,6 +408,13 @@ private:
     std::vector<std::string> m_geometryFiles;
     std::vector<std::string> m_constructionPlaneFiles;
     std::vector<std::string> m_sketchFiles;
+
+    // Memory accounting (see memory.h)
+    memory::Charge m_bodiesCharge{memory::Tag::ProjectBodies};
+    memory::Charge m_sketchCharge{memory::Tag::SketchEntities};
+    memory::Charge m_backgroundCharge{memory::Tag::BackgroundImages};
+
+    void chargeSketch(const SketchData& sketch, int sign);
 };
 
 }  // namespace hobbycad
@@ -0,0 +1,80 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/sketch/auto_constrain.h — Constraint inference
+// =====================================================================
+//
+//  Finds the geometric relations that already hold in a sketch, within
+//  tolerance, and turns them into a minimal set of constraints in one
+//  batch.  Meant for imported drawings, where constraining thousands of
+//  entities pair by pair is not practical.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_SKETCH_AUTO_CONSTRAIN_H
+#define HOBBYCAD_SKETCH_AUTO_CONSTRAIN_H
+
+#include "entity.h"
+#include "constraint.h"
+#include "../core.h"
+
+#include <string>
+#include <vector>
+
+namespace hobbycad {
+namespace sketch {
+
+/// Tolerances and relation kinds for inferConstraints()
+struct AutoConstrainOptions {
+    double tolerance = 1e-6;        ///< Largest position, length or radius mismatch (mm)
+    double angleTolerance = 1e-6;   ///< Largest direction mismatch (radians)
+    bool coincident = true;         ///< Line ends and points that meet
+    bool horizontalVertical = true; ///< Horizontal and vertical lines
+    bool parallel = true;           ///< Lines with the same direction
+    bool perpendicular = true;      ///< Directions at right angles
+    bool equal = true;              ///< Equal line lengths and equal radii
+    bool tangent = true;            ///< Lines and arcs ending tangent on an arc or circle
+    bool concentric = true;         ///< Circles and arcs sharing a center
+};
+
+/// Result of inferConstraints()
+struct AutoConstrainResult {
+    bool success = false;
+    std::vector<Constraint> constraints;  ///< New constraints, highest ranked first
+    int candidates = 0;                   ///< Relations found within tolerance
+    int redundant = 0;                    ///< Candidates implied by existing or accepted constraints
+    int dof = 0;                          ///< Degrees of freedom left with the new constraints
+    int unheldJoins = 0;                  ///< Line or arc ends meeting an arc end; no constraint holds these
+    std::string errorMessage;
+};
+
+/// Infer a minimal constraint set from the geometry of a sketch
+///
+/// Relations are found with a spatial grid (coincident points,
+/// tangency) and by sorting lines on direction and length and circles
+/// on radius, so the search is near-linear in the entity count.
+/// Candidates are ranked by kind (coincident, concentric,
+/// horizontal/vertical, tangent, perpendicular, parallel, equal) and
+/// then by how closely they hold.  Each is added to a NativeSolver
+/// system only when its equations raise the rank of the Jacobian, so
+/// the result never duplicates an existing constraint or another new
+/// one, and the sketch is never over-constrained.
+///
+/// Only the entities the solvers model are considered: points, lines,
+/// circles and arcs.  Arc ends are not solver points, so concentricity
+/// is expressed as Coincident centers (point index 0), and a line or
+/// arc that ends at an arc end gets no Coincident: the join is held by
+/// Tangent when the two are tangent there, and otherwise not at all.
+/// Such joins are counted in unheldJoins so callers can report them;
+/// solving may pull them apart.
+/// New constraint IDs follow the largest existing ID.
+HOBBYCAD_EXPORT AutoConstrainResult inferConstraints(
+    const std::vector<Entity>& entities,
+    const std::vector<Constraint>& existingConstraints = {},
+    const AutoConstrainOptions& options = {});
+
+}  // namespace sketch
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_SKETCH_AUTO_CONSTRAIN_H
@@ -0,0 +1,74 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/sketch/contour_fit.h — Contours from polylines
+// =====================================================================
+//
+//  Turns dense polylines, such as sections cut from tessellated or
+//  exact solids, back into sketch geometry: pieces are joined end to
+//  end into contours, each contour is replaced by the fewest lines,
+//  arcs and circles that stay within a tolerance, and closed contours
+//  are nested into outer boundaries and holes with their areas.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_SKETCH_CONTOUR_FIT_H
+#define HOBBYCAD_SKETCH_CONTOUR_FIT_H
+
+#include "entity.h"
+#include "../core.h"
+#include "../types.h"
+
+#include <vector>
+
+namespace hobbycad {
+namespace sketch {
+
+/// Tolerances for fitLinesAndArcs() and buildContours()
+struct ContourFitOptions {
+    double tolerance = 1e-3;           ///< Largest deviation of the fit, and join distance (mm)
+    bool recoverArcs = true;           ///< Fit arcs and circles, not only lines
+    int minArcSegments = 4;            ///< Fewest polyline segments one arc may replace
+    double maxArcSegmentAngle = 45.0;  ///< Largest angle one segment may span on an arc (degrees)
+};
+
+/// A joined and fitted contour
+struct Contour {
+    std::vector<Point2D> points;   ///< Polyline; for closed contours the last point is not repeated
+    std::vector<Entity> entities;  ///< Lines, arcs and circles in order along the contour
+    bool closed = false;
+    bool hole = false;             ///< Inside an odd number of other closed contours
+    double area = 0.0;             ///< Enclosed area of the fitted geometry, negative for holes
+};
+
+/// Replace a polyline by lines and arcs within options.tolerance.
+///
+/// Each step takes the longest line or arc (longest wins, lines on a
+/// tie) that starts where the previous one ended, so the result is
+/// connected and follows the polyline's direction.  A closed
+/// polyline on one circle becomes a Circle; arcs are stored with a
+/// positive sweep.  Entity IDs count up from firstId.
+HOBBYCAD_EXPORT std::vector<Entity> fitLinesAndArcs(
+    const std::vector<Point2D>& points,
+    bool closed,
+    const ContourFitOptions& options = {},
+    int firstId = 1);
+
+/// Join pieces end to end, fit them, and nest the closed contours.
+///
+/// Closed loops are taken as they are; open pieces are joined where
+/// their ends meet within options.tolerance, and become closed when a
+/// chain returns to its start.  Outer contours run counter-clockwise
+/// and holes clockwise.  Contours are returned outer boundaries first,
+/// largest first, then holes and open chains.
+HOBBYCAD_EXPORT std::vector<Contour> buildContours(
+    const std::vector<std::vector<Point2D>>& loops,
+    const std::vector<std::vector<Point2D>>& pieces,
+    const ContourFitOptions& options = {},
+    int firstId = 1);
+
+}  // namespace sketch
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_SKETCH_CONTOUR_FIT_H
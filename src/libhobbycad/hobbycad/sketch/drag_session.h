@@ -0,0 +1,108 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/sketch/drag_session.h — Interactive drag solving
+// =====================================================================
+//
+//  Keeps a constraint system alive for the length of one drag
+//  gesture.  The system is built and its sparsity pattern analyzed
+//  once when the drag begins; each mouse move then only moves the
+//  dragged points, warm-starts from the previous frame's solution
+//  and runs a capped number of Newton iterations.  Dragged points
+//  are marked as dragged parameters, so the solver moves the rest of
+//  the sketch to follow them rather than pulling them back.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_SKETCH_DRAG_SESSION_H
+#define HOBBYCAD_SKETCH_DRAG_SESSION_H
+
+#include "entity.h"
+#include "constraint.h"
+#include "solver.h"
+#include "../core.h"
+
+#include <vector>
+
+namespace hobbycad {
+namespace sketch {
+
+/// One point of one entity being dragged
+struct DraggedPoint {
+    int entityId = -1;
+    int pointIndex = 0;
+};
+
+/// Cost of the last drag step
+struct DragStepInfo {
+    int iterations = 0;           ///< Newton iterations run
+    double milliseconds = 0.0;    ///< Wall time of the step
+    bool converged = false;       ///< All equations within tolerance
+};
+
+/// Solver state for one drag gesture.
+///
+/// Example usage:
+/// @code
+///     DragSession drag;
+///     drag.begin(entities, constraints, {{lineId, 1}});
+///     // on each mouse move:
+///     drag.step({mousePos});
+///     drag.applyTo(entities);
+///     // on release:
+///     drag.end();
+/// @endcode
+///
+/// Always solves with the native backend (native_solver.h).  If the
+/// entities or constraints change structurally during the gesture,
+/// call begin() again.
+class HOBBYCAD_EXPORT DragSession {
+public:
+    DragSession();
+    ~DragSession();
+
+    DragSession(const DragSession&) = delete;
+    DragSession& operator=(const DragSession&) = delete;
+
+    /// Start a gesture: build the system and mark the dragged points
+    void begin(const std::vector<Entity>& entities,
+               const std::vector<Constraint>& constraints,
+               const std::vector<DraggedPoint>& dragged);
+
+    /// Finish the gesture and release the system
+    void end();
+
+    /// True between begin() and end()
+    bool isActive() const;
+
+    /// Move the dragged points to targets (in begin() order) and solve
+    /// from the previous step's solution.  Use applyTo() to read the
+    /// result.  On a capped, unconverged step the best iterate so far
+    /// is kept, so the next step continues from it.
+    SolveResult step(const std::vector<Point2D>& targets);
+
+    /// Reload every entity's current values (with the dragged points
+    /// already at their targets), solve, and write the result back.
+    /// For callers that edit geometry between steps themselves.
+    SolveResult step(std::vector<Entity>& entities);
+
+    /// Copy the current solution into entities
+    void applyTo(std::vector<Entity>& entities) const;
+
+    /// Maximum Newton iterations per step (default 8)
+    void setMaxIterationsPerStep(int iterations);
+    int maxIterationsPerStep() const;
+
+    /// Statistics for the last step
+    const DragStepInfo& lastStep() const;
+
+private:
+    class Impl;
+    Impl* m_impl;
+};
+
+}  // namespace sketch
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_SKETCH_DRAG_SESSION_H
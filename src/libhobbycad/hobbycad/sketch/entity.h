@@ -14,9 +14,11 @@
 #define HOBBYCAD_SKETCH_ENTITY_H
 
 #include "../core.h"
+#include "../geometry/spline.h"
 #include "../geometry/types.h"
 #include "../types.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -35,7 +37,7 @@ enum class EntityType {
     Parallelogram, ///< Parallelogram (4 corner points: p1, p2, p3, p4 where p4 = p1 + (p3 - p2))
     Circle,        ///< Circle (center + radius)
     Arc,           ///< Arc (center + radius + angles)
-    Spline,        ///< Catmull-Rom spline (control points)
+    Spline,        ///< Catmull-Rom spline through its points (see splineCurve())
     Polygon,       ///< Regular polygon (center + radius + sides)
     Slot,          ///< Slot: Linear (2 arc centers + radius) or Arc (arc center + start + end + radius)
     Ellipse,       ///< Ellipse (center + major/minor radii)
@@ -47,6 +49,8 @@ enum class EntityType {
 //  Sketch Entity
 // =====================================================================
 
+struct SplineCache;
+
 /// A single sketch entity (point, line, circle, etc.)
 ///
 /// This is the core data structure for sketch geometry. The GUI extends
@@ -104,6 +108,14 @@ struct HOBBYCAD_EXPORT Entity {
 
     /// Clone the entity with a new ID
     Entity clone(int newId) const;
+
+    /// Fitted curve of a spline entity, or nullptr for other types and
+    /// splines with fewer than two points.  Built on first use and kept
+    /// until the points change; copies of the entity share it.
+    std::shared_ptr<const geometry::BSplineCurve2D> splineCurve() const;
+
+    /// Cache behind splineCurve() (not part of the entity's value)
+    mutable std::shared_ptr<const SplineCache> splineCache;
 };
 
 // =====================================================================
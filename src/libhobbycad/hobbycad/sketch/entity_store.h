@@ -0,0 +1,274 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/sketch/entity_store.h — Compact entity store
+// =====================================================================
+//
+//  Struct-of-arrays storage for sketch entities.  Type tags, IDs and
+//  scalar parameters live in parallel arrays, every entity's points
+//  live in one pooled buffer, and text/font attributes are interned
+//  in a side table.  Geometry-only code reads entities through
+//  EntityView, which exposes the same geometric fields as Entity
+//  without copying points or strings.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_SKETCH_ENTITY_STORE_H
+#define HOBBYCAD_SKETCH_ENTITY_STORE_H
+
+#include "entity.h"
+#include "../core.h"
+#include "../types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hobbycad {
+namespace sketch {
+
+class EntityStore;
+
+// =====================================================================
+//  PointSpan
+// =====================================================================
+
+/// Read-only view over a run of points in the store's pooled buffer.
+/// Supports the subset of std::vector used by geometry code.
+class PointSpan {
+public:
+    PointSpan() = default;
+    PointSpan(const Point2D* data, size_t size) : m_data(data), m_size(size) {}
+
+    const Point2D* begin() const { return m_data; }
+    const Point2D* end() const { return m_data + m_size; }
+    const Point2D* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const Point2D& operator[](size_t i) const { return m_data[i]; }
+    const Point2D& front() const { return m_data[0]; }
+    const Point2D& back() const { return m_data[m_size - 1]; }
+
+    /// Copy into an owning vector
+    std::vector<Point2D> toVector() const { return {begin(), end()}; }
+
+private:
+    const Point2D* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+// =====================================================================
+//  EntityView
+// =====================================================================
+
+/// Lightweight view of one entity in an EntityStore.
+///
+/// The geometric fields carry the same names as Entity's, so code
+/// written against one (entity.points[0], entity.radius, ...) compiles
+/// against the other.  Text attributes are looked up on demand.
+/// A view stays valid until the store is modified.
+struct HOBBYCAD_EXPORT EntityView {
+    int id = 0;
+    EntityType type = EntityType::Line;
+    PointSpan points;
+    double radius = 0.0;
+    double startAngle = 0.0;
+    double sweepAngle = 360.0;
+    int sides = 6;
+    double majorRadius = 0.0;
+    double minorRadius = 0.0;
+    bool arcFlipped = false;
+    bool isConstruction = false;
+    bool constrained = false;
+    int groupId = -1;
+
+    const EntityStore* store = nullptr;   ///< Owning store
+    int index = -1;                       ///< Slot in the store
+
+    // ---- Text attributes (interned) ----
+
+    const std::string& text() const;
+    const std::string& fontFamily() const;
+    double fontSize() const;
+    bool fontBold() const;
+    bool fontItalic() const;
+    double textRotation() const;
+
+    // ---- Geometry ----
+
+    /// Bounding box, as Entity::boundingBox()
+    geometry::BoundingBox boundingBox() const;
+
+    /// Endpoints of open entities, as Entity::endpoints()
+    std::vector<Point2D> endpoints() const;
+
+    /// Get the closest point on this entity to a given point
+    Point2D closestPoint(const Point2D& point) const;
+
+    /// Fitted curve of a spline, as Entity::splineCurve().  Cached in
+    /// the store's slot until setPoint() moves one of its points.
+    std::shared_ptr<const geometry::BSplineCurve2D> splineCurve() const;
+
+    /// Materialize a full Entity (allocates)
+    Entity toEntity() const;
+};
+
+// =====================================================================
+//  EntityStore
+// =====================================================================
+
+/// Struct-of-arrays container for sketch entities.
+///
+/// Appending copies an Entity's fields into the parallel arrays;
+/// entity(i) and toEntities() reconstruct equivalent Entity values.
+/// Indices are dense and follow insertion order.  The store can be
+/// refilled with assign() without giving up its capacity, which makes
+/// it suitable for per-frame rebuilding from another container.
+/// Spline slots share the appended Entity's fitted curve, so a refill
+/// only fits splines that were never fitted before.
+class HOBBYCAD_EXPORT EntityStore {
+public:
+    EntityStore() = default;
+    explicit EntityStore(const std::vector<Entity>& entities);
+
+    // ---- Building ----
+
+    /// Append an entity.  Returns its index.
+    int append(const Entity& entity);
+
+    /// Replace the contents with a range of Entity (or Entity-derived)
+    /// values, keeping allocated capacity
+    template <typename Iter>
+    void assign(Iter first, Iter last)
+    {
+        clear();
+        for (; first != last; ++first) {
+            append(static_cast<const Entity&>(*first));
+        }
+    }
+
+    /// Remove all entities, keeping allocated capacity
+    void clear();
+
+    /// Reserve space for entities and pooled points
+    void reserve(size_t entityCount, size_t pointCount = 0);
+
+    // ---- Access ----
+
+    size_t size() const { return m_ids.size(); }
+    bool empty() const { return m_ids.empty(); }
+
+    /// View of the entity at an index
+    EntityView view(int index) const;
+    EntityView operator[](size_t index) const { return view(static_cast<int>(index)); }
+
+    /// Index of the entity with the given ID, or -1
+    int indexOf(int id) const;
+
+    int id(int index) const { return m_ids[index]; }
+    EntityType type(int index) const { return m_types[index]; }
+    PointSpan points(int index) const;
+
+    /// Move one point of an entity in place (drops the entity's
+    /// cached spline curve)
+    void setPoint(int index, int pointIndex, const Point2D& p);
+
+    /// Every point of every entity, in entity order
+    const std::vector<Point2D>& pointPool() const { return m_points; }
+
+    // ---- Conversion ----
+
+    /// Reconstruct the entity at an index
+    Entity entity(int index) const;
+
+    /// Reconstruct all entities, in index order
+    std::vector<Entity> toEntities() const;
+
+    // ---- Iteration (yields EntityView by value) ----
+
+    class const_iterator {
+    public:
+        const_iterator(const EntityStore* store, int index) : m_store(store), m_index(index) {}
+        EntityView operator*() const { return m_store->view(m_index); }
+        const_iterator& operator++() { ++m_index; return *this; }
+        bool operator==(const const_iterator& o) const { return m_index == o.m_index; }
+        bool operator!=(const const_iterator& o) const { return m_index != o.m_index; }
+
+    private:
+        const EntityStore* m_store;
+        int m_index;
+    };
+
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, static_cast<int>(size())}; }
+
+    // ---- Diagnostics ----
+
+    /// Approximate heap bytes held by the store
+    size_t memoryUsage() const;
+
+private:
+    friend struct EntityView;
+
+    /// Per-entity flag bits
+    enum Flag : uint8_t {
+        FlagConstruction = 1 << 0,
+        FlagConstrained  = 1 << 1,
+        FlagArcFlipped   = 1 << 2,
+        FlagFontBold     = 1 << 3,
+        FlagFontItalic   = 1 << 4
+    };
+
+    /// Text attributes, stored only for Text entities
+    struct TextAttributes {
+        uint32_t text = 0;         ///< Index into m_strings
+        uint32_t fontFamily = 0;   ///< Index into m_strings
+        double fontSize = 12.0;
+        double rotation = 0.0;
+    };
+
+    uint32_t intern(const std::string& s);
+
+    // Parallel per-entity arrays
+    std::vector<int> m_ids;
+    std::vector<EntityType> m_types;
+    std::vector<uint8_t> m_flags;
+    std::vector<uint32_t> m_pointBegin;    ///< Offset into m_points
+    std::vector<uint32_t> m_pointCount;
+    std::vector<double> m_radius;
+    std::vector<double> m_startAngle;
+    std::vector<double> m_sweepAngle;
+    std::vector<int> m_sides;
+    std::vector<double> m_majorRadius;
+    std::vector<double> m_minorRadius;
+    std::vector<int> m_groupIds;
+    std::vector<int32_t> m_textSlot;       ///< Index into m_text, or -1
+
+    // Fitted spline curves, null until first use or after setPoint()
+    mutable std::vector<std::shared_ptr<const geometry::BSplineCurve2D>> m_splines;
+
+    // Pooled and side-table storage
+    std::vector<Point2D> m_points;
+    std::vector<TextAttributes> m_text;
+    std::vector<std::string> m_strings{std::string()};  ///< Index 0 is ""
+    std::unordered_map<std::string, uint32_t> m_stringIndex;
+
+    // ID lookup is built on first use, so per-frame rebuilds that never
+    // look up by ID do not pay for hashing
+    mutable std::unordered_map<int, int> m_idIndex;
+    mutable bool m_idIndexValid = false;
+};
+
+/// Check if two entity views share an endpoint, as the Entity version
+HOBBYCAD_EXPORT bool entitiesConnected(const EntityView& e1, const EntityView& e2,
+                                       double tolerance = geometry::POINT_TOLERANCE);
+
+}  // namespace sketch
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_SKETCH_ENTITY_STORE_H
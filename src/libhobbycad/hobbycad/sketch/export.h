@@ -37,6 +37,7 @@ struct SVGExportOptions {
     bool includeDimensions = true;              ///< Show dimension values
     double margin = 5.0;                        ///< Margin around sketch in mm
     double scale = 1.0;                         ///< Scale factor (1.0 = 1mm per SVG unit)
+    bool textAsOutlines = false;                ///< Write text as glyph outline paths (needs FreeType)
 };
 
 /// Export sketch to SVG string
@@ -72,6 +73,7 @@ struct DXFExportOptions {
     int colorIndex = 7;                               ///< DXF color index (7 = white/black)
     int constructionColorIndex = 5;                   ///< Color index for construction
     bool usePolylines = true;                         ///< Use LWPOLYLINE for complex shapes
+    bool textAsOutlines = false;                      ///< Write text as closed glyph polylines (needs FreeType)
 };
 
 /// Export sketch to DXF string
@@ -17,6 +17,7 @@
 #include "../types.h"
 
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -64,6 +65,16 @@ struct HOBBYCAD_EXPORT Group {
 // =====================================================================
 
 /// Manages a collection of groups with hierarchy support
+///
+/// Lookups are indexed: group IDs map to slots through a hash, every
+/// entity maps to the groups that directly contain it, transitive
+/// entity sets are cached per group, and the hierarchy is numbered
+/// (pre/post order, depth, ancestor jump table) so ancestry queries
+/// don't walk parent chains.  The caches are rebuilt lazily, so const
+/// queries are not safe to run concurrently with each other.
+///
+/// Membership and nesting must be changed through the manager;
+/// pointers from groupById() may be used to edit names and flags.
 class HOBBYCAD_EXPORT GroupManager {
 public:
     GroupManager() = default;
@@ -102,12 +113,30 @@ public:
     /// Get all entity IDs in a group (recursively includes nested groups)
     std::unordered_set<int> allEntityIds(int groupId) const;
 
+    /// Same as allEntityIds() without the copy.  The reference stays
+    /// valid until the group, its subtree or its nesting changes.
+    const std::unordered_set<int>& entityClosure(int groupId) const;
+
     /// Get all groups that contain an entity (directly, not through nesting)
     std::vector<int> groupsContainingEntity(int entityId) const;
 
     /// Check if adding childId as a child of parentId would create a cycle
     bool wouldCreateCycle(int childId, int parentId) const;
 
+    // ---- Hierarchy queries ----
+
+    /// True if ancestorId is a strict ancestor of descendantId
+    bool isAncestorOf(int ancestorId, int descendantId) const;
+
+    /// Depth of a group in the hierarchy (0 = top-level)
+    int groupDepth(int groupId) const;
+
+    /// Path from the root to a group (list of group IDs)
+    std::vector<int> groupPath(int groupId) const;
+
+    /// Deepest group that is an ancestor of (or equal to) both, or -1
+    int commonAncestor(int groupId1, int groupId2) const;
+
     /// Clear all groups
     void clear();
 
@@ -115,11 +144,33 @@ public:
     int nextGroupId() const { return m_nextId; }
 
 private:
+    /// Hierarchy numbering, indexed by slot
+    struct Hierarchy {
+        std::vector<int> enter;                ///< Pre-order number
+        std::vector<int> exit;                 ///< Post-order number
+        std::vector<int> depth;
+        std::vector<std::vector<int>> up;      ///< up[k][slot] = 2^k-th ancestor slot, or -1
+        int clock = 0;
+        bool valid = false;
+    };
+
     std::vector<Group> m_groups;
     int m_nextId = 1;
 
-    /// Helper to check ancestry
-    bool isAncestorOf(int ancestorId, int descendantId) const;
+    std::unordered_map<int, int> m_slotById;                     ///< Group ID -> index in m_groups
+    std::unordered_map<int, std::vector<int>> m_groupsByEntity;  ///< Entity ID -> direct groups
+
+    /// Transitive entity sets, computed on demand.  A membership change
+    /// drops the entries of the changed group and its ancestors only.
+    mutable std::unordered_map<int, std::unordered_set<int>> m_closures;
+    mutable Hierarchy m_hierarchy;
+
+    int slotOf(int id) const;
+    void rebuildSlots();
+    void invalidateClosures(int groupId);
+    void rebuildHierarchy() const;
+    const Hierarchy& hierarchy() const;
+    bool walkIsAncestorOf(int ancestorId, int descendantId) const;
 };
 
 // =====================================================================
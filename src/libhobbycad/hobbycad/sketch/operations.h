@@ -23,6 +23,9 @@
 namespace hobbycad {
 namespace sketch {
 
+class EntityStore;
+struct EntityView;
+
 // =====================================================================
 //  Intersection Detection
 // =====================================================================
@@ -87,6 +90,65 @@ HOBBYCAD_EXPORT OffsetResult offsetEntity(
     int side,
     int newId);
 
+// =====================================================================
+//  Chain Offset
+// =====================================================================
+
+/// How offset pieces are joined where a convex corner opens a gap
+enum class OffsetJoin {
+    Round,    ///< Arc of the offset distance around the corner
+    Miter     ///< Extend both pieces until they meet (round past miterLimit)
+};
+
+/// Options for offsetChain()
+struct ChainOffsetOptions {
+    OffsetJoin join = OffsetJoin::Round;
+    double miterLimit = 4.0;      ///< Longest miter, as a multiple of the distance
+    double tolerance = 0.01;      ///< Chord tolerance for splines and ellipses (mm)
+};
+
+/// Result of a chain offset
+struct ChainOffsetResult {
+    bool success = false;
+    std::vector<Entity> newEntities;  ///< Lines, arcs and circles, chain by chain in path order
+    int chainCount = 0;               ///< Number of separate chains in newEntities
+    std::string errorMessage;
+};
+
+/// Offset a connected chain of entities as one curve
+///
+/// The chain (as returned by findConnectedChain()) must form a single
+/// path or loop, or be one closed entity.  Lines, arcs and circles are
+/// offset exactly, and so are the edges of rectangles, polygons and
+/// slots; splines and ellipses are flattened within the tolerance
+/// first.  Convex corners get round or miter joins, and parts of the
+/// offset that come closer to the chain than the distance (local and
+/// global self-intersections) are removed, so the result may split
+/// into several chains.
+/// @param chainIds IDs of the chain's entities
+/// @param entities All entities in the sketch
+/// @param distance The offset distance
+/// @param clickPos Point on the side to offset to
+/// @param nextId Function to get next entity ID
+HOBBYCAD_EXPORT ChainOffsetResult offsetChain(
+    const std::vector<int>& chainIds,
+    const std::vector<Entity>& entities,
+    double distance,
+    const Point2D& clickPos,
+    std::function<int()> nextId,
+    const ChainOffsetOptions& options = {});
+
+/// Offset a chain with explicit side selection
+/// @param side +1 for outward (closed chains) or right of the first
+///             entity's direction (open chains), -1 for the other side
+HOBBYCAD_EXPORT ChainOffsetResult offsetChain(
+    const std::vector<int>& chainIds,
+    const std::vector<Entity>& entities,
+    double distance,
+    int side,
+    std::function<int()> nextId,
+    const ChainOffsetOptions& options = {});
+
 // =====================================================================
 //  Fillet Operation
 // =====================================================================
@@ -314,6 +376,29 @@ HOBBYCAD_EXPORT RejoinResult validateCollinearRejoin(
     double angleTolerance = 0.001,
     double endpointTolerance = 1e-4);
 
+// =====================================================================
+//  EntityStore Overloads
+// =====================================================================
+//
+//  The read-only queries above, reading entities in place from a
+//  struct-of-arrays EntityStore with the same results.  The editing
+//  operations build new entities and keep taking Entity values.
+
+HOBBYCAD_EXPORT std::vector<Intersection> findAllIntersections(
+    const EntityStore& entities);
+
+HOBBYCAD_EXPORT std::vector<Intersection> findIntersections(
+    const EntityView& entity,
+    const EntityStore& others);
+
+HOBBYCAD_EXPORT std::vector<Intersection> findIntersection(
+    const EntityView& e1, const EntityView& e2);
+
+HOBBYCAD_EXPORT std::vector<int> findConnectedChain(
+    int startId,
+    const EntityStore& entities,
+    double tolerance = geometry::POINT_TOLERANCE);
+
 }  // namespace sketch
 }  // namespace hobbycad
 
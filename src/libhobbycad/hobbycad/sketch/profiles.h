@@ -22,6 +22,8 @@
 namespace hobbycad {
 namespace sketch {
 
+class EntityStore;
+
 // =====================================================================
 //  Profile Data Structure
 // =====================================================================
@@ -34,6 +36,7 @@ struct Profile {
     std::vector<Point2D> polygon;     ///< Approximated polygon for the profile
     double area = 0.0;                ///< Signed area (positive = CCW, negative = CW)
     bool isOuter = true;              ///< True if outer profile, false if inner (hole)
+    int parentId = 0;                 ///< ID of the smallest enclosing profile (0 = none)
     geometry::BoundingBox bounds;     ///< Bounding box of the profile
 
     /// Check if this profile contains another profile (for hole detection)
@@ -43,6 +46,13 @@ struct Profile {
     bool containsPoint(const Point2D& point) const;
 };
 
+/// An outer profile together with the holes directly inside it.
+/// Islands inside a hole are outer profiles of regions of their own.
+struct ProfileRegion {
+    Profile outer;                    ///< Outer boundary
+    std::vector<Profile> holes;       ///< Holes in the outer boundary
+};
+
 // =====================================================================
 //  Profile Detection
 // =====================================================================
@@ -72,6 +82,31 @@ HOBBYCAD_EXPORT std::vector<Profile> detectProfilesWithHoles(
     const std::vector<Entity>& entities,
     const ProfileDetectionOptions& options = {});
 
+/// Build the containment tree of a set of profiles
+///
+/// Sorts the profiles by decreasing area, sets parentId to the smallest
+/// profile containing each one and isOuter by nesting depth (outer,
+/// hole, island, ...).  Candidates are looked up in a uniform grid, so
+/// a profile is only tested against the larger profiles overlapping
+/// it rather than against every other profile.
+/// @param profiles Profiles to classify (reordered in place)
+HOBBYCAD_EXPORT void buildContainmentTree(std::vector<Profile>& profiles);
+
+/// Group classified profiles into regions, one per outer profile
+/// @param profiles Profiles from detectProfilesWithHoles (or after
+///                 buildContainmentTree)
+/// @return Regions in the order of their outer profiles
+HOBBYCAD_EXPORT std::vector<ProfileRegion> profileRegions(
+    const std::vector<Profile>& profiles);
+
+/// Detect profiles and group them into regions with holes
+/// @param entities All entities in the sketch
+/// @param options Detection options
+/// @return One region per outer profile
+HOBBYCAD_EXPORT std::vector<ProfileRegion> detectProfileRegions(
+    const std::vector<Entity>& entities,
+    const ProfileDetectionOptions& options = {});
+
 // =====================================================================
 //  Profile Utilities
 // =====================================================================
@@ -147,6 +182,43 @@ HOBBYCAD_EXPORT std::vector<std::vector<int>> findCycles(
     const ConnectivityGraph& graph,
     int maxCycles = 100);
 
+// =====================================================================
+//  EntityStore Overloads
+// =====================================================================
+//
+//  Same results as the std::vector<Entity> versions above, reading
+//  entities in place from a struct-of-arrays EntityStore (no per-entity
+//  copies of points or text).
+
+HOBBYCAD_EXPORT std::vector<Profile> detectProfiles(
+    const EntityStore& entities,
+    const ProfileDetectionOptions& options = {});
+
+HOBBYCAD_EXPORT std::vector<Profile> detectProfilesWithHoles(
+    const EntityStore& entities,
+    const ProfileDetectionOptions& options = {});
+
+HOBBYCAD_EXPORT std::vector<ProfileRegion> detectProfileRegions(
+    const EntityStore& entities,
+    const ProfileDetectionOptions& options = {});
+
+HOBBYCAD_EXPORT std::vector<Point2D> profileToPolygon(
+    const Profile& profile,
+    const EntityStore& entities,
+    int segments = 32);
+
+HOBBYCAD_EXPORT double profileArea(
+    const Profile& profile,
+    const EntityStore& entities);
+
+HOBBYCAD_EXPORT Point2D profileCentroid(
+    const Profile& profile,
+    const EntityStore& entities);
+
+HOBBYCAD_EXPORT ConnectivityGraph buildConnectivityGraph(
+    const EntityStore& entities,
+    double tolerance = geometry::POINT_TOLERANCE);
+
 }  // namespace sketch
 }  // namespace hobbycad
 
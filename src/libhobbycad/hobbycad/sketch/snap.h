@@ -22,6 +22,9 @@
 namespace hobbycad {
 namespace sketch {
 
+class EntityStore;
+struct EntityView;
+
 // =====================================================================
 //  Snap Types
 // =====================================================================
@@ -184,6 +187,43 @@ HOBBYCAD_EXPORT SnapResult findBestSnap(
 HOBBYCAD_EXPORT std::vector<Point2D> computeEntityIntersectionPoints(
     const Entity& e1, const Entity& e2);
 
+// =====================================================================
+//  EntityStore Overloads
+// =====================================================================
+//
+//  Same behavior as the std::vector<Entity> versions above, reading
+//  entities in place from a struct-of-arrays EntityStore (no per-entity
+//  copies of points or text).
+
+HOBBYCAD_EXPORT std::vector<SnapPoint> collectSnapPoints(const EntityView& entity);
+
+HOBBYCAD_EXPORT std::vector<SnapPoint> collectAllSnapPoints(
+    const EntityStore& entities,
+    int excludeEntityId = -1);
+
+HOBBYCAD_EXPORT std::vector<SnapPoint> collectIntersectionSnapPoints(
+    const EntityStore& entities,
+    int excludeEntityId = -1);
+
+HOBBYCAD_EXPORT std::vector<SnapPoint> collectAxisCrossingSnapPoints(
+    const EntityStore& entities,
+    int excludeEntityId = -1);
+
+HOBBYCAD_EXPORT SnapPoint findNearestOnPerimeter(
+    const EntityStore& entities,
+    const Point2D& point,
+    double tolerance,
+    int excludeEntityId = -1);
+
+HOBBYCAD_EXPORT SnapResult findBestSnap(
+    const EntityStore& entities,
+    const Point2D& worldPos,
+    double worldTolerance,
+    int excludeEntityId = -1);
+
+HOBBYCAD_EXPORT std::vector<Point2D> computeEntityIntersectionPoints(
+    const EntityView& e1, const EntityView& e2);
+
 }  // namespace sketch
 }  // namespace hobbycad
 
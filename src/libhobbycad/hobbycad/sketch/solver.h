@@ -2,9 +2,11 @@
 //  src/libhobbycad/hobbycad/sketch/solver.h — Constraint solver wrapper
 // =====================================================================
 //
-//  Wrapper around libslvs for parametric constraint solving.
-//  This allows sketches to maintain geometric relationships as
-//  entities are modified.
+//  Front end for parametric constraint solving.  This allows
+//  sketches to maintain geometric relationships as entities are
+//  modified.  Solving is done by libslvs when it is compiled in, or
+//  by the built-in sparse solver (native_solver.h); the backend can
+//  be chosen at runtime.
 //
 //  Part of libhobbycad.
 //  SPDX-License-Identifier: GPL-3.0-only
@@ -54,11 +56,22 @@ struct OverConstraintInfo {
     std::string reason;                          ///< Human-readable explanation
 };
 
+// =====================================================================
+//  Solver Backends
+// =====================================================================
+
+/// Constraint solver implementation
+enum class SolverBackend {
+    Automatic,   ///< libslvs when compiled in, otherwise native
+    Native,      ///< Built-in sparse Newton/Levenberg–Marquardt solver
+    SolveSpace   ///< libslvs
+};
+
 // =====================================================================
 //  Solver Class
 // =====================================================================
 
-/// Wrapper around libslvs constraint solver
+/// Constraint solver front end
 ///
 /// The solver takes a set of entities and constraints, and adjusts
 /// entity geometry to satisfy all constraints while minimizing
@@ -79,9 +92,17 @@ struct OverConstraintInfo {
 /// @endcode
 class HOBBYCAD_EXPORT Solver {
 public:
-    Solver();
+    explicit Solver(SolverBackend backend = SolverBackend::Automatic);
     ~Solver();
 
+    /// Select the backend used by later calls
+    void setBackend(SolverBackend backend);
+    SolverBackend backend() const;
+
+    /// Backend that will actually run (Automatic resolved, and
+    /// SolveSpace falling back to Native when libslvs is missing)
+    SolverBackend activeBackend() const;
+
     /// Solve constraints and update entity geometry
     /// @param entities Entities to solve (modified in place on success)
     /// @param constraints Constraints to satisfy
@@ -122,10 +143,14 @@ public:
         const std::vector<Constraint>& constraints
     );
 
-    /// Check if solver is available (libslvs compiled in)
+    /// Check if solver is available.  Always true: the native
+    /// backend needs no external library.
     /// @return True if constraint solving is supported
     static bool isAvailable();
 
+    /// Check if a specific backend is compiled in
+    static bool isBackendAvailable(SolverBackend backend);
+
 private:
     class Impl;
     Impl* m_impl;
@@ -138,6 +163,12 @@ private:
 /// Get human-readable name for a solve result code
 HOBBYCAD_EXPORT std::string solveResultName(SolveResult::ResultCode code);
 
+/// Get the identifier of a backend ("auto", "native", "solvespace")
+HOBBYCAD_EXPORT std::string solverBackendName(SolverBackend backend);
+
+/// Parse a backend identifier.  Returns false for unknown names.
+HOBBYCAD_EXPORT bool solverBackendFromName(const std::string& name, SolverBackend* backend);
+
 /// Check if a constraint type is supported by the solver
 HOBBYCAD_EXPORT bool constraintSupported(ConstraintType type);
 
@@ -0,0 +1,193 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/sketch/text.h — Text outlines
+// =====================================================================
+//
+//  Turns text entities into geometry.  Fonts are loaded headlessly
+//  through FreeType; each glyph is decomposed once into lines and
+//  quadratic/cubic Bézier segments and kept in a process-wide cache
+//  keyed by font face, glyph and synthetic style, so laying out a
+//  serial-number plate with thousands of characters decomposes each
+//  distinct glyph only once.
+//
+//  Laid-out text is a set of closed contours in sketch coordinates.
+//  Outer contours run counter-clockwise and holes (the counters of
+//  "o", "A", "8") clockwise, ready for profile detection, export and
+//  B-rep faces.
+//
+//  Without FreeType (HOBBYCAD_HAS_FREETYPE unset) every function
+//  reports failure and text keeps its anchor-point-only behaviour.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_SKETCH_TEXT_H
+#define HOBBYCAD_SKETCH_TEXT_H
+
+#include "entity.h"
+#include "../geometry/types.h"
+#include "../types.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace hobbycad {
+namespace sketch {
+
+// =====================================================================
+//  Outline Data
+// =====================================================================
+
+/// Kind of outline segment
+enum class OutlineSegmentType {
+    Line,           ///< start → end
+    Quadratic,      ///< Quadratic Bézier (start, control1, end)
+    Cubic           ///< Cubic Bézier (start, control1, control2, end)
+};
+
+/// One segment of a glyph contour
+struct OutlineSegment {
+    OutlineSegmentType type = OutlineSegmentType::Line;
+    Point2D start;
+    Point2D control1;               ///< Unused for lines
+    Point2D control2;               ///< Cubic only
+    Point2D end;
+};
+
+/// A closed glyph contour; each segment starts where the previous one
+/// ended and the last ends at the first one's start
+struct OutlineContour {
+    std::vector<OutlineSegment> segments;
+    double area = 0.0;              ///< Signed area (positive = CCW)
+    bool isHole = false;            ///< Inside an odd number of contours of its glyph
+    int glyph = 0;                  ///< Index of the glyph in its layout
+};
+
+/// Font style requested for a text entity
+struct TextStyle {
+    std::string fontFamily;         ///< Family name (empty = default font)
+    bool bold = false;
+    bool italic = false;
+};
+
+/// A font face known to the font cache
+struct FontInfo {
+    std::string family;             ///< Family name reported by the font
+    std::string style;              ///< Style name ("Regular", "Bold Italic", ...)
+    std::string path;               ///< Font file
+    int faceIndex = 0;              ///< Face within the file (collections)
+    bool bold = false;
+    bool italic = false;
+};
+
+/// Laid-out text
+struct TextOutline {
+    bool success = false;
+    std::string errorMessage;
+    std::vector<OutlineContour> contours;   ///< In sketch coordinates
+    geometry::BoundingBox bounds;
+    FontInfo font;                  ///< Face the text was set in
+    bool fontSubstituted = false;   ///< Requested family not found; default used
+    int glyphCount = 0;             ///< Glyphs laid out (including spaces)
+};
+
+// =====================================================================
+//  Font and Glyph Cache
+// =====================================================================
+
+/// Counters for the glyph cache
+struct GlyphCacheStats {
+    std::size_t fonts = 0;          ///< Font faces indexed
+    std::size_t openFaces = 0;      ///< Faces currently loaded by FreeType
+    std::size_t glyphs = 0;         ///< Decomposed glyphs cached
+    std::size_t hits = 0;           ///< Glyph lookups served from the cache
+    std::size_t misses = 0;         ///< Glyph lookups that decomposed a glyph
+};
+
+/// Check if text outlines are compiled in (FreeType available)
+HOBBYCAD_EXPORT bool textOutlinesAvailable();
+
+/// Add a font file to the font index (all faces of a collection)
+/// @param errorMsg Optional error message output
+/// @return true if at least one scalable face was added
+HOBBYCAD_EXPORT bool addFontFile(const std::string& path, std::string* errorMsg = nullptr);
+
+/// Add every font file below a directory to the font index
+/// @return Number of faces added
+HOBBYCAD_EXPORT int addFontDirectory(const std::string& path);
+
+/// All indexed font faces.  The system font directories and the
+/// directories in HOBBYCAD_FONT_PATH are scanned on first use.
+HOBBYCAD_EXPORT std::vector<FontInfo> availableFonts();
+
+/// Face that would be used for a style
+/// @return false if no font is available at all
+HOBBYCAD_EXPORT bool findFont(const TextStyle& style, FontInfo* font,
+                              bool* substituted = nullptr);
+
+/// Glyph cache counters
+HOBBYCAD_EXPORT GlyphCacheStats glyphCacheStats();
+
+/// Drop all cached glyphs and close all faces (the font index is kept)
+HOBBYCAD_EXPORT void clearGlyphCache();
+
+// =====================================================================
+//  Layout
+// =====================================================================
+
+/// Lay out a string as glyph outlines
+///
+/// The first line's baseline starts at position; "\n" starts a new
+/// line below it.  Glyphs are scaled so the font's em square is size
+/// high, kerned with the font's kerning table, and the whole block is
+/// rotated about position.  Missing bold or italic faces are
+/// synthesized by emboldening and slanting the regular face.
+/// @param text UTF-8 text
+/// @param position Baseline origin of the first line
+/// @param style Font family and style
+/// @param size Em size in mm
+/// @param rotationDegrees Counter-clockwise rotation
+HOBBYCAD_EXPORT TextOutline layoutText(
+    const std::string& text,
+    const Point2D& position,
+    const TextStyle& style,
+    double size,
+    double rotationDegrees = 0.0);
+
+/// Lay out a text entity (its first point is the baseline origin)
+HOBBYCAD_EXPORT TextOutline textOutline(const Entity& entity);
+
+// =====================================================================
+//  Conversion
+// =====================================================================
+
+/// Flatten a contour to a polygon (without a repeated closing point)
+/// @param tolerance Maximum distance between curve and polygon
+HOBBYCAD_EXPORT std::vector<Point2D> contourToPolygon(
+    const OutlineContour& contour,
+    double tolerance = 0.05);
+
+/// Flatten every contour of an outline
+HOBBYCAD_EXPORT std::vector<std::vector<Point2D>> outlineToPolygons(
+    const TextOutline& outline,
+    double tolerance = 0.05);
+
+/// Replace a text entity by line entities along its flattened
+/// outlines, so the glyphs take part in profile detection like any
+/// other closed geometry.  The lines inherit the construction flag.
+/// @param entity Text entity
+/// @param nextId Function to get next entity ID
+/// @param tolerance Maximum distance between curve and lines
+/// @return Line entities (empty if the text could not be laid out)
+HOBBYCAD_EXPORT std::vector<Entity> textToEntities(
+    const Entity& entity,
+    std::function<int()> nextId,
+    double tolerance = 0.05);
+
+}  // namespace sketch
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_SKETCH_TEXT_H
@@ -14,6 +14,7 @@
 #define HOBBYCAD_SKETCH_UNDO_H
 
 #include "../core.h"
+#include "../memory.h"
 #include "entity.h"
 #include "constraint.h"
 #include "group.h"
@@ -212,6 +213,9 @@ private:
     std::vector<UndoCommand> m_compoundCommands;
     std::string m_compoundDescription;
 
+    // Memory accounting: all commands held by the three stacks
+    memory::Charge m_charge{memory::Tag::UndoHistory};
+
     void enforceMaxSize();
 };
 
@@ -0,0 +1,80 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/sketch_io.h — Binary sketch encoding
+// =====================================================================
+//
+//  Compact, versioned binary encoding of SketchData shared by the Qt
+//  and non-Qt builds.  Large sketches load several times faster than
+//  their JSON form and take a fraction of the space.  JSON remains
+//  available as the human-readable interchange format.
+//
+//  Layout (all multi-byte values little-endian):
+//    - Magic "HCSK" followed by a varint format version
+//    - Sketch header (name, plane reference, grid spacing)
+//    - String table (text and font family values, interned)
+//    - Entities, stored column by column: delta-coded varint IDs,
+//      type and flag bytes, per-entity point counts, then every X
+//      coordinate followed by every Y coordinate as packed doubles
+//    - Constraints, also columnar
+//    - Background image (only when set)
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_SKETCH_IO_H
+#define HOBBYCAD_SKETCH_IO_H
+
+#include "core.h"
+#include "project.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hobbycad {
+namespace sketch_io {
+
+/// Current binary format version.  Readers reject newer versions.
+constexpr uint32_t BINARY_FORMAT_VERSION = 1;
+
+/// File extension used for binary sketch files (without the dot)
+constexpr const char* BINARY_EXTENSION = "hsk";
+
+/// Encode a sketch into the binary format.
+HOBBYCAD_EXPORT std::vector<uint8_t> encodeSketch(const SketchData& sketch);
+
+/// Decode a sketch from the binary format.
+/// Returns true on success.  On failure, leaves sketch unspecified
+/// and sets errorMsg if non-null.
+HOBBYCAD_EXPORT bool decodeSketch(
+    const uint8_t* data, size_t size,
+    SketchData& sketch,
+    std::string* errorMsg = nullptr);
+
+/// Check whether a buffer starts with the binary sketch magic.
+HOBBYCAD_EXPORT bool isBinarySketch(const uint8_t* data, size_t size);
+
+/// Check whether a file on disk is a binary sketch (by content,
+/// not extension).
+HOBBYCAD_EXPORT bool isBinarySketchFile(const std::string& path);
+
+/// Write a sketch to a binary file.
+/// Returns true on success.  Sets errorMsg on failure.
+HOBBYCAD_EXPORT bool writeSketchFile(
+    const std::string& path,
+    const SketchData& sketch,
+    std::string* errorMsg = nullptr);
+
+/// Read a sketch from a binary file.
+/// Returns true on success.  Sets errorMsg on failure.
+HOBBYCAD_EXPORT bool readSketchFile(
+    const std::string& path,
+    SketchData& sketch,
+    std::string* errorMsg = nullptr);
+
+}  // namespace sketch_io
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_SKETCH_IO_H
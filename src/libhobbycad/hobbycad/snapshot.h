@@ -0,0 +1,156 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/snapshot.h — Project snapshot history
+// =====================================================================
+//
+//  Built-in, content-addressed version history for .hcad projects.
+//  Each snapshot records the project's managed files (manifest,
+//  geometry/, construction/, sketches/, features/) as a commit in a
+//  private git object database written through libgit2.  Blobs are
+//  keyed by content hash, so files that did not change between saves
+//  are stored only once and cost nothing to snapshot again.
+//
+//  The object database lives in <project>/metadata/snapshots and
+//  snapshots are recorded on their own ref, so a user's own .git
+//  repository in the project directory is never touched.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_SNAPSHOT_H
+#define HOBBYCAD_SNAPSHOT_H
+
+#include "core.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hobbycad {
+namespace snapshot {
+
+/// Summary of a single snapshot
+struct SnapshotInfo {
+    std::string id;             ///< Full commit hash (40 hex chars)
+    std::string shortId;        ///< Abbreviated hash for display
+    std::string message;        ///< Snapshot message
+    std::string author;         ///< Author name
+    int64_t time = 0;           ///< Seconds since the Unix epoch (UTC)
+    std::string parentId;       ///< Previous snapshot (empty for the first)
+};
+
+/// Result of taking a snapshot
+struct SnapshotResult {
+    bool success = false;
+    std::string errorMessage;
+    std::string id;             ///< Snapshot id (the existing head if nothing changed)
+    bool created = false;       ///< False when the project was unchanged since the last snapshot
+    int filesTotal = 0;         ///< Number of files recorded in the snapshot
+    int filesStored = 0;        ///< Files whose content was new to the object store
+};
+
+/// Kind of change between two snapshots
+enum class ChangeKind {
+    Added,
+    Modified,
+    Deleted,
+    Renamed
+};
+
+/// A single changed file between two snapshots
+struct FileChange {
+    ChangeKind kind = ChangeKind::Modified;
+    std::string path;           ///< Path in the newer snapshot (relative to project root)
+    std::string oldPath;        ///< Path in the older snapshot (differs only for renames)
+};
+
+/// Summary of differences between two snapshots
+struct DiffSummary {
+    bool success = false;
+    std::string errorMessage;
+    std::vector<FileChange> changes;
+    int added = 0;
+    int modified = 0;
+    int deleted = 0;
+    int renamed = 0;
+};
+
+/// Content-addressed snapshot store for a project directory
+///
+/// Example usage:
+/// @code
+///     snapshot::SnapshotStore store;
+///     if (store.open(project.projectPath())) {
+///         auto result = store.takeSnapshot("Saved from GUI");
+///         for (const auto& info : store.listSnapshots(20)) { ... }
+///     }
+/// @endcode
+class HOBBYCAD_EXPORT SnapshotStore {
+public:
+    SnapshotStore();
+    ~SnapshotStore();
+
+    SnapshotStore(const SnapshotStore&) = delete;
+    SnapshotStore& operator=(const SnapshotStore&) = delete;
+
+    /// Open (creating if necessary) the snapshot store of a project.
+    /// @param projectDir Project directory (the one containing the .hcad manifest)
+    /// @param errorMsg Optional error message output
+    /// @return true on success
+    bool open(const std::string& projectDir, std::string* errorMsg = nullptr);
+
+    /// Release the underlying repository handle
+    void close();
+
+    /// True if open() succeeded and close() has not been called
+    bool isOpen() const;
+
+    /// Project directory this store belongs to (empty if not open)
+    std::string projectDir() const;
+
+    /// Record the project's current on-disk state.
+    /// Unchanged files are detected by size/mtime and by content hash,
+    /// and only content that is new to the object store is compressed
+    /// and written.  If the resulting tree equals the latest snapshot,
+    /// no commit is made and result.created is false.
+    /// @param message Snapshot message (e.g., "Save")
+    SnapshotResult takeSnapshot(const std::string& message);
+
+    /// List snapshots, newest first.
+    /// @param maxCount Maximum number to return (-1 = all)
+    std::vector<SnapshotInfo> listSnapshots(int maxCount = -1) const;
+
+    /// Id of the latest snapshot (empty if none)
+    std::string headId() const;
+
+    /// Restore the project's managed files to the state of a snapshot.
+    /// The current files are first saved as a "Before restore"
+    /// snapshot, so the restore itself can be reverted.  Files that exist in the snapshot are rewritten only if their
+    /// content differs; managed files absent from the snapshot are
+    /// removed.  The caller must reload the Project afterwards.
+    /// @param id Full or abbreviated snapshot id
+    /// @param errorMsg Optional error message output
+    /// @return true on success
+    bool restoreSnapshot(const std::string& id, std::string* errorMsg = nullptr);
+
+    /// Summarize file changes from one snapshot to another.
+    /// @param fromId Older snapshot (full or abbreviated id)
+    /// @param toId Newer snapshot (full or abbreviated id)
+    DiffSummary diff(const std::string& fromId, const std::string& toId) const;
+
+    /// Check if snapshot support is compiled in (libgit2 available)
+    static bool isAvailable();
+
+private:
+    class Impl;
+    Impl* m_impl;
+};
+
+/// Get a human-readable name for a change kind ("added", "modified", ...)
+HOBBYCAD_EXPORT std::string changeKindName(ChangeKind kind);
+
+}  // namespace snapshot
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_SNAPSHOT_H
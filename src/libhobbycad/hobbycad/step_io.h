@@ -3,7 +3,9 @@
 // =====================================================================
 //
 //  STEP (ISO 10303-21) import/export functions for CAD interchange.
-//  Uses OpenCASCADE's STEPControl_Reader and STEPControl_Writer.
+//  Uses OpenCASCADE's STEPControl_Reader and STEPControl_Writer, and
+//  the XDE document framework (STEPCAFControl_Writer) for assemblies
+//  with shared parts, names and colours.
 //
 //  Part of libhobbycad.
 //  SPDX-License-Identifier: GPL-3.0-only
@@ -15,6 +17,7 @@
 
 #include "core.h"
 
+#include <Message_ProgressRange.hxx>
 #include <TopoDS_Shape.hxx>
 
 #include <string>
@@ -37,6 +40,7 @@ struct ReadResult {
     std::string errorMessage;
     int shapeCount = 0;         ///< Number of shapes read
     int rootCount = 0;          ///< Number of root entities in file
+    bool cancelled = false;     ///< True if the user aborted through the progress range
 };
 
 /// Result of a STEP write operation
@@ -44,12 +48,44 @@ struct WriteResult {
     bool success = false;
     std::string errorMessage;
     int shapeCount = 0;         ///< Number of shapes written
+    int partCount = 0;          ///< Distinct parts written (assembly export)
+    int instanceCount = 0;      ///< Located part instances (assembly export)
+    bool cancelled = false;     ///< True if the user aborted through the progress range
+};
+
+/// One body of an assembly export
+struct AssemblyBody {
+    TopoDS_Shape shape;
+    std::string name;           ///< Instance name (empty = "Body <n>")
+    bool hasColor = false;
+    double red = 0.0;           ///< sRGB components in [0, 1]
+    double green = 0.0;
+    double blue = 0.0;
+};
+
+/// Assembly export settings
+struct AssemblyOptions {
+    StepVersion version = StepVersion::AP214;
+    std::string assemblyName;   ///< Top-level product name (empty = file name)
+
+    /// Write identical bodies once, as one part with located instances.
+    /// Bodies sharing a TShape always match; others match if a rigid
+    /// motion maps one onto the other within tolerance.
+    bool deduplicate = true;
+    double tolerance = 1e-6;    ///< Geometric match tolerance (mm)
+    bool parallel = true;       ///< Analyze bodies on OCCT's thread pool
 };
 
 /// Read a STEP file and return all shapes.
+/// Safe to call from a worker thread.  Parsing is reported as a single
+/// step; root transfer reports per-entity progress and honours
+/// cancellation (UserBreak) of the progress indicator.
 /// @param path Path to the STEP file (.step, .stp)
+/// @param progress Optional progress range for reporting and cancellation
 /// @return ReadResult with shapes and status
-HOBBYCAD_EXPORT ReadResult readStep(const std::string& path);
+HOBBYCAD_EXPORT ReadResult readStep(
+    const std::string& path,
+    const Message_ProgressRange& progress = Message_ProgressRange());
 
 /// Read a STEP file (legacy interface).
 /// @param path Path to the STEP file
@@ -60,14 +96,18 @@ HOBBYCAD_EXPORT std::vector<TopoDS_Shape> readStep(
     std::string* errorMsg);
 
 /// Write shapes to a STEP file.
+/// Progress is reported per transferred shape; a cancelled write leaves
+/// no output file behind.
 /// @param path Output file path
 /// @param shapes Shapes to write
 /// @param version STEP version to use (default: AP214)
+/// @param progress Optional progress range for reporting and cancellation
 /// @return WriteResult with status
 HOBBYCAD_EXPORT WriteResult writeStep(
     const std::string& path,
     const std::vector<TopoDS_Shape>& shapes,
-    StepVersion version = StepVersion::AP214);
+    StepVersion version = StepVersion::AP214,
+    const Message_ProgressRange& progress = Message_ProgressRange());
 
 /// Write a single shape to a STEP file.
 /// @param path Output file path
@@ -89,6 +129,23 @@ HOBBYCAD_EXPORT bool writeStep(
     const std::vector<TopoDS_Shape>& shapes,
     std::string* errorMsg);
 
+/// Write bodies to a STEP file as an assembly of parts.
+/// Identical bodies (3D patterns, copies) are written once and placed
+/// by located instances, which keeps pattern-heavy files small and
+/// fast to read.  Mirrored bodies are not identical and become parts
+/// of their own.  A single unplaced body is written as a plain part.
+/// Progress and cancellation behave as for writeStep().
+/// @param path Output file path
+/// @param bodies Bodies with optional names and colours
+/// @param options Export settings
+/// @param progress Optional progress range for reporting and cancellation
+/// @return WriteResult with part and instance counts
+HOBBYCAD_EXPORT WriteResult writeStepAssembly(
+    const std::string& path,
+    const std::vector<AssemblyBody>& bodies,
+    const AssemblyOptions& options = AssemblyOptions{},
+    const Message_ProgressRange& progress = Message_ProgressRange());
+
 /// Check if a file appears to be a STEP file (by extension).
 HOBBYCAD_EXPORT bool isStepFile(const std::string& path);
 
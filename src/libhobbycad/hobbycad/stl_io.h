@@ -15,7 +15,10 @@
 #define HOBBYCAD_STL_IO_H
 
 #include "core.h"
+#include "mesh/decimate.h"
+#include "mesh/repair.h"
 
+#include <Message_ProgressRange.hxx>
 #include <TopoDS_Shape.hxx>
 #include <Poly_Triangulation.hxx>
 
@@ -36,6 +39,20 @@ struct MeshQuality {
     double linearDeflection = 0.1;   ///< Max linear deviation (mm)
     double angularDeflection = 0.5;  ///< Max angular deviation (radians)
     bool relative = false;           ///< If true, linearDeflection is relative to shape size
+    int maxTriangles = 0;            ///< Decimate to this many triangles (0 = no limit)
+    double maxError = 0.0;           ///< Decimate up to this error (mm, 0 = no decimation)
+};
+
+/// STL import settings
+struct ReadOptions {
+    bool repair = false;              ///< Heal the mesh before building the shape
+    mesh::RepairOptions repairOptions;
+    bool decimate = false;            ///< Reduce the mesh after any repair
+    mesh::DecimateOptions decimateOptions;
+    /// Build a solid with shared B-rep edges (mesh::toSolid) instead of a
+    /// single face carrying the triangulation.  Slower to build, but the
+    /// result needs no sewing before booleans.
+    bool buildSolid = false;
 };
 
 /// Result of an STL read operation
@@ -47,6 +64,9 @@ struct ReadResult {
     int triangleCount = 0;            ///< Number of triangles read
     int nodeCount = 0;                ///< Number of vertices read
     StlFormat detectedFormat = StlFormat::Binary;  ///< Detected file format
+    bool repaired = false;            ///< True if ReadOptions::repair ran
+    mesh::DefectSummary repairSummary;  ///< Defects found when repairing
+    int decimatedFrom = 0;            ///< Triangle count before decimation (0 if not decimated)
 };
 
 /// Result of an STL write operation
@@ -54,19 +74,27 @@ struct WriteResult {
     bool success = false;
     std::string errorMessage;
     int triangleCount = 0;      ///< Number of triangles written
+    bool cancelled = false;     ///< True if the user aborted through the progress range
 };
 
 /// Write shapes to an STL file.
+/// With MeshQuality::maxTriangles or maxError set, the meshed faces are
+/// welded into one mesh and decimated before writing.
+/// Meshing stores triangulations on the shapes' faces, so callers on a
+/// worker thread should pass shapes not shared with the viewer (e.g. a
+/// BRepBuilderAPI_Copy).
 /// @param path Output file path
 /// @param shapes Shapes to write (will be merged into single mesh)
 /// @param format Binary or ASCII format
 /// @param quality Mesh quality settings
+/// @param progress Optional progress range for reporting and cancellation
 /// @return WriteResult with status
 HOBBYCAD_EXPORT WriteResult writeStl(
     const std::string& path,
     const std::vector<TopoDS_Shape>& shapes,
     StlFormat format = StlFormat::Binary,
-    const MeshQuality& quality = MeshQuality{});
+    const MeshQuality& quality = MeshQuality{},
+    const Message_ProgressRange& progress = Message_ProgressRange());
 
 /// Write a single shape to an STL file.
 /// @param path Output file path
@@ -90,12 +118,24 @@ HOBBYCAD_EXPORT bool writeStl(
     const std::vector<TopoDS_Shape>& shapes,
     std::string* errorMsg);
 
+/// Write a triangulation as-is (e.g. a repaired mesh), without meshing.
+/// @param path Output file path
+/// @param mesh Triangulation to write
+/// @param format Binary or ASCII format
+/// @return WriteResult with status
+HOBBYCAD_EXPORT WriteResult writeStlMesh(
+    const std::string& path,
+    const Handle(Poly_Triangulation)& mesh,
+    StlFormat format = StlFormat::Binary);
+
 // ---- Import functions ----
 
 /// Read an STL file (binary or ASCII, auto-detected).
 /// @param path Path to the STL file
+/// @param options Optional repair and shape settings
 /// @return ReadResult with mesh/shape and status
-HOBBYCAD_EXPORT ReadResult readStl(const std::string& path);
+HOBBYCAD_EXPORT ReadResult readStl(const std::string& path,
+                                   const ReadOptions& options = ReadOptions{});
 
 /// Read an STL file and convert to a TopoDS_Shape.
 /// The result is a face with the triangulation attached.
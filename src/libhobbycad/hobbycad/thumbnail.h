@@ -0,0 +1,135 @@
+// =====================================================================
+//  src/libhobbycad/hobbycad/thumbnail.h — Headless thumbnail renderer
+// =====================================================================
+//
+//  Renders bodies and sketches to an RGBA ImageBuffer on the CPU, with
+//  no window, OpenGL context or Qt.  Shapes are triangulated with
+//  BRepMesh_IncrementalMesh (as for STL export), projected with an
+//  orthographic camera fitted to the scene, and rasterized with a
+//  z-buffer in screen tiles that are shaded in parallel.  B-rep edges
+//  and sketch curves are drawn on top with a depth test.
+//
+//  Intended for batch thumbnail generation (asset servers, file
+//  browsers) and for comparing rendered output in tests.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#ifndef HOBBYCAD_THUMBNAIL_H
+#define HOBBYCAD_THUMBNAIL_H
+
+#include "core.h"
+#include "image_buffer.h"
+
+#include <TopoDS_Shape.hxx>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hobbycad {
+
+class Project;
+
+namespace thumbnail {
+
+/// Standard view directions (Z up).  Isometric matches the viewport's
+/// home view, looking from (+X, -Y, +Z).
+enum class ViewDirection {
+    Isometric,
+    Front,      ///< Looking along +Y
+    Back,       ///< Looking along -Y
+    Left,       ///< Looking along +X
+    Right,      ///< Looking along -X
+    Top,        ///< Looking along -Z
+    Bottom,     ///< Looking along +Z
+    Custom      ///< Camera placed at RenderOptions azimuth/elevation
+};
+
+/// 8-bit RGBA colour
+struct Rgba {
+    uint8_t r = 0;
+    uint8_t g = 0;
+    uint8_t b = 0;
+    uint8_t a = 255;
+};
+
+/// Rendering options
+struct RenderOptions {
+    int width = 256;                     ///< Output width in pixels
+    int height = 256;                    ///< Output height in pixels
+    ViewDirection view = ViewDirection::Isometric;
+    double azimuth = -45.0;              ///< Degrees around Z from +X (Custom view)
+    double elevation = 35.264;           ///< Degrees above the XY plane (Custom view)
+    double margin = 0.05;                ///< Empty border, as a fraction of the image size
+
+    Rgba background{255, 255, 255, 0};   ///< Transparent white by default
+    Rgba bodyColor{150, 170, 200, 255};
+    Rgba edgeColor{40, 40, 40, 255};
+    Rgba sketchColor{30, 90, 200, 255};
+
+    bool drawEdges = true;               ///< Draw B-rep edges over the shading
+    bool drawSketches = true;            ///< Draw project sketches (renderProject)
+    double lineWidth = 1.0;              ///< Edge and sketch line width in pixels
+
+    int supersample = 2;                 ///< Samples per pixel along each axis (1-4)
+    int tileSize = 64;                   ///< Tile edge in (supersampled) pixels
+    bool parallel = true;                ///< Shade tiles on OCCT's thread pool
+
+    /// Mesh deflection in model units; 0 picks about half a pixel
+    double linearDeflection = 0.0;
+    double angularDeflection = 0.35;     ///< Radians
+};
+
+/// Result of a render
+struct RenderResult {
+    bool success = false;
+    std::string errorMessage;
+    ImageBuffer image;
+    int triangleCount = 0;               ///< Triangles rasterized
+    int segmentCount = 0;                ///< Edge and sketch segments drawn
+    double milliseconds = 0.0;           ///< Wall time, meshing included
+};
+
+/// Per-channel difference between two images
+struct ImageDifference {
+    bool sameSize = false;
+    int differingPixels = 0;             ///< Pixels with any channel over the tolerance
+    int maxChannelError = 0;             ///< Largest channel difference (0-255)
+    double meanChannelError = 0.0;       ///< Mean absolute channel difference
+};
+
+/// Render shapes.  Meshing stores triangulations on the shapes' faces,
+/// so a caller on a worker thread should pass shapes not shared with
+/// the viewer (e.g. a BRepBuilderAPI_Copy).
+/// An empty scene renders as the background colour.
+HOBBYCAD_EXPORT RenderResult renderShapes(
+    const std::vector<TopoDS_Shape>& shapes,
+    const RenderOptions& options = RenderOptions{});
+
+/// Render a project's bodies and (optionally) its sketches
+HOBBYCAD_EXPORT RenderResult renderProject(
+    const Project& project,
+    const RenderOptions& options = RenderOptions{});
+
+/// Compare two images channel by channel.
+/// @param channelTolerance Differences up to this value are ignored
+///        when counting differing pixels
+HOBBYCAD_EXPORT ImageDifference compareImages(
+    const ImageBuffer& a,
+    const ImageBuffer& b,
+    int channelTolerance = 0);
+
+/// Name of a view direction ("iso", "front", ...)
+HOBBYCAD_EXPORT std::string viewDirectionName(ViewDirection view);
+
+/// Parse a view direction name (case-insensitive; "isometric" is
+/// accepted for "iso").  Returns false if the name is unknown.
+HOBBYCAD_EXPORT bool viewDirectionFromName(const std::string& name, ViewDirection* view);
+
+}  // namespace thumbnail
+}  // namespace hobbycad
+
+#endif  // HOBBYCAD_THUMBNAIL_H
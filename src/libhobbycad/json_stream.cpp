@@ -0,0 +1,686 @@
+// =====================================================================
+//  src/libhobbycad/json_stream.cpp — Streaming JSON reader/writer
+// =====================================================================
+
+#include "hobbycad/json_stream.h"
+
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace hobbycad {
+
+namespace {
+
+/// Decimal separator of the current C locale.  Qt applications switch
+/// LC_NUMERIC to the user's locale on Unix, so printf/strtod may use
+/// ',' and JSON numbers have to be translated on the way in and out.
+char localeDecimalPoint()
+{
+    const struct lconv* lc = std::localeconv();
+    return (lc && lc->decimal_point && lc->decimal_point[0]) ? lc->decimal_point[0] : '.';
+}
+
+void appendUtf8(std::string& out, uint32_t cp)
+{
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+}  // namespace
+
+// =====================================================================
+//  JsonWriter
+// =====================================================================
+
+JsonWriter::JsonWriter(int indent)
+    : m_indent(indent)
+{
+}
+
+void JsonWriter::beginObject()
+{
+    beforeValue();
+    m_out += '{';
+    m_hasItems.push_back(false);
+}
+
+void JsonWriter::endObject()
+{
+    bool hadItems = !m_hasItems.empty() && m_hasItems.back();
+    if (!m_hasItems.empty()) m_hasItems.pop_back();
+    if (hadItems) newline();
+    m_out += '}';
+    if (m_hasItems.empty() && m_indent > 0) m_out += '\n';
+}
+
+void JsonWriter::beginArray()
+{
+    beforeValue();
+    m_out += '[';
+    m_hasItems.push_back(false);
+}
+
+void JsonWriter::endArray()
+{
+    bool hadItems = !m_hasItems.empty() && m_hasItems.back();
+    if (!m_hasItems.empty()) m_hasItems.pop_back();
+    if (hadItems) newline();
+    m_out += ']';
+    if (m_hasItems.empty() && m_indent > 0) m_out += '\n';
+}
+
+JsonWriter& JsonWriter::key(const char* name)
+{
+    beforeValue();
+    writeString(name, std::strlen(name));
+    m_out += m_indent > 0 ? ": " : ":";
+    m_afterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(const std::string& name)
+{
+    beforeValue();
+    writeString(name.data(), name.size());
+    m_out += m_indent > 0 ? ": " : ":";
+    m_afterKey = true;
+    return *this;
+}
+
+void JsonWriter::value(const std::string& s)
+{
+    beforeValue();
+    writeString(s.data(), s.size());
+}
+
+void JsonWriter::value(const char* s)
+{
+    beforeValue();
+    writeString(s, std::strlen(s));
+}
+
+void JsonWriter::value(double d)
+{
+    beforeValue();
+
+    // JSON has no representation for NaN or infinity
+    if (!std::isfinite(d)) {
+        m_out += "null";
+        return;
+    }
+
+    char buf[32];
+    if (d == std::floor(d) && std::fabs(d) < 1e15) {
+        std::snprintf(buf, sizeof buf, "%.0f", d);
+        m_out += buf;
+        return;
+    }
+
+    // Shortest of 15-17 significant digits that reads back exactly
+    for (int precision = 15; precision <= 17; ++precision) {
+        std::snprintf(buf, sizeof buf, "%.*g", precision, d);
+        if (precision == 17 || std::strtod(buf, nullptr) == d) break;
+    }
+
+    const char point = localeDecimalPoint();
+    if (point != '.') {
+        if (char* p = std::strchr(buf, point)) *p = '.';
+    }
+    m_out += buf;
+}
+
+void JsonWriter::value(int i)
+{
+    beforeValue();
+    m_out += std::to_string(i);
+}
+
+void JsonWriter::value(bool b)
+{
+    beforeValue();
+    m_out += b ? "true" : "false";
+}
+
+void JsonWriter::null()
+{
+    beforeValue();
+    m_out += "null";
+}
+
+void JsonWriter::rawValue(const std::string& json)
+{
+    beforeValue();
+    m_out += json;
+}
+
+std::string JsonWriter::take()
+{
+    std::string out;
+    out.swap(m_out);
+    m_hasItems.clear();
+    m_afterKey = false;
+    return out;
+}
+
+void JsonWriter::beforeValue()
+{
+    if (m_afterKey) {
+        m_afterKey = false;
+        return;
+    }
+    if (m_hasItems.empty()) return;
+
+    if (m_hasItems.back()) m_out += ',';
+    m_hasItems.back() = true;
+    newline();
+}
+
+void JsonWriter::newline()
+{
+    if (m_indent <= 0) return;
+    m_out += '\n';
+    m_out.append(m_hasItems.size() * static_cast<size_t>(m_indent), ' ');
+}
+
+void JsonWriter::writeString(const char* s, size_t n)
+{
+    static constexpr char kHex[] = "0123456789abcdef";
+
+    m_out += '"';
+    size_t runStart = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        m_out.append(s + runStart, i - runStart);
+        runStart = i + 1;
+        switch (c) {
+        case '"':  m_out += "\\\""; break;
+        case '\\': m_out += "\\\\"; break;
+        case '\b': m_out += "\\b";  break;
+        case '\f': m_out += "\\f";  break;
+        case '\n': m_out += "\\n";  break;
+        case '\r': m_out += "\\r";  break;
+        case '\t': m_out += "\\t";  break;
+        default:
+            m_out += "\\u00";
+            m_out += kHex[c >> 4];
+            m_out += kHex[c & 0xF];
+            break;
+        }
+    }
+    m_out.append(s + runStart, n - runStart);
+    m_out += '"';
+}
+
+// =====================================================================
+//  JsonReader
+// =====================================================================
+
+JsonReader::JsonReader(const char* data, size_t size)
+    : m_begin(data)
+    , m_p(data)
+    , m_end(data + size)
+{
+}
+
+JsonReader::JsonReader(const std::string& text)
+    : JsonReader(text.data(), text.size())
+{
+}
+
+JsonReader::Token JsonReader::peek()
+{
+    if (!ok()) return Token::Invalid;
+    skipWhitespace();
+    if (m_p == m_end) return Token::End;
+
+    switch (*m_p) {
+    case '{': return Token::BeginObject;
+    case '}': return Token::EndObject;
+    case '[': return Token::BeginArray;
+    case ']': return Token::EndArray;
+    case '"': return Token::String;
+    case 't':
+    case 'f': return Token::Bool;
+    case 'n': return Token::Null;
+    default:
+        if (*m_p == '-' || isDigit(*m_p)) return Token::Number;
+        return Token::Invalid;
+    }
+}
+
+bool JsonReader::beginObject()
+{
+    if (peek() != Token::BeginObject) {
+        skipValue();
+        return false;
+    }
+    ++m_p;
+    m_first.push_back(true);
+    return true;
+}
+
+bool JsonReader::nextKey(std::string& key)
+{
+    if (!consumeSeparator('}')) return false;
+
+    skipWhitespace();
+    if (m_p == m_end || *m_p != '"') {
+        fail("Expected object key");
+        return false;
+    }
+    if (!parseString(&key)) return false;
+    return expect(':');
+}
+
+bool JsonReader::beginArray()
+{
+    if (peek() != Token::BeginArray) {
+        skipValue();
+        return false;
+    }
+    ++m_p;
+    m_first.push_back(true);
+    return true;
+}
+
+bool JsonReader::nextElement()
+{
+    return consumeSeparator(']');
+}
+
+std::string JsonReader::readString(const std::string& defaultValue)
+{
+    if (peek() != Token::String) {
+        skipValue();
+        return defaultValue;
+    }
+    std::string s;
+    return parseString(&s) ? s : defaultValue;
+}
+
+double JsonReader::readDouble(double defaultValue)
+{
+    if (peek() != Token::Number) {
+        skipValue();
+        return defaultValue;
+    }
+    double d = 0.0;
+    return parseNumber(&d) ? d : defaultValue;
+}
+
+int JsonReader::readInt(int defaultValue)
+{
+    double d = readDouble(static_cast<double>(defaultValue));
+    // Like QJsonValue::toInt(), non-integral or out-of-range values
+    // yield the default
+    if (d != std::floor(d) || d < -2147483648.0 || d > 2147483647.0) {
+        return defaultValue;
+    }
+    return static_cast<int>(d);
+}
+
+bool JsonReader::readBool(bool defaultValue)
+{
+    if (peek() != Token::Bool) {
+        skipValue();
+        return defaultValue;
+    }
+    if (*m_p == 't') return parseLiteral("true") ? true : defaultValue;
+    return parseLiteral("false") ? false : defaultValue;
+}
+
+bool JsonReader::skipValue(std::string* raw)
+{
+    if (!ok()) return false;
+    skipWhitespace();
+    const char* start = m_p;
+
+    // Stack of expected closing brackets for nested containers.  Tokens
+    // and bracket nesting are validated; separator placement is not.
+    std::string closers;
+    for (;;) {
+        skipWhitespace();
+        if (m_p == m_end) {
+            fail("Unexpected end of input");
+            return false;
+        }
+
+        const char c = *m_p;
+        if (c == '{' || c == '[') {
+            closers += (c == '{') ? '}' : ']';
+            ++m_p;
+            continue;
+        }
+        if (c == '}' || c == ']') {
+            if (closers.empty() || closers.back() != c) {
+                fail("Mismatched bracket");
+                return false;
+            }
+            closers.pop_back();
+            ++m_p;
+        } else if (c == ',' || c == ':') {
+            if (closers.empty()) {
+                fail("Unexpected separator");
+                return false;
+            }
+            ++m_p;
+            continue;
+        } else if (c == '"') {
+            if (!parseString(nullptr)) return false;
+        } else if (c == 't') {
+            if (!parseLiteral("true")) return false;
+        } else if (c == 'f') {
+            if (!parseLiteral("false")) return false;
+        } else if (c == 'n') {
+            if (!parseLiteral("null")) return false;
+        } else if (c == '-' || isDigit(c)) {
+            if (!parseNumber(nullptr)) return false;
+        } else {
+            fail("Unexpected character");
+            return false;
+        }
+
+        if (closers.empty()) break;
+    }
+
+    if (raw) raw->assign(start, m_p);
+    return true;
+}
+
+bool JsonReader::atEnd()
+{
+    if (!ok()) return false;
+    skipWhitespace();
+    if (m_p != m_end) {
+        fail("Trailing content after JSON value");
+        return false;
+    }
+    return true;
+}
+
+void JsonReader::skipWhitespace()
+{
+    while (m_p != m_end &&
+           (*m_p == ' ' || *m_p == '\n' || *m_p == '\r' || *m_p == '\t')) {
+        ++m_p;
+    }
+}
+
+bool JsonReader::expect(char c)
+{
+    skipWhitespace();
+    if (m_p == m_end || *m_p != c) {
+        char what[24];
+        std::snprintf(what, sizeof what, "Expected '%c'", c);
+        fail(what);
+        return false;
+    }
+    ++m_p;
+    return true;
+}
+
+bool JsonReader::consumeSeparator(char closer)
+{
+    if (!ok() || m_first.empty()) return false;
+
+    skipWhitespace();
+    if (m_p != m_end && *m_p == closer) {
+        ++m_p;
+        m_first.pop_back();
+        return false;
+    }
+
+    if (m_first.back()) {
+        m_first.back() = false;
+        if (m_p == m_end) {
+            fail("Unexpected end of input");
+            return false;
+        }
+        return true;
+    }
+    return expect(',');
+}
+
+bool JsonReader::parseString(std::string* out)
+{
+    ++m_p;  // Opening quote
+    if (out) out->clear();
+
+    for (;;) {
+        // Copy the longest run without escapes in one go
+        const char* run = m_p;
+        while (m_p != m_end && *m_p != '"' && *m_p != '\\' &&
+               static_cast<unsigned char>(*m_p) >= 0x20) {
+            ++m_p;
+        }
+        if (out) out->append(run, m_p);
+
+        if (m_p == m_end) {
+            fail("Unterminated string");
+            return false;
+        }
+        const char c = *m_p++;
+        if (c == '"') return true;
+        if (c != '\\') {
+            fail("Control character in string");
+            return false;
+        }
+
+        if (m_p == m_end) {
+            fail("Unterminated string");
+            return false;
+        }
+        const char e = *m_p++;
+        char simple = 0;
+        switch (e) {
+        case '"':  simple = '"';  break;
+        case '\\': simple = '\\'; break;
+        case '/':  simple = '/';  break;
+        case 'b':  simple = '\b'; break;
+        case 'f':  simple = '\f'; break;
+        case 'n':  simple = '\n'; break;
+        case 'r':  simple = '\r'; break;
+        case 't':  simple = '\t'; break;
+        case 'u':  break;
+        default:
+            fail("Invalid escape sequence");
+            return false;
+        }
+        if (simple) {
+            if (out) *out += simple;
+            continue;
+        }
+
+        auto readHex4 = [this](uint32_t& cp) {
+            if (m_end - m_p < 4) return false;
+            cp = 0;
+            for (int i = 0; i < 4; ++i) {
+                int h = hexValue(m_p[i]);
+                if (h < 0) return false;
+                cp = (cp << 4) | static_cast<uint32_t>(h);
+            }
+            m_p += 4;
+            return true;
+        };
+
+        uint32_t cp = 0;
+        if (!readHex4(cp)) {
+            fail("Invalid \\u escape");
+            return false;
+        }
+        // Combine a UTF-16 surrogate pair; lone surrogates become U+FFFD
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+            uint32_t low = 0;
+            if (m_end - m_p >= 6 && m_p[0] == '\\' && m_p[1] == 'u') {
+                m_p += 2;
+                if (!readHex4(low)) {
+                    fail("Invalid \\u escape");
+                    return false;
+                }
+            }
+            cp = (low >= 0xDC00 && low <= 0xDFFF)
+                     ? 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00)
+                     : 0xFFFD;
+        } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+            cp = 0xFFFD;
+        }
+        if (out) appendUtf8(*out, cp);
+    }
+}
+
+bool JsonReader::parseNumber(double* out)
+{
+    const char* start = m_p;
+
+    if (m_p != m_end && *m_p == '-') ++m_p;
+    if (m_p == m_end || !isDigit(*m_p)) {
+        fail("Invalid number");
+        return false;
+    }
+    if (*m_p == '0') {
+        ++m_p;
+    } else {
+        while (m_p != m_end && isDigit(*m_p)) ++m_p;
+    }
+    const char* fraction = nullptr;
+    if (m_p != m_end && *m_p == '.') {
+        fraction = m_p++;
+        if (m_p == m_end || !isDigit(*m_p)) {
+            fail("Invalid number");
+            return false;
+        }
+        while (m_p != m_end && isDigit(*m_p)) ++m_p;
+    }
+    if (m_p != m_end && (*m_p == 'e' || *m_p == 'E')) {
+        ++m_p;
+        if (m_p != m_end && (*m_p == '+' || *m_p == '-')) ++m_p;
+        if (m_p == m_end || !isDigit(*m_p)) {
+            fail("Invalid number");
+            return false;
+        }
+        while (m_p != m_end && isDigit(*m_p)) ++m_p;
+    }
+
+    if (!out) return true;
+
+    // strtod needs a terminated copy, with the locale's decimal point
+    const size_t len = static_cast<size_t>(m_p - start);
+    char small[64];
+    std::string large;
+    char* buf = small;
+    if (len >= sizeof small) {
+        large.assign(len + 1, '\0');
+        buf = &large[0];
+    }
+    std::memcpy(buf, start, len);
+    buf[len] = '\0';
+    if (fraction) buf[fraction - start] = localeDecimalPoint();
+
+    *out = std::strtod(buf, nullptr);
+    return true;
+}
+
+bool JsonReader::parseLiteral(const char* word)
+{
+    const size_t n = std::strlen(word);
+    if (static_cast<size_t>(m_end - m_p) < n || std::memcmp(m_p, word, n) != 0) {
+        fail("Invalid literal");
+        return false;
+    }
+    m_p += n;
+    return true;
+}
+
+void JsonReader::fail(const char* what)
+{
+    if (!m_error.empty()) return;
+
+    // Report a 1-based line and column for the offending position
+    int line = 1;
+    int column = 1;
+    for (const char* q = m_begin; q < m_p && q < m_end; ++q) {
+        if (*q == '\n') {
+            ++line;
+            column = 1;
+        } else {
+            ++column;
+        }
+    }
+    char where[48];
+    std::snprintf(where, sizeof where, " at line %d, column %d", line, column);
+    m_error = std::string(what) + where;
+
+    // Stop all further reading
+    m_p = m_end;
+    m_first.clear();
+}
+
+// =====================================================================
+//  File helpers
+// =====================================================================
+
+bool readTextFile(const std::string& path, std::string& contents, std::string* errorMsg)
+{
+    std::ifstream ifs(std::filesystem::u8path(path), std::ios::binary);
+    if (!ifs.is_open()) {
+        if (errorMsg) *errorMsg = "Failed to open: " + path;
+        return false;
+    }
+
+    ifs.seekg(0, std::ios::end);
+    const std::streamoff size = ifs.tellg();
+    ifs.seekg(0, std::ios::beg);
+    contents.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    if (size > 0 && !ifs.read(&contents[0], size)) {
+        if (errorMsg) *errorMsg = "Failed to read: " + path;
+        return false;
+    }
+    return true;
+}
+
+bool writeTextFile(const std::string& path, const std::string& contents, std::string* errorMsg)
+{
+    std::ofstream ofs(std::filesystem::u8path(path), std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open()) {
+        if (errorMsg) *errorMsg = "Failed to create: " + path;
+        return false;
+    }
+    ofs.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    if (!ofs.good()) {
+        if (errorMsg) *errorMsg = "Failed to write: " + path;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace hobbycad
@@ -0,0 +1,725 @@
+// =====================================================================
+//  src/libhobbycad/memory.cpp — Memory accounting
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include "hobbycad/memory.h"
+#include "hobbycad/sketch/background.h"
+#include "hobbycad/sketch/constraint.h"
+#include "hobbycad/sketch/entity.h"
+#include "hobbycad/sketch/group.h"
+
+#include <BRep_CurveRepresentation.hxx>
+#include <BRep_TEdge.hxx>
+#include <BRep_TFace.hxx>
+#include <Geom2d_BSplineCurve.hxx>
+#include <Geom2d_BezierCurve.hxx>
+#include <Geom2d_OffsetCurve.hxx>
+#include <Geom2d_TrimmedCurve.hxx>
+#include <Geom_BSplineCurve.hxx>
+#include <Geom_BSplineSurface.hxx>
+#include <Geom_BezierCurve.hxx>
+#include <Geom_BezierSurface.hxx>
+#include <Geom_OffsetCurve.hxx>
+#include <Geom_OffsetSurface.hxx>
+#include <Geom_RectangularTrimmedSurface.hxx>
+#include <Geom_TrimmedCurve.hxx>
+#include <Poly_Polygon3D.hxx>
+#include <Poly_PolygonOnTriangulation.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TopoDS_Iterator.hxx>
+#include <TopoDS_Shape.hxx>
+
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <unordered_set>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace hobbycad {
+namespace memory {
+
+namespace {
+
+// ---- Counters -------------------------------------------------------
+
+struct Counter {
+    std::atomic<std::int64_t> bytes{0};
+    std::atomic<std::int64_t> peak{0};
+    std::atomic<std::int64_t> owners{0};
+};
+
+Counter g_counters[kTagCount];
+Counter g_total;
+
+void raisePeak(std::atomic<std::int64_t>& peak, std::int64_t value)
+{
+    std::int64_t seen = peak.load(std::memory_order_relaxed);
+    while (value > seen &&
+           !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+void addBytes(Counter& counter, std::int64_t bytes)
+{
+    std::int64_t now = counter.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (bytes > 0) raisePeak(counter.peak, now);
+}
+
+struct TagInfo {
+    const char* name;
+    const char* displayName;
+};
+
+constexpr TagInfo kTagInfo[kTagCount] = {
+    {"bodies",        "Project bodies"},
+    {"entities",      "Sketch entities"},
+    {"undo",          "Undo history"},
+    {"backgrounds",   "Background images"},
+    {"tessellations", "Tessellations"},
+};
+
+// ---- Shape footprint ------------------------------------------------
+//
+// Approximate sizes of OCCT objects on a 64-bit build.  They only need
+// to be right to within a small factor: the bulk of a large model is in
+// poles, knots and triangulation arrays, which are counted exactly.
+
+constexpr std::int64_t kTShapeBytes         = 96;   ///< Wire, shell, solid, compound
+constexpr std::int64_t kVertexBytes         = 160;  ///< BRep_TVertex and point representation
+constexpr std::int64_t kEdgeBytes           = 112;  ///< BRep_TEdge
+constexpr std::int64_t kFaceBytes           = 128;  ///< BRep_TFace
+constexpr std::int64_t kChildBytes          = 48;   ///< TopoDS_Shape in a child list
+constexpr std::int64_t kRepresentationBytes = 80;   ///< BRep_CurveRepresentation
+constexpr std::int64_t kGeometryBytes       = 128;  ///< Analytic curve or surface
+constexpr std::int64_t kPolyBytes           = 96;   ///< Poly_* object header
+
+class FootprintWalker {
+public:
+    void add(const TopoDS_Shape& root)
+    {
+        if (root.IsNull()) return;
+        std::vector<TopoDS_Shape> stack{root};
+        while (!stack.empty()) {
+            TopoDS_Shape shape = stack.back();
+            stack.pop_back();
+            const Handle(TopoDS_TShape)& tshape = shape.TShape();
+            if (!m_shapes.insert(tshape.get()).second) continue;
+
+            switch (shape.ShapeType()) {
+            case TopAbs_VERTEX:
+                m_result.geometryBytes += kVertexBytes;
+                break;
+            case TopAbs_EDGE:
+                m_result.geometryBytes += kEdgeBytes;
+                addEdge(Handle(BRep_TEdge)::DownCast(tshape));
+                break;
+            case TopAbs_FACE:
+                m_result.geometryBytes += kFaceBytes;
+                addFace(Handle(BRep_TFace)::DownCast(tshape));
+                break;
+            default:
+                m_result.geometryBytes += kTShapeBytes;
+                break;
+            }
+
+            for (TopoDS_Iterator it(shape, false, false); it.More(); it.Next()) {
+                m_result.geometryBytes += kChildBytes;
+                stack.push_back(it.Value());
+            }
+        }
+    }
+
+    ShapeFootprint result() const { return m_result; }
+
+private:
+    bool firstVisit(const Handle(Standard_Transient)& object)
+    {
+        return !object.IsNull() && m_objects.insert(object.get()).second;
+    }
+
+    static std::int64_t splineBytes(int poles, int dimension, bool rational, int knots)
+    {
+        std::int64_t bytes = static_cast<std::int64_t>(poles) * dimension * 8;
+        if (rational) bytes += static_cast<std::int64_t>(poles) * 8;
+        // Knots, multiplicities and the flat knot vector
+        bytes += static_cast<std::int64_t>(knots) * 12;
+        bytes += static_cast<std::int64_t>(poles + knots) * 8;
+        return kGeometryBytes + bytes;
+    }
+
+    void addCurve(const Handle(Geom_Curve)& curve)
+    {
+        if (!firstVisit(curve)) return;
+        if (auto bs = Handle(Geom_BSplineCurve)::DownCast(curve)) {
+            m_result.geometryBytes += splineBytes(bs->NbPoles(), 3, bs->IsRational(), bs->NbKnots());
+        } else if (auto bz = Handle(Geom_BezierCurve)::DownCast(curve)) {
+            m_result.geometryBytes += splineBytes(bz->NbPoles(), 3, bz->IsRational(), 0);
+        } else if (auto tc = Handle(Geom_TrimmedCurve)::DownCast(curve)) {
+            m_result.geometryBytes += kGeometryBytes;
+            addCurve(tc->BasisCurve());
+        } else if (auto oc = Handle(Geom_OffsetCurve)::DownCast(curve)) {
+            m_result.geometryBytes += kGeometryBytes;
+            addCurve(oc->BasisCurve());
+        } else {
+            m_result.geometryBytes += kGeometryBytes;
+        }
+    }
+
+    void addCurve2d(const Handle(Geom2d_Curve)& curve)
+    {
+        if (!firstVisit(curve)) return;
+        if (auto bs = Handle(Geom2d_BSplineCurve)::DownCast(curve)) {
+            m_result.geometryBytes += splineBytes(bs->NbPoles(), 2, bs->IsRational(), bs->NbKnots());
+        } else if (auto bz = Handle(Geom2d_BezierCurve)::DownCast(curve)) {
+            m_result.geometryBytes += splineBytes(bz->NbPoles(), 2, bz->IsRational(), 0);
+        } else if (auto tc = Handle(Geom2d_TrimmedCurve)::DownCast(curve)) {
+            m_result.geometryBytes += kGeometryBytes;
+            addCurve2d(tc->BasisCurve());
+        } else if (auto oc = Handle(Geom2d_OffsetCurve)::DownCast(curve)) {
+            m_result.geometryBytes += kGeometryBytes;
+            addCurve2d(oc->BasisCurve());
+        } else {
+            m_result.geometryBytes += kGeometryBytes;
+        }
+    }
+
+    void addSurface(const Handle(Geom_Surface)& surface)
+    {
+        if (!firstVisit(surface)) return;
+        if (auto bs = Handle(Geom_BSplineSurface)::DownCast(surface)) {
+            bool rational = bs->IsURational() || bs->IsVRational();
+            m_result.geometryBytes += splineBytes(bs->NbUPoles() * bs->NbVPoles(), 3, rational,
+                                                  bs->NbUKnots() + bs->NbVKnots());
+        } else if (auto bz = Handle(Geom_BezierSurface)::DownCast(surface)) {
+            bool rational = bz->IsURational() || bz->IsVRational();
+            m_result.geometryBytes += splineBytes(bz->NbUPoles() * bz->NbVPoles(), 3, rational, 0);
+        } else if (auto ts = Handle(Geom_RectangularTrimmedSurface)::DownCast(surface)) {
+            m_result.geometryBytes += kGeometryBytes;
+            addSurface(ts->BasisSurface());
+        } else if (auto os = Handle(Geom_OffsetSurface)::DownCast(surface)) {
+            m_result.geometryBytes += kGeometryBytes;
+            addSurface(os->BasisSurface());
+        } else {
+            m_result.geometryBytes += kGeometryBytes;
+        }
+    }
+
+    void addTriangulation(const Handle(Poly_Triangulation)& mesh)
+    {
+        if (!firstVisit(mesh)) return;
+        std::int64_t nodes = mesh->NbNodes();
+        std::int64_t bytes = kPolyBytes + nodes * 24 + std::int64_t(mesh->NbTriangles()) * 12;
+        if (mesh->HasUVNodes()) bytes += nodes * 16;
+        if (mesh->HasNormals()) bytes += nodes * 12;
+        m_result.tessellationBytes += bytes;
+    }
+
+    void addPolygon(const Handle(Poly_Polygon3D)& polygon)
+    {
+        if (!firstVisit(polygon)) return;
+        std::int64_t nodes = polygon->NbNodes();
+        std::int64_t bytes = kPolyBytes + nodes * 24;
+        if (polygon->HasParameters()) bytes += nodes * 8;
+        m_result.tessellationBytes += bytes;
+    }
+
+    void addPolygon(const Handle(Poly_PolygonOnTriangulation)& polygon)
+    {
+        if (!firstVisit(polygon)) return;
+        std::int64_t nodes = polygon->NbNodes();
+        std::int64_t bytes = kPolyBytes + nodes * 4;
+        if (polygon->HasParameters()) bytes += nodes * 8;
+        m_result.tessellationBytes += bytes;
+    }
+
+    void addEdge(const Handle(BRep_TEdge)& edge)
+    {
+        if (edge.IsNull()) return;
+        for (const Handle(BRep_CurveRepresentation)& rep : edge->Curves()) {
+            m_result.geometryBytes += kRepresentationBytes;
+            if (rep->IsCurve3D()) {
+                addCurve(rep->Curve3D());
+            } else if (rep->IsCurveOnSurface()) {
+                addCurve2d(rep->PCurve());
+                if (rep->IsCurveOnClosedSurface()) addCurve2d(rep->PCurve2());
+            } else if (rep->IsPolygon3D()) {
+                addPolygon(rep->Polygon3D());
+            } else if (rep->IsPolygonOnTriangulation()) {
+                addPolygon(rep->PolygonOnTriangulation());
+                if (rep->IsPolygonOnClosedTriangulation())
+                    addPolygon(rep->PolygonOnTriangulation2());
+            }
+        }
+    }
+
+    void addFace(const Handle(BRep_TFace)& face)
+    {
+        if (face.IsNull()) return;
+        addSurface(face->Surface());
+        for (const Handle(Poly_Triangulation)& mesh : face->Triangulations()) {
+            addTriangulation(mesh);
+        }
+    }
+
+    std::unordered_set<const void*> m_shapes;
+    std::unordered_set<const void*> m_objects;
+    ShapeFootprint m_result;
+};
+
+}  // namespace
+
+// =====================================================================
+//  Tags and Counters
+// =====================================================================
+
+const char* tagName(Tag tag)
+{
+    int index = static_cast<int>(tag);
+    return index >= 0 && index < kTagCount ? kTagInfo[index].name : "unknown";
+}
+
+const char* tagDisplayName(Tag tag)
+{
+    int index = static_cast<int>(tag);
+    return index >= 0 && index < kTagCount ? kTagInfo[index].displayName : "Unknown";
+}
+
+bool tagFromName(const std::string& name, Tag* tag)
+{
+    for (int i = 0; i < kTagCount; ++i) {
+        if (name == kTagInfo[i].name) {
+            if (tag) *tag = static_cast<Tag>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void adjust(Tag tag, std::int64_t bytes)
+{
+    int index = static_cast<int>(tag);
+    if (bytes == 0 || index < 0 || index >= kTagCount) return;
+    addBytes(g_counters[index], bytes);
+    addBytes(g_total, bytes);
+}
+
+TagStats tagStats(Tag tag)
+{
+    TagStats s;
+    s.tag = tag;
+    int index = static_cast<int>(tag);
+    if (index < 0 || index >= kTagCount) return s;
+    const Counter& c = g_counters[index];
+    s.bytes = c.bytes.load(std::memory_order_relaxed);
+    s.peakBytes = c.peak.load(std::memory_order_relaxed);
+    s.owners = c.owners.load(std::memory_order_relaxed);
+    return s;
+}
+
+Stats snapshot()
+{
+    Stats s;
+    for (int i = 0; i < kTagCount; ++i) {
+        s.tags[i] = tagStats(static_cast<Tag>(i));
+    }
+    s.totalBytes = g_total.bytes.load(std::memory_order_relaxed);
+    s.peakTotalBytes = g_total.peak.load(std::memory_order_relaxed);
+    s.heap = heapStats();
+    s.process = processStats();
+    return s;
+}
+
+void resetPeaks()
+{
+    for (Counter& c : g_counters) {
+        c.peak.store(c.bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    g_total.peak.store(g_total.bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+ProcessStats processStats()
+{
+    ProcessStats s;
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        s.available = true;
+        s.residentBytes = static_cast<std::int64_t>(pmc.WorkingSetSize);
+        s.peakResidentBytes = static_cast<std::int64_t>(pmc.PeakWorkingSetSize);
+    }
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+        s.available = true;
+        s.residentBytes = static_cast<std::int64_t>(info.resident_size);
+        s.peakResidentBytes = static_cast<std::int64_t>(info.resident_size_max);
+    }
+#elif defined(__linux__)
+    // statm: total program size, then resident pages
+    if (FILE* f = std::fopen("/proc/self/statm", "r")) {
+        long long pages = 0, resident = 0;
+        if (std::fscanf(f, "%lld %lld", &pages, &resident) == 2) {
+            s.available = true;
+            s.residentBytes = resident * static_cast<std::int64_t>(sysconf(_SC_PAGESIZE));
+        }
+        std::fclose(f);
+    }
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        // ru_maxrss is in kilobytes on Linux
+        s.peakResidentBytes = static_cast<std::int64_t>(usage.ru_maxrss) * 1024;
+    }
+    if (s.peakResidentBytes < s.residentBytes) s.peakResidentBytes = s.residentBytes;
+#endif
+    return s;
+}
+
+// =====================================================================
+//  Charge
+// =====================================================================
+
+Charge::Charge(Tag tag, std::int64_t bytes)
+    : m_tag(tag)
+{
+    g_counters[static_cast<int>(m_tag)].owners.fetch_add(1, std::memory_order_relaxed);
+    set(bytes);
+}
+
+Charge::Charge(const Charge& other)
+    : Charge(other.m_tag, other.m_bytes)
+{
+}
+
+Charge::Charge(Charge&& other) noexcept
+    : m_tag(other.m_tag)
+    , m_bytes(other.m_bytes)
+{
+    g_counters[static_cast<int>(m_tag)].owners.fetch_add(1, std::memory_order_relaxed);
+    other.m_bytes = 0;
+}
+
+Charge& Charge::operator=(const Charge& other)
+{
+    // The tag stays: a charge always belongs to its owner's category
+    if (this != &other) set(other.m_bytes);
+    return *this;
+}
+
+Charge& Charge::operator=(Charge&& other) noexcept
+{
+    if (this != &other) {
+        if (other.m_tag == m_tag) {
+            // Take the bytes over without touching the counters
+            adjust(m_tag, -m_bytes);
+            m_bytes = other.m_bytes;
+            other.m_bytes = 0;
+        } else {
+            set(other.m_bytes);
+            other.set(0);
+        }
+    }
+    return *this;
+}
+
+Charge::~Charge()
+{
+    set(0);
+    g_counters[static_cast<int>(m_tag)].owners.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void Charge::set(std::int64_t bytes)
+{
+    if (bytes < 0) bytes = 0;
+    adjust(m_tag, bytes - m_bytes);
+    m_bytes = bytes;
+}
+
+// =====================================================================
+//  Size Estimates
+// =====================================================================
+
+ShapeFootprint shapeFootprint(const TopoDS_Shape& shape)
+{
+    FootprintWalker walker;
+    walker.add(shape);
+    return walker.result();
+}
+
+ShapeFootprint shapeFootprint(const std::vector<TopoDS_Shape>& shapes)
+{
+    FootprintWalker walker;
+    for (const TopoDS_Shape& shape : shapes) {
+        walker.add(shape);
+    }
+    return walker.result();
+}
+
+std::int64_t footprint(const sketch::Entity& entity)
+{
+    std::int64_t bytes = static_cast<std::int64_t>(sizeof(sketch::Entity)) +
+        heapBytes(entity.points) + heapBytes(entity.text) + heapBytes(entity.fontFamily);
+
+    // A spline's fitted curve, once something has asked for it
+    if (entity.splineCache) {
+        if (auto curve = entity.splineCurve()) {
+            bytes += static_cast<std::int64_t>(sizeof(geometry::BSplineCurve2D) + curve->memoryUsage());
+        }
+    }
+    return bytes;
+}
+
+std::int64_t footprint(const sketch::Constraint& constraint)
+{
+    return static_cast<std::int64_t>(sizeof(sketch::Constraint)) +
+           heapBytes(constraint.entityIds) + heapBytes(constraint.pointIndices);
+}
+
+std::int64_t footprint(const sketch::Group& group)
+{
+    return static_cast<std::int64_t>(sizeof(sketch::Group)) + heapBytes(group.name) +
+           heapBytes(group.entityIds) + heapBytes(group.constraintIds) +
+           heapBytes(group.childGroupIds);
+}
+
+std::int64_t footprint(const sketch::BackgroundImage& image)
+{
+    return heapBytes(image.imageData) + heapBytes(image.filePath) + heapBytes(image.mimeType);
+}
+
+// =====================================================================
+//  Budgets
+// =====================================================================
+
+bool parseByteSize(const std::string& text, std::int64_t* bytes)
+{
+    if (text.empty()) return false;
+
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || !std::isfinite(value) || value < 0.0) return false;
+
+    std::string suffix(end);
+    for (char& c : suffix) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    if (!suffix.empty() && suffix.back() == 'B') suffix.pop_back();
+    if (suffix.size() == 2 && suffix[1] == 'I') suffix.pop_back();  // "KiB", "MiB"
+
+    double scale = 1.0;
+    if (suffix == "K") scale = 1024.0;
+    else if (suffix == "M") scale = 1024.0 * 1024.0;
+    else if (suffix == "G") scale = 1024.0 * 1024.0 * 1024.0;
+    else if (suffix == "T") scale = 1024.0 * 1024.0 * 1024.0 * 1024.0;
+    else if (!suffix.empty()) return false;
+
+    double result = value * scale;
+    if (result > 9.0e18) return false;
+    if (bytes) *bytes = static_cast<std::int64_t>(std::llround(result));
+    return true;
+}
+
+std::string formatBytes(std::int64_t bytes)
+{
+    static const char* const kUnits[] = {"KiB", "MiB", "GiB", "TiB"};
+
+    if (bytes > -1024 && bytes < 1024) {
+        return std::to_string(bytes) + " B";
+    }
+    double value = static_cast<double>(bytes);
+    int unit = -1;
+    while (std::fabs(value) >= 1024.0 && unit < 3) {
+        value /= 1024.0;
+        ++unit;
+    }
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.1f %s", value, kUnits[unit]);
+    return buf;
+}
+
+bool parseBudget(const std::string& spec, Budget* budget, std::string* errorMsg)
+{
+    auto eq = spec.find('=');
+    if (eq == std::string::npos) {
+        if (errorMsg) *errorMsg = "Expected <counter>=<size>: " + spec;
+        return false;
+    }
+
+    std::string key = spec.substr(0, eq);
+    if (key != "total" && key != "heap" && key != "rss" && !tagFromName(key, nullptr)) {
+        if (errorMsg) *errorMsg = "Unknown counter: " + key;
+        return false;
+    }
+
+    std::int64_t limit = 0;
+    if (!parseByteSize(spec.substr(eq + 1), &limit)) {
+        if (errorMsg) *errorMsg = "Invalid size: " + spec.substr(eq + 1);
+        return false;
+    }
+
+    if (budget) {
+        budget->key = key;
+        budget->limitBytes = limit;
+    }
+    return true;
+}
+
+std::vector<BudgetViolation> checkBudgets(const Stats& stats,
+                                          const std::vector<Budget>& budgets)
+{
+    std::vector<BudgetViolation> violations;
+
+    for (const Budget& budget : budgets) {
+        std::int64_t peak = 0;
+        Tag tag = Tag::ProjectBodies;
+        if (budget.key == "total") {
+            peak = stats.peakTotalBytes;
+        } else if (budget.key == "heap") {
+            if (!stats.heap.enabled) continue;
+            peak = stats.heap.peakBytes;
+        } else if (budget.key == "rss") {
+            if (!stats.process.available) continue;
+            peak = stats.process.peakResidentBytes;
+        } else if (tagFromName(budget.key, &tag)) {
+            peak = stats.tags[static_cast<int>(tag)].peakBytes;
+        } else {
+            continue;
+        }
+
+        if (peak > budget.limitBytes) {
+            violations.push_back({budget.key, budget.limitBytes, peak});
+        }
+    }
+
+    return violations;
+}
+
+}  // namespace memory
+}  // namespace hobbycad
+
+// =====================================================================
+//  Allocation Hooks
+// =====================================================================
+//
+//  With HOBBYCAD_MEMORY_HOOKS the global operator new/delete keep the
+//  block size in a header in front of each allocation so frees can be
+//  counted.  Over-aligned new/delete are left to the runtime.  OCCT
+//  allocates through its own Standard::Allocate and is not counted.
+
+#if HOBBYCAD_MEMORY_HOOKS
+
+namespace {
+
+constexpr std::size_t kHeaderBytes = alignof(std::max_align_t) > sizeof(std::size_t)
+                                         ? alignof(std::max_align_t)
+                                         : sizeof(std::size_t);
+
+std::atomic<std::int64_t> g_heapBytes{0};
+std::atomic<std::int64_t> g_heapPeak{0};
+std::atomic<std::int64_t> g_heapAllocations{0};
+std::atomic<std::int64_t> g_heapDeallocations{0};
+
+void* hookedAllocate(std::size_t size) noexcept
+{
+    // The header must not wrap the block size around
+    if (size > std::numeric_limits<std::size_t>::max() - kHeaderBytes) return nullptr;
+
+    void* block = std::malloc(size + kHeaderBytes);
+    if (!block) return nullptr;
+    *static_cast<std::size_t*>(block) = size;
+
+    std::int64_t bytes = static_cast<std::int64_t>(size);
+    std::int64_t now = g_heapBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    std::int64_t seen = g_heapPeak.load(std::memory_order_relaxed);
+    while (now > seen &&
+           !g_heapPeak.compare_exchange_weak(seen, now, std::memory_order_relaxed)) {
+    }
+    return static_cast<char*>(block) + kHeaderBytes;
+}
+
+void* hookedNew(std::size_t size)
+{
+    for (;;) {
+        if (void* p = hookedAllocate(size)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+/// Non-throwing new still runs the new_handler loop; only the final
+/// failure is reported as nullptr instead of std::bad_alloc
+void* hookedNewNothrow(std::size_t size) noexcept
+{
+    try {
+        return hookedNew(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void hookedFree(void* p) noexcept
+{
+    if (!p) return;
+    char* block = static_cast<char*>(p) - kHeaderBytes;
+    std::size_t size = *reinterpret_cast<std::size_t*>(block);
+    g_heapBytes.fetch_sub(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+    g_heapDeallocations.fetch_add(1, std::memory_order_relaxed);
+    std::free(block);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) { return hookedNew(size); }
+void* operator new[](std::size_t size) { return hookedNew(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return hookedNewNothrow(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return hookedNewNothrow(size); }
+void operator delete(void* p) noexcept { hookedFree(p); }
+void operator delete[](void* p) noexcept { hookedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { hookedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { hookedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { hookedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { hookedFree(p); }
+
+hobbycad::memory::HeapStats hobbycad::memory::heapStats()
+{
+    HeapStats s;
+    s.enabled = true;
+    s.bytes = g_heapBytes.load(std::memory_order_relaxed);
+    s.peakBytes = g_heapPeak.load(std::memory_order_relaxed);
+    s.allocations = g_heapAllocations.load(std::memory_order_relaxed);
+    s.deallocations = g_heapDeallocations.load(std::memory_order_relaxed);
+    return s;
+}
+
+#else
+
+hobbycad::memory::HeapStats hobbycad::memory::heapStats()
+{
+    return {};
+}
+
+#endif  // HOBBYCAD_MEMORY_HOOKS
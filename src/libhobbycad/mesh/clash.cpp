@@ -0,0 +1,854 @@
+// =====================================================================
+//  src/libhobbycad/mesh/clash.cpp — Clash and clearance detection
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/mesh/clash.h>
+
+#include <OSD_Parallel.hxx>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace hobbycad {
+namespace mesh {
+
+namespace {
+
+/// Leaves hold at most this many items
+constexpr int kLeafSize = 4;
+
+/// Ray hits closer than this fraction of the overlap size are one hit
+constexpr double kRayHitTolerance = 1e-9;
+
+double coord(const MeshPoint& p, int axis)
+{
+    return axis == 0 ? p.x : (axis == 1 ? p.y : p.z);
+}
+
+double boxDistanceSquared(const MeshBox& a, const MeshBox& b)
+{
+    double d2 = 0.0;
+    for (int k = 0; k < 3; ++k) {
+        const double gap = std::max(coord(a.min, k) - coord(b.max, k),
+                                    coord(b.min, k) - coord(a.max, k));
+        if (gap > 0.0) d2 += gap * gap;
+    }
+    return d2;
+}
+
+double boxVolume(const MeshBox& b)
+{
+    if (b.isEmpty()) return 0.0;
+    return (b.max.x - b.min.x) * (b.max.y - b.min.y) * (b.max.z - b.min.z);
+}
+
+MeshBox boxIntersection(const MeshBox& a, const MeshBox& b)
+{
+    MeshBox r;
+    r.min = {std::max(a.min.x, b.min.x), std::max(a.min.y, b.min.y), std::max(a.min.z, b.min.z)};
+    r.max = {std::min(a.max.x, b.max.x), std::min(a.max.y, b.max.y), std::min(a.max.z, b.max.z)};
+    if (r.min.x > r.max.x || r.min.y > r.max.y || r.min.z > r.max.z) return MeshBox();
+    return r;
+}
+
+bool boxContains(const MeshBox& b, const MeshPoint& p)
+{
+    return p.x >= b.min.x && p.x <= b.max.x &&
+           p.y >= b.min.y && p.y <= b.max.y &&
+           p.z >= b.min.z && p.z <= b.max.z;
+}
+
+using Triangle = std::array<MeshPoint, 3>;
+
+Triangle corners(const TriangleMesh& mesh, int t)
+{
+    const MeshTriangle& tri = mesh.triangles[t];
+    return {mesh.vertices[tri[0]], mesh.vertices[tri[1]], mesh.vertices[tri[2]]};
+}
+
+// =====================================================================
+//  Triangle Primitives
+// =====================================================================
+
+/// Closest point on a triangle (Ericson, Real-Time Collision Detection 5.1.5)
+MeshPoint closestOnTriangle(const MeshPoint& p, const Triangle& t)
+{
+    const MeshPoint& a = t[0];
+    const MeshPoint& b = t[1];
+    const MeshPoint& c = t[2];
+    const MeshPoint ab = b - a, ac = c - a, ap = p - a;
+    const double d1 = ab.dot(ap), d2 = ac.dot(ap);
+    if (d1 <= 0.0 && d2 <= 0.0) return a;
+
+    const MeshPoint bp = p - b;
+    const double d3 = ab.dot(bp), d4 = ac.dot(bp);
+    if (d3 >= 0.0 && d4 <= d3) return b;
+
+    const double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) return a + ab * (d1 / (d1 - d3));
+
+    const MeshPoint cp = p - c;
+    const double d5 = ab.dot(cp), d6 = ac.dot(cp);
+    if (d6 >= 0.0 && d5 <= d6) return c;
+
+    const double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) return a + ac * (d2 / (d2 - d6));
+
+    const double va = d3 * d6 - d5 * d4;
+    if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    const double denom = va + vb + vc;
+    if (denom <= 0.0) return a;  // degenerate triangle
+    return a + ab * (vb / denom) + ac * (vc / denom);
+}
+
+/// Closest points of two segments (Ericson 5.1.9)
+void closestSegmentSegment(const MeshPoint& p1, const MeshPoint& q1,
+                           const MeshPoint& p2, const MeshPoint& q2,
+                           MeshPoint& c1, MeshPoint& c2)
+{
+    const MeshPoint d1 = q1 - p1, d2 = q2 - p2, r = p1 - p2;
+    const double a = d1.dot(d1), e = d2.dot(d2), f = d2.dot(r);
+    double s = 0.0, t = 0.0;
+    if (a <= 1e-300 && e <= 1e-300) {
+        c1 = p1;
+        c2 = p2;
+        return;
+    }
+    if (a <= 1e-300) {
+        t = std::clamp(f / e, 0.0, 1.0);
+    } else {
+        const double c = d1.dot(r);
+        if (e <= 1e-300) {
+            s = std::clamp(-c / a, 0.0, 1.0);
+        } else {
+            const double b = d1.dot(d2);
+            const double denom = a * e - b * b;
+            s = denom > 0.0 ? std::clamp((b * f - c * e) / denom, 0.0, 1.0) : 0.0;
+            t = (b * s + f) / e;
+            if (t < 0.0) {
+                t = 0.0;
+                s = std::clamp(-c / a, 0.0, 1.0);
+            } else if (t > 1.0) {
+                t = 1.0;
+                s = std::clamp((b - c) / a, 0.0, 1.0);
+            }
+        }
+    }
+    c1 = p1 + d1 * s;
+    c2 = p2 + d2 * t;
+}
+
+/// Point where segment pq crosses triangle t, if it does
+bool segmentCrossesTriangle(const MeshPoint& p, const MeshPoint& q, const Triangle& t,
+                            MeshPoint& hit)
+{
+    const MeshPoint e1 = t[1] - t[0], e2 = t[2] - t[0], d = q - p;
+    const MeshPoint h = d.cross(e2);
+    const double det = e1.dot(h);
+    if (std::abs(det) < 1e-300) return false;
+    const double inv = 1.0 / det;
+    const MeshPoint s = p - t[0];
+    const double u = s.dot(h) * inv;
+    if (u < 0.0 || u > 1.0) return false;
+    const MeshPoint qv = s.cross(e1);
+    const double v = d.dot(qv) * inv;
+    if (v < 0.0 || u + v > 1.0) return false;
+    const double w = e2.dot(qv) * inv;
+    if (w < 0.0 || w > 1.0) return false;
+    hit = p + d * w;
+    return true;
+}
+
+/// Squared distance between two triangles, with the closest points
+double triangleDistanceSquared(const Triangle& a, const Triangle& b,
+                               MeshPoint& pa, MeshPoint& pb)
+{
+    double best = std::numeric_limits<double>::max();
+    auto consider = [&](const MeshPoint& x, const MeshPoint& y) {
+        const MeshPoint d = x - y;
+        const double d2 = d.dot(d);
+        if (d2 < best) {
+            best = d2;
+            pa = x;
+            pb = y;
+        }
+    };
+
+    MeshPoint hit;
+    for (int i = 0; i < 3; ++i) {
+        const MeshPoint& p = a[i];
+        const MeshPoint& q = a[(i + 1) % 3];
+        if (segmentCrossesTriangle(p, q, b, hit)) {
+            pa = pb = hit;
+            return 0.0;
+        }
+        if (segmentCrossesTriangle(b[i], b[(i + 1) % 3], a, hit)) {
+            pa = pb = hit;
+            return 0.0;
+        }
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        consider(a[i], closestOnTriangle(a[i], b));
+        consider(closestOnTriangle(b[i], a), b[i]);
+    }
+    MeshPoint ca, cb;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            closestSegmentSegment(a[i], a[(i + 1) % 3], b[j], b[(j + 1) % 3], ca, cb);
+            consider(ca, cb);
+        }
+    }
+    return best;
+}
+
+/// Interval of triangle t on the line dir, where t crosses the plane
+/// with signed vertex distances d
+bool planeInterval(const Triangle& t, const double d[3], const MeshPoint& dir,
+                   double& lo, double& hi)
+{
+    lo = std::numeric_limits<double>::max();
+    hi = -lo;
+    bool any = false;
+    for (int i = 0; i < 3; ++i) {
+        const int j = (i + 1) % 3;
+        if (d[i] == 0.0) {
+            const double s = t[i].dot(dir);
+            lo = std::min(lo, s);
+            hi = std::max(hi, s);
+            any = true;
+        }
+        if ((d[i] < 0.0 && d[j] > 0.0) || (d[i] > 0.0 && d[j] < 0.0)) {
+            const MeshPoint x = t[i] + (t[j] - t[i]) * (d[i] / (d[i] - d[j]));
+            const double s = x.dot(dir);
+            lo = std::min(lo, s);
+            hi = std::max(hi, s);
+            any = true;
+        }
+    }
+    return any;
+}
+
+/// True if the triangles pass through each other by more than
+/// tolerance.  Triangles that only touch, or lie in one plane, do not.
+bool trianglesCross(const Triangle& a, const Triangle& b, double tolerance, MeshPoint& at)
+{
+    const MeshPoint na = (a[1] - a[0]).cross(a[2] - a[0]);
+    const MeshPoint nb = (b[1] - b[0]).cross(b[2] - b[0]);
+    const double la = na.length(), lb = nb.length();
+    if (la <= 0.0 || lb <= 0.0) return false;
+
+    double db[3], da[3];
+    double minB = 0.0, maxB = 0.0, minA = 0.0, maxA = 0.0;
+    for (int i = 0; i < 3; ++i) {
+        db[i] = na.dot(b[i] - a[0]) / la;
+        da[i] = nb.dot(a[i] - b[0]) / lb;
+        minB = std::min(minB, db[i]);
+        maxB = std::max(maxB, db[i]);
+        minA = std::min(minA, da[i]);
+        maxA = std::max(maxA, da[i]);
+    }
+    if (maxB <= tolerance || minB >= -tolerance) return false;
+    if (maxA <= tolerance || minA >= -tolerance) return false;
+
+    MeshPoint dir = na.cross(nb);
+    const double dl = dir.length();
+    if (dl <= 1e-12 * la * lb) return false;
+    dir = dir * (1.0 / dl);
+
+    double loA, hiA, loB, hiB;
+    if (!planeInterval(a, da, dir, loA, hiA) || !planeInterval(b, db, dir, loB, hiB))
+        return false;
+    const double lo = std::max(loA, loB), hi = std::min(hiA, hiB);
+    if (hi - lo <= tolerance) return false;
+
+    // A point on the crossing: the middle of the shared interval,
+    // on the line where the planes meet
+    const double ca = na.dot(a[0]) / la, cb = nb.dot(b[0]) / lb;
+    const MeshPoint ua = na * (1.0 / la), ub = nb * (1.0 / lb);
+    const double c = ua.dot(ub);
+    const double det = 1.0 - c * c;
+    const MeshPoint base = ua * ((ca - cb * c) / det) + ub * ((cb - ca * c) / det);
+    at = base + dir * (0.5 * (lo + hi) - base.dot(dir));
+    return true;
+}
+
+// =====================================================================
+//  Ray Casting
+// =====================================================================
+
+/// A surface crossing along a ray: position and +1 entering / -1 leaving
+struct RayHit {
+    double t;
+    int delta;
+    bool operator<(const RayHit& o) const { return t < o.t || (t == o.t && delta < o.delta); }
+};
+
+/// All crossings of the line through (u, v) parallel to axis, where u
+/// and v are the coordinates on the next two axes in cyclic order
+void castRay(const TriangleMesh& mesh, const BoxTree& tree, int axis, double u, double v,
+             std::vector<RayHit>& hits)
+{
+    hits.clear();
+    if (tree.isEmpty()) return;
+    const int ua = (axis + 1) % 3, va = (axis + 2) % 3;
+    const auto& nodes = tree.nodes();
+    int stack[128];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const BoxTree::Node& node = nodes[stack[--top]];
+        if (u < coord(node.box.min, ua) || u > coord(node.box.max, ua) ||
+            v < coord(node.box.min, va) || v > coord(node.box.max, va))
+            continue;
+        if (!node.isLeaf()) {
+            stack[top++] = node.left;
+            stack[top++] = node.right;
+            continue;
+        }
+        for (int k = node.first; k < node.first + node.count; ++k) {
+            const Triangle t = corners(mesh, tree.items()[k]);
+            double pu[3], pv[3];
+            for (int i = 0; i < 3; ++i) {
+                pu[i] = coord(t[i], ua) - u;
+                pv[i] = coord(t[i], va) - v;
+            }
+            // Twice the signed areas of the sub-triangles opposite each corner
+            const double w0 = pu[1] * pv[2] - pv[1] * pu[2];
+            const double w1 = pu[2] * pv[0] - pv[2] * pu[0];
+            const double w2 = pu[0] * pv[1] - pv[0] * pu[1];
+            const double area = w0 + w1 + w2;
+            if (area == 0.0) continue;
+            if (area > 0.0 ? (w0 < 0.0 || w1 < 0.0 || w2 < 0.0)
+                           : (w0 > 0.0 || w1 > 0.0 || w2 > 0.0))
+                continue;
+            const double s = (w0 * coord(t[0], axis) + w1 * coord(t[1], axis) +
+                              w2 * coord(t[2], axis)) / area;
+            // The outward normal points along +axis where the ray leaves
+            hits.push_back({s, area > 0.0 ? -1 : 1});
+        }
+    }
+    std::sort(hits.begin(), hits.end());
+}
+
+/// Turn sorted hits into the intervals where the winding number is
+/// positive.  A ray through a shared edge hits both triangles, so hits
+/// at the same place in the same sense count once.
+void insideIntervals(const std::vector<RayHit>& hits, double eps,
+                     std::vector<std::pair<double, double>>& intervals)
+{
+    intervals.clear();
+    int winding = 0;
+    double start = 0.0;
+    for (size_t i = 0; i < hits.size(); ++i) {
+        bool repeated = false;
+        for (size_t j = i; j-- > 0 && hits[i].t - hits[j].t <= eps;) {
+            if (hits[j].delta == hits[i].delta) {
+                repeated = true;
+                break;
+            }
+        }
+        if (repeated) continue;
+        const int before = winding;
+        winding += hits[i].delta;
+        if (before <= 0 && winding > 0) start = hits[i].t;
+        else if (before > 0 && winding <= 0) intervals.push_back({start, hits[i].t});
+    }
+}
+
+double overlapLength(const std::vector<std::pair<double, double>>& a,
+                     const std::vector<std::pair<double, double>>& b)
+{
+    double length = 0.0;
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        const double lo = std::max(a[i].first, b[j].first);
+        const double hi = std::min(a[i].second, b[j].second);
+        if (hi > lo) length += hi - lo;
+        if (a[i].second < b[j].second) ++i;
+        else ++j;
+    }
+    return length;
+}
+
+// =====================================================================
+//  Dual Traversal
+// =====================================================================
+
+/// Visit leaf pairs of two trees (or of one tree with itself when
+/// self is true) whose boxes are within margin.  visit returns false
+/// to stop early.
+template <typename Visit>
+void traverseLeafPairs(const BoxTree& a, const BoxTree& b, double margin, bool self,
+                       Visit visit)
+{
+    if (a.isEmpty() || b.isEmpty()) return;
+    const auto& na = a.nodes();
+    const auto& nb = b.nodes();
+    std::vector<std::pair<int, int>> stack;
+    stack.push_back({0, 0});
+    while (!stack.empty()) {
+        const auto [i, j] = stack.back();
+        stack.pop_back();
+        const BoxTree::Node& x = na[i];
+        const BoxTree::Node& y = nb[j];
+        if (self && i == j) {
+            if (x.isLeaf()) {
+                if (!visit(x, y)) return;
+            } else {
+                stack.push_back({x.left, x.left});
+                stack.push_back({x.right, x.right});
+                stack.push_back({x.left, x.right});
+            }
+            continue;
+        }
+        if (!x.box.overlaps(y.box, margin)) continue;
+        if (x.isLeaf() && y.isLeaf()) {
+            if (!visit(x, y)) return;
+        } else if (y.isLeaf() || (!x.isLeaf() && boxVolume(x.box) >= boxVolume(y.box))) {
+            stack.push_back({x.left, j});
+            stack.push_back({x.right, j});
+        } else {
+            stack.push_back({i, y.left});
+            stack.push_back({i, y.right});
+        }
+    }
+}
+
+// =====================================================================
+//  Pair Classification
+// =====================================================================
+
+struct BodyData {
+    const TriangleMesh* mesh = nullptr;
+    BoxTree tree;
+    MeshBox box;
+};
+
+/// Volume below which touching surfaces are contact: the overlap must
+/// be thicker than the tolerance across its largest face
+double contactVolume(const MeshBox& a, const MeshBox& b, double tolerance)
+{
+    const MeshBox o = boxIntersection(a, b);
+    if (o.isEmpty()) return 0.0;
+    const double dx = o.max.x - o.min.x, dy = o.max.y - o.min.y, dz = o.max.z - o.min.z;
+    return tolerance * std::max({dx * dy, dy * dz, dz * dx});
+}
+
+/// First vertex a triangle uses; meshes may carry unused vertices
+bool firstVertex(const TriangleMesh& mesh, MeshPoint& p)
+{
+    if (mesh.triangles.empty()) return false;
+    p = mesh.vertices[mesh.triangles.front()[0]];
+    return true;
+}
+
+bool classifyPair(const BodyData& a, const BodyData& b, const ClashOptions& options,
+                  ClashPair& clash)
+{
+    const double tol = options.contactTolerance;
+    const double reach = std::max(options.clearance, tol);
+    const MeshProximity prox = meshProximity(*a.mesh, a.tree, *b.mesh, b.tree, reach, tol);
+
+    if (prox.intersecting) {
+        clash.type = ClashType::Interference;
+        clash.pointA = prox.pointA;
+        clash.pointB = prox.pointB;
+        if (options.computeVolumes)
+            clash.volume = interferenceVolume(*a.mesh, a.tree, *b.mesh, b.tree,
+                                              options.volumeSamples);
+        return true;
+    }
+
+    if (prox.distance >= 0.0 && prox.distance <= tol) {
+        // Touching: flush faces can still enclose shared volume
+        const double volume = interferenceVolume(*a.mesh, a.tree, *b.mesh, b.tree,
+                                                 options.volumeSamples);
+        clash.pointA = prox.pointA;
+        clash.pointB = prox.pointB;
+        if (volume > contactVolume(a.box, b.box, tol)) {
+            clash.type = ClashType::Interference;
+            clash.volume = options.computeVolumes ? volume : 0.0;
+        } else {
+            clash.type = ClashType::Contact;
+            clash.distance = prox.distance;
+        }
+        return true;
+    }
+
+    // Surfaces apart: one body may still lie inside the other
+    MeshPoint p;
+    const bool aInB = firstVertex(*a.mesh, p) && boxContains(b.box, p) &&
+                      pointInside(*b.mesh, b.tree, p);
+    const bool bInA = !aInB && firstVertex(*b.mesh, p) && boxContains(a.box, p) &&
+                      pointInside(*a.mesh, a.tree, p);
+    if (aInB || bInA) {
+        clash.type = ClashType::Interference;
+        clash.pointA = clash.pointB = p;
+        if (options.computeVolumes)
+            clash.volume = interferenceVolume(*a.mesh, a.tree, *b.mesh, b.tree,
+                                              options.volumeSamples);
+        return true;
+    }
+
+    if (prox.distance >= 0.0 && prox.distance <= options.clearance) {
+        clash.type = ClashType::Clearance;
+        clash.distance = prox.distance;
+        clash.pointA = prox.pointA;
+        clash.pointB = prox.pointB;
+        return true;
+    }
+    return false;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+}  // anonymous namespace
+
+// =====================================================================
+//  MeshBox
+// =====================================================================
+
+void MeshBox::add(const MeshPoint& p)
+{
+    min = {std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z)};
+    max = {std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z)};
+}
+
+void MeshBox::add(const MeshBox& b)
+{
+    if (b.isEmpty()) return;
+    add(b.min);
+    add(b.max);
+}
+
+bool MeshBox::overlaps(const MeshBox& o, double margin) const
+{
+    return min.x <= o.max.x + margin && o.min.x <= max.x + margin &&
+           min.y <= o.max.y + margin && o.min.y <= max.y + margin &&
+           min.z <= o.max.z + margin && o.min.z <= max.z + margin;
+}
+
+double MeshBox::distance(const MeshBox& o) const
+{
+    return std::sqrt(boxDistanceSquared(*this, o));
+}
+
+// =====================================================================
+//  BoxTree
+// =====================================================================
+
+void BoxTree::build(const std::vector<MeshBox>& boxes)
+{
+    m_boxes = boxes;
+    m_nodes.clear();
+    m_items.clear();
+    for (int i = 0; i < static_cast<int>(boxes.size()); ++i)
+        if (!boxes[i].isEmpty()) m_items.push_back(i);
+    if (m_items.empty()) return;
+
+    std::vector<MeshPoint> centers(boxes.size());
+    for (int i : m_items) centers[i] = (boxes[i].min + boxes[i].max) * 0.5;
+
+    m_nodes.reserve(2 * m_items.size() / kLeafSize + 1);
+    m_nodes.push_back({});
+    m_nodes[0].count = static_cast<int>(m_items.size());
+
+    // Split nodes depth-first; every node starts out as a leaf over
+    // its item range
+    std::vector<int> pending{0};
+    while (!pending.empty()) {
+        const int n = pending.back();
+        pending.pop_back();
+        const int first = m_nodes[n].first, count = m_nodes[n].count;
+        auto begin = m_items.begin() + first, end = begin + count;
+
+        MeshBox box, spread;
+        for (auto it = begin; it != end; ++it) {
+            box.add(m_boxes[*it]);
+            spread.add(centers[*it]);
+        }
+        m_nodes[n].box = box;
+        if (count <= kLeafSize) continue;
+
+        const MeshPoint extent = spread.max - spread.min;
+        const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0
+                       : (extent.y >= extent.z ? 1 : 2);
+        if (coord(extent, axis) <= 0.0) continue;  // all centers coincide
+
+        const int half = count / 2;
+        std::nth_element(begin, begin + half, end, [&](int p, int q) {
+            return coord(centers[p], axis) < coord(centers[q], axis);
+        });
+
+        const int left = static_cast<int>(m_nodes.size());
+        m_nodes.push_back({});
+        m_nodes.push_back({});
+        m_nodes[left].first = first;
+        m_nodes[left].count = half;
+        m_nodes[left + 1].first = first + half;
+        m_nodes[left + 1].count = count - half;
+        m_nodes[n].left = left;
+        m_nodes[n].right = left + 1;
+        m_nodes[n].count = 0;
+        pending.push_back(left);
+        pending.push_back(left + 1);
+    }
+}
+
+std::vector<std::pair<int, int>> BoxTree::selfPairs(double margin) const
+{
+    std::vector<std::pair<int, int>> result;
+    traverseLeafPairs(*this, *this, margin, true, [&](const Node& x, const Node& y) {
+        const bool same = &x == &y;
+        for (int i = x.first; i < x.first + x.count; ++i) {
+            for (int j = same ? i + 1 : y.first; j < y.first + y.count; ++j) {
+                const int p = m_items[i], q = m_items[j];
+                if (m_boxes[p].overlaps(m_boxes[q], margin))
+                    result.push_back({std::min(p, q), std::max(p, q)});
+            }
+        }
+        return true;
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<std::pair<int, int>> BoxTree::pairs(const BoxTree& other, double margin) const
+{
+    std::vector<std::pair<int, int>> result;
+    traverseLeafPairs(*this, other, margin, false, [&](const Node& x, const Node& y) {
+        for (int i = x.first; i < x.first + x.count; ++i) {
+            for (int j = y.first; j < y.first + y.count; ++j) {
+                const int p = m_items[i], q = other.m_items[j];
+                if (m_boxes[p].overlaps(other.m_boxes[q], margin)) result.push_back({p, q});
+            }
+        }
+        return true;
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+BoxTree triangleTree(const TriangleMesh& mesh)
+{
+    std::vector<MeshBox> boxes(mesh.triangles.size());
+    for (size_t t = 0; t < mesh.triangles.size(); ++t)
+        for (int v : mesh.triangles[t]) boxes[t].add(mesh.vertices[v]);
+    return BoxTree(boxes);
+}
+
+// =====================================================================
+//  Pair Queries
+// =====================================================================
+
+MeshProximity meshProximity(const TriangleMesh& a, const BoxTree& treeA,
+                            const TriangleMesh& b, const BoxTree& treeB,
+                            double maxDistance, double tolerance)
+{
+    MeshProximity result;
+    if (treeA.isEmpty() || treeB.isEmpty()) return result;
+
+    // Crossing triangles first; any one settles the question
+    traverseLeafPairs(treeA, treeB, 0.0, false,
+                      [&](const BoxTree::Node& x, const BoxTree::Node& y) {
+        for (int i = x.first; i < x.first + x.count; ++i) {
+            const int ta = treeA.items()[i];
+            const Triangle tri = corners(a, ta);
+            for (int j = y.first; j < y.first + y.count; ++j) {
+                const int tb = treeB.items()[j];
+                if (!treeA.itemBox(ta).overlaps(treeB.itemBox(tb))) continue;
+                MeshPoint at;
+                if (trianglesCross(tri, corners(b, tb), tolerance, at)) {
+                    result.intersecting = true;
+                    result.distance = 0.0;
+                    result.pointA = result.pointB = at;
+                    return false;
+                }
+            }
+        }
+        return true;
+    });
+    if (result.intersecting) return result;
+
+    // Branch and bound on the minimum distance, nearest node pair first
+    double best = maxDistance * maxDistance;
+    bool found = false;
+    const auto& na = treeA.nodes();
+    const auto& nb = treeB.nodes();
+    std::vector<std::pair<int, int>> stack{{0, 0}};
+    while (!stack.empty()) {
+        const auto [i, j] = stack.back();
+        stack.pop_back();
+        const BoxTree::Node& x = na[i];
+        const BoxTree::Node& y = nb[j];
+        if (boxDistanceSquared(x.box, y.box) > best) continue;
+
+        if (x.isLeaf() && y.isLeaf()) {
+            for (int p = x.first; p < x.first + x.count; ++p) {
+                const int ta = treeA.items()[p];
+                const Triangle tri = corners(a, ta);
+                for (int q = y.first; q < y.first + y.count; ++q) {
+                    const int tb = treeB.items()[q];
+                    if (boxDistanceSquared(treeA.itemBox(ta), treeB.itemBox(tb)) > best)
+                        continue;
+                    MeshPoint pa, pb;
+                    const double d2 = triangleDistanceSquared(tri, corners(b, tb), pa, pb);
+                    if (d2 <= best) {
+                        best = d2;
+                        found = true;
+                        result.pointA = pa;
+                        result.pointB = pb;
+                    }
+                }
+            }
+            continue;
+        }
+
+        std::pair<int, int> first, second;
+        if (y.isLeaf() || (!x.isLeaf() && boxVolume(x.box) >= boxVolume(y.box))) {
+            first = {x.left, j};
+            second = {x.right, j};
+        } else {
+            first = {i, y.left};
+            second = {i, y.right};
+        }
+        const double d1 = boxDistanceSquared(na[first.first].box, nb[first.second].box);
+        const double d2 = boxDistanceSquared(na[second.first].box, nb[second.second].box);
+        if (d1 < d2) std::swap(first, second);
+        stack.push_back(first);   // farther pair
+        stack.push_back(second);  // nearer pair, popped next
+    }
+    if (found) result.distance = std::sqrt(best);
+    return result;
+}
+
+bool pointInside(const TriangleMesh& mesh, const BoxTree& tree, const MeshPoint& p)
+{
+    if (tree.isEmpty() || !boxContains(tree.bounds(), p)) return false;
+    std::vector<RayHit> hits;
+    castRay(mesh, tree, 2, p.x, p.y, hits);
+    std::vector<std::pair<double, double>> intervals;
+    const MeshBox box = tree.bounds();
+    insideIntervals(hits, kRayHitTolerance * (box.max.z - box.min.z), intervals);
+    for (const auto& [lo, hi] : intervals)
+        if (p.z > lo && p.z < hi) return true;
+    return false;
+}
+
+double interferenceVolume(const TriangleMesh& a, const BoxTree& treeA,
+                          const TriangleMesh& b, const BoxTree& treeB,
+                          int samples)
+{
+    if (treeA.isEmpty() || treeB.isEmpty() || samples < 1) return 0.0;
+    const MeshBox o = boxIntersection(treeA.bounds(), treeB.bounds());
+    if (o.isEmpty()) return 0.0;
+
+    // Cast along the thinnest side of the overlap, so a thin sliver is
+    // measured along its thickness rather than sampled across it
+    const MeshPoint extent = o.max - o.min;
+    const int axis = extent.x <= extent.y && extent.x <= extent.z ? 0
+                   : (extent.y <= extent.z ? 1 : 2);
+    const int ua = (axis + 1) % 3, va = (axis + 2) % 3;
+    const double du = coord(extent, ua) / samples, dv = coord(extent, va) / samples;
+    if (coord(extent, axis) <= 0.0 || du <= 0.0 || dv <= 0.0) return 0.0;
+
+    const double eps = kRayHitTolerance *
+        std::max({extent.x, extent.y, extent.z, coord(extent, axis) + 1.0});
+
+    double length = 0.0;
+    std::vector<RayHit> hits;
+    std::vector<std::pair<double, double>> inA, inB;
+    for (int i = 0; i < samples; ++i) {
+        // Off-centre sample positions keep rays off the edges of
+        // meshes aligned with the box
+        const double u = coord(o.min, ua) + (i + 0.5173) * du;
+        for (int j = 0; j < samples; ++j) {
+            const double v = coord(o.min, va) + (j + 0.4709) * dv;
+            castRay(a, treeA, axis, u, v, hits);
+            insideIntervals(hits, eps, inA);
+            if (inA.empty()) continue;
+            castRay(b, treeB, axis, u, v, hits);
+            insideIntervals(hits, eps, inB);
+            length += overlapLength(inA, inB);
+        }
+    }
+    return length * du * dv;
+}
+
+// =====================================================================
+//  Clash Detection
+// =====================================================================
+
+const char* clashTypeName(ClashType type)
+{
+    switch (type) {
+    case ClashType::Interference: return "interference";
+    case ClashType::Contact:      return "contact";
+    case ClashType::Clearance:    return "clearance";
+    }
+    return "unknown";
+}
+
+ClashReport findClashes(const std::vector<TriangleMesh>& bodies, const ClashOptions& options)
+{
+    const auto start = std::chrono::steady_clock::now();
+    ClashReport report;
+    report.bodies = static_cast<int>(bodies.size());
+
+    if (options.clearance < 0.0 || options.contactTolerance < 0.0) {
+        report.errorMessage = "Clearance and contact tolerance must not be negative";
+        return report;
+    }
+
+    const int n = static_cast<int>(bodies.size());
+    std::vector<BodyData> data(n);
+    std::vector<MeshBox> boxes(n);
+    OSD_Parallel::For(0, n, [&](int i) {
+        data[i].mesh = &bodies[i];
+        data[i].tree = triangleTree(bodies[i]);
+        data[i].box = data[i].tree.bounds();
+        boxes[i] = data[i].box;
+    }, !options.parallel);
+
+    // Broad phase over the body boxes
+    const double reach = std::max(options.clearance, options.contactTolerance);
+    const std::vector<std::pair<int, int>> candidates = BoxTree(boxes).selfPairs(reach);
+    report.candidatePairs = static_cast<int>(candidates.size());
+
+    // Narrow phase; each task writes only its own slot
+    std::vector<ClashPair> found(candidates.size());
+    std::vector<char> hit(candidates.size(), 0);
+    OSD_Parallel::For(0, static_cast<int>(candidates.size()), [&](int k) {
+        const auto [i, j] = candidates[k];
+        found[k].bodyA = i;
+        found[k].bodyB = j;
+        hit[k] = classifyPair(data[i], data[j], options, found[k]);
+    }, !options.parallel);
+
+    for (size_t k = 0; k < candidates.size(); ++k)
+        if (hit[k]) report.clashes.push_back(found[k]);
+
+    report.success = true;
+    report.milliseconds = elapsedMs(start);
+    return report;
+}
+
+}  // namespace mesh
+}  // namespace hobbycad
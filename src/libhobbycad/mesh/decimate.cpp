@@ -0,0 +1,723 @@
+// =====================================================================
+//  src/libhobbycad/mesh/decimate.cpp — Triangle mesh decimation
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/mesh/decimate.h>
+#include <hobbycad/mesh/repair.h>
+
+#include <OSD_Parallel.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace hobbycad {
+namespace mesh {
+
+namespace {
+
+/// Collapses that turn a neighbouring triangle's normal by more than
+/// about 75 degrees are rejected as fold-overs
+constexpr double kMinNormalCos = 0.25;
+
+/// A triangle whose doubled area is below this fraction of its longest
+/// edge squared is degenerate
+constexpr double kCollinearRatio = 1e-10;
+
+/// Quadrics whose determinant is below this fraction of their scale
+/// cubed have no well-defined minimum (flat or cylindrical regions)
+constexpr double kSingularRatio = 1e-10;
+
+/// Collapses leaving a vertex with more neighbours than this are
+/// rejected; on flat regions, where every collapse is free, fans would
+/// otherwise grow without bound and each collapse gets slower
+constexpr size_t kMaxValence = 24;
+
+/// Partitions smaller than this cost more to merge than they save
+constexpr int kMinPartitionTriangles = 10000;
+
+constexpr double kPi = 3.14159265358979323846;
+
+uint64_t edgeKey(int a, int b)
+{
+    if (a > b) std::swap(a, b);
+    return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// =====================================================================
+//  Quadrics
+// =====================================================================
+
+/// Sum of squared distances to a set of planes, stored as the upper
+/// triangle of the symmetric 4x4 matrix
+///   | a00 a01 a02 a03 |
+///   |     a11 a12 a13 |
+///   |         a22 a23 |
+///   |             a33 |
+struct Quadric {
+    double m[10] = {};
+
+    /// Add the plane n.p + d = 0 (n of unit length)
+    void addPlane(const MeshPoint& n, double d)
+    {
+        m[0] += n.x * n.x; m[1] += n.x * n.y; m[2] += n.x * n.z; m[3] += n.x * d;
+        m[4] += n.y * n.y; m[5] += n.y * n.z; m[6] += n.y * d;
+        m[7] += n.z * n.z; m[8] += n.z * d;
+        m[9] += d * d;
+    }
+
+    Quadric& operator+=(const Quadric& o)
+    {
+        for (int i = 0; i < 10; ++i) m[i] += o.m[i];
+        return *this;
+    }
+
+    double error(const MeshPoint& p) const
+    {
+        const double x = p.x, y = p.y, z = p.z;
+        return m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z + 2.0 * m[3] * x +
+               m[4] * y * y + 2.0 * m[5] * y * z + 2.0 * m[6] * y +
+               m[7] * z * z + 2.0 * m[8] * z + m[9];
+    }
+
+    /// Point of least error, if the quadric has a unique minimum
+    bool minimum(MeshPoint* p) const
+    {
+        const double a00 = m[0], a01 = m[1], a02 = m[2];
+        const double a11 = m[4], a12 = m[5], a22 = m[7];
+
+        const double c00 = a11 * a22 - a12 * a12;
+        const double c01 = a02 * a12 - a01 * a22;
+        const double c02 = a01 * a12 - a02 * a11;
+        const double det = a00 * c00 + a01 * c01 + a02 * c02;
+
+        const double scale = std::max({std::abs(a00), std::abs(a11), std::abs(a22)});
+        if (scale <= 0.0 || std::abs(det) <= kSingularRatio * scale * scale * scale) return false;
+
+        const double c11 = a00 * a22 - a02 * a02;
+        const double c12 = a01 * a02 - a00 * a12;
+        const double c22 = a00 * a11 - a01 * a01;
+        const double bx = -m[3], by = -m[6], bz = -m[8];
+
+        *p = MeshPoint((c00 * bx + c01 * by + c02 * bz) / det,
+                       (c01 * bx + c11 * by + c12 * bz) / det,
+                       (c02 * bx + c12 * by + c22 * bz) / det);
+        return true;
+    }
+};
+
+// =====================================================================
+//  Edge-Collapse Decimator
+// =====================================================================
+
+/// How freely a vertex may move.  A collapse always keeps the vertex
+/// of the higher class; a boundary or feature vertex may only merge
+/// along its own boundary or feature line.
+enum VertexClass : char {
+    Free = 0,
+    Feature = 1,    ///< On exactly two sharp edges
+    Boundary = 2,   ///< On exactly two open edges
+    Locked = 3      ///< Corner, non-manifold, or shared with another partition
+};
+
+class Decimator {
+public:
+    /// @param locked Vertices that must not move (may be empty)
+    /// @param quadrics Accumulated quadrics from an earlier pass; empty
+    ///        to derive them from the mesh's triangles
+    Decimator(TriangleMesh& mesh, const DecimateOptions& options,
+              const std::vector<char>& locked, std::vector<Quadric> quadrics)
+        : m_mesh(mesh), m_options(options), m_quadrics(std::move(quadrics))
+    {
+        setup(locked);
+    }
+
+    /// Collapse edges until at most target triangles remain (0 = no
+    /// budget) or the cheapest collapse costs more than maxCost
+    void run(int target, double maxCost)
+    {
+        while (!m_heap.empty() && (target <= 0 || m_live > target)) {
+            Candidate c = m_heap.top();
+            m_heap.pop();
+            if (m_stamp[c.a] != c.stampA || m_stamp[c.b] != c.stampB) continue;
+            if (c.cost > maxCost) break;
+            collapse(c);
+        }
+    }
+
+    /// Write the surviving triangles back to the mesh
+    void finish()
+    {
+        std::vector<MeshTriangle> kept;
+        kept.reserve(m_live);
+        for (int i = 0; i < m_mesh.triangleCount(); ++i) {
+            if (!m_deadTriangle[i]) kept.push_back(m_mesh.triangles[i]);
+        }
+        m_mesh.triangles.swap(kept);
+    }
+
+    std::vector<Quadric>& quadrics() { return m_quadrics; }
+    double maxCost() const { return m_maxCost; }
+
+private:
+    struct Candidate {
+        double cost;
+        int a;              ///< Survivor
+        int b;              ///< Removed
+        unsigned stampA;
+        unsigned stampB;
+        MeshPoint target;
+
+        bool operator>(const Candidate& o) const { return cost > o.cost; }
+    };
+
+    MeshPoint normalOf(const MeshTriangle& t) const
+    {
+        const MeshPoint& p0 = m_mesh.vertices[t[0]];
+        return (m_mesh.vertices[t[1]] - p0).cross(m_mesh.vertices[t[2]] - p0);
+    }
+
+    bool contains(int triangle, int v) const
+    {
+        const MeshTriangle& t = m_mesh.triangles[triangle];
+        return t[0] == v || t[1] == v || t[2] == v;
+    }
+
+    void setup(const std::vector<char>& locked)
+    {
+        const int vertexCount = m_mesh.vertexCount();
+        const int triangleCount = m_mesh.triangleCount();
+
+        m_deadTriangle.assign(triangleCount, 0);
+        m_vertexTriangles.assign(vertexCount, {});
+        m_stamp.assign(vertexCount, 0);
+        m_onBoundary.assign(vertexCount, 0);
+        m_live = 0;
+
+        for (int i = 0; i < triangleCount; ++i) {
+            const MeshTriangle& t = m_mesh.triangles[i];
+            if (t[0] == t[1] || t[1] == t[2] || t[2] == t[0]) {
+                m_deadTriangle[i] = 1;
+                continue;
+            }
+            for (int v : t) m_vertexTriangles[v].push_back(i);
+            ++m_live;
+        }
+
+        const bool deriveQuadrics = m_quadrics.size() != static_cast<size_t>(vertexCount);
+        if (deriveQuadrics) {
+            m_quadrics.assign(vertexCount, Quadric());
+            for (int i = 0; i < triangleCount; ++i) {
+                if (m_deadTriangle[i]) continue;
+                const MeshTriangle& t = m_mesh.triangles[i];
+                MeshPoint n = normalOf(t);
+                const double length = n.length();
+                if (length <= 0.0) continue;
+                n = n * (1.0 / length);
+                const double d = -n.dot(m_mesh.vertices[t[0]]);
+                for (int v : t) m_quadrics[v].addPlane(n, d);
+            }
+        }
+
+        // Classify edges by use count and dihedral angle
+        std::vector<std::pair<uint64_t, int>> edges;
+        edges.reserve(static_cast<size_t>(m_live) * 3);
+        for (int i = 0; i < triangleCount; ++i) {
+            if (m_deadTriangle[i]) continue;
+            const MeshTriangle& t = m_mesh.triangles[i];
+            for (int k = 0; k < 3; ++k) edges.emplace_back(edgeKey(t[k], t[(k + 1) % 3]), i);
+        }
+        std::sort(edges.begin(), edges.end());
+
+        std::vector<char> nonManifold(vertexCount, 0);
+        std::vector<int> specialEdges(vertexCount, 0);
+        std::vector<int> boundaryEdges(vertexCount, 0);
+        std::vector<uint64_t> uniqueEdges;
+        uniqueEdges.reserve(edges.size() / 2 + 1);
+        const double sharpCos = std::cos(m_options.featureAngle * kPi / 180.0);
+
+        for (size_t i = 0; i < edges.size();) {
+            size_t j = i;
+            while (j < edges.size() && edges[j].first == edges[i].first) ++j;
+            const uint64_t key = edges[i].first;
+            const int a = static_cast<int>(key >> 32);
+            const int b = static_cast<int>(key & 0xffffffffu);
+            const size_t uses = j - i;
+            uniqueEdges.push_back(key);
+
+            if (uses == 1) {
+                m_onBoundary[a] = m_onBoundary[b] = 1;
+                if (m_options.preserveBoundary) {
+                    ++specialEdges[a]; ++specialEdges[b];
+                    ++boundaryEdges[a]; ++boundaryEdges[b];
+                    if (deriveQuadrics) addBoundaryPlane(edges[i].second, a, b, locked);
+                }
+            } else if (uses > 2) {
+                nonManifold[a] = nonManifold[b] = 1;
+            } else if (m_options.preserveFeatures) {
+                MeshPoint n0 = normalOf(m_mesh.triangles[edges[i].second]);
+                MeshPoint n1 = normalOf(m_mesh.triangles[edges[i + 1].second]);
+                const double lengths = n0.length() * n1.length();
+                if (lengths > 0.0 && n0.dot(n1) < sharpCos * lengths) {
+                    ++specialEdges[a]; ++specialEdges[b];
+                    m_sharpEdges.insert(key);
+                }
+            }
+            i = j;
+        }
+
+        m_class.assign(vertexCount, Free);
+        for (int v = 0; v < vertexCount; ++v) {
+            const bool pinned = nonManifold[v] || (!locked.empty() && locked[v]);
+            if (pinned || (specialEdges[v] != 0 && specialEdges[v] != 2) ||
+                (boundaryEdges[v] == 1 && specialEdges[v] == 2)) {
+                m_class[v] = Locked;
+            } else if (boundaryEdges[v] == 2) {
+                m_class[v] = Boundary;
+            } else if (specialEdges[v] == 2) {
+                m_class[v] = Feature;
+            }
+        }
+
+        for (uint64_t key : uniqueEdges) {
+            push(static_cast<int>(key >> 32), static_cast<int>(key & 0xffffffffu));
+        }
+    }
+
+    /// Constrain an open edge with a plane through it, perpendicular to
+    /// its triangle, so sliding along the boundary is cheap and moving
+    /// off it is not.  Partition seams look open too; both their ends
+    /// are locked, so they are skipped.
+    void addBoundaryPlane(int triangle, int a, int b, const std::vector<char>& locked)
+    {
+        if (!locked.empty() && locked[a] && locked[b]) return;
+
+        const MeshPoint normal = normalOf(m_mesh.triangles[triangle]);
+        const MeshPoint edge = m_mesh.vertices[b] - m_mesh.vertices[a];
+        MeshPoint n = edge.cross(normal);
+        const double length = n.length();
+        if (length <= 0.0) return;
+        n = n * (1.0 / length);
+        const double d = -n.dot(m_mesh.vertices[a]);
+        m_quadrics[a].addPlane(n, d);
+        m_quadrics[b].addPlane(n, d);
+    }
+
+    /// Count live triangles using edge a-b
+    int edgeUses(int a, int b) const
+    {
+        int uses = 0;
+        for (int t : m_vertexTriangles[a]) {
+            if (contains(t, b)) ++uses;
+        }
+        return uses;
+    }
+
+    /// Queue the collapse of edge a-b, if the vertex classes allow one
+    void push(int a, int b)
+    {
+        if (m_class[a] < m_class[b]) std::swap(a, b);
+        if (m_class[b] == Locked) return;
+        if (m_class[b] == Feature && !m_sharpEdges.count(edgeKey(a, b))) return;
+        if (m_class[b] == Boundary && edgeUses(a, b) != 1) return;
+
+        Quadric q = m_quadrics[a];
+        q += m_quadrics[b];
+
+        const MeshPoint& pa = m_mesh.vertices[a];
+        const MeshPoint& pb = m_mesh.vertices[b];
+        const MeshPoint mid = (pa + pb) * 0.5;
+
+        MeshPoint target = pa;
+        if (m_class[a] == m_class[b]) {
+            // Free vertices go to the quadric's minimum unless it lies
+            // far off the edge; boundary and feature vertices stay on
+            // their line
+            const bool solved = m_class[a] == Free && q.minimum(&target) &&
+                                (target - mid).length() <= (pb - pa).length();
+            if (!solved) {
+                target = pa;
+                double best = q.error(pa);
+                for (const MeshPoint& p : {pb, mid}) {
+                    const double e = q.error(p);
+                    if (e < best) {
+                        best = e;
+                        target = p;
+                    }
+                }
+            }
+        }
+
+        const double cost = std::max(0.0, q.error(target));
+        m_heap.push(Candidate{cost, a, b, m_stamp[a], m_stamp[b], target});
+    }
+
+    /// Sorted, unique neighbours of v over its live triangles
+    void neighbours(int v, std::vector<int>& out) const
+    {
+        out.clear();
+        for (int t : m_vertexTriangles[v]) {
+            for (int w : m_mesh.triangles[t]) {
+                if (w != v) out.push_back(w);
+            }
+        }
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+
+    /// Topology and geometry checks before merging b into a
+    bool canCollapse(const Candidate& c)
+    {
+        const int a = c.a;
+        const int b = c.b;
+
+        // Link condition: the only vertices adjacent to both ends are
+        // the apexes of the triangles on the edge
+        m_shared.clear();
+        for (int t : m_vertexTriangles[a]) {
+            if (contains(t, b)) m_shared.push_back(t);
+        }
+        if (m_shared.empty() || m_shared.size() > 2) return false;
+
+        neighbours(a, m_neighboursA);
+        neighbours(b, m_neighboursB);
+        size_t common = 0;
+        size_t i = 0, j = 0;
+        while (i < m_neighboursA.size() && j < m_neighboursB.size()) {
+            if (m_neighboursA[i] < m_neighboursB[j]) {
+                ++i;
+            } else if (m_neighboursB[j] < m_neighboursA[i]) {
+                ++j;
+            } else {
+                ++common;
+                ++i;
+                ++j;
+            }
+        }
+        if (common != m_shared.size()) return false;
+
+        // Keep enough neighbours to stay a surface (a tetrahedron would
+        // fold into two coincident triangles)
+        const size_t merged = m_neighboursA.size() + m_neighboursB.size() - common - 2;
+        if (merged < (m_shared.size() == 2 ? 3u : 2u) || merged > kMaxValence) return false;
+
+        // Pinching two boundaries together across the interior makes
+        // the vertex non-manifold
+        if (m_shared.size() == 2 && m_onBoundary[a] && m_onBoundary[b]) return false;
+
+        // No neighbouring triangle may flip or degenerate
+        for (int v : {a, b}) {
+            for (int t : m_vertexTriangles[v]) {
+                if (contains(t, a) && contains(t, b)) continue;
+                const MeshTriangle& tri = m_mesh.triangles[t];
+                MeshPoint p[3];
+                for (int k = 0; k < 3; ++k) {
+                    p[k] = (tri[k] == a || tri[k] == b) ? c.target : m_mesh.vertices[tri[k]];
+                }
+                const MeshPoint before = normalOf(tri);
+                const MeshPoint after = (p[1] - p[0]).cross(p[2] - p[0]);
+                const double longest = std::max({(p[1] - p[0]).dot(p[1] - p[0]),
+                                                 (p[2] - p[1]).dot(p[2] - p[1]),
+                                                 (p[0] - p[2]).dot(p[0] - p[2])});
+                const double afterLength = after.length();
+                if (afterLength <= kCollinearRatio * longest) return false;
+                if (before.dot(after) < kMinNormalCos * before.length() * afterLength) return false;
+            }
+        }
+        return true;
+    }
+
+    void collapse(const Candidate& c)
+    {
+        if (!canCollapse(c)) return;
+
+        const int a = c.a;
+        const int b = c.b;
+
+        // Sharp edges of b move to a before the neighbour lists change
+        if (!m_sharpEdges.empty()) {
+            for (int w : m_neighboursB) {
+                if (w == a || !m_sharpEdges.erase(edgeKey(b, w))) continue;
+                m_sharpEdges.insert(edgeKey(a, w));
+            }
+            m_sharpEdges.erase(edgeKey(a, b));
+        }
+
+        for (int t : m_shared) {
+            m_deadTriangle[t] = 1;
+            --m_live;
+            for (int w : m_mesh.triangles[t]) {
+                if (w == a || w == b) continue;
+                std::vector<int>& list = m_vertexTriangles[w];
+                list.erase(std::remove(list.begin(), list.end(), t), list.end());
+            }
+        }
+
+        std::vector<int>& listA = m_vertexTriangles[a];
+        listA.erase(std::remove_if(listA.begin(), listA.end(),
+                                   [&](int t) { return m_deadTriangle[t] != 0; }),
+                    listA.end());
+        for (int t : m_vertexTriangles[b]) {
+            if (m_deadTriangle[t]) continue;
+            for (int& w : m_mesh.triangles[t]) {
+                if (w == b) w = a;
+            }
+            listA.push_back(t);
+        }
+        m_vertexTriangles[b].clear();
+        m_vertexTriangles[b].shrink_to_fit();
+
+        m_mesh.vertices[a] = c.target;
+        m_quadrics[a] += m_quadrics[b];
+        m_onBoundary[a] = m_onBoundary[a] || m_onBoundary[b];
+        ++m_stamp[a];
+        ++m_stamp[b];
+        m_maxCost = std::max(m_maxCost, c.cost);
+
+        neighbours(a, m_neighboursA);
+        for (int w : m_neighboursA) push(a, w);
+    }
+
+    TriangleMesh& m_mesh;
+    const DecimateOptions& m_options;
+
+    std::vector<Quadric> m_quadrics;
+    std::vector<char> m_deadTriangle;
+    std::vector<std::vector<int>> m_vertexTriangles;
+    std::vector<unsigned> m_stamp;      ///< Bumped on every change, invalidating queued collapses
+    std::vector<char> m_class;
+    std::vector<char> m_onBoundary;
+    std::unordered_set<uint64_t> m_sharpEdges;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> m_heap;
+    int m_live = 0;
+    double m_maxCost = 0.0;
+
+    // Scratch lists reused across collapses
+    std::vector<int> m_shared;
+    std::vector<int> m_neighboursA;
+    std::vector<int> m_neighboursB;
+};
+
+// =====================================================================
+//  Partitions
+// =====================================================================
+
+/// Split triangles into spatially compact groups of at most maxSize by
+/// recursive median cuts of their centroids along the longest axis
+void splitPartitions(const std::vector<MeshPoint>& centroids, std::vector<int>& order,
+                     int begin, int end, int maxSize, std::vector<std::vector<int>>& out)
+{
+    if (end - begin <= maxSize) {
+        out.emplace_back(order.begin() + begin, order.begin() + end);
+        return;
+    }
+
+    MeshPoint lo = centroids[order[begin]];
+    MeshPoint hi = lo;
+    for (int i = begin; i < end; ++i) {
+        const MeshPoint& p = centroids[order[i]];
+        lo = {std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z)};
+        hi = {std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z)};
+    }
+    const MeshPoint size = hi - lo;
+    const int axis = size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+    auto coordinate = [&](int t) {
+        const MeshPoint& p = centroids[t];
+        return axis == 0 ? p.x : (axis == 1 ? p.y : p.z);
+    };
+
+    const int mid = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+                     [&](int x, int y) { return coordinate(x) < coordinate(y); });
+    splitPartitions(centroids, order, begin, mid, maxSize, out);
+    splitPartitions(centroids, order, mid, end, maxSize, out);
+}
+
+/// One partition's triangles with its own compact vertex list
+struct Piece {
+    TriangleMesh mesh;
+    std::vector<int> globalIndex;   ///< Local vertex -> vertex of the whole mesh
+    std::vector<Quadric> quadrics;
+    double maxCost = 0.0;
+};
+
+/// Decimate the partitions in parallel with shared vertices locked and
+/// merge them back into mesh, returning the merged quadrics
+std::vector<Quadric> decimatePartitions(TriangleMesh& mesh, const DecimateOptions& options,
+                                        const std::vector<std::vector<int>>& parts,
+                                        int target, double maxCost, double* worstCost)
+{
+    const int vertexCount = mesh.vertexCount();
+    const int triangleCount = mesh.triangleCount();
+
+    std::vector<int> owner(vertexCount, -1);
+    std::vector<char> shared(vertexCount, 0);
+    for (int p = 0; p < static_cast<int>(parts.size()); ++p) {
+        for (int t : parts[p]) {
+            for (int v : mesh.triangles[t]) {
+                if (owner[v] < 0) owner[v] = p;
+                else if (owner[v] != p) shared[v] = 1;
+            }
+        }
+    }
+
+    std::vector<Piece> pieces(parts.size());
+    OSD_Parallel::For(0, static_cast<int>(parts.size()), [&](int p) {
+        Piece& piece = pieces[p];
+        for (int t : parts[p]) {
+            for (int v : mesh.triangles[t]) piece.globalIndex.push_back(v);
+        }
+        std::sort(piece.globalIndex.begin(), piece.globalIndex.end());
+        piece.globalIndex.erase(std::unique(piece.globalIndex.begin(), piece.globalIndex.end()),
+                                piece.globalIndex.end());
+
+        auto localIndex = [&](int v) {
+            return static_cast<int>(std::lower_bound(piece.globalIndex.begin(),
+                                                     piece.globalIndex.end(), v) -
+                                    piece.globalIndex.begin());
+        };
+
+        std::vector<char> locked(piece.globalIndex.size());
+        piece.mesh.vertices.reserve(piece.globalIndex.size());
+        for (size_t i = 0; i < piece.globalIndex.size(); ++i) {
+            piece.mesh.vertices.push_back(mesh.vertices[piece.globalIndex[i]]);
+            locked[i] = shared[piece.globalIndex[i]];
+        }
+        piece.mesh.triangles.reserve(parts[p].size());
+        for (int t : parts[p]) {
+            const MeshTriangle& tri = mesh.triangles[t];
+            piece.mesh.triangles.push_back({localIndex(tri[0]), localIndex(tri[1]),
+                                            localIndex(tri[2])});
+        }
+
+        const int pieceTarget = target > 0
+            ? std::max(1, static_cast<int>(static_cast<double>(target) *
+                                           parts[p].size() / triangleCount + 0.5))
+            : 0;
+
+        Decimator decimator(piece.mesh, options, locked, {});
+        decimator.run(pieceTarget, maxCost);
+        decimator.finish();
+        piece.quadrics = std::move(decimator.quadrics());
+        piece.maxCost = decimator.maxCost();
+    }, !options.parallel);
+
+    // Survivors keep their vertex index, so moved positions and
+    // quadrics go back to the same slots; locked vertices collect the
+    // planes of every partition they border
+    std::vector<Quadric> quadrics(vertexCount);
+    std::vector<MeshTriangle> triangles;
+    for (const Piece& piece : pieces) {
+        for (size_t i = 0; i < piece.globalIndex.size(); ++i) {
+            const int v = piece.globalIndex[i];
+            mesh.vertices[v] = piece.mesh.vertices[i];
+            quadrics[v] += piece.quadrics[i];
+        }
+        for (const MeshTriangle& t : piece.mesh.triangles) {
+            triangles.push_back({piece.globalIndex[t[0]], piece.globalIndex[t[1]],
+                                 piece.globalIndex[t[2]]});
+        }
+        *worstCost = std::max(*worstCost, piece.maxCost);
+    }
+    mesh.triangles.swap(triangles);
+    return quadrics;
+}
+
+}  // namespace
+
+// =====================================================================
+//  Public API
+// =====================================================================
+
+DecimateResult decimate(const TriangleMesh& input, const DecimateOptions& options)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    DecimateResult result;
+    result.inputTriangles = input.triangleCount();
+
+    if (input.isEmpty()) {
+        result.errorMessage = "Mesh is empty";
+        return result;
+    }
+
+    int target = 0;
+    if (options.targetTriangles > 0) {
+        target = options.targetTriangles;
+    } else if (options.targetRatio > 0.0) {
+        target = std::max(1, static_cast<int>(std::ceil(input.triangleCount() *
+                                                        std::min(options.targetRatio, 1.0))));
+    }
+    if (target <= 0 && options.maxError <= 0.0) {
+        result.errorMessage = "No triangle budget or error bound set";
+        return result;
+    }
+
+    TriangleMesh mesh = input;
+    weldVertices(mesh, 0.0);
+
+    const double maxCost = options.maxError > 0.0
+        ? options.maxError * options.maxError
+        : std::numeric_limits<double>::infinity();
+    double worstCost = 0.0;
+
+    if (target <= 0 || mesh.triangleCount() > target) {
+        std::vector<Quadric> quadrics;
+
+        const int partitionSize = std::max(options.partitionTriangles, kMinPartitionTriangles);
+        if (options.parallel && mesh.triangleCount() > partitionSize) {
+            std::vector<MeshPoint> centroids;
+            centroids.reserve(mesh.triangles.size());
+            for (const MeshTriangle& t : mesh.triangles) {
+                centroids.push_back((mesh.vertices[t[0]] + mesh.vertices[t[1]] +
+                                     mesh.vertices[t[2]]) * (1.0 / 3.0));
+            }
+            std::vector<int> order(mesh.triangles.size());
+            for (int i = 0; i < mesh.triangleCount(); ++i) order[i] = i;
+
+            std::vector<std::vector<int>> parts;
+            splitPartitions(centroids, order, 0, mesh.triangleCount(), partitionSize, parts);
+            result.partitions = static_cast<int>(parts.size());
+
+            quadrics = decimatePartitions(mesh, options, parts, target, maxCost, &worstCost);
+        }
+
+        // Whole-mesh pass: finishes small inputs outright and removes
+        // the partition seams of large ones
+        Decimator decimator(mesh, options, {}, std::move(quadrics));
+        decimator.run(target, maxCost);
+        decimator.finish();
+        worstCost = std::max(worstCost, decimator.maxCost());
+    }
+
+    mesh.removeUnusedVertices();
+
+    result.mesh = std::move(mesh);
+    result.outputTriangles = result.mesh.triangleCount();
+    result.maxError = std::sqrt(worstCost);
+    result.success = !result.mesh.isEmpty();
+    if (!result.success) result.errorMessage = "No triangles left after decimation";
+    result.milliseconds = elapsedMs(start);
+    return result;
+}
+
+}  // namespace mesh
+}  // namespace hobbycad
@@ -0,0 +1,1068 @@
+// =====================================================================
+//  src/libhobbycad/mesh/repair.cpp — Triangle mesh repair
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/mesh/repair.h>
+
+#include <OSD_Parallel.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace hobbycad {
+namespace mesh {
+
+namespace {
+
+/// Default weld distance as a fraction of the bounding-box diagonal
+constexpr double kRelativeWeldTolerance = 1e-6;
+
+/// A triangle whose doubled area is below this fraction of its longest
+/// edge squared has collinear corners
+constexpr double kCollinearRatio = 1e-10;
+
+/// Sliver splitting can cascade; stop after this many sweeps
+constexpr int kMaxSliverPasses = 4;
+
+constexpr double kPi = 3.14159265358979323846;
+
+// =====================================================================
+//  Edge Keys
+// =====================================================================
+
+uint64_t directedKey(int a, int b)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+}
+
+uint64_t undirectedKey(int a, int b)
+{
+    return a < b ? directedKey(a, b) : directedKey(b, a);
+}
+
+/// (undirected key, triangle) for every triangle edge, sorted by key so
+/// triangles sharing an edge are adjacent
+std::vector<std::pair<uint64_t, int>> sortedEdges(const TriangleMesh& mesh)
+{
+    std::vector<std::pair<uint64_t, int>> edges;
+    edges.reserve(mesh.triangles.size() * 3);
+    for (int i = 0; i < mesh.triangleCount(); ++i) {
+        const MeshTriangle& t = mesh.triangles[i];
+        for (int k = 0; k < 3; ++k) {
+            edges.emplace_back(undirectedKey(t[k], t[(k + 1) % 3]), i);
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+/// True if the triangle has the directed edge a->b
+bool hasDirectedEdge(const MeshTriangle& t, int a, int b)
+{
+    return (t[0] == a && t[1] == b) || (t[1] == a && t[2] == b) || (t[2] == a && t[0] == b);
+}
+
+bool sharesVertex(const MeshTriangle& a, const MeshTriangle& b)
+{
+    for (int u : a) {
+        if (u == b[0] || u == b[1] || u == b[2]) return true;
+    }
+    return false;
+}
+
+void flip(MeshTriangle& t)
+{
+    std::swap(t[1], t[2]);
+}
+
+/// Drop triangles flagged in dead, keeping order
+void compact(TriangleMesh& mesh, const std::vector<char>& dead)
+{
+    size_t out = 0;
+    for (size_t i = 0; i < mesh.triangles.size(); ++i) {
+        if (!dead[i]) mesh.triangles[out++] = mesh.triangles[i];
+    }
+    mesh.triangles.resize(out);
+}
+
+// =====================================================================
+//  Cleanup (whole mesh)
+// =====================================================================
+
+/// Remove triangles that reference a vertex twice
+int removeCollapsed(TriangleMesh& mesh)
+{
+    auto collapsed = [](const MeshTriangle& t) {
+        return t[0] == t[1] || t[1] == t[2] || t[2] == t[0];
+    };
+    size_t before = mesh.triangles.size();
+    mesh.triangles.erase(std::remove_if(mesh.triangles.begin(), mesh.triangles.end(), collapsed),
+                         mesh.triangles.end());
+    return static_cast<int>(before - mesh.triangles.size());
+}
+
+/// Corner opposite the longest edge if the triangle is a zero-area
+/// sliver (k such that t[k]->t[k+1] is the longest edge), else -1
+int sliverEdge(const TriangleMesh& mesh, const MeshTriangle& t)
+{
+    const MeshPoint& p0 = mesh.vertices[t[0]];
+    const MeshPoint& p1 = mesh.vertices[t[1]];
+    const MeshPoint& p2 = mesh.vertices[t[2]];
+    double lengths[3] = {(p1 - p0).dot(p1 - p0), (p2 - p1).dot(p2 - p1), (p0 - p2).dot(p0 - p2)};
+    int longest = static_cast<int>(std::max_element(lengths, lengths + 3) - lengths);
+    double area2 = (p1 - p0).cross(p2 - p0).length();
+    return area2 <= kCollinearRatio * lengths[longest] ? longest : -1;
+}
+
+/// Remove zero-area triangles whose corners are distinct but collinear.
+/// Deleting such a sliver alone would open a hole, so the neighbour
+/// across its longest edge a->b is split at the middle corner c:
+/// (b, a, d) becomes (b, c, d) + (c, a, d), which closes the gap.
+int removeSlivers(TriangleMesh& mesh)
+{
+    bool any = false;
+    for (const MeshTriangle& t : mesh.triangles) {
+        if (sliverEdge(mesh, t) >= 0) {
+            any = true;
+            break;
+        }
+    }
+    if (!any) return 0;
+
+    std::unordered_map<uint64_t, int> owner;
+    owner.reserve(mesh.triangles.size() * 3);
+    auto registerTriangle = [&](int index) {
+        const MeshTriangle& t = mesh.triangles[index];
+        for (int k = 0; k < 3; ++k) owner[directedKey(t[k], t[(k + 1) % 3])] = index;
+    };
+    auto unregisterTriangle = [&](int index) {
+        const MeshTriangle& t = mesh.triangles[index];
+        for (int k = 0; k < 3; ++k) {
+            auto it = owner.find(directedKey(t[k], t[(k + 1) % 3]));
+            if (it != owner.end() && it->second == index) owner.erase(it);
+        }
+    };
+    for (int i = 0; i < mesh.triangleCount(); ++i) registerTriangle(i);
+
+    std::vector<char> dead(mesh.triangles.size(), 0);
+    int removed = 0;
+
+    for (int pass = 0; pass < kMaxSliverPasses; ++pass) {
+        bool changed = false;
+        for (int i = 0; i < mesh.triangleCount(); ++i) {
+            if (dead[i]) continue;
+            int k = sliverEdge(mesh, mesh.triangles[i]);
+            if (k < 0) continue;
+
+            const MeshTriangle t = mesh.triangles[i];
+            const int a = t[k];
+            const int b = t[(k + 1) % 3];
+            const int c = t[(k + 2) % 3];
+            unregisterTriangle(i);
+            dead[i] = 1;
+            ++removed;
+            changed = true;
+
+            auto it = owner.find(directedKey(b, a));
+            if (it == owner.end() || dead[it->second]) continue;
+            const int j = it->second;
+
+            MeshTriangle n = mesh.triangles[j];
+            while (n[0] != b) std::rotate(n.begin(), n.begin() + 1, n.end());
+            const int d = n[2];
+            unregisterTriangle(j);
+            if (d == c) {
+                // The neighbour is the same sliver facing the other way
+                dead[j] = 1;
+                ++removed;
+                continue;
+            }
+
+            mesh.triangles[j] = {b, c, d};
+            registerTriangle(j);
+            mesh.triangles.push_back({c, a, d});
+            dead.push_back(0);
+            registerTriangle(mesh.triangleCount() - 1);
+        }
+        if (!changed) break;
+    }
+
+    compact(mesh, dead);
+    return removed;
+}
+
+/// Remove triangles over the same three vertices as an earlier one
+int removeDuplicates(TriangleMesh& mesh)
+{
+    std::vector<std::pair<MeshTriangle, int>> sorted;
+    sorted.reserve(mesh.triangles.size());
+    for (int i = 0; i < mesh.triangleCount(); ++i) {
+        MeshTriangle key = mesh.triangles[i];
+        std::sort(key.begin(), key.end());
+        sorted.emplace_back(key, i);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    std::vector<char> dead(mesh.triangles.size(), 0);
+    int removed = 0;
+    for (size_t i = 1; i < sorted.size(); ++i) {
+        if (sorted[i].first == sorted[i - 1].first) {
+            dead[sorted[i].second] = 1;
+            ++removed;
+        }
+    }
+    compact(mesh, dead);
+    return removed;
+}
+
+/// Keep at most two triangles on every edge, preferring a pair that
+/// uses the edge in opposite directions.  Returns triangles removed.
+int removeNonManifold(TriangleMesh& mesh, int* nonManifoldEdges)
+{
+    const auto edges = sortedEdges(mesh);
+    std::vector<char> dead(mesh.triangles.size(), 0);
+    int edgeCount = 0;
+
+    for (size_t begin = 0; begin < edges.size();) {
+        size_t end = begin + 1;
+        while (end < edges.size() && edges[end].first == edges[begin].first) ++end;
+
+        if (end - begin > 2) {
+            ++edgeCount;
+            const int a = static_cast<int>(edges[begin].first >> 32);
+            const int b = static_cast<int>(edges[begin].first & 0xFFFFFFFFu);
+
+            int forward = -1;
+            int backward = -1;
+            std::vector<int> alive;
+            for (size_t e = begin; e < end; ++e) {
+                int tri = edges[e].second;
+                if (dead[tri]) continue;
+                alive.push_back(tri);
+                if (hasDirectedEdge(mesh.triangles[tri], a, b)) {
+                    if (forward < 0) forward = tri;
+                } else if (backward < 0) {
+                    backward = tri;
+                }
+            }
+            // No opposite pair: keep the first two and let orientation fix them
+            if (forward < 0 || backward < 0) {
+                forward = alive.size() > 0 ? alive[0] : -1;
+                backward = alive.size() > 1 ? alive[1] : -1;
+            }
+            for (size_t e = begin; e < end; ++e) {
+                int tri = edges[e].second;
+                if (tri != forward && tri != backward) dead[tri] = 1;
+            }
+        }
+        begin = end;
+    }
+
+    if (nonManifoldEdges) *nonManifoldEdges = edgeCount;
+    int removed = static_cast<int>(std::count(dead.begin(), dead.end(), 1));
+    compact(mesh, dead);
+    return removed;
+}
+
+// =====================================================================
+//  Components
+// =====================================================================
+
+/// Triangle indices of each edge-connected component, largest first
+std::vector<std::vector<int>> componentTriangles(const TriangleMesh& mesh)
+{
+    std::vector<int> parent(mesh.triangles.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&](int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    };
+
+    const auto edges = sortedEdges(mesh);
+    for (size_t i = 1; i < edges.size(); ++i) {
+        if (edges[i].first == edges[i - 1].first) {
+            int a = find(edges[i].second);
+            int b = find(edges[i - 1].second);
+            if (a != b) parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+    std::unordered_map<int, int> slot;
+    std::vector<std::vector<int>> components;
+    for (int i = 0; i < mesh.triangleCount(); ++i) {
+        int root = find(i);
+        auto it = slot.find(root);
+        if (it == slot.end()) {
+            it = slot.emplace(root, static_cast<int>(components.size())).first;
+            components.emplace_back();
+        }
+        components[it->second].push_back(i);
+    }
+
+    std::stable_sort(components.begin(), components.end(),
+                     [](const std::vector<int>& a, const std::vector<int>& b) {
+                         return a.size() > b.size();
+                     });
+    return components;
+}
+
+TriangleMesh extract(const TriangleMesh& mesh, const std::vector<int>& triangles)
+{
+    TriangleMesh part;
+    part.triangles.reserve(triangles.size());
+    std::unordered_map<int, int> remap;
+    for (int index : triangles) {
+        MeshTriangle t = mesh.triangles[index];
+        for (int& v : t) {
+            auto it = remap.find(v);
+            if (it == remap.end()) {
+                it = remap.emplace(v, part.vertexCount()).first;
+                part.vertices.push_back(mesh.vertices[v]);
+            }
+            v = it->second;
+        }
+        part.triangles.push_back(t);
+    }
+    return part;
+}
+
+// =====================================================================
+//  Orientation
+// =====================================================================
+
+/// Propagate orientation across shared edges, then point the normals
+/// outward (positive signed volume).  Returns triangles flipped.
+int orient(TriangleMesh& mesh)
+{
+    const int n = mesh.triangleCount();
+    if (n == 0) return 0;
+
+    std::vector<std::vector<int>> neighbours(n);
+    const auto edges = sortedEdges(mesh);
+    for (size_t i = 1; i < edges.size(); ++i) {
+        if (edges[i].first == edges[i - 1].first) {
+            neighbours[edges[i].second].push_back(edges[i - 1].second);
+            neighbours[edges[i - 1].second].push_back(edges[i].second);
+        }
+    }
+
+    const std::vector<MeshTriangle> original = mesh.triangles;
+    std::vector<char> visited(n, 0);
+    std::vector<int> queue;
+    queue.reserve(n);
+
+    for (int seed = 0; seed < n; ++seed) {
+        if (visited[seed]) continue;
+        visited[seed] = 1;
+        queue.assign(1, seed);
+        for (size_t q = 0; q < queue.size(); ++q) {
+            const MeshTriangle& t = mesh.triangles[queue[q]];
+            for (int other : neighbours[queue[q]]) {
+                if (visited[other]) continue;
+                visited[other] = 1;
+                // A consistent neighbour uses the shared edge reversed
+                for (int k = 0; k < 3; ++k) {
+                    if (hasDirectedEdge(mesh.triangles[other], t[k], t[(k + 1) % 3])) {
+                        flip(mesh.triangles[other]);
+                        break;
+                    }
+                }
+                queue.push_back(other);
+            }
+        }
+    }
+
+    // Measured about a point on the boundary, the volume is that of the
+    // mesh closed by cones to that point, so components that still have
+    // holes (filled only after this) face outward too
+    MeshPoint centre;
+    int boundaryEnds = 0;
+    for (size_t begin = 0; begin < edges.size();) {
+        size_t end = begin + 1;
+        while (end < edges.size() && edges[end].first == edges[begin].first) ++end;
+        if (end - begin == 1) {
+            centre = centre + mesh.vertices[static_cast<int>(edges[begin].first >> 32)];
+            centre = centre + mesh.vertices[static_cast<int>(edges[begin].first & 0xFFFFFFFFu)];
+            boundaryEnds += 2;
+        }
+        begin = end;
+    }
+    if (boundaryEnds > 0) centre = centre * (1.0 / boundaryEnds);
+
+    double volume = 0.0;
+    for (const MeshTriangle& t : mesh.triangles) {
+        const MeshPoint a = mesh.vertices[t[0]] - centre;
+        volume += a.dot((mesh.vertices[t[1]] - centre).cross(mesh.vertices[t[2]] - centre));
+    }
+    if (volume < 0.0) {
+        for (MeshTriangle& t : mesh.triangles) flip(t);
+    }
+
+    int flipped = 0;
+    for (int i = 0; i < n; ++i) {
+        if (!hasDirectedEdge(original[i], mesh.triangles[i][0], mesh.triangles[i][1])) ++flipped;
+    }
+    return flipped;
+}
+
+// =====================================================================
+//  Self-Intersections
+// =====================================================================
+
+struct Box {
+    MeshPoint lo, hi;
+
+    bool overlaps(const Box& o) const
+    {
+        return lo.x <= o.hi.x && o.lo.x <= hi.x &&
+               lo.y <= o.hi.y && o.lo.y <= hi.y &&
+               lo.z <= o.hi.z && o.lo.z <= hi.z;
+    }
+};
+
+Box triangleBox(const TriangleMesh& mesh, const MeshTriangle& t)
+{
+    Box box{mesh.vertices[t[0]], mesh.vertices[t[0]]};
+    for (int k = 1; k < 3; ++k) {
+        const MeshPoint& p = mesh.vertices[t[k]];
+        box.lo = {std::min(box.lo.x, p.x), std::min(box.lo.y, p.y), std::min(box.lo.z, p.z)};
+        box.hi = {std::max(box.hi.x, p.x), std::max(box.hi.y, p.y), std::max(box.hi.z, p.z)};
+    }
+    return box;
+}
+
+/// Interval where a triangle crosses the other triangle's plane,
+/// projected on the intersection line (Moller 1997).  d holds the
+/// corners' signed distances to the plane; false if coplanar.
+bool crossingInterval(const double v[3], const double d[3], double* t0, double* t1)
+{
+    auto cut = [&](int from, int to) {
+        return v[from] + (v[to] - v[from]) * d[from] / (d[from] - d[to]);
+    };
+    if (d[0] * d[1] > 0.0) {
+        *t0 = cut(0, 2);
+        *t1 = cut(1, 2);
+    } else if (d[0] * d[2] > 0.0) {
+        *t0 = cut(0, 1);
+        *t1 = cut(2, 1);
+    } else if (d[1] * d[2] > 0.0 || d[0] != 0.0) {
+        *t0 = cut(1, 0);
+        *t1 = cut(2, 0);
+    } else if (d[1] != 0.0) {
+        *t0 = cut(0, 1);
+        *t1 = cut(2, 1);
+    } else if (d[2] != 0.0) {
+        *t0 = cut(0, 2);
+        *t1 = cut(1, 2);
+    } else {
+        return false;
+    }
+    if (*t0 > *t1) std::swap(*t0, *t1);
+    return true;
+}
+
+/// Signed distances (times the normal length) of p's corners to the
+/// plane of q, snapped to zero within eps.  False if all on one side.
+bool planeDistances(const MeshPoint p[3], const MeshPoint q[3], double eps,
+                    MeshPoint* normal, double d[3])
+{
+    *normal = (q[1] - q[0]).cross(q[2] - q[0]);
+    const double snap = eps * normal->length();
+    for (int k = 0; k < 3; ++k) {
+        d[k] = normal->dot(p[k] - q[0]);
+        if (std::abs(d[k]) <= snap) d[k] = 0.0;
+    }
+    return !((d[0] > 0.0 && d[1] > 0.0 && d[2] > 0.0) ||
+             (d[0] < 0.0 && d[1] < 0.0 && d[2] < 0.0));
+}
+
+/// Proper crossing of two triangles.  Touching contacts (overlap no
+/// longer than eps) and coplanar pairs do not count.
+bool trianglesIntersect(const MeshPoint p[3], const MeshPoint q[3], double eps)
+{
+    MeshPoint np, nq;
+    double dp[3], dq[3];
+    if (!planeDistances(p, q, eps, &nq, dp)) return false;
+    if (!planeDistances(q, p, eps, &np, dq)) return false;
+    if (dp[0] == 0.0 && dp[1] == 0.0 && dp[2] == 0.0) return false;
+
+    // Project onto the dominant axis of the intersection line
+    MeshPoint line = np.cross(nq);
+    double ax = std::abs(line.x), ay = std::abs(line.y), az = std::abs(line.z);
+    auto axis = [&](const MeshPoint& v) {
+        return ax >= ay && ax >= az ? v.x : (ay >= az ? v.y : v.z);
+    };
+    double vp[3] = {axis(p[0]), axis(p[1]), axis(p[2])};
+    double vq[3] = {axis(q[0]), axis(q[1]), axis(q[2])};
+
+    double p0, p1, q0, q1;
+    if (!crossingInterval(vp, dp, &p0, &p1)) return false;
+    if (!crossingInterval(vq, dq, &q0, &q1)) return false;
+    return std::min(p1, q1) - std::max(p0, q0) > eps;
+}
+
+/// Flag triangles that cross a triangle they share no vertex with.
+/// Broad phase is a uniform grid with cells twice the average triangle
+/// size, which keeps both cells per triangle and candidates per cell low.
+std::vector<char> findSelfIntersections(const TriangleMesh& mesh, bool parallel)
+{
+    const int n = mesh.triangleCount();
+    std::vector<char> flags(n, 0);
+    if (n < 2) return flags;
+
+    std::vector<Box> boxes(n);
+    double extent = 0.0;
+    for (int i = 0; i < n; ++i) {
+        boxes[i] = triangleBox(mesh, mesh.triangles[i]);
+        MeshPoint size = boxes[i].hi - boxes[i].lo;
+        extent += std::max({size.x, size.y, size.z});
+    }
+    const double diagonal = mesh.diagonal();
+    const double cell = std::max(2.0 * extent / n, diagonal * 1e-4);
+    const double eps = std::max(diagonal * 1e-9, std::numeric_limits<double>::min());
+    if (cell <= 0.0) return flags;
+
+    auto cellIndex = [cell](double v) { return static_cast<int64_t>(std::floor(v / cell)); };
+    auto cellKey = [](int64_t x, int64_t y, int64_t z) {
+        return (static_cast<uint64_t>(x) * 73856093u) ^ (static_cast<uint64_t>(y) * 19349663u) ^
+               (static_cast<uint64_t>(z) * 83492791u);
+    };
+    auto forEachCell = [&](const Box& box, const auto& fn) {
+        for (int64_t x = cellIndex(box.lo.x); x <= cellIndex(box.hi.x); ++x)
+            for (int64_t y = cellIndex(box.lo.y); y <= cellIndex(box.hi.y); ++y)
+                for (int64_t z = cellIndex(box.lo.z); z <= cellIndex(box.hi.z); ++z)
+                    if (!fn(cellKey(x, y, z))) return;
+    };
+
+    std::unordered_map<uint64_t, std::vector<int>> grid;
+    for (int i = 0; i < n; ++i) {
+        forEachCell(boxes[i], [&](uint64_t key) {
+            grid[key].push_back(i);
+            return true;
+        });
+    }
+
+    // Each task writes only its own flag
+    OSD_Parallel::For(0, n, [&](int i) {
+        const MeshTriangle& t = mesh.triangles[i];
+        const MeshPoint p[3] = {mesh.vertices[t[0]], mesh.vertices[t[1]], mesh.vertices[t[2]]};
+        forEachCell(boxes[i], [&](uint64_t key) {
+            auto it = grid.find(key);
+            for (int j : it->second) {
+                if (j == i || !boxes[i].overlaps(boxes[j])) continue;
+                const MeshTriangle& u = mesh.triangles[j];
+                if (sharesVertex(t, u)) continue;
+                const MeshPoint q[3] = {mesh.vertices[u[0]], mesh.vertices[u[1]],
+                                        mesh.vertices[u[2]]};
+                if (trianglesIntersect(p, q, eps)) {
+                    flags[i] = 1;
+                    return false;
+                }
+            }
+            return true;
+        });
+    }, !parallel);
+
+    return flags;
+}
+
+// =====================================================================
+//  Holes
+// =====================================================================
+
+/// Boundary loops, each listed in the direction of its boundary edges
+std::vector<std::vector<int>> boundaryLoops(const TriangleMesh& mesh)
+{
+    std::unordered_set<uint64_t> directed;
+    directed.reserve(mesh.triangles.size() * 3);
+    for (const MeshTriangle& t : mesh.triangles) {
+        for (int k = 0; k < 3; ++k) directed.insert(directedKey(t[k], t[(k + 1) % 3]));
+    }
+
+    std::vector<std::pair<int, int>> boundary;
+    std::unordered_map<int, std::vector<int>> outgoing;
+    for (const MeshTriangle& t : mesh.triangles) {
+        for (int k = 0; k < 3; ++k) {
+            int a = t[k];
+            int b = t[(k + 1) % 3];
+            if (!directed.count(directedKey(b, a))) {
+                outgoing[a].push_back(static_cast<int>(boundary.size()));
+                boundary.emplace_back(a, b);
+            }
+        }
+    }
+
+    std::vector<char> used(boundary.size(), 0);
+    std::vector<std::vector<int>> loops;
+    for (size_t start = 0; start < boundary.size(); ++start) {
+        if (used[start]) continue;
+        used[start] = 1;
+
+        // A loop passing a vertex twice (holes touching at a corner) is
+        // split there into simple loops
+        std::vector<int> loop = {boundary[start].first};
+        std::unordered_map<int, size_t> position = {{loop.front(), 0}};
+        int current = boundary[start].second;
+        bool closed = true;
+        while (current != boundary[start].first) {
+            auto seen = position.find(current);
+            if (seen != position.end()) {
+                std::vector<int> inner(loop.begin() + seen->second, loop.end());
+                for (int v : inner) position.erase(v);
+                loop.resize(seen->second);
+                if (inner.size() >= 3) loops.push_back(std::move(inner));
+            }
+
+            int next = -1;
+            for (int e : outgoing[current]) {
+                if (!used[e]) {
+                    next = e;
+                    break;
+                }
+            }
+            if (next < 0) {
+                closed = false;
+                break;
+            }
+            used[next] = 1;
+            position[current] = loop.size();
+            loop.push_back(current);
+            current = boundary[next].second;
+        }
+        if (closed && loop.size() >= 3) loops.push_back(std::move(loop));
+    }
+    return loops;
+}
+
+/// Triangulate a hole by repeatedly cutting off the corner with the
+/// smallest interior angle.  Corners whose cut would duplicate an
+/// existing mesh edge are put last.  Returns triangles added.
+int fillHole(TriangleMesh& mesh, const std::vector<int>& loop,
+             std::unordered_set<uint64_t>& meshEdges)
+{
+    // The patch runs against the boundary edges so it closes them
+    std::vector<int> polygon(loop.rbegin(), loop.rend());
+    const int n = static_cast<int>(polygon.size());
+    if (n < 3) return 0;
+
+    MeshPoint normal;
+    for (int i = 0; i < n; ++i) {
+        const MeshPoint& a = mesh.vertices[polygon[i]];
+        const MeshPoint& b = mesh.vertices[polygon[(i + 1) % n]];
+        normal = normal + MeshPoint((a.y - b.y) * (a.z + b.z), (a.z - b.z) * (a.x + b.x),
+                                    (a.x - b.x) * (a.y + b.y));
+    }
+
+    std::vector<int> prev(n), next(n), version(n, 0);
+    std::vector<char> alive(n, 1);
+    for (int i = 0; i < n; ++i) {
+        prev[i] = (i + n - 1) % n;
+        next[i] = (i + 1) % n;
+    }
+
+    auto cost = [&](int i) {
+        const MeshPoint& p = mesh.vertices[polygon[i]];
+        MeshPoint e1 = mesh.vertices[polygon[next[i]]] - p;
+        MeshPoint e0 = mesh.vertices[polygon[prev[i]]] - p;
+        double angle = std::atan2(normal.dot(e1.cross(e0)) / std::max(normal.length(), 1e-300),
+                                  e1.dot(e0));
+        if (angle < 0.0) angle += 2.0 * kPi;
+        if (meshEdges.count(undirectedKey(polygon[prev[i]], polygon[next[i]]))) angle += 4.0 * kPi;
+        return angle;
+    };
+
+    using Entry = std::pair<double, std::pair<int, int>>;  // cost, (corner, version)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    for (int i = 0; i < n; ++i) queue.push({cost(i), {i, 0}});
+
+    int remaining = n;
+    int added = 0;
+    auto emit = [&](int a, int b, int c) {
+        mesh.triangles.push_back({polygon[a], polygon[b], polygon[c]});
+        meshEdges.insert(undirectedKey(polygon[a], polygon[b]));
+        meshEdges.insert(undirectedKey(polygon[b], polygon[c]));
+        meshEdges.insert(undirectedKey(polygon[c], polygon[a]));
+        ++added;
+    };
+
+    while (remaining > 3 && !queue.empty()) {
+        auto [angle, entry] = queue.top();
+        queue.pop();
+        int i = entry.first;
+        if (!alive[i] || entry.second != version[i]) continue;
+
+        emit(prev[i], i, next[i]);
+        alive[i] = 0;
+        --remaining;
+        next[prev[i]] = next[i];
+        prev[next[i]] = prev[i];
+        for (int j : {prev[i], next[i]}) {
+            ++version[j];
+            queue.push({cost(j), {j, version[j]}});
+        }
+    }
+
+    if (remaining == 3) {
+        int i = 0;
+        while (!alive[i]) ++i;
+        emit(prev[i], i, next[i]);
+    }
+    return added;
+}
+
+struct HoleFillStats {
+    int holes = 0;
+    int filled = 0;
+    int triangles = 0;
+};
+
+HoleFillStats fillHoles(TriangleMesh& mesh, int maxHoleEdges)
+{
+    HoleFillStats stats;
+    const auto loops = boundaryLoops(mesh);
+    stats.holes = static_cast<int>(loops.size());
+
+    std::unordered_set<uint64_t> meshEdges;
+    meshEdges.reserve(mesh.triangles.size() * 2);
+    for (const MeshTriangle& t : mesh.triangles) {
+        for (int k = 0; k < 3; ++k) meshEdges.insert(undirectedKey(t[k], t[(k + 1) % 3]));
+    }
+
+    for (const auto& loop : loops) {
+        if (maxHoleEdges > 0 && static_cast<int>(loop.size()) > maxHoleEdges) continue;
+        int added = fillHole(mesh, loop, meshEdges);
+        if (added > 0) {
+            ++stats.filled;
+            stats.triangles += added;
+        }
+    }
+    return stats;
+}
+
+// =====================================================================
+//  Per-Component Pipeline
+// =====================================================================
+
+/// Count boundary edges and edges not shared by exactly one opposite pair
+void edgeHealth(const TriangleMesh& mesh, int* openEdges, int* badEdges)
+{
+    std::unordered_map<uint64_t, int> uses;
+    uses.reserve(mesh.triangles.size() * 3);
+    for (const MeshTriangle& t : mesh.triangles) {
+        for (int k = 0; k < 3; ++k) ++uses[directedKey(t[k], t[(k + 1) % 3])];
+    }
+
+    int open = 0;
+    int bad = 0;
+    for (const auto& entry : uses) {
+        int a = static_cast<int>(entry.first >> 32);
+        int b = static_cast<int>(entry.first & 0xFFFFFFFFu);
+        auto opposite = uses.find(directedKey(b, a));
+        if (opposite == uses.end()) {
+            open += entry.second;
+            if (entry.second > 1) ++bad;
+        } else if (entry.second != 1 || opposite->second != 1) {
+            if (a < b) ++bad;
+        }
+    }
+    if (openEdges) *openEdges = open;
+    if (badEdges) *badEdges = bad;
+}
+
+struct ComponentReport {
+    int flipped = 0;
+    int selfIntersecting = 0;
+    int holes = 0;
+    int filledHoles = 0;
+    int fillTriangles = 0;
+};
+
+/// Grow a triangle selection by the triangles sharing a vertex with it
+void growSelection(const TriangleMesh& mesh, std::vector<char>& selected)
+{
+    std::vector<char> vertex(mesh.vertices.size(), 0);
+    for (int i = 0; i < mesh.triangleCount(); ++i) {
+        if (!selected[i]) continue;
+        for (int v : mesh.triangles[i]) vertex[v] = 1;
+    }
+    for (int i = 0; i < mesh.triangleCount(); ++i) {
+        const MeshTriangle& t = mesh.triangles[i];
+        if (vertex[t[0]] || vertex[t[1]] || vertex[t[2]]) selected[i] = 1;
+    }
+}
+
+ComponentReport repairComponent(TriangleMesh& mesh, const RepairOptions& options, bool parallel)
+{
+    ComponentReport report;
+
+    if (options.fixOrientation) report.flipped = orient(mesh);
+
+    if (options.fillHoles) {
+        HoleFillStats fill = fillHoles(mesh, options.maxHoleEdges);
+        report.holes = fill.holes;
+        report.filledHoles = fill.filled;
+        report.fillTriangles = fill.triangles;
+    } else {
+        report.holes = static_cast<int>(boundaryLoops(mesh).size());
+    }
+
+    if (options.removeSelfIntersections) {
+        // Cut out crossing triangles and refill; if the patch still
+        // crosses, cut a ring wider on the next pass
+        for (int pass = 0; pass < std::max(1, options.selfIntersectionPasses); ++pass) {
+            std::vector<char> flags = findSelfIntersections(mesh, parallel);
+            int count = static_cast<int>(std::count(flags.begin(), flags.end(), 1));
+            if (count == 0) break;
+            if (pass == 0) report.selfIntersecting = count;
+
+            for (int ring = 0; ring < pass; ++ring) growSelection(mesh, flags);
+            compact(mesh, flags);
+            if (!options.fillHoles) break;
+            report.fillTriangles += fillHoles(mesh, options.maxHoleEdges).triangles;
+        }
+    }
+    return report;
+}
+
+/// Weld, then strip collapsed, sliver, duplicate and non-manifold
+/// triangles, recording counts in the summary
+void cleanup(TriangleMesh& mesh, const RepairOptions& options, DefectSummary& summary)
+{
+    double tolerance = options.weldTolerance > 0.0
+                           ? options.weldTolerance
+                           : mesh.diagonal() * kRelativeWeldTolerance;
+    summary.weldedVertices = weldVertices(mesh, tolerance);
+    summary.degenerateTriangles = removeCollapsed(mesh);
+    summary.degenerateTriangles += removeSlivers(mesh);
+    summary.duplicateTriangles = removeDuplicates(mesh);
+    summary.nonManifoldTriangles = removeNonManifold(mesh, &summary.nonManifoldEdges);
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+// =====================================================================
+//  Public API
+// =====================================================================
+
+int weldVertices(TriangleMesh& mesh, double tolerance)
+{
+    const int n = mesh.vertexCount();
+    std::vector<int> remap(n);
+    int merged = 0;
+
+    if (tolerance <= 0.0) {
+        std::vector<int> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        auto coords = [&](int i) {
+            const MeshPoint& p = mesh.vertices[i];
+            return std::make_tuple(p.x, p.y, p.z);
+        };
+        std::sort(order.begin(), order.end(),
+                  [&](int a, int b) { return coords(a) < coords(b); });
+        for (int i = 0; i < n; ++i) {
+            bool same = i > 0 && coords(order[i]) == coords(order[i - 1]);
+            remap[order[i]] = same ? remap[order[i - 1]] : order[i];
+            if (same) ++merged;
+        }
+    } else {
+        // Grid with cells one tolerance wide; a match can only be in
+        // the 27 cells around a vertex
+        const double tol2 = tolerance * tolerance;
+        auto cellIndex = [tolerance](double v) {
+            return static_cast<int64_t>(std::floor(v / tolerance));
+        };
+        auto cellKey = [](int64_t x, int64_t y, int64_t z) {
+            return (static_cast<uint64_t>(x) * 73856093u) ^
+                   (static_cast<uint64_t>(y) * 19349663u) ^
+                   (static_cast<uint64_t>(z) * 83492791u);
+        };
+        std::unordered_map<uint64_t, std::vector<int>> grid;
+        grid.reserve(n);
+
+        for (int i = 0; i < n; ++i) {
+            const MeshPoint& p = mesh.vertices[i];
+            const int64_t cx = cellIndex(p.x), cy = cellIndex(p.y), cz = cellIndex(p.z);
+            int match = -1;
+            for (int64_t dx = -1; dx <= 1 && match < 0; ++dx) {
+                for (int64_t dy = -1; dy <= 1 && match < 0; ++dy) {
+                    for (int64_t dz = -1; dz <= 1 && match < 0; ++dz) {
+                        auto it = grid.find(cellKey(cx + dx, cy + dy, cz + dz));
+                        if (it == grid.end()) continue;
+                        for (int rep : it->second) {
+                            MeshPoint d = mesh.vertices[rep] - p;
+                            if (d.dot(d) <= tol2) {
+                                match = rep;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+            if (match >= 0) {
+                remap[i] = match;
+                ++merged;
+            } else {
+                remap[i] = i;
+                grid[cellKey(cx, cy, cz)].push_back(i);
+            }
+        }
+    }
+
+    if (merged == 0) return 0;
+    for (MeshTriangle& t : mesh.triangles) {
+        for (int& v : t) v = remap[v];
+    }
+    mesh.removeUnusedVertices();
+    return merged;
+}
+
+std::vector<TriangleMesh> splitComponents(const TriangleMesh& mesh)
+{
+    std::vector<TriangleMesh> parts;
+    for (const auto& triangles : componentTriangles(mesh)) {
+        parts.push_back(extract(mesh, triangles));
+    }
+    return parts;
+}
+
+DefectSummary analyze(const TriangleMesh& mesh, const RepairOptions& options)
+{
+    DefectSummary summary;
+    summary.inputVertices = mesh.vertexCount();
+    summary.inputTriangles = mesh.triangleCount();
+
+    TriangleMesh work = mesh;
+    cleanup(work, options, summary);
+
+    std::vector<TriangleMesh> parts = splitComponents(work);
+    summary.components = static_cast<int>(parts.size());
+
+    // Orientation and self-intersections are measured per component on
+    // the cleaned copy; holes are counted after orientation
+    std::vector<ComponentReport> reports(parts.size());
+    const bool perComponent = options.parallel && parts.size() > 1;
+    OSD_Parallel::For(0, static_cast<int>(parts.size()), [&](int i) {
+        TriangleMesh& part = parts[i];
+        if (options.fixOrientation) reports[i].flipped = orient(part);
+        reports[i].holes = static_cast<int>(boundaryLoops(part).size());
+        std::vector<char> flags = findSelfIntersections(part, options.parallel && !perComponent);
+        reports[i].selfIntersecting = static_cast<int>(std::count(flags.begin(), flags.end(), 1));
+    }, !perComponent);
+
+    for (const ComponentReport& r : reports) {
+        summary.flippedTriangles += r.flipped;
+        summary.holes += r.holes;
+        summary.selfIntersectingTriangles += r.selfIntersecting;
+    }
+
+    // Describe the input as welded, before anything is removed
+    TriangleMesh welded = mesh;
+    weldVertices(welded, options.weldTolerance > 0.0 ? options.weldTolerance
+                                                      : welded.diagonal() * kRelativeWeldTolerance);
+    int badEdges = 0;
+    edgeHealth(welded, &summary.openEdges, &badEdges);
+    summary.outputVertices = welded.vertexCount();
+    summary.outputTriangles = welded.triangleCount();
+    summary.watertight = !welded.isEmpty() && summary.openEdges == 0 && badEdges == 0 &&
+                         summary.degenerateTriangles == 0 && summary.duplicateTriangles == 0;
+    return summary;
+}
+
+RepairResult repair(const TriangleMesh& mesh, const RepairOptions& options)
+{
+    const auto start = std::chrono::steady_clock::now();
+    RepairResult result;
+    DefectSummary& summary = result.summary;
+    summary.inputVertices = mesh.vertexCount();
+    summary.inputTriangles = mesh.triangleCount();
+
+    for (const MeshTriangle& t : mesh.triangles) {
+        for (int v : t) {
+            if (v < 0 || v >= mesh.vertexCount()) {
+                result.errorMessage = "Triangle references a vertex out of range";
+                return result;
+            }
+        }
+    }
+
+    TriangleMesh work = mesh;
+    cleanup(work, options, summary);
+
+    std::vector<TriangleMesh> parts = splitComponents(work);
+    summary.components = static_cast<int>(parts.size());
+
+    // Size filters (parts are sorted largest first)
+    size_t keep = parts.size();
+    if (options.keepLargestComponentOnly && keep > 1) keep = 1;
+    while (keep > 1 && options.minComponentTriangles > 0 &&
+           parts[keep - 1].triangleCount() < options.minComponentTriangles) {
+        --keep;
+    }
+    summary.removedComponents = static_cast<int>(parts.size() - keep);
+    parts.resize(keep);
+
+    // Components are independent, so they are repaired concurrently.
+    // A single large component parallelizes its intersection search
+    // instead.
+    std::vector<ComponentReport> reports(parts.size());
+    const bool perComponent = options.parallel && parts.size() > 1;
+    OSD_Parallel::For(0, static_cast<int>(parts.size()), [&](int i) {
+        reports[i] = repairComponent(parts[i], options, options.parallel && !perComponent);
+    }, !perComponent);
+
+    for (size_t i = 0; i < parts.size(); ++i) {
+        const ComponentReport& r = reports[i];
+        summary.flippedTriangles += r.flipped;
+        summary.selfIntersectingTriangles += r.selfIntersecting;
+        summary.holes += r.holes;
+        summary.filledHoles += r.filledHoles;
+        summary.fillTriangles += r.fillTriangles;
+
+        const int base = result.mesh.vertexCount();
+        result.mesh.vertices.insert(result.mesh.vertices.end(),
+                                    parts[i].vertices.begin(), parts[i].vertices.end());
+        for (MeshTriangle t : parts[i].triangles) {
+            for (int& v : t) v += base;
+            result.mesh.triangles.push_back(t);
+        }
+    }
+    result.mesh.removeUnusedVertices();
+
+    int badEdges = 0;
+    edgeHealth(result.mesh, &summary.openEdges, &badEdges);
+    summary.outputVertices = result.mesh.vertexCount();
+    summary.outputTriangles = result.mesh.triangleCount();
+    summary.watertight = !result.mesh.isEmpty() && summary.openEdges == 0 && badEdges == 0;
+
+    result.success = !result.mesh.isEmpty();
+    if (!result.success) result.errorMessage = "No triangles left after repair";
+    result.milliseconds = elapsedMs(start);
+    return result;
+}
+
+}  // namespace mesh
+}  // namespace hobbycad
@@ -0,0 +1,226 @@
+// =====================================================================
+//  src/libhobbycad/mesh/slice.cpp — Multi-plane mesh slicing
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/mesh/slice.h>
+#include <hobbycad/mesh/repair.h>
+
+#include <OSD_Parallel.hxx>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+
+namespace hobbycad {
+namespace mesh {
+
+namespace {
+
+/// Vertices closer than this fraction of the diagonal are one vertex
+constexpr double kRelativeWeldTolerance = 1e-9;
+
+/// A normal within this of an axis is treated as that axis
+constexpr double kAxisTolerance = 1e-12;
+
+MeshPoint normalized(const MeshPoint& v)
+{
+    const double length = v.length();
+    return length > 0.0 ? v * (1.0 / length) : MeshPoint(0.0, 0.0, 1.0);
+}
+
+uint64_t edgeKey(int a, int b)
+{
+    if (a > b) std::swap(a, b);
+    return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+}
+
+/// One triangle's cut: the two mesh edges it crosses
+struct Segment {
+    uint64_t edge[2];
+};
+
+/// Cut one plane: collect a segment per crossing triangle, then walk
+/// the segments through the edges they share
+MeshSection cutPlane(const TriangleMesh& mesh, const std::vector<double>& heights,
+                     const std::vector<int>& triangles, double offset,
+                     const MeshPoint& xDir, const MeshPoint& yDir)
+{
+    MeshSection section;
+    section.offset = offset;
+
+    std::vector<Segment> segments;
+    segments.reserve(triangles.size());
+    std::unordered_map<uint64_t, Point2D> points;
+    std::unordered_map<uint64_t, std::array<int, 2>> uses;
+    points.reserve(triangles.size());
+    uses.reserve(triangles.size());
+
+    auto crossing = [&](int a, int b) {
+        if (a > b) std::swap(a, b);  // same point from both triangles
+        const uint64_t key = edgeKey(a, b);
+        if (points.find(key) == points.end()) {
+            const double t = (offset - heights[a]) / (heights[b] - heights[a]);
+            const MeshPoint p = mesh.vertices[a] + (mesh.vertices[b] - mesh.vertices[a]) * t;
+            points.emplace(key, Point2D(p.dot(xDir), p.dot(yDir)));
+        }
+        return key;
+    };
+
+    for (int t : triangles) {
+        const MeshTriangle& tri = mesh.triangles[t];
+        if (tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0]) continue;
+        Segment s;
+        int found = 0;
+        for (int k = 0; k < 3 && found < 2; ++k) {
+            const int a = tri[k], b = tri[(k + 1) % 3];
+            if ((heights[a] >= offset) != (heights[b] >= offset)) s.edge[found++] = crossing(a, b);
+        }
+        if (found != 2) continue;
+        const int index = static_cast<int>(segments.size());
+        segments.push_back(s);
+        for (uint64_t key : s.edge) {
+            auto [it, inserted] = uses.emplace(key, std::array<int, 2>{index, -1});
+            if (!inserted) {
+                if (it->second[1] < 0) it->second[1] = index;
+                else it->second = {-1, -1};  // non-manifold edge: break the chain here
+            }
+        }
+    }
+
+    // Walk from an edge along unused segments until the chain closes or
+    // ends at an edge with only one segment
+    std::vector<char> used(segments.size(), 0);
+    auto walk = [&](int first, uint64_t from, std::vector<Point2D>& out) {
+        uint64_t at = from;
+        int seg = first;
+        out.push_back(points[at]);
+        while (seg >= 0 && !used[seg]) {
+            used[seg] = 1;
+            const Segment& s = segments[seg];
+            at = s.edge[0] == at ? s.edge[1] : s.edge[0];
+            out.push_back(points[at]);
+            const auto& next = uses[at];
+            seg = next[0] == seg ? next[1] : next[0];
+        }
+        return at == from && out.size() > 2;
+    };
+
+    // Open chains first, from edges used by a single segment
+    for (const auto& [key, pair] : uses) {
+        if (pair[0] < 0 || pair[1] >= 0 || used[pair[0]]) continue;
+        std::vector<Point2D> chain;
+        walk(pair[0], key, chain);
+        if (chain.size() >= 2) section.chains.push_back(std::move(chain));
+    }
+    for (int i = 0; i < static_cast<int>(segments.size()); ++i) {
+        if (used[i]) continue;
+        std::vector<Point2D> loop;
+        if (walk(i, segments[i].edge[0], loop)) {
+            loop.pop_back();
+            section.loops.push_back(std::move(loop));
+        } else if (loop.size() >= 2) {
+            section.chains.push_back(std::move(loop));
+        }
+    }
+    return section;
+}
+
+}  // anonymous namespace
+
+SlicePlanes SlicePlanes::evenlySpaced(const MeshPoint& normal, double first, double last,
+                                      int count)
+{
+    SlicePlanes planes;
+    planes.normal = normal;
+    for (int i = 0; i < count; ++i)
+        planes.offsets.push_back(count == 1 ? first : first + (last - first) * i / (count - 1));
+    return planes;
+}
+
+void planeAxes(const MeshPoint& normal, MeshPoint& xDir, MeshPoint& yDir)
+{
+    const MeshPoint n = normalized(normal);
+    if (std::abs(n.x) < kAxisTolerance && std::abs(n.y) < kAxisTolerance) {
+        xDir = {1.0, 0.0, 0.0};   // XY
+        yDir = {0.0, 1.0, 0.0};
+    } else if (std::abs(n.x) < kAxisTolerance && std::abs(n.z) < kAxisTolerance) {
+        xDir = {1.0, 0.0, 0.0};   // XZ
+        yDir = {0.0, 0.0, 1.0};
+    } else if (std::abs(n.y) < kAxisTolerance && std::abs(n.z) < kAxisTolerance) {
+        xDir = {0.0, 1.0, 0.0};   // YZ
+        yDir = {0.0, 0.0, 1.0};
+    } else {
+        xDir = normalized(MeshPoint(0.0, 0.0, 1.0).cross(n));
+        yDir = n.cross(xDir);
+    }
+}
+
+std::vector<MeshSection> sliceMesh(const TriangleMesh& input, const SlicePlanes& planes,
+                                   bool parallel)
+{
+    const int planeCount = static_cast<int>(planes.offsets.size());
+    std::vector<MeshSection> sections(planeCount);
+    for (int i = 0; i < planeCount; ++i) sections[i].offset = planes.offsets[i];
+    if (input.isEmpty() || planeCount == 0) return sections;
+
+    TriangleMesh mesh = input;
+    weldVertices(mesh, mesh.diagonal() * kRelativeWeldTolerance);
+
+    const MeshPoint n = normalized(planes.normal);
+    MeshPoint xDir, yDir;
+    planeAxes(n, xDir, yDir);
+
+    std::vector<double> heights(mesh.vertices.size());
+    for (size_t v = 0; v < heights.size(); ++v)
+        heights[v] = (mesh.vertices[v] - planes.origin).dot(n);
+
+    // Planes in ascending order; a triangle crosses the planes with
+    // offsets in (lowest vertex, highest vertex]
+    std::vector<int> order(planeCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&](int a, int b) { return planes.offsets[a] < planes.offsets[b]; });
+    std::vector<double> sorted(planeCount);
+    for (int i = 0; i < planeCount; ++i) sorted[i] = planes.offsets[order[i]];
+
+    auto span = [&](const MeshTriangle& t) {
+        const double lo = std::min({heights[t[0]], heights[t[1]], heights[t[2]]});
+        const double hi = std::max({heights[t[0]], heights[t[1]], heights[t[2]]});
+        const int first = static_cast<int>(std::upper_bound(sorted.begin(), sorted.end(), lo) - sorted.begin());
+        const int last = static_cast<int>(std::upper_bound(sorted.begin(), sorted.end(), hi) - sorted.begin());
+        return std::make_pair(first, last);
+    };
+
+    // Bin the triangles to their planes: count, then fill
+    std::vector<int> start(planeCount + 1, 0);
+    for (const MeshTriangle& t : mesh.triangles) {
+        const auto [first, last] = span(t);
+        for (int p = first; p < last; ++p) ++start[p + 1];
+    }
+    std::partial_sum(start.begin(), start.end(), start.begin());
+    std::vector<int> binned(start.back());
+    std::vector<int> fill(start.begin(), start.end() - 1);
+    for (int t = 0; t < mesh.triangleCount(); ++t) {
+        const auto [first, last] = span(mesh.triangles[t]);
+        for (int p = first; p < last; ++p) binned[fill[p]++] = t;
+    }
+
+    // Each task writes only its own section
+    OSD_Parallel::For(0, planeCount, [&](int p) {
+        const std::vector<int> triangles(binned.begin() + start[p], binned.begin() + start[p + 1]);
+        sections[order[p]] = cutPlane(mesh, heights, triangles, sorted[p], xDir, yDir);
+    }, !parallel);
+    return sections;
+}
+
+}  // namespace mesh
+}  // namespace hobbycad
@@ -0,0 +1,253 @@
+// =====================================================================
+//  src/libhobbycad/mesh/types.cpp — Indexed triangle meshes
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/mesh/types.h>
+
+#include <BRepBuilderAPI_MakeEdge.hxx>
+#include <BRepBuilderAPI_MakeFace.hxx>
+#include <BRepLib.hxx>
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <Poly_Triangle.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_Face.hxx>
+#include <TopoDS_Shell.hxx>
+#include <TopoDS_Solid.hxx>
+#include <TopoDS_Vertex.hxx>
+#include <TopoDS_Wire.hxx>
+#include <gp_Pln.hxx>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
+namespace hobbycad {
+namespace mesh {
+
+// =====================================================================
+//  TriangleMesh
+// =====================================================================
+
+double TriangleMesh::diagonal() const
+{
+    if (vertices.empty()) return 0.0;
+
+    MeshPoint lo = vertices.front();
+    MeshPoint hi = lo;
+    for (const MeshPoint& p : vertices) {
+        lo = {std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z)};
+        hi = {std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z)};
+    }
+    return (hi - lo).length();
+}
+
+void TriangleMesh::removeUnusedVertices()
+{
+    std::vector<int> remap(vertices.size(), -1);
+    std::vector<MeshPoint> kept;
+    kept.reserve(vertices.size());
+
+    for (MeshTriangle& t : triangles) {
+        for (int& v : t) {
+            if (remap[v] < 0) {
+                remap[v] = static_cast<int>(kept.size());
+                kept.push_back(vertices[v]);
+            }
+            v = remap[v];
+        }
+    }
+    vertices.swap(kept);
+}
+
+// =====================================================================
+//  Conversions
+// =====================================================================
+
+TriangleMesh fromTriangulation(const Handle(Poly_Triangulation)& triangulation)
+{
+    TriangleMesh mesh;
+    if (triangulation.IsNull()) return mesh;
+
+    mesh.vertices.reserve(triangulation->NbNodes());
+    for (int i = 1; i <= triangulation->NbNodes(); ++i) {
+        gp_Pnt p = triangulation->Node(i);
+        mesh.vertices.emplace_back(p.X(), p.Y(), p.Z());
+    }
+
+    mesh.triangles.reserve(triangulation->NbTriangles());
+    for (int i = 1; i <= triangulation->NbTriangles(); ++i) {
+        int a = 0, b = 0, c = 0;
+        triangulation->Triangle(i).Get(a, b, c);
+        mesh.triangles.push_back({a - 1, b - 1, c - 1});
+    }
+    return mesh;
+}
+
+TriangleMesh fromShape(const TopoDS_Shape& shape)
+{
+    TriangleMesh mesh;
+    if (shape.IsNull()) return mesh;
+
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        const TopoDS_Face& face = TopoDS::Face(exp.Current());
+        TopLoc_Location location;
+        Handle(Poly_Triangulation) tri = BRep_Tool::Triangulation(face, location);
+        if (tri.IsNull()) continue;
+
+        const int base = mesh.vertexCount();
+        const gp_Trsf& trsf = location.Transformation();
+        for (int i = 1; i <= tri->NbNodes(); ++i) {
+            gp_Pnt p = tri->Node(i);
+            if (!location.IsIdentity()) p.Transform(trsf);
+            mesh.vertices.emplace_back(p.X(), p.Y(), p.Z());
+        }
+
+        const bool reversed = face.Orientation() == TopAbs_REVERSED;
+        for (int i = 1; i <= tri->NbTriangles(); ++i) {
+            int a = 0, b = 0, c = 0;
+            tri->Triangle(i).Get(a, b, c);
+            if (reversed) std::swap(b, c);
+            mesh.triangles.push_back({base + a - 1, base + b - 1, base + c - 1});
+        }
+    }
+    return mesh;
+}
+
+Handle(Poly_Triangulation) toTriangulation(const TriangleMesh& mesh)
+{
+    if (mesh.isEmpty()) return Handle(Poly_Triangulation)();
+
+    Handle(Poly_Triangulation) tri =
+        new Poly_Triangulation(mesh.vertexCount(), mesh.triangleCount(), Standard_False);
+    for (int i = 0; i < mesh.vertexCount(); ++i) {
+        const MeshPoint& p = mesh.vertices[i];
+        tri->SetNode(i + 1, gp_Pnt(p.x, p.y, p.z));
+    }
+    for (int i = 0; i < mesh.triangleCount(); ++i) {
+        const MeshTriangle& t = mesh.triangles[i];
+        tri->SetTriangle(i + 1, Poly_Triangle(t[0] + 1, t[1] + 1, t[2] + 1));
+    }
+    return tri;
+}
+
+TopoDS_Shape toMeshFace(const TriangleMesh& mesh)
+{
+    Handle(Poly_Triangulation) tri = toTriangulation(mesh);
+    if (tri.IsNull()) return TopoDS_Shape();
+
+    TopoDS_Face face;
+    BRep_Builder builder;
+    builder.MakeFace(face);
+    builder.UpdateFace(face, tri);
+    return face;
+}
+
+TopoDS_Shape toSolid(const TriangleMesh& mesh, std::string* errorMsg)
+{
+    if (mesh.isEmpty()) {
+        if (errorMsg) *errorMsg = "Mesh is empty";
+        return TopoDS_Shape();
+    }
+
+    try {
+        BRep_Builder builder;
+        const double tolerance = std::max(1e-7, mesh.diagonal() * 1e-9);
+
+        std::vector<TopoDS_Vertex> vertices(mesh.vertices.size());
+        auto vertexAt = [&](int index) -> const TopoDS_Vertex& {
+            if (vertices[index].IsNull()) {
+                const MeshPoint& p = mesh.vertices[index];
+                builder.MakeVertex(vertices[index], gp_Pnt(p.x, p.y, p.z), tolerance);
+            }
+            return vertices[index];
+        };
+
+        // One edge per undirected mesh edge, built from the lower index
+        // to the higher; the other triangle uses it reversed.  Edge use
+        // counts tell whether the result is closed.
+        struct SharedEdge {
+            TopoDS_Edge edge;
+            int forwardUses = 0;
+            int reverseUses = 0;
+        };
+        std::unordered_map<uint64_t, SharedEdge> edges;
+        edges.reserve(mesh.triangles.size() * 2);
+
+        TopoDS_Shell shell;
+        builder.MakeShell(shell);
+        int faceCount = 0;
+
+        for (const MeshTriangle& t : mesh.triangles) {
+            const MeshPoint& p0 = mesh.vertices[t[0]];
+            MeshPoint normal = (mesh.vertices[t[1]] - p0).cross(mesh.vertices[t[2]] - p0);
+            double length = normal.length();
+            if (length <= std::numeric_limits<double>::min()) continue;
+
+            TopoDS_Wire wire;
+            builder.MakeWire(wire);
+            for (int k = 0; k < 3; ++k) {
+                int a = t[k];
+                int b = t[(k + 1) % 3];
+                bool forward = a < b;
+                uint64_t key = (static_cast<uint64_t>(std::min(a, b)) << 32) |
+                               static_cast<uint32_t>(std::max(a, b));
+                SharedEdge& shared = edges[key];
+                if (shared.edge.IsNull()) {
+                    shared.edge = BRepBuilderAPI_MakeEdge(vertexAt(std::min(a, b)),
+                                                          vertexAt(std::max(a, b))).Edge();
+                }
+                (forward ? shared.forwardUses : shared.reverseUses)++;
+                builder.Add(wire, forward ? shared.edge : TopoDS::Edge(shared.edge.Reversed()));
+            }
+            wire.Closed(Standard_True);
+
+            gp_Pln plane(gp_Pnt(p0.x, p0.y, p0.z),
+                         gp_Dir(normal.x / length, normal.y / length, normal.z / length));
+            BRepBuilderAPI_MakeFace makeFace(plane, wire, Standard_True);
+            if (!makeFace.IsDone()) continue;
+            builder.Add(shell, makeFace.Face());
+            ++faceCount;
+        }
+
+        if (faceCount == 0) {
+            if (errorMsg) *errorMsg = "Mesh has no non-degenerate triangles";
+            return TopoDS_Shape();
+        }
+
+        bool closed = faceCount == mesh.triangleCount();
+        for (const auto& entry : edges) {
+            if (entry.second.forwardUses != 1 || entry.second.reverseUses != 1) {
+                closed = false;
+                break;
+            }
+        }
+        if (!closed) return shell;
+
+        shell.Closed(Standard_True);
+        TopoDS_Solid solid;
+        builder.MakeSolid(solid);
+        builder.Add(solid, shell);
+        BRepLib::OrientClosedSolid(solid);
+        return solid;
+
+    } catch (const Standard_Failure& e) {
+        if (errorMsg) *errorMsg = std::string("OCCT exception: ") + e.GetMessageString();
+    } catch (...) {
+        if (errorMsg) *errorMsg = "Unknown exception while building B-rep from mesh";
+    }
+    return TopoDS_Shape();
+}
+
+}  // namespace mesh
+}  // namespace hobbycad
@@ -9,14 +9,7 @@
 
 #include <hobbycad/parameters.h>
 #include <hobbycad/format.h>
-
-#if HOBBYCAD_HAS_QT
-#include <QJsonArray>
-#include <QJsonObject>
-#include <QString>
-#else
-#include <nlohmann/json.hpp>
-#endif
+#include <hobbycad/json_stream.h>
 
 #include <algorithm>
 #include <cctype>
@@ -1005,112 +998,91 @@ std::vector<std::string> ParameterEngine::usedParameters(const std::string& expr
     return temp.d->usedParams(expression);
 }
 
-#if HOBBYCAD_HAS_QT
-QJsonObject ParameterEngine::toJson() const
+std::string ParameterEngine::toJson() const
 {
-    QJsonArray params;
-    for (auto it = d->parameters.begin(); it != d->parameters.end(); ++it) {
-        QJsonObject p;
-        p["name"] = QString::fromStdString(it->second.name);
-        p["expression"] = QString::fromStdString(it->second.expression);
-        if (!it->second.unit.empty())
-            p["unit"] = QString::fromStdString(it->second.unit);
-        if (!it->second.comment.empty())
-            p["comment"] = QString::fromStdString(it->second.comment);
-        if (!it->second.isUserParam)
-            p["isUserParam"] = false;
-        params.append(p);
-    }
-
-    QJsonObject obj;
-    obj["parameters"] = params;
-    return obj;
+    JsonWriter w;
+    writeJson(w);
+    return w.take();
 }
 
-bool ParameterEngine::fromJson(const QJsonObject& json, std::string* errorMsg)
+bool ParameterEngine::fromJson(const std::string& json, std::string* errorMsg)
 {
-    clear();
-
-    if (!json.contains("parameters")) {
-        return true;  // Empty is valid
-    }
-
-    QJsonArray params = json["parameters"].toArray();
-    for (const QJsonValue& val : params) {
-        QJsonObject p = val.toObject();
-
-        Parameter param;
-        param.name = p["name"].toString().toStdString();
-        param.expression = p["expression"].toString().toStdString();
-        param.unit = p["unit"].toString().toStdString();
-        param.comment = p["comment"].toString().toStdString();
-        param.isUserParam = p.value("isUserParam").toBool(true);
-
-        if (param.name.empty()) {
-            if (errorMsg) *errorMsg = "Parameter missing name";
-            return false;
-        }
-
-        d->parameters[param.name] = param;
+    JsonReader r(json);
+    if (!readJson(r, errorMsg)) return false;
+    if (!r.atEnd()) {
+        if (errorMsg) *errorMsg = "Invalid parameters JSON: " + r.errorMessage();
+        return false;
     }
-
-    d->buildDependencyGraph();
     return true;
 }
 
-#else  // !HOBBYCAD_HAS_QT — nlohmann/json fallback
-
-nlohmann::json ParameterEngine::toJson() const
+void ParameterEngine::writeJson(JsonWriter& w) const
 {
-    nlohmann::json params = nlohmann::json::array();
+    w.beginObject();
+    w.key("parameters");
+    w.beginArray();
     for (auto it = d->parameters.begin(); it != d->parameters.end(); ++it) {
-        nlohmann::json p;
-        p["name"] = it->second.name;
-        p["expression"] = it->second.expression;
+        w.beginObject();
+        w.field("name", it->second.name);
+        w.field("expression", it->second.expression);
         if (!it->second.unit.empty())
-            p["unit"] = it->second.unit;
+            w.field("unit", it->second.unit);
         if (!it->second.comment.empty())
-            p["comment"] = it->second.comment;
+            w.field("comment", it->second.comment);
         if (!it->second.isUserParam)
-            p["isUserParam"] = false;
-        params.push_back(p);
+            w.field("isUserParam", false);
+        w.endObject();
     }
-
-    nlohmann::json obj;
-    obj["parameters"] = params;
-    return obj;
+    w.endArray();
+    w.endObject();
 }
 
-bool ParameterEngine::fromJson(const nlohmann::json& json, std::string* errorMsg)
+bool ParameterEngine::readJson(JsonReader& r, std::string* errorMsg)
 {
     clear();
 
-    if (!json.contains("parameters")) {
-        return true;  // Empty is valid
-    }
+    // A missing "parameters" key is valid (empty)
+    if (!r.beginObject()) return r.ok();
+
+    std::string key;
+    while (r.nextKey(key)) {
+        if (key != "parameters") {
+            r.skipValue();
+            continue;
+        }
+        if (!r.beginArray()) continue;
+
+        while (r.nextElement()) {
+            Parameter param;
+            if (r.beginObject()) {
+                while (r.nextKey(key)) {
+                    if (key == "name")             param.name = r.readString();
+                    else if (key == "expression")  param.expression = r.readString();
+                    else if (key == "unit")        param.unit = r.readString();
+                    else if (key == "comment")     param.comment = r.readString();
+                    else if (key == "isUserParam") param.isUserParam = r.readBool(true);
+                    else r.skipValue();
+                }
+            }
 
-    for (const auto& p : json["parameters"]) {
-        Parameter param;
-        param.name = p.value("name", std::string{});
-        param.expression = p.value("expression", std::string{});
-        param.unit = p.value("unit", std::string{});
-        param.comment = p.value("comment", std::string{});
-        param.isUserParam = p.value("isUserParam", true);
+            if (param.name.empty()) {
+                if (errorMsg) *errorMsg = "Parameter missing name";
+                return false;
+            }
 
-        if (param.name.empty()) {
-            if (errorMsg) *errorMsg = "Parameter missing name";
-            return false;
+            d->parameters[param.name] = param;
         }
+    }
 
-        d->parameters[param.name] = param;
+    if (!r.ok()) {
+        if (errorMsg) *errorMsg = "Invalid parameters JSON: " + r.errorMessage();
+        return false;
     }
 
     d->buildDependencyGraph();
     return true;
 }
 
-#endif  // HOBBYCAD_HAS_QT
-
 // ---- Standalone expression evaluation ----
 
 bool evaluateExpression(const std::string& expression, double& result,
@@ -0,0 +1,359 @@
+// =====================================================================
+//  src/libhobbycad/png_writer.cpp — Dependency-free PNG encoder
+// =====================================================================
+
+#include "hobbycad/png_writer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <fstream>
+
+namespace hobbycad {
+
+namespace {
+
+// =====================================================================
+//  Checksums
+// =====================================================================
+
+const std::array<uint32_t, 256>& crcTable()
+{
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+    return table;
+}
+
+uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0)
+{
+    const auto& table = crcTable();
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t adler32(const std::vector<uint8_t>& data)
+{
+    uint32_t a = 1, b = 0;
+    size_t i = 0;
+    while (i < data.size()) {
+        // 5552 is the largest run that cannot overflow 32 bits
+        size_t end = std::min(data.size(), i + 5552);
+        for (; i < end; ++i) {
+            a += data[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+// =====================================================================
+//  Deflate (LZ77 + fixed Huffman codes, RFC 1951)
+// =====================================================================
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+    /// Append bits least-significant first (block headers, extra bits)
+    void bits(uint32_t value, int count)
+    {
+        m_buffer |= value << m_count;
+        m_count += count;
+        while (m_count >= 8) {
+            m_out.push_back(static_cast<uint8_t>(m_buffer));
+            m_buffer >>= 8;
+            m_count -= 8;
+        }
+    }
+
+    /// Append a Huffman code (stored most-significant bit first)
+    void code(uint32_t code, int length)
+    {
+        uint32_t reversed = 0;
+        for (int i = 0; i < length; ++i) {
+            reversed = (reversed << 1) | ((code >> i) & 1);
+        }
+        bits(reversed, length);
+    }
+
+    void flush()
+    {
+        if (m_count > 0) m_out.push_back(static_cast<uint8_t>(m_buffer));
+        m_buffer = 0;
+        m_count = 0;
+    }
+
+private:
+    std::vector<uint8_t>& m_out;
+    uint32_t m_buffer = 0;
+    int m_count = 0;
+};
+
+const int kLengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+const int kLengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+const int kDistanceBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577
+};
+const int kDistanceExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+constexpr int kWindowSize = 32768;
+constexpr int kMinMatch = 3;
+constexpr int kMaxMatch = 258;
+constexpr int kHashBits = 15;
+constexpr int kMaxChain = 32;
+
+void writeLiteralOrLength(BitWriter& w, int symbol)
+{
+    if (symbol < 144)      w.code(0x30 + symbol, 8);
+    else if (symbol < 256) w.code(0x190 + symbol - 144, 9);
+    else if (symbol < 280) w.code(symbol - 256, 7);
+    else                   w.code(0xC0 + symbol - 280, 8);
+}
+
+void writeMatch(BitWriter& w, int length, int distance)
+{
+    int lc = 28;
+    while (kLengthBase[lc] > length) --lc;
+    writeLiteralOrLength(w, 257 + lc);
+    w.bits(length - kLengthBase[lc], kLengthExtra[lc]);
+
+    int dc = 29;
+    while (kDistanceBase[dc] > distance) --dc;
+    w.code(dc, 5);
+    w.bits(distance - kDistanceBase[dc], kDistanceExtra[dc]);
+}
+
+std::vector<uint8_t> deflate(const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> out;
+    out.reserve(data.size() / 4 + 64);
+    BitWriter w(out);
+
+    // One fixed-Huffman block: BFINAL = 1, BTYPE = 01
+    w.bits(1, 1);
+    w.bits(1, 2);
+
+    const int n = static_cast<int>(data.size());
+    std::vector<int> head(1 << kHashBits, -1);
+    std::vector<int> prev(kWindowSize, -1);
+
+    auto hashAt = [&](int i) {
+        uint32_t h = (uint32_t(data[i]) << 16) | (uint32_t(data[i + 1]) << 8) | data[i + 2];
+        return static_cast<int>((h * 2654435761u) >> (32 - kHashBits));
+    };
+    auto insert = [&](int i) {
+        if (i + kMinMatch > n) return;
+        int h = hashAt(i);
+        prev[i & (kWindowSize - 1)] = head[h];
+        head[h] = i;
+    };
+
+    int i = 0;
+    while (i < n) {
+        int bestLength = 0;
+        int bestDistance = 0;
+
+        if (i + kMinMatch <= n) {
+            int limit = std::min(kMaxMatch, n - i);
+            int candidate = head[hashAt(i)];
+            for (int chain = 0; candidate >= 0 && chain < kMaxChain; ++chain) {
+                int distance = i - candidate;
+                if (distance > kWindowSize - 1) break;
+
+                int length = 0;
+                while (length < limit && data[candidate + length] == data[i + length]) {
+                    ++length;
+                }
+                if (length > bestLength) {
+                    bestLength = length;
+                    bestDistance = distance;
+                    if (length == limit) break;
+                }
+
+                int next = prev[candidate & (kWindowSize - 1)];
+                if (next >= candidate) break;   // slot was reused by a newer position
+                candidate = next;
+            }
+        }
+
+        if (bestLength >= kMinMatch) {
+            writeMatch(w, bestLength, bestDistance);
+            for (int k = 0; k < bestLength; ++k) insert(i + k);
+            i += bestLength;
+        } else {
+            writeLiteralOrLength(w, data[i]);
+            insert(i);
+            ++i;
+        }
+    }
+
+    writeLiteralOrLength(w, 256);   // end of block
+    w.flush();
+    return out;
+}
+
+// =====================================================================
+//  PNG filtering and chunks
+// =====================================================================
+
+int paeth(int a, int b, int c)
+{
+    int p = a + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    return pb <= pc ? b : c;
+}
+
+/// Filter every row with whichever of the five PNG filters gives the
+/// smallest sum of absolute values (the usual libpng heuristic)
+std::vector<uint8_t> filterRows(const ImageBuffer& image)
+{
+    const size_t stride = static_cast<size_t>(image.width) * 4;
+    std::vector<uint8_t> out;
+    out.reserve((stride + 1) * image.height);
+
+    std::vector<uint8_t> candidate(stride);
+    std::vector<uint8_t> best(stride);
+    const std::vector<uint8_t> zeroRow(stride, 0);
+
+    for (int y = 0; y < image.height; ++y) {
+        const uint8_t* row = image.pixels.data() + y * stride;
+        const uint8_t* up = y > 0 ? row - stride : zeroRow.data();
+
+        long bestScore = -1;
+        int bestFilter = 0;
+        for (int filter = 0; filter < 5; ++filter) {
+            long score = 0;
+            for (size_t x = 0; x < stride; ++x) {
+                int a = x >= 4 ? row[x - 4] : 0;
+                int b = up[x];
+                int c = x >= 4 ? up[x - 4] : 0;
+                int predictor = 0;
+                switch (filter) {
+                case 1: predictor = a; break;
+                case 2: predictor = b; break;
+                case 3: predictor = (a + b) / 2; break;
+                case 4: predictor = paeth(a, b, c); break;
+                default: break;
+                }
+                uint8_t v = static_cast<uint8_t>(row[x] - predictor);
+                candidate[x] = v;
+                score += v < 128 ? v : 256 - v;
+            }
+            if (bestScore < 0 || score < bestScore) {
+                bestScore = score;
+                bestFilter = filter;
+                best.swap(candidate);
+            }
+        }
+
+        out.push_back(static_cast<uint8_t>(bestFilter));
+        out.insert(out.end(), best.begin(), best.end());
+    }
+    return out;
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t v)
+{
+    out.push_back(static_cast<uint8_t>(v >> 24));
+    out.push_back(static_cast<uint8_t>(v >> 16));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+void putChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data)
+{
+    putU32(out, static_cast<uint32_t>(data.size()));
+    size_t typeStart = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    putU32(out, crc32(out.data() + typeStart, out.size() - typeStart));
+}
+
+}  // namespace
+
+// =====================================================================
+//  Public API
+// =====================================================================
+
+std::vector<uint8_t> encodePng(const ImageBuffer& image)
+{
+    if (!image.isValid() ||
+        image.pixels.size() < static_cast<size_t>(image.width) * image.height * 4) {
+        return {};
+    }
+
+    std::vector<uint8_t> out = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+    std::vector<uint8_t> header;
+    putU32(header, static_cast<uint32_t>(image.width));
+    putU32(header, static_cast<uint32_t>(image.height));
+    header.push_back(8);   // bit depth
+    header.push_back(6);   // colour type: RGBA
+    header.push_back(0);   // compression
+    header.push_back(0);   // filter method
+    header.push_back(0);   // no interlace
+    putChunk(out, "IHDR", header);
+
+    // zlib stream: header, deflate data, Adler-32 of the raw data
+    std::vector<uint8_t> raw = filterRows(image);
+    std::vector<uint8_t> zlib = {0x78, 0x01};
+    std::vector<uint8_t> compressed = deflate(raw);
+    zlib.insert(zlib.end(), compressed.begin(), compressed.end());
+    putU32(zlib, adler32(raw));
+    putChunk(out, "IDAT", zlib);
+
+    putChunk(out, "IEND", {});
+    return out;
+}
+
+bool writePng(const std::string& path, const ImageBuffer& image, std::string* errorMsg)
+{
+    std::vector<uint8_t> png = encodePng(image);
+    if (png.empty()) {
+        if (errorMsg) *errorMsg = "Invalid image";
+        return false;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        if (errorMsg) *errorMsg = "Cannot open file for writing: " + path;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(png.data()),
+               static_cast<std::streamsize>(png.size()));
+    if (!file) {
+        if (errorMsg) *errorMsg = "Failed to write file: " + path;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace hobbycad
@@ -0,0 +1,576 @@
+// =====================================================================
+//  src/libhobbycad/sketch/auto_constrain.cpp — Constraint inference
+// =====================================================================
+//
+//  Candidates come from four near-linear searches:
+//
+//    - Coincidence: solver points (line ends, points, centers) hashed
+//      into a grid with one cell per tolerance.  Only the pairs that
+//      join two clusters become candidates, so a cluster of k points
+//      yields k − 1 of them.
+//    - Direction: lines sorted by direction (folded into half a turn)
+//      and swept into classes.  Lines of a class are chained by
+//      parallel candidates, and classes at right angles are paired by
+//      binary search through their longest lines.
+//    - Size: lines sorted by length and circles by radius, swept into
+//      equal classes the same way.
+//    - Tangency: circles and arcs hashed by bounding box; each line or
+//      arc end looks up the curves passing through it.
+//
+//  Ends meeting at an arc end are hashed the same way as solver points
+//  but only counted: arc ends have no solver parameters, so they
+//  cannot be made coincident.
+//
+//  The ranked candidates are then fed to NativeSolver::addIfIndependent(),
+//  which keeps the rows of J in an echelon basis and rejects any
+//  candidate whose rows it already spans.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/sketch/auto_constrain.h>
+#include <hobbycad/sketch/native_solver.h>
+#include <hobbycad/geometry/utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace hobbycad {
+namespace sketch {
+
+using namespace geometry;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// A circle whose bounding box covers more grid cells than this is
+// checked against every end instead of being hashed
+constexpr long long kMaxCircleCells = 256;
+
+/// Collisions only cost a few extra comparisons
+std::int64_t cellKey(long long a, long long b)
+{
+    return static_cast<std::int64_t>(a) * 73856093LL ^
+           static_cast<std::int64_t>(b) * 19349663LL;
+}
+
+long long cellOf(double v, double cell)
+{
+    return static_cast<long long>(std::floor(v / cell));
+}
+
+struct DisjointSets {
+    std::vector<size_t> parent;
+
+    explicit DisjointSets(size_t n) : parent(n) { std::iota(parent.begin(), parent.end(), 0); }
+
+    size_t find(size_t i)
+    {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+
+    bool unite(size_t a, size_t b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        parent[std::max(a, b)] = std::min(a, b);
+        return true;
+    }
+};
+
+// =====================================================================
+//  Candidates
+// =====================================================================
+
+/// Ranks, best first: topology, then orientation, then sizes
+enum CandidateRank {
+    kRankCoincident,
+    kRankConcentric,
+    kRankOrientation,
+    kRankTangent,
+    kRankPerpendicular,
+    kRankParallel,
+    kRankEqual
+};
+
+struct Candidate {
+    ConstraintType type = ConstraintType::Coincident;
+    int rank = kRankCoincident;
+    double score = 0.0;     ///< Mismatch divided by its tolerance
+    size_t entityA = 0;
+    int pointA = 0;
+    long entityB = -1;      ///< -1 for single-entity constraints
+    int pointB = 0;
+};
+
+struct SolverPoint {
+    size_t entity;
+    int index;
+    Point2D position;
+    bool center;
+};
+
+struct LineInfo {
+    size_t entity;
+    Point2D start, end;
+    Point2D direction;      ///< Unit
+    double length;
+    double angle;           ///< Direction in [−angleTolerance, π − angleTolerance)
+};
+
+struct CircleInfo {
+    size_t entity;
+    Point2D center;
+    double radius;
+    bool arc;
+    double start = 0.0;     ///< Arc start (radians)
+    double sweep = 0.0;     ///< Arc sweep, positive (radians)
+};
+
+/// True if p, which lies on the circle, is on the arc's span
+bool onSpan(const CircleInfo& c, const Point2D& p, double tolerance)
+{
+    if (!c.arc) return true;
+    double slack = tolerance / std::max(c.radius, tolerance);
+    double a = std::atan2(p.y - c.center.y, p.x - c.center.x) - c.start;
+    a = std::fmod(a, 2.0 * kPi);
+    if (a < 0.0) a += 2.0 * kPi;
+    return a <= c.sweep + slack || a >= 2.0 * kPi - slack;
+}
+
+// =====================================================================
+//  Coincidence
+// =====================================================================
+
+void findCoincidences(const std::vector<SolverPoint>& points, const AutoConstrainOptions& options,
+                      std::vector<Candidate>& out)
+{
+    const double tol = options.tolerance;
+    DisjointSets clusters(points.size());
+    std::unordered_map<std::int64_t, std::vector<size_t>> grid;
+
+    for (size_t k = 0; k < points.size(); ++k) {
+        const SolverPoint& p = points[k];
+        long long cx = cellOf(p.position.x, tol);
+        long long cy = cellOf(p.position.y, tol);
+
+        // Nearest earlier point in each other cluster
+        std::vector<std::pair<double, size_t>> near;
+        for (long long dx = -1; dx <= 1; ++dx) {
+            for (long long dy = -1; dy <= 1; ++dy) {
+                auto it = grid.find(cellKey(cx + dx, cy + dy));
+                if (it == grid.end()) continue;
+                for (size_t j : it->second) {
+                    const SolverPoint& q = points[j];
+                    if (q.entity == p.entity) continue;
+                    if (p.center && q.center ? !options.concentric : !options.coincident) continue;
+                    double d = length(p.position - q.position);
+                    if (d <= tol) near.emplace_back(d, j);
+                }
+            }
+        }
+        std::sort(near.begin(), near.end());
+        for (const auto& [d, j] : near) {
+            if (!clusters.unite(j, k)) continue;
+            const SolverPoint& q = points[j];
+            Candidate c;
+            c.type = ConstraintType::Coincident;
+            c.rank = p.center && q.center ? kRankConcentric : kRankCoincident;
+            c.score = d / tol;
+            c.entityA = q.entity;
+            c.pointA = q.index;
+            c.entityB = static_cast<long>(p.entity);
+            c.pointB = p.index;
+            out.push_back(c);
+        }
+        grid[cellKey(cx, cy)].push_back(k);
+    }
+}
+
+// =====================================================================
+//  Direction
+// =====================================================================
+
+void findDirections(const std::vector<LineInfo>& lines, const AutoConstrainOptions& options,
+                    std::vector<Candidate>& out)
+{
+    const double tol = options.angleTolerance;
+
+    if (options.horizontalVertical) {
+        for (size_t k = 0; k < lines.size(); ++k) {
+            const LineInfo& l = lines[k];
+            double horizontal = std::abs(l.angle);
+            double vertical = std::abs(l.angle - kPi / 2.0);
+            if (horizontal > tol && vertical > tol) continue;
+            Candidate c;
+            c.type = horizontal <= tol ? ConstraintType::Horizontal : ConstraintType::Vertical;
+            c.rank = kRankOrientation;
+            c.score = std::min(horizontal, vertical) / tol;
+            c.entityA = l.entity;
+            out.push_back(c);
+        }
+    }
+    if (!options.parallel && !options.perpendicular) return;
+
+    // Classes of lines within tol of the class's first direction
+    std::vector<size_t> order(lines.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return lines[a].angle < lines[b].angle;
+    });
+
+    struct DirectionClass {
+        double first;       ///< Smallest direction in the class
+        size_t anchor;      ///< Longest line
+    };
+    std::vector<DirectionClass> classes;
+    for (size_t begin = 0; begin < order.size();) {
+        size_t end = begin;
+        size_t anchor = order[begin];
+        while (end < order.size() && lines[order[end]].angle - lines[order[begin]].angle <= tol) {
+            if (lines[order[end]].length > lines[anchor].length) anchor = order[end];
+            ++end;
+        }
+        if (options.parallel) {
+            for (size_t k = begin + 1; k < end; ++k) {
+                Candidate c;
+                c.type = ConstraintType::Parallel;
+                c.rank = kRankParallel;
+                c.score = (lines[order[k]].angle - lines[order[k - 1]].angle) / tol;
+                c.entityA = lines[order[k - 1]].entity;
+                c.entityB = static_cast<long>(lines[order[k]].entity);
+                out.push_back(c);
+            }
+        }
+        classes.push_back({lines[order[begin]].angle, anchor});
+        begin = end;
+    }
+    if (!options.perpendicular) return;
+
+    // Pair classes at right angles; directions wrap at half a turn
+    for (size_t i = 0; i < classes.size(); ++i) {
+        double alpha = lines[classes[i].anchor].angle;
+        for (double shift : {-kPi, 0.0, kPi}) {
+            double beta = alpha + kPi / 2.0 + shift;
+            auto it = std::lower_bound(classes.begin(), classes.end(), beta - 2.0 * tol,
+                                       [](const DirectionClass& c, double v) { return c.first < v; });
+            for (; it != classes.end() && it->first <= beta + tol; ++it) {
+                size_t j = static_cast<size_t>(it - classes.begin());
+                if (j <= i) continue;
+                double mismatch = std::abs(lines[it->anchor].angle - beta);
+                if (mismatch > tol) continue;
+                Candidate c;
+                c.type = ConstraintType::Perpendicular;
+                c.rank = kRankPerpendicular;
+                c.score = mismatch / tol;
+                c.entityA = lines[classes[i].anchor].entity;
+                c.entityB = static_cast<long>(lines[it->anchor].entity);
+                out.push_back(c);
+            }
+        }
+    }
+}
+
+// =====================================================================
+//  Size
+// =====================================================================
+
+/// Equal candidates for items sorted by size.  Each class is linked as
+/// a chain of neighbours, not a star around one member, which keeps
+/// every entity in at most two rows and J·Jᵀ sparse.
+void findEqualSizes(std::vector<std::pair<double, size_t>> sizes, double tol,
+                    std::vector<Candidate>& out)
+{
+    std::sort(sizes.begin(), sizes.end());
+    for (size_t begin = 0; begin < sizes.size();) {
+        size_t end = begin + 1;
+        while (end < sizes.size() && sizes[end].first - sizes[begin].first <= tol) {
+            Candidate c;
+            c.type = ConstraintType::Equal;
+            c.rank = kRankEqual;
+            c.score = (sizes[end].first - sizes[end - 1].first) / tol;
+            c.entityA = sizes[end - 1].second;
+            c.entityB = static_cast<long>(sizes[end].second);
+            out.push_back(c);
+            ++end;
+        }
+        begin = end;
+    }
+}
+
+// =====================================================================
+//  Tangency
+// =====================================================================
+
+void findTangencies(const std::vector<LineInfo>& lines, const std::vector<CircleInfo>& circles,
+                    const std::vector<Entity>& entities, const AutoConstrainOptions& options,
+                    std::vector<Candidate>& out)
+{
+    if (circles.empty()) return;
+    const double tol = options.tolerance;
+
+    // Cell size from the median diameter keeps a typical circle in a
+    // few cells
+    std::vector<double> diameters;
+    for (const CircleInfo& c : circles) diameters.push_back(2.0 * c.radius);
+    std::nth_element(diameters.begin(), diameters.begin() + diameters.size() / 2, diameters.end());
+    const double cell = std::max(diameters[diameters.size() / 2], 4.0 * tol);
+
+    std::unordered_map<std::int64_t, std::vector<size_t>> grid;
+    std::vector<size_t> large;
+    for (size_t k = 0; k < circles.size(); ++k) {
+        const CircleInfo& c = circles[k];
+        double reach = c.radius + tol;
+        long long x0 = cellOf(c.center.x - reach, cell), x1 = cellOf(c.center.x + reach, cell);
+        long long y0 = cellOf(c.center.y - reach, cell), y1 = cellOf(c.center.y + reach, cell);
+        if ((x1 - x0 + 1) * (y1 - y0 + 1) > kMaxCircleCells) {
+            large.push_back(k);
+            continue;
+        }
+        for (long long x = x0; x <= x1; ++x) {
+            for (long long y = y0; y <= y1; ++y) grid[cellKey(x, y)].push_back(k);
+        }
+    }
+
+    // Curves passing through p
+    std::vector<size_t> through;
+    auto lookup = [&](const Point2D& p) {
+        through.clear();
+        auto visit = [&](size_t k) {
+            const CircleInfo& c = circles[k];
+            if (std::abs(length(p - c.center) - c.radius) <= tol && onSpan(c, p, tol)) {
+                through.push_back(k);
+            }
+        };
+        auto it = grid.find(cellKey(cellOf(p.x, cell), cellOf(p.y, cell)));
+        if (it != grid.end()) {
+            for (size_t k : it->second) visit(k);
+        }
+        for (size_t k : large) visit(k);
+    };
+
+    std::set<std::pair<size_t, size_t>> seen;
+    auto add = [&](size_t a, size_t b, double mismatch) {
+        if (!seen.insert({std::min(a, b), std::max(a, b)}).second) return;
+        Candidate c;
+        c.type = ConstraintType::Tangent;
+        c.rank = kRankTangent;
+        c.score = mismatch / tol;
+        c.entityA = a;
+        c.entityB = static_cast<long>(b);
+        out.push_back(c);
+    };
+
+    // Line ends: the center lies one radius from the line
+    for (const LineInfo& l : lines) {
+        for (const Point2D& p : {l.start, l.end}) {
+            lookup(p);
+            for (size_t k : through) {
+                const CircleInfo& c = circles[k];
+                double offset = std::abs(cross(l.direction, c.center - l.start));
+                double mismatch = std::abs(offset - c.radius);
+                if (mismatch <= tol) add(l.entity, c.entity, mismatch);
+            }
+        }
+    }
+
+    // Arc ends: the centers and the shared point are collinear
+    for (const CircleInfo& a : circles) {
+        if (!a.arc) continue;
+        for (const Point2D& p : entities[a.entity].endpoints()) {
+            lookup(p);
+            for (size_t k : through) {
+                const CircleInfo& c = circles[k];
+                if (c.entity == a.entity) continue;
+                double d = length(a.center - c.center);
+                if (d <= tol) continue;
+                double mismatch = std::min(std::abs(d - (a.radius + c.radius)),
+                                           std::abs(d - std::abs(a.radius - c.radius)));
+                if (mismatch <= tol) add(a.entity, c.entity, mismatch);
+            }
+        }
+    }
+}
+
+// =====================================================================
+//  Arc Joins
+// =====================================================================
+
+/// Pairs of ends that meet at an arc end.  The solvers have no arc end
+/// parameters, so these cannot become Coincident candidates.
+int countArcJoins(const std::vector<SolverPoint>& points, const std::vector<CircleInfo>& circles,
+                  const std::vector<Entity>& entities, double tol)
+{
+    std::vector<std::pair<size_t, Point2D>> arcEnds;
+    for (const CircleInfo& c : circles) {
+        if (!c.arc) continue;
+        for (const Point2D& p : entities[c.entity].endpoints()) arcEnds.emplace_back(c.entity, p);
+    }
+    if (arcEnds.empty()) return 0;
+
+    std::unordered_map<std::int64_t, std::vector<size_t>> grid;
+    auto meetings = [&](size_t entity, const Point2D& p) {
+        int count = 0;
+        long long cx = cellOf(p.x, tol), cy = cellOf(p.y, tol);
+        for (long long dx = -1; dx <= 1; ++dx) {
+            for (long long dy = -1; dy <= 1; ++dy) {
+                auto it = grid.find(cellKey(cx + dx, cy + dy));
+                if (it == grid.end()) continue;
+                for (size_t j : it->second) {
+                    if (arcEnds[j].first != entity && length(arcEnds[j].second - p) <= tol) ++count;
+                }
+            }
+        }
+        return count;
+    };
+
+    // Arc ends against earlier arc ends, then line ends against all
+    int joins = 0;
+    for (size_t k = 0; k < arcEnds.size(); ++k) {
+        joins += meetings(arcEnds[k].first, arcEnds[k].second);
+        const Point2D& p = arcEnds[k].second;
+        grid[cellKey(cellOf(p.x, tol), cellOf(p.y, tol))].push_back(k);
+    }
+    for (const SolverPoint& p : points) {
+        if (entities[p.entity].type != EntityType::Line) continue;
+        joins += meetings(p.entity, p.position);
+    }
+    return joins;
+}
+
+Constraint toConstraint(const Candidate& candidate, const std::vector<Entity>& entities)
+{
+    Constraint c;
+    c.type = candidate.type;
+    c.entityIds.push_back(entities[candidate.entityA].id);
+    if (candidate.entityB >= 0) {
+        c.entityIds.push_back(entities[static_cast<size_t>(candidate.entityB)].id);
+    }
+    if (candidate.type == ConstraintType::Coincident) {
+        c.pointIndices = {candidate.pointA, candidate.pointB};
+    }
+    return c;
+}
+
+}  // namespace
+
+// =====================================================================
+//  Inference
+// =====================================================================
+
+AutoConstrainResult inferConstraints(const std::vector<Entity>& entities,
+                                     const std::vector<Constraint>& existingConstraints,
+                                     const AutoConstrainOptions& options)
+{
+    AutoConstrainResult result;
+    if (!(options.tolerance > 0.0) || !(options.angleTolerance > 0.0)) {
+        result.errorMessage = "Tolerances must be positive";
+        return result;
+    }
+    const double tol = options.tolerance;
+    const double angleTol = options.angleTolerance;
+
+    // Gather what the solver models
+    std::vector<SolverPoint> points;
+    std::vector<LineInfo> lines;
+    std::vector<CircleInfo> circles;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        const Entity& e = entities[i];
+        switch (e.type) {
+        case EntityType::Point:
+            if (e.points.empty()) break;
+            points.push_back({i, 0, e.points[0], false});
+            break;
+        case EntityType::Line: {
+            if (e.points.size() < 2) break;
+            points.push_back({i, 0, e.points[0], false});
+            points.push_back({i, 1, e.points[1], false});
+            Point2D v = e.points[1] - e.points[0];
+            double len = length(v);
+            if (len <= tol) break;
+            double angle = std::atan2(v.y, v.x);
+            if (angle < 0.0) angle += kPi;
+            if (angle >= kPi - angleTol) angle -= kPi;
+            lines.push_back({i, e.points[0], e.points[1], v / len, len, angle});
+            break;
+        }
+        case EntityType::Circle:
+        case EntityType::Arc: {
+            if (e.points.empty() || e.radius <= tol) break;
+            points.push_back({i, 0, e.points[0], true});
+            CircleInfo c{i, e.points[0], e.radius, e.type == EntityType::Arc};
+            if (c.arc) {
+                double start = e.startAngle, sweep = e.sweepAngle;
+                if (sweep < 0.0) {
+                    start += sweep;
+                    sweep = -sweep;
+                }
+                c.start = start * kPi / 180.0;
+                c.sweep = std::min(sweep, 360.0) * kPi / 180.0;
+            }
+            circles.push_back(c);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    std::vector<Candidate> candidates;
+    if (options.coincident || options.concentric) findCoincidences(points, options, candidates);
+    findDirections(lines, options, candidates);
+    if (options.equal) {
+        std::vector<std::pair<double, size_t>> lengths, radii;
+        for (const LineInfo& l : lines) lengths.emplace_back(l.length, l.entity);
+        for (const CircleInfo& c : circles) radii.emplace_back(c.radius, c.entity);
+        findEqualSizes(std::move(lengths), tol, candidates);
+        findEqualSizes(std::move(radii), tol, candidates);
+    }
+    if (options.tangent) findTangencies(lines, circles, entities, options, candidates);
+    if (options.coincident) result.unheldJoins = countArcJoins(points, circles, entities, tol);
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return std::tie(a.rank, a.score, a.entityA, a.entityB, a.pointA, a.pointB) <
+               std::tie(b.rank, b.score, b.entityA, b.entityB, b.pointA, b.pointB);
+    });
+    result.candidates = static_cast<int>(candidates.size());
+
+    // Keep the candidates that raise the rank of the system
+    NativeSolver solver;
+    solver.build(entities, existingConstraints);
+
+    int nextId = 1;
+    for (const Constraint& c : existingConstraints) nextId = std::max(nextId, c.id + 1);
+
+    for (const Candidate& candidate : candidates) {
+        Constraint c = toConstraint(candidate, entities);
+        c.id = nextId;
+        if (!solver.addIfIndependent(c)) {
+            ++result.redundant;
+            continue;
+        }
+        result.constraints.push_back(std::move(c));
+        ++nextId;
+    }
+
+    result.dof = solver.degreesOfFreedom();
+    result.success = true;
+    return result;
+}
+
+}  // namespace sketch
+}  // namespace hobbycad
@@ -8,6 +8,8 @@
 // =====================================================================
 
 #include <hobbycad/sketch/background.h>
+#include <hobbycad/base64.h>
+#include <hobbycad/json_stream.h>
 
 #include <algorithm>
 #include <cmath>
@@ -24,14 +26,10 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QImageReader>
-#include <QJsonDocument>
-#include <QJsonObject>
 #else
 #if HOBBYCAD_HAS_STB_IMAGE
 #include <hobbycad/image_buffer.h>
 #endif
-#include <hobbycad/base64.h>
-#include <nlohmann/json.hpp>
 #endif
 
 #ifndef M_PI
@@ -859,186 +857,89 @@ BackgroundImage updateBackgroundFromFile(
 //  Serialization
 // =====================================================================
 
-#if HOBBYCAD_HAS_QT
-
-std::string backgroundToJson(
-    const BackgroundImage& background,
-    bool includeImageData)
-{
-    QJsonObject obj;
-
-    obj["enabled"] = background.enabled;
-    obj["storage"] = static_cast<int>(background.storage);
-    obj["filePath"] = QString::fromStdString(background.filePath);
-    obj["mimeType"] = QString::fromStdString(background.mimeType);
-
-    obj["positionX"] = background.position.x;
-    obj["positionY"] = background.position.y;
-    obj["width"] = background.width;
-    obj["height"] = background.height;
-    obj["rotation"] = background.rotation;
-
-    obj["opacity"] = background.opacity;
-    obj["lockAspectRatio"] = background.lockAspectRatio;
-    obj["flipHorizontal"] = background.flipHorizontal;
-    obj["flipVertical"] = background.flipVertical;
-    obj["grayscale"] = background.grayscale;
-    obj["contrast"] = background.contrast;
-    obj["brightness"] = background.brightness;
-
-    obj["calibrated"] = background.calibrated;
-    obj["calibrationScale"] = background.calibrationScale;
-
-    obj["originalPixelWidth"] = background.originalPixelWidth;
-    obj["originalPixelHeight"] = background.originalPixelHeight;
-
-    if (includeImageData && background.storage == BackgroundStorage::Embedded) {
-        QByteArray qData(reinterpret_cast<const char*>(background.imageData.data()),
-                         static_cast<int>(background.imageData.size()));
-        obj["imageData"] = QString::fromLatin1(qData.toBase64());
-    }
-
-    QJsonDocument doc(obj);
-    return doc.toJson(QJsonDocument::Compact).toStdString();
-}
-
-BackgroundImage backgroundFromJson(const std::string& json)
-{
-    BackgroundImage bg;
-
-    QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromStdString(json));
-    if (!doc.isObject()) {
-        return bg;
-    }
-
-    QJsonObject obj = doc.object();
-
-    bg.enabled = obj["enabled"].toBool(false);
-    bg.storage = static_cast<BackgroundStorage>(obj["storage"].toInt(0));
-    bg.filePath = obj["filePath"].toString().toStdString();
-    bg.mimeType = obj["mimeType"].toString().toStdString();
-
-    bg.position = Point2D(obj["positionX"].toDouble(0),
-                          obj["positionY"].toDouble(0));
-    bg.width = obj["width"].toDouble(100);
-    bg.height = obj["height"].toDouble(100);
-    bg.rotation = obj["rotation"].toDouble(0);
-
-    bg.opacity = obj["opacity"].toDouble(0.5);
-    bg.lockAspectRatio = obj["lockAspectRatio"].toBool(true);
-    bg.flipHorizontal = obj["flipHorizontal"].toBool(false);
-    bg.flipVertical = obj["flipVertical"].toBool(false);
-    bg.grayscale = obj["grayscale"].toBool(false);
-    bg.contrast = obj["contrast"].toDouble(1.0);
-    bg.brightness = obj["brightness"].toDouble(0.0);
-
-    bg.calibrated = obj["calibrated"].toBool(false);
-    bg.calibrationScale = obj["calibrationScale"].toDouble(1.0);
-
-    bg.originalPixelWidth = obj["originalPixelWidth"].toInt(0);
-    bg.originalPixelHeight = obj["originalPixelHeight"].toInt(0);
-
-    if (obj.contains("imageData")) {
-        QByteArray decoded = QByteArray::fromBase64(
-            obj["imageData"].toString().toLatin1());
-        bg.imageData.assign(
-            reinterpret_cast<const uint8_t*>(decoded.constData()),
-            reinterpret_cast<const uint8_t*>(decoded.constData()) + decoded.size());
-    }
-
-    return bg;
-}
-
-#else  // !HOBBYCAD_HAS_QT — nlohmann/json path
-
 std::string backgroundToJson(
     const BackgroundImage& background,
     bool includeImageData)
 {
-    nlohmann::json obj;
-
-    obj["enabled"]   = background.enabled;
-    obj["storage"]   = static_cast<int>(background.storage);
-    obj["filePath"]  = background.filePath;
-    obj["mimeType"]  = background.mimeType;
-
-    obj["positionX"] = background.position.x;
-    obj["positionY"] = background.position.y;
-    obj["width"]     = background.width;
-    obj["height"]    = background.height;
-    obj["rotation"]  = background.rotation;
-
-    obj["opacity"]          = background.opacity;
-    obj["lockAspectRatio"]  = background.lockAspectRatio;
-    obj["flipHorizontal"]   = background.flipHorizontal;
-    obj["flipVertical"]     = background.flipVertical;
-    obj["grayscale"]        = background.grayscale;
-    obj["contrast"]         = background.contrast;
-    obj["brightness"]       = background.brightness;
-
-    obj["calibrated"]       = background.calibrated;
-    obj["calibrationScale"] = background.calibrationScale;
-
-    obj["originalPixelWidth"]  = background.originalPixelWidth;
-    obj["originalPixelHeight"] = background.originalPixelHeight;
+    JsonWriter w(0);
+    w.beginObject();
+
+    w.field("enabled", background.enabled);
+    w.field("storage", static_cast<int>(background.storage));
+    w.field("filePath", background.filePath);
+    w.field("mimeType", background.mimeType);
+
+    w.field("positionX", background.position.x);
+    w.field("positionY", background.position.y);
+    w.field("width", background.width);
+    w.field("height", background.height);
+    w.field("rotation", background.rotation);
+
+    w.field("opacity", background.opacity);
+    w.field("lockAspectRatio", background.lockAspectRatio);
+    w.field("flipHorizontal", background.flipHorizontal);
+    w.field("flipVertical", background.flipVertical);
+    w.field("grayscale", background.grayscale);
+    w.field("contrast", background.contrast);
+    w.field("brightness", background.brightness);
+
+    w.field("calibrated", background.calibrated);
+    w.field("calibrationScale", background.calibrationScale);
+
+    w.field("originalPixelWidth", background.originalPixelWidth);
+    w.field("originalPixelHeight", background.originalPixelHeight);
 
     if (includeImageData && background.storage == BackgroundStorage::Embedded &&
         !background.imageData.empty()) {
-        obj["imageData"] = hobbycad::base64Encode(background.imageData);
+        w.field("imageData", hobbycad::base64Encode(background.imageData));
     }
 
-    return obj.dump();
+    w.endObject();
+    return w.take();
 }
 
 BackgroundImage backgroundFromJson(const std::string& json)
 {
     BackgroundImage bg;
 
-    nlohmann::json obj;
-    try {
-        obj = nlohmann::json::parse(json);
-    } catch (...) {
+    JsonReader r(json);
+    if (!r.beginObject()) {
         return bg;
     }
 
-    if (!obj.is_object()) {
-        return bg;
+    std::string key;
+    while (r.nextKey(key)) {
+        if (key == "enabled")                  bg.enabled = r.readBool(false);
+        else if (key == "storage")             bg.storage = static_cast<BackgroundStorage>(r.readInt(0));
+        else if (key == "filePath")            bg.filePath = r.readString();
+        else if (key == "mimeType")            bg.mimeType = r.readString();
+        else if (key == "positionX")           bg.position.x = r.readDouble(0);
+        else if (key == "positionY")           bg.position.y = r.readDouble(0);
+        else if (key == "width")               bg.width = r.readDouble(100);
+        else if (key == "height")              bg.height = r.readDouble(100);
+        else if (key == "rotation")            bg.rotation = r.readDouble(0);
+        else if (key == "opacity")             bg.opacity = r.readDouble(0.5);
+        else if (key == "lockAspectRatio")     bg.lockAspectRatio = r.readBool(true);
+        else if (key == "flipHorizontal")      bg.flipHorizontal = r.readBool(false);
+        else if (key == "flipVertical")        bg.flipVertical = r.readBool(false);
+        else if (key == "grayscale")           bg.grayscale = r.readBool(false);
+        else if (key == "contrast")            bg.contrast = r.readDouble(1.0);
+        else if (key == "brightness")          bg.brightness = r.readDouble(0.0);
+        else if (key == "calibrated")          bg.calibrated = r.readBool(false);
+        else if (key == "calibrationScale")    bg.calibrationScale = r.readDouble(1.0);
+        else if (key == "originalPixelWidth")  bg.originalPixelWidth = r.readInt(0);
+        else if (key == "originalPixelHeight") bg.originalPixelHeight = r.readInt(0);
+        else if (key == "imageData")           bg.imageData = hobbycad::base64Decode(r.readString());
+        else r.skipValue();
+    }
+
+    // Malformed input yields defaults, as a failed parse always has
+    if (!r.atEnd()) {
+        return BackgroundImage();
     }
-
-    bg.enabled  = obj.value("enabled", false);
-    bg.storage  = static_cast<BackgroundStorage>(obj.value("storage", 0));
-    bg.filePath = obj.value("filePath", std::string{});
-    bg.mimeType = obj.value("mimeType", std::string{});
-
-    bg.position = Point2D(obj.value("positionX", 0.0),
-                          obj.value("positionY", 0.0));
-    bg.width    = obj.value("width", 100.0);
-    bg.height   = obj.value("height", 100.0);
-    bg.rotation = obj.value("rotation", 0.0);
-
-    bg.opacity         = obj.value("opacity", 0.5);
-    bg.lockAspectRatio = obj.value("lockAspectRatio", true);
-    bg.flipHorizontal  = obj.value("flipHorizontal", false);
-    bg.flipVertical    = obj.value("flipVertical", false);
-    bg.grayscale       = obj.value("grayscale", false);
-    bg.contrast        = obj.value("contrast", 1.0);
-    bg.brightness      = obj.value("brightness", 0.0);
-
-    bg.calibrated       = obj.value("calibrated", false);
-    bg.calibrationScale = obj.value("calibrationScale", 1.0);
-
-    bg.originalPixelWidth  = obj.value("originalPixelWidth", 0);
-    bg.originalPixelHeight = obj.value("originalPixelHeight", 0);
-
-    if (obj.contains("imageData") && obj["imageData"].is_string()) {
-        bg.imageData = hobbycad::base64Decode(obj["imageData"].get<std::string>());
-    }
-
     return bg;
 }
 
-#endif  // HOBBYCAD_HAS_QT
-
 // =====================================================================
 //  Supported Formats
 // =====================================================================
@@ -0,0 +1,1151 @@
+// =====================================================================
+//  src/libhobbycad/sketch/chain_offset.cpp — Chain offset
+// =====================================================================
+//
+//  Offsets a connected chain of sketch entities as one curve.  The
+//  chain is ordered into a path of line and arc pieces (splines and
+//  ellipses are flattened to lines first), each piece is offset
+//  exactly, and convex corners are closed with round or miter joins.
+//  The raw offset is then cut wherever it crosses itself, using a
+//  sweep over the piece bounds; cut pieces that come closer to the
+//  source path than the offset distance are dropped, and the rest are
+//  stitched back into chains of lines and arcs.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/sketch/operations.h>
+#include <hobbycad/geometry/intersections.h>
+#include <hobbycad/geometry/spline.h>
+#include <hobbycad/geometry/utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace hobbycad {
+namespace sketch {
+
+using namespace geometry;
+
+namespace {
+
+constexpr double kTwoPi = 2.0 * M_PI;
+constexpr double kParamEps = 1e-9;
+
+// =====================================================================
+//  Pieces
+// =====================================================================
+
+/// A line or circular arc of a path, directed from a to b
+struct Piece {
+    bool arc = false;
+    Point2D a;
+    Point2D b;
+    Point2D center;
+    double radius = 0.0;
+    double start = 0.0;         ///< Arc start angle (radians)
+    double sweep = 0.0;         ///< Arc sweep (radians, positive = CCW)
+    bool smooth = false;        ///< Tangent to the next piece (flattened curve)
+};
+
+Point2D polar(const Point2D& center, double radius, double angle)
+{
+    return Point2D(center.x + radius * std::cos(angle), center.y + radius * std::sin(angle));
+}
+
+Piece makeLine(const Point2D& a, const Point2D& b)
+{
+    Piece p;
+    p.a = a;
+    p.b = b;
+    return p;
+}
+
+Piece makeArc(const Point2D& center, double radius, double start, double sweep)
+{
+    Piece p;
+    p.arc = true;
+    p.center = center;
+    p.radius = radius;
+    p.start = start;
+    p.sweep = sweep;
+    p.a = polar(center, radius, start);
+    p.b = polar(center, radius, start + sweep);
+    return p;
+}
+
+Point2D pointAt(const Piece& p, double u)
+{
+    if (!p.arc) return p.a + (p.b - p.a) * u;
+    return polar(p.center, p.radius, p.start + p.sweep * u);
+}
+
+Point2D arcTangent(const Piece& p, double angle)
+{
+    double s = p.sweep < 0 ? -1.0 : 1.0;
+    return Point2D(-std::sin(angle) * s, std::cos(angle) * s);
+}
+
+Point2D startTangent(const Piece& p)
+{
+    return p.arc ? arcTangent(p, p.start) : normalize(p.b - p.a);
+}
+
+Point2D endTangent(const Piece& p)
+{
+    return p.arc ? arcTangent(p, p.start + p.sweep) : normalize(p.b - p.a);
+}
+
+Piece reversed(const Piece& p)
+{
+    Piece r = p;
+    std::swap(r.a, r.b);
+    if (p.arc) {
+        r.start = p.start + p.sweep;
+        r.sweep = -p.sweep;
+    }
+    return r;
+}
+
+/// Position of a point's angle along an arc: 0 at the start, 1 at the
+/// end.  Angles just before the start come out slightly negative.
+double arcParameter(const Piece& p, const Point2D& pt)
+{
+    double span = std::abs(p.sweep);
+    double delta = std::atan2(pt.y - p.center.y, pt.x - p.center.x) - p.start;
+    if (p.sweep < 0) delta = -delta;
+    delta = std::fmod(delta, kTwoPi);
+    if (delta < 0) delta += kTwoPi;
+    if (delta > span && delta > 0.5 * (span + kTwoPi)) delta -= kTwoPi;
+    return delta / span;
+}
+
+/// Part of a piece between two parameters, with its end points given
+/// exactly so that neighbouring parts meet bit for bit
+Piece subPiece(const Piece& p, double u0, double u1, const Point2D& a, const Point2D& b)
+{
+    Piece s = p;
+    s.a = a;
+    s.b = b;
+    if (p.arc) {
+        s.start = p.start + p.sweep * u0;
+        s.sweep = p.sweep * (u1 - u0);
+    }
+    return s;
+}
+
+BoundingBox pieceBounds(const Piece& p)
+{
+    BoundingBox box;
+    box.include(p.a);
+    box.include(p.b);
+    if (p.arc) {
+        for (int k = 0; k < 4; ++k) {
+            Point2D extreme = polar(p.center, p.radius, k * M_PI / 2.0);
+            double u = arcParameter(p, extreme);
+            if (u >= 0.0 && u <= 1.0) box.include(extreme);
+        }
+    }
+    return box;
+}
+
+double pieceLength(const Piece& p)
+{
+    return p.arc ? p.radius * std::abs(p.sweep) : length(p.b - p.a);
+}
+
+double distanceToPiece(const Piece& p, const Point2D& pt)
+{
+    if (!p.arc) {
+        Point2D d = p.b - p.a;
+        double len2 = lengthSquared(d);
+        double t = len2 > 0.0 ? std::clamp(dot(pt - p.a, d) / len2, 0.0, 1.0) : 0.0;
+        return length(pt - (p.a + d * t));
+    }
+    double u = arcParameter(p, pt);
+    if (u >= 0.0 && u <= 1.0) return std::abs(length(pt - p.center) - p.radius);
+    return std::min(length(pt - p.a), length(pt - p.b));
+}
+
+/// Point on a piece closest to pt, with the piece's direction there
+Point2D closestOnPiece(const Piece& p, const Point2D& pt, Point2D* tangent)
+{
+    if (!p.arc) {
+        Point2D d = p.b - p.a;
+        double len2 = lengthSquared(d);
+        double t = len2 > 0.0 ? std::clamp(dot(pt - p.a, d) / len2, 0.0, 1.0) : 0.0;
+        *tangent = normalize(d);
+        return p.a + d * t;
+    }
+    double u = std::clamp(arcParameter(p, pt), 0.0, 1.0);
+    double angle = p.start + p.sweep * u;
+    *tangent = arcTangent(p, angle);
+    return polar(p.center, p.radius, angle);
+}
+
+/// Offset a piece to its right by d (negative d offsets to the left).
+/// An arc offset past its center turns inside out: the raw offset
+/// stays continuous, and the whole of it lies in the invalid region.
+Piece offsetPiece(const Piece& p, double d)
+{
+    Piece out;
+    if (!p.arc) {
+        Point2D n = perpendicularCW(normalize(p.b - p.a)) * d;
+        out = makeLine(p.a + n, p.b + n);
+    } else {
+        // The right of a CCW arc is outside it
+        double r = p.radius + (p.sweep > 0 ? d : -d);
+        if (r >= 0.0) out = makeArc(p.center, r, p.start, p.sweep);
+        else out = makeArc(p.center, -r, p.start + M_PI, p.sweep);
+    }
+    out.smooth = p.smooth;
+    return out;
+}
+
+// =====================================================================
+//  Piece Intersections
+// =====================================================================
+
+struct Crossing {
+    double u1 = 0.0;
+    double u2 = 0.0;
+    Point2D point;
+};
+
+bool inUnitRange(double u)
+{
+    return u >= -kParamEps && u <= 1.0 + kParamEps;
+}
+
+void addCrossing(double u1, double u2, const Point2D& point, std::vector<Crossing>& out)
+{
+    if (inUnitRange(u1) && inUnitRange(u2)) {
+        out.push_back({std::clamp(u1, 0.0, 1.0), std::clamp(u2, 0.0, 1.0), point});
+    }
+}
+
+void intersectLineArc(const Piece& line, const Piece& arc, bool swapped, std::vector<Crossing>& out)
+{
+    Point2D r = line.b - line.a;
+    Point2D f = line.a - arc.center;
+    double A = dot(r, r);
+    double B = 2.0 * dot(f, r);
+    double C = dot(f, f) - arc.radius * arc.radius;
+    if (A <= 0.0) return;
+
+    double disc = B * B - 4.0 * A * C;
+    if (disc < 0.0) {
+        // Grazing contact within rounding
+        if (disc < -1e-12 * B * B) return;
+        disc = 0.0;
+    }
+    double sq = std::sqrt(disc);
+    double roots[2] = {(-B - sq) / (2.0 * A), (-B + sq) / (2.0 * A)};
+    int count = sq > 0.0 ? 2 : 1;
+    for (int i = 0; i < count; ++i) {
+        Point2D pt = line.a + r * roots[i];
+        double u = arcParameter(arc, pt);
+        if (swapped) addCrossing(u, roots[i], pt, out);
+        else addCrossing(roots[i], u, pt, out);
+    }
+}
+
+void intersectPieces(const Piece& p, const Piece& q, std::vector<Crossing>& out)
+{
+    if (!p.arc && !q.arc) {
+        Point2D r = p.b - p.a;
+        Point2D s = q.b - q.a;
+        double denom = cross(r, s);
+        if (std::abs(denom) <= 1e-14 * length(r) * length(s)) return;  // Parallel
+        Point2D qp = q.a - p.a;
+        double t = cross(qp, s) / denom;
+        double u = cross(qp, r) / denom;
+        addCrossing(t, u, p.a + r * t, out);
+    } else if (!p.arc) {
+        intersectLineArc(p, q, false, out);
+    } else if (!q.arc) {
+        intersectLineArc(q, p, true, out);
+    } else {
+        CircleCircleIntersection cci = circleCircleIntersection(
+            p.center, p.radius, q.center, q.radius);
+        if (cci.coincident) return;
+        if (cci.count >= 1) addCrossing(arcParameter(p, cci.point1), arcParameter(q, cci.point1), cci.point1, out);
+        if (cci.count >= 2) addCrossing(arcParameter(p, cci.point2), arcParameter(q, cci.point2), cci.point2, out);
+    }
+}
+
+// =====================================================================
+//  Entities to Pieces
+// =====================================================================
+
+/// One entity as pieces in its own direction
+struct Unit {
+    std::vector<Piece> pieces;
+    bool closed = false;
+};
+
+void addPolyline(const std::vector<Point2D>& pts, bool smooth, std::vector<Piece>& out)
+{
+    for (size_t i = 1; i < pts.size(); ++i) {
+        if (length(pts[i] - pts[i - 1]) <= DEFAULT_TOLERANCE) continue;
+        Piece line = makeLine(pts[i - 1], pts[i]);
+        line.smooth = smooth;
+        out.push_back(line);
+    }
+    if (!out.empty()) out.back().smooth = false;
+}
+
+void addPolygon(const std::vector<Point2D>& corners, std::vector<Piece>& out)
+{
+    std::vector<Point2D> closed(corners);
+    closed.push_back(corners.front());
+    addPolyline(closed, false, out);
+}
+
+/// Convert an entity to pieces; false for entities without an outline
+bool entityUnit(const Entity& e, double tolerance, Unit& unit)
+{
+    std::vector<Piece>& pieces = unit.pieces;
+
+    switch (e.type) {
+    case EntityType::Line:
+        if (e.points.size() >= 2) addPolyline({e.points[0], e.points[1]}, false, pieces);
+        break;
+
+    case EntityType::Arc:
+        if (!e.points.empty() && e.radius > 0.0 && e.sweepAngle != 0.0) {
+            pieces.push_back(makeArc(e.points[0], e.radius,
+                                     e.startAngle * M_PI / 180.0, e.sweepAngle * M_PI / 180.0));
+        }
+        break;
+
+    case EntityType::Circle:
+        if (!e.points.empty() && e.radius > 0.0) {
+            pieces.push_back(makeArc(e.points[0], e.radius, 0.0, kTwoPi));
+            unit.closed = true;
+        }
+        break;
+
+    case EntityType::Rectangle:
+    case EntityType::Parallelogram:
+        if (e.points.size() >= 4) {
+            addPolygon({e.points[0], e.points[1], e.points[2], e.points[3]}, pieces);
+            unit.closed = true;
+        } else if (e.type == EntityType::Rectangle && e.points.size() >= 2) {
+            const Point2D& p1 = e.points[0];
+            const Point2D& p3 = e.points[1];
+            addPolygon({p1, Point2D(p3.x, p1.y), p3, Point2D(p1.x, p3.y)}, pieces);
+            unit.closed = true;
+        }
+        break;
+
+    case EntityType::Polygon:
+        if (!e.points.empty() && e.radius > 0.0) {
+            int sides = e.sides > 0 ? e.sides : 6;
+            std::vector<Point2D> corners;
+            for (int i = 0; i < sides; ++i) {
+                corners.push_back(polar(e.points[0], e.radius, i * kTwoPi / sides - M_PI / 2.0));
+            }
+            addPolygon(corners, pieces);
+            unit.closed = true;
+        }
+        break;
+
+    case EntityType::Slot:
+        if (e.points.size() >= 3 && e.radius > 0.0) {
+            // Arc slot: points[0] = arc center, points[1] = start, points[2] = end
+            Point2D c = e.points[0];
+            double arcRadius = length(e.points[1] - c);
+            double startAngle = std::atan2(e.points[1].y - c.y, e.points[1].x - c.x);
+            double endAngle = std::atan2(e.points[2].y - c.y, e.points[2].x - c.x);
+            double sweep = endAngle - startAngle;
+            while (sweep > M_PI) sweep -= kTwoPi;
+            while (sweep < -M_PI) sweep += kTwoPi;
+            if (e.arcFlipped) sweep = (sweep > 0) ? sweep - kTwoPi : sweep + kTwoPi;
+            double capDir = (sweep >= 0) ? 1.0 : -1.0;
+
+            pieces.push_back(makeArc(c, arcRadius + e.radius, startAngle, sweep));
+            pieces.push_back(makeArc(polar(c, arcRadius, endAngle), e.radius, endAngle, capDir * M_PI));
+            if (arcRadius - e.radius > DEFAULT_TOLERANCE) {
+                pieces.push_back(makeArc(c, arcRadius - e.radius, endAngle, -sweep));
+            }
+            pieces.push_back(makeArc(polar(c, arcRadius, startAngle), e.radius,
+                                     startAngle + M_PI, capDir * M_PI));
+            unit.closed = true;
+        } else if (e.points.size() >= 2 && e.radius > 0.0) {
+            // Linear slot: two lines and two semicircular ends
+            Point2D c1 = e.points[0];
+            Point2D c2 = e.points[1];
+            if (length(c2 - c1) <= DEFAULT_TOLERANCE) {
+                pieces.push_back(makeArc(c1, e.radius, 0.0, kTwoPi));
+            } else {
+                Point2D n = perpendicular(normalize(c2 - c1)) * e.radius;
+                double normalAngle = std::atan2(n.y, n.x);
+                pieces.push_back(makeLine(c1 + n, c2 + n));
+                pieces.push_back(makeArc(c2, e.radius, normalAngle, -M_PI));
+                pieces.push_back(makeLine(c2 - n, c1 - n));
+                pieces.push_back(makeArc(c1, e.radius, normalAngle + M_PI, -M_PI));
+            }
+            unit.closed = true;
+        }
+        break;
+
+    case EntityType::Ellipse:
+        if (!e.points.empty() && e.majorRadius > 0.0 && e.minorRadius > 0.0) {
+            // Chords short enough for the sharpest curvature
+            double big = std::max(e.majorRadius, e.minorRadius);
+            double small = std::min(e.majorRadius, e.minorRadius);
+            double maxCurvature = big / (small * small);
+            double chord = std::sqrt(8.0 * tolerance / maxCurvature);
+            int n = std::clamp(static_cast<int>(std::ceil(kTwoPi * big / chord)), 16, 4096);
+            std::vector<Point2D> pts;
+            for (int i = 0; i <= n; ++i) {
+                double t = kTwoPi * i / n;
+                pts.push_back(Point2D(e.points[0].x + e.majorRadius * std::cos(t),
+                                      e.points[0].y + e.minorRadius * std::sin(t)));
+            }
+            pts.back() = pts.front();
+            addPolyline(pts, true, pieces);
+            if (!pieces.empty()) pieces.back().smooth = true;
+            unit.closed = true;
+        }
+        break;
+
+    case EntityType::Spline:
+        if (auto curve = e.splineCurve()) {
+            addPolyline(curve->tessellate(tolerance), true, pieces);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return !pieces.empty();
+}
+
+/// Reverse a run of pieces, keeping each smooth flag on its joint
+void reversePieces(std::vector<Piece>& pieces, bool loop)
+{
+    size_t n = pieces.size();
+    if (n == 0) return;
+    std::vector<bool> smooth(n);
+    for (size_t i = 0; i < n; ++i) smooth[i] = pieces[i].smooth;
+
+    std::reverse(pieces.begin(), pieces.end());
+    for (Piece& p : pieces) p = reversed(p);
+    for (size_t j = 0; j + 1 < n; ++j) pieces[j].smooth = smooth[n - 2 - j];
+    pieces[n - 1].smooth = loop && smooth[n - 1];
+}
+
+/// Order the units end to end into one path.  The first unit keeps
+/// its own direction.
+bool orderPath(std::vector<Unit>& units, double tolerance,
+               std::vector<Piece>& path, bool& closed, std::string& error)
+{
+    const size_t n = units.size();
+    if (n == 1) {
+        path = units[0].pieces;
+        closed = units[0].closed ||
+                 length(path.back().b - path.front().a) <= tolerance;
+        return true;
+    }
+    for (const Unit& unit : units) {
+        if (unit.closed) {
+            error = "A closed entity can only be offset on its own";
+            return false;
+        }
+    }
+
+    // Endpoint 2i is the start of unit i, 2i + 1 its end.  Sorting by x
+    // keeps the candidate search to a narrow window; the closest
+    // candidates pair first, so entities shorter than the tolerance
+    // still join their true neighbours.
+    auto endpoint = [&](size_t e) {
+        const Unit& u = units[e / 2];
+        return (e % 2 == 0) ? u.pieces.front().a : u.pieces.back().b;
+    };
+    std::vector<size_t> order(2 * n);
+    for (size_t e = 0; e < 2 * n; ++e) order[e] = e;
+    std::sort(order.begin(), order.end(), [&](size_t l, size_t r) {
+        return endpoint(l).x < endpoint(r).x;
+    });
+
+    struct Candidate {
+        double distance;
+        size_t e1;
+        size_t e2;
+    };
+    std::vector<Candidate> candidates;
+    for (size_t i = 0; i < order.size(); ++i) {
+        Point2D p = endpoint(order[i]);
+        for (size_t j = i + 1; j < order.size(); ++j) {
+            Point2D q = endpoint(order[j]);
+            if (q.x - p.x > tolerance) break;
+            double dist = length(q - p);
+            if (order[i] / 2 == order[j] / 2 || dist > tolerance) continue;
+            candidates.push_back({dist, order[i], order[j]});
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& l, const Candidate& r) {
+        return l.distance < r.distance;
+    });
+
+    std::vector<long> partner(2 * n, -1);
+    for (const Candidate& c : candidates) {
+        if (partner[c.e1] >= 0 || partner[c.e2] >= 0) continue;
+        partner[c.e1] = static_cast<long>(c.e2);
+        partner[c.e2] = static_cast<long>(c.e1);
+    }
+
+    // Start at a free end if there is one, otherwise anywhere on the loop
+    size_t startEnd = 0;
+    closed = true;
+    for (size_t e = 0; e < 2 * n; ++e) {
+        if (partner[e] < 0) {
+            startEnd = e;
+            closed = false;
+            break;
+        }
+    }
+
+    std::vector<bool> visited(n, false);
+    bool firstReversed = false;
+    size_t entry = startEnd;
+    for (size_t count = 0; count < n; ++count) {
+        size_t unit = entry / 2;
+        if (visited[unit]) break;
+        visited[unit] = true;
+
+        std::vector<Piece> pieces = units[unit].pieces;
+        bool rev = (entry % 2 == 1);
+        if (rev) reversePieces(pieces, false);
+        if (unit == 0) firstReversed = rev;
+        path.insert(path.end(), pieces.begin(), pieces.end());
+
+        long next = partner[rev ? unit * 2 : unit * 2 + 1];
+        if (next < 0) break;
+        entry = static_cast<size_t>(next);
+    }
+
+    if (std::count(visited.begin(), visited.end(), true) != static_cast<long>(n)) {
+        error = "Chain branches or is not connected; select a single path or loop";
+        return false;
+    }
+
+    if (firstReversed) reversePieces(path, closed);
+    return true;
+}
+
+/// Closed path as a polygon, for orientation and inside tests
+std::vector<Point2D> samplePath(const std::vector<Piece>& path)
+{
+    std::vector<Point2D> pts;
+    for (const Piece& p : path) {
+        int steps = p.arc ? std::max(2, static_cast<int>(std::ceil(std::abs(p.sweep) / (M_PI / 16)))) : 1;
+        for (int i = 0; i < steps; ++i) pts.push_back(pointAt(p, static_cast<double>(i) / steps));
+    }
+    return pts;
+}
+
+double signedArea(const std::vector<Point2D>& pts)
+{
+    double area = 0.0;
+    for (size_t i = 0; i < pts.size(); ++i) {
+        const Point2D& p = pts[i];
+        const Point2D& q = pts[(i + 1) % pts.size()];
+        area += p.x * q.y - q.x * p.y;
+    }
+    return 0.5 * area;
+}
+
+bool insidePolygon(const std::vector<Point2D>& pts, const Point2D& p)
+{
+    bool inside = false;
+    for (size_t i = 0, j = pts.size() - 1; i < pts.size(); j = i++) {
+        if ((pts[i].y > p.y) != (pts[j].y > p.y) &&
+            p.x < (pts[j].x - pts[i].x) * (p.y - pts[i].y) / (pts[j].y - pts[i].y) + pts[i].x) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+// =====================================================================
+//  Distance Grid
+// =====================================================================
+
+/// Uniform grid over the source path for "closer than" queries
+class PieceGrid {
+public:
+    PieceGrid(const std::vector<Piece>& pieces, double cellSize)
+        : m_pieces(pieces), m_cell(cellSize), m_stamp(pieces.size(), 0)
+    {
+        for (size_t i = 0; i < pieces.size(); ++i) {
+            BoundingBox box = pieceBounds(pieces[i]);
+            for (long long cx = cell(box.minX); cx <= cell(box.maxX); ++cx) {
+                for (long long cy = cell(box.minY); cy <= cell(box.maxY); ++cy) {
+                    m_cells[key(cx, cy)].push_back(static_cast<int>(i));
+                }
+            }
+        }
+    }
+
+    /// True if some piece is closer to p than limit
+    bool anyCloser(const Point2D& p, double limit)
+    {
+        ++m_query;
+        for (long long cx = cell(p.x - limit); cx <= cell(p.x + limit); ++cx) {
+            for (long long cy = cell(p.y - limit); cy <= cell(p.y + limit); ++cy) {
+                auto it = m_cells.find(key(cx, cy));
+                if (it == m_cells.end()) continue;
+                for (int i : it->second) {
+                    if (m_stamp[i] == m_query) continue;
+                    m_stamp[i] = m_query;
+                    if (distanceToPiece(m_pieces[i], p) < limit) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    long long cell(double v) const { return static_cast<long long>(std::floor(v / m_cell)); }
+
+    /// Collisions only cost a few extra distance checks
+    static std::int64_t key(long long cx, long long cy)
+    {
+        return static_cast<std::int64_t>(cx) * 73856093LL ^ static_cast<std::int64_t>(cy) * 19349663LL;
+    }
+
+    const std::vector<Piece>& m_pieces;
+    double m_cell;
+    std::unordered_map<std::int64_t, std::vector<int>> m_cells;
+    std::vector<int> m_stamp;
+    int m_query = 0;
+};
+
+// =====================================================================
+//  Offset
+// =====================================================================
+
+/// A kept part of a raw offset piece
+struct Part {
+    Piece piece;
+    int raw = 0;                ///< Raw piece it was cut from
+};
+
+/// Raw offset of a path: offset pieces plus joins
+struct RawOffset {
+    std::vector<Piece> pieces;
+    std::vector<int> miterJoint;    ///< Per piece: joint index if it is a miter line, else -1
+};
+
+RawOffset buildRawOffset(const std::vector<Piece>& path, bool closed, double d,
+                         const ChainOffsetOptions& options, const std::vector<bool>& forceRound)
+{
+    const double absD = std::abs(d);
+    const double weld = 1e-9 * (1.0 + absD);
+    const size_t n = path.size();
+
+    std::vector<Piece> offs(n);
+    for (size_t i = 0; i < n; ++i) offs[i] = offsetPiece(path[i], d);
+
+    RawOffset raw;
+    auto push = [&](const Piece& p, int joint) {
+        if (pieceLength(p) <= weld) return;
+        raw.pieces.push_back(p);
+        raw.miterJoint.push_back(joint);
+    };
+
+    // Each offset piece is pushed once its end joint is resolved; the
+    // start of piece 0 is resolved last on a closed path
+    int firstRaw = -1;
+    for (size_t i = 0; i < n; ++i) {
+        Piece current = offs[i];
+
+        size_t next = i + 1;
+        if (next == n) next = closed ? 0 : n;
+        std::vector<Piece> joins;
+        int joinMiter = -1;
+
+        if (next < n) {
+            Piece& following = (next == 0 && firstRaw >= 0)
+                ? raw.pieces[firstRaw] : offs[next];
+            Point2D E = current.b;
+            Point2D S = following.a;
+            Point2D V = path[i].b;
+            Point2D t1 = endTangent(path[i]);
+            Point2D t2 = startTangent(path[next]);
+            double turn = cross(t1, t2);
+            double along = dot(t1, t2);
+            bool cusp = along < 0.0 && std::abs(turn) < 1e-9;
+
+            if (length(S - E) <= weld) {
+                // Tangent joint: the pieces already meet
+            } else if (turn * d > 0.0 || cusp) {
+                // Convex corner: the offset pieces leave a gap
+                double theta = std::atan2(std::abs(turn), along);
+                double half = std::cos(theta / 2.0);
+                bool miter;
+                if (path[i].smooth) {
+                    // Joint of a flattened curve: a miter stays within tolerance
+                    miter = half > 0.0 && absD * (1.0 / half - 1.0) <= 0.5 * options.tolerance;
+                } else {
+                    miter = options.join == OffsetJoin::Miter && !forceRound[i] &&
+                            half > 0.0 && 1.0 / half <= options.miterLimit;
+                }
+
+                if (miter) {
+                    Point2D P = E + t1 * (absD * std::tan(theta / 2.0));
+                    joins.push_back(makeLine(E, P));
+                    joins.push_back(makeLine(P, S));
+                    joinMiter = static_cast<int>(i);
+                } else {
+                    double a0 = std::atan2(E.y - V.y, E.x - V.x);
+                    double a1 = std::atan2(S.y - V.y, S.x - V.x);
+                    double sweep = std::remainder(a1 - a0, kTwoPi);
+                    // Go round the corner on the far side of the vertex
+                    if (dot(polar(Point2D(), 1.0, a0 + sweep / 2.0), t1) < 0.0) {
+                        sweep += (sweep > 0.0) ? -kTwoPi : kTwoPi;
+                    }
+                    Piece join = makeArc(V, absD, a0, sweep);
+                    join.a = E;
+                    Point2D end = join.b;
+                    bool meets = length(S - end) <= weld;
+                    if (meets) join.b = S;
+                    joins.push_back(join);
+                    if (!meets) joins.push_back(makeLine(end, S));
+                }
+            } else if (std::abs(turn) < 1e-9) {
+                // Collinear pieces with a gap between them
+                joins.push_back(makeLine(E, S));
+            } else {
+                // Concave corner: trim both pieces at their crossing next
+                // to the joint.  Where they do not cross (a piece shorter
+                // than its overlap), a connector keeps the raw offset
+                // continuous; it lies in the invalid region and is
+                // trimmed away with the overlap.
+                std::vector<Crossing> crossings;
+                intersectPieces(current, following, crossings);
+                const Crossing* best = nullptr;
+                double bestGap = 0.0;
+                for (const Crossing& c : crossings) {
+                    if (c.u1 <= kParamEps || c.u2 >= 1.0 - kParamEps) continue;
+                    double gap = (1.0 - c.u1) * pieceLength(current) + c.u2 * pieceLength(following);
+                    if (!best || gap < bestGap) {
+                        best = &c;
+                        bestGap = gap;
+                    }
+                }
+                if (best) {
+                    Point2D X = best->point;
+                    double u1 = best->u1;
+                    double u2 = best->u2;
+                    current = subPiece(current, 0.0, u1, current.a, X);
+                    following = subPiece(following, u2, 1.0, X, following.b);
+                } else {
+                    joins.push_back(makeLine(E, S));
+                }
+            }
+        }
+
+        if (pieceLength(current) > weld) {
+            if (i == 0) firstRaw = static_cast<int>(raw.pieces.size());
+            raw.pieces.push_back(current);
+            raw.miterJoint.push_back(-1);
+        }
+        for (const Piece& j : joins) push(j, joinMiter);
+    }
+    return raw;
+}
+
+/// Cut the raw offset at its crossings and keep the parts at least the
+/// offset distance away from the source path.  Cutters cut raw pieces
+/// but are never kept.
+std::vector<Part> trimRawOffset(const RawOffset& raw, const std::vector<Piece>& cutters,
+                                const std::vector<Piece>& path, double d,
+                                std::vector<int>* crossedMiters)
+{
+    const double absD = std::abs(d);
+    const std::vector<Piece>& pieces = raw.pieces;
+    const size_t m = pieces.size();
+
+    std::vector<Piece> all(pieces);
+    all.insert(all.end(), cutters.begin(), cutters.end());
+
+    // Sweep over the pieces by increasing minX
+    std::vector<BoundingBox> bounds(all.size());
+    BoundingBox extent;
+    for (size_t i = 0; i < all.size(); ++i) {
+        bounds[i] = pieceBounds(all[i]);
+        extent.include(bounds[i]);
+    }
+    std::vector<size_t> order(all.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t l, size_t r) {
+        return bounds[l].minX < bounds[r].minX;
+    });
+
+    std::vector<std::vector<std::pair<double, Point2D>>> cuts(m);
+    std::vector<size_t> active;
+    std::vector<Crossing> crossings;
+    const double slack = 1e-9 * (1.0 + absD);
+    for (size_t idx : order) {
+        const BoundingBox& bi = bounds[idx];
+        active.erase(std::remove_if(active.begin(), active.end(), [&](size_t j) {
+            return bounds[j].maxX < bi.minX - slack;
+        }), active.end());
+
+        for (size_t j : active) {
+            if (idx >= m && j >= m) continue;
+            const BoundingBox& bj = bounds[j];
+            if (bj.maxY < bi.minY - slack || bj.minY > bi.maxY + slack) continue;
+
+            crossings.clear();
+            intersectPieces(all[idx], all[j], crossings);
+            for (const Crossing& c : crossings) {
+                bool interiorI = c.u1 > kParamEps && c.u1 < 1.0 - kParamEps;
+                bool interiorJ = c.u2 > kParamEps && c.u2 < 1.0 - kParamEps;
+                if (idx < m && interiorI) cuts[idx].push_back({c.u1, c.point});
+                if (j < m && interiorJ) cuts[j].push_back({c.u2, c.point});
+
+                // A miter line crossing anything but its own neighbours
+                if (crossedMiters && (interiorI || interiorJ)) {
+                    if (idx < m && raw.miterJoint[idx] >= 0 && interiorI) crossedMiters->push_back(raw.miterJoint[idx]);
+                    if (j < m && raw.miterJoint[j] >= 0 && interiorJ) crossedMiters->push_back(raw.miterJoint[j]);
+                }
+            }
+        }
+        active.push_back(idx);
+    }
+
+    double cellSize = std::max({absD, extent.width() / 128.0, extent.height() / 128.0, 1e-6});
+    PieceGrid grid(path, cellSize);
+    // Kept parts are exactly the offset distance away up to rounding;
+    // anything measurably closer overlaps the source
+    const double size = std::max(extent.width(), extent.height());
+    const double keepLimit = absD - 1e-9 * (1.0 + absD + size);
+
+    std::vector<Part> parts;
+    for (size_t i = 0; i < m; ++i) {
+        std::vector<std::pair<double, Point2D>>& c = cuts[i];
+        std::sort(c.begin(), c.end(), [](const auto& l, const auto& r) { return l.first < r.first; });
+
+        double u0 = 0.0;
+        Point2D p0 = pieces[i].a;
+        for (size_t k = 0; k <= c.size(); ++k) {
+            double u1 = (k < c.size()) ? c[k].first : 1.0;
+            Point2D p1 = (k < c.size()) ? c[k].second : pieces[i].b;
+            if (u1 - u0 <= kParamEps) continue;
+
+            Piece part = subPiece(pieces[i], u0, u1, p0, p1);
+            if (pieceLength(part) > slack && !grid.anyCloser(pointAt(part, 0.5), keepLimit)) {
+                parts.push_back({part, static_cast<int>(i)});
+            }
+            u0 = u1;
+            p0 = p1;
+        }
+    }
+    return parts;
+}
+
+/// Stitch kept parts into chains by their end points
+std::vector<std::vector<Part>> stitchParts(std::vector<Part>& parts, double weld)
+{
+    // Weld end points: nodes in a hash of cells, matched within weld
+    std::unordered_map<std::int64_t, std::vector<int>> cells;
+    std::vector<Point2D> nodes;
+    auto cellOf = [&](double v) { return static_cast<long long>(std::floor(v / weld)); };
+    auto key = [](long long cx, long long cy) {
+        return static_cast<std::int64_t>(cx) * 73856093LL ^ static_cast<std::int64_t>(cy) * 19349663LL;
+    };
+    auto nodeAt = [&](const Point2D& p) {
+        long long cx = cellOf(p.x), cy = cellOf(p.y);
+        for (long long dx = -1; dx <= 1; ++dx) {
+            for (long long dy = -1; dy <= 1; ++dy) {
+                auto it = cells.find(key(cx + dx, cy + dy));
+                if (it == cells.end()) continue;
+                for (int node : it->second) {
+                    if (length(nodes[node] - p) <= weld) return node;
+                }
+            }
+        }
+        nodes.push_back(p);
+        cells[key(cx, cy)].push_back(static_cast<int>(nodes.size()) - 1);
+        return static_cast<int>(nodes.size()) - 1;
+    };
+
+    std::vector<int> startNode(parts.size()), endNode(parts.size());
+    std::vector<std::vector<int>> incident;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        startNode[i] = nodeAt(parts[i].piece.a);
+        endNode[i] = nodeAt(parts[i].piece.b);
+        incident.resize(nodes.size());
+        incident[startNode[i]].push_back(static_cast<int>(i));
+        incident[endNode[i]].push_back(static_cast<int>(i));
+    }
+
+    std::vector<bool> used(parts.size(), false);
+    std::vector<std::vector<Part>> chains;
+
+    auto walk = [&](int first, bool forward) {
+        std::vector<Part> chain;
+        int current = first;
+        bool fwd = forward;
+        while (current >= 0) {
+            used[current] = true;
+            Part part = parts[current];
+            if (!fwd) part.piece = reversed(part.piece);
+            chain.push_back(part);
+
+            int node = fwd ? endNode[current] : startNode[current];
+            int next = -1;
+            for (int cand : incident[node]) {
+                if (used[cand]) continue;
+                next = cand;
+                fwd = (startNode[cand] == node);
+                break;
+            }
+            current = next;
+        }
+        chains.push_back(std::move(chain));
+    };
+
+    // Open chains from their free ends first, then loops
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (used[i]) continue;
+        if (incident[startNode[i]].size() == 1) walk(static_cast<int>(i), true);
+        else if (incident[endNode[i]].size() == 1) walk(static_cast<int>(i), false);
+    }
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (!used[i]) walk(static_cast<int>(i), true);
+    }
+    return chains;
+}
+
+/// Merge neighbouring parts cut from the same raw piece, and collinear
+/// lines such as a miter and the piece it extends
+void mergeParts(std::vector<Part>& chain, bool loop)
+{
+    auto mergeable = [](const Part& l, const Part& r) {
+        if (l.piece.b.x != r.piece.a.x || l.piece.b.y != r.piece.a.y) return false;
+        if (l.raw == r.raw) return (l.piece.sweep < 0) == (r.piece.sweep < 0);
+        if (l.piece.arc || r.piece.arc) return false;
+        Point2D dl = l.piece.b - l.piece.a;
+        Point2D dr = r.piece.b - r.piece.a;
+        return dot(dl, dr) > 0.0 && std::abs(cross(dl, dr)) <= 1e-12 * length(dl) * length(dr);
+    };
+    auto merge = [](Part& l, const Part& r) {
+        l.piece.b = r.piece.b;
+        if (l.piece.arc) l.piece.sweep += r.piece.sweep;
+    };
+
+    std::vector<Part> merged;
+    for (const Part& part : chain) {
+        if (!merged.empty() && mergeable(merged.back(), part)) merge(merged.back(), part);
+        else merged.push_back(part);
+    }
+    if (loop && merged.size() > 1 && mergeable(merged.back(), merged.front())) {
+        merge(merged.back(), merged.front());
+        merged.erase(merged.begin());
+    }
+    chain = std::move(merged);
+}
+
+Entity pieceEntity(const Piece& p, int id)
+{
+    if (!p.arc) return createLine(id, p.a, p.b);
+
+    // Arc entities run counter-clockwise from their start angle
+    double start = p.sweep >= 0 ? p.start : p.start + p.sweep;
+    double startDeg = std::fmod(start * 180.0 / M_PI, 360.0);
+    if (startDeg < 0) startDeg += 360.0;
+    return createArc(id, p.center, p.radius, startDeg, std::abs(p.sweep) * 180.0 / M_PI);
+}
+
+ChainOffsetResult offsetPath(const std::vector<Piece>& path, bool closed, double d,
+                             std::function<int()>& nextId, const ChainOffsetOptions& options,
+                             bool construction)
+{
+    ChainOffsetResult result;
+
+    // Miters that cross other parts of the offset would leave it
+    // self-intersecting; such corners are redone with round joins
+    std::vector<bool> forceRound(path.size(), false);
+
+    // An open path's offset can also run into the region within the
+    // offset distance across the path's ends or its other side, so the
+    // round end caps and the opposite offset bound that region too
+    std::vector<Piece> cutters;
+    if (!closed) {
+        cutters.push_back(makeArc(path.front().a, std::abs(d), 0.0, kTwoPi));
+        cutters.push_back(makeArc(path.back().b, std::abs(d), 0.0, kTwoPi));
+        ChainOffsetOptions roundJoins = options;
+        roundJoins.join = OffsetJoin::Round;
+        RawOffset other = buildRawOffset(path, false, -d, roundJoins, forceRound);
+        cutters.insert(cutters.end(), other.pieces.begin(), other.pieces.end());
+    }
+
+    std::vector<Part> parts;
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        RawOffset raw = buildRawOffset(path, closed, d, options, forceRound);
+        std::vector<int> crossedMiters;
+        parts = trimRawOffset(raw, cutters, path, d, &crossedMiters);
+        if (crossedMiters.empty() || options.join != OffsetJoin::Miter) break;
+        for (int joint : crossedMiters) forceRound[joint] = true;
+    }
+
+    BoundingBox extent;
+    for (const Part& part : parts) extent.include(pieceBounds(part.piece));
+    double size = extent.valid ? std::max(extent.width(), extent.height()) : 0.0;
+    double weld = 1e-9 * (1.0 + std::abs(d) + size);
+
+    for (std::vector<Part>& chain : stitchParts(parts, weld)) {
+        double total = 0.0;
+        for (const Part& part : chain) total += pieceLength(part.piece);
+        if (total < options.tolerance) continue;  // Slivers left by tangencies
+
+        bool loop = length(chain.back().piece.b - chain.front().piece.a) <= weld;
+        mergeParts(chain, loop);
+
+        if (chain.size() == 1 && chain[0].piece.arc &&
+            std::abs(chain[0].piece.sweep) >= kTwoPi - kParamEps) {
+            Entity circle = createCircle(nextId(), chain[0].piece.center, chain[0].piece.radius);
+            circle.isConstruction = construction;
+            result.newEntities.push_back(circle);
+        } else {
+            for (const Part& part : chain) {
+                Entity e = pieceEntity(part.piece, nextId());
+                e.isConstruction = construction;
+                result.newEntities.push_back(e);
+            }
+        }
+        ++result.chainCount;
+    }
+
+    if (result.chainCount == 0) {
+        result.errorMessage = "Offset leaves no geometry";
+        return result;
+    }
+    result.success = true;
+    return result;
+}
+
+/// Build the oriented path of a chain
+bool chainPath(const std::vector<int>& chainIds, const std::vector<Entity>& entities,
+               double tolerance, std::vector<Piece>& path, bool& closed,
+               bool& construction, std::string& error)
+{
+    std::unordered_map<int, const Entity*> byId;
+    for (const Entity& e : entities) byId[e.id] = &e;
+
+    std::vector<Unit> units;
+    for (int id : chainIds) {
+        auto it = byId.find(id);
+        if (it == byId.end()) continue;
+        // Chord sag and the sharpened corners between offset chords
+        // share the tolerance
+        Unit unit;
+        if (entityUnit(*it->second, 0.25 * tolerance, unit)) {
+            if (units.empty()) construction = it->second->isConstruction;
+            units.push_back(std::move(unit));
+        }
+    }
+    if (units.empty()) {
+        error = "No offsettable entities in chain";
+        return false;
+    }
+    return orderPath(units, POINT_TOLERANCE, path, closed, error);
+}
+
+}  // anonymous namespace
+
+// =====================================================================
+//  Chain Offset
+// =====================================================================
+
+ChainOffsetResult offsetChain(
+    const std::vector<int>& chainIds,
+    const std::vector<Entity>& entities,
+    double distance,
+    int side,
+    std::function<int()> nextId,
+    const ChainOffsetOptions& options)
+{
+    ChainOffsetResult result;
+    if (distance <= 0.0) {
+        result.errorMessage = "Offset distance must be positive";
+        return result;
+    }
+
+    std::vector<Piece> path;
+    bool closed = false;
+    bool construction = false;
+    if (!chainPath(chainIds, entities, options.tolerance, path, closed, construction,
+                   result.errorMessage)) {
+        return result;
+    }
+
+    // Outward is to the right of a counter-clockwise loop
+    double right = (side > 0) ? 1.0 : -1.0;
+    if (closed && signedArea(samplePath(path)) < 0.0) right = -right;
+
+    return offsetPath(path, closed, distance * right, nextId, options, construction);
+}
+
+ChainOffsetResult offsetChain(
+    const std::vector<int>& chainIds,
+    const std::vector<Entity>& entities,
+    double distance,
+    const Point2D& clickPos,
+    std::function<int()> nextId,
+    const ChainOffsetOptions& options)
+{
+    ChainOffsetResult result;
+    if (distance <= 0.0) {
+        result.errorMessage = "Offset distance must be positive";
+        return result;
+    }
+
+    std::vector<Piece> path;
+    bool closed = false;
+    bool construction = false;
+    if (!chainPath(chainIds, entities, options.tolerance, path, closed, construction,
+                   result.errorMessage)) {
+        return result;
+    }
+
+    double right;
+    if (closed) {
+        std::vector<Point2D> polygon = samplePath(path);
+        bool ccw = signedArea(polygon) > 0.0;
+        bool outward = !insidePolygon(polygon, clickPos);
+        right = (outward == ccw) ? 1.0 : -1.0;
+    } else {
+        // Side of the nearest piece the click is on
+        double best = std::numeric_limits<double>::max();
+        right = 1.0;
+        for (const Piece& p : path) {
+            if (distanceToPiece(p, clickPos) >= best) continue;
+            best = distanceToPiece(p, clickPos);
+            Point2D tangent;
+            Point2D nearest = closestOnPiece(p, clickPos, &tangent);
+            right = (cross(tangent, clickPos - nearest) < 0.0) ? 1.0 : -1.0;
+        }
+    }
+
+    return offsetPath(path, closed, distance * right, nextId, options, construction);
+}
+
+}  // namespace sketch
+}  // namespace hobbycad
@@ -0,0 +1,462 @@
+// =====================================================================
+//  src/libhobbycad/sketch/contour_fit.cpp — Contours from polylines
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/sketch/contour_fit.h>
+#include <hobbycad/geometry/utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <unordered_map>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace hobbycad {
+namespace sketch {
+
+namespace {
+
+/// Consecutive points closer than this fraction of the tolerance are
+/// one point
+constexpr double kDuplicateRatio = 1e-3;
+
+constexpr double kTwoPi = 2.0 * M_PI;
+
+double cross2(const Point2D& a, const Point2D& b)
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+double distance(const Point2D& a, const Point2D& b)
+{
+    return std::hypot(a.x - b.x, a.y - b.y);
+}
+
+double segmentDistance(const Point2D& p, const Point2D& a, const Point2D& b)
+{
+    const Point2D ab = b - a;
+    const double len2 = ab.x * ab.x + ab.y * ab.y;
+    double t = len2 > 0.0 ? ((p.x - a.x) * ab.x + (p.y - a.y) * ab.y) / len2 : 0.0;
+    t = std::clamp(t, 0.0, 1.0);
+    return distance(p, a + ab * t);
+}
+
+/// Signed angle from u to v in (-pi, pi]
+double turn(const Point2D& u, const Point2D& v)
+{
+    return std::atan2(cross2(u, v), u.x * v.x + u.y * v.y);
+}
+
+/// Drop consecutive duplicates (and, for closed input, a repeated
+/// start point)
+std::vector<Point2D> cleaned(const std::vector<Point2D>& points, bool closed, double eps)
+{
+    std::vector<Point2D> out;
+    out.reserve(points.size());
+    for (const Point2D& p : points)
+        if (out.empty() || distance(out.back(), p) > eps) out.push_back(p);
+    if (closed)
+        while (out.size() > 1 && distance(out.front(), out.back()) <= eps) out.pop_back();
+    return out;
+}
+
+/// Circle through three points; false if they are (nearly) collinear
+bool circleThrough(const Point2D& a, const Point2D& b, const Point2D& c,
+                   Point2D& center, double& radius)
+{
+    const Point2D ab = b - a, ac = c - a;
+    const double d = 2.0 * cross2(ab, ac);
+    const double scale = (ab.x * ab.x + ab.y * ab.y) * (ac.x * ac.x + ac.y * ac.y);
+    if (std::abs(d) <= 1e-12 * std::sqrt(scale)) return false;
+    const double ab2 = ab.x * ab.x + ab.y * ab.y, ac2 = ac.x * ac.x + ac.y * ac.y;
+    center = a + Point2D((ac.y * ab2 - ab.y * ac2) / d, (ab.x * ac2 - ac.x * ab2) / d);
+    radius = distance(center, a);
+    return true;
+}
+
+/// An arc over points [i, j], traversed from i to j
+struct ArcFit {
+    Point2D center;
+    double radius = 0.0;
+    double sweep = 0.0;  ///< Signed, radians
+};
+
+class PolylineFitter {
+public:
+    PolylineFitter(const std::vector<Point2D>& pts, const ContourFitOptions& options)
+        : m_p(pts), m_options(options),
+          m_maxStep(options.maxArcSegmentAngle * M_PI / 180.0) {}
+
+    bool lineFits(int i, int j) const
+    {
+        for (int k = i + 1; k < j; ++k)
+            if (segmentDistance(m_p[k], m_p[i], m_p[j]) > m_options.tolerance) return false;
+        return true;
+    }
+
+    bool arcFits(int i, int j, ArcFit* fit = nullptr) const
+    {
+        if (j - i < m_options.minArcSegments) return false;
+        ArcFit arc;
+        if (!circleThrough(m_p[i], m_p[(i + j) / 2], m_p[j], arc.center, arc.radius)) return false;
+        double total = 0.0;
+        int sign = 0;
+        for (int k = i; k <= j; ++k) {
+            if (std::abs(distance(m_p[k], arc.center) - arc.radius) > m_options.tolerance)
+                return false;
+            if (k == j) break;
+            const double step = turn(m_p[k] - arc.center, m_p[k + 1] - arc.center);
+            const int s = step > 0.0 ? 1 : -1;
+            if (sign == 0) sign = s;
+            if (s != sign || std::abs(step) > m_maxStep) return false;
+            total += step;
+        }
+        if (std::abs(total) >= kTwoPi) return false;
+        arc.sweep = total;
+        if (fit) *fit = arc;
+        return true;
+    }
+
+    /// Largest j > i with fits(i, j), starting from i + minimum; -1 if
+    /// even that fails.  Doubles the span, then bisects.
+    int longest(int i, int minimum, int last, const std::function<bool(int, int)>& fits) const
+    {
+        int good = i + minimum;
+        if (good > last || !fits(i, good)) return -1;
+        int bad = -1;
+        while (good < last) {
+            const int next = std::min(last, i + 2 * (good - i));
+            if (fits(i, next)) good = next;
+            else { bad = next; break; }
+        }
+        while (bad >= 0 && bad - good > 1) {
+            const int mid = (good + bad) / 2;
+            if (fits(i, mid)) good = mid;
+            else bad = mid;
+        }
+        return good;
+    }
+
+    /// Fit points [0, last] into primitives; appends entities, the
+    /// start index of each primitive, and the signed area they sweep
+    /// about the origin
+    void fit(int last, int& nextId, std::vector<Entity>& entities, std::vector<int>& starts,
+             double& area) const
+    {
+        auto line = [this](int a, int b) { return lineFits(a, b); };
+        auto arc = [this](int a, int b) { return arcFits(a, b); };
+        int i = 0;
+        while (i < last) {
+            const int lineEnd = longest(i, 1, last, line);
+            const int arcEnd = m_options.recoverArcs
+                ? longest(i, m_options.minArcSegments, last, arc) : -1;
+            starts.push_back(i);
+            const Point2D& a = m_p[i];
+            if (arcEnd > lineEnd) {
+                ArcFit f;
+                arcFits(i, arcEnd, &f);
+                const Point2D& b = m_p[arcEnd];
+                double start = std::atan2(a.y - f.center.y, a.x - f.center.x) * 180.0 / M_PI;
+                double sweep = f.sweep * 180.0 / M_PI;
+                if (sweep < 0.0) {
+                    start += sweep;
+                    sweep = -sweep;
+                }
+                entities.push_back(createArc(nextId++, f.center, f.radius, start, sweep));
+                area += 0.5 * cross2(a, b) +
+                        0.5 * f.radius * f.radius * (f.sweep - std::sin(f.sweep));
+                i = arcEnd;
+            } else {
+                entities.push_back(createLine(nextId++, a, m_p[lineEnd]));
+                area += 0.5 * cross2(a, m_p[lineEnd]);
+                i = lineEnd;
+            }
+        }
+    }
+
+private:
+    const std::vector<Point2D>& m_p;
+    const ContourFitOptions& m_options;
+    double m_maxStep;
+};
+
+/// A closed polyline that is one full circle
+bool fullCircle(const std::vector<Point2D>& p, const ContourFitOptions& options,
+                Point2D& center, double& radius)
+{
+    const int n = static_cast<int>(p.size());
+    if (!options.recoverArcs || n < std::max(3, options.minArcSegments)) return false;
+
+    // Algebraic least-squares circle (x^2 + y^2 = 2ax + 2by + c), about
+    // the centroid for conditioning
+    Point2D mean;
+    for (const Point2D& q : p) mean += q;
+    mean /= n;
+    double suu = 0, svv = 0, suv = 0, suuu = 0, svvv = 0, suvv = 0, svuu = 0;
+    for (const Point2D& q : p) {
+        const double u = q.x - mean.x, v = q.y - mean.y;
+        suu += u * u;
+        svv += v * v;
+        suv += u * v;
+        suuu += u * u * u;
+        svvv += v * v * v;
+        suvv += u * v * v;
+        svuu += v * u * u;
+    }
+    const double det = suu * svv - suv * suv;
+    if (std::abs(det) <= 1e-12 * (suu * svv)) return false;
+    const double ru = 0.5 * (suuu + suvv), rv = 0.5 * (svvv + svuu);
+    const Point2D c((ru * svv - rv * suv) / det, (rv * suu - ru * suv) / det);
+    center = mean + c;
+    radius = std::sqrt(c.x * c.x + c.y * c.y + (suu + svv) / n);
+    const double maxStep = options.maxArcSegmentAngle * M_PI / 180.0;
+    double total = 0.0;
+    int sign = 0;
+    for (int k = 0; k < n; ++k) {
+        if (std::abs(distance(p[k], center) - radius) > options.tolerance) return false;
+        const double step = turn(p[k] - center, p[(k + 1) % n] - center);
+        const int s = step > 0.0 ? 1 : -1;
+        if (sign == 0) sign = s;
+        if (s != sign || std::abs(step) > maxStep) return false;
+        total += step;
+    }
+    return std::abs(std::abs(total) - kTwoPi) < 1e-6;
+}
+
+/// Fit with the signed area of the result (0 for open polylines)
+std::vector<Entity> fitWithArea(const std::vector<Point2D>& input, bool closed,
+                                const ContourFitOptions& options, int firstId, double& area)
+{
+    area = 0.0;
+    std::vector<Entity> entities;
+    std::vector<Point2D> p = cleaned(input, closed, options.tolerance * kDuplicateRatio);
+    const int n = static_cast<int>(p.size());
+    if (n < 2 || (closed && n < 3)) return entities;
+
+    if (!closed) {
+        std::vector<int> starts;
+        double ignored = 0.0;
+        int id = firstId;
+        PolylineFitter(p, options).fit(n - 1, id, entities, starts, ignored);
+        return entities;
+    }
+
+    Point2D center;
+    double radius = 0.0;
+    if (fullCircle(p, options, center, radius)) {
+        entities.push_back(createCircle(firstId, center, radius));
+        area = (geometry::polygonArea(p) < 0.0 ? -1.0 : 1.0) * M_PI * radius * radius;
+        return entities;
+    }
+
+    // Start at the sharpest corner, which is always a primitive
+    // boundary; then refit from the last boundary of that pass so the
+    // primitive crossing the start is fitted whole
+    auto sharpness = [&](int k) {
+        const Point2D& prev = p[(k + n - 1) % n];
+        const Point2D& next = p[(k + 1) % n];
+        return std::abs(turn(p[k] - prev, next - p[k]));
+    };
+    int corner = 0;
+    for (int k = 1; k < n; ++k)
+        if (sharpness(k) > sharpness(corner)) corner = k;
+
+    auto fitFrom = [&](int first, std::vector<Entity>& out, std::vector<int>& starts, double& a) {
+        std::vector<Point2D> ring(n + 1);
+        for (int k = 0; k <= n; ++k) ring[k] = p[(first + k) % n];
+        int id = firstId;
+        a = 0.0;
+        PolylineFitter(ring, options).fit(n, id, out, starts, a);
+    };
+
+    std::vector<int> starts;
+    fitFrom(corner, entities, starts, area);
+    if (entities.size() > 1) {
+        std::vector<Entity> again;
+        std::vector<int> againStarts;
+        double againArea = 0.0;
+        fitFrom((corner + starts.back()) % n, again, againStarts, againArea);
+        if (again.size() < entities.size()) {
+            entities = std::move(again);
+            area = againArea;
+        }
+    }
+    return entities;
+}
+
+// =====================================================================
+//  Joining
+// =====================================================================
+
+/// Join open pieces at ends that meet within tolerance
+void joinPieces(const std::vector<std::vector<Point2D>>& pieces, double tolerance,
+                std::vector<std::vector<Point2D>>& loops,
+                std::vector<std::vector<Point2D>>& chains)
+{
+    const int n = static_cast<int>(pieces.size());
+    const double cell = tolerance > 0.0 ? tolerance : 1e-9;
+    auto cellOf = [cell](const Point2D& p) {
+        return std::make_pair(static_cast<int64_t>(std::floor(p.x / cell)),
+                              static_cast<int64_t>(std::floor(p.y / cell)));
+    };
+    auto key = [](int64_t x, int64_t y) {
+        return (static_cast<uint64_t>(x) * 73856093u) ^ (static_cast<uint64_t>(y) * 19349663u);
+    };
+
+    // End e of piece i is 2 * i + e (0 = start, 1 = end)
+    std::unordered_map<uint64_t, std::vector<int>> grid;
+    auto endPoint = [&](int end) -> const Point2D& {
+        const auto& piece = pieces[end / 2];
+        return end % 2 == 0 ? piece.front() : piece.back();
+    };
+    for (int i = 0; i < n; ++i) {
+        if (pieces[i].size() < 2) continue;
+        for (int e = 0; e < 2; ++e) {
+            const auto [cx, cy] = cellOf(endPoint(2 * i + e));
+            grid[key(cx, cy)].push_back(2 * i + e);
+        }
+    }
+
+    std::vector<char> used(n, 0);
+    auto nearestEnd = [&](const Point2D& p) {
+        const auto [cx, cy] = cellOf(p);
+        int best = -1;
+        double bestDistance = tolerance;
+        for (int64_t dx = -1; dx <= 1; ++dx) {
+            for (int64_t dy = -1; dy <= 1; ++dy) {
+                auto it = grid.find(key(cx + dx, cy + dy));
+                if (it == grid.end()) continue;
+                for (int end : it->second) {
+                    if (used[end / 2]) continue;
+                    const double d = distance(p, endPoint(end));
+                    if (d <= bestDistance) {
+                        bestDistance = d;
+                        best = end;
+                    }
+                }
+            }
+        }
+        return best;
+    };
+
+    // Append piece `end / 2` entering at `end`, skipping the shared point
+    auto append = [&](std::vector<Point2D>& chain, int end) {
+        const auto& piece = pieces[end / 2];
+        used[end / 2] = 1;
+        if (end % 2 == 0) chain.insert(chain.end(), piece.begin() + 1, piece.end());
+        else chain.insert(chain.end(), piece.rbegin() + 1, piece.rend());
+    };
+
+    for (int i = 0; i < n; ++i) {
+        if (used[i] || pieces[i].size() < 2) continue;
+        used[i] = 1;
+        std::vector<Point2D> chain = pieces[i];
+        bool closed = false;
+        for (;;) {
+            if (chain.size() > 2 && distance(chain.back(), chain.front()) <= tolerance) {
+                closed = true;
+                break;
+            }
+            const int end = nearestEnd(chain.back());
+            if (end < 0) break;
+            append(chain, end);
+        }
+        if (!closed) {
+            // Grow backwards from the start as well
+            std::reverse(chain.begin(), chain.end());
+            for (int end; (end = nearestEnd(chain.back())) >= 0;) append(chain, end);
+            std::reverse(chain.begin(), chain.end());
+        }
+        if (closed) {
+            chain.pop_back();
+            loops.push_back(std::move(chain));
+        } else {
+            chains.push_back(std::move(chain));
+        }
+    }
+}
+
+}  // anonymous namespace
+
+// =====================================================================
+//  Public API
+// =====================================================================
+
+std::vector<Entity> fitLinesAndArcs(const std::vector<Point2D>& points, bool closed,
+                                    const ContourFitOptions& options, int firstId)
+{
+    double area = 0.0;
+    return fitWithArea(points, closed, options, firstId, area);
+}
+
+std::vector<Contour> buildContours(const std::vector<std::vector<Point2D>>& loops,
+                                   const std::vector<std::vector<Point2D>>& pieces,
+                                   const ContourFitOptions& options, int firstId)
+{
+    std::vector<std::vector<Point2D>> closedLoops;
+    std::vector<std::vector<Point2D>> openChains;
+    for (const auto& loop : loops)
+        if (loop.size() >= 3) closedLoops.push_back(loop);
+    joinPieces(pieces, options.tolerance, closedLoops, openChains);
+
+    std::vector<Contour> contours;
+    for (auto& loop : closedLoops) {
+        Contour c;
+        c.points = std::move(loop);
+        c.closed = true;
+        contours.push_back(std::move(c));
+    }
+
+    // Nesting depth decides holes; test one point of each loop against
+    // the loops whose boxes contain it
+    const int closedCount = static_cast<int>(contours.size());
+    std::vector<geometry::BoundingBox> boxes(closedCount);
+    for (int i = 0; i < closedCount; ++i)
+        for (const Point2D& p : contours[i].points) boxes[i].include(p);
+    for (int i = 0; i < closedCount; ++i) {
+        const Point2D& probe = contours[i].points.front();
+        int depth = 0;
+        for (int j = 0; j < closedCount; ++j) {
+            if (j == i || !boxes[j].contains(probe)) continue;
+            if (geometry::pointInPolygon(probe, contours[j].points)) ++depth;
+        }
+        contours[i].hole = depth % 2 == 1;
+
+        // Outer boundaries counter-clockwise, holes clockwise
+        const bool ccw = geometry::polygonArea(contours[i].points) > 0.0;
+        if (ccw == contours[i].hole) std::reverse(contours[i].points.begin(), contours[i].points.end());
+    }
+
+    for (auto& chain : openChains) {
+        Contour c;
+        c.points = std::move(chain);
+        contours.push_back(std::move(c));
+    }
+
+    std::stable_sort(contours.begin(), contours.end(), [](const Contour& a, const Contour& b) {
+        const int ra = a.closed ? (a.hole ? 1 : 0) : 2;
+        const int rb = b.closed ? (b.hole ? 1 : 0) : 2;
+        if (ra != rb) return ra < rb;
+        return std::abs(geometry::polygonArea(a.points)) > std::abs(geometry::polygonArea(b.points));
+    });
+
+    int nextId = firstId;
+    for (Contour& c : contours) {
+        c.entities = fitWithArea(c.points, c.closed, options, nextId, c.area);
+        nextId += static_cast<int>(c.entities.size());
+    }
+    return contours;
+}
+
+}  // namespace sketch
+}  // namespace hobbycad
@@ -0,0 +1,138 @@
+// =====================================================================
+//  src/libhobbycad/sketch/drag_session.cpp — Interactive drag solving
+// =====================================================================
+
+#include <hobbycad/sketch/drag_session.h>
+#include <hobbycad/sketch/native_solver.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace hobbycad {
+namespace sketch {
+
+namespace {
+
+constexpr int kDefaultIterationsPerStep = 8;
+
+}  // namespace
+
+class DragSession::Impl {
+public:
+    NativeSolver solver;
+    std::vector<DraggedPoint> dragged;
+    DragStepInfo lastStep;
+    int iterationsPerStep = kDefaultIterationsPerStep;
+    bool active = false;
+
+    SolveResult run();
+};
+
+SolveResult DragSession::Impl::run()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    solver.setMaxIterations(iterationsPerStep);
+    SolveResult result = solver.solve();
+
+    lastStep.iterations = solver.lastIterations();
+    lastStep.converged = result.success;
+    lastStep.milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+DragSession::DragSession()
+    : m_impl(new Impl())
+{
+}
+
+DragSession::~DragSession()
+{
+    delete m_impl;
+}
+
+void DragSession::begin(const std::vector<Entity>& entities,
+                        const std::vector<Constraint>& constraints,
+                        const std::vector<DraggedPoint>& dragged)
+{
+    m_impl->solver.build(entities, constraints);
+
+    // Per-frame steps skip the rank analysis; DOF and redundancy are
+    // reported by the full solve that follows the gesture
+    m_impl->solver.setDiagnostics(false);
+
+    m_impl->dragged = dragged;
+    for (const DraggedPoint& d : dragged) {
+        m_impl->solver.setDragged(d.entityId, d.pointIndex);
+    }
+    m_impl->lastStep = DragStepInfo();
+    m_impl->active = true;
+}
+
+void DragSession::end()
+{
+    m_impl->solver.build({}, {});
+    m_impl->dragged.clear();
+    m_impl->active = false;
+}
+
+bool DragSession::isActive() const
+{
+    return m_impl->active;
+}
+
+SolveResult DragSession::step(const std::vector<Point2D>& targets)
+{
+    if (!m_impl->active) {
+        SolveResult result;
+        result.errorMessage = "No drag in progress";
+        return result;
+    }
+
+    size_t count = std::min(targets.size(), m_impl->dragged.size());
+    for (size_t i = 0; i < count; ++i) {
+        const DraggedPoint& d = m_impl->dragged[i];
+        m_impl->solver.setPoint(d.entityId, d.pointIndex, targets[i]);
+    }
+    return m_impl->run();
+}
+
+SolveResult DragSession::step(std::vector<Entity>& entities)
+{
+    if (!m_impl->active) {
+        SolveResult result;
+        result.errorMessage = "No drag in progress";
+        return result;
+    }
+
+    m_impl->solver.updateValues(entities);
+    SolveResult result = m_impl->run();
+    m_impl->solver.applyTo(entities);
+    return result;
+}
+
+void DragSession::applyTo(std::vector<Entity>& entities) const
+{
+    if (m_impl->active) {
+        m_impl->solver.applyTo(entities);
+    }
+}
+
+void DragSession::setMaxIterationsPerStep(int iterations)
+{
+    m_impl->iterationsPerStep = std::max(1, iterations);
+}
+
+int DragSession::maxIterationsPerStep() const
+{
+    return m_impl->iterationsPerStep;
+}
+
+const DragStepInfo& DragSession::lastStep() const
+{
+    return m_impl->lastStep;
+}
+
+}  // namespace sketch
+}  // namespace hobbycad
@@ -8,11 +8,16 @@
 // =====================================================================
 
 #include <hobbycad/sketch/entity.h>
+#include <hobbycad/sketch/entity_store.h>
 #include <hobbycad/geometry/intersections.h>
+#include <hobbycad/geometry/scratch.h>
 #include <hobbycad/geometry/utils.h>
 
 #include <cmath>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -23,12 +28,70 @@ namespace sketch {
 
 using namespace geometry;
 
+// =====================================================================
+//  Spline Curve Cache
+// =====================================================================
+
+/// Fitted curve of a spline entity and the points it was fitted to
+struct SplineCache {
+    std::uint64_t pointsHash = 0;
+    std::size_t pointCount = 0;
+    BSplineCurve2D curve;
+};
+
+namespace {
+
+/// FNV-1a over the bit patterns of the points' coordinates
+std::uint64_t hashPoints(const std::vector<Point2D>& points)
+{
+    std::uint64_t hash = 1469598103934665603ULL;
+    for (const Point2D& p : points) {
+        std::uint64_t bits[2];
+        std::memcpy(&bits[0], &p.x, sizeof(double));
+        std::memcpy(&bits[1], &p.y, sizeof(double));
+        hash = (hash ^ bits[0]) * 1099511628211ULL;
+        hash = (hash ^ bits[1]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+}  // anonymous namespace
+
+std::shared_ptr<const BSplineCurve2D> Entity::splineCurve() const
+{
+    if (type != EntityType::Spline || points.size() < 2) return nullptr;
+
+    // The cache is checked against a hash of the points, so editing
+    // points in place (or in a copy) rebuilds it on the next call.
+    // Concurrent callers may each build it; the results are identical.
+    std::uint64_t hash = hashPoints(points);
+    std::shared_ptr<const SplineCache> cache = std::atomic_load(&splineCache);
+    if (!cache || cache->pointsHash != hash || cache->pointCount != points.size()) {
+        auto built = std::make_shared<SplineCache>();
+        built->pointsHash = hash;
+        built->pointCount = points.size();
+        built->curve = BSplineCurve2D::fromCatmullRom(points);
+        cache = built;
+        std::atomic_store(&splineCache, cache);
+    }
+    return std::shared_ptr<const BSplineCurve2D>(cache, &cache->curve);
+}
+
 // =====================================================================
 //  Entity Methods
 // =====================================================================
 
-BoundingBox Entity::boundingBox() const
+// Geometry shared by Entity and EntityView, which have the same
+// field names
+namespace {
+
+/// Bounding box of an Entity or EntityView
+template <typename E>
+BoundingBox boundingBoxOf(const E& entity)
 {
+    const auto& points = entity.points;
+    const EntityType type = entity.type;
+    const double radius = entity.radius;
     BoundingBox bbox;
 
     for (const Point2D& p : points) {
@@ -53,18 +116,24 @@ BoundingBox Entity::boundingBox() const
             bbox.include(Point2D(p.x + radius, p.y + radius));
         }
     } else if (type == EntityType::Ellipse && !points.empty()) {
-        bbox.include(Point2D(points[0].x - majorRadius, points[0].y - minorRadius));
-        bbox.include(Point2D(points[0].x + majorRadius, points[0].y + minorRadius));
+        bbox.include(Point2D(points[0].x - entity.majorRadius, points[0].y - entity.minorRadius));
+        bbox.include(Point2D(points[0].x + entity.majorRadius, points[0].y + entity.minorRadius));
+    } else if (auto curve = entity.splineCurve()) {
+        // The curve can bulge past its through-points; its poles bound it
+        bbox.include(curve->boundingBox());
     }
 
     return bbox;
 }
 
-std::vector<Point2D> Entity::endpoints() const
+/// Start and end points of an Entity or EntityView
+template <typename E>
+std::vector<Point2D> endpointsOf(const E& entity)
 {
+    const auto& points = entity.points;
     std::vector<Point2D> result;
 
-    switch (type) {
+    switch (entity.type) {
     case EntityType::Line:
         if (points.size() >= 2) {
             result.push_back(points[0]);
@@ -75,9 +144,9 @@ std::vector<Point2D> Entity::endpoints() const
         if (!points.empty()) {
             Arc arc;
             arc.center = points[0];
-            arc.radius = radius;
-            arc.startAngle = startAngle;
-            arc.sweepAngle = sweepAngle;
+            arc.radius = entity.radius;
+            arc.startAngle = entity.startAngle;
+            arc.sweepAngle = entity.sweepAngle;
             result.push_back(arc.startPoint());
             result.push_back(arc.endPoint());
         }
@@ -106,6 +175,46 @@ std::vector<Point2D> Entity::endpoints() const
     return result;
 }
 
+/// Shared endpoint of two entities (or views), averaged
+template <typename E>
+std::optional<Point2D> connectionPointOf(const E& e1, const E& e2, double tolerance)
+{
+    std::vector<Point2D> ep1 = endpointsOf(e1);
+    std::vector<Point2D> ep2 = endpointsOf(e2);
+
+    for (const Point2D& p1 : ep1) {
+        for (const Point2D& p2 : ep2) {
+            if (pointsCoincident(p1, p2, tolerance)) {
+                return (p1 + p2) / 2.0;
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+}  // anonymous namespace
+
+BoundingBox Entity::boundingBox() const
+{
+    return boundingBoxOf(*this);
+}
+
+std::vector<Point2D> Entity::endpoints() const
+{
+    return endpointsOf(*this);
+}
+
+BoundingBox EntityView::boundingBox() const
+{
+    return boundingBoxOf(*this);
+}
+
+std::vector<Point2D> EntityView::endpoints() const
+{
+    return endpointsOf(*this);
+}
+
 bool Entity::containsPoint(const Point2D& point, double tolerance) const
 {
     return distanceTo(point) < tolerance;
@@ -212,34 +321,7 @@ Point2D Entity::closestPoint(const Point2D& point) const
             if (points.size() == 2) {
                 return closestPointOnLine(point, points[0], points[1]);
             }
-            // Sample Catmull-Rom spline and find closest point on sub-segments
-            Point2D bestPoint = points[0];
-            double minDist = std::hypot(point.x - points[0].x, point.y - points[0].y);
-            const int samplesPerSegment = 20;
-
-            for (int i = 0; i < static_cast<int>(points.size()) - 1; ++i) {
-                Point2D cp0 = (i == 0) ? points[i] : points[i - 1];
-                Point2D cp1 = points[i];
-                Point2D cp2 = points[i + 1];
-                Point2D cp3 = (i == static_cast<int>(points.size()) - 2) ? points[i + 1] : points[i + 2];
-
-                Point2D b0 = cp1;
-                Point2D b1 = cp1 + (cp2 - cp0) / 6.0;
-                Point2D b2 = cp2 - (cp3 - cp1) / 6.0;
-                Point2D b3 = cp2;
-
-                Point2D prev = b0;
-                for (int s = 1; s <= samplesPerSegment; ++s) {
-                    double st = static_cast<double>(s) / samplesPerSegment;
-                    double u = 1.0 - st;
-                    Point2D cur = u*u*u*b0 + 3.0*u*u*st*b1 + 3.0*u*st*st*b2 + st*st*st*b3;
-                    Point2D cp = closestPointOnLine(point, prev, cur);
-                    double d = std::hypot(point.x - cp.x, point.y - cp.y);
-                    if (d < minDist) { minDist = d; bestPoint = cp; }
-                    prev = cur;
-                }
-            }
-            return bestPoint;
+            return splineCurve()->closestPoint(point);
         }
         break;
 
@@ -416,33 +498,7 @@ double Entity::distanceTo(const Point2D& point) const
                 // Just two points - distance to line segment
                 return pointToLineDistance(point, points[0], points[1]);
             }
-            // Sample Catmull-Rom spline and find minimum distance to sub-segments
-            const int samplesPerSegment = 20;
-            double minDist = std::numeric_limits<double>::max();
-            for (int i = 0; i < static_cast<int>(points.size()) - 1; ++i) {
-                Point2D cp0 = (i == 0) ? points[i] : points[i - 1];
-                Point2D cp1 = points[i];
-                Point2D cp2 = points[i + 1];
-                Point2D cp3 = (i == static_cast<int>(points.size()) - 2) ? points[i + 1] : points[i + 2];
-
-                // Convert Catmull-Rom to cubic Bezier control points (tension = 0.5)
-                Point2D b0 = cp1;
-                Point2D b1 = cp1 + (cp2 - cp0) / 6.0;
-                Point2D b2 = cp2 - (cp3 - cp1) / 6.0;
-                Point2D b3 = cp2;
-
-                // Sample the cubic Bezier and test each sub-segment
-                Point2D prev = b0;
-                for (int s = 1; s <= samplesPerSegment; ++s) {
-                    double st = static_cast<double>(s) / samplesPerSegment;
-                    double u = 1.0 - st;
-                    Point2D cur = u*u*u*b0 + 3.0*u*u*st*b1 + 3.0*u*st*st*b2 + st*st*st*b3;
-                    double d = pointToLineDistance(point, prev, cur);
-                    if (d < minDist) minDist = d;
-                    prev = cur;
-                }
-            }
-            return minDist;
+            return splineCurve()->distanceTo(point);
         }
         break;
 
@@ -713,18 +769,12 @@ bool entitiesConnected(const Entity& e1, const Entity& e2, double tolerance)
 
 std::optional<Point2D> connectionPoint(const Entity& e1, const Entity& e2, double tolerance)
 {
-    std::vector<Point2D> ep1 = e1.endpoints();
-    std::vector<Point2D> ep2 = e2.endpoints();
-
-    for (const Point2D& p1 : ep1) {
-        for (const Point2D& p2 : ep2) {
-            if (pointsCoincident(p1, p2, tolerance)) {
-                return (p1 + p2) / 2.0;
-            }
-        }
-    }
+    return connectionPointOf(e1, e2, tolerance);
+}
 
-    return std::nullopt;
+bool entitiesConnected(const EntityView& e1, const EntityView& e2, double tolerance)
+{
+    return connectionPointOf(e1, e2, tolerance).has_value();
 }
 
 bool entityIntersectsRect(const Entity& entity, const Rect2D& rect)
@@ -817,8 +867,19 @@ bool entityIntersectsRect(const Entity& entity, const Rect2D& rect)
         break;
 
     case EntityType::Spline:
-        for (const Point2D& pt : entity.points) {
-            if (rect.contains(pt)) return true;
+        if (auto curve = entity.splineCurve()) {
+            // Only spans whose hull reaches the rectangle can cross it
+            for (int span : curve->spansInBox(BoundingBox(rect))) {
+                double t0, t1;
+                curve->spanRange(span, &t0, &t1);
+                Point2D prev = curve->point(t0);
+                for (int i = 1; i <= 16; ++i) {
+                    Point2D cur = curve->point(t0 + (t1 - t0) * i / 16);
+                    if (rect.contains(prev) || lineIntersectsRect(prev, cur, rect)) return true;
+                    prev = cur;
+                }
+                if (rect.contains(prev)) return true;
+            }
         }
         break;
 
@@ -884,6 +945,16 @@ bool entityEnclosedByRect(const Entity& entity, const Rect2D& rect)
         break;
 
     case EntityType::Spline:
+        if (auto curve = entity.splineCurve()) {
+            // The pole hull is conservative; fall back to the curve itself
+            if (rect.contains(curve->boundingBox().toRect())) return true;
+            for (const Point2D& p : curve->tessellate(POINT_TOLERANCE * 0.1)) {
+                if (!rect.contains(p)) return false;
+            }
+            return true;
+        }
+        [[fallthrough]];
+
     default:
         // All control points must be enclosed
         for (const Point2D& p : entity.points) {
@@ -933,7 +1004,10 @@ double getEntityAngle(const Entity& entity)
 
 std::vector<Point2D> entityToPolygon(const Entity& entity, int segments)
 {
-    std::vector<Point2D> result;
+    // Built in scratch storage so the returned vector is allocated once
+    // at its final size rather than grown point by point
+    ScratchArena arena;
+    ScratchVector<Point2D> result(arena.resource());
 
     switch (entity.type) {
     case EntityType::Point:
@@ -1118,8 +1192,15 @@ std::vector<Point2D> entityToPolygon(const Entity& entity, int segments)
         break;
 
     case EntityType::Spline:
-        // For splines, return control points (proper tessellation would need Catmull-Rom)
-        result = entity.points;
+        if (auto curve = entity.splineCurve()) {
+            // Same sagitta as a circle of the spline's size split into
+            // segments
+            BoundingBox box = curve->boundingBox();
+            double radius = 0.5 * std::hypot(box.width(), box.height());
+            std::vector<Point2D> polyline =
+                curve->tessellate(radius * (1.0 - std::cos(M_PI / segments)));
+            result.assign(polyline.begin(), polyline.end());
+        }
         break;
 
     case EntityType::Text:
@@ -1130,7 +1211,7 @@ std::vector<Point2D> entityToPolygon(const Entity& entity, int segments)
         break;
     }
 
-    return result;
+    return std::vector<Point2D>(result.begin(), result.end());
 }
 
 }  // namespace sketch
@@ -0,0 +1,336 @@
+// =====================================================================
+//  src/libhobbycad/sketch/entity_store.cpp — Compact entity store
+// =====================================================================
+
+#include "../hobbycad/sketch/entity_store.h"
+
+#include <atomic>
+
+namespace hobbycad {
+namespace sketch {
+
+// =====================================================================
+//  EntityView
+// =====================================================================
+
+namespace {
+
+const std::string kEmptyString;
+
+}  // namespace
+
+const std::string& EntityView::text() const
+{
+    int32_t slot = store->m_textSlot[index];
+    return slot < 0 ? kEmptyString : store->m_strings[store->m_text[slot].text];
+}
+
+const std::string& EntityView::fontFamily() const
+{
+    int32_t slot = store->m_textSlot[index];
+    return slot < 0 ? kEmptyString : store->m_strings[store->m_text[slot].fontFamily];
+}
+
+double EntityView::fontSize() const
+{
+    int32_t slot = store->m_textSlot[index];
+    return slot < 0 ? 12.0 : store->m_text[slot].fontSize;
+}
+
+bool EntityView::fontBold() const
+{
+    return (store->m_flags[index] & EntityStore::FlagFontBold) != 0;
+}
+
+bool EntityView::fontItalic() const
+{
+    return (store->m_flags[index] & EntityStore::FlagFontItalic) != 0;
+}
+
+double EntityView::textRotation() const
+{
+    int32_t slot = store->m_textSlot[index];
+    return slot < 0 ? 0.0 : store->m_text[slot].rotation;
+}
+
+Point2D EntityView::closestPoint(const Point2D& point) const
+{
+    // Only composite outlines (slots, text) need the full Entity;
+    // geometry code handles the simple types directly on the view
+    return toEntity().closestPoint(point);
+}
+
+std::shared_ptr<const geometry::BSplineCurve2D> EntityView::splineCurve() const
+{
+    if (type != EntityType::Spline || points.size() < 2) return nullptr;
+
+    // As with Entity, concurrent callers may each fit the curve; the
+    // results are identical
+    std::shared_ptr<const geometry::BSplineCurve2D> curve =
+        std::atomic_load(&store->m_splines[index]);
+    if (!curve) {
+        curve = std::make_shared<const geometry::BSplineCurve2D>(
+            geometry::BSplineCurve2D::fromCatmullRom(points.data(), points.size()));
+        std::atomic_store(&store->m_splines[index], curve);
+    }
+    return curve;
+}
+
+Entity EntityView::toEntity() const
+{
+    return store->entity(index);
+}
+
+// =====================================================================
+//  EntityStore — Building
+// =====================================================================
+
+EntityStore::EntityStore(const std::vector<Entity>& entities)
+{
+    size_t pointCount = 0;
+    for (const Entity& e : entities) pointCount += e.points.size();
+    reserve(entities.size(), pointCount);
+    assign(entities.begin(), entities.end());
+}
+
+int EntityStore::append(const Entity& entity)
+{
+    int index = static_cast<int>(m_ids.size());
+
+    uint8_t flags = 0;
+    if (entity.isConstruction) flags |= FlagConstruction;
+    if (entity.constrained)    flags |= FlagConstrained;
+    if (entity.arcFlipped)     flags |= FlagArcFlipped;
+    if (entity.fontBold)       flags |= FlagFontBold;
+    if (entity.fontItalic)     flags |= FlagFontItalic;
+
+    m_ids.push_back(entity.id);
+    m_types.push_back(entity.type);
+    m_flags.push_back(flags);
+    m_pointBegin.push_back(static_cast<uint32_t>(m_points.size()));
+    m_pointCount.push_back(static_cast<uint32_t>(entity.points.size()));
+    m_radius.push_back(entity.radius);
+    m_startAngle.push_back(entity.startAngle);
+    m_sweepAngle.push_back(entity.sweepAngle);
+    m_sides.push_back(entity.sides);
+    m_majorRadius.push_back(entity.majorRadius);
+    m_minorRadius.push_back(entity.minorRadius);
+    m_groupIds.push_back(entity.groupId);
+    m_splines.push_back(entity.splineCurve());
+
+    m_points.insert(m_points.end(), entity.points.begin(), entity.points.end());
+
+    // Text attributes only exist for text entities (or entities that
+    // carry non-default text values, so round trips stay exact)
+    bool hasText = entity.type == EntityType::Text || !entity.text.empty() ||
+                   !entity.fontFamily.empty() || entity.fontSize != 12.0 ||
+                   entity.textRotation != 0.0;
+    if (hasText) {
+        TextAttributes attrs;
+        attrs.text = intern(entity.text);
+        attrs.fontFamily = intern(entity.fontFamily);
+        attrs.fontSize = entity.fontSize;
+        attrs.rotation = entity.textRotation;
+        m_textSlot.push_back(static_cast<int32_t>(m_text.size()));
+        m_text.push_back(attrs);
+    } else {
+        m_textSlot.push_back(-1);
+    }
+
+    m_idIndexValid = false;
+    return index;
+}
+
+void EntityStore::clear()
+{
+    m_ids.clear();
+    m_types.clear();
+    m_flags.clear();
+    m_pointBegin.clear();
+    m_pointCount.clear();
+    m_radius.clear();
+    m_startAngle.clear();
+    m_sweepAngle.clear();
+    m_sides.clear();
+    m_majorRadius.clear();
+    m_minorRadius.clear();
+    m_groupIds.clear();
+    m_textSlot.clear();
+    m_splines.clear();
+
+    m_points.clear();
+    m_text.clear();
+    m_strings.resize(1);
+    m_stringIndex.clear();
+    m_idIndex.clear();
+    m_idIndexValid = false;
+}
+
+void EntityStore::reserve(size_t entityCount, size_t pointCount)
+{
+    m_ids.reserve(entityCount);
+    m_types.reserve(entityCount);
+    m_flags.reserve(entityCount);
+    m_pointBegin.reserve(entityCount);
+    m_pointCount.reserve(entityCount);
+    m_radius.reserve(entityCount);
+    m_startAngle.reserve(entityCount);
+    m_sweepAngle.reserve(entityCount);
+    m_sides.reserve(entityCount);
+    m_majorRadius.reserve(entityCount);
+    m_minorRadius.reserve(entityCount);
+    m_groupIds.reserve(entityCount);
+    m_textSlot.reserve(entityCount);
+    m_splines.reserve(entityCount);
+    m_points.reserve(pointCount);
+}
+
+uint32_t EntityStore::intern(const std::string& s)
+{
+    if (s.empty()) return 0;
+
+    auto it = m_stringIndex.find(s);
+    if (it != m_stringIndex.end()) return it->second;
+
+    uint32_t index = static_cast<uint32_t>(m_strings.size());
+    m_strings.push_back(s);
+    m_stringIndex.emplace(s, index);
+    return index;
+}
+
+// =====================================================================
+//  EntityStore — Access
+// =====================================================================
+
+EntityView EntityStore::view(int index) const
+{
+    EntityView v;
+    v.id = m_ids[index];
+    v.type = m_types[index];
+    v.points = points(index);
+    v.radius = m_radius[index];
+    v.startAngle = m_startAngle[index];
+    v.sweepAngle = m_sweepAngle[index];
+    v.sides = m_sides[index];
+    v.majorRadius = m_majorRadius[index];
+    v.minorRadius = m_minorRadius[index];
+    v.arcFlipped = (m_flags[index] & FlagArcFlipped) != 0;
+    v.isConstruction = (m_flags[index] & FlagConstruction) != 0;
+    v.constrained = (m_flags[index] & FlagConstrained) != 0;
+    v.groupId = m_groupIds[index];
+    v.store = this;
+    v.index = index;
+    return v;
+}
+
+int EntityStore::indexOf(int id) const
+{
+    if (!m_idIndexValid) {
+        m_idIndex.clear();
+        m_idIndex.reserve(m_ids.size());
+        for (int i = 0; i < static_cast<int>(m_ids.size()); ++i) {
+            m_idIndex[m_ids[i]] = i;
+        }
+        m_idIndexValid = true;
+    }
+
+    auto it = m_idIndex.find(id);
+    return it != m_idIndex.end() ? it->second : -1;
+}
+
+PointSpan EntityStore::points(int index) const
+{
+    return PointSpan(m_points.data() + m_pointBegin[index], m_pointCount[index]);
+}
+
+void EntityStore::setPoint(int index, int pointIndex, const Point2D& p)
+{
+    if (pointIndex < 0 || static_cast<uint32_t>(pointIndex) >= m_pointCount[index]) return;
+    m_points[m_pointBegin[index] + pointIndex] = p;
+    m_splines[index].reset();
+}
+
+// =====================================================================
+//  EntityStore — Conversion
+// =====================================================================
+
+Entity EntityStore::entity(int index) const
+{
+    Entity e;
+    e.id = m_ids[index];
+    e.type = m_types[index];
+
+    PointSpan pts = points(index);
+    e.points.assign(pts.begin(), pts.end());
+
+    e.radius = m_radius[index];
+    e.startAngle = m_startAngle[index];
+    e.sweepAngle = m_sweepAngle[index];
+    e.sides = m_sides[index];
+    e.majorRadius = m_majorRadius[index];
+    e.minorRadius = m_minorRadius[index];
+
+    uint8_t flags = m_flags[index];
+    e.isConstruction = (flags & FlagConstruction) != 0;
+    e.constrained = (flags & FlagConstrained) != 0;
+    e.arcFlipped = (flags & FlagArcFlipped) != 0;
+    e.fontBold = (flags & FlagFontBold) != 0;
+    e.fontItalic = (flags & FlagFontItalic) != 0;
+    e.groupId = m_groupIds[index];
+
+    int32_t slot = m_textSlot[index];
+    if (slot >= 0) {
+        const TextAttributes& attrs = m_text[slot];
+        e.text = m_strings[attrs.text];
+        e.fontFamily = m_strings[attrs.fontFamily];
+        e.fontSize = attrs.fontSize;
+        e.textRotation = attrs.rotation;
+    }
+    return e;
+}
+
+std::vector<Entity> EntityStore::toEntities() const
+{
+    std::vector<Entity> result;
+    result.reserve(size());
+    for (int i = 0; i < static_cast<int>(size()); ++i) {
+        result.push_back(entity(i));
+    }
+    return result;
+}
+
+// =====================================================================
+//  EntityStore — Diagnostics
+// =====================================================================
+
+size_t EntityStore::memoryUsage() const
+{
+    size_t bytes = 0;
+    bytes += m_ids.capacity() * sizeof(int);
+    bytes += m_types.capacity() * sizeof(EntityType);
+    bytes += m_flags.capacity() * sizeof(uint8_t);
+    bytes += m_pointBegin.capacity() * sizeof(uint32_t);
+    bytes += m_pointCount.capacity() * sizeof(uint32_t);
+    bytes += m_radius.capacity() * sizeof(double);
+    bytes += m_startAngle.capacity() * sizeof(double);
+    bytes += m_sweepAngle.capacity() * sizeof(double);
+    bytes += m_sides.capacity() * sizeof(int);
+    bytes += m_majorRadius.capacity() * sizeof(double);
+    bytes += m_minorRadius.capacity() * sizeof(double);
+    bytes += m_groupIds.capacity() * sizeof(int);
+    bytes += m_textSlot.capacity() * sizeof(int32_t);
+    bytes += m_splines.capacity() * sizeof(std::shared_ptr<const geometry::BSplineCurve2D>);
+    bytes += m_points.capacity() * sizeof(Point2D);
+    bytes += m_text.capacity() * sizeof(TextAttributes);
+
+    // Interned strings, plus the hash keys that index them
+    for (const std::string& s : m_strings) {
+        bytes += sizeof(std::string) + (s.capacity() > 15 ? s.capacity() : 0);
+    }
+    bytes += m_stringIndex.size() * (sizeof(std::string) + sizeof(uint32_t) + 2 * sizeof(void*));
+    bytes += m_idIndex.size() * (2 * sizeof(int) + 2 * sizeof(void*));
+    return bytes;
+}
+
+}  // namespace sketch
+}  // namespace hobbycad
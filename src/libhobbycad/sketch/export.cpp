@@ -9,6 +9,8 @@
 
 #include <hobbycad/sketch/export.h>
 #include <hobbycad/sketch/queries.h>
+#include <hobbycad/sketch/text.h>
+#include <hobbycad/geometry/spline.h>
 #include <hobbycad/geometry/types.h>
 #include <hobbycad/format.h>
 
@@ -131,15 +133,17 @@ std::string entityToSVGPath(const Entity& entity, double scale)
         break;
 
     case EntityType::Spline:
-        // Approximate as polyline
-        if (!entity.points.empty()) {
+        // Exact: the spline is a chain of cubic Bézier segments
+        if (auto curve = entity.splineCurve()) {
             path = hobbycad::format("M %g %g",
                                     entity.points[0].x * scale,
                                     -entity.points[0].y * scale);
-            for (size_t i = 1; i < entity.points.size(); ++i) {
-                path += hobbycad::format(" L %g %g",
-                                         entity.points[i].x * scale,
-                                         -entity.points[i].y * scale);
+            for (const std::vector<Point2D>& seg : curve->bezierSegments()) {
+                if (seg.size() != 4) continue;
+                path += hobbycad::format(" C %g %g %g %g %g %g",
+                                         seg[1].x * scale, -seg[1].y * scale,
+                                         seg[2].x * scale, -seg[2].y * scale,
+                                         seg[3].x * scale, -seg[3].y * scale);
             }
         }
         break;
@@ -169,6 +173,40 @@ std::string entityToSVGPath(const Entity& entity, double scale)
     return path;
 }
 
+/// Path data for laid-out text: one closed subpath per glyph contour,
+/// keeping the Bézier segments
+std::string textOutlineToSVGPath(const TextOutline& outline, double scale)
+{
+    std::string path;
+    for (const OutlineContour& contour : outline.contours) {
+        if (contour.segments.empty()) continue;
+
+        const Point2D& first = contour.segments.front().start;
+        path += hobbycad::format("%sM %g %g", path.empty() ? "" : " ",
+                                 first.x * scale, -first.y * scale);
+        for (const OutlineSegment& seg : contour.segments) {
+            switch (seg.type) {
+            case OutlineSegmentType::Line:
+                path += hobbycad::format(" L %g %g", seg.end.x * scale, -seg.end.y * scale);
+                break;
+            case OutlineSegmentType::Quadratic:
+                path += hobbycad::format(" Q %g %g %g %g",
+                                         seg.control1.x * scale, -seg.control1.y * scale,
+                                         seg.end.x * scale, -seg.end.y * scale);
+                break;
+            case OutlineSegmentType::Cubic:
+                path += hobbycad::format(" C %g %g %g %g %g %g",
+                                         seg.control1.x * scale, -seg.control1.y * scale,
+                                         seg.control2.x * scale, -seg.control2.y * scale,
+                                         seg.end.x * scale, -seg.end.y * scale);
+                break;
+            }
+        }
+        path += " Z";
+    }
+    return path;
+}
+
 // Simple XML/HTML escape for text content
 std::string htmlEscape(const std::string& s)
 {
@@ -194,8 +232,23 @@ std::string sketchToSVG(
     const std::vector<Constraint>& constraints,
     const SVGExportOptions& options)
 {
+    // Lay out text first so the outlines count toward the bounds
+    std::vector<TextOutline> textOutlines(entities.size());
+    if (options.textAsOutlines) {
+        for (size_t i = 0; i < entities.size(); ++i) {
+            if (entities[i].type == EntityType::Text) {
+                textOutlines[i] = textOutline(entities[i]);
+            }
+        }
+    }
+
     // Calculate bounds
     geometry::BoundingBox bounds = sketchBounds(entities);
+    for (const TextOutline& outline : textOutlines) {
+        if (outline.success && outline.bounds.valid) {
+            bounds.include(outline.bounds);
+        }
+    }
     if (!bounds.valid) {
         bounds = geometry::BoundingBox(0, 0, 100, 100);
     }
@@ -235,9 +288,21 @@ std::string sketchToSVG(
     out << hobbycad::format("  <g transform=\"translate(%g %g)\">\n", offsetX, offsetY);
 
     // Entities
-    for (const Entity& entity : entities) {
+    for (size_t i = 0; i < entities.size(); ++i) {
+        const Entity& entity = entities[i];
         std::string className = entity.isConstruction ? "entity construction" : "entity";
 
+        // Text laid out as glyph outlines; falls back to <text> when
+        // no font is available
+        if (textOutlines[i].success) {
+            std::string pathData = textOutlineToSVGPath(textOutlines[i], scale);
+            if (!pathData.empty()) {
+                out << hobbycad::format("    <path class=\"%s\" fill-rule=\"nonzero\" d=\"%s\"/>\n",
+                                        className.c_str(), pathData.c_str());
+            }
+            continue;
+        }
+
         // Handle text entities separately
         if (entity.type == EntityType::Text && !entity.points.empty()) {
             double x = entity.points[0].x * scale;
@@ -420,10 +485,34 @@ void writeDXFEntity(std::ostream& out, const Entity& entity, const DXFExportOpti
         }
         break;
 
+    case EntityType::Spline:
+        // Exact SPLINE with the kernel's knots and control points
+        if (auto curve = entity.splineCurve()) {
+            const std::vector<double>& knots = curve->knots();
+            const std::vector<Point2D>& poles = curve->poles();
+            out << "0\nSPLINE\n";
+            out << "8\n" << layer << "\n";
+            out << "62\n" << color << "\n";
+            out << "210\n0\n220\n0\n230\n1\n";  // Normal
+            out << "70\n8\n";  // Planar
+            out << "71\n" << curve->degree() << "\n";
+            out << "72\n" << knots.size() << "\n";
+            out << "73\n" << poles.size() << "\n";
+            out << "74\n0\n";
+            for (double k : knots) {
+                out << "40\n" << k << "\n";
+            }
+            for (const Point2D& p : poles) {
+                out << "10\n" << p.x << "\n";
+                out << "20\n" << p.y << "\n";
+                out << "30\n0\n";
+            }
+        }
+        break;
+
     case EntityType::Rectangle:
     case EntityType::Polygon:
     case EntityType::Slot:
-    case EntityType::Spline:
         // Use LWPOLYLINE for complex shapes
         if (options.usePolylines) {
             std::vector<Point2D> points = tessellate(entity, 0.5);
@@ -442,6 +531,25 @@ void writeDXFEntity(std::ostream& out, const Entity& entity, const DXFExportOpti
         break;
 
     case EntityType::Text:
+        // Glyph outlines as closed polylines; falls back to TEXT when
+        // no font is available
+        if (options.textAsOutlines) {
+            TextOutline outline = textOutline(entity);
+            if (outline.success) {
+                for (const std::vector<Point2D>& polygon : outlineToPolygons(outline)) {
+                    out << "0\nLWPOLYLINE\n";
+                    out << "8\n" << layer << "\n";
+                    out << "62\n" << color << "\n";
+                    out << "90\n" << polygon.size() << "\n";
+                    out << "70\n1\n";  // Closed polyline
+                    for (const Point2D& p : polygon) {
+                        out << "10\n" << p.x << "\n";
+                        out << "20\n" << p.y << "\n";
+                    }
+                }
+                break;
+            }
+        }
         if (!entity.points.empty()) {
             out << "0\nTEXT\n";
             out << "8\n" << layer << "\n";
@@ -1450,14 +1558,19 @@ std::vector<Entity> parseDXFLWPolyline(const std::vector<std::string>& lines, in
     return entities;
 }
 
-/// Parse a SPLINE entity (approximate as polyline)
+/// Parse a SPLINE entity.  A NURBS definition (control points, knots,
+/// weights) is evaluated exactly and sampled to within the tolerance;
+/// a fit-point-only spline becomes a spline through its fit points.
 std::vector<Entity> parseDXFSpline(const std::vector<std::string>& lines, int& lineIndex, int& nextId,
                                 double scale, const Point2D& offset, double tolerance)
 {
     std::vector<Entity> entities;
     std::vector<Point2D> controlPoints;
     std::vector<Point2D> fitPoints;
+    std::vector<double> knots;
+    std::vector<double> weights;
     int degree = 3;
+    double pendingX = 0;
     DXFPair pair;
 
     while (lineIndex < static_cast<int>(lines.size())) {
@@ -1469,49 +1582,53 @@ std::vector<Entity> parseDXFSpline(const std::vector<std::string>& lines, int& l
             break;
         }
 
-        static double tempX = 0, tempY = 0;
-        static bool isFitPoint = false;
-
         switch (pair.code) {
         case 71: degree = std::stoi(pair.value); break;
+        case 40: knots.push_back(std::stod(pair.value)); break;
+        case 41: weights.push_back(std::stod(pair.value)); break;
         case 10:  // Control point X
-            tempX = std::stod(pair.value) * scale + offset.x;
-            isFitPoint = false;
+        case 11:  // Fit point X
+            pendingX = std::stod(pair.value) * scale + offset.x;
             break;
         case 20:  // Control point Y
-            tempY = std::stod(pair.value) * scale + offset.y;
-            if (!isFitPoint) {
-                controlPoints.push_back(Point2D(tempX, tempY));
-            }
-            break;
-        case 11:  // Fit point X
-            tempX = std::stod(pair.value) * scale + offset.x;
-            isFitPoint = true;
+            controlPoints.push_back(Point2D(pendingX, std::stod(pair.value) * scale + offset.y));
             break;
         case 21:  // Fit point Y
-            tempY = std::stod(pair.value) * scale + offset.y;
-            fitPoints.push_back(Point2D(tempX, tempY));
+            fitPoints.push_back(Point2D(pendingX, std::stod(pair.value) * scale + offset.y));
             break;
         }
     }
 
-    // Use fit points if available, otherwise control points
-    const std::vector<Point2D>& points = fitPoints.empty() ? controlPoints : fitPoints;
+    Entity spline;
+    spline.type = EntityType::Spline;
+
+    if (controlPoints.size() >= 2) {
+        // Weights are only meaningful when every control point has one;
+        // a missing or short knot vector is replaced by a clamped
+        // uniform one
+        degree = std::clamp(degree, 1, std::min(geometry::MAX_SPLINE_DEGREE,
+                                                static_cast<int>(controlPoints.size()) - 1));
+        if (weights.size() != controlPoints.size()) weights.clear();
+        if (knots.size() != controlPoints.size() + degree + 1) {
+            int spans = static_cast<int>(controlPoints.size()) - degree;
+            knots.assign(degree + 1, 0.0);
+            for (int i = 1; i < spans; ++i) knots.push_back(i);
+            knots.insert(knots.end(), degree + 1, static_cast<double>(spans));
+        }
 
-    if (points.size() >= 2) {
-        // Create as a spline entity if we have control points
-        if (!controlPoints.empty()) {
-            Entity spline;
-            spline.id = nextId++;
-            spline.type = EntityType::Spline;
-            spline.points = controlPoints;
-            entities.push_back(spline);
+        geometry::BSplineCurve2D curve(degree, controlPoints, knots, weights);
+        if (curve.isValid()) {
+            spline.points = curve.tessellate(tolerance);
         } else {
-            // Approximate as line segments
-            for (size_t i = 0; i < points.size() - 1; ++i) {
-                entities.push_back(createLine(nextId++, points[i], points[i + 1]));
-            }
+            spline.points = controlPoints;
         }
+    } else if (fitPoints.size() >= 2) {
+        spline.points = fitPoints;
+    }
+
+    if (spline.points.size() >= 2) {
+        spline.id = nextId++;
+        entities.push_back(spline);
     }
 
     return entities;
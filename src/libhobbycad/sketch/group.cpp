@@ -5,10 +5,17 @@
 #include <hobbycad/sketch/group.h>
 
 #include <algorithm>
+#include <utility>
 
 namespace hobbycad {
 namespace sketch {
 
+namespace {
+
+const std::unordered_set<int> kEmptyClosure;
+
+}  // namespace
+
 // =====================================================================
 //  GroupManager Implementation
 // =====================================================================
@@ -18,69 +25,101 @@ int GroupManager::createGroup(const std::string& name)
     Group group;
     group.id = m_nextId++;
     group.name = name.empty() ? ("Group " + std::to_string(group.id)) : name;
+
+    int slot = static_cast<int>(m_groups.size());
     m_groups.push_back(group);
+    m_slotById[group.id] = slot;
+
+    // A new top-level group extends the numbering without renumbering
+    Hierarchy& h = m_hierarchy;
+    if (h.valid) {
+        h.enter.push_back(h.clock++);
+        h.exit.push_back(h.clock++);
+        h.depth.push_back(0);
+        for (std::vector<int>& level : h.up) {
+            level.push_back(-1);
+        }
+    }
     return group.id;
 }
 
 void GroupManager::deleteGroup(int groupId, bool deleteChildren)
 {
-    Group* group = groupById(groupId);
-    if (!group) return;
+    int slot = slotOf(groupId);
+    if (slot < 0) return;
 
-    int parentId = group->parentGroupId;
+    int parentId = m_groups[slot].parentGroupId;
+    invalidateClosures(groupId);
 
+    // Groups to remove: just this one, or its whole subtree
+    std::vector<int> removed{groupId};
     if (deleteChildren) {
-        // Recursively delete all child groups
-        for (int childId : group->childGroupIds) {
-            deleteGroup(childId, true);
+        for (size_t i = 0; i < removed.size(); ++i) {
+            const Group& g = m_groups[slotOf(removed[i])];
+            for (int childId : g.childGroupIds) {
+                if (slotOf(childId) >= 0) removed.push_back(childId);
+            }
         }
     } else {
         // Move child groups to parent (or make them top-level)
-        for (int childId : group->childGroupIds) {
+        Group* parent = parentId >= 0 ? groupById(parentId) : nullptr;
+        for (int childId : m_groups[slot].childGroupIds) {
             Group* child = groupById(childId);
-            if (child) {
-                child->parentGroupId = parentId;
-                if (parentId >= 0) {
-                    Group* parent = groupById(parentId);
-                    if (parent && !hobbycad::contains(parent->childGroupIds, childId)) {
-                        parent->childGroupIds.push_back(childId);
-                    }
-                }
+            if (!child) continue;
+            child->parentGroupId = parentId;
+            if (parent && !hobbycad::contains(parent->childGroupIds, childId)) {
+                parent->childGroupIds.push_back(childId);
             }
         }
     }
 
     // Remove from parent's child list
-    if (parentId >= 0) {
-        Group* parent = groupById(parentId);
-        if (parent) {
-            hobbycad::removeAll(parent->childGroupIds, groupId);
-        }
+    if (Group* parent = parentId >= 0 ? groupById(parentId) : nullptr) {
+        hobbycad::removeAll(parent->childGroupIds, groupId);
     }
 
-    // Remove the group itself
-    for (int i = 0; i < static_cast<int>(m_groups.size()); ++i) {
-        if (m_groups[i].id == groupId) {
-            m_groups.erase(m_groups.begin() + i);
-            break;
+    // Drop the removed groups from the indexes
+    std::unordered_set<int> removedSet(removed.begin(), removed.end());
+    for (int id : removed) {
+        for (int entityId : m_groups[slotOf(id)].entityIds) {
+            auto it = m_groupsByEntity.find(entityId);
+            if (it == m_groupsByEntity.end()) continue;
+            hobbycad::removeAll(it->second, id);
+            if (it->second.empty()) m_groupsByEntity.erase(it);
         }
+        m_closures.erase(id);
     }
+
+    m_groups.erase(std::remove_if(m_groups.begin(), m_groups.end(),
+                                  [&](const Group& g) { return removedSet.count(g.id) > 0; }),
+                   m_groups.end());
+    rebuildSlots();
+    m_hierarchy.valid = false;
 }
 
 void GroupManager::addEntityToGroup(int entityId, int groupId)
 {
     Group* group = groupById(groupId);
-    if (group && !hobbycad::contains(group->entityIds, entityId)) {
-        group->entityIds.push_back(entityId);
-    }
+    if (!group) return;
+
+    std::vector<int>& owners = m_groupsByEntity[entityId];
+    if (hobbycad::contains(owners, groupId)) return;
+
+    owners.push_back(groupId);
+    group->entityIds.push_back(entityId);
+    invalidateClosures(groupId);
 }
 
 void GroupManager::removeEntityFromGroup(int entityId, int groupId)
 {
-    Group* group = groupById(groupId);
-    if (group) {
-        hobbycad::removeAll(group->entityIds, entityId);
-    }
+    auto it = m_groupsByEntity.find(entityId);
+    if (it == m_groupsByEntity.end() || !hobbycad::contains(it->second, groupId)) return;
+
+    hobbycad::removeAll(it->second, groupId);
+    if (it->second.empty()) m_groupsByEntity.erase(it);
+
+    hobbycad::removeAll(m_groups[slotOf(groupId)].entityIds, entityId);
+    invalidateClosures(groupId);
 }
 
 bool GroupManager::addGroupToGroup(int childGroupId, int parentGroupId)
@@ -96,6 +135,7 @@ bool GroupManager::addGroupToGroup(int childGroupId, int parentGroupId)
     if (child->parentGroupId >= 0) {
         Group* oldParent = groupById(child->parentGroupId);
         if (oldParent) {
+            invalidateClosures(oldParent->id);
             hobbycad::removeAll(oldParent->childGroupIds, childGroupId);
         }
     }
@@ -105,6 +145,8 @@ bool GroupManager::addGroupToGroup(int childGroupId, int parentGroupId)
     if (!hobbycad::contains(parent->childGroupIds, childGroupId)) {
         parent->childGroupIds.push_back(childGroupId);
     }
+    invalidateClosures(parentGroupId);
+    m_hierarchy.valid = false;
 
     return true;
 }
@@ -116,25 +158,23 @@ void GroupManager::ungroupFromParent(int groupId)
 
     Group* parent = groupById(group->parentGroupId);
     if (parent) {
+        invalidateClosures(parent->id);
         hobbycad::removeAll(parent->childGroupIds, groupId);
     }
     group->parentGroupId = -1;
+    m_hierarchy.valid = false;
 }
 
 Group* GroupManager::groupById(int id)
 {
-    for (auto& g : m_groups) {
-        if (g.id == id) return &g;
-    }
-    return nullptr;
+    int slot = slotOf(id);
+    return slot >= 0 ? &m_groups[slot] : nullptr;
 }
 
 const Group* GroupManager::groupById(int id) const
 {
-    for (const auto& g : m_groups) {
-        if (g.id == id) return &g;
-    }
-    return nullptr;
+    int slot = slotOf(id);
+    return slot >= 0 ? &m_groups[slot] : nullptr;
 }
 
 std::vector<int> GroupManager::topLevelGroupIds() const
@@ -150,51 +190,238 @@ std::vector<int> GroupManager::topLevelGroupIds() const
 
 std::unordered_set<int> GroupManager::allEntityIds(int groupId) const
 {
-    std::unordered_set<int> result;
-    const Group* group = groupById(groupId);
-    if (!group) return result;
+    return entityClosure(groupId);
+}
 
-    // Add direct entities
-    for (int entityId : group->entityIds) {
-        result.insert(entityId);
-    }
+const std::unordered_set<int>& GroupManager::entityClosure(int groupId) const
+{
+    int slot = slotOf(groupId);
+    if (slot < 0) return kEmptyClosure;
+
+    auto cached = m_closures.find(groupId);
+    if (cached != m_closures.end()) return cached->second;
+
+    // Walk the subtree without recursion (imported hierarchies can be
+    // thousands deep), reusing any child closure that is still cached
+    std::unordered_set<int> closure;
+    std::vector<int> pending{slot};
+    while (!pending.empty()) {
+        const Group& g = m_groups[pending.back()];
+        pending.pop_back();
+
+        if (g.id != groupId) {
+            auto child = m_closures.find(g.id);
+            if (child != m_closures.end()) {
+                closure.insert(child->second.begin(), child->second.end());
+                continue;
+            }
+        }
 
-    // Recursively add entities from child groups
-    for (int childId : group->childGroupIds) {
-        auto childIds = allEntityIds(childId);
-        result.insert(childIds.begin(), childIds.end());
+        closure.insert(g.entityIds.begin(), g.entityIds.end());
+        for (int childId : g.childGroupIds) {
+            int childSlot = slotOf(childId);
+            if (childSlot >= 0) pending.push_back(childSlot);
+        }
     }
 
-    return result;
+    return m_closures.emplace(groupId, std::move(closure)).first->second;
 }
 
 std::vector<int> GroupManager::groupsContainingEntity(int entityId) const
 {
-    std::vector<int> result;
-    for (const auto& g : m_groups) {
-        if (hobbycad::contains(g.entityIds, entityId)) {
-            result.push_back(g.id);
-        }
-    }
+    auto it = m_groupsByEntity.find(entityId);
+    if (it == m_groupsByEntity.end()) return {};
+
+    // Report in group order, like a scan over groups() would
+    std::vector<int> result = it->second;
+    std::sort(result.begin(), result.end(),
+              [this](int a, int b) { return slotOf(a) < slotOf(b); });
     return result;
 }
 
 bool GroupManager::wouldCreateCycle(int childId, int parentId) const
 {
-    // Check if parentId is a descendant of childId
+    // Check if parentId is a descendant of childId.  While the
+    // hierarchy numbering is stale (e.g. during a bulk import that
+    // nests groups one by one) a parent walk is cheaper than renumbering.
+    if (!m_hierarchy.valid) {
+        return walkIsAncestorOf(childId, parentId);
+    }
     return isAncestorOf(childId, parentId);
 }
 
 void GroupManager::clear()
 {
     m_groups.clear();
+    m_slotById.clear();
+    m_groupsByEntity.clear();
+    m_closures.clear();
+    m_hierarchy = Hierarchy();
     m_nextId = 1;
 }
 
+// =====================================================================
+//  GroupManager — Hierarchy Queries
+// =====================================================================
+
 bool GroupManager::isAncestorOf(int ancestorId, int descendantId) const
+{
+    int a = slotOf(ancestorId);
+    int d = slotOf(descendantId);
+    if (a < 0 || d < 0 || a == d) return false;
+
+    const Hierarchy& h = hierarchy();
+    return h.enter[a] < h.enter[d] && h.exit[d] < h.exit[a];
+}
+
+int GroupManager::groupDepth(int groupId) const
+{
+    int slot = slotOf(groupId);
+    return slot >= 0 ? hierarchy().depth[slot] : 0;
+}
+
+std::vector<int> GroupManager::groupPath(int groupId) const
+{
+    int slot = slotOf(groupId);
+    if (slot < 0) return {};
+
+    const Hierarchy& h = hierarchy();
+    std::vector<int> path(h.depth[slot] + 1);
+    for (int i = static_cast<int>(path.size()) - 1; i >= 0 && slot >= 0; --i) {
+        path[i] = m_groups[slot].id;
+        slot = h.up[0][slot];
+    }
+    return path;
+}
+
+int GroupManager::commonAncestor(int groupId1, int groupId2) const
+{
+    int a = slotOf(groupId1);
+    int b = slotOf(groupId2);
+    if (a < 0 || b < 0) return -1;
+
+    const Hierarchy& h = hierarchy();
+    if (h.depth[a] < h.depth[b]) std::swap(a, b);
+
+    // Lift the deeper group to the other's depth, then lift both to
+    // just below their lowest common ancestor
+    int levels = static_cast<int>(h.up.size());
+    int diff = h.depth[a] - h.depth[b];
+    for (int k = 0; diff > 0; ++k, diff >>= 1) {
+        if (diff & 1) a = h.up[k][a];
+    }
+    if (a == b) return m_groups[a].id;
+
+    for (int k = levels - 1; k >= 0; --k) {
+        if (h.up[k][a] != h.up[k][b]) {
+            a = h.up[k][a];
+            b = h.up[k][b];
+        }
+    }
+    int parent = h.up[0][a];
+    return parent >= 0 ? m_groups[parent].id : -1;
+}
+
+// =====================================================================
+//  GroupManager — Indexes
+// =====================================================================
+
+int GroupManager::slotOf(int id) const
+{
+    auto it = m_slotById.find(id);
+    return it != m_slotById.end() ? it->second : -1;
+}
+
+void GroupManager::rebuildSlots()
+{
+    m_slotById.clear();
+    m_slotById.reserve(m_groups.size());
+    for (int i = 0; i < static_cast<int>(m_groups.size()); ++i) {
+        m_slotById[m_groups[i].id] = i;
+    }
+}
+
+void GroupManager::invalidateClosures(int groupId)
+{
+    // Only the group and its ancestors include its members; the guard
+    // stops on a corrupted (cyclic) parent chain
+    size_t guard = m_groups.size();
+    for (int slot = slotOf(groupId); slot >= 0 && guard > 0; --guard) {
+        m_closures.erase(m_groups[slot].id);
+        slot = slotOf(m_groups[slot].parentGroupId);
+    }
+}
+
+const GroupManager::Hierarchy& GroupManager::hierarchy() const
+{
+    if (!m_hierarchy.valid) rebuildHierarchy();
+    return m_hierarchy;
+}
+
+void GroupManager::rebuildHierarchy() const
+{
+    Hierarchy& h = m_hierarchy;
+    int n = static_cast<int>(m_groups.size());
+    h.enter.assign(n, -1);
+    h.exit.assign(n, -1);
+    h.depth.assign(n, 0);
+    std::vector<int> parent(n, -1);
+    h.clock = 0;
+
+    // Iterative DFS from every root.  Groups whose parent is missing
+    // count as roots; the second pass picks up anything left over.
+    int maxDepth = 0;
+    std::vector<std::pair<int, size_t>> stack;   // slot, next child
+    auto visit = [&](int root) {
+        h.enter[root] = h.clock++;
+        stack.emplace_back(root, 0);
+        while (!stack.empty()) {
+            int slot = stack.back().first;
+            size_t next = stack.back().second;
+            const std::vector<int>& children = m_groups[slot].childGroupIds;
+            if (next < children.size()) {
+                stack.back().second++;
+                int child = slotOf(children[next]);
+                if (child < 0 || h.enter[child] >= 0) continue;
+                parent[child] = slot;
+                h.depth[child] = h.depth[slot] + 1;
+                maxDepth = std::max(maxDepth, h.depth[child]);
+                h.enter[child] = h.clock++;
+                stack.emplace_back(child, 0);
+            } else {
+                h.exit[slot] = h.clock++;
+                stack.pop_back();
+            }
+        }
+    };
+
+    for (int i = 0; i < n; ++i) {
+        if (h.enter[i] < 0 && slotOf(m_groups[i].parentGroupId) < 0) visit(i);
+    }
+    for (int i = 0; i < n; ++i) {
+        if (h.enter[i] < 0) visit(i);
+    }
+
+    // Ancestor jump table for logarithmic lifting
+    int levels = 1;
+    while ((1 << levels) <= maxDepth) ++levels;
+    h.up.assign(levels, std::vector<int>());
+    h.up[0] = std::move(parent);
+    for (int k = 1; k < levels; ++k) {
+        h.up[k].resize(n);
+        for (int i = 0; i < n; ++i) {
+            int mid = h.up[k - 1][i];
+            h.up[k][i] = mid < 0 ? -1 : h.up[k - 1][mid];
+        }
+    }
+    h.valid = true;
+}
+
+bool GroupManager::walkIsAncestorOf(int ancestorId, int descendantId) const
 {
     const Group* descendant = groupById(descendantId);
-    while (descendant && descendant->parentGroupId >= 0) {
+    size_t guard = m_groups.size();
+    while (descendant && descendant->parentGroupId >= 0 && guard-- > 0) {
         if (descendant->parentGroupId == ancestorId) {
             return true;
         }
@@ -209,42 +436,17 @@ bool GroupManager::isAncestorOf(int ancestorId, int descendantId) const
 
 int groupDepth(const GroupManager& manager, int groupId)
 {
-    int depth = 0;
-    const Group* group = manager.groupById(groupId);
-    while (group && group->parentGroupId >= 0) {
-        depth++;
-        group = manager.groupById(group->parentGroupId);
-    }
-    return depth;
+    return manager.groupDepth(groupId);
 }
 
 std::vector<int> groupPath(const GroupManager& manager, int groupId)
 {
-    std::vector<int> path;
-    const Group* group = manager.groupById(groupId);
-    while (group) {
-        path.insert(path.begin(), group->id);
-        if (group->parentGroupId < 0) break;
-        group = manager.groupById(group->parentGroupId);
-    }
-    return path;
+    return manager.groupPath(groupId);
 }
 
 int commonAncestor(const GroupManager& manager, int groupId1, int groupId2)
 {
-    std::vector<int> path1 = groupPath(manager, groupId1);
-    std::vector<int> path2 = groupPath(manager, groupId2);
-
-    int common = -1;
-    int minLen = std::min(static_cast<int>(path1.size()), static_cast<int>(path2.size()));
-    for (int i = 0; i < minLen; ++i) {
-        if (path1[i] == path2[i]) {
-            common = path1[i];
-        } else {
-            break;
-        }
-    }
-    return common;
+    return manager.commonAncestor(groupId1, groupId2);
 }
 
 }  // namespace sketch
@@ -0,0 +1,888 @@
+// =====================================================================
+//  src/libhobbycad/sketch/lint.cpp — Sketch linting
+// =====================================================================
+//
+//  Each check hashes entities into a uniform grid keyed on the
+//  property two defective entities share, and only compares entities
+//  in neighbouring cells:
+//
+//    - Duplicates: bounding box center and size.  Each entity is
+//      compared with the entities kept so far, so a stack of copies
+//      costs one comparison per copy.
+//    - Overlaps: line direction and distance from a reference origin.
+//      Lines in connected cells are swept by their extent along the
+//      common direction.
+//    - Gaps: endpoint position, with one cell per gap tolerance.
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/sketch/lint.h>
+#include <hobbycad/sketch/undo.h>
+#include <hobbycad/geometry/utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace hobbycad {
+namespace sketch {
+
+using namespace geometry;
+
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+/// Collisions only cost a few extra comparisons
+std::int64_t cellKey(long long a, long long b, long long c = 0)
+{
+    return static_cast<std::int64_t>(a) * 73856093LL ^
+           static_cast<std::int64_t>(b) * 19349663LL ^
+           static_cast<std::int64_t>(c) * 83492791LL;
+}
+
+long long cellOf(double v, double cell)
+{
+    return static_cast<long long>(std::floor(v / cell));
+}
+
+/// Union-find whose roots are the lowest index of each set, so a set's
+/// root is its first member in sketch order
+struct DisjointSets {
+    explicit DisjointSets(size_t n) : parent(n) { std::iota(parent.begin(), parent.end(), 0); }
+
+    size_t find(size_t x)
+    {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    void unite(size_t a, size_t b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a != b) parent[std::max(a, b)] = std::min(a, b);
+    }
+
+    std::vector<size_t> parent;
+};
+
+// =====================================================================
+//  Geometric Deviation
+// =====================================================================
+
+/// Largest distance between corresponding points, optionally also
+/// trying the reverse order
+double sequenceDeviation(const std::vector<Point2D>& a, const std::vector<Point2D>& b,
+                         bool reversible, bool* reversed)
+{
+    if (a.empty() || a.size() != b.size()) return kInf;
+    const size_t n = a.size();
+    double forward = 0.0;
+    double backward = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        forward = std::max(forward, length(a[i] - b[i]));
+        backward = std::max(backward, length(a[i] - b[n - 1 - i]));
+    }
+    if (reversible && backward < forward) {
+        if (reversed) *reversed = true;
+        return backward;
+    }
+    return forward;
+}
+
+/// Largest distance between corresponding corners of two closed
+/// corner lists, over every starting corner and both directions
+double loopDeviation(const std::vector<Point2D>& a, const std::vector<Point2D>& b)
+{
+    if (a.empty() || a.size() != b.size()) return kInf;
+    const size_t n = a.size();
+    double best = kInf;
+    for (size_t shift = 0; shift < n; ++shift) {
+        double forward = 0.0;
+        double backward = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            forward = std::max(forward, length(a[i] - b[(i + shift) % n]));
+            backward = std::max(backward, length(a[i] - b[(shift + n - i) % n]));
+        }
+        best = std::min({best, forward, backward});
+    }
+    return best;
+}
+
+/// How far apart two entities are as geometry: the largest distance
+/// between corresponding defining points and sizes, or infinity if they
+/// cannot be duplicates.  Sets reversed when a line or spline matches
+/// with its points in the opposite order.
+double entityDeviation(const Entity& a, const Entity& b, bool* reversed = nullptr)
+{
+    if (reversed) *reversed = false;
+    if (a.type != b.type || a.isConstruction != b.isConstruction) return kInf;
+    if (a.points.empty() || a.points.size() != b.points.size()) return kInf;
+
+    switch (a.type) {
+    case EntityType::Point:
+        return length(a.points[0] - b.points[0]);
+
+    case EntityType::Line:
+    case EntityType::Spline:
+        return sequenceDeviation(a.points, b.points, true, reversed);
+
+    case EntityType::Circle:
+        return std::max(length(a.points[0] - b.points[0]), std::abs(a.radius - b.radius));
+
+    case EntityType::Arc: {
+        // The end points pin down the angles
+        std::vector<Point2D> ea = a.endpoints();
+        std::vector<Point2D> eb = b.endpoints();
+        return std::max({length(a.points[0] - b.points[0]), std::abs(a.radius - b.radius),
+                         length(ea[0] - eb[0]), length(ea[1] - eb[1])});
+    }
+
+    case EntityType::Rectangle:
+    case EntityType::Parallelogram:
+        return loopDeviation(a.points, b.points);
+
+    case EntityType::Polygon:
+        if (a.sides != b.sides) return kInf;
+        return std::max(length(a.points[0] - b.points[0]), std::abs(a.radius - b.radius));
+
+    case EntityType::Slot:
+        if (a.arcFlipped != b.arcFlipped) return kInf;
+        return std::max(sequenceDeviation(a.points, b.points, a.points.size() == 2, nullptr),
+                        std::abs(a.radius - b.radius));
+
+    case EntityType::Ellipse:
+        return std::max({sequenceDeviation(a.points, b.points, false, nullptr),
+                         std::abs(a.majorRadius - b.majorRadius),
+                         std::abs(a.minorRadius - b.minorRadius)});
+
+    case EntityType::Text:
+        if (a.text != b.text || a.fontFamily != b.fontFamily ||
+            a.fontBold != b.fontBold || a.fontItalic != b.fontItalic) {
+            return kInf;
+        }
+        return std::max({sequenceDeviation(a.points, b.points, false, nullptr),
+                         std::abs(a.fontSize - b.fontSize),
+                         std::abs(a.textRotation - b.textRotation)});
+
+    default:
+        return kInf;
+    }
+}
+
+// =====================================================================
+//  Duplicates
+// =====================================================================
+
+struct Duplicate {
+    size_t index = 0;       ///< Duplicate entity
+    size_t kept = 0;        ///< Entity it duplicates
+    double deviation = 0.0;
+    bool reversed = false;
+};
+
+/// Entities within the near tolerance of an earlier entity, in sketch
+/// order
+std::vector<Duplicate> findDuplicates(const std::vector<Entity>& entities,
+                                      const LintOptions& options)
+{
+    const double tolerance = std::max(options.nearTolerance, options.duplicateTolerance);
+    const double cell = std::max(tolerance, 1e-12);
+    // A box corner moves at most the tolerance, so the size moves at
+    // most 2√2 times it
+    const double sizeCell = 4.0 * cell;
+
+    std::unordered_map<std::int64_t, std::vector<size_t>> kept;
+    std::vector<Duplicate> result;
+
+    for (size_t i = 0; i < entities.size(); ++i) {
+        const Entity& e = entities[i];
+        if (e.type == EntityType::Dimension || e.points.empty()) continue;
+        BoundingBox box = e.boundingBox();
+        if (!box.valid) continue;
+
+        Point2D c = box.center();
+        long long cx = cellOf(c.x, cell);
+        long long cy = cellOf(c.y, cell);
+        long long cs = cellOf(std::hypot(box.width(), box.height()), sizeCell);
+
+        Duplicate best;
+        best.index = i;
+        best.deviation = kInf;
+        for (long long dx = -1; dx <= 1; ++dx) {
+            for (long long dy = -1; dy <= 1; ++dy) {
+                for (long long ds = -1; ds <= 1; ++ds) {
+                    auto it = kept.find(cellKey(cx + dx, cy + dy, cs + ds));
+                    if (it == kept.end()) continue;
+                    for (size_t j : it->second) {
+                        bool reversed = false;
+                        double d = entityDeviation(e, entities[j], &reversed);
+                        if (d <= tolerance && (d < best.deviation ||
+                                               (d == best.deviation && j < best.kept))) {
+                            best.kept = j;
+                            best.deviation = d;
+                            best.reversed = reversed;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (best.deviation <= tolerance) {
+            result.push_back(best);
+        } else {
+            kept[cellKey(cx, cy, cs)].push_back(i);
+        }
+    }
+    return result;
+}
+
+// =====================================================================
+//  Collinear Overlaps
+// =====================================================================
+
+struct OverlapGroup {
+    std::vector<size_t> lines;   ///< Entity indices, ascending
+    Point2D location;
+    double overlap = 0.0;
+};
+
+/// Groups of collinear lines that overlap by more than the near
+/// tolerance.  Duplicated lines are left to the duplicate check.
+std::vector<OverlapGroup> findOverlaps(const std::vector<Entity>& entities,
+                                       const LintOptions& options)
+{
+    const double tolerance = std::max(options.nearTolerance, options.duplicateTolerance);
+
+    struct LineInfo {
+        size_t index;
+        Point2D a;
+        Point2D b;
+        Point2D u;             ///< Unit direction with angle in (-90°, 90°]
+        long long angleCell;
+        long long offsetCell;
+    };
+
+    std::vector<LineInfo> lines;
+    BoundingBox extent;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        const Entity& e = entities[i];
+        if (e.type != EntityType::Line || e.points.size() < 2) continue;
+        if (length(e.points[1] - e.points[0]) <= tolerance) continue;
+        lines.push_back({i, e.points[0], e.points[1], Point2D(), 0, 0});
+        extent.include(e.points[0]);
+        extent.include(e.points[1]);
+    }
+    if (lines.size() < 2) return {};
+
+    // Offsets are measured from the middle of the lines so the offset
+    // error of a direction error stays small
+    const Point2D origin = extent.center();
+    double reach = 0.0;
+    for (const LineInfo& l : lines) {
+        reach = std::max({reach, length(l.a - origin), length(l.b - origin)});
+    }
+
+    const double angleCell = std::max(options.angleTolerance, 1e-12);
+    const long long angleCells = std::max(1LL, static_cast<long long>(std::ceil(M_PI / angleCell)));
+    const double offsetCell = std::max(tolerance + options.angleTolerance * reach, 1e-12);
+
+    std::unordered_map<std::int64_t, std::vector<size_t>> cells;
+    for (size_t k = 0; k < lines.size(); ++k) {
+        LineInfo& l = lines[k];
+        l.u = normalize(l.b - l.a);
+        if (l.u.x < 0.0 || (l.u.x == 0.0 && l.u.y < 0.0)) l.u = l.u * -1.0;
+        double angle = std::atan2(l.u.y, l.u.x) + M_PI / 2.0;
+        l.angleCell = std::clamp(static_cast<long long>(angle / angleCell), 0LL, angleCells - 1);
+        l.offsetCell = cellOf(cross(l.u, l.a - origin), offsetCell);
+        cells[cellKey(l.angleCell, l.offsetCell)].push_back(k);
+    }
+
+    // Cells neighbouring a cell.  Past ±90° the direction flips, and
+    // with it the sign of the offset.
+    auto neighbours = [&](long long ac, long long oc, std::vector<std::int64_t>& out) {
+        out.clear();
+        for (long long da = -1; da <= 1; ++da) {
+            long long a = ac + da;
+            bool wrapped = a < 0 || a >= angleCells;
+            if (wrapped) a = (a + angleCells) % angleCells;
+            for (long long d = -1; d <= 1; ++d) {
+                long long o = wrapped ? -oc - 1 + d : oc + d;
+                out.push_back(cellKey(a, o));
+            }
+        }
+    };
+
+    // Connected groups of occupied cells
+    std::unordered_set<std::int64_t> visitedCells;
+    std::vector<std::int64_t> around;
+    std::vector<OverlapGroup> groups;
+    DisjointSets sets(lines.size());
+    std::vector<double> groupOverlap(lines.size(), 0.0);
+    std::vector<Point2D> groupLocation(lines.size());
+
+    for (size_t start = 0; start < lines.size(); ++start) {
+        std::int64_t startKey = cellKey(lines[start].angleCell, lines[start].offsetCell);
+        if (!visitedCells.insert(startKey).second) continue;
+
+        std::vector<size_t> members;
+        std::vector<std::int64_t> stack = {startKey};
+        while (!stack.empty()) {
+            std::int64_t key = stack.back();
+            stack.pop_back();
+            const std::vector<size_t>& inCell = cells[key];
+            members.insert(members.end(), inCell.begin(), inCell.end());
+            const LineInfo& any = lines[inCell.front()];
+            neighbours(any.angleCell, any.offsetCell, around);
+            for (std::int64_t next : around) {
+                if (cells.count(next) && visitedCells.insert(next).second) stack.push_back(next);
+            }
+        }
+        if (members.size() < 2) continue;
+
+        // Sweep the members by their extent along a common direction
+        const Point2D ref = lines[members.front()].u;
+        struct Extent {
+            double s0;
+            double s1;
+            size_t line;
+        };
+        std::vector<Extent> extents;
+        extents.reserve(members.size());
+        for (size_t k : members) {
+            double p = dot(lines[k].a - origin, ref);
+            double q = dot(lines[k].b - origin, ref);
+            extents.push_back({std::min(p, q), std::max(p, q), k});
+        }
+        std::sort(extents.begin(), extents.end(), [](const Extent& l, const Extent& r) {
+            return l.s0 < r.s0;
+        });
+
+        // Point on a line at a position along the reference direction
+        auto pointAlong = [&](const LineInfo& l, double s) {
+            double p = dot(l.a - origin, ref);
+            double q = dot(l.b - origin, ref);
+            return l.a + (l.b - l.a) * ((s - p) / (q - p));
+        };
+
+        std::vector<const Extent*> active;
+        for (const Extent& cur : extents) {
+            active.erase(std::remove_if(active.begin(), active.end(), [&](const Extent* x) {
+                return x->s1 <= cur.s0 + tolerance;
+            }), active.end());
+
+            const LineInfo& li = lines[cur.line];
+            for (const Extent* other : active) {
+                const LineInfo& lj = lines[other->line];
+                if (std::abs(cross(li.u, lj.u)) > options.angleTolerance) continue;
+
+                double lo = std::max(cur.s0, other->s0);
+                double hi = std::min(cur.s1, other->s1);
+                if (hi - lo <= tolerance) continue;
+
+                Point2D pl = pointAlong(li, lo);
+                Point2D ph = pointAlong(li, hi);
+                if (std::abs(cross(ref, pointAlong(lj, lo) - pl)) > tolerance ||
+                    std::abs(cross(ref, pointAlong(lj, hi) - ph)) > tolerance) {
+                    continue;
+                }
+                if (entityDeviation(entities[li.index], entities[lj.index]) <= tolerance) continue;
+
+                sets.unite(cur.line, other->line);
+                size_t root = sets.find(cur.line);
+                if (hi - lo > groupOverlap[root]) {
+                    groupOverlap[root] = hi - lo;
+                    groupLocation[root] = (pl + ph) * 0.5;
+                }
+            }
+            active.push_back(&cur);
+        }
+    }
+
+    // Collect the groups; the overlap records may sit on a former root
+    std::vector<size_t> setSize(lines.size(), 0);
+    for (size_t k = 0; k < lines.size(); ++k) ++setSize[sets.find(k)];
+
+    std::unordered_map<size_t, size_t> groupOf;
+    for (size_t k = 0; k < lines.size(); ++k) {
+        size_t root = sets.find(k);
+        if (setSize[root] < 2) continue;
+        auto it = groupOf.find(root);
+        if (it == groupOf.end()) {
+            it = groupOf.emplace(root, groups.size()).first;
+            groups.push_back({});
+        }
+        OverlapGroup& g = groups[it->second];
+        g.lines.push_back(lines[k].index);
+        if (groupOverlap[k] > g.overlap) {
+            g.overlap = groupOverlap[k];
+            g.location = groupLocation[k];
+        }
+    }
+    return groups;
+}
+
+// =====================================================================
+//  Endpoint Gaps
+// =====================================================================
+
+struct EndRef {
+    size_t entity;
+    int end;              ///< 0 = start, 1 = end
+    Point2D position;
+};
+
+struct GapCluster {
+    std::vector<EndRef> ends;    ///< Members, in sketch order
+    Point2D target;              ///< Where the ends should meet
+    double gap = 0.0;            ///< Largest distance of an end from the target
+};
+
+/// Open ends of lines, arcs and splines
+std::vector<EndRef> openEnds(const std::vector<Entity>& entities)
+{
+    std::vector<EndRef> ends;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        const Entity& e = entities[i];
+        if (e.type != EntityType::Line && e.type != EntityType::Arc &&
+            e.type != EntityType::Spline) {
+            continue;
+        }
+        std::vector<Point2D> pts = e.endpoints();
+        if (pts.size() < 2) continue;
+        ends.push_back({i, 0, pts[0]});
+        ends.push_back({i, 1, pts[1]});
+    }
+    return ends;
+}
+
+/// Clusters of ends that nearly meet.  An end that already meets
+/// another end exactly is joined, not gapped; a loose end is linked
+/// to its nearest neighbour within the gap tolerance.  Ends of ignored
+/// entities (duplicates, which are reported as such) are skipped.
+std::vector<GapCluster> findGaps(const std::vector<Entity>& entities, const LintOptions& options,
+                                 const std::vector<bool>& ignored = {})
+{
+    std::vector<EndRef> ends = openEnds(entities);
+    if (!ignored.empty()) {
+        ends.erase(std::remove_if(ends.begin(), ends.end(), [&](const EndRef& end) {
+            return ignored[end.entity];
+        }), ends.end());
+    }
+    const size_t n = ends.size();
+    const double exact = options.duplicateTolerance;
+    const double cell = std::max(options.gapTolerance, 1e-12);
+
+    std::unordered_map<std::int64_t, std::vector<size_t>> grid;
+    for (size_t k = 0; k < n; ++k) {
+        grid[cellKey(cellOf(ends[k].position.x, cell), cellOf(ends[k].position.y, cell))].push_back(k);
+    }
+
+    DisjointSets coincident(n);
+    DisjointSets clusters(n);
+    std::vector<bool> linked(n, false);
+    std::vector<long> nearest(n, -1);
+    std::vector<double> nearestDistance(n, kInf);
+
+    for (size_t k = 0; k < n; ++k) {
+        const EndRef& p = ends[k];
+        const Entity& pe = entities[p.entity];
+        long long cx = cellOf(p.position.x, cell);
+        long long cy = cellOf(p.position.y, cell);
+        for (long long dx = -1; dx <= 1; ++dx) {
+            for (long long dy = -1; dy <= 1; ++dy) {
+                auto it = grid.find(cellKey(cx + dx, cy + dy));
+                if (it == grid.end()) continue;
+                for (size_t j : it->second) {
+                    const EndRef& q = ends[j];
+                    if (q.entity == p.entity) continue;
+                    if (entities[q.entity].isConstruction != pe.isConstruction) continue;
+                    double d = length(q.position - p.position);
+                    if (d <= exact) {
+                        coincident.unite(k, j);
+                        clusters.unite(k, j);
+                        linked[k] = true;
+                    } else if (d <= options.gapTolerance && d < nearestDistance[k]) {
+                        nearest[k] = static_cast<long>(j);
+                        nearestDistance[k] = d;
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<bool> gapped(n, false);
+    for (size_t k = 0; k < n; ++k) {
+        if (linked[k] || nearest[k] < 0) continue;
+        clusters.unite(k, static_cast<size_t>(nearest[k]));
+        gapped[k] = true;
+    }
+
+    std::unordered_map<size_t, std::vector<size_t>> members;
+    std::vector<size_t> roots;
+    for (size_t k = 0; k < n; ++k) {
+        if (!gapped[k]) continue;
+        size_t root = clusters.find(k);
+        if (members.emplace(root, std::vector<size_t>()).second) roots.push_back(root);
+    }
+    if (roots.empty()) return {};
+    for (size_t k = 0; k < n; ++k) {
+        auto it = members.find(clusters.find(k));
+        if (it != members.end()) it->second.push_back(k);
+    }
+    std::sort(roots.begin(), roots.end());
+
+    std::vector<GapCluster> result;
+    for (size_t root : roots) {
+        const std::vector<size_t>& group = members[root];
+
+        // Meet where most ends already meet, preferring arc ends, which
+        // can only move by refitting the arc
+        std::unordered_map<size_t, int> groupSize;
+        std::unordered_map<size_t, bool> groupHasArc;
+        for (size_t k : group) {
+            size_t c = coincident.find(k);
+            ++groupSize[c];
+            if (entities[ends[k].entity].type == EntityType::Arc) groupHasArc[c] = true;
+        }
+        size_t best = coincident.find(group.front());
+        for (size_t k : group) {
+            size_t c = coincident.find(k);
+            if (c == best) continue;
+            bool arcC = groupHasArc[c];
+            bool arcBest = groupHasArc[best];
+            if (arcC != arcBest ? arcC : groupSize[c] > groupSize[best]) best = c;
+        }
+
+        GapCluster cluster;
+        cluster.target = ends[best].position;
+        for (size_t k : group) {
+            cluster.ends.push_back(ends[k]);
+            cluster.gap = std::max(cluster.gap, length(ends[k].position - cluster.target));
+        }
+        if (cluster.gap > exact) result.push_back(std::move(cluster));
+    }
+    return result;
+}
+
+// =====================================================================
+//  Messages
+// =====================================================================
+
+std::string formatLength(double mm)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.4g mm", mm);
+    return buf;
+}
+
+std::string formatPoint(const Point2D& p)
+{
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "(%.4f, %.4f)", p.x, p.y);
+    return buf;
+}
+
+std::string joinIds(std::vector<int>::const_iterator first, std::vector<int>::const_iterator last)
+{
+    std::string s;
+    for (auto it = first; it != last; ++it) {
+        if (!s.empty()) s += ", ";
+        s += std::to_string(*it);
+    }
+    return s;
+}
+
+}  // namespace
+
+// =====================================================================
+//  Linting
+// =====================================================================
+
+LintReport lintSketch(const std::vector<Entity>& entities, const LintOptions& options)
+{
+    LintReport report;
+    std::vector<bool> duplicated;
+
+    if (options.checkDuplicates) {
+        std::vector<Duplicate> duplicates = findDuplicates(entities, options);
+        duplicated.assign(entities.size(), false);
+        for (const Duplicate& d : duplicates) duplicated[d.index] = true;
+
+        // One exact and one near issue per kept entity, in sketch order
+        std::vector<size_t> keptOrder;
+        std::unordered_map<size_t, std::pair<LintIssue, LintIssue>> byKept;
+        for (const Duplicate& d : duplicates) {
+            auto it = byKept.find(d.kept);
+            if (it == byKept.end()) {
+                keptOrder.push_back(d.kept);
+                LintIssue issue;
+                issue.entityIds.push_back(entities[d.kept].id);
+                issue.location = entities[d.kept].boundingBox().center();
+                it = byKept.emplace(d.kept, std::make_pair(issue, issue)).first;
+                it->second.second.type = LintIssueType::NearDuplicateEntity;
+            }
+            bool exact = d.deviation <= options.duplicateTolerance;
+            LintIssue& issue = exact ? it->second.first : it->second.second;
+            issue.entityIds.push_back(entities[d.index].id);
+            issue.size = std::max(issue.size, d.deviation);
+            ++(exact ? report.duplicates : report.nearDuplicates);
+        }
+        std::sort(keptOrder.begin(), keptOrder.end());
+        for (LintIssueType type : {LintIssueType::DuplicateEntity, LintIssueType::NearDuplicateEntity}) {
+            for (size_t kept : keptOrder) {
+                const auto& pair = byKept[kept];
+                const LintIssue& issue = (type == LintIssueType::DuplicateEntity) ? pair.first : pair.second;
+                if (issue.entityIds.size() > 1) report.issues.push_back(issue);
+            }
+        }
+    }
+
+    if (options.checkOverlaps) {
+        for (const OverlapGroup& g : findOverlaps(entities, options)) {
+            LintIssue issue;
+            issue.type = LintIssueType::CollinearOverlap;
+            for (size_t i : g.lines) issue.entityIds.push_back(entities[i].id);
+            issue.location = g.location;
+            issue.size = g.overlap;
+            report.issues.push_back(issue);
+            ++report.overlaps;
+        }
+    }
+
+    if (options.checkGaps) {
+        for (const GapCluster& c : findGaps(entities, options, duplicated)) {
+            LintIssue issue;
+            issue.type = LintIssueType::EndpointGap;
+            for (const EndRef& end : c.ends) {
+                int id = entities[end.entity].id;
+                if (std::find(issue.entityIds.begin(), issue.entityIds.end(), id) == issue.entityIds.end()) {
+                    issue.entityIds.push_back(id);
+                }
+            }
+            issue.location = c.target;
+            issue.size = c.gap;
+            report.issues.push_back(issue);
+            ++report.gaps;
+        }
+    }
+
+    return report;
+}
+
+std::string lintIssueMessage(const LintIssue& issue, const std::vector<Entity>& entities)
+{
+    if (issue.entityIds.empty()) return {};
+
+    std::string first = std::to_string(issue.entityIds.front());
+    for (const Entity& e : entities) {
+        if (e.id == issue.entityIds.front()) {
+            first = std::string(entityTypeName(e.type)) + " " + first;
+            break;
+        }
+    }
+    const std::string rest = joinIds(issue.entityIds.begin() + 1, issue.entityIds.end());
+    const std::string all = joinIds(issue.entityIds.begin(), issue.entityIds.end());
+
+    switch (issue.type) {
+    case LintIssueType::DuplicateEntity:
+        return first + " is duplicated by " + rest;
+    case LintIssueType::NearDuplicateEntity:
+        return first + " is nearly duplicated by " + rest +
+               " (within " + formatLength(issue.size) + ")";
+    case LintIssueType::CollinearOverlap:
+        return "Lines " + all + " overlap by " + formatLength(issue.size) +
+               " at " + formatPoint(issue.location);
+    case LintIssueType::EndpointGap:
+        return "Endpoints of " + all + " miss by " + formatLength(issue.size) +
+               " at " + formatPoint(issue.location);
+    }
+    return {};
+}
+
+// =====================================================================
+//  Fixes
+// =====================================================================
+
+LintFixResult fixLint(const std::vector<Entity>& entities,
+                      const std::vector<Constraint>& constraints,
+                      const LintOptions& options,
+                      const LintFixOptions& fixes)
+{
+    LintFixResult result;
+    result.entities = entities;
+    result.constraints = constraints;
+
+    // Removed entity ID -> replacement ID (-1 drops the references),
+    // and whether the replacement runs the other way
+    struct Replacement {
+        int id = -1;
+        bool reversed = false;
+    };
+    std::unordered_map<int, Replacement> replaced;
+
+    auto removeMarked = [&](const std::vector<bool>& remove) {
+        size_t out = 0;
+        for (size_t i = 0; i < result.entities.size(); ++i) {
+            if (remove[i]) {
+                result.removedIds.push_back(result.entities[i].id);
+                continue;
+            }
+            if (out != i) result.entities[out] = std::move(result.entities[i]);
+            ++out;
+        }
+        result.entities.resize(out);
+    };
+
+    if (fixes.removeDuplicates) {
+        std::vector<bool> remove(result.entities.size(), false);
+        for (const Duplicate& d : findDuplicates(result.entities, options)) {
+            remove[d.index] = true;
+            replaced[result.entities[d.index].id] = {result.entities[d.kept].id, d.reversed};
+            ++result.duplicatesRemoved;
+        }
+        removeMarked(remove);
+    }
+
+    if (fixes.mergeCollinear) {
+        std::vector<bool> remove(result.entities.size(), false);
+        for (const OverlapGroup& g : findOverlaps(result.entities, options)) {
+            // The first line grows to cover the whole group
+            Entity& keep = result.entities[g.lines.front()];
+            Point2D a = keep.points[0];
+            Point2D u = normalize(keep.points[1] - a);
+            double lo = 0.0;
+            double hi = dot(keep.points[1] - a, u);
+            for (size_t i : g.lines) {
+                for (const Point2D& p : result.entities[i].points) {
+                    double s = dot(p - a, u);
+                    lo = std::min(lo, s);
+                    hi = std::max(hi, s);
+                }
+            }
+            keep.points[0] = a + u * lo;
+            keep.points[1] = a + u * hi;
+            for (size_t k = 1; k < g.lines.size(); ++k) {
+                remove[g.lines[k]] = true;
+                replaced[result.entities[g.lines[k]].id] = {};
+                ++result.linesMerged;
+            }
+        }
+        removeMarked(remove);
+    }
+
+    if (fixes.weldEndpoints) {
+        std::vector<bool> remove(result.entities.size(), false);
+        std::unordered_map<size_t, std::pair<Point2D, Point2D>> arcEnds;
+
+        for (const GapCluster& c : findGaps(result.entities, options)) {
+            for (const EndRef& end : c.ends) {
+                if (length(end.position - c.target) <= 0.0) continue;
+                Entity& e = result.entities[end.entity];
+                if (e.type == EntityType::Arc) {
+                    auto it = arcEnds.find(end.entity);
+                    if (it == arcEnds.end()) {
+                        std::vector<Point2D> pts = e.endpoints();
+                        it = arcEnds.emplace(end.entity, std::make_pair(pts[0], pts[1])).first;
+                    }
+                    (end.end == 0 ? it->second.first : it->second.second) = c.target;
+                } else if (end.end == 0) {
+                    e.points.front() = c.target;
+                } else {
+                    e.points.back() = c.target;
+                }
+                ++result.endpointsWelded;
+            }
+        }
+
+        // Refit moved arcs through their new ends and old midpoint
+        for (const auto& [index, newEnds] : arcEnds) {
+            Entity& e = result.entities[index];
+            double mid = (e.startAngle + e.sweepAngle / 2.0) * M_PI / 180.0;
+            Point2D midPoint(e.points[0].x + e.radius * std::cos(mid),
+                             e.points[0].y + e.radius * std::sin(mid));
+            Entity fitted = createArcFromThreePoints(e.id, newEnds.first, midPoint, newEnds.second);
+            fitted.isConstruction = e.isConstruction;
+            fitted.constrained = e.constrained;
+            fitted.groupId = e.groupId;
+            e = fitted;
+        }
+
+        // Lines and splines whose ends were welded together are gone
+        for (size_t i = 0; i < result.entities.size(); ++i) {
+            const Entity& e = result.entities[i];
+            if ((e.type == EntityType::Line || e.type == EntityType::Spline) &&
+                e.points.size() == 2 &&
+                length(e.points[1] - e.points[0]) <= options.duplicateTolerance) {
+                remove[i] = true;
+                replaced[e.id] = {};
+            }
+        }
+        removeMarked(remove);
+    }
+
+    // Hand constraint references on to the replacements
+    if (!replaced.empty()) {
+        std::vector<Constraint> kept;
+        kept.reserve(result.constraints.size());
+        auto repeatsEntity = [](std::vector<int> ids) {
+            std::sort(ids.begin(), ids.end());
+            return std::adjacent_find(ids.begin(), ids.end()) != ids.end();
+        };
+
+        for (Constraint c : result.constraints) {
+            const bool repeatedBefore = repeatsEntity(c.entityIds);
+            bool drop = false;
+            for (size_t k = 0; k < c.entityIds.size() && !drop; ++k) {
+                auto it = replaced.find(c.entityIds[k]);
+                if (it == replaced.end()) continue;
+                // Follow chains: a duplicate of a line that was later merged away
+                Replacement r = it->second;
+                auto next = replaced.find(r.id);
+                while (r.id >= 0 && next != replaced.end()) {
+                    r.reversed = r.reversed != next->second.reversed;
+                    r.id = next->second.id;
+                    next = replaced.find(r.id);
+                }
+                if (r.id < 0) {
+                    drop = true;
+                    break;
+                }
+                c.entityIds[k] = r.id;
+                if (r.reversed && k < c.pointIndices.size() && c.pointIndices[k] >= 0) {
+                    auto e = std::find_if(result.entities.begin(), result.entities.end(),
+                                          [&](const Entity& x) { return x.id == r.id; });
+                    if (e != result.entities.end()) {
+                        c.pointIndices[k] = static_cast<int>(e->points.size()) - 1 - c.pointIndices[k];
+                    }
+                }
+            }
+            // A constraint between an entity and its own duplicate is void
+            if (!drop && !repeatedBefore && repeatsEntity(c.entityIds)) drop = true;
+            if (!drop) kept.push_back(std::move(c));
+        }
+        result.constraints = std::move(kept);
+    }
+
+    result.success = true;
+    return result;
+}
+
+}  // namespace sketch
+}  // namespace hobbycad
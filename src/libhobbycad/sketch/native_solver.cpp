@@ -0,0 +1,1381 @@
+// =====================================================================
+//  src/libhobbycad/sketch/native_solver.cpp — Built-in constraint solver
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/sketch/native_solver.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace hobbycad {
+namespace sketch {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+constexpr int kDefaultMaxIterations = 50;
+constexpr double kDefaultTolerance = 1e-9;
+
+// Levenberg–Marquardt damping bounds.  Rows are normalized, so these
+// are relative to a unit diagonal.
+constexpr double kInitialDamping = 1e-6;
+constexpr double kMinDamping = 1e-12;
+constexpr double kMaxDamping = 1e8;
+
+// Rank detection: a row whose pivot falls below kRankTolerance (with
+// kRankDamping added to the diagonal) depends on earlier rows
+constexpr double kRankDamping = 1e-12;
+constexpr double kRankTolerance = 1e-9;
+
+constexpr double kDegenerateLength = 1e-12;
+
+// Column scale for dragged parameters.  Steps move a parameter in
+// proportion to its scale squared, so dragged points move 400× less
+// than free ones.
+constexpr double kDraggedScale = 1.0 / 20.0;
+
+constexpr int kMaxTerms = 8;
+
+// ---- Equations -------------------------------------------------------
+
+/// Residual forms.  Parameter layouts are documented per kind; points
+/// are always consecutive (x, y) parameter pairs.
+enum class EquationKind {
+    Linear,                  ///< Σ coef·p − value
+    PointDistance,           ///< |p1 − p0| + Σ coef·r − value   [x0 y0 x1 y1 (r...)]
+    LengthDifference,        ///< |a1 − a0| − |b1 − b0|          [a0 a1 b0 b1]
+    Angle,                   ///< sin(angle(a, b) − value)         [a0 a1 (b0 b1)]
+    PointLineDistance,       ///< coef0·dist(q, ab) + Σ coef·r    [a b q (r)]
+    SymmetricMidpoint,       ///< dist(mid(p, q), ab)              [a b p q]
+    SymmetricPerpendicular   ///< (q − p)·(b − a) / |b − a|        [a b p q]
+};
+
+struct Equation {
+    EquationKind kind = EquationKind::Linear;
+    int constraintId = 0;
+    int param[kMaxTerms] = {};
+    double coef[kMaxTerms] = {};
+    int count = 0;
+    double value = 0.0;
+
+    void add(int p, double c = 0.0)
+    {
+        param[count] = p;
+        coef[count] = c;
+        ++count;
+    }
+
+    void addPoint(int p)
+    {
+        add(p);
+        add(p + 1);
+    }
+};
+
+/// Signed distance from q to the line through a and b, with gradient
+/// (d/dax, d/day, d/dbx, d/dby, d/dqx, d/dqy)
+double pointLineDistance(double ax, double ay, double bx, double by,
+                         double qx, double qy, double* grad)
+{
+    double ux = bx - ax, uy = by - ay;
+    double wx = qx - ax, wy = qy - ay;
+    double len = std::sqrt(ux * ux + uy * uy);
+    if (len < kDegenerateLength) {
+        std::fill(grad, grad + 6, 0.0);
+        return 0.0;
+    }
+
+    double g = (ux * wy - uy * wx) / len;
+    double len2 = len * len;
+    double dux = wy / len - g * ux / len2;
+    double duy = -wx / len - g * uy / len2;
+    double dwx = -uy / len;
+    double dwy = ux / len;
+
+    grad[0] = -dux - dwx;
+    grad[1] = -duy - dwy;
+    grad[2] = dux;
+    grad[3] = duy;
+    grad[4] = dwx;
+    grad[5] = dwy;
+    return g;
+}
+
+/// Evaluate an equation at x.  grad receives ∂f/∂param[i].
+double evaluateEquation(const Equation& eq, const double* x, double* grad)
+{
+    const int* p = eq.param;
+
+    switch (eq.kind) {
+    case EquationKind::Linear: {
+        double f = -eq.value;
+        for (int i = 0; i < eq.count; ++i) {
+            f += eq.coef[i] * x[p[i]];
+            grad[i] = eq.coef[i];
+        }
+        return f;
+    }
+
+    case EquationKind::PointDistance: {
+        double dx = x[p[2]] - x[p[0]];
+        double dy = x[p[3]] - x[p[1]];
+        double len = std::sqrt(dx * dx + dy * dy);
+        double ux = 1.0, uy = 0.0;
+        if (len > kDegenerateLength) {
+            ux = dx / len;
+            uy = dy / len;
+        }
+        grad[0] = -ux;
+        grad[1] = -uy;
+        grad[2] = ux;
+        grad[3] = uy;
+
+        double f = len - eq.value;
+        for (int i = 4; i < eq.count; ++i) {
+            f += eq.coef[i] * x[p[i]];
+            grad[i] = eq.coef[i];
+        }
+        return f;
+    }
+
+    case EquationKind::LengthDifference: {
+        double ax = x[p[2]] - x[p[0]], ay = x[p[3]] - x[p[1]];
+        double bx = x[p[6]] - x[p[4]], by = x[p[7]] - x[p[5]];
+        double la = std::sqrt(ax * ax + ay * ay);
+        double lb = std::sqrt(bx * bx + by * by);
+        double uax = la > kDegenerateLength ? ax / la : 1.0;
+        double uay = la > kDegenerateLength ? ay / la : 0.0;
+        double ubx = lb > kDegenerateLength ? bx / lb : 1.0;
+        double uby = lb > kDegenerateLength ? by / lb : 0.0;
+        grad[0] = -uax; grad[1] = -uay; grad[2] = uax; grad[3] = uay;
+        grad[4] = ubx;  grad[5] = uby;  grad[6] = -ubx; grad[7] = -uby;
+        return la - lb;
+    }
+
+    case EquationKind::Angle: {
+        // f = sin(θ − t) = (cross·cos t − dot·sin t) / (|u|·|v|),
+        // zero for either direction of each line
+        double ux = x[p[2]] - x[p[0]], uy = x[p[3]] - x[p[1]];
+        double vx = 1.0, vy = 0.0;
+        bool twoLines = eq.count == 8;
+        if (twoLines) {
+            vx = x[p[6]] - x[p[4]];
+            vy = x[p[7]] - x[p[5]];
+        }
+        double lu2 = ux * ux + uy * uy;
+        double lv2 = vx * vx + vy * vy;
+        if (lu2 < kDegenerateLength || lv2 < kDegenerateLength) {
+            std::fill(grad, grad + eq.count, 0.0);
+            return 0.0;
+        }
+
+        double n = std::sqrt(lu2 * lv2);
+        double ct = std::cos(eq.value), st = std::sin(eq.value);
+        double cross = ux * vy - uy * vx;
+        double dot = ux * vx + uy * vy;
+        double f = (cross * ct - dot * st) / n;
+
+        double dux = (vy * ct - vx * st) / n - f * ux / lu2;
+        double duy = (-vx * ct - vy * st) / n - f * uy / lu2;
+        grad[0] = -dux; grad[1] = -duy; grad[2] = dux; grad[3] = duy;
+        if (twoLines) {
+            double dvx = (-uy * ct - ux * st) / n - f * vx / lv2;
+            double dvy = (ux * ct - uy * st) / n - f * vy / lv2;
+            grad[4] = -dvx; grad[5] = -dvy; grad[6] = dvx; grad[7] = dvy;
+        }
+        return f;
+    }
+
+    case EquationKind::PointLineDistance: {
+        double g = pointLineDistance(x[p[0]], x[p[1]], x[p[2]], x[p[3]],
+                                     x[p[4]], x[p[5]], grad);
+        double side = eq.coef[0];
+        for (int i = 0; i < 6; ++i) grad[i] *= side;
+
+        double f = side * g - eq.value;
+        for (int i = 6; i < eq.count; ++i) {
+            f += eq.coef[i] * x[p[i]];
+            grad[i] = eq.coef[i];
+        }
+        return f;
+    }
+
+    case EquationKind::SymmetricMidpoint: {
+        double mx = 0.5 * (x[p[4]] + x[p[6]]);
+        double my = 0.5 * (x[p[5]] + x[p[7]]);
+        double g = pointLineDistance(x[p[0]], x[p[1]], x[p[2]], x[p[3]],
+                                     mx, my, grad);
+        grad[6] = 0.5 * grad[4];
+        grad[7] = 0.5 * grad[5];
+        grad[4] = grad[6];
+        grad[5] = grad[7];
+        return g;
+    }
+
+    case EquationKind::SymmetricPerpendicular: {
+        double ux = x[p[2]] - x[p[0]], uy = x[p[3]] - x[p[1]];
+        double sx = x[p[6]] - x[p[4]], sy = x[p[7]] - x[p[5]];
+        double len = std::sqrt(ux * ux + uy * uy);
+        if (len < kDegenerateLength) {
+            std::fill(grad, grad + 8, 0.0);
+            return 0.0;
+        }
+        double h = (sx * ux + sy * uy) / len;
+        double len2 = len * len;
+        double dux = sx / len - h * ux / len2;
+        double duy = sy / len - h * uy / len2;
+        grad[0] = -dux;       grad[1] = -duy;
+        grad[2] = dux;        grad[3] = duy;
+        grad[4] = -ux / len;  grad[5] = -uy / len;
+        grad[6] = ux / len;   grad[7] = uy / len;
+        return h;
+    }
+    }
+    return 0.0;
+}
+
+// ---- Sparse LDLᵀ -----------------------------------------------------
+//
+// Up-looking LDLᵀ factorization of a symmetric positive definite
+// matrix in compressed-column form (both triangles stored), after
+// T. Davis' LDL package.  The elimination tree and column counts are
+// computed once per pattern; numeric factorization reuses them.
+
+struct SparseLdl {
+    int n = 0;
+    std::vector<int> perm;      ///< New index → original index
+    std::vector<int> permInv;   ///< Original index → new index
+    std::vector<int> parent;    ///< Elimination tree
+    std::vector<int> lp;        ///< Column pointers of L
+    std::vector<int> li;
+    std::vector<double> lx;
+    std::vector<double> d;
+
+    // Workspace
+    std::vector<int> lnz;
+    std::vector<int> flag;
+    std::vector<int> pattern;
+    std::vector<double> y;
+
+    void analyze(int size, const std::vector<int>& ap, const std::vector<int>& ai,
+                 const std::vector<int>& ordering)
+    {
+        n = size;
+        perm = ordering;
+        permInv.assign(n, 0);
+        for (int k = 0; k < n; ++k) permInv[perm[k]] = k;
+
+        parent.assign(n, -1);
+        lnz.assign(n, 0);
+        flag.assign(n, 0);
+        for (int k = 0; k < n; ++k) {
+            flag[k] = k;
+            int kk = perm[k];
+            for (int q = ap[kk]; q < ap[kk + 1]; ++q) {
+                int i = permInv[ai[q]];
+                if (i >= k) continue;
+                for (; flag[i] != k; i = parent[i]) {
+                    if (parent[i] == -1) parent[i] = k;
+                    ++lnz[i];
+                    flag[i] = k;
+                }
+            }
+        }
+
+        lp.assign(n + 1, 0);
+        for (int k = 0; k < n; ++k) lp[k + 1] = lp[k] + lnz[k];
+        li.assign(lp[n], 0);
+        lx.assign(lp[n], 0.0);
+        d.assign(n, 0.0);
+        pattern.assign(n, 0);
+        y.assign(n, 0.0);
+    }
+
+    /// Numeric factorization.  Returns false on a zero pivot.
+    bool factor(const std::vector<int>& ap, const std::vector<int>& ai,
+                const std::vector<double>& ax)
+    {
+        for (int k = 0; k < n; ++k) {
+            y[k] = 0.0;
+            int top = n;
+            flag[k] = k;
+            lnz[k] = 0;
+            int kk = perm[k];
+            for (int q = ap[kk]; q < ap[kk + 1]; ++q) {
+                int i = permInv[ai[q]];
+                if (i > k) continue;
+                y[i] += ax[q];
+                int len = 0;
+                for (; flag[i] != k; i = parent[i]) {
+                    pattern[len++] = i;
+                    flag[i] = k;
+                }
+                while (len > 0) pattern[--top] = pattern[--len];
+            }
+
+            d[k] = y[k];
+            y[k] = 0.0;
+            for (; top < n; ++top) {
+                int i = pattern[top];
+                double yi = y[i];
+                y[i] = 0.0;
+                int end = lp[i] + lnz[i];
+                for (int q = lp[i]; q < end; ++q) y[li[q]] -= lx[q] * yi;
+                double lki = yi / d[i];
+                d[k] -= lki * yi;
+                li[end] = k;
+                lx[end] = lki;
+                ++lnz[i];
+            }
+            if (d[k] == 0.0) return false;
+        }
+        return true;
+    }
+
+    /// Solve A·x = b in place
+    void solve(std::vector<double>& b)
+    {
+        for (int k = 0; k < n; ++k) y[k] = b[perm[k]];
+        for (int j = 0; j < n; ++j) {
+            for (int q = lp[j]; q < lp[j + 1]; ++q) y[li[q]] -= lx[q] * y[j];
+        }
+        for (int j = 0; j < n; ++j) y[j] /= d[j];
+        for (int j = n - 1; j >= 0; --j) {
+            for (int q = lp[j]; q < lp[j + 1]; ++q) y[j] -= lx[q] * y[li[q]];
+        }
+        for (int k = 0; k < n; ++k) b[perm[k]] = y[k];
+        std::fill(y.begin(), y.end(), 0.0);
+    }
+};
+
+/// Reverse Cuthill–McKee ordering of a symmetric pattern, which keeps
+/// fill-in low for the chain-like structure typical of sketches
+std::vector<int> reverseCuthillMcKee(int n, const std::vector<int>& ap,
+                                     const std::vector<int>& ai)
+{
+    std::vector<int> degree(n);
+    for (int i = 0; i < n; ++i) degree[i] = ap[i + 1] - ap[i];
+
+    std::vector<int> seeds(n);
+    for (int i = 0; i < n; ++i) seeds[i] = i;
+    std::stable_sort(seeds.begin(), seeds.end(),
+                     [&](int a, int b) { return degree[a] < degree[b]; });
+
+    std::vector<int> order;
+    order.reserve(n);
+    std::vector<char> visited(n, 0);
+    std::vector<int> neighbors;
+
+    for (int seed : seeds) {
+        if (visited[seed]) continue;
+        visited[seed] = 1;
+        size_t head = order.size();
+        order.push_back(seed);
+        while (head < order.size()) {
+            int v = order[head++];
+            neighbors.clear();
+            for (int q = ap[v]; q < ap[v + 1]; ++q) {
+                int w = ai[q];
+                if (!visited[w]) {
+                    visited[w] = 1;
+                    neighbors.push_back(w);
+                }
+            }
+            std::stable_sort(neighbors.begin(), neighbors.end(),
+                             [&](int a, int b) { return degree[a] < degree[b]; });
+            order.insert(order.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+}  // namespace
+
+// =====================================================================
+//  Implementation
+// =====================================================================
+
+class NativeSolver::Impl {
+public:
+    /// Where an entity's parameters live
+    struct EntitySlot {
+        EntityType type = EntityType::Point;
+        int param = -1;   ///< First parameter
+    };
+
+    // Parameters
+    std::vector<double> params;
+    std::vector<char> locked;
+    std::vector<double> scale;    ///< Column scale (kDraggedScale when dragged)
+    std::unordered_map<int, EntitySlot> slots;
+
+    // Equations (rows of J)
+    std::vector<Equation> equations;
+
+    // Sparse Jacobian, rows in CSR form over unknown columns
+    int unknowns = 0;
+    std::vector<int> column;      ///< Parameter → unknown column, or -1
+    std::vector<int> columnParam; ///< Unknown column → parameter
+    std::vector<int> rowStart;
+    std::vector<int> rowColumn;
+    std::vector<int> termEntry;   ///< Equation term → J entry, or -1
+    std::vector<double> rowValue;
+    std::vector<double> residual; ///< Row-normalized residuals
+
+    // Normal matrix A = J·Jᵀ (symmetric, both triangles, CSC)
+    std::vector<int> ap;
+    std::vector<int> ai;
+    std::vector<double> ax;
+    std::vector<int> diagonal;    ///< Position of A(i, i)
+    std::vector<int> products;    ///< Per column of J: A positions of each entry pair
+    std::vector<int> colStart;    ///< Column-major view of J: entries per column
+    std::vector<int> colEntry;
+    SparseLdl ldl;
+
+    // Echelon basis of the equations, for addIfIndependent()
+    struct BasisRow {
+        int pivot = -1;                             ///< Pivot parameter
+        std::vector<std::pair<int, double>> terms;  ///< (parameter, value), pivot included
+    };
+    std::vector<BasisRow> basis;
+    std::vector<int> pivotRow;     ///< Parameter → basis row, or -1
+    std::vector<double> work;      ///< Dense scratch row over parameters
+    std::vector<char> queued;      ///< Basis rows queued during a reduction
+    size_t basisEquations = 0;     ///< Equations already reduced into the basis
+    bool analyzed = false;         ///< analyze() matches the equations
+
+    int maxIterations = kDefaultMaxIterations;
+    double tolerance = kDefaultTolerance;
+    bool diagnostics = true;
+    int lastIterations = 0;
+
+    void clear();
+    int addParams(int count, const double* values);
+    int pointParam(int entityId, int pointIndex) const;
+    int radiusParam(int entityId) const;
+    bool lineParam(int entityId, int& param) const;
+    void addConstraint(const Constraint& c);
+    void analyze();
+    void ensureAnalyzed();
+    bool reduceIntoBasis(const Equation& eq);
+
+    double evaluate();
+    void formNormalMatrix(double damping);
+    double maxResidual() const;
+    std::vector<int> dependentRows();
+    int freeParameterCount() const;
+};
+
+void NativeSolver::Impl::clear()
+{
+    params.clear();
+    locked.clear();
+    scale.clear();
+    slots.clear();
+    equations.clear();
+    basis.clear();
+    pivotRow.clear();
+    work.clear();
+    queued.clear();
+    basisEquations = 0;
+    analyzed = false;
+}
+
+int NativeSolver::Impl::addParams(int count, const double* values)
+{
+    int first = static_cast<int>(params.size());
+    params.insert(params.end(), values, values + count);
+    locked.insert(locked.end(), count, 0);
+    scale.insert(scale.end(), count, 1.0);
+    return first;
+}
+
+int NativeSolver::Impl::pointParam(int entityId, int pointIndex) const
+{
+    auto it = slots.find(entityId);
+    if (it == slots.end()) return -1;
+
+    const EntitySlot& slot = it->second;
+    switch (slot.type) {
+    case EntityType::Point:
+        return slot.param;
+    case EntityType::Line:
+        if (pointIndex == 0) return slot.param;
+        if (pointIndex == 1) return slot.param + 2;
+        return -1;
+    case EntityType::Circle:
+    case EntityType::Arc:
+        return pointIndex == 0 ? slot.param : -1;
+    default:
+        return -1;
+    }
+}
+
+int NativeSolver::Impl::radiusParam(int entityId) const
+{
+    auto it = slots.find(entityId);
+    if (it == slots.end()) return -1;
+    if (it->second.type != EntityType::Circle && it->second.type != EntityType::Arc) return -1;
+    return it->second.param + 2;
+}
+
+bool NativeSolver::Impl::lineParam(int entityId, int& param) const
+{
+    auto it = slots.find(entityId);
+    if (it == slots.end() || it->second.type != EntityType::Line) return false;
+    param = it->second.param;
+    return true;
+}
+
+void NativeSolver::Impl::addConstraint(const Constraint& c)
+{
+    auto safeGet = [](const std::vector<int>& vec, size_t index, int defaultVal) -> int {
+        return (index < vec.size()) ? vec[index] : defaultVal;
+    };
+    auto entity = [&](size_t i) { return safeGet(c.entityIds, i, -1); };
+    auto point = [&](size_t i) {
+        return pointParam(entity(i), safeGet(c.pointIndices, i, 0));
+    };
+
+    Equation eq;
+    eq.constraintId = c.id;
+
+    switch (c.type) {
+    case ConstraintType::Distance: {
+        int p0 = point(0), p1 = point(1);
+        if (p0 < 0 || p1 < 0) break;
+        eq.kind = EquationKind::PointDistance;
+        eq.addPoint(p0);
+        eq.addPoint(p1);
+        eq.value = c.value;
+        equations.push_back(eq);
+        return;
+    }
+
+    case ConstraintType::Radius:
+    case ConstraintType::Diameter: {
+        int r = radiusParam(entity(0));
+        if (r < 0) break;
+        eq.add(r, 1.0);
+        eq.value = c.type == ConstraintType::Diameter ? c.value * 0.5 : c.value;
+        equations.push_back(eq);
+        return;
+    }
+
+    case ConstraintType::Angle:
+    case ConstraintType::FixedAngle:
+    case ConstraintType::Parallel:
+    case ConstraintType::Perpendicular: {
+        int a = -1, b = -1;
+        if (!lineParam(entity(0), a)) break;
+        bool reference = c.type == ConstraintType::FixedAngle;
+        if (!reference && !lineParam(entity(1), b)) break;
+
+        eq.kind = EquationKind::Angle;
+        eq.addPoint(a);
+        eq.addPoint(a + 2);
+        if (!reference) {
+            eq.addPoint(b);
+            eq.addPoint(b + 2);
+        }
+
+        if (c.type == ConstraintType::Parallel) {
+            eq.value = 0.0;
+        } else if (c.type == ConstraintType::Perpendicular) {
+            eq.value = kPi / 2.0;
+        } else {
+            // An angle dimension is unsigned: keep whichever sense the
+            // geometry is already closer to
+            double t = c.value * kPi / 180.0;
+            double grad[kMaxTerms];
+            eq.value = t;
+            double fPos = std::abs(evaluateEquation(eq, params.data(), grad));
+            eq.value = -t;
+            double fNeg = std::abs(evaluateEquation(eq, params.data(), grad));
+            eq.value = fPos <= fNeg ? t : -t;
+        }
+        equations.push_back(eq);
+        return;
+    }
+
+    case ConstraintType::Horizontal:
+    case ConstraintType::Vertical: {
+        int a = -1;
+        if (!lineParam(entity(0), a)) break;
+        int axis = c.type == ConstraintType::Horizontal ? 1 : 0;
+        eq.add(a + axis, 1.0);
+        eq.add(a + 2 + axis, -1.0);
+        equations.push_back(eq);
+        return;
+    }
+
+    case ConstraintType::Coincident: {
+        int p0 = point(0), p1 = point(1);
+        if (p0 < 0 || p1 < 0) break;
+        for (int axis = 0; axis < 2; ++axis) {
+            Equation row = eq;
+            row.add(p0 + axis, 1.0);
+            row.add(p1 + axis, -1.0);
+            equations.push_back(row);
+        }
+        return;
+    }
+
+    case ConstraintType::Equal: {
+        int a = -1, b = -1;
+        if (lineParam(entity(0), a) && lineParam(entity(1), b)) {
+            eq.kind = EquationKind::LengthDifference;
+            eq.addPoint(a);
+            eq.addPoint(a + 2);
+            eq.addPoint(b);
+            eq.addPoint(b + 2);
+            equations.push_back(eq);
+            return;
+        }
+        int r0 = radiusParam(entity(0)), r1 = radiusParam(entity(1));
+        if (r0 < 0 || r1 < 0) break;
+        eq.add(r0, 1.0);
+        eq.add(r1, -1.0);
+        equations.push_back(eq);
+        return;
+    }
+
+    case ConstraintType::Tangent: {
+        int line = -1;
+        int lineIndex = lineParam(entity(0), line) ? 0 : (lineParam(entity(1), line) ? 1 : -1);
+        if (lineIndex >= 0) {
+            // Line–circle: center lies one radius from the line, on
+            // whichever side it is now
+            int r = radiusParam(entity(1 - lineIndex));
+            if (r < 0) break;
+            int center = r - 2;
+            eq.kind = EquationKind::PointLineDistance;
+            eq.addPoint(line);
+            eq.addPoint(line + 2);
+            eq.addPoint(center);
+            eq.add(r, -1.0);
+            eq.coef[0] = 1.0;
+            double grad[kMaxTerms];
+            double g = evaluateEquation(eq, params.data(), grad) + params[r];
+            eq.coef[0] = g >= 0.0 ? 1.0 : -1.0;
+            equations.push_back(eq);
+            return;
+        }
+
+        // Circle–circle: center distance equals r0 + r1 (external) or
+        // |r0 − r1| (internal); keep the configuration nearest now
+        int r0 = radiusParam(entity(0)), r1 = radiusParam(entity(1));
+        if (r0 < 0 || r1 < 0) break;
+        eq.kind = EquationKind::PointDistance;
+        eq.addPoint(r0 - 2);
+        eq.addPoint(r1 - 2);
+        eq.add(r0);
+        eq.add(r1);
+
+        static const double kSigns[3][2] = {{-1.0, -1.0}, {-1.0, 1.0}, {1.0, -1.0}};
+        double best = -1.0;
+        double grad[kMaxTerms];
+        Equation trial = eq;
+        for (const auto& s : kSigns) {
+            trial.coef[4] = s[0];
+            trial.coef[5] = s[1];
+            double f = std::abs(evaluateEquation(trial, params.data(), grad));
+            if (best < 0.0 || f < best) {
+                best = f;
+                eq.coef[4] = s[0];
+                eq.coef[5] = s[1];
+            }
+        }
+        equations.push_back(eq);
+        return;
+    }
+
+    case ConstraintType::Midpoint: {
+        int pt = pointParam(entity(0), 0);
+        int line = -1;
+        if (pt < 0 || !lineParam(entity(1), line)) break;
+        for (int axis = 0; axis < 2; ++axis) {
+            Equation row = eq;
+            row.add(pt + axis, 1.0);
+            row.add(line + axis, -0.5);
+            row.add(line + 2 + axis, -0.5);
+            equations.push_back(row);
+        }
+        return;
+    }
+
+    case ConstraintType::Symmetric: {
+        int p0 = point(0), p1 = point(1);
+        int line = -1;
+        if (p0 < 0 || p1 < 0 || !lineParam(entity(2), line)) break;
+        eq.addPoint(line);
+        eq.addPoint(line + 2);
+        eq.addPoint(p0);
+        eq.addPoint(p1);
+
+        Equation mid = eq;
+        mid.kind = EquationKind::SymmetricMidpoint;
+        equations.push_back(mid);
+
+        Equation perp = eq;
+        perp.kind = EquationKind::SymmetricPerpendicular;
+        equations.push_back(perp);
+        return;
+    }
+
+    case ConstraintType::FixedPoint: {
+        int pt = point(0);
+        if (pt < 0) break;
+        locked[pt] = 1;
+        locked[pt + 1] = 1;
+        return;
+    }
+
+    default:
+        fprintf(stderr, "Solver: constraint %d has unsupported type %d, skipping\n",
+                c.id, static_cast<int>(c.type));
+        return;
+    }
+
+    fprintf(stderr, "Solver: constraint %d (type %d): failed to resolve entities, skipping\n",
+            c.id, static_cast<int>(c.type));
+}
+
+void NativeSolver::Impl::analyze()
+{
+    const int rows = static_cast<int>(equations.size());
+
+    // Unknown columns: unlocked parameters that some equation uses
+    column.assign(params.size(), -1);
+    columnParam.clear();
+    for (const Equation& eq : equations) {
+        for (int t = 0; t < eq.count; ++t) {
+            int p = eq.param[t];
+            if (!locked[p] && column[p] < 0) {
+                column[p] = static_cast<int>(columnParam.size());
+                columnParam.push_back(p);
+            }
+        }
+    }
+    unknowns = static_cast<int>(columnParam.size());
+
+    // Row pattern of J; repeated parameters in one equation share an entry
+    rowStart.assign(rows + 1, 0);
+    rowColumn.clear();
+    termEntry.assign(static_cast<size_t>(rows) * kMaxTerms, -1);
+    for (int r = 0; r < rows; ++r) {
+        const Equation& eq = equations[r];
+        rowStart[r] = static_cast<int>(rowColumn.size());
+        for (int t = 0; t < eq.count; ++t) {
+            int col = column[eq.param[t]];
+            if (col < 0) continue;
+            int entry = -1;
+            for (int e = rowStart[r]; e < static_cast<int>(rowColumn.size()); ++e) {
+                if (rowColumn[e] == col) entry = e;
+            }
+            if (entry < 0) {
+                entry = static_cast<int>(rowColumn.size());
+                rowColumn.push_back(col);
+            }
+            termEntry[static_cast<size_t>(r) * kMaxTerms + t] = entry;
+        }
+    }
+    rowStart[rows] = static_cast<int>(rowColumn.size());
+    rowValue.assign(rowColumn.size(), 0.0);
+    residual.assign(rows, 0.0);
+
+    // Column-major view of J
+    colStart.assign(unknowns + 1, 0);
+    for (int col : rowColumn) ++colStart[col + 1];
+    for (int c = 0; c < unknowns; ++c) colStart[c + 1] += colStart[c];
+    colEntry.assign(rowColumn.size(), 0);
+    std::vector<int> rowOfEntry(rowColumn.size());
+    {
+        std::vector<int> next(colStart.begin(), colStart.end() - 1);
+        for (int r = 0; r < rows; ++r) {
+            for (int e = rowStart[r]; e < rowStart[r + 1]; ++e) {
+                rowOfEntry[e] = r;
+                colEntry[next[rowColumn[e]]++] = e;
+            }
+        }
+    }
+
+    // Pattern of A = J·Jᵀ: rows sharing a column are coupled
+    std::vector<std::vector<int>> pattern(rows);
+    for (int r = 0; r < rows; ++r) pattern[r].push_back(r);
+    for (int c = 0; c < unknowns; ++c) {
+        for (int a = colStart[c]; a < colStart[c + 1]; ++a) {
+            for (int b = colStart[c]; b < colStart[c + 1]; ++b) {
+                pattern[rowOfEntry[colEntry[b]]].push_back(rowOfEntry[colEntry[a]]);
+            }
+        }
+    }
+    ap.assign(rows + 1, 0);
+    ai.clear();
+    for (int r = 0; r < rows; ++r) {
+        std::vector<int>& list = pattern[r];
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+        ai.insert(ai.end(), list.begin(), list.end());
+        ap[r + 1] = static_cast<int>(ai.size());
+    }
+    ax.assign(ai.size(), 0.0);
+
+    auto position = [&](int row, int col) {
+        auto first = ai.begin() + ap[col];
+        auto last = ai.begin() + ap[col + 1];
+        return static_cast<int>(std::lower_bound(first, last, row) - ai.begin());
+    };
+    diagonal.assign(rows, 0);
+    for (int r = 0; r < rows; ++r) diagonal[r] = position(r, r);
+
+    products.clear();
+    for (int c = 0; c < unknowns; ++c) {
+        for (int a = colStart[c]; a < colStart[c + 1]; ++a) {
+            for (int b = colStart[c]; b < colStart[c + 1]; ++b) {
+                products.push_back(position(rowOfEntry[colEntry[a]],
+                                            rowOfEntry[colEntry[b]]));
+            }
+        }
+    }
+
+    ldl.analyze(rows, ap, ai, reverseCuthillMcKee(rows, ap, ai));
+    analyzed = true;
+}
+
+void NativeSolver::Impl::ensureAnalyzed()
+{
+    if (!analyzed) analyze();
+}
+
+bool NativeSolver::Impl::reduceIntoBasis(const Equation& eq)
+{
+    // The row is J at the current values, normalized like evaluate()
+    // does, over unlocked parameters
+    double grad[kMaxTerms];
+    evaluateEquation(eq, params.data(), grad);
+
+    if (work.size() != params.size()) {
+        work.assign(params.size(), 0.0);
+        pivotRow.assign(params.size(), -1);
+    }
+
+    std::vector<int> touched;
+    double norm = 0.0;
+    for (int t = 0; t < eq.count; ++t) {
+        int p = eq.param[t];
+        if (locked[p]) continue;
+        if (work[p] == 0.0) touched.push_back(p);
+        work[p] += grad[t];
+    }
+    for (int p : touched) norm += work[p] * work[p];
+    norm = std::sqrt(norm);
+
+    auto clearWork = [&]() {
+        for (int p : touched) work[p] = 0.0;
+    };
+    if (norm <= kDegenerateLength) {
+        clearWork();
+        return false;
+    }
+    for (int p : touched) work[p] /= norm;
+
+    // Eliminate against basis rows in the order they were added.  Row
+    // k is zero at the pivots of rows before it, so subtracting it can
+    // only bring in pivots of later rows, which the heap still holds.
+    std::vector<int> heap;
+    std::vector<int> visited;
+    queued.resize(basis.size(), 0);
+    auto queue = [&](int p) {
+        int row = pivotRow[p];
+        if (row < 0 || queued[row]) return;
+        queued[row] = 1;
+        visited.push_back(row);
+        heap.push_back(row);
+        std::push_heap(heap.begin(), heap.end(), std::greater<int>());
+    };
+    for (int p : touched) queue(p);
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<int>());
+        const BasisRow& row = basis[heap.back()];
+        heap.pop_back();
+
+        double pivotValue = 0.0;
+        for (const auto& term : row.terms) {
+            if (term.first == row.pivot) pivotValue = term.second;
+        }
+        double factor = work[row.pivot] / pivotValue;
+        if (factor == 0.0) continue;
+        for (const auto& term : row.terms) {
+            int p = term.first;
+            if (work[p] == 0.0) {
+                touched.push_back(p);
+                queue(p);
+            }
+            work[p] -= factor * term.second;
+        }
+        work[row.pivot] = 0.0;
+    }
+    for (int row : visited) queued[row] = 0;
+
+    // Independent rows keep a residual above the solver's rank
+    // threshold, which is a squared pivot
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    double residual = 0.0;
+    int pivot = -1;
+    for (int p : touched) {
+        if (pivotRow[p] >= 0) {
+            work[p] = 0.0;
+            continue;
+        }
+        residual += work[p] * work[p];
+        if (pivot < 0 || std::abs(work[p]) > std::abs(work[pivot])) pivot = p;
+    }
+    if (residual < kRankTolerance) {
+        clearWork();
+        return false;
+    }
+
+    BasisRow row;
+    row.pivot = pivot;
+    for (int p : touched) {
+        if (std::abs(work[p]) > kDegenerateLength) row.terms.emplace_back(p, work[p]);
+    }
+    pivotRow[pivot] = static_cast<int>(basis.size());
+    basis.push_back(std::move(row));
+    clearWork();
+    return true;
+}
+
+double NativeSolver::Impl::evaluate()
+{
+    double grad[kMaxTerms];
+    double cost = 0.0;
+    std::fill(rowValue.begin(), rowValue.end(), 0.0);
+
+    for (size_t r = 0; r < equations.size(); ++r) {
+        const Equation& eq = equations[r];
+        double f = evaluateEquation(eq, params.data(), grad);
+
+        const int* entries = &termEntry[r * kMaxTerms];
+        for (int t = 0; t < eq.count; ++t) {
+            if (entries[t] >= 0) rowValue[entries[t]] += grad[t];
+        }
+
+        // Normalize each row so residuals of every kind are measured in
+        // model units and the normal matrix has a unit diagonal
+        double norm = 0.0;
+        for (int e = rowStart[r]; e < rowStart[r + 1]; ++e) norm += rowValue[e] * rowValue[e];
+        norm = std::sqrt(norm);
+        if (norm > kDegenerateLength) {
+            f /= norm;
+            for (int e = rowStart[r]; e < rowStart[r + 1]; ++e) rowValue[e] /= norm;
+        }
+
+        // Dragged columns are scaled down so steps avoid moving them
+        for (int e = rowStart[r]; e < rowStart[r + 1]; ++e) {
+            rowValue[e] *= scale[columnParam[rowColumn[e]]];
+        }
+
+        residual[r] = f;
+        cost += f * f;
+    }
+    return cost;
+}
+
+void NativeSolver::Impl::formNormalMatrix(double damping)
+{
+    std::fill(ax.begin(), ax.end(), 0.0);
+    size_t k = 0;
+    for (int c = 0; c < unknowns; ++c) {
+        for (int a = colStart[c]; a < colStart[c + 1]; ++a) {
+            for (int b = colStart[c]; b < colStart[c + 1]; ++b) {
+                ax[products[k++]] += rowValue[colEntry[a]] * rowValue[colEntry[b]];
+            }
+        }
+    }
+    for (int pos : diagonal) ax[pos] += damping;
+}
+
+double NativeSolver::Impl::maxResidual() const
+{
+    double worst = 0.0;
+    for (double f : residual) worst = std::max(worst, std::abs(f));
+    return worst;
+}
+
+std::vector<int> NativeSolver::Impl::dependentRows()
+{
+    std::vector<int> rows;
+    if (equations.empty()) return rows;
+
+    evaluate();
+    formNormalMatrix(kRankDamping);
+    ldl.factor(ap, ai, ax);
+    for (int k = 0; k < ldl.n; ++k) {
+        if (ldl.d[k] < kRankTolerance) rows.push_back(ldl.perm[k]);
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+int NativeSolver::Impl::freeParameterCount() const
+{
+    return static_cast<int>(std::count(locked.begin(), locked.end(), 0));
+}
+
+// =====================================================================
+//  NativeSolver
+// =====================================================================
+
+NativeSolver::NativeSolver()
+    : m_impl(new Impl())
+{
+}
+
+NativeSolver::~NativeSolver()
+{
+    delete m_impl;
+}
+
+void NativeSolver::build(const std::vector<Entity>& entities,
+                         const std::vector<Constraint>& constraints)
+{
+    m_impl->clear();
+
+    for (const Entity& entity : entities) {
+        Impl::EntitySlot slot;
+        slot.type = entity.type;
+
+        switch (entity.type) {
+        case EntityType::Point:
+            if (entity.points.empty()) continue;
+            {
+                double v[2] = {entity.points[0].x, entity.points[0].y};
+                slot.param = m_impl->addParams(2, v);
+            }
+            break;
+        case EntityType::Line:
+            if (entity.points.size() < 2) continue;
+            {
+                double v[4] = {entity.points[0].x, entity.points[0].y,
+                               entity.points[1].x, entity.points[1].y};
+                slot.param = m_impl->addParams(4, v);
+            }
+            break;
+        case EntityType::Circle:
+        case EntityType::Arc:
+            if (entity.points.empty()) continue;
+            {
+                double v[3] = {entity.points[0].x, entity.points[0].y, entity.radius};
+                slot.param = m_impl->addParams(3, v);
+            }
+            break;
+        // Other entity types not yet supported in solver
+        default:
+            continue;
+        }
+        m_impl->slots[entity.id] = slot;
+    }
+
+    for (const Constraint& constraint : constraints) {
+        if (!constraint.enabled) continue;
+        m_impl->addConstraint(constraint);
+    }
+
+    m_impl->analyze();
+}
+
+SolveResult NativeSolver::solve()
+{
+    Impl& d = *m_impl;
+    SolveResult result;
+
+    d.ensureAnalyzed();
+    double cost = d.evaluate();
+    bool converged = d.maxResidual() <= d.tolerance;
+    double damping = kInitialDamping;
+    double growth = 2.0;
+    d.lastIterations = 0;
+
+    std::vector<double> savedParams, savedResidual, savedRows;
+    std::vector<double> step;
+    for (int iter = 0; !converged && iter < d.maxIterations; ++iter) {
+        d.formNormalMatrix(damping);
+        if (!d.ldl.factor(d.ap, d.ai, d.ax)) {
+            damping *= growth;
+            growth *= 2.0;
+            if (damping > kMaxDamping) break;
+            continue;
+        }
+
+        // Minimum-norm Newton step: δ = −S·Jᵀ·(J·Jᵀ + λI)⁻¹·r, with J
+        // already column-scaled by S
+        step.assign(d.residual.begin(), d.residual.end());
+        for (double& v : step) v = -v;
+        d.ldl.solve(step);
+
+        // The linear model predicts a new cost of λ²·|y|²
+        double stepNorm2 = 0.0;
+        for (double v : step) stepNorm2 += v * v;
+        double predicted = cost - damping * damping * stepNorm2;
+
+        savedParams = d.params;
+        savedResidual = d.residual;
+        savedRows = d.rowValue;
+        for (size_t r = 0; r < d.equations.size(); ++r) {
+            for (int e = d.rowStart[r]; e < d.rowStart[r + 1]; ++e) {
+                int p = d.columnParam[d.rowColumn[e]];
+                d.params[p] += d.scale[p] * d.rowValue[e] * step[r];
+            }
+        }
+        ++d.lastIterations;
+
+        // Damping follows the ratio of actual to predicted reduction
+        // (Nielsen's update), which avoids the oscillation of a fixed
+        // ×10 / ÷10 schedule on strongly nonlinear sketches
+        double newCost = d.evaluate();
+        double gain = predicted > 0.0 ? (cost - newCost) / predicted : -1.0;
+        if (newCost < cost && gain > 0.0) {
+            cost = newCost;
+            double t = 2.0 * gain - 1.0;
+            damping = std::max(damping * std::max(1.0 / 3.0, 1.0 - t * t * t), kMinDamping);
+            growth = 2.0;
+            converged = d.maxResidual() <= d.tolerance;
+        } else {
+            d.params.swap(savedParams);
+            d.residual.swap(savedResidual);
+            d.rowValue.swap(savedRows);
+            damping *= growth;
+            growth *= 2.0;
+            if (damping > kMaxDamping) break;
+        }
+    }
+
+    // DOF = free parameters − rank(J)
+    std::vector<int> dependent;
+    if (d.diagnostics) {
+        dependent = d.dependentRows();
+        int rank = static_cast<int>(d.equations.size() - dependent.size());
+        result.dof = d.freeParameterCount() - rank;
+    } else {
+        result.dof = -1;
+    }
+
+    if (converged) {
+        result.success = true;
+        result.resultCode = dependent.empty() ? SolveResult::Okay : SolveResult::RedundantOkay;
+        return result;
+    }
+
+    // Report constraints left unsatisfied, plus those whose equations
+    // depend on others (the likely conflict)
+    std::vector<char> failed(d.equations.size(), 0);
+    for (size_t r = 0; r < d.equations.size(); ++r) {
+        if (std::abs(d.residual[r]) > d.tolerance) failed[r] = 1;
+    }
+    for (int r : dependent) failed[r] = 1;
+    for (size_t r = 0; r < d.equations.size(); ++r) {
+        if (!failed[r]) continue;
+        int id = d.equations[r].constraintId;
+        if (std::find(result.failedConstraintIds.begin(),
+                      result.failedConstraintIds.end(), id) == result.failedConstraintIds.end()) {
+            result.failedConstraintIds.push_back(id);
+        }
+    }
+
+    result.success = false;
+    result.resultCode = dependent.empty() ? SolveResult::DidntConverge : SolveResult::Inconsistent;
+    result.errorMessage = solveResultName(result.resultCode);
+    return result;
+}
+
+void NativeSolver::applyTo(std::vector<Entity>& entities) const
+{
+    const std::vector<double>& x = m_impl->params;
+    for (Entity& entity : entities) {
+        auto it = m_impl->slots.find(entity.id);
+        if (it == m_impl->slots.end()) continue;
+        int p = it->second.param;
+
+        switch (entity.type) {
+        case EntityType::Point:
+            if (entity.points.empty()) break;
+            entity.points[0] = Point2D(x[p], x[p + 1]);
+            break;
+        case EntityType::Line:
+            if (entity.points.size() < 2) break;
+            entity.points[0] = Point2D(x[p], x[p + 1]);
+            entity.points[1] = Point2D(x[p + 2], x[p + 3]);
+            break;
+        case EntityType::Circle:
+        case EntityType::Arc:
+            if (entity.points.empty()) break;
+            entity.points[0] = Point2D(x[p], x[p + 1]);
+            entity.radius = x[p + 2];
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void NativeSolver::updateValues(const std::vector<Entity>& entities)
+{
+    std::vector<double>& x = m_impl->params;
+    for (const Entity& entity : entities) {
+        auto it = m_impl->slots.find(entity.id);
+        if (it == m_impl->slots.end()) continue;
+        int p = it->second.param;
+
+        switch (it->second.type) {
+        case EntityType::Point:
+            if (entity.points.empty()) break;
+            x[p] = entity.points[0].x;
+            x[p + 1] = entity.points[0].y;
+            break;
+        case EntityType::Line:
+            if (entity.points.size() < 2) break;
+            x[p] = entity.points[0].x;
+            x[p + 1] = entity.points[0].y;
+            x[p + 2] = entity.points[1].x;
+            x[p + 3] = entity.points[1].y;
+            break;
+        case EntityType::Circle:
+        case EntityType::Arc:
+            if (entity.points.empty()) break;
+            x[p] = entity.points[0].x;
+            x[p + 1] = entity.points[0].y;
+            x[p + 2] = entity.radius;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+bool NativeSolver::setPoint(int entityId, int pointIndex, const Point2D& position)
+{
+    int p = m_impl->pointParam(entityId, pointIndex);
+    if (p < 0) return false;
+    m_impl->params[p] = position.x;
+    m_impl->params[p + 1] = position.y;
+    return true;
+}
+
+bool NativeSolver::setDragged(int entityId, int pointIndex)
+{
+    int p = m_impl->pointParam(entityId, pointIndex);
+    if (p < 0) return false;
+    m_impl->scale[p] = kDraggedScale;
+    m_impl->scale[p + 1] = kDraggedScale;
+    return true;
+}
+
+void NativeSolver::clearDragged()
+{
+    std::fill(m_impl->scale.begin(), m_impl->scale.end(), 1.0);
+}
+
+bool NativeSolver::addIfIndependent(const Constraint& constraint)
+{
+    Impl& d = *m_impl;
+    if (!constraint.enabled || constraint.type == ConstraintType::FixedPoint) return false;
+
+    // Bring the equations from build() into the basis first; those
+    // that depend on others are simply left out of it
+    for (; d.basisEquations < d.equations.size(); ++d.basisEquations) {
+        d.reduceIntoBasis(d.equations[d.basisEquations]);
+    }
+
+    size_t first = d.equations.size();
+    size_t basisSize = d.basis.size();
+    d.addConstraint(constraint);
+    if (d.equations.size() == first) return false;
+
+    for (size_t r = first; r < d.equations.size(); ++r) {
+        if (d.reduceIntoBasis(d.equations[r])) continue;
+
+        // Roll back the rows this constraint already added
+        for (size_t k = basisSize; k < d.basis.size(); ++k) {
+            d.pivotRow[d.basis[k].pivot] = -1;
+        }
+        d.basis.resize(basisSize);
+        d.equations.resize(first);
+        return false;
+    }
+
+    d.basisEquations = d.equations.size();
+    d.analyzed = false;
+    return true;
+}
+
+int NativeSolver::degreesOfFreedom() const
+{
+    m_impl->ensureAnalyzed();
+    int rank = static_cast<int>(m_impl->equations.size()) -
+               static_cast<int>(m_impl->dependentRows().size());
+    return m_impl->freeParameterCount() - rank;
+}
+
+int NativeSolver::parameterCount() const
+{
+    return static_cast<int>(m_impl->params.size());
+}
+
+int NativeSolver::equationCount() const
+{
+    return static_cast<int>(m_impl->equations.size());
+}
+
+void NativeSolver::setMaxIterations(int iterations)
+{
+    m_impl->maxIterations = std::max(1, iterations);
+}
+
+int NativeSolver::maxIterations() const
+{
+    return m_impl->maxIterations;
+}
+
+void NativeSolver::setTolerance(double tolerance)
+{
+    m_impl->tolerance = tolerance > 0.0 ? tolerance : kDefaultTolerance;
+}
+
+double NativeSolver::tolerance() const
+{
+    return m_impl->tolerance;
+}
+
+void NativeSolver::setDiagnostics(bool enabled)
+{
+    m_impl->diagnostics = enabled;
+}
+
+bool NativeSolver::diagnostics() const
+{
+    return m_impl->diagnostics;
+}
+
+int NativeSolver::lastIterations() const
+{
+    return m_impl->lastIterations;
+}
+
+}  // namespace sketch
+}  // namespace hobbycad
@@ -8,7 +8,10 @@
 // =====================================================================
 
 #include <hobbycad/sketch/operations.h>
+#include <hobbycad/sketch/entity_store.h>
 #include <hobbycad/geometry/intersections.h>
+#include <hobbycad/geometry/scratch.h>
+#include <hobbycad/geometry/spline.h>
 #include <hobbycad/geometry/utils.h>
 
 #include <queue>
@@ -29,12 +32,65 @@ using namespace geometry;
 //  Intersection Detection
 // =====================================================================
 
-std::vector<Intersection> findIntersection(const Entity& e1, const Entity& e2)
+namespace {
+
+// Append the intersections between e1 and e2 (Entity or EntityView)
+// to results, so callers looping over many pairs can collect them
+// without a vector per pair
+template<typename E, typename Out>
+void appendIntersections(const E& e1, const E& e2, Out& results)
 {
-    std::vector<Intersection> results;
+    auto isCurveOrLine = [](EntityType type) {
+        return type == EntityType::Line || type == EntityType::Circle ||
+               type == EntityType::Arc;
+    };
+
+    // Spline-Line / Spline-Circle / Spline-Arc; the spline parameter is
+    // the arc-length fraction, as in pointAtParameter()
+    if (e1.type == EntityType::Spline && isCurveOrLine(e2.type)) {
+        auto curve = e1.splineCurve();
+        if (!curve || e2.points.size() < (e2.type == EntityType::Line ? 2u : 1u))
+            return;
 
+        Arc arc;
+        std::vector<double> params;
+        if (e2.type == EntityType::Line) {
+            params = curve->intersectSegment(e2.points[0], e2.points[1]);
+        } else {
+            arc.center = e2.points[0];
+            arc.radius = e2.radius;
+            arc.startAngle = e2.startAngle;
+            arc.sweepAngle = e2.sweepAngle;
+            params = curve->intersectCircle(arc.center, arc.radius);
+        }
+
+        double total = params.empty() ? 0.0 : curve->length();
+        for (double t : params) {
+            Point2D p = curve->point(t);
+            if (e2.type == EntityType::Arc && !pointOnArc(p, arc))
+                continue;
+
+            Intersection inter;
+            inter.entityId1 = e1.id;
+            inter.entityId2 = e2.id;
+            inter.point = p;
+            inter.param1 = total > 0.0 ? curve->lengthAt(t) / total : 0.0;
+            if (e2.type == EntityType::Line)
+                inter.param2 = projectPointOnLine(p, e2.points[0], e2.points[1]);
+            results.push_back(inter);
+        }
+    }
+    // Line/Circle/Arc-Spline (swap arguments)
+    else if (isCurveOrLine(e1.type) && e2.type == EntityType::Spline) {
+        size_t first = results.size();
+        appendIntersections(e2, e1, results);
+        for (size_t i = first; i < results.size(); ++i) {
+            std::swap(results[i].entityId1, results[i].entityId2);
+            std::swap(results[i].param1, results[i].param2);
+        }
+    }
     // Line-Line
-    if (e1.type == EntityType::Line && e2.type == EntityType::Line) {
+    else if (e1.type == EntityType::Line && e2.type == EntityType::Line) {
         if (e1.points.size() >= 2 && e2.points.size() >= 2) {
             LineLineIntersection lli = lineLineIntersection(
                 e1.points[0], e1.points[1],
@@ -107,13 +163,11 @@ std::vector<Intersection> findIntersection(const Entity& e1, const Entity& e2)
     // Circle-Line (swap arguments)
     else if ((e1.type == EntityType::Circle || e1.type == EntityType::Arc) &&
              e2.type == EntityType::Line) {
-        auto swapped = findIntersection(e2, e1);
-        for (auto& inter : swapped) {
-            std::swap(inter.entityId1, inter.entityId2);
-            std::swap(inter.param1, inter.param2);
-        }
-        for (auto& inter : swapped) {
-            results.push_back(inter);
+        size_t first = results.size();
+        appendIntersections(e2, e1, results);
+        for (size_t i = first; i < results.size(); ++i) {
+            std::swap(results[i].entityId1, results[i].entityId2);
+            std::swap(results[i].param1, results[i].param2);
         }
     }
     // Circle-Circle
@@ -171,43 +225,96 @@ std::vector<Intersection> findIntersection(const Entity& e1, const Entity& e2)
             }
         }
     }
+}
 
-    return results;
+/// Entities as a random-access array for the pairwise loops below.  A
+/// vector is used as is; a store's views are built once here instead
+/// of once per pair.
+const std::vector<Entity>& entityArray(
+    const std::vector<Entity>& entities, ScratchVector<EntityView>&)
+{
+    return entities;
 }
 
-std::vector<Intersection> findIntersections(
-    const Entity& entity,
-    const std::vector<Entity>& others)
+const ScratchVector<EntityView>& entityArray(
+    const EntityStore& entities, ScratchVector<EntityView>& views)
+{
+    views.reserve(entities.size());
+    for (const EntityView& view : entities) views.push_back(view);
+    return views;
+}
+
+template <typename E, typename Range>
+std::vector<Intersection> findIntersectionsImpl(const E& entity, const Range& others)
 {
     std::vector<Intersection> results;
 
-    for (const Entity& other : others) {
+    for (const auto& other : others) {
         if (other.id == entity.id) continue;
-        auto inters = findIntersection(entity, other);
-        for (auto& inter : inters) {
-            results.push_back(inter);
-        }
+        appendIntersections(entity, other, results);
     }
 
     return results;
 }
 
-std::vector<Intersection> findAllIntersections(const std::vector<Entity>& entities)
+template <typename Range>
+std::vector<Intersection> findAllIntersectionsImpl(const Range& entities)
 {
     std::vector<Intersection> results;
 
-    for (int i = 0; i < static_cast<int>(entities.size()); ++i) {
-        for (int j = i + 1; j < static_cast<int>(entities.size()); ++j) {
-            auto inters = findIntersection(entities[i], entities[j]);
-            for (auto& inter : inters) {
-                results.push_back(inter);
-            }
+    ScratchArena arena;
+    ScratchVector<EntityView> views(arena.resource());
+    const auto& array = entityArray(entities, views);
+
+    for (int i = 0; i < static_cast<int>(array.size()); ++i) {
+        for (int j = i + 1; j < static_cast<int>(array.size()); ++j) {
+            appendIntersections(array[i], array[j], results);
         }
     }
 
     return results;
 }
 
+}  // anonymous namespace
+
+std::vector<Intersection> findIntersection(const Entity& e1, const Entity& e2)
+{
+    std::vector<Intersection> results;
+    appendIntersections(e1, e2, results);
+    return results;
+}
+
+std::vector<Intersection> findIntersection(const EntityView& e1, const EntityView& e2)
+{
+    std::vector<Intersection> results;
+    appendIntersections(e1, e2, results);
+    return results;
+}
+
+std::vector<Intersection> findIntersections(
+    const Entity& entity,
+    const std::vector<Entity>& others)
+{
+    return findIntersectionsImpl(entity, others);
+}
+
+std::vector<Intersection> findIntersections(
+    const EntityView& entity,
+    const EntityStore& others)
+{
+    return findIntersectionsImpl(entity, others);
+}
+
+std::vector<Intersection> findAllIntersections(const std::vector<Entity>& entities)
+{
+    return findAllIntersectionsImpl(entities);
+}
+
+std::vector<Intersection> findAllIntersections(const EntityStore& entities)
+{
+    return findAllIntersectionsImpl(entities);
+}
+
 // =====================================================================
 //  Offset Operation
 // =====================================================================
@@ -504,9 +611,12 @@ TrimResult trimEntity(
         return result;
     }
 
+    ScratchArena arena;
+
     if (entity.type == EntityType::Line && entity.points.size() >= 2) {
         // Sort intersections by parameter along line
-        std::vector<double> params;
+        ScratchVector<double> params(arena.resource());
+        params.reserve(intersections.size() + 2);
         for (const Point2D& pt : intersections) {
             double t = projectPointOnLine(pt, entity.points[0], entity.points[1]);
             if (t > 0.001 && t < 0.999) {
@@ -555,7 +665,8 @@ TrimResult trimEntity(
         }
 
         // Calculate angles for each intersection
-        std::vector<double> angles;
+        ScratchVector<double> angles(arena.resource());
+        angles.reserve(intersections.size());
         for (const Point2D& pt : intersections) {
             double angle = std::atan2(
                 pt.y - entity.points[0].y,
@@ -633,14 +744,18 @@ ExtendResult extendEntity(
     double bestDist = std::numeric_limits<double>::max();
     Point2D bestPoint = extendPoint;
 
+    // Create extended line (project far)
+    Point2D farPoint = extendPoint + dir * 10000.0;
+    Entity ray = createLine(-1, anchorPoint, farPoint);
+
+    ScratchArena arena;
+    ScratchVector<Intersection> intersections(arena.resource());
+
     for (const Entity& boundary : boundaries) {
         if (boundary.id == entity.id) continue;
 
-        // Create extended line (project far)
-        Point2D farPoint = extendPoint + dir * 10000.0;
-
-        auto intersections = findIntersection(
-            createLine(-1, anchorPoint, farPoint), boundary);
+        intersections.clear();
+        appendIntersections(ray, boundary, intersections);
 
         for (const Intersection& inter : intersections) {
             // Must be in extension direction
@@ -755,7 +870,9 @@ SplitResult splitEntityAtIntersections(
 
     if (entity.type == EntityType::Line && entity.points.size() >= 2) {
         // Sort intersections by parameter
-        std::vector<double> params;
+        ScratchArena arena;
+        ScratchVector<double> params(arena.resource());
+        params.reserve(intersections.size() + 2);
         params.push_back(0.0);
         for (const Point2D& pt : intersections) {
             double t = projectPointOnLine(pt, entity.points[0], entity.points[1]);
@@ -803,11 +920,18 @@ SplitResult splitEntityAtIntersections(
 //  Chain Selection
 // =====================================================================
 
-std::vector<int> findConnectedChain(
+namespace {
+
+template <typename Range>
+std::vector<int> findConnectedChainImpl(
     int startId,
-    const std::vector<Entity>& entities,
+    const Range& entities,
     double tolerance)
 {
+    ScratchArena arena;
+    ScratchVector<EntityView> views(arena.resource());
+    const auto& array = entityArray(entities, views);
+
     std::unordered_set<int> visited;
     std::vector<int> result;
     std::queue<int> queue;
@@ -822,19 +946,19 @@ std::vector<int> findConnectedChain(
         result.push_back(currentId);
 
         // Find the current entity
-        const Entity* current = nullptr;
-        for (const Entity& e : entities) {
-            if (e.id == currentId) {
-                current = &e;
+        int current = -1;
+        for (int i = 0; i < static_cast<int>(array.size()); ++i) {
+            if (array[i].id == currentId) {
+                current = i;
                 break;
             }
         }
-        if (!current) continue;
+        if (current < 0) continue;
 
         // Find connected entities
-        for (const Entity& other : entities) {
+        for (const auto& other : array) {
             if (visited.count(other.id) > 0) continue;
-            if (entitiesConnected(*current, other, tolerance)) {
+            if (entitiesConnected(array[current], other, tolerance)) {
                 queue.push(other.id);
             }
         }
@@ -843,6 +967,24 @@ std::vector<int> findConnectedChain(
     return result;
 }
 
+}  // anonymous namespace
+
+std::vector<int> findConnectedChain(
+    int startId,
+    const std::vector<Entity>& entities,
+    double tolerance)
+{
+    return findConnectedChainImpl(startId, entities, tolerance);
+}
+
+std::vector<int> findConnectedChain(
+    int startId,
+    const EntityStore& entities,
+    double tolerance)
+{
+    return findConnectedChainImpl(startId, entities, tolerance);
+}
+
 int findConnectedLineAtCorner(
     const Entity& lineEntity,
     const std::vector<Entity>& allEntities,
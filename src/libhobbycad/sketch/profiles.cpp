@@ -8,13 +8,17 @@
 // =====================================================================
 
 #include <hobbycad/sketch/profiles.h>
+#include <hobbycad/sketch/entity_store.h>
+#include <hobbycad/geometry/scratch.h>
 #include <hobbycad/geometry/utils.h>
 
 #include <algorithm>
 #include <cmath>
 #include <map>
+#include <optional>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 #ifndef M_PI
@@ -43,16 +47,38 @@ const Entity* findEntityById(const std::vector<Entity>& entities, int id)
     return nullptr;
 }
 
-/// Get endpoints of an entity (returns 0, 1, or 2 points)
-std::vector<Point2D> getEndpoints(const Entity& entity)
+/// Find entity by ID in a store (through its ID index)
+std::optional<EntityView> findEntityById(const EntityStore& entities, int id)
 {
-    return entity.endpoints();
+    int index = entities.indexOf(id);
+    if (index < 0) {
+        return std::nullopt;
+    }
+    return entities.view(index);
+}
+
+/// Entities as a random-access array.  A vector is used as is; a
+/// store's views are built once here instead of once per lookup.
+const std::vector<Entity>& entityArray(
+    const std::vector<Entity>& entities, ScratchVector<EntityView>&)
+{
+    return entities;
 }
 
-/// Discretize an entity into a series of points
-std::vector<Point2D> discretizeEntity(const Entity& entity, int segments)
+const ScratchVector<EntityView>& entityArray(
+    const EntityStore& entities, ScratchVector<EntityView>& views)
 {
-    std::vector<Point2D> points;
+    views.reserve(entities.size());
+    for (const EntityView& view : entities) views.push_back(view);
+    return views;
+}
+
+/// Discretize an entity into a series of points (replacing the
+/// contents of points, so one buffer can be reused across entities)
+template <typename E>
+void discretizeEntity(const E& entity, int segments, ScratchVector<Point2D>& points)
+{
+    points.clear();
 
     switch (entity.type) {
     case EntityType::Point:
@@ -105,16 +131,22 @@ std::vector<Point2D> discretizeEntity(const Entity& entity, int segments)
         break;
 
     case EntityType::Polygon:
-        points = entity.points;
+        points.assign(entity.points.begin(), entity.points.end());
         if (!points.empty() && !(points.front() == points.back())) {
             points.push_back(points.front());
         }
         break;
 
     case EntityType::Spline:
-        // For splines, use the control points as approximation
-        // A proper implementation would evaluate the spline
-        points = entity.points;
+        if (auto curve = entity.splineCurve()) {
+            // Same sagitta as a circle of the spline's size split into
+            // segments
+            BoundingBox box = curve->boundingBox();
+            double radius = 0.5 * std::hypot(box.width(), box.height());
+            std::vector<Point2D> polyline =
+                curve->tessellate(radius * (1.0 - std::cos(M_PI / segments)));
+            points.assign(polyline.begin(), polyline.end());
+        }
         break;
 
     case EntityType::Ellipse:
@@ -165,8 +197,6 @@ std::vector<Point2D> discretizeEntity(const Entity& entity, int segments)
         // Text doesn't contribute to profiles
         break;
     }
-
-    return points;
 }
 
 /// Check if two points are the same within tolerance
@@ -180,7 +210,7 @@ void findCyclesDFS(
     const ConnectivityGraph& graph,
     int currentNode,
     int startNode,
-    std::vector<int>& currentPath,
+    ScratchVector<int>& currentPath,
     std::set<std::pair<int, int>>& usedEdges,
     std::vector<std::vector<int>>& cycles,
     int maxCycles,
@@ -207,14 +237,16 @@ void findCyclesDFS(
 
         if (otherNode == startNode && currentPath.size() >= 2) {
             // Found a cycle
-            std::vector<int> cycle = currentPath;
+            std::vector<int> cycle;
+            cycle.reserve(currentPath.size() + 1);
+            cycle.assign(currentPath.begin(), currentPath.end());
             cycle.push_back(startNode);
-            cycles.push_back(cycle);
+            cycles.push_back(std::move(cycle));
             continue;
         }
 
         // Check if we've already visited this node in current path
-        if (hobbycad::contains(currentPath, otherNode)) {
+        if (std::find(currentPath.begin(), currentPath.end(), otherNode) != currentPath.end()) {
             continue;
         }
 
@@ -267,9 +299,10 @@ bool Profile::containsPoint(const Point2D& point) const
 //  Connectivity Graph
 // =====================================================================
 
-ConnectivityGraph buildConnectivityGraph(
-    const std::vector<Entity>& entities,
-    double tolerance)
+namespace {
+
+template <typename Range>
+ConnectivityGraph buildConnectivityGraphImpl(const Range& entities, double tolerance)
 {
     ConnectivityGraph graph;
 
@@ -302,13 +335,13 @@ ConnectivityGraph buildConnectivityGraph(
     };
 
     // Build nodes and edges
-    for (const Entity& entity : entities) {
+    for (const auto& entity : entities) {
         // Skip construction geometry
         if (entity.isConstruction) {
             continue;
         }
 
-        std::vector<Point2D> endpoints = getEndpoints(entity);
+        std::vector<Point2D> endpoints = entity.endpoints();
 
         if (endpoints.size() == 2) {
             // Entity with two endpoints (line, arc, etc.)
@@ -345,6 +378,22 @@ ConnectivityGraph buildConnectivityGraph(
     return graph;
 }
 
+}  // anonymous namespace
+
+ConnectivityGraph buildConnectivityGraph(
+    const std::vector<Entity>& entities,
+    double tolerance)
+{
+    return buildConnectivityGraphImpl(entities, tolerance);
+}
+
+ConnectivityGraph buildConnectivityGraph(
+    const EntityStore& entities,
+    double tolerance)
+{
+    return buildConnectivityGraphImpl(entities, tolerance);
+}
+
 std::vector<std::vector<int>> findCycles(
     const ConnectivityGraph& graph,
     int maxCycles)
@@ -355,9 +404,12 @@ std::vector<std::vector<int>> findCycles(
         return cycles;
     }
 
+    ScratchArena arena;
+    ScratchVector<int> currentPath(arena.resource());
+
     // Try starting from each node
     for (int startNode = 0; startNode < static_cast<int>(graph.nodes.size()) && static_cast<int>(cycles.size()) < maxCycles; ++startNode) {
-        std::vector<int> currentPath;
+        currentPath.clear();
         currentPath.push_back(startNode);
         std::set<std::pair<int, int>> usedEdges;
 
@@ -369,11 +421,15 @@ std::vector<std::vector<int>> findCycles(
     std::vector<std::vector<int>> uniqueCycles;
     std::set<std::string> seenCycles;
 
+    ScratchVector<int> normalized(arena.resource());
+    ScratchVector<int> rotated(arena.resource());
+    ScratchVector<int> reversed(arena.resource());
+
     for (const std::vector<int>& cycle : cycles) {
         if (cycle.size() < 3) continue;
 
         // Create canonical representation (start from minimum node, in sorted direction)
-        std::vector<int> normalized = cycle;
+        normalized.assign(cycle.begin(), cycle.end());
         normalized.pop_back();  // Remove duplicate end
 
         // Find minimum element
@@ -385,19 +441,19 @@ std::vector<std::vector<int>> findCycles(
         }
 
         // Rotate to start from minimum
-        std::vector<int> rotated;
+        rotated.clear();
         for (int i = 0; i < static_cast<int>(normalized.size()); ++i) {
             rotated.push_back(normalized[(minIdx + i) % normalized.size()]);
         }
 
         // Check direction and reverse if needed for canonical form
         if (rotated.size() >= 2 && rotated[1] > rotated.back()) {
-            std::vector<int> reversed;
+            reversed.clear();
             reversed.push_back(rotated[0]);
             for (int i = static_cast<int>(rotated.size()) - 1; i >= 1; --i) {
                 reversed.push_back(rotated[i]);
             }
-            rotated = reversed;
+            rotated.swap(reversed);
         }
 
         // Create key
@@ -409,7 +465,7 @@ std::vector<std::vector<int>> findCycles(
         if (seenCycles.count(key) == 0) {
             seenCycles.insert(key);
             rotated.push_back(rotated.front());  // Re-add closing node
-            uniqueCycles.push_back(rotated);
+            uniqueCycles.emplace_back(rotated.begin(), rotated.end());
         }
     }
 
@@ -420,24 +476,36 @@ std::vector<std::vector<int>> findCycles(
 //  Profile Detection
 // =====================================================================
 
-std::vector<Profile> detectProfiles(
-    const std::vector<Entity>& entities,
+namespace {
+
+template <typename Range>
+std::vector<Profile> detectProfilesImpl(
+    const Range& entities,
     const ProfileDetectionOptions& options)
 {
     std::vector<Profile> profiles;
 
-    // Filter entities
-    std::vector<Entity> filteredEntities;
-    for (const Entity& e : entities) {
-        if (options.excludeConstruction && e.isConstruction) {
+    ScratchArena arena;
+    ScratchVector<Point2D> pts(arena.resource());
+    ScratchVector<Point2D> polygonPoints(arena.resource());
+    ScratchVector<EntityView> views(arena.resource());
+    const auto& array = entityArray(entities, views);
+
+    // Filter entities by index, and look them up by ID (first wins)
+    ScratchVector<int> filtered(arena.resource());
+    std::unordered_map<int, int> indexById;
+    for (int i = 0; i < static_cast<int>(array.size()); ++i) {
+        if (options.excludeConstruction && array[i].isConstruction) {
             continue;
         }
-        filteredEntities.push_back(e);
+        filtered.push_back(i);
+        indexById.emplace(array[i].id, i);
     }
 
     // Handle closed entities (circles, ellipses, closed polygons) as profiles
     int profileId = 1;
-    for (const Entity& entity : filteredEntities) {
+    for (int index : filtered) {
+        const auto& entity = array[index];
         bool isClosed = false;
 
         switch (entity.type) {
@@ -467,7 +535,8 @@ std::vector<Profile> detectProfiles(
             profile.id = profileId++;
             profile.entityIds.push_back(entity.id);
             profile.reversed.push_back(false);
-            profile.polygon = discretizeEntity(entity, options.polygonSegments);
+            discretizeEntity(entity, options.polygonSegments, pts);
+            profile.polygon.assign(pts.begin(), pts.end());
             profile.area = polygonArea(profile.polygon);
             profile.isOuter = true;
             profile.bounds = entity.boundingBox();
@@ -480,8 +549,9 @@ std::vector<Profile> detectProfiles(
         }
     }
 
-    // Build connectivity graph for open entities
-    ConnectivityGraph graph = buildConnectivityGraph(filteredEntities, options.tolerance);
+    // Build connectivity graph for open entities (construction geometry
+    // never enters the graph, so the unfiltered array gives the same one)
+    ConnectivityGraph graph = buildConnectivityGraphImpl(array, options.tolerance);
 
     // Find cycles
     std::vector<std::vector<int>> cycles = findCycles(graph, options.maxProfiles - profiles.size());
@@ -496,7 +566,7 @@ std::vector<Profile> detectProfiles(
         profile.id = profileId++;
 
         // Convert node cycle to entity IDs
-        std::vector<Point2D> polygonPoints;
+        polygonPoints.clear();
 
         for (int i = 0; i < static_cast<int>(cycle.size()) - 1; ++i) {
             int nodeA = cycle[i];
@@ -513,9 +583,9 @@ std::vector<Profile> detectProfiles(
                     profile.reversed.push_back(reversed);
 
                     // Add discretized points
-                    const Entity* entity = findEntityById(filteredEntities, edge.entityId);
-                    if (entity) {
-                        std::vector<Point2D> pts = discretizeEntity(*entity, options.polygonSegments);
+                    auto it = indexById.find(edge.entityId);
+                    if (it != indexById.end()) {
+                        discretizeEntity(array[it->second], options.polygonSegments, pts);
                         if (reversed) {
                             std::reverse(pts.begin(), pts.end());
                         }
@@ -532,8 +602,8 @@ std::vector<Profile> detectProfiles(
         }
 
         if (!polygonPoints.empty()) {
-            profile.polygon = polygonPoints;
-            profile.area = polygonArea(polygonPoints);
+            profile.polygon.assign(polygonPoints.begin(), polygonPoints.end());
+            profile.area = polygonArea(profile.polygon);
             profile.isOuter = true;
 
             // Calculate bounds
@@ -548,54 +618,171 @@ std::vector<Profile> detectProfiles(
     return profiles;
 }
 
+}  // anonymous namespace
+
+std::vector<Profile> detectProfiles(
+    const std::vector<Entity>& entities,
+    const ProfileDetectionOptions& options)
+{
+    return detectProfilesImpl(entities, options);
+}
+
+std::vector<Profile> detectProfiles(
+    const EntityStore& entities,
+    const ProfileDetectionOptions& options)
+{
+    return detectProfilesImpl(entities, options);
+}
+
 std::vector<Profile> detectProfilesWithHoles(
     const std::vector<Entity>& entities,
     const ProfileDetectionOptions& options)
 {
     std::vector<Profile> profiles = detectProfiles(entities, options);
+    buildContainmentTree(profiles);
+    return profiles;
+}
 
-    if (profiles.size() < 2) {
-        return profiles;
-    }
+std::vector<Profile> detectProfilesWithHoles(
+    const EntityStore& entities,
+    const ProfileDetectionOptions& options)
+{
+    std::vector<Profile> profiles = detectProfiles(entities, options);
+    buildContainmentTree(profiles);
+    return profiles;
+}
 
-    // Sort profiles by area (largest first)
-    std::sort(profiles.begin(), profiles.end(), [](const Profile& a, const Profile& b) {
+void buildContainmentTree(std::vector<Profile>& profiles)
+{
+    // Sort profiles by area (largest first), so every profile that can
+    // contain another comes before it
+    std::stable_sort(profiles.begin(), profiles.end(), [](const Profile& a, const Profile& b) {
         return std::abs(a.area) > std::abs(b.area);
     });
 
-    // Determine containment
-    for (int i = 0; i < static_cast<int>(profiles.size()); ++i) {
-        for (int j = i + 1; j < static_cast<int>(profiles.size()); ++j) {
-            if (profiles[i].contains(profiles[j])) {
-                // j is inside i
-                // If i is outer, j is inner. If i is inner, j is outer again.
-                profiles[j].isOuter = !profiles[i].isOuter;
+    BoundingBox extent;
+    for (Profile& profile : profiles) {
+        profile.isOuter = true;
+        profile.parentId = 0;
+        if (profile.bounds.valid) {
+            extent.include(profile.bounds);
+        }
+    }
+
+    if (profiles.size() < 2 || !extent.valid) {
+        return;
+    }
+
+    // Uniform grid over all profiles, about one cell per profile.  Each
+    // profile is registered in the cells its bounds overlap once it has
+    // been classified, and a profile can only be inside the ones
+    // registered in the cell holding its centroid.
+    const int n = static_cast<int>(profiles.size());
+    const int dim = std::min(256, std::max(1, static_cast<int>(std::ceil(std::sqrt(double(n))))));
+    const double cellW = std::max(extent.width() / dim, POINT_TOLERANCE);
+    const double cellH = std::max(extent.height() / dim, POINT_TOLERANCE);
+
+    auto cellX = [&](double x) {
+        return std::clamp(static_cast<int>((x - extent.minX) / cellW), 0, dim - 1);
+    };
+    auto cellY = [&](double y) {
+        return std::clamp(static_cast<int>((y - extent.minY) / cellH), 0, dim - 1);
+    };
+
+    std::vector<std::vector<int>> cells(static_cast<size_t>(dim) * dim);
+
+    for (int i = 0; i < n; ++i) {
+        Profile& profile = profiles[i];
+        if (!profile.bounds.valid || profile.polygon.empty()) {
+            continue;
+        }
+
+        // Candidates were registered in decreasing area order, so the
+        // last one containing this profile is its direct parent.
+        // If the parent is outer this is a hole, if the parent is a
+        // hole this is an island (outer again).
+        Point2D centroid = polygonCentroid(profile.polygon);
+        const std::vector<int>& candidates = cells[cellY(centroid.y) * dim + cellX(centroid.x)];
+        for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
+            const Profile& parent = profiles[*it];
+            if (parent.contains(profile)) {
+                profile.parentId = parent.id;
+                profile.isOuter = !parent.isOuter;
+                break;
+            }
+        }
+
+        for (int y = cellY(profile.bounds.minY); y <= cellY(profile.bounds.maxY); ++y) {
+            for (int x = cellX(profile.bounds.minX); x <= cellX(profile.bounds.maxX); ++x) {
+                cells[y * dim + x].push_back(i);
             }
         }
     }
+}
 
-    return profiles;
+std::vector<ProfileRegion> profileRegions(const std::vector<Profile>& profiles)
+{
+    std::vector<ProfileRegion> regions;
+    std::unordered_map<int, size_t> regionOf;  // outer profile ID -> region
+
+    for (const Profile& profile : profiles) {
+        if (profile.isOuter) {
+            regionOf[profile.id] = regions.size();
+            ProfileRegion region;
+            region.outer = profile;
+            regions.push_back(std::move(region));
+        }
+    }
+
+    for (const Profile& profile : profiles) {
+        if (profile.isOuter) continue;
+        auto it = regionOf.find(profile.parentId);
+        if (it != regionOf.end()) {
+            regions[it->second].holes.push_back(profile);
+        }
+    }
+
+    return regions;
+}
+
+std::vector<ProfileRegion> detectProfileRegions(
+    const std::vector<Entity>& entities,
+    const ProfileDetectionOptions& options)
+{
+    return profileRegions(detectProfilesWithHoles(entities, options));
+}
+
+std::vector<ProfileRegion> detectProfileRegions(
+    const EntityStore& entities,
+    const ProfileDetectionOptions& options)
+{
+    return profileRegions(detectProfilesWithHoles(entities, options));
 }
 
 // =====================================================================
 //  Profile Utilities
 // =====================================================================
 
-std::vector<Point2D> profileToPolygon(
+namespace {
+
+template <typename Entities>
+std::vector<Point2D> profileToPolygonImpl(
     const Profile& profile,
-    const std::vector<Entity>& entities,
+    const Entities& entities,
     int segments)
 {
-    std::vector<Point2D> points;
+    ScratchArena arena;
+    ScratchVector<Point2D> points(arena.resource());
+    ScratchVector<Point2D> entityPoints(arena.resource());
 
     for (int i = 0; i < static_cast<int>(profile.entityIds.size()); ++i) {
         int entityId = profile.entityIds[i];
         bool reversed = (i < static_cast<int>(profile.reversed.size())) ? profile.reversed[i] : false;
 
-        const Entity* entity = findEntityById(entities, entityId);
+        auto entity = findEntityById(entities, entityId);
         if (!entity) continue;
 
-        std::vector<Point2D> entityPoints = discretizeEntity(*entity, segments);
+        discretizeEntity(*entity, segments, entityPoints);
         if (reversed) {
             std::reverse(entityPoints.begin(), entityPoints.end());
         }
@@ -608,7 +795,25 @@ std::vector<Point2D> profileToPolygon(
         }
     }
 
-    return points;
+    return std::vector<Point2D>(points.begin(), points.end());
+}
+
+}  // anonymous namespace
+
+std::vector<Point2D> profileToPolygon(
+    const Profile& profile,
+    const std::vector<Entity>& entities,
+    int segments)
+{
+    return profileToPolygonImpl(profile, entities, segments);
+}
+
+std::vector<Point2D> profileToPolygon(
+    const Profile& profile,
+    const EntityStore& entities,
+    int segments)
+{
+    return profileToPolygonImpl(profile, entities, segments);
 }
 
 double profileArea(
@@ -619,6 +824,14 @@ double profileArea(
     return polygonArea(polygon);
 }
 
+double profileArea(
+    const Profile& profile,
+    const EntityStore& entities)
+{
+    std::vector<Point2D> polygon = profileToPolygon(profile, entities, 32);
+    return polygonArea(polygon);
+}
+
 bool profilesShareEdge(const Profile& p1, const Profile& p2)
 {
     for (int id1 : p1.entityIds) {
@@ -637,6 +850,14 @@ Point2D profileCentroid(
     return polygonCentroid(polygon);
 }
 
+Point2D profileCentroid(
+    const Profile& profile,
+    const EntityStore& entities)
+{
+    std::vector<Point2D> polygon = profileToPolygon(profile, entities, 32);
+    return polygonCentroid(polygon);
+}
+
 bool profileIsCCW(const Profile& profile)
 {
     return profile.area > 0;
@@ -656,9 +877,7 @@ Profile reverseProfile(const Profile& profile)
     std::reverse(reversed.reversed.begin(), reversed.reversed.end());
 
     // Reverse polygon
-    std::vector<Point2D> points = reversed.polygon;
-    std::reverse(points.begin(), points.end());
-    reversed.polygon = points;
+    std::reverse(reversed.polygon.begin(), reversed.polygon.end());
 
     // Negate area
     reversed.area = -reversed.area;
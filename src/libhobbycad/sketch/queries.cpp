@@ -119,14 +119,8 @@ double distanceToEntity(const Point2D& point, const Entity& entity)
         break;
 
     case EntityType::Spline:
-        if (entity.points.size() >= 2) {
-            // Approximate by checking control polygon
-            double minDist = std::numeric_limits<double>::max();
-            for (int i = 0; i < static_cast<int>(entity.points.size()) - 1; ++i) {
-                double d = pointToLineDistance(point, entity.points[i], entity.points[i+1]);
-                minDist = std::min(minDist, d);
-            }
-            return minDist;
+        if (auto curve = entity.splineCurve()) {
+            return curve->distanceTo(point);
         }
         break;
 
@@ -171,6 +165,12 @@ Point2D closestPointOnEntity(const Point2D& point, const Entity& entity)
         }
         break;
 
+    case EntityType::Spline:
+        if (auto curve = entity.splineCurve()) {
+            return curve->closestPoint(point);
+        }
+        break;
+
     default:
         // For complex entities, return nearest control point
         if (!entity.points.empty()) {
@@ -532,14 +532,10 @@ double entityLength(const Entity& entity)
         break;
 
     case EntityType::Spline:
-        // Approximate by summing control polygon segments
-        {
-            double len = 0.0;
-            for (int i = 0; i < static_cast<int>(entity.points.size()) - 1; ++i) {
-                len += std::hypot(entity.points[i].x - entity.points[i+1].x, entity.points[i].y - entity.points[i+1].y);
-            }
-            return len;
+        if (auto curve = entity.splineCurve()) {
+            return curve->length();
         }
+        return 0.0;
 
     case EntityType::Text:
         return 0.0;
@@ -615,23 +611,9 @@ Point2D pointAtParameter(const Entity& entity, double t)
         break;
 
     case EntityType::Spline:
-        // Simple linear interpolation along control polygon
-        if (entity.points.size() >= 2) {
-            double totalLen = 0.0;
-            for (int i = 0; i < static_cast<int>(entity.points.size()) - 1; ++i) {
-                totalLen += std::hypot(entity.points[i].x - entity.points[i+1].x, entity.points[i].y - entity.points[i+1].y);
-            }
-            double targetLen = t * totalLen;
-            double accumulated = 0.0;
-            for (int i = 0; i < static_cast<int>(entity.points.size()) - 1; ++i) {
-                double segLen = std::hypot(entity.points[i].x - entity.points[i+1].x, entity.points[i].y - entity.points[i+1].y);
-                if (accumulated + segLen >= targetLen) {
-                    double segT = (targetLen - accumulated) / segLen;
-                    return lerp(entity.points[i], entity.points[i+1], segT);
-                }
-                accumulated += segLen;
-            }
-            return entity.points.back();
+        // t is the fraction of the arc length
+        if (auto curve = entity.splineCurve()) {
+            return curve->point(curve->parameterAtLength(t * curve->length()));
         }
         break;
 
@@ -688,6 +670,16 @@ double parameterAtPoint(const Entity& entity, const Point2D& point)
         }
         break;
 
+    case EntityType::Spline:
+        if (auto curve = entity.splineCurve()) {
+            double length = curve->length();
+            if (length <= 0.0) return 0.0;
+            double u;
+            curve->closestPoint(point, &u);
+            return std::clamp(curve->lengthAt(u) / length, 0.0, 1.0);
+        }
+        break;
+
     default:
         break;
     }
@@ -726,6 +718,15 @@ Point2D tangentAtParameter(const Entity& entity, double t)
         }
         break;
 
+    case EntityType::Spline:
+        if (auto curve = entity.splineCurve()) {
+            Point2D tan = curve->tangent(curve->parameterAtLength(t * curve->length()));
+            if (lengthSquared(tan) > 0.0) {
+                return tan;
+            }
+        }
+        break;
+
     default:
         // Approximate by finite difference
         {
@@ -857,9 +858,9 @@ std::vector<Point2D> tessellate(const Entity& entity, double tolerance)
         break;
 
     case EntityType::Spline:
-        // For now, just use control points
-        // TODO: Proper spline evaluation
-        points = entity.points;
+        if (auto curve = entity.splineCurve()) {
+            points = curve->tessellate(tolerance);
+        }
         break;
 
     case EntityType::Text:
@@ -3,7 +3,10 @@
 // =====================================================================
 
 #include "../hobbycad/sketch/snap.h"
+#include "../hobbycad/sketch/entity_store.h"
 #include "../hobbycad/geometry/intersections.h"
+#include "../hobbycad/geometry/scratch.h"
+#include "../hobbycad/geometry/spline.h"
 
 #include <cmath>
 
@@ -14,6 +17,9 @@
 namespace hobbycad {
 namespace sketch {
 
+using geometry::ScratchArena;
+using geometry::ScratchVector;
+
 // =====================================================================
 //  defaultSnapWeight
 // =====================================================================
@@ -40,10 +46,16 @@ double defaultSnapWeight(SnapType type)
 //  collectSnapPoints  (single entity)
 // =====================================================================
 
-std::vector<SnapPoint> collectSnapPoints(const Entity& entity)
-{
-    std::vector<SnapPoint> points;
+// The collection and intersection routines below are written once for
+// any entity-like type with Entity's geometric fields, and instantiated
+// for both Entity and EntityView (see the public wrappers at the end).
+// They append to scratch vectors and take their own temporaries from
+// the same arena, so a whole snap query runs without heap traffic; the
+// public wrappers copy the result out.
 
+template <typename E>
+static void collectSnapPointsImpl(const E& entity, ScratchVector<SnapPoint>& points)
+{
     switch (entity.type) {
     case EntityType::Point:
         if (!entity.points.empty()) {
@@ -293,33 +305,46 @@ std::vector<SnapPoint> collectSnapPoints(const Entity& entity)
     default:
         break;
     }
-
-    return points;
 }
 
 // =====================================================================
 //  Intersection helpers
 // =====================================================================
 
+/// Number of sides of a Polygon entity.
+template <typename E>
+static int polygonSideCount(const E& entity)
+{
+    return entity.sides > 0 ? entity.sides : 6;
+}
+
+/// Vertex i of a Polygon entity, counting from the top.
+template <typename E>
+static Point2D polygonVertex(const E& entity, int i)
+{
+    double angleStep = 2.0 * M_PI / polygonSideCount(entity);
+    double angle = i * angleStep - M_PI / 2;  // Start at top
+    double r = entity.radius;
+    return entity.points[0] + Point2D(r * std::cos(angle), r * std::sin(angle));
+}
+
 /// Compute polygon vertices from center, radius, and side count.
-static std::vector<Point2D> computePolygonVertices(const Entity& entity)
+template <typename E>
+static void computePolygonVertices(const E& entity, ScratchVector<Point2D>& verts)
 {
-    std::vector<Point2D> verts;
+    verts.clear();
     if (entity.type != EntityType::Polygon || entity.points.empty())
-        return verts;
-    Point2D center = entity.points[0];
-    double r = entity.radius;
-    int sides = entity.sides > 0 ? entity.sides : 6;
-    double angleStep = 2.0 * M_PI / sides;
+        return;
+    int sides = polygonSideCount(entity);
+    verts.reserve(sides);
     for (int i = 0; i < sides; ++i) {
-        double angle = i * angleStep - M_PI / 2;  // Start at top
-        verts.push_back(center + Point2D(r * std::cos(angle), r * std::sin(angle)));
+        verts.push_back(polygonVertex(entity, i));
     }
-    return verts;
 }
 
 /// Build a geometry::Arc from a sketch Arc entity.
-static geometry::Arc entityToArc(const Entity& entity)
+template <typename E>
+static geometry::Arc entityToArc(const E& entity)
 {
     geometry::Arc arc;
     arc.center = entity.points[0];
@@ -337,30 +362,97 @@ static bool isEdgeBasedEntity(EntityType type)
         || type == EntityType::Polygon;
 }
 
+using EdgeList = ScratchVector<std::pair<Point2D, Point2D>>;
+
 /// Get ordered edge list for edge-based entities.
-static std::vector<std::pair<Point2D, Point2D>> entityEdges(const Entity& entity)
+template <typename E>
+static void entityEdges(const E& entity, EdgeList& edges)
 {
-    std::vector<std::pair<Point2D, Point2D>> edges;
+    edges.clear();
     if ((entity.type == EntityType::Rectangle || entity.type == EntityType::Parallelogram)
         && entity.points.size() >= 4) {
+        edges.reserve(4);
         for (int i = 0; i < 4; ++i)
             edges.push_back({entity.points[i], entity.points[(i + 1) % 4]});
-    } else if (entity.type == EntityType::Polygon) {
-        std::vector<Point2D> verts = computePolygonVertices(entity);
-        int n = static_cast<int>(verts.size());
-        for (int i = 0; i < n; ++i)
-            edges.push_back({verts[i], verts[(i + 1) % n]});
+    } else if (entity.type == EntityType::Polygon && !entity.points.empty()) {
+        int n = polygonSideCount(entity);
+        edges.reserve(n);
+        Point2D first = polygonVertex(entity, 0);
+        Point2D prev = first;
+        for (int i = 1; i < n; ++i) {
+            Point2D curr = polygonVertex(entity, i);
+            edges.push_back({prev, curr});
+            prev = curr;
+        }
+        edges.push_back({prev, first});
+    }
+}
+
+/// Crossings of a spline with another entity, as points on the spline.
+/// Spline-spline crossings are found against a fine tessellation of
+/// the other spline.
+template <typename E>
+static void splineIntersections(const geometry::BSplineCurve2D& curve,
+                                const E& other, ScratchVector<Point2D>& result)
+{
+    auto addSegment = [&](const Point2D& a, const Point2D& b) {
+        for (double t : curve.intersectSegment(a, b))
+            result.push_back(curve.point(t));
+    };
+
+    switch (other.type) {
+    case EntityType::Line:
+        if (other.points.size() >= 2)
+            addSegment(other.points[0], other.points[1]);
+        break;
+
+    case EntityType::Circle:
+    case EntityType::Arc:
+        if (!other.points.empty() && other.radius > 0) {
+            geometry::Arc arc = entityToArc(other);
+            for (double t : curve.intersectCircle(arc.center, arc.radius)) {
+                Point2D p = curve.point(t);
+                if (other.type == EntityType::Circle || geometry::pointOnArc(p, arc))
+                    result.push_back(p);
+            }
+        }
+        break;
+
+    case EntityType::Spline:
+        if (auto otherCurve = other.splineCurve()) {
+            std::vector<Point2D> poly = otherCurve->tessellate(geometry::POINT_TOLERANCE * 0.1);
+            for (size_t i = 1; i < poly.size(); ++i)
+                addSegment(poly[i - 1], poly[i]);
+        }
+        break;
+
+    default:
+        if (isEdgeBasedEntity(other.type)) {
+            EdgeList edges(result.get_allocator());
+            entityEdges(other, edges);
+            for (const auto& [p1, p2] : edges)
+                addSegment(p1, p2);
+        }
+        break;
     }
-    return edges;
 }
 
 // =====================================================================
 //  computeEntityIntersectionPoints
 // =====================================================================
 
-std::vector<Point2D> computeEntityIntersectionPoints(const Entity& e1, const Entity& e2)
+template <typename E>
+static void computeEntityIntersectionPointsImpl(
+    const E& e1, const E& e2, ScratchVector<Point2D>& result)
 {
-    std::vector<Point2D> result;
+    // Spline x anything: the spline kernel does the work
+    if (e1.type == EntityType::Spline || e2.type == EntityType::Spline) {
+        const E& spline = e1.type == EntityType::Spline ? e1 : e2;
+        const E& other = e1.type == EntityType::Spline ? e2 : e1;
+        if (auto curve = spline.splineCurve())
+            splineIntersections(*curve, other, result);
+        return;
+    }
 
     // Line-Line intersection
     if (e1.type == EntityType::Line && e2.type == EntityType::Line) {
@@ -564,7 +656,8 @@ std::vector<Point2D> computeEntityIntersectionPoints(const Entity& e1, const Ent
     else if (e1.type == EntityType::Arc && isEdgeBasedEntity(e2.type)) {
         if (!e1.points.empty()) {
             geometry::Arc arc = entityToArc(e1);
-            auto edges = entityEdges(e2);
+            EdgeList edges(result.get_allocator());
+            entityEdges(e2, edges);
             for (const auto& [p1, p2] : edges) {
                 auto isect = geometry::lineArcIntersection(p1, p2, arc);
                 if (isect.count >= 1 && isect.point1InSegment && isect.point1OnArc)
@@ -577,7 +670,8 @@ std::vector<Point2D> computeEntityIntersectionPoints(const Entity& e1, const Ent
     else if (isEdgeBasedEntity(e1.type) && e2.type == EntityType::Arc) {
         if (!e2.points.empty()) {
             geometry::Arc arc = entityToArc(e2);
-            auto edges = entityEdges(e1);
+            EdgeList edges(result.get_allocator());
+            entityEdges(e1, edges);
             for (const auto& [p1, p2] : edges) {
                 auto isect = geometry::lineArcIntersection(p1, p2, arc);
                 if (isect.count >= 1 && isect.point1InSegment && isect.point1OnArc)
@@ -590,7 +684,8 @@ std::vector<Point2D> computeEntityIntersectionPoints(const Entity& e1, const Ent
     // Line x Polygon (Rect/Para already caught above)
     else if (e1.type == EntityType::Line && isEdgeBasedEntity(e2.type)) {
         if (e1.points.size() >= 2) {
-            auto edges = entityEdges(e2);
+            EdgeList edges(result.get_allocator());
+            entityEdges(e2, edges);
             for (const auto& [p1, p2] : edges) {
                 auto isect = geometry::lineLineIntersection(e1.points[0], e1.points[1], p1, p2);
                 if (isect.intersects && isect.withinSegment1 && isect.withinSegment2)
@@ -600,7 +695,8 @@ std::vector<Point2D> computeEntityIntersectionPoints(const Entity& e1, const Ent
     }
     else if (isEdgeBasedEntity(e1.type) && e2.type == EntityType::Line) {
         if (e2.points.size() >= 2) {
-            auto edges = entityEdges(e1);
+            EdgeList edges(result.get_allocator());
+            entityEdges(e1, edges);
             for (const auto& [p1, p2] : edges) {
                 auto isect = geometry::lineLineIntersection(p1, p2, e2.points[0], e2.points[1]);
                 if (isect.intersects && isect.withinSegment1 && isect.withinSegment2)
@@ -611,7 +707,8 @@ std::vector<Point2D> computeEntityIntersectionPoints(const Entity& e1, const Ent
     // Circle x Polygon (Rect/Para already caught above)
     else if (e1.type == EntityType::Circle && isEdgeBasedEntity(e2.type)) {
         if (!e1.points.empty()) {
-            auto edges = entityEdges(e2);
+            EdgeList edges(result.get_allocator());
+            entityEdges(e2, edges);
             for (const auto& [p1, p2] : edges) {
                 auto isect = geometry::lineCircleIntersection(p1, p2, e1.points[0], e1.radius);
                 if (isect.count >= 1 && isect.point1InSegment)
@@ -623,7 +720,8 @@ std::vector<Point2D> computeEntityIntersectionPoints(const Entity& e1, const Ent
     }
     else if (isEdgeBasedEntity(e1.type) && e2.type == EntityType::Circle) {
         if (!e2.points.empty()) {
-            auto edges = entityEdges(e1);
+            EdgeList edges(result.get_allocator());
+            entityEdges(e1, edges);
             for (const auto& [p1, p2] : edges) {
                 auto isect = geometry::lineCircleIntersection(p1, p2, e2.points[0], e2.radius);
                 if (isect.count >= 1 && isect.point1InSegment)
@@ -635,8 +733,10 @@ std::vector<Point2D> computeEntityIntersectionPoints(const Entity& e1, const Ent
     }
     // Edge-based x edge-based (Rect-Rect, Rect-Polygon, Polygon-Polygon, etc.)
     else if (isEdgeBasedEntity(e1.type) && isEdgeBasedEntity(e2.type)) {
-        auto edges1 = entityEdges(e1);
-        auto edges2 = entityEdges(e2);
+        EdgeList edges1(result.get_allocator());
+        EdgeList edges2(result.get_allocator());
+        entityEdges(e1, edges1);
+        entityEdges(e2, edges2);
         for (const auto& [a1, a2] : edges1) {
             for (const auto& [b1, b2] : edges2) {
                 auto isect = geometry::lineLineIntersection(a1, a2, b1, b2);
@@ -645,22 +745,22 @@ std::vector<Point2D> computeEntityIntersectionPoints(const Entity& e1, const Ent
             }
         }
     }
-
-    return result;
 }
 
 // =====================================================================
 //  collectAxisCrossingSnapPoints
 // =====================================================================
 
-std::vector<SnapPoint> collectAxisCrossingSnapPoints(
-    const std::vector<Entity>& entities,
-    int excludeEntityId)
+template <typename Range>
+static void collectAxisCrossingSnapPointsImpl(
+    const Range& entities,
+    int excludeEntityId,
+    ScratchVector<SnapPoint>& points)
 {
-    std::vector<SnapPoint> points;
     constexpr double kEps = 1e-9;
+    ScratchVector<Point2D> verts(points.get_allocator());
 
-    for (const Entity& entity : entities) {
+    for (const auto& entity : entities) {
         if (entity.id == excludeEntityId) continue;
 
         auto addAxisPoint = [&](const Point2D& pt) {
@@ -786,7 +886,7 @@ std::vector<SnapPoint> collectAxisCrossingSnapPoints(
 
         case EntityType::Polygon:
             if (!entity.points.empty()) {
-                std::vector<Point2D> verts = computePolygonVertices(entity);
+                computePolygonVertices(entity, verts);
                 int n = static_cast<int>(verts.size());
                 for (int i = 0; i < n; ++i) {
                     lineAxisCrossings(verts[i], verts[(i + 1) % n]);
@@ -826,36 +926,74 @@ std::vector<SnapPoint> collectAxisCrossingSnapPoints(
             }
             break;
 
+        case EntityType::Spline:
+            if (auto curve = entity.splineCurve()) {
+                geometry::BoundingBox box = curve->boundingBox();
+                double minT = curve->firstParameter();
+                double maxT = curve->lastParameter();
+                auto addCrossings = [&](const Point2D& a, const Point2D& b) {
+                    for (double t : curve->intersectSegment(a, b)) {
+                        if (t > minT + kEps && t < maxT - kEps)  // Exclude endpoints
+                            addAxisPoint(curve->point(t));
+                    }
+                };
+                if (box.minX < 0.0 && box.maxX > 0.0)
+                    addCrossings(Point2D(0.0, box.minY - 1.0), Point2D(0.0, box.maxY + 1.0));
+                if (box.minY < 0.0 && box.maxY > 0.0)
+                    addCrossings(Point2D(box.minX - 1.0, 0.0), Point2D(box.maxX + 1.0, 0.0));
+            }
+            break;
+
         default:
-            // Slots, splines -- can be extended later
+            // Slots -- can be extended later
             break;
         }
     }
-
-    return points;
 }
 
 // =====================================================================
 //  collectIntersectionSnapPoints
 // =====================================================================
 
-std::vector<SnapPoint> collectIntersectionSnapPoints(
-    const std::vector<Entity>& entities,
-    int excludeEntityId)
+/// Entities as a random-access array for the pairwise loop below.  A
+/// vector is used as is; a store's views are built once here instead
+/// of once per pair.
+static const std::vector<Entity>& pairwiseArray(
+    const std::vector<Entity>& entities, ScratchVector<EntityView>&)
+{
+    return entities;
+}
+
+static const ScratchVector<EntityView>& pairwiseArray(
+    const EntityStore& entities, ScratchVector<EntityView>& views)
 {
-    std::vector<SnapPoint> points;
+    views.reserve(entities.size());
+    for (const EntityView& view : entities) views.push_back(view);
+    return views;
+}
+
+template <typename Range>
+static void collectIntersectionSnapPointsImpl(
+    const Range& entities,
+    int excludeEntityId,
+    ScratchVector<SnapPoint>& points)
+{
+    ScratchVector<Point2D> intersections(points.get_allocator());
+    ScratchVector<EntityView> views(points.get_allocator());
+    const auto& array = pairwiseArray(entities, views);
 
     // Compute intersections between all pairs of entities
-    for (int i = 0; i < static_cast<int>(entities.size()); ++i) {
-        const Entity& e1 = entities[i];
+    for (int i = 0; i < static_cast<int>(array.size()); ++i) {
+        const auto& e1 = array[i];
         if (e1.id == excludeEntityId) continue;
 
-        for (int j = i + 1; j < static_cast<int>(entities.size()); ++j) {
-            const Entity& e2 = entities[j];
+        for (int j = i + 1; j < static_cast<int>(array.size()); ++j) {
+            const auto& e2 = array[j];
             if (e2.id == excludeEntityId) continue;
 
             // Get intersection points between e1 and e2
-            std::vector<Point2D> intersections = computeEntityIntersectionPoints(e1, e2);
+            intersections.clear();
+            computeEntityIntersectionPointsImpl(e1, e2, intersections);
             for (const Point2D& pt : intersections) {
                 // Use first entity's id for the snap point
                 points.push_back({pt, SnapType::Intersection, e1.id});
@@ -864,41 +1002,35 @@ std::vector<SnapPoint> collectIntersectionSnapPoints(
     }
 
     // Compute intersections of entities with the X and Y axes
-    auto axisCrossings = collectAxisCrossingSnapPoints(entities, excludeEntityId);
-    points.insert(points.end(), axisCrossings.begin(), axisCrossings.end());
-
-    return points;
+    collectAxisCrossingSnapPointsImpl(entities, excludeEntityId, points);
 }
 
 // =====================================================================
 //  collectAllSnapPoints
 // =====================================================================
 
-std::vector<SnapPoint> collectAllSnapPoints(
-    const std::vector<Entity>& entities,
-    int excludeEntityId)
+template <typename Range>
+static void collectAllSnapPointsImpl(
+    const Range& entities,
+    int excludeEntityId,
+    ScratchVector<SnapPoint>& points)
 {
-    std::vector<SnapPoint> points;
-
-    for (const Entity& entity : entities) {
+    for (const auto& entity : entities) {
         if (entity.id == excludeEntityId) continue;
-        auto entitySnaps = collectSnapPoints(entity);
-        points.insert(points.end(), entitySnaps.begin(), entitySnaps.end());
+        collectSnapPointsImpl(entity, points);
     }
 
     // Collect intersection points between all entity pairs
-    auto intersectionSnaps = collectIntersectionSnapPoints(entities, excludeEntityId);
-    points.insert(points.end(), intersectionSnaps.begin(), intersectionSnaps.end());
-
-    return points;
+    collectIntersectionSnapPointsImpl(entities, excludeEntityId, points);
 }
 
 // =====================================================================
 //  findNearestOnPerimeter
 // =====================================================================
 
-SnapPoint findNearestOnPerimeter(
-    const std::vector<Entity>& entities,
+template <typename Range>
+static SnapPoint findNearestOnPerimeterImpl(
+    const Range& entities,
     const Point2D& point,
     double tolerance,
     int excludeEntityId)
@@ -908,7 +1040,10 @@ SnapPoint findNearestOnPerimeter(
     result.entityId = -1;
     double bestDist = tolerance;
 
-    for (const Entity& entity : entities) {
+    ScratchArena arena;
+    ScratchVector<Point2D> verts(arena.resource());
+
+    for (const auto& entity : entities) {
         if (entity.id == excludeEntityId) continue;
 
         Point2D nearest;
@@ -960,7 +1095,7 @@ SnapPoint findNearestOnPerimeter(
 
         case EntityType::Polygon:
             if (!entity.points.empty()) {
-                std::vector<Point2D> verts = computePolygonVertices(entity);
+                computePolygonVertices(entity, verts);
                 int n = static_cast<int>(verts.size());
                 for (int i = 0; i < n; ++i) {
                     Point2D edgeNearest = geometry::closestPointOnLine(
@@ -980,8 +1115,15 @@ SnapPoint findNearestOnPerimeter(
             dist = std::hypot(point.x - nearest.x, point.y - nearest.y);
             break;
 
+        case EntityType::Spline:
+            if (auto curve = entity.splineCurve()) {
+                nearest = curve->closestPoint(point);
+                dist = std::hypot(point.x - nearest.x, point.y - nearest.y);
+            }
+            break;
+
         default:
-            // Ellipses, splines -- can be extended later
+            // Ellipses -- can be extended later
             break;
         }
 
@@ -1000,8 +1142,9 @@ SnapPoint findNearestOnPerimeter(
 //  findBestSnap
 // =====================================================================
 
-SnapResult findBestSnap(
-    const std::vector<Entity>& entities,
+template <typename Range>
+static SnapResult findBestSnapImpl(
+    const Range& entities,
     const Point2D& worldPos,
     double worldTolerance,
     int excludeEntityId)
@@ -1026,14 +1169,16 @@ SnapResult findBestSnap(
     consider(SnapPoint{Point2D(0, 0), SnapType::Origin, -1}, originDist);
 
     // Check explicit entity snap points (includes axis-crossing intersections)
-    std::vector<SnapPoint> snapPoints = collectAllSnapPoints(entities, excludeEntityId);
+    ScratchArena arena;
+    ScratchVector<SnapPoint> snapPoints(arena.resource());
+    collectAllSnapPointsImpl(entities, excludeEntityId, snapPoints);
     for (const SnapPoint& sp : snapPoints) {
         double dist = std::hypot(worldPos.x - sp.position.x, worldPos.y - sp.position.y);
         consider(sp, dist);
     }
 
     // Check nearest point on entity perimeter
-    SnapPoint nearestSnap = findNearestOnPerimeter(entities, worldPos, worldTolerance, excludeEntityId);
+    SnapPoint nearestSnap = findNearestOnPerimeterImpl(entities, worldPos, worldTolerance, excludeEntityId);
     if (nearestSnap.type == SnapType::Nearest) {
         double dist = std::hypot(worldPos.x - nearestSnap.position.x, worldPos.y - nearestSnap.position.y);
         consider(nearestSnap, dist);
@@ -1054,5 +1199,141 @@ SnapResult findBestSnap(
     return snapResult;
 }
 
+// =====================================================================
+//  Public entry points — Entity
+// =====================================================================
+
+std::vector<SnapPoint> collectSnapPoints(const Entity& entity)
+{
+    ScratchArena arena;
+    ScratchVector<SnapPoint> points(arena.resource());
+    collectSnapPointsImpl(entity, points);
+    return std::vector<SnapPoint>(points.begin(), points.end());
+}
+
+std::vector<SnapPoint> collectAllSnapPoints(
+    const std::vector<Entity>& entities,
+    int excludeEntityId)
+{
+    ScratchArena arena;
+    ScratchVector<SnapPoint> points(arena.resource());
+    collectAllSnapPointsImpl(entities, excludeEntityId, points);
+    return std::vector<SnapPoint>(points.begin(), points.end());
+}
+
+std::vector<SnapPoint> collectIntersectionSnapPoints(
+    const std::vector<Entity>& entities,
+    int excludeEntityId)
+{
+    ScratchArena arena;
+    ScratchVector<SnapPoint> points(arena.resource());
+    collectIntersectionSnapPointsImpl(entities, excludeEntityId, points);
+    return std::vector<SnapPoint>(points.begin(), points.end());
+}
+
+std::vector<SnapPoint> collectAxisCrossingSnapPoints(
+    const std::vector<Entity>& entities,
+    int excludeEntityId)
+{
+    ScratchArena arena;
+    ScratchVector<SnapPoint> points(arena.resource());
+    collectAxisCrossingSnapPointsImpl(entities, excludeEntityId, points);
+    return std::vector<SnapPoint>(points.begin(), points.end());
+}
+
+SnapPoint findNearestOnPerimeter(
+    const std::vector<Entity>& entities,
+    const Point2D& point,
+    double tolerance,
+    int excludeEntityId)
+{
+    return findNearestOnPerimeterImpl(entities, point, tolerance, excludeEntityId);
+}
+
+SnapResult findBestSnap(
+    const std::vector<Entity>& entities,
+    const Point2D& worldPos,
+    double worldTolerance,
+    int excludeEntityId)
+{
+    return findBestSnapImpl(entities, worldPos, worldTolerance, excludeEntityId);
+}
+
+std::vector<Point2D> computeEntityIntersectionPoints(const Entity& e1, const Entity& e2)
+{
+    ScratchArena arena;
+    ScratchVector<Point2D> result(arena.resource());
+    computeEntityIntersectionPointsImpl(e1, e2, result);
+    return std::vector<Point2D>(result.begin(), result.end());
+}
+
+// =====================================================================
+//  Public entry points — EntityStore
+// =====================================================================
+
+std::vector<SnapPoint> collectSnapPoints(const EntityView& entity)
+{
+    ScratchArena arena;
+    ScratchVector<SnapPoint> points(arena.resource());
+    collectSnapPointsImpl(entity, points);
+    return std::vector<SnapPoint>(points.begin(), points.end());
+}
+
+std::vector<SnapPoint> collectAllSnapPoints(
+    const EntityStore& entities,
+    int excludeEntityId)
+{
+    ScratchArena arena;
+    ScratchVector<SnapPoint> points(arena.resource());
+    collectAllSnapPointsImpl(entities, excludeEntityId, points);
+    return std::vector<SnapPoint>(points.begin(), points.end());
+}
+
+std::vector<SnapPoint> collectIntersectionSnapPoints(
+    const EntityStore& entities,
+    int excludeEntityId)
+{
+    ScratchArena arena;
+    ScratchVector<SnapPoint> points(arena.resource());
+    collectIntersectionSnapPointsImpl(entities, excludeEntityId, points);
+    return std::vector<SnapPoint>(points.begin(), points.end());
+}
+
+std::vector<SnapPoint> collectAxisCrossingSnapPoints(
+    const EntityStore& entities,
+    int excludeEntityId)
+{
+    ScratchArena arena;
+    ScratchVector<SnapPoint> points(arena.resource());
+    collectAxisCrossingSnapPointsImpl(entities, excludeEntityId, points);
+    return std::vector<SnapPoint>(points.begin(), points.end());
+}
+
+SnapPoint findNearestOnPerimeter(
+    const EntityStore& entities,
+    const Point2D& point,
+    double tolerance,
+    int excludeEntityId)
+{
+    return findNearestOnPerimeterImpl(entities, point, tolerance, excludeEntityId);
+}
+
+SnapResult findBestSnap(
+    const EntityStore& entities,
+    const Point2D& worldPos,
+    double worldTolerance,
+    int excludeEntityId)
+{
+    return findBestSnapImpl(entities, worldPos, worldTolerance, excludeEntityId);
+}
+
+std::vector<Point2D> computeEntityIntersectionPoints(const EntityView& e1, const EntityView& e2)
+{
+    ScratchArena arena;
+    ScratchVector<Point2D> result(arena.resource());
+    computeEntityIntersectionPointsImpl(e1, e2, result);
+    return std::vector<Point2D>(result.begin(), result.end());
+}
+
 }  // namespace sketch
 }  // namespace hobbycad
@@ -8,6 +8,7 @@
 // =====================================================================
 
 #include <hobbycad/sketch/solver.h>
+#include <hobbycad/sketch/native_solver.h>
 
 #ifdef HAVE_SLVS
 #include <slvs.h>
@@ -28,6 +29,17 @@ namespace sketch {
 
 class Solver::Impl {
 public:
+    SolverBackend backend = SolverBackend::Automatic;
+    NativeSolver native;
+
+    SolveResult solveNative(std::vector<Entity>& entities,
+                            const std::vector<Constraint>& constraints);
+    OverConstraintInfo checkNative(const std::vector<Entity>& entities,
+                                   const std::vector<Constraint>& existingConstraints,
+                                   const Constraint& newConstraint);
+    int degreesOfFreedomNative(const std::vector<Entity>& entities,
+                               const std::vector<Constraint>& constraints);
+
 #ifdef HAVE_SLVS
     // Map HobbyCAD entity IDs to solver handles
     std::map<int, Slvs_hEntity> entityHandles;
@@ -141,9 +153,10 @@ public:
 //  Solver Implementation
 // =====================================================================
 
-Solver::Solver()
+Solver::Solver(SolverBackend backend)
     : m_impl(new Impl())
 {
+    m_impl->backend = backend;
 }
 
 Solver::~Solver()
@@ -151,13 +164,42 @@ Solver::~Solver()
     delete m_impl;
 }
 
+void Solver::setBackend(SolverBackend backend)
+{
+    m_impl->backend = backend;
+}
+
+SolverBackend Solver::backend() const
+{
+    return m_impl->backend;
+}
+
+SolverBackend Solver::activeBackend() const
+{
+    if (m_impl->backend != SolverBackend::Native &&
+        isBackendAvailable(SolverBackend::SolveSpace)) {
+        return SolverBackend::SolveSpace;
+    }
+    return SolverBackend::Native;
+}
+
 bool Solver::isAvailable()
 {
-#ifdef HAVE_SLVS
     return true;
+}
+
+bool Solver::isBackendAvailable(SolverBackend backend)
+{
+    switch (backend) {
+    case SolverBackend::SolveSpace:
+#ifdef HAVE_SLVS
+        return true;
 #else
-    return false;
+        return false;
 #endif
+    default:
+        return true;
+    }
 }
 
 SolveResult Solver::solve(
@@ -165,11 +207,12 @@ SolveResult Solver::solve(
     const std::vector<Constraint>& constraints)
 {
 #ifndef HAVE_SLVS
-    SolveResult result;
-    result.success = false;
-    result.errorMessage = "Solver not available (libslvs not compiled)";
-    return result;
+    return m_impl->solveNative(entities, constraints);
 #else
+    if (activeBackend() == SolverBackend::Native) {
+        return m_impl->solveNative(entities, constraints);
+    }
+
     m_impl->reset();
 
     // Prepare solver data structures
@@ -238,12 +281,15 @@ OverConstraintInfo Solver::checkOverConstrain(
     const std::vector<Constraint>& existingConstraints,
     const Constraint& newConstraint)
 {
-    OverConstraintInfo info;
-
 #ifndef HAVE_SLVS
-    info.wouldOverConstrain = false;
-    return info;
+    return m_impl->checkNative(entities, existingConstraints, newConstraint);
 #else
+    if (activeBackend() == SolverBackend::Native) {
+        return m_impl->checkNative(entities, existingConstraints, newConstraint);
+    }
+
+    OverConstraintInfo info;
+
     // Create a temporary list with the new constraint added
     std::vector<Constraint> testConstraints = existingConstraints;
     testConstraints.push_back(newConstraint);
@@ -307,8 +353,12 @@ int Solver::degreesOfFreedom(
     const std::vector<Constraint>& constraints)
 {
 #ifndef HAVE_SLVS
-    return -1;  // Unknown
+    return m_impl->degreesOfFreedomNative(entities, constraints);
 #else
+    if (activeBackend() == SolverBackend::Native) {
+        return m_impl->degreesOfFreedomNative(entities, constraints);
+    }
+
     // Make a copy of entities (solve may modify them)
     std::vector<Entity> testEntities = entities;
 
@@ -338,6 +388,57 @@ int Solver::degreesOfFreedom(
 #endif
 }
 
+// =====================================================================
+//  Native Backend
+// =====================================================================
+
+SolveResult Solver::Impl::solveNative(
+    std::vector<Entity>& entities,
+    const std::vector<Constraint>& constraints)
+{
+    native.build(entities, constraints);
+    SolveResult result = native.solve();
+    if (result.success) {
+        native.applyTo(entities);
+    }
+    return result;
+}
+
+OverConstraintInfo Solver::Impl::checkNative(
+    const std::vector<Entity>& entities,
+    const std::vector<Constraint>& existingConstraints,
+    const Constraint& newConstraint)
+{
+    OverConstraintInfo info;
+
+    std::vector<Constraint> testConstraints = existingConstraints;
+    testConstraints.push_back(newConstraint);
+
+    native.build(entities, testConstraints);
+    SolveResult result = native.solve();
+
+    info.wouldOverConstrain = (result.resultCode == SolveResult::Inconsistent ||
+                               result.resultCode == SolveResult::DidntConverge ||
+                               result.resultCode == SolveResult::TooManyUnknowns);
+    if (info.wouldOverConstrain) {
+        for (int id : result.failedConstraintIds) {
+            if (id != newConstraint.id) {
+                info.conflictingConstraintIds.push_back(id);
+            }
+        }
+        info.reason = solveResultName(result.resultCode);
+    }
+    return info;
+}
+
+int Solver::Impl::degreesOfFreedomNative(
+    const std::vector<Entity>& entities,
+    const std::vector<Constraint>& constraints)
+{
+    native.build(entities, constraints);
+    return native.solve().dof;
+}
+
 // =====================================================================
 //  libslvs System Building (only when HAVE_SLVS is defined)
 // =====================================================================
@@ -960,6 +1061,34 @@ std::string solveResultName(SolveResult::ResultCode code)
     }
 }
 
+std::string solverBackendName(SolverBackend backend)
+{
+    switch (backend) {
+    case SolverBackend::Native:
+        return "native";
+    case SolverBackend::SolveSpace:
+        return "solvespace";
+    default:
+        return "auto";
+    }
+}
+
+bool solverBackendFromName(const std::string& name, SolverBackend* backend)
+{
+    SolverBackend parsed;
+    if (name == "auto") {
+        parsed = SolverBackend::Automatic;
+    } else if (name == "native") {
+        parsed = SolverBackend::Native;
+    } else if (name == "solvespace" || name == "slvs") {
+        parsed = SolverBackend::SolveSpace;
+    } else {
+        return false;
+    }
+    if (backend) *backend = parsed;
+    return true;
+}
+
 bool constraintSupported(ConstraintType type)
 {
     switch (type) {
@@ -0,0 +1,843 @@
+// =====================================================================
+//  src/libhobbycad/sketch/text.cpp — Text outlines
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/sketch/text.h>
+#include <hobbycad/geometry/utils.h>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef HOBBYCAD_HAS_FREETYPE
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_OUTLINE_H
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace hobbycad {
+namespace sketch {
+
+namespace {
+
+/// Segments needed to keep a Bézier within tolerance of its chords.
+/// The chord error of n uniform steps is bounded by |B''| / (8 n²).
+int bezierSteps(const OutlineSegment& seg, double tolerance)
+{
+    double dd = 0.0;
+    if (seg.type == OutlineSegmentType::Quadratic) {
+        Point2D d = seg.start - seg.control1 * 2.0 + seg.end;
+        dd = 2.0 * std::hypot(d.x, d.y);
+    } else if (seg.type == OutlineSegmentType::Cubic) {
+        Point2D d1 = seg.start - seg.control1 * 2.0 + seg.control2;
+        Point2D d2 = seg.control1 - seg.control2 * 2.0 + seg.end;
+        dd = 6.0 * std::max(std::hypot(d1.x, d1.y), std::hypot(d2.x, d2.y));
+    }
+    if (dd <= 0.0) return 1;
+
+    int steps = static_cast<int>(std::ceil(std::sqrt(dd / (8.0 * tolerance))));
+    return std::clamp(steps, 1, 64);
+}
+
+Point2D bezierPoint(const OutlineSegment& seg, double t)
+{
+    double u = 1.0 - t;
+    if (seg.type == OutlineSegmentType::Quadratic) {
+        return seg.start * (u * u) + seg.control1 * (2.0 * u * t) + seg.end * (t * t);
+    }
+    return seg.start * (u * u * u) + seg.control1 * (3.0 * u * u * t) +
+           seg.control2 * (3.0 * u * t * t) + seg.end * (t * t * t);
+}
+
+}  // anonymous namespace
+
+// =====================================================================
+//  Font and Glyph Cache
+// =====================================================================
+
+#ifdef HOBBYCAD_HAS_FREETYPE
+
+namespace {
+
+/// Slant of synthesized italics (about 12 degrees)
+constexpr double kSyntheticSlant = 0.2126;
+
+/// Stroke added around synthesized bold glyphs, as a fraction of the em
+constexpr double kSyntheticBold = 1.0 / 24.0;
+
+/// Families tried, in order, when none is requested or the requested
+/// one is not installed
+const char* const kDefaultFamilies[] = {
+    "DejaVu Sans", "Liberation Sans", "Noto Sans", "Arial", "Helvetica",
+    "FreeSans", "Lato", "Open Sans"
+};
+
+double cross(const Point2D& a, const Point2D& b)
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+/// Exact signed area of a closed contour by Green's theorem; each
+/// segment contributes the integral of (x dy - y dx) / 2 along it
+double contourArea(const OutlineContour& contour)
+{
+    double area = 0.0;
+    for (const OutlineSegment& s : contour.segments) {
+        switch (s.type) {
+        case OutlineSegmentType::Line:
+            area += cross(s.start, s.end) / 2.0;
+            break;
+        case OutlineSegmentType::Quadratic:
+            area += (2.0 * cross(s.start, s.control1) + 2.0 * cross(s.control1, s.end) +
+                     cross(s.start, s.end)) / 6.0;
+            break;
+        case OutlineSegmentType::Cubic:
+            area += (6.0 * cross(s.start, s.control1) + 3.0 * cross(s.start, s.control2) +
+                     cross(s.start, s.end) + 3.0 * cross(s.control1, s.control2) +
+                     3.0 * cross(s.control1, s.end) + 6.0 * cross(s.control2, s.end)) / 20.0;
+            break;
+        }
+    }
+    return area;
+}
+
+/// Reverse a contour's direction
+void reverseContour(OutlineContour& contour)
+{
+    std::reverse(contour.segments.begin(), contour.segments.end());
+    for (OutlineSegment& seg : contour.segments) {
+        std::swap(seg.start, seg.end);
+        if (seg.type == OutlineSegmentType::Cubic) {
+            std::swap(seg.control1, seg.control2);
+        }
+    }
+    contour.area = -contour.area;
+}
+
+/// A glyph in font units, y up, holes already classified and every
+/// contour oriented outer-CCW / hole-CW
+struct Glyph {
+    std::vector<OutlineContour> contours;
+    double advance = 0.0;
+};
+
+struct Face {
+    FontInfo info;
+    FT_Face face = nullptr;         ///< Opened on first use
+    double unitsPerEm = 1000.0;
+    double lineHeight = 1200.0;
+};
+
+std::string lower(std::string s)
+{
+    for (char& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return s;
+}
+
+bool isFontFile(const std::filesystem::path& path)
+{
+    std::string ext = lower(path.extension().string());
+    return ext == ".ttf" || ext == ".otf" || ext == ".ttc" || ext == ".otc";
+}
+
+/// Builds contours from FT_Outline_Decompose callbacks
+struct Decomposer {
+    std::vector<OutlineContour> contours;
+    Point2D pen;
+
+    static Point2D point(const FT_Vector* v)
+    {
+        return Point2D(static_cast<double>(v->x), static_cast<double>(v->y));
+    }
+
+    void add(const OutlineSegment& seg)
+    {
+        if (contours.empty()) contours.emplace_back();
+        contours.back().segments.push_back(seg);
+        pen = seg.end;
+    }
+
+    static int moveTo(const FT_Vector* to, void* user)
+    {
+        auto* self = static_cast<Decomposer*>(user);
+        self->contours.emplace_back();
+        self->pen = point(to);
+        return 0;
+    }
+
+    static int lineTo(const FT_Vector* to, void* user)
+    {
+        auto* self = static_cast<Decomposer*>(user);
+        OutlineSegment seg;
+        seg.start = self->pen;
+        seg.end = point(to);
+        // FreeType closes every contour with a segment back to its
+        // start, which is empty when the font repeats the first point
+        if (seg.start != seg.end) self->add(seg);
+        return 0;
+    }
+
+    static int conicTo(const FT_Vector* control, const FT_Vector* to, void* user)
+    {
+        auto* self = static_cast<Decomposer*>(user);
+        OutlineSegment seg;
+        seg.type = OutlineSegmentType::Quadratic;
+        seg.start = self->pen;
+        seg.control1 = point(control);
+        seg.end = point(to);
+        self->add(seg);
+        return 0;
+    }
+
+    static int cubicTo(const FT_Vector* control1, const FT_Vector* control2,
+                       const FT_Vector* to, void* user)
+    {
+        auto* self = static_cast<Decomposer*>(user);
+        OutlineSegment seg;
+        seg.type = OutlineSegmentType::Cubic;
+        seg.start = self->pen;
+        seg.control1 = point(control1);
+        seg.control2 = point(control2);
+        seg.end = point(to);
+        self->add(seg);
+        return 0;
+    }
+};
+
+class FontCache {
+public:
+    FontCache()
+    {
+        if (FT_Init_FreeType(&m_library) != 0) {
+            m_library = nullptr;
+        }
+    }
+
+    ~FontCache()
+    {
+        closeFaces();
+        if (m_library) FT_Done_FreeType(m_library);
+    }
+
+    std::mutex& mutex() { return m_mutex; }
+
+    // ---- Font index (callers hold the mutex) ----
+
+    int addFile(const std::string& path, std::string* errorMsg)
+    {
+        if (!m_library) {
+            if (errorMsg) *errorMsg = "FreeType failed to initialize";
+            return 0;
+        }
+        if (!m_files.insert(path).second) return 0;
+
+        FT_Face face = nullptr;
+        if (FT_New_Face(m_library, path.c_str(), 0, &face) != 0) {
+            if (errorMsg) *errorMsg = "Not a font file: " + path;
+            return 0;
+        }
+        FT_Long count = face->num_faces;
+
+        int added = 0;
+        for (FT_Long i = 0; i < count; ++i) {
+            if (i > 0) {
+                if (face) FT_Done_Face(face);
+                face = nullptr;
+                if (FT_New_Face(m_library, path.c_str(), i, &face) != 0) continue;
+            }
+            if (!FT_IS_SCALABLE(face) || !face->family_name) continue;
+
+            Face entry;
+            entry.info.family = face->family_name;
+            entry.info.style = face->style_name ? face->style_name : "";
+            entry.info.path = path;
+            entry.info.faceIndex = static_cast<int>(i);
+            entry.info.bold = (face->style_flags & FT_STYLE_FLAG_BOLD) != 0;
+            entry.info.italic = (face->style_flags & FT_STYLE_FLAG_ITALIC) != 0;
+            m_families[lower(entry.info.family)].push_back(static_cast<int>(m_faces.size()));
+            m_faces.push_back(entry);
+            ++added;
+        }
+        if (face) FT_Done_Face(face);
+
+        if (added == 0 && errorMsg) *errorMsg = "No scalable font faces in " + path;
+        return added;
+    }
+
+    int addDirectory(const std::string& path)
+    {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        if (!fs::is_directory(path, ec)) return 0;
+
+        // Sort so the index, and with it the fallback font, does not
+        // depend on directory iteration order
+        std::vector<std::string> files;
+        fs::recursive_directory_iterator it(path, fs::directory_options::skip_permission_denied, ec);
+        for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            if (it->is_regular_file(ec) && isFontFile(it->path())) {
+                files.push_back(it->path().string());
+            }
+        }
+        std::sort(files.begin(), files.end());
+
+        int added = 0;
+        for (const std::string& file : files) {
+            added += addFile(file, nullptr);
+        }
+        return added;
+    }
+
+    /// Scan HOBBYCAD_FONT_PATH and the system font directories once
+    void ensureScanned()
+    {
+        if (m_scanned) return;
+        m_scanned = true;
+
+        std::vector<std::string> dirs;
+        if (const char* env = std::getenv("HOBBYCAD_FONT_PATH")) {
+#ifdef _WIN32
+            const char separator = ';';
+#else
+            const char separator = ':';
+#endif
+            std::string list = env;
+            size_t begin = 0;
+            while (begin <= list.size()) {
+                size_t end = list.find(separator, begin);
+                if (end == std::string::npos) end = list.size();
+                if (end > begin) dirs.push_back(list.substr(begin, end - begin));
+                begin = end + 1;
+            }
+        }
+
+#if defined(_WIN32)
+        if (const char* windir = std::getenv("WINDIR")) dirs.push_back(std::string(windir) + "\\Fonts");
+        if (const char* local = std::getenv("LOCALAPPDATA")) {
+            dirs.push_back(std::string(local) + "\\Microsoft\\Windows\\Fonts");
+        }
+#elif defined(__APPLE__)
+        dirs.push_back("/System/Library/Fonts");
+        dirs.push_back("/Library/Fonts");
+        if (const char* home = std::getenv("HOME")) dirs.push_back(std::string(home) + "/Library/Fonts");
+#else
+        if (const char* home = std::getenv("HOME")) {
+            dirs.push_back(std::string(home) + "/.local/share/fonts");
+            dirs.push_back(std::string(home) + "/.fonts");
+        }
+        dirs.push_back("/usr/local/share/fonts");
+        dirs.push_back("/usr/share/fonts");
+#endif
+
+        for (const std::string& dir : dirs) {
+            addDirectory(dir);
+        }
+    }
+
+    std::vector<FontInfo> fonts()
+    {
+        ensureScanned();
+        std::vector<FontInfo> result;
+        result.reserve(m_faces.size());
+        for (const Face& f : m_faces) {
+            result.push_back(f.info);
+        }
+        return result;
+    }
+
+    /// Index of the best face for a style, or -1
+    int find(const TextStyle& style, bool* substituted)
+    {
+        ensureScanned();
+        if (substituted) *substituted = false;
+        if (m_faces.empty()) return -1;
+
+        auto best = [&](const std::string& family) -> int {
+            auto it = m_families.find(lower(family));
+            if (it == m_families.end()) return -1;
+
+            int bestIndex = -1;
+            int bestScore = -1000;
+            for (int index : it->second) {
+                const FontInfo& info = m_faces[index].info;
+                int score = 0;
+                if (info.bold == style.bold) score += 4;
+                if (info.italic == style.italic) score += 4;
+                // Prefer the plain weight and width of the family
+                static const char* const kVariants[] = {
+                    "thin", "light", "medium", "semi", "demi", "extra", "ultra",
+                    "black", "heavy", "condensed", "narrow", "expanded", "oblique"
+                };
+                std::string name = lower(info.style);
+                for (const char* v : kVariants) {
+                    if (name.find(v) != std::string::npos) --score;
+                }
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestIndex = index;
+                }
+            }
+            return bestIndex;
+        };
+
+        if (!style.fontFamily.empty()) {
+            int index = best(style.fontFamily);
+            if (index >= 0) return index;
+            if (substituted) *substituted = true;
+        }
+        for (const char* family : kDefaultFamilies) {
+            int index = best(family);
+            if (index >= 0) return index;
+        }
+        int index = best(m_faces.front().info.family);
+        return index >= 0 ? index : 0;
+    }
+
+    FontInfo info(int index) const { return m_faces[index].info; }
+
+    // ---- Glyphs (callers hold the mutex) ----
+
+    Face* open(int index)
+    {
+        Face& f = m_faces[index];
+        if (f.face) return &f;
+
+        if (FT_New_Face(m_library, f.info.path.c_str(), f.info.faceIndex, &f.face) != 0) {
+            f.face = nullptr;
+            return nullptr;
+        }
+        FT_Select_Charmap(f.face, FT_ENCODING_UNICODE);
+        if (f.face->units_per_EM > 0) f.unitsPerEm = f.face->units_per_EM;
+        f.lineHeight = f.face->height > 0 ? f.face->height : 1.2 * f.unitsPerEm;
+        ++m_openFaces;
+        return &f;
+    }
+
+    const Glyph* glyph(int faceIndex, Face& face, unsigned glyphIndex, bool embolden)
+    {
+        std::uint64_t key = (static_cast<std::uint64_t>(faceIndex) << 33) |
+                            (static_cast<std::uint64_t>(glyphIndex) << 1) |
+                            (embolden ? 1u : 0u);
+        auto it = m_glyphs.find(key);
+        if (it != m_glyphs.end()) {
+            ++m_hits;
+            return &it->second;
+        }
+        ++m_misses;
+
+        Glyph& g = m_glyphs[key];
+        if (FT_Load_Glyph(face.face, glyphIndex, FT_LOAD_NO_SCALE) != 0) {
+            return &g;
+        }
+
+        FT_GlyphSlot slot = face.face->glyph;
+        g.advance = static_cast<double>(slot->metrics.horiAdvance);
+        if (slot->format != FT_GLYPH_FORMAT_OUTLINE) {
+            return &g;
+        }
+
+        if (embolden) {
+            FT_Pos strength = static_cast<FT_Pos>(face.unitsPerEm * kSyntheticBold);
+            FT_Outline_Embolden(&slot->outline, strength);
+            g.advance += static_cast<double>(strength);
+        }
+
+        FT_Outline_Funcs funcs = {};
+        funcs.move_to = &Decomposer::moveTo;
+        funcs.line_to = &Decomposer::lineTo;
+        funcs.conic_to = &Decomposer::conicTo;
+        funcs.cubic_to = &Decomposer::cubicTo;
+
+        Decomposer decomposer;
+        if (FT_Outline_Decompose(&slot->outline, &funcs, &decomposer) != 0) {
+            return &g;
+        }
+
+        for (OutlineContour& c : decomposer.contours) {
+            if (!c.segments.empty()) g.contours.push_back(std::move(c));
+        }
+
+        // Nesting depth decides holes: a contour inside an odd number of
+        // others is a counter.  Glyphs have few contours, so test pairs.
+        double tolerance = face.unitsPerEm / 1000.0;
+        std::vector<std::vector<Point2D>> polygons;
+        polygons.reserve(g.contours.size());
+        for (OutlineContour& c : g.contours) {
+            polygons.push_back(contourToPolygon(c, tolerance));
+            c.area = contourArea(c);
+        }
+        for (size_t i = 0; i < g.contours.size(); ++i) {
+            if (polygons[i].empty()) continue;
+            int depth = 0;
+            for (size_t j = 0; j < g.contours.size(); ++j) {
+                if (i == j || std::abs(g.contours[j].area) <= std::abs(g.contours[i].area)) continue;
+                if (geometry::pointInPolygon(polygons[i].front(), polygons[j])) ++depth;
+            }
+            OutlineContour& c = g.contours[i];
+            c.isHole = (depth % 2) == 1;
+            if ((c.isHole && c.area > 0.0) || (!c.isHole && c.area < 0.0)) {
+                reverseContour(c);
+            }
+        }
+
+        return &g;
+    }
+
+    GlyphCacheStats stats() const
+    {
+        GlyphCacheStats s;
+        s.fonts = m_faces.size();
+        s.openFaces = m_openFaces;
+        s.glyphs = m_glyphs.size();
+        s.hits = m_hits;
+        s.misses = m_misses;
+        return s;
+    }
+
+    void clear()
+    {
+        m_glyphs.clear();
+        closeFaces();
+    }
+
+private:
+    void closeFaces()
+    {
+        for (Face& f : m_faces) {
+            if (f.face) {
+                FT_Done_Face(f.face);
+                f.face = nullptr;
+            }
+        }
+        m_openFaces = 0;
+    }
+
+    std::mutex m_mutex;
+    FT_Library m_library = nullptr;
+    bool m_scanned = false;
+    std::vector<Face> m_faces;
+    std::unordered_map<std::string, std::vector<int>> m_families;  ///< Lower-case family → faces
+    std::unordered_set<std::string> m_files;
+    std::unordered_map<std::uint64_t, Glyph> m_glyphs;  ///< By face, glyph and emboldening
+    std::size_t m_openFaces = 0;
+    std::size_t m_hits = 0;
+    std::size_t m_misses = 0;
+};
+
+FontCache& fontCache()
+{
+    static FontCache cache;
+    return cache;
+}
+
+/// Decode one UTF-8 code point, advancing i (U+FFFD for bad input)
+char32_t nextCodePoint(const std::string& s, size_t& i)
+{
+    unsigned char c = static_cast<unsigned char>(s[i++]);
+    if (c < 0x80) return c;
+
+    int extra = 0;
+    char32_t cp = 0;
+    if ((c & 0xE0) == 0xC0) { extra = 1; cp = c & 0x1F; }
+    else if ((c & 0xF0) == 0xE0) { extra = 2; cp = c & 0x0F; }
+    else if ((c & 0xF8) == 0xF0) { extra = 3; cp = c & 0x07; }
+    else return 0xFFFD;
+
+    for (int k = 0; k < extra; ++k) {
+        if (i >= s.size() || (static_cast<unsigned char>(s[i]) & 0xC0) != 0x80) return 0xFFFD;
+        cp = (cp << 6) | (static_cast<unsigned char>(s[i++]) & 0x3F);
+    }
+    return cp;
+}
+
+}  // anonymous namespace
+
+bool textOutlinesAvailable()
+{
+    return true;
+}
+
+bool addFontFile(const std::string& path, std::string* errorMsg)
+{
+    FontCache& cache = fontCache();
+    std::lock_guard<std::mutex> lock(cache.mutex());
+    return cache.addFile(path, errorMsg) > 0;
+}
+
+int addFontDirectory(const std::string& path)
+{
+    FontCache& cache = fontCache();
+    std::lock_guard<std::mutex> lock(cache.mutex());
+    return cache.addDirectory(path);
+}
+
+std::vector<FontInfo> availableFonts()
+{
+    FontCache& cache = fontCache();
+    std::lock_guard<std::mutex> lock(cache.mutex());
+    return cache.fonts();
+}
+
+bool findFont(const TextStyle& style, FontInfo* font, bool* substituted)
+{
+    FontCache& cache = fontCache();
+    std::lock_guard<std::mutex> lock(cache.mutex());
+    int index = cache.find(style, substituted);
+    if (index < 0) return false;
+    if (font) *font = cache.info(index);
+    return true;
+}
+
+GlyphCacheStats glyphCacheStats()
+{
+    FontCache& cache = fontCache();
+    std::lock_guard<std::mutex> lock(cache.mutex());
+    return cache.stats();
+}
+
+void clearGlyphCache()
+{
+    FontCache& cache = fontCache();
+    std::lock_guard<std::mutex> lock(cache.mutex());
+    cache.clear();
+}
+
+TextOutline layoutText(
+    const std::string& text,
+    const Point2D& position,
+    const TextStyle& style,
+    double size,
+    double rotationDegrees)
+{
+    TextOutline result;
+
+    if (size <= 0.0) {
+        result.errorMessage = "Text size must be positive";
+        return result;
+    }
+
+    FontCache& cache = fontCache();
+    std::lock_guard<std::mutex> lock(cache.mutex());
+
+    int faceIndex = cache.find(style, &result.fontSubstituted);
+    if (faceIndex < 0) {
+        result.errorMessage = "No fonts found (set HOBBYCAD_FONT_PATH to a font directory)";
+        return result;
+    }
+    Face* face = cache.open(faceIndex);
+    if (!face) {
+        result.errorMessage = "Failed to open font " + cache.info(faceIndex).path;
+        return result;
+    }
+    result.font = face->info;
+
+    bool embolden = style.bold && !face->info.bold;
+    double slant = (style.italic && !face->info.italic) ? kSyntheticSlant : 0.0;
+    bool kerning = FT_HAS_KERNING(face->face);
+
+    double scale = size / face->unitsPerEm;
+    double angle = rotationDegrees * M_PI / 180.0;
+    double cosA = std::cos(angle);
+    double sinA = std::sin(angle);
+
+    // Font units at pen offset → sketch coordinates
+    auto place = [&](const Point2D& p, const Point2D& pen) {
+        double x = (p.x + pen.x + slant * p.y) * scale;
+        double y = (p.y + pen.y) * scale;
+        return Point2D(position.x + x * cosA - y * sinA,
+                       position.y + x * sinA + y * cosA);
+    };
+
+    Point2D pen(0.0, 0.0);
+    unsigned previous = 0;
+    size_t i = 0;
+    while (i < text.size()) {
+        char32_t cp = nextCodePoint(text, i);
+        if (cp == U'\n') {
+            pen = Point2D(0.0, pen.y - face->lineHeight);
+            previous = 0;
+            continue;
+        }
+        if (cp == U'\r') continue;
+
+        unsigned glyphIndex = FT_Get_Char_Index(face->face, cp);
+        if (kerning && previous && glyphIndex) {
+            FT_Vector delta;
+            if (FT_Get_Kerning(face->face, previous, glyphIndex, FT_KERNING_UNSCALED, &delta) == 0) {
+                pen.x += static_cast<double>(delta.x);
+            }
+        }
+
+        const Glyph* g = cache.glyph(faceIndex, *face, glyphIndex, embolden);
+        for (const OutlineContour& source : g->contours) {
+            OutlineContour c;
+            c.isHole = source.isHole;
+            c.glyph = result.glyphCount;
+            c.area = source.area * scale * scale;  // Shear and rotation keep area
+            c.segments.reserve(source.segments.size());
+            for (const OutlineSegment& s : source.segments) {
+                OutlineSegment seg;
+                seg.type = s.type;
+                seg.start = place(s.start, pen);
+                seg.end = place(s.end, pen);
+                result.bounds.include(seg.start);
+                if (s.type != OutlineSegmentType::Line) {
+                    seg.control1 = place(s.control1, pen);
+                    result.bounds.include(seg.control1);
+                }
+                if (s.type == OutlineSegmentType::Cubic) {
+                    seg.control2 = place(s.control2, pen);
+                    result.bounds.include(seg.control2);
+                }
+                c.segments.push_back(seg);
+            }
+            result.contours.push_back(std::move(c));
+        }
+
+        pen.x += g->advance;
+        previous = glyphIndex;
+        ++result.glyphCount;
+    }
+
+    result.success = true;
+    return result;
+}
+
+#else  // !HOBBYCAD_HAS_FREETYPE — text outlines compiled out
+
+namespace {
+const char* const UNAVAILABLE = "Text outlines are unavailable (built without FreeType)";
+}
+
+bool textOutlinesAvailable()
+{
+    return false;
+}
+
+bool addFontFile(const std::string& /*path*/, std::string* errorMsg)
+{
+    if (errorMsg) *errorMsg = UNAVAILABLE;
+    return false;
+}
+
+int addFontDirectory(const std::string& /*path*/) { return 0; }
+
+std::vector<FontInfo> availableFonts() { return {}; }
+
+bool findFont(const TextStyle& /*style*/, FontInfo* /*font*/, bool* substituted)
+{
+    if (substituted) *substituted = false;
+    return false;
+}
+
+GlyphCacheStats glyphCacheStats() { return {}; }
+
+void clearGlyphCache() {}
+
+TextOutline layoutText(
+    const std::string& /*text*/,
+    const Point2D& /*position*/,
+    const TextStyle& /*style*/,
+    double /*size*/,
+    double /*rotationDegrees*/)
+{
+    TextOutline result;
+    result.errorMessage = UNAVAILABLE;
+    return result;
+}
+
+#endif  // HOBBYCAD_HAS_FREETYPE
+
+TextOutline textOutline(const Entity& entity)
+{
+    if (entity.type != EntityType::Text || entity.points.empty()) {
+        TextOutline result;
+        result.errorMessage = "Not a text entity";
+        return result;
+    }
+
+    TextStyle style;
+    style.fontFamily = entity.fontFamily;
+    style.bold = entity.fontBold;
+    style.italic = entity.fontItalic;
+    return layoutText(entity.text, entity.points[0], style, entity.fontSize, entity.textRotation);
+}
+
+// =====================================================================
+//  Conversion
+// =====================================================================
+
+std::vector<Point2D> contourToPolygon(const OutlineContour& contour, double tolerance)
+{
+    std::vector<Point2D> polygon;
+    tolerance = std::max(tolerance, 1e-9);
+
+    for (const OutlineSegment& seg : contour.segments) {
+        polygon.push_back(seg.start);
+        if (seg.type == OutlineSegmentType::Line) continue;
+
+        int steps = bezierSteps(seg, tolerance);
+        for (int k = 1; k < steps; ++k) {
+            polygon.push_back(bezierPoint(seg, static_cast<double>(k) / steps));
+        }
+    }
+
+    return polygon;
+}
+
+std::vector<std::vector<Point2D>> outlineToPolygons(const TextOutline& outline, double tolerance)
+{
+    std::vector<std::vector<Point2D>> polygons;
+    polygons.reserve(outline.contours.size());
+    for (const OutlineContour& contour : outline.contours) {
+        std::vector<Point2D> polygon = contourToPolygon(contour, tolerance);
+        if (polygon.size() >= 3) {
+            polygons.push_back(std::move(polygon));
+        }
+    }
+    return polygons;
+}
+
+std::vector<Entity> textToEntities(
+    const Entity& entity,
+    std::function<int()> nextId,
+    double tolerance)
+{
+    std::vector<Entity> lines;
+
+    TextOutline outline = textOutline(entity);
+    if (!outline.success) return lines;
+
+    for (const std::vector<Point2D>& polygon : outlineToPolygons(outline, tolerance)) {
+        for (size_t i = 0; i < polygon.size(); ++i) {
+            const Point2D& a = polygon[i];
+            const Point2D& b = polygon[(i + 1) % polygon.size()];
+            if (a == b) continue;
+
+            Entity line = createLine(nextId(), a, b);
+            line.isConstruction = entity.isConstruction;
+            lines.push_back(std::move(line));
+        }
+    }
+
+    return lines;
+}
+
+}  // namespace sketch
+}  // namespace hobbycad
@@ -10,6 +10,38 @@
 namespace hobbycad {
 namespace sketch {
 
+namespace {
+
+/// Estimated size of a command and its sub-commands.  The entity,
+/// constraint and group footprints include the objects themselves,
+/// which sizeof(UndoCommand) already covers.
+std::int64_t commandBytes(const UndoCommand& cmd)
+{
+    constexpr std::int64_t kEmbedded =
+        2 * static_cast<std::int64_t>(sizeof(Entity) + sizeof(Constraint) + sizeof(Group));
+
+    std::int64_t bytes = static_cast<std::int64_t>(sizeof(UndoCommand)) - kEmbedded +
+                         memory::heapBytes(cmd.description) +
+                         memory::footprint(cmd.entity) + memory::footprint(cmd.previousEntity) +
+                         memory::footprint(cmd.constraint) + memory::footprint(cmd.previousConstraint) +
+                         memory::footprint(cmd.group) + memory::footprint(cmd.previousGroup);
+    for (const auto& sub : cmd.subCommands) {
+        bytes += commandBytes(sub);
+    }
+    return bytes;
+}
+
+std::int64_t commandBytes(const std::vector<UndoCommand>& commands)
+{
+    std::int64_t bytes = 0;
+    for (const auto& cmd : commands) {
+        bytes += commandBytes(cmd);
+    }
+    return bytes;
+}
+
+}  // namespace
+
 // =====================================================================
 //  UndoCommand Static Factories
 // =====================================================================
@@ -132,10 +164,12 @@ void UndoStack::push(const UndoCommand& command)
 {
     if (m_recordingCompound) {
         m_compoundCommands.push_back(command);
+        m_charge.add(commandBytes(command));
         return;
     }
 
     m_undoStack.push_back(command);
+    m_charge.add(commandBytes(command) - commandBytes(m_redoStack));
     m_redoStack.clear();
     m_modified = true;
     enforceMaxSize();
@@ -234,6 +268,7 @@ std::vector<std::string> UndoStack::redoDescriptions() const
 
 void UndoStack::clear()
 {
+    m_charge.add(-commandBytes(m_undoStack) - commandBytes(m_redoStack));
     m_undoStack.clear();
     m_redoStack.clear();
     m_modified = false;
@@ -241,6 +276,7 @@ void UndoStack::clear()
 
 void UndoStack::clearRedo()
 {
+    m_charge.add(-commandBytes(m_redoStack));
     m_redoStack.clear();
 }
 
@@ -257,6 +293,7 @@ void UndoStack::beginCompound(const std::string& description)
         return;
     }
     m_recordingCompound = true;
+    m_charge.add(-commandBytes(m_compoundCommands));
     m_compoundCommands.clear();
     m_compoundDescription = description;
 }
@@ -271,6 +308,7 @@ void UndoStack::endCompound()
         pushCompound(m_compoundCommands, m_compoundDescription);
     }
 
+    m_charge.add(-commandBytes(m_compoundCommands));
     m_compoundCommands.clear();
     m_compoundDescription.clear();
 }
@@ -278,6 +316,7 @@ void UndoStack::endCompound()
 void UndoStack::enforceMaxSize()
 {
     while (static_cast<int>(m_undoStack.size()) > m_maxSize) {
+        m_charge.add(-commandBytes(m_undoStack.front()));
         m_undoStack.erase(m_undoStack.begin());
     }
 }
@@ -0,0 +1,708 @@
+// =====================================================================
+//  src/libhobbycad/sketch_io.cpp — Binary sketch encoding
+// =====================================================================
+
+#include "hobbycad/sketch_io.h"
+#include "hobbycad/format.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+namespace hobbycad {
+namespace sketch_io {
+
+namespace {
+
+constexpr uint8_t kMagic[4] = {'H', 'C', 'S', 'K'};
+
+// Entity flag bits
+constexpr uint8_t kEntConstruction = 0x01;
+constexpr uint8_t kEntConstrained  = 0x02;
+constexpr uint8_t kEntArcFlipped   = 0x04;
+constexpr uint8_t kEntFontBold     = 0x08;
+constexpr uint8_t kEntFontItalic   = 0x10;
+
+// Entity attribute bits — set when the value differs from the default
+// in sketch::Entity, so common entities carry no attributes at all
+constexpr uint32_t kAttrRadius       = 1u << 0;
+constexpr uint32_t kAttrStartAngle   = 1u << 1;
+constexpr uint32_t kAttrSweepAngle   = 1u << 2;
+constexpr uint32_t kAttrSides        = 1u << 3;
+constexpr uint32_t kAttrMajorRadius  = 1u << 4;
+constexpr uint32_t kAttrMinorRadius  = 1u << 5;
+constexpr uint32_t kAttrText         = 1u << 6;
+constexpr uint32_t kAttrFontFamily   = 1u << 7;
+constexpr uint32_t kAttrFontSize     = 1u << 8;
+constexpr uint32_t kAttrTextRotation = 1u << 9;
+constexpr uint32_t kAttrGroup        = 1u << 10;
+
+// Constraint flag bits
+constexpr uint8_t kConDriving      = 0x01;
+constexpr uint8_t kConLabelVisible = 0x02;
+constexpr uint8_t kConEnabled      = 0x04;
+
+// Background flag bits
+constexpr uint8_t kBgEnabled      = 0x01;
+constexpr uint8_t kBgLockAspect   = 0x02;
+constexpr uint8_t kBgFlipH        = 0x04;
+constexpr uint8_t kBgFlipV        = 0x08;
+constexpr uint8_t kBgGrayscale    = 0x10;
+constexpr uint8_t kBgCalibrated   = 0x20;
+
+bool hostIsLittleEndian()
+{
+    const uint16_t probe = 1;
+    uint8_t first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+uint32_t zigzag(int32_t v)
+{
+    return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+}
+
+int32_t unzigzag(uint32_t v)
+{
+    return static_cast<int32_t>((v >> 1) ^ (~(v & 1) + 1));
+}
+
+// ---- Writer ---------------------------------------------------------
+
+class Writer {
+public:
+    explicit Writer(std::vector<uint8_t>& out) : m_out(out) {}
+
+    void byte(uint8_t b) { m_out.push_back(b); }
+
+    void bytes(const uint8_t* data, size_t n)
+    {
+        m_out.insert(m_out.end(), data, data + n);
+    }
+
+    void varint(uint64_t v)
+    {
+        while (v >= 0x80) {
+            m_out.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        m_out.push_back(static_cast<uint8_t>(v));
+    }
+
+    void svarint(int v) { varint(zigzag(v)); }
+
+    void f64(double v)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof bits);
+        for (int i = 0; i < 8; ++i) {
+            m_out.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+        }
+    }
+
+    /// Append a run of doubles; a straight copy on little-endian hosts
+    void f64Column(const std::vector<double>& values)
+    {
+        if (hostIsLittleEndian()) {
+            const auto* p = reinterpret_cast<const uint8_t*>(values.data());
+            bytes(p, values.size() * sizeof(double));
+        } else {
+            for (double v : values) f64(v);
+        }
+    }
+
+    void str(const std::string& s)
+    {
+        varint(s.size());
+        bytes(reinterpret_cast<const uint8_t*>(s.data()), s.size());
+    }
+
+private:
+    std::vector<uint8_t>& m_out;
+};
+
+// ---- Reader ---------------------------------------------------------
+
+/// Bounds-checked cursor.  Any overrun latches the failed state and
+/// every later read returns zero, so callers check ok() once per
+/// section rather than after every field.
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size) : m_p(data), m_end(data + size) {}
+
+    bool ok() const { return m_ok; }
+    size_t remaining() const { return static_cast<size_t>(m_end - m_p); }
+
+    uint8_t byte()
+    {
+        if (!need(1)) return 0;
+        return *m_p++;
+    }
+
+    const uint8_t* bytes(size_t n)
+    {
+        if (!need(n)) return nullptr;
+        const uint8_t* p = m_p;
+        m_p += n;
+        return p;
+    }
+
+    uint64_t varint()
+    {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (!need(1)) return 0;
+            uint8_t b = *m_p++;
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        m_ok = false;
+        return 0;
+    }
+
+    int svarint() { return unzigzag(static_cast<uint32_t>(varint())); }
+
+    /// Read an element count, rejecting counts that could not possibly
+    /// fit in the remaining input (each element takes at least
+    /// minBytes), so corrupt files cannot trigger huge allocations.
+    size_t count(size_t minBytes = 1)
+    {
+        uint64_t n = varint();
+        if (minBytes > 0 && n > remaining() / minBytes) {
+            m_ok = false;
+            return 0;
+        }
+        return static_cast<size_t>(n);
+    }
+
+    double f64()
+    {
+        const uint8_t* p = bytes(8);
+        if (!p) return 0.0;
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; ++i) {
+            bits |= static_cast<uint64_t>(p[i]) << (8 * i);
+        }
+        double v;
+        std::memcpy(&v, &bits, sizeof v);
+        return v;
+    }
+
+    void f64Column(std::vector<double>& values, size_t n)
+    {
+        values.resize(n);
+        if (hostIsLittleEndian()) {
+            const uint8_t* p = bytes(n * sizeof(double));
+            if (p && n > 0) std::memcpy(values.data(), p, n * sizeof(double));
+        } else {
+            for (size_t i = 0; i < n; ++i) values[i] = f64();
+        }
+    }
+
+    std::string str()
+    {
+        size_t n = count(1);
+        const uint8_t* p = bytes(n);
+        return p ? std::string(reinterpret_cast<const char*>(p), n) : std::string();
+    }
+
+private:
+    bool need(size_t n)
+    {
+        if (!m_ok || remaining() < n) {
+            m_ok = false;
+            return false;
+        }
+        return true;
+    }
+
+    const uint8_t* m_p;
+    const uint8_t* m_end;
+    bool m_ok = true;
+};
+
+// ---- String interning -----------------------------------------------
+
+class StringTable {
+public:
+    /// Index of s in the table; index 0 is always the empty string
+    uint32_t intern(const std::string& s)
+    {
+        if (s.empty()) return 0;
+        auto [it, inserted] = m_index.emplace(s, static_cast<uint32_t>(m_strings.size() + 1));
+        if (inserted) m_strings.push_back(s);
+        return it->second;
+    }
+
+    const std::vector<std::string>& strings() const { return m_strings; }
+
+private:
+    std::vector<std::string> m_strings;
+    std::unordered_map<std::string, uint32_t> m_index;
+};
+
+// ---- Sections -------------------------------------------------------
+
+void writeEntities(Writer& w, const std::vector<SketchEntityData>& entities,
+                   StringTable& strings, std::vector<uint8_t>& stringBlock)
+{
+    const size_t n = entities.size();
+    w.varint(n);
+
+    // IDs — delta-coded, since sketches allocate them in increasing order
+    int prevId = 0;
+    for (const auto& e : entities) {
+        w.svarint(e.id - prevId);
+        prevId = e.id;
+    }
+
+    for (const auto& e : entities) w.byte(static_cast<uint8_t>(e.type));
+
+    for (const auto& e : entities) {
+        uint8_t flags = 0;
+        if (e.isConstruction) flags |= kEntConstruction;
+        if (e.constrained)    flags |= kEntConstrained;
+        if (e.arcFlipped)     flags |= kEntArcFlipped;
+        if (e.fontBold)       flags |= kEntFontBold;
+        if (e.fontItalic)     flags |= kEntFontItalic;
+        w.byte(flags);
+    }
+
+    // Points — counts first, then all X values and all Y values
+    size_t totalPoints = 0;
+    for (const auto& e : entities) {
+        w.varint(e.points.size());
+        totalPoints += e.points.size();
+    }
+    std::vector<double> column;
+    column.reserve(totalPoints);
+    for (const auto& e : entities) {
+        for (const auto& pt : e.points) column.push_back(pt.x);
+    }
+    w.f64Column(column);
+    column.clear();
+    for (const auto& e : entities) {
+        for (const auto& pt : e.points) column.push_back(pt.y);
+    }
+    w.f64Column(column);
+
+    // Attributes — a mask per entity, then only the non-default values
+    const sketch::Entity defaults;
+    std::vector<double> scalars;
+    std::vector<uint8_t> ints;
+    Writer intWriter(ints);
+    for (const auto& e : entities) {
+        uint32_t mask = 0;
+        if (e.radius != defaults.radius)             mask |= kAttrRadius;
+        if (e.startAngle != defaults.startAngle)     mask |= kAttrStartAngle;
+        if (e.sweepAngle != defaults.sweepAngle)     mask |= kAttrSweepAngle;
+        if (e.sides != defaults.sides)               mask |= kAttrSides;
+        if (e.majorRadius != defaults.majorRadius)   mask |= kAttrMajorRadius;
+        if (e.minorRadius != defaults.minorRadius)   mask |= kAttrMinorRadius;
+        if (!e.text.empty())                         mask |= kAttrText;
+        if (!e.fontFamily.empty())                   mask |= kAttrFontFamily;
+        if (e.fontSize != defaults.fontSize)         mask |= kAttrFontSize;
+        if (e.textRotation != defaults.textRotation) mask |= kAttrTextRotation;
+        if (e.groupId != defaults.groupId)           mask |= kAttrGroup;
+        w.varint(mask);
+
+        if (mask & kAttrRadius)       scalars.push_back(e.radius);
+        if (mask & kAttrStartAngle)   scalars.push_back(e.startAngle);
+        if (mask & kAttrSweepAngle)   scalars.push_back(e.sweepAngle);
+        if (mask & kAttrMajorRadius)  scalars.push_back(e.majorRadius);
+        if (mask & kAttrMinorRadius)  scalars.push_back(e.minorRadius);
+        if (mask & kAttrFontSize)     scalars.push_back(e.fontSize);
+        if (mask & kAttrTextRotation) scalars.push_back(e.textRotation);
+
+        if (mask & kAttrSides)      intWriter.svarint(e.sides);
+        if (mask & kAttrText)       intWriter.varint(strings.intern(e.text));
+        if (mask & kAttrFontFamily) intWriter.varint(strings.intern(e.fontFamily));
+        if (mask & kAttrGroup)      intWriter.svarint(e.groupId);
+    }
+    w.varint(scalars.size());
+    w.f64Column(scalars);
+    w.varint(ints.size());
+    w.bytes(ints.data(), ints.size());
+
+    // The string table precedes the entity block on disk but is only
+    // complete once every entity has been visited
+    Writer sw(stringBlock);
+    sw.varint(strings.strings().size());
+    for (const auto& s : strings.strings()) sw.str(s);
+}
+
+bool readEntities(Reader& r, const std::vector<std::string>& strings,
+                  std::vector<SketchEntityData>& entities)
+{
+    const size_t n = r.count(3);  // ID, type and flag bytes at minimum
+    entities.assign(n, SketchEntityData{});
+
+    int id = 0;
+    for (auto& e : entities) {
+        id += r.svarint();
+        e.id = id;
+    }
+    for (auto& e : entities) e.type = static_cast<SketchEntityType>(r.byte());
+    for (auto& e : entities) {
+        uint8_t flags = r.byte();
+        e.isConstruction = flags & kEntConstruction;
+        e.constrained    = flags & kEntConstrained;
+        e.arcFlipped     = flags & kEntArcFlipped;
+        e.fontBold       = flags & kEntFontBold;
+        e.fontItalic     = flags & kEntFontItalic;
+    }
+    if (!r.ok()) return false;
+
+    size_t totalPoints = 0;
+    for (auto& e : entities) {
+        size_t count = r.count(16);
+        e.points.resize(count);
+        totalPoints += count;
+    }
+    if (!r.ok() || totalPoints > r.remaining() / 16) return false;
+
+    std::vector<double> xs, ys;
+    r.f64Column(xs, totalPoints);
+    r.f64Column(ys, totalPoints);
+    if (!r.ok()) return false;
+    size_t k = 0;
+    for (auto& e : entities) {
+        for (auto& pt : e.points) {
+            pt.x = xs[k];
+            pt.y = ys[k];
+            ++k;
+        }
+    }
+
+    std::vector<uint32_t> masks(n);
+    for (auto& m : masks) m = static_cast<uint32_t>(r.varint());
+
+    std::vector<double> scalars;
+    r.f64Column(scalars, r.count(8));
+    size_t intBytes = r.count(1);
+    Reader ints(r.bytes(intBytes), intBytes);
+    if (!r.ok()) return false;
+
+    auto lookup = [&strings](uint64_t index) -> std::string {
+        return index > 0 && index <= strings.size() ? strings[index - 1] : std::string();
+    };
+
+    size_t s = 0;
+    auto nextScalar = [&scalars, &s]() {
+        return s < scalars.size() ? scalars[s++] : 0.0;
+    };
+
+    for (size_t i = 0; i < n; ++i) {
+        auto& e = entities[i];
+        const uint32_t mask = masks[i];
+        if (mask & kAttrRadius)       e.radius = nextScalar();
+        if (mask & kAttrStartAngle)   e.startAngle = nextScalar();
+        if (mask & kAttrSweepAngle)   e.sweepAngle = nextScalar();
+        if (mask & kAttrMajorRadius)  e.majorRadius = nextScalar();
+        if (mask & kAttrMinorRadius)  e.minorRadius = nextScalar();
+        if (mask & kAttrFontSize)     e.fontSize = nextScalar();
+        if (mask & kAttrTextRotation) e.textRotation = nextScalar();
+
+        if (mask & kAttrSides)      e.sides = ints.svarint();
+        if (mask & kAttrText)       e.text = lookup(ints.varint());
+        if (mask & kAttrFontFamily) e.fontFamily = lookup(ints.varint());
+        if (mask & kAttrGroup)      e.groupId = ints.svarint();
+    }
+
+    return ints.ok() && s == scalars.size();
+}
+
+void writeConstraints(Writer& w, const std::vector<ConstraintData>& constraints)
+{
+    w.varint(constraints.size());
+
+    int prevId = 0;
+    for (const auto& c : constraints) {
+        w.svarint(c.id - prevId);
+        prevId = c.id;
+    }
+    for (const auto& c : constraints) w.varint(static_cast<uint32_t>(c.type));
+    for (const auto& c : constraints) {
+        uint8_t flags = 0;
+        if (c.isDriving)    flags |= kConDriving;
+        if (c.labelVisible) flags |= kConLabelVisible;
+        if (c.enabled)      flags |= kConEnabled;
+        w.byte(flags);
+    }
+    for (const auto& c : constraints) {
+        w.varint(c.entityIds.size());
+        for (int eid : c.entityIds) w.svarint(eid);
+        w.varint(c.pointIndices.size());
+        for (int pidx : c.pointIndices) w.svarint(pidx);
+    }
+
+    std::vector<double> column;
+    column.reserve(constraints.size());
+    for (const auto& c : constraints) column.push_back(c.value);
+    w.f64Column(column);
+    column.clear();
+    for (const auto& c : constraints) column.push_back(c.labelPosition.x);
+    w.f64Column(column);
+    column.clear();
+    for (const auto& c : constraints) column.push_back(c.labelPosition.y);
+    w.f64Column(column);
+}
+
+bool readConstraints(Reader& r, std::vector<ConstraintData>& constraints)
+{
+    const size_t n = r.count(3 + 24);  // IDs, type, flags and three doubles
+    constraints.assign(n, ConstraintData{});
+
+    int id = 0;
+    for (auto& c : constraints) {
+        id += r.svarint();
+        c.id = id;
+    }
+    for (auto& c : constraints) c.type = static_cast<ConstraintType>(r.varint());
+    for (auto& c : constraints) {
+        uint8_t flags = r.byte();
+        c.isDriving    = flags & kConDriving;
+        c.labelVisible = flags & kConLabelVisible;
+        c.enabled      = flags & kConEnabled;
+    }
+    for (auto& c : constraints) {
+        c.entityIds.resize(r.count(1));
+        for (int& eid : c.entityIds) eid = r.svarint();
+        c.pointIndices.resize(r.count(1));
+        for (int& pidx : c.pointIndices) pidx = r.svarint();
+    }
+    if (!r.ok()) return false;
+
+    std::vector<double> values, labelX, labelY;
+    r.f64Column(values, n);
+    r.f64Column(labelX, n);
+    r.f64Column(labelY, n);
+    if (!r.ok()) return false;
+
+    for (size_t i = 0; i < n; ++i) {
+        constraints[i].value = values[i];
+        constraints[i].labelPosition = Point2D(labelX[i], labelY[i]);
+    }
+    return true;
+}
+
+bool backgroundIsSet(const sketch::BackgroundImage& bg)
+{
+    return bg.enabled || !bg.filePath.empty() || !bg.imageData.empty();
+}
+
+void writeBackground(Writer& w, const sketch::BackgroundImage& bg)
+{
+    if (!backgroundIsSet(bg)) {
+        w.byte(0);
+        return;
+    }
+    w.byte(1);
+
+    uint8_t flags = 0;
+    if (bg.enabled)         flags |= kBgEnabled;
+    if (bg.lockAspectRatio) flags |= kBgLockAspect;
+    if (bg.flipHorizontal)  flags |= kBgFlipH;
+    if (bg.flipVertical)    flags |= kBgFlipV;
+    if (bg.grayscale)       flags |= kBgGrayscale;
+    if (bg.calibrated)      flags |= kBgCalibrated;
+    w.byte(flags);
+
+    w.varint(static_cast<uint32_t>(bg.storage));
+    w.str(bg.filePath);
+    w.str(bg.mimeType);
+    w.f64(bg.position.x);
+    w.f64(bg.position.y);
+    w.f64(bg.width);
+    w.f64(bg.height);
+    w.f64(bg.rotation);
+    w.f64(bg.opacity);
+    w.f64(bg.contrast);
+    w.f64(bg.brightness);
+    w.f64(bg.calibrationScale);
+    w.svarint(bg.originalPixelWidth);
+    w.svarint(bg.originalPixelHeight);
+    w.varint(bg.imageData.size());
+    w.bytes(bg.imageData.data(), bg.imageData.size());
+}
+
+bool readBackground(Reader& r, sketch::BackgroundImage& bg)
+{
+    if (r.byte() == 0) return r.ok();
+
+    uint8_t flags = r.byte();
+    bg.enabled         = flags & kBgEnabled;
+    bg.lockAspectRatio = flags & kBgLockAspect;
+    bg.flipHorizontal  = flags & kBgFlipH;
+    bg.flipVertical    = flags & kBgFlipV;
+    bg.grayscale       = flags & kBgGrayscale;
+    bg.calibrated      = flags & kBgCalibrated;
+
+    bg.storage = static_cast<sketch::BackgroundStorage>(r.varint());
+    bg.filePath = r.str();
+    bg.mimeType = r.str();
+    double px = r.f64();
+    double py = r.f64();
+    bg.position = Point2D(px, py);
+    bg.width = r.f64();
+    bg.height = r.f64();
+    bg.rotation = r.f64();
+    bg.opacity = r.f64();
+    bg.contrast = r.f64();
+    bg.brightness = r.f64();
+    bg.calibrationScale = r.f64();
+    bg.originalPixelWidth = r.svarint();
+    bg.originalPixelHeight = r.svarint();
+
+    size_t n = r.count(1);
+    const uint8_t* data = r.bytes(n);
+    if (data) bg.imageData.assign(data, data + n);
+    return r.ok();
+}
+
+}  // namespace
+
+// ---- Public API -----------------------------------------------------
+
+std::vector<uint8_t> encodeSketch(const SketchData& sketch)
+{
+    // Entities are encoded into a side buffer first so the string table
+    // they fill can be written ahead of them
+    std::vector<uint8_t> entityBlock;
+    std::vector<uint8_t> stringBlock;
+    {
+        Writer ew(entityBlock);
+        StringTable strings;
+        writeEntities(ew, sketch.entities, strings, stringBlock);
+    }
+
+    std::vector<uint8_t> out;
+    out.reserve(64 + stringBlock.size() + entityBlock.size() +
+                sketch.constraints.size() * 40 +
+                sketch.backgroundImage.imageData.size());
+    Writer w(out);
+
+    w.bytes(kMagic, sizeof kMagic);
+    w.varint(BINARY_FORMAT_VERSION);
+
+    w.str(sketch.name);
+    w.varint(static_cast<uint32_t>(sketch.plane));
+    w.svarint(sketch.constructionPlaneId);
+    w.f64(sketch.planeOffset);
+    w.varint(static_cast<uint32_t>(sketch.rotationAxis));
+    w.f64(sketch.rotationAngle);
+    w.f64(sketch.gridSpacing);
+
+    w.bytes(stringBlock.data(), stringBlock.size());
+    w.bytes(entityBlock.data(), entityBlock.size());
+    writeConstraints(w, sketch.constraints);
+    writeBackground(w, sketch.backgroundImage);
+
+    return out;
+}
+
+bool decodeSketch(const uint8_t* data, size_t size, SketchData& sketch,
+                  std::string* errorMsg)
+{
+    auto fail = [errorMsg](const std::string& what) {
+        if (errorMsg) *errorMsg = what;
+        return false;
+    };
+
+    if (!isBinarySketch(data, size)) {
+        return fail("Not a binary sketch file");
+    }
+
+    Reader r(data + sizeof kMagic, size - sizeof kMagic);
+    uint64_t version = r.varint();
+    if (!r.ok()) return fail("Truncated sketch header");
+    if (version > BINARY_FORMAT_VERSION) {
+        return fail(format(
+            "Sketch was written by a newer version of HobbyCAD (format %d, this version supports %d)",
+            static_cast<int>(version), static_cast<int>(BINARY_FORMAT_VERSION)));
+    }
+
+    sketch = SketchData{};
+    sketch.name = r.str();
+    sketch.plane = static_cast<SketchPlane>(r.varint());
+    sketch.constructionPlaneId = r.svarint();
+    sketch.planeOffset = r.f64();
+    sketch.rotationAxis = static_cast<PlaneRotationAxis>(r.varint());
+    sketch.rotationAngle = r.f64();
+    sketch.gridSpacing = r.f64();
+    if (!r.ok()) return fail("Truncated sketch header");
+
+    std::vector<std::string> strings(r.count(1));
+    for (auto& s : strings) s = r.str();
+    if (!r.ok()) return fail("Corrupt sketch string table");
+
+    if (!readEntities(r, strings, sketch.entities)) {
+        return fail("Corrupt sketch entity data");
+    }
+    if (!readConstraints(r, sketch.constraints)) {
+        return fail("Corrupt sketch constraint data");
+    }
+    if (!readBackground(r, sketch.backgroundImage)) {
+        return fail("Corrupt sketch background image data");
+    }
+
+    return true;
+}
+
+bool isBinarySketch(const uint8_t* data, size_t size)
+{
+    return data && size >= sizeof kMagic &&
+           std::memcmp(data, kMagic, sizeof kMagic) == 0;
+}
+
+bool isBinarySketchFile(const std::string& path)
+{
+    std::ifstream ifs(std::filesystem::u8path(path), std::ios::binary);
+    uint8_t head[sizeof kMagic] = {};
+    if (!ifs.read(reinterpret_cast<char*>(head), sizeof head)) return false;
+    return isBinarySketch(head, sizeof head);
+}
+
+bool writeSketchFile(const std::string& path, const SketchData& sketch,
+                     std::string* errorMsg)
+{
+    std::ofstream ofs(std::filesystem::u8path(path), std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open()) {
+        if (errorMsg) *errorMsg = "Failed to save sketch: " + path;
+        return false;
+    }
+
+    const std::vector<uint8_t> data = encodeSketch(sketch);
+    ofs.write(reinterpret_cast<const char*>(data.data()),
+              static_cast<std::streamsize>(data.size()));
+    if (!ofs.good()) {
+        if (errorMsg) *errorMsg = "Failed to write sketch: " + path;
+        return false;
+    }
+    return true;
+}
+
+bool readSketchFile(const std::string& path, SketchData& sketch,
+                    std::string* errorMsg)
+{
+    std::ifstream ifs(std::filesystem::u8path(path), std::ios::binary);
+    if (!ifs.is_open()) {
+        if (errorMsg) *errorMsg = "Failed to read sketch: " + path;
+        return false;
+    }
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(ifs)),
+                              std::istreambuf_iterator<char>());
+    std::string decodeError;
+    if (!decodeSketch(data.data(), data.size(), sketch, &decodeError)) {
+        if (errorMsg) *errorMsg = decodeError + ": " + path;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace sketch_io
+}  // namespace hobbycad
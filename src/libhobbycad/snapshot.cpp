@@ -0,0 +1,721 @@
+// =====================================================================
+//  src/libhobbycad/snapshot.cpp — Project snapshot history
+// =====================================================================
+//
+//  Part of libhobbycad.
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/snapshot.h>
+
+#ifdef HOBBYCAD_HAS_LIBGIT2
+#include <git2.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace hobbycad {
+namespace snapshot {
+
+namespace fs = std::filesystem;
+
+std::string changeKindName(ChangeKind kind)
+{
+    switch (kind) {
+    case ChangeKind::Added:    return "added";
+    case ChangeKind::Modified: return "modified";
+    case ChangeKind::Deleted:  return "deleted";
+    case ChangeKind::Renamed:  return "renamed";
+    }
+    return "unknown";
+}
+
+#ifdef HOBBYCAD_HAS_LIBGIT2
+
+namespace {
+
+/// Ref that records the snapshot chain (kept off refs/heads so it never
+/// shows up as a user branch)
+const char* const SNAPSHOT_REF = "refs/hobbycad/snapshots";
+
+/// Object store location, relative to the project directory
+const char* const STORE_SUBDIR = "metadata/snapshots";
+
+/// Project subdirectories whose contents are recorded in snapshots
+const char* const MANAGED_DIRS[] = { "geometry", "construction", "sketches", "features" };
+
+/// Fallback identity when the user has no git identity configured
+const char* const DEFAULT_AUTHOR = "HobbyCAD";
+const char* const DEFAULT_EMAIL  = "hobbycad@localhost";
+
+bool isManifestFile(const fs::path& path)
+{
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".hcad";
+}
+
+/// Collect the project's managed files as sorted, '/'-separated paths
+/// relative to the project directory.
+std::vector<std::string> collectManagedFiles(const fs::path& projectDir)
+{
+    std::vector<std::string> files;
+    std::error_code ec;
+
+    for (const auto& entry : fs::directory_iterator(projectDir, ec)) {
+        if (entry.is_regular_file(ec) && isManifestFile(entry.path())) {
+            files.push_back(entry.path().filename().generic_string());
+        }
+    }
+
+    for (const char* dir : MANAGED_DIRS) {
+        fs::path base = projectDir / dir;
+        if (!fs::is_directory(base, ec)) continue;
+
+        for (auto it = fs::recursive_directory_iterator(base, ec);
+             !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            if (it->is_regular_file(ec)) {
+                files.push_back(it->path().lexically_relative(projectDir).generic_string());
+            }
+        }
+    }
+
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+std::string gitError(const std::string& what)
+{
+    const git_error* err = git_error_last();
+    if (err && err->message) {
+        return what + ": " + err->message;
+    }
+    return what;
+}
+
+std::string oidString(const git_oid* oid)
+{
+    return git_oid_tostr_s(oid);
+}
+
+std::string shortOidString(const git_oid* oid)
+{
+    char buf[8];
+    git_oid_tostr(buf, sizeof(buf), oid);
+    return buf;
+}
+
+// ---- RAII wrappers for libgit2 handles ----
+
+template<typename T, void (*FreeFn)(T*)>
+struct GitFree {
+    void operator()(T* ptr) const { if (ptr) FreeFn(ptr); }
+};
+
+using CommitPtr      = std::unique_ptr<git_commit,      GitFree<git_commit,      git_commit_free>>;
+using TreePtr        = std::unique_ptr<git_tree,        GitFree<git_tree,        git_tree_free>>;
+using BlobPtr        = std::unique_ptr<git_blob,        GitFree<git_blob,        git_blob_free>>;
+using ObjectPtr      = std::unique_ptr<git_object,      GitFree<git_object,      git_object_free>>;
+using DiffPtr        = std::unique_ptr<git_diff,        GitFree<git_diff,        git_diff_free>>;
+using SignaturePtr   = std::unique_ptr<git_signature,   GitFree<git_signature,   git_signature_free>>;
+using TreeBuilderPtr = std::unique_ptr<git_treebuilder, GitFree<git_treebuilder, git_treebuilder_free>>;
+
+/// In-memory directory node used to assemble nested trees
+struct DirNode {
+    std::map<std::string, git_oid> files;
+    std::map<std::string, DirNode> dirs;
+};
+
+void insertPath(DirNode& root, const std::string& relPath, const git_oid& oid)
+{
+    DirNode* node = &root;
+    size_t start = 0;
+    size_t slash;
+    while ((slash = relPath.find('/', start)) != std::string::npos) {
+        node = &node->dirs[relPath.substr(start, slash - start)];
+        start = slash + 1;
+    }
+    node->files[relPath.substr(start)] = oid;
+}
+
+bool writeFile(const fs::path& path, const void* data, size_t size)
+{
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open()) return false;
+    ofs.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    return ofs.good();
+}
+
+}  // namespace
+
+// =====================================================================
+//  SnapshotStore Implementation Class (libgit2)
+// =====================================================================
+
+class SnapshotStore::Impl {
+public:
+    /// Cached content hash of a file, valid while size and mtime match
+    struct CachedFile {
+        uintmax_t size = 0;
+        fs::file_time_type mtime;
+        fs::file_time_type hashedAt;  ///< When the content was hashed
+        git_oid oid;
+    };
+
+    /// A file modified this close to its hashing may change again
+    /// without a visible mtime change (coarse timestamps, e.g. 2 s on
+    /// FAT), so its cached hash is not trusted.
+    static constexpr std::chrono::seconds kRacyWindow{2};
+
+    fs::path projectDir;
+    git_repository* repo = nullptr;
+    git_odb* odb = nullptr;
+    std::unordered_map<std::string, CachedFile> statCache;
+
+    Impl() { git_libgit2_init(); }
+
+    ~Impl()
+    {
+        release();
+        git_libgit2_shutdown();
+    }
+
+    void release()
+    {
+        if (odb) { git_odb_free(odb); odb = nullptr; }
+        if (repo) { git_repository_free(repo); repo = nullptr; }
+        statCache.clear();
+        projectDir.clear();
+    }
+
+    bool headOid(git_oid* out) const
+    {
+        return git_reference_name_to_id(out, repo, SNAPSHOT_REF) == 0;
+    }
+
+    /// Hash a managed file, reusing the cached id when the file is
+    /// untouched, and store its content if the object store lacks it.
+    bool hashAndStore(const std::string& relPath, git_oid* out,
+                      bool* stored, std::string* errorMsg)
+    {
+        fs::path fullPath = projectDir / fs::path(relPath);
+        std::error_code ec;
+        uintmax_t size = fs::file_size(fullPath, ec);
+        fs::file_time_type mtime = fs::last_write_time(fullPath, ec);
+        if (ec) {
+            if (errorMsg) *errorMsg = "Cannot stat " + relPath + ": " + ec.message();
+            return false;
+        }
+
+        *stored = false;
+        auto cached = statCache.find(relPath);
+        if (cached != statCache.end() &&
+            cached->second.size == size && cached->second.mtime == mtime &&
+            mtime + kRacyWindow <= cached->second.hashedAt &&
+            git_odb_exists(odb, &cached->second.oid)) {
+            *out = cached->second.oid;
+            return true;
+        }
+
+        fs::file_time_type hashedAt = fs::file_time_type::clock::now();
+        std::string pathStr = fullPath.string();
+        if (git_odb_hashfile(out, pathStr.c_str(), GIT_OBJECT_BLOB) < 0) {
+            if (errorMsg) *errorMsg = gitError("Cannot hash " + relPath);
+            return false;
+        }
+
+        // Only compress and write content the store has never seen
+        if (!git_odb_exists(odb, out)) {
+            if (git_blob_create_from_disk(out, repo, pathStr.c_str()) < 0) {
+                if (errorMsg) *errorMsg = gitError("Cannot store " + relPath);
+                return false;
+            }
+            *stored = true;
+        }
+
+        statCache[relPath] = CachedFile{size, mtime, hashedAt, *out};
+        return true;
+    }
+
+    bool writeTree(const DirNode& node, git_oid* out, std::string* errorMsg) const
+    {
+        git_treebuilder* rawBuilder = nullptr;
+        if (git_treebuilder_new(&rawBuilder, repo, nullptr) < 0) {
+            if (errorMsg) *errorMsg = gitError("Cannot create tree");
+            return false;
+        }
+        TreeBuilderPtr builder(rawBuilder);
+
+        for (const auto& [name, child] : node.dirs) {
+            git_oid childOid;
+            if (!writeTree(child, &childOid, errorMsg)) return false;
+            if (git_treebuilder_insert(nullptr, builder.get(), name.c_str(),
+                                       &childOid, GIT_FILEMODE_TREE) < 0) {
+                if (errorMsg) *errorMsg = gitError("Cannot add directory " + name);
+                return false;
+            }
+        }
+
+        for (const auto& [name, oid] : node.files) {
+            if (git_treebuilder_insert(nullptr, builder.get(), name.c_str(),
+                                       &oid, GIT_FILEMODE_BLOB) < 0) {
+                if (errorMsg) *errorMsg = gitError("Cannot add file " + name);
+                return false;
+            }
+        }
+
+        if (git_treebuilder_write(out, builder.get()) < 0) {
+            if (errorMsg) *errorMsg = gitError("Cannot write tree");
+            return false;
+        }
+        return true;
+    }
+
+    /// Resolve a full or abbreviated snapshot id to its commit
+    CommitPtr resolveCommit(const std::string& spec, std::string* errorMsg) const
+    {
+        git_object* rawObject = nullptr;
+        if (git_revparse_single(&rawObject, repo, spec.c_str()) < 0) {
+            if (errorMsg) *errorMsg = gitError("Unknown snapshot '" + spec + "'");
+            return nullptr;
+        }
+        ObjectPtr object(rawObject);
+
+        git_object* rawCommit = nullptr;
+        if (git_object_peel(&rawCommit, object.get(), GIT_OBJECT_COMMIT) < 0) {
+            if (errorMsg) *errorMsg = gitError("'" + spec + "' is not a snapshot");
+            return nullptr;
+        }
+        return CommitPtr(reinterpret_cast<git_commit*>(rawCommit));
+    }
+
+    TreePtr resolveTree(const std::string& spec, std::string* errorMsg) const
+    {
+        CommitPtr commit = resolveCommit(spec, errorMsg);
+        if (!commit) return nullptr;
+
+        git_tree* rawTree = nullptr;
+        if (git_commit_tree(&rawTree, commit.get()) < 0) {
+            if (errorMsg) *errorMsg = gitError("Cannot read snapshot tree");
+            return nullptr;
+        }
+        return TreePtr(rawTree);
+    }
+
+    static SnapshotInfo commitInfo(const git_commit* commit)
+    {
+        SnapshotInfo info;
+        const git_oid* oid = git_commit_id(commit);
+        info.id = oidString(oid);
+        info.shortId = shortOidString(oid);
+
+        const char* message = git_commit_message(commit);
+        info.message = message ? message : "";
+        while (!info.message.empty() &&
+               (info.message.back() == '\n' || info.message.back() == '\r')) {
+            info.message.pop_back();
+        }
+
+        const git_signature* author = git_commit_author(commit);
+        if (author && author->name) info.author = author->name;
+        info.time = static_cast<int64_t>(git_commit_time(commit));
+
+        if (git_commit_parentcount(commit) > 0) {
+            info.parentId = oidString(git_commit_parent_id(commit, 0));
+        }
+        return info;
+    }
+};
+
+// =====================================================================
+//  SnapshotStore Public Interface (libgit2)
+// =====================================================================
+
+SnapshotStore::SnapshotStore()
+    : m_impl(new Impl())
+{
+}
+
+SnapshotStore::~SnapshotStore()
+{
+    delete m_impl;
+}
+
+bool SnapshotStore::open(const std::string& projectDir, std::string* errorMsg)
+{
+    close();
+
+    std::error_code ec;
+    if (!fs::is_directory(projectDir, ec)) {
+        if (errorMsg) *errorMsg = "Project directory does not exist: " + projectDir;
+        return false;
+    }
+
+    fs::path storeDir = fs::path(projectDir) / STORE_SUBDIR;
+    std::string storeStr = storeDir.string();
+
+    if (fs::exists(storeDir / "HEAD", ec)) {
+        if (git_repository_open_bare(&m_impl->repo, storeStr.c_str()) < 0) {
+            if (errorMsg) *errorMsg = gitError("Cannot open snapshot store");
+            return false;
+        }
+    } else {
+        fs::create_directories(storeDir, ec);
+        if (git_repository_init(&m_impl->repo, storeStr.c_str(), 1) < 0) {
+            if (errorMsg) *errorMsg = gitError("Cannot create snapshot store");
+            return false;
+        }
+        // Keep the store out of any repository the user keeps in the
+        // project directory (a lone '*' ignores the directory's contents)
+        std::ofstream ignore(storeDir / ".gitignore");
+        ignore << "*\n";
+    }
+
+    if (git_repository_odb(&m_impl->odb, m_impl->repo) < 0) {
+        if (errorMsg) *errorMsg = gitError("Cannot open snapshot object database");
+        m_impl->release();
+        return false;
+    }
+
+    m_impl->projectDir = fs::path(projectDir);
+    return true;
+}
+
+void SnapshotStore::close()
+{
+    m_impl->release();
+}
+
+bool SnapshotStore::isOpen() const
+{
+    return m_impl->repo != nullptr;
+}
+
+std::string SnapshotStore::projectDir() const
+{
+    return m_impl->projectDir.string();
+}
+
+SnapshotResult SnapshotStore::takeSnapshot(const std::string& message)
+{
+    SnapshotResult result;
+    if (!isOpen()) {
+        result.errorMessage = "Snapshot store is not open";
+        return result;
+    }
+
+    // Hash every managed file; only unseen content is written
+    DirNode root;
+    for (const std::string& relPath : collectManagedFiles(m_impl->projectDir)) {
+        git_oid oid;
+        bool stored = false;
+        if (!m_impl->hashAndStore(relPath, &oid, &stored, &result.errorMessage)) {
+            return result;
+        }
+        insertPath(root, relPath, oid);
+        result.filesTotal++;
+        if (stored) result.filesStored++;
+    }
+
+    git_oid treeOid;
+    if (!m_impl->writeTree(root, &treeOid, &result.errorMessage)) {
+        return result;
+    }
+
+    git_oid headOid;
+    CommitPtr head;
+    if (m_impl->headOid(&headOid)) {
+        git_commit* rawHead = nullptr;
+        if (git_commit_lookup(&rawHead, m_impl->repo, &headOid) < 0) {
+            result.errorMessage = gitError("Cannot read latest snapshot");
+            return result;
+        }
+        head.reset(rawHead);
+
+        // Nothing changed since the last snapshot
+        if (git_oid_equal(git_commit_tree_id(head.get()), &treeOid)) {
+            result.success = true;
+            result.id = oidString(&headOid);
+            return result;
+        }
+    }
+
+    git_tree* rawTree = nullptr;
+    if (git_tree_lookup(&rawTree, m_impl->repo, &treeOid) < 0) {
+        result.errorMessage = gitError("Cannot read snapshot tree");
+        return result;
+    }
+    TreePtr tree(rawTree);
+
+    git_signature* rawSig = nullptr;
+    if (git_signature_default(&rawSig, m_impl->repo) < 0 &&
+        git_signature_now(&rawSig, DEFAULT_AUTHOR, DEFAULT_EMAIL) < 0) {
+        result.errorMessage = gitError("Cannot create snapshot signature");
+        return result;
+    }
+    SignaturePtr sig(rawSig);
+
+    std::string text = message.empty() ? std::string("Snapshot") : message;
+    git_oid commitOid;
+    int rc = head
+        ? git_commit_create_v(&commitOid, m_impl->repo, SNAPSHOT_REF, sig.get(), sig.get(),
+                              nullptr, text.c_str(), tree.get(), 1, head.get())
+        : git_commit_create_v(&commitOid, m_impl->repo, SNAPSHOT_REF, sig.get(), sig.get(),
+                              nullptr, text.c_str(), tree.get(), 0);
+    if (rc < 0) {
+        result.errorMessage = gitError("Cannot record snapshot");
+        return result;
+    }
+
+    result.success = true;
+    result.created = true;
+    result.id = oidString(&commitOid);
+    return result;
+}
+
+std::vector<SnapshotInfo> SnapshotStore::listSnapshots(int maxCount) const
+{
+    std::vector<SnapshotInfo> snapshots;
+    if (!isOpen()) return snapshots;
+
+    git_oid oid;
+    if (!m_impl->headOid(&oid)) return snapshots;
+
+    // Snapshots form a single first-parent chain, so follow it directly
+    // instead of running a sorted revision walk
+    while (maxCount < 0 || static_cast<int>(snapshots.size()) < maxCount) {
+        git_commit* rawCommit = nullptr;
+        if (git_commit_lookup(&rawCommit, m_impl->repo, &oid) < 0) break;
+        CommitPtr commit(rawCommit);
+
+        snapshots.push_back(Impl::commitInfo(commit.get()));
+        if (git_commit_parentcount(commit.get()) == 0) break;
+        git_oid_cpy(&oid, git_commit_parent_id(commit.get(), 0));
+    }
+
+    return snapshots;
+}
+
+std::string SnapshotStore::headId() const
+{
+    git_oid oid;
+    if (!isOpen() || !m_impl->headOid(&oid)) return {};
+    return oidString(&oid);
+}
+
+bool SnapshotStore::restoreSnapshot(const std::string& id, std::string* errorMsg)
+{
+    if (!isOpen()) {
+        if (errorMsg) *errorMsg = "Snapshot store is not open";
+        return false;
+    }
+
+    TreePtr tree = m_impl->resolveTree(id, errorMsg);
+    if (!tree) return false;
+
+    // Keep the current state reachable so the restore can be undone.
+    // Nothing is committed if it matches the latest snapshot.
+    SnapshotResult before = takeSnapshot("Before restore");
+    if (!before.success) {
+        if (errorMsg) *errorMsg = "Cannot snapshot current state: " + before.errorMessage;
+        return false;
+    }
+
+    // Gather every blob in the snapshot
+    struct WalkState {
+        std::vector<std::pair<std::string, git_oid>> blobs;
+    } state;
+
+    auto collect = [](const char* root, const git_tree_entry* entry, void* payload) -> int {
+        if (git_tree_entry_type(entry) == GIT_OBJECT_BLOB) {
+            auto* st = static_cast<WalkState*>(payload);
+            st->blobs.emplace_back(std::string(root) + git_tree_entry_name(entry),
+                                   *git_tree_entry_id(entry));
+        }
+        return 0;
+    };
+    if (git_tree_walk(tree.get(), GIT_TREEWALK_PRE, collect, &state) < 0) {
+        if (errorMsg) *errorMsg = gitError("Cannot read snapshot contents");
+        return false;
+    }
+
+    std::unordered_set<std::string> snapshotPaths;
+    for (const auto& [relPath, oid] : state.blobs) {
+        snapshotPaths.insert(relPath);
+        fs::path fullPath = m_impl->projectDir / fs::path(relPath);
+
+        // Leave files alone whose content already matches
+        std::error_code ec;
+        if (fs::is_regular_file(fullPath, ec)) {
+            git_oid current;
+            if (git_odb_hashfile(&current, fullPath.string().c_str(), GIT_OBJECT_BLOB) == 0 &&
+                git_oid_equal(&current, &oid)) {
+                continue;
+            }
+        }
+
+        git_blob* rawBlob = nullptr;
+        if (git_blob_lookup(&rawBlob, m_impl->repo, &oid) < 0) {
+            if (errorMsg) *errorMsg = gitError("Cannot read " + relPath);
+            return false;
+        }
+        BlobPtr blob(rawBlob);
+
+        if (!writeFile(fullPath, git_blob_rawcontent(blob.get()),
+                       static_cast<size_t>(git_blob_rawsize(blob.get())))) {
+            if (errorMsg) *errorMsg = "Cannot write " + fullPath.string();
+            return false;
+        }
+        m_impl->statCache.erase(relPath);
+    }
+
+    // Remove managed files the snapshot does not contain
+    for (const std::string& relPath : collectManagedFiles(m_impl->projectDir)) {
+        if (snapshotPaths.count(relPath) == 0) {
+            std::error_code ec;
+            fs::remove(m_impl->projectDir / fs::path(relPath), ec);
+            m_impl->statCache.erase(relPath);
+        }
+    }
+
+    return true;
+}
+
+DiffSummary SnapshotStore::diff(const std::string& fromId, const std::string& toId) const
+{
+    DiffSummary summary;
+    if (!isOpen()) {
+        summary.errorMessage = "Snapshot store is not open";
+        return summary;
+    }
+
+    TreePtr fromTree = m_impl->resolveTree(fromId, &summary.errorMessage);
+    if (!fromTree) return summary;
+    TreePtr toTree = m_impl->resolveTree(toId, &summary.errorMessage);
+    if (!toTree) return summary;
+
+    git_diff* rawDiff = nullptr;
+    git_diff_options options = GIT_DIFF_OPTIONS_INIT;
+    if (git_diff_tree_to_tree(&rawDiff, m_impl->repo, fromTree.get(), toTree.get(), &options) < 0) {
+        summary.errorMessage = gitError("Cannot compare snapshots");
+        return summary;
+    }
+    DiffPtr diff(rawDiff);
+
+    git_diff_find_options findOptions = GIT_DIFF_FIND_OPTIONS_INIT;
+    findOptions.flags = GIT_DIFF_FIND_RENAMES;
+    git_diff_find_similar(diff.get(), &findOptions);
+
+    size_t count = git_diff_num_deltas(diff.get());
+    summary.changes.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const git_diff_delta* delta = git_diff_get_delta(diff.get(), i);
+        FileChange change;
+        change.path = delta->new_file.path ? delta->new_file.path : "";
+        change.oldPath = delta->old_file.path ? delta->old_file.path : change.path;
+
+        switch (delta->status) {
+        case GIT_DELTA_ADDED:
+            change.kind = ChangeKind::Added;
+            summary.added++;
+            break;
+        case GIT_DELTA_DELETED:
+            change.kind = ChangeKind::Deleted;
+            change.path = change.oldPath;
+            summary.deleted++;
+            break;
+        case GIT_DELTA_RENAMED:
+            change.kind = ChangeKind::Renamed;
+            summary.renamed++;
+            break;
+        default:
+            change.kind = ChangeKind::Modified;
+            summary.modified++;
+            break;
+        }
+        summary.changes.push_back(change);
+    }
+
+    summary.success = true;
+    return summary;
+}
+
+bool SnapshotStore::isAvailable()
+{
+    return true;
+}
+
+#else  // !HOBBYCAD_HAS_LIBGIT2 — snapshot history compiled out
+
+namespace {
+const char* const UNAVAILABLE = "Snapshot history is unavailable (built without libgit2)";
+}
+
+class SnapshotStore::Impl {};
+
+SnapshotStore::SnapshotStore()
+    : m_impl(new Impl())
+{
+}
+
+SnapshotStore::~SnapshotStore()
+{
+    delete m_impl;
+}
+
+bool SnapshotStore::open(const std::string& /*projectDir*/, std::string* errorMsg)
+{
+    if (errorMsg) *errorMsg = UNAVAILABLE;
+    return false;
+}
+
+void SnapshotStore::close() {}
+
+bool SnapshotStore::isOpen() const { return false; }
+
+std::string SnapshotStore::projectDir() const { return {}; }
+
+SnapshotResult SnapshotStore::takeSnapshot(const std::string& /*message*/)
+{
+    SnapshotResult result;
+    result.errorMessage = UNAVAILABLE;
+    return result;
+}
+
+std::vector<SnapshotInfo> SnapshotStore::listSnapshots(int /*maxCount*/) const { return {}; }
+
+std::string SnapshotStore::headId() const { return {}; }
+
+bool SnapshotStore::restoreSnapshot(const std::string& /*id*/, std::string* errorMsg)
+{
+    if (errorMsg) *errorMsg = UNAVAILABLE;
+    return false;
+}
+
+DiffSummary SnapshotStore::diff(const std::string& /*fromId*/, const std::string& /*toId*/) const
+{
+    DiffSummary summary;
+    summary.errorMessage = UNAVAILABLE;
+    return summary;
+}
+
+bool SnapshotStore::isAvailable()
+{
+    return false;
+}
+
+#endif  // HOBBYCAD_HAS_LIBGIT2
+
+}  // namespace snapshot
+}  // namespace hobbycad
@@ -15,18 +15,372 @@
 #include <STEPControl_StepModelType.hxx>
 #include <Interface_Static.hxx>
 #include <IFSelect_ReturnStatus.hxx>
+#include <Message_ProgressScope.hxx>
 #include <XSControl_WorkSession.hxx>
 #include <Transfer_TransientProcess.hxx>
 #include <TopoDS_Compound.hxx>
 #include <BRep_Builder.hxx>
 
+// XDE assembly export
+#include <STEPCAFControl_Writer.hxx>
+#include <XCAFApp_Application.hxx>
+#include <XCAFDoc_ColorTool.hxx>
+#include <XCAFDoc_DocumentTool.hxx>
+#include <XCAFDoc_ShapeTool.hxx>
+#include <TDocStd_Document.hxx>
+#include <TDataStd_Name.hxx>
+#include <TDF_Label.hxx>
+#include <TCollection_ExtendedString.hxx>
+#include <Quantity_Color.hxx>
+
+// Instance detection
+#include <BRepBuilderAPI_Transform.hxx>
+#include <BRepGProp.hxx>
+#include <BRep_Tool.hxx>
+#include <GProp_GProps.hxx>
+#include <OSD_Parallel.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS.hxx>
+#include <gp_Ax3.hxx>
+#include <gp_Trsf.hxx>
+
 #include <algorithm>
+#include <cmath>
 #include <filesystem>
+#include <map>
+#include <mutex>
+#include <utility>
 
 namespace hobbycad {
 namespace step_io {
 
-ReadResult readStep(const std::string& path)
+namespace {
+
+/// The STEP schema is a process-wide Interface_Static setting, so
+/// concurrent writers (e.g. background export jobs) must not interleave
+/// selecting the schema and transferring shapes.
+std::mutex& stepWriteMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+/// Select the schema for the next transfer (caller holds stepWriteMutex)
+void selectSchema(StepVersion version)
+{
+    switch (version) {
+    case StepVersion::AP203:
+        Interface_Static::SetCVal("write.step.schema", "AP203");
+        break;
+    case StepVersion::AP214:
+        Interface_Static::SetCVal("write.step.schema", "AP214CD");
+        break;
+    case StepVersion::AP242:
+        Interface_Static::SetCVal("write.step.schema", "AP242DIS");
+        break;
+    }
+}
+
+// =====================================================================
+//  Instance Detection
+// =====================================================================
+
+/// Volumes and areas of matching bodies agree to this relative precision
+constexpr double kRelativeMeasureTolerance = 1e-6;
+
+/// Highly symmetric bodies offer many equivalent alignments; give up
+/// matching after this many failed candidates
+constexpr int kMaxAlignments = 64;
+
+/// Bodies written as one part definition
+struct PartGroup {
+    TopoDS_Shape definition;                         ///< Geometry without location
+    std::vector<std::pair<int, gp_Trsf>> instances;  ///< Body index, placement
+};
+
+/// Rigid-motion invariants and reference points of a part definition
+struct ShapeSignature {
+    bool valid = false;         ///< False if the shape cannot be aligned
+    int counts[4] = {};         ///< Solids, faces, edges, vertices
+    double measure = 0.0;       ///< Volume of solids, else area
+    double area = 0.0;
+    gp_Pnt centre;
+    std::vector<gp_Pnt> points; ///< Vertices and face centroids
+    int anchor = -1;            ///< Point farthest from the centre
+    int secondAnchor = -1;      ///< Point farthest from the centre-anchor line
+};
+
+ShapeSignature signatureOf(const TopoDS_Shape& shape, double tolerance)
+{
+    ShapeSignature signature;
+    try {
+        TopTools_IndexedMapOfShape solids, faces, edges, vertices;
+        TopExp::MapShapes(shape, TopAbs_SOLID, solids);
+        TopExp::MapShapes(shape, TopAbs_FACE, faces);
+        TopExp::MapShapes(shape, TopAbs_EDGE, edges);
+        TopExp::MapShapes(shape, TopAbs_VERTEX, vertices);
+        signature.counts[0] = solids.Extent();
+        signature.counts[1] = faces.Extent();
+        signature.counts[2] = edges.Extent();
+        signature.counts[3] = vertices.Extent();
+        if (faces.IsEmpty()) return signature;
+
+        GProp_GProps props;
+        if (!solids.IsEmpty()) {
+            BRepGProp::VolumeProperties(shape, props);
+        } else {
+            BRepGProp::SurfaceProperties(shape, props);
+        }
+        if (props.Mass() <= 0.0) return signature;
+        signature.measure = props.Mass();
+        signature.centre = props.CentreOfMass();
+
+        signature.points.reserve(vertices.Extent() + faces.Extent());
+        for (int i = 1; i <= vertices.Extent(); ++i) {
+            signature.points.push_back(BRep_Tool::Pnt(TopoDS::Vertex(vertices(i))));
+        }
+        for (int i = 1; i <= faces.Extent(); ++i) {
+            GProp_GProps faceProps;
+            BRepGProp::SurfaceProperties(faces(i), faceProps);
+            signature.area += faceProps.Mass();
+            if (faceProps.Mass() > 0.0) signature.points.push_back(faceProps.CentreOfMass());
+        }
+    } catch (const Standard_Failure&) {
+        return signature;
+    }
+
+    // Two anchors not in line with the centre fix the orientation
+    double farthest = tolerance;
+    for (size_t i = 0; i < signature.points.size(); ++i) {
+        double d = signature.centre.Distance(signature.points[i]);
+        if (d > farthest) {
+            farthest = d;
+            signature.anchor = static_cast<int>(i);
+        }
+    }
+    if (signature.anchor < 0) return signature;
+
+    const gp_Vec axis(signature.centre, signature.points[signature.anchor]);
+    double offAxis = tolerance;
+    for (size_t i = 0; i < signature.points.size(); ++i) {
+        double d = gp_Vec(signature.centre, signature.points[i]).Crossed(axis).Magnitude() /
+                   axis.Magnitude();
+        if (d > offAxis) {
+            offAxis = d;
+            signature.secondAnchor = static_cast<int>(i);
+        }
+    }
+    signature.valid = signature.secondAnchor >= 0;
+    return signature;
+}
+
+bool sameMeasure(double a, double b)
+{
+    return std::abs(a - b) <= kRelativeMeasureTolerance * std::max(std::abs(a), std::abs(b));
+}
+
+/// Points sorted by x for tolerance lookups
+class PointSet {
+public:
+    PointSet(std::vector<gp_Pnt> points, double tolerance)
+        : m_points(std::move(points)), m_tolerance(tolerance)
+    {
+        std::sort(m_points.begin(), m_points.end(),
+                  [](const gp_Pnt& a, const gp_Pnt& b) { return a.X() < b.X(); });
+    }
+
+    bool contains(const gp_Pnt& p) const
+    {
+        auto it = std::lower_bound(m_points.begin(), m_points.end(), p.X() - m_tolerance,
+                                   [](const gp_Pnt& q, double x) { return q.X() < x; });
+        const double limit = m_tolerance * m_tolerance;
+        for (; it != m_points.end() && it->X() <= p.X() + m_tolerance; ++it) {
+            if (it->SquareDistance(p) <= limit) return true;
+        }
+        return false;
+    }
+
+private:
+    std::vector<gp_Pnt> m_points;
+    double m_tolerance;
+};
+
+/// Find a proper rigid motion taking shape a onto shape b.  Candidate
+/// motions map a's two anchors onto points of b at the same distances;
+/// a candidate is accepted if it maps every reference point of a onto
+/// one of b.  Mirror images never match.
+bool findRigidMotion(const ShapeSignature& a, const ShapeSignature& b,
+                     double tolerance, gp_Trsf* motion)
+{
+    if (!a.valid || !b.valid) return false;
+    if (!std::equal(a.counts, a.counts + 4, b.counts)) return false;
+    if (a.points.size() != b.points.size()) return false;
+    if (!sameMeasure(a.measure, b.measure) || !sameMeasure(a.area, b.area)) return false;
+
+    const gp_Pnt& p1 = a.points[a.anchor];
+    const gp_Pnt& p2 = a.points[a.secondAnchor];
+    const double r1 = a.centre.Distance(p1);
+    const double r2 = a.centre.Distance(p2);
+    const double span = p1.Distance(p2);
+    const gp_Vec x1(a.centre, p1);
+    const gp_Ax3 from(a.centre, gp_Dir(x1.Crossed(gp_Vec(a.centre, p2))), gp_Dir(x1));
+
+    const PointSet targets(b.points, tolerance);
+    int attempts = 0;
+
+    for (const gp_Pnt& q1 : b.points) {
+        if (std::abs(b.centre.Distance(q1) - r1) > tolerance) continue;
+        const gp_Vec x2(b.centre, q1);
+
+        for (const gp_Pnt& q2 : b.points) {
+            if (std::abs(b.centre.Distance(q2) - r2) > tolerance ||
+                std::abs(q1.Distance(q2) - span) > tolerance) {
+                continue;
+            }
+            const gp_Vec normal = x2.Crossed(gp_Vec(b.centre, q2));
+            if (normal.Magnitude() <= tolerance * r1) continue;
+            if (++attempts > kMaxAlignments) return false;
+
+            gp_Trsf candidate;
+            candidate.SetDisplacement(from, gp_Ax3(b.centre, gp_Dir(normal), gp_Dir(x2)));
+
+            bool all = true;
+            for (const gp_Pnt& p : a.points) {
+                if (!targets.contains(p.Transformed(candidate))) {
+                    all = false;
+                    break;
+                }
+            }
+            if (all) {
+                *motion = candidate;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/// Group bodies into parts: first by shared TShape, then by geometric
+/// match between the distinct shapes
+std::vector<PartGroup> groupInstances(const std::vector<AssemblyBody>& bodies,
+                                      const AssemblyOptions& options)
+{
+    std::vector<PartGroup> groups;
+    std::map<std::pair<const TopoDS_TShape*, TopAbs_Orientation>, int> byTShape;
+
+    for (int i = 0; i < static_cast<int>(bodies.size()); ++i) {
+        const TopoDS_Shape& shape = bodies[i].shape;
+        if (shape.IsNull()) continue;
+
+        const gp_Trsf placement = shape.Location().Transformation();
+
+        // A mirroring location cannot place an instance; bake it into
+        // a part of its own
+        if (placement.IsNegative()) {
+            PartGroup group;
+            group.definition = BRepBuilderAPI_Transform(
+                shape.Located(TopLoc_Location()), placement, Standard_True).Shape();
+            group.instances.emplace_back(i, gp_Trsf());
+            groups.push_back(std::move(group));
+            continue;
+        }
+
+        const auto key = std::make_pair(shape.TShape().get(), shape.Orientation());
+        auto found = byTShape.find(key);
+        if (options.deduplicate && found != byTShape.end()) {
+            groups[found->second].instances.emplace_back(i, placement);
+            continue;
+        }
+
+        byTShape[key] = static_cast<int>(groups.size());
+        PartGroup group;
+        group.definition = shape.Located(TopLoc_Location());
+        group.instances.emplace_back(i, placement);
+        groups.push_back(std::move(group));
+    }
+
+    if (!options.deduplicate || groups.size() < 2) return groups;
+
+    std::vector<ShapeSignature> signatures(groups.size());
+    OSD_Parallel::For(0, static_cast<int>(groups.size()), [&](int g) {
+        signatures[g] = signatureOf(groups[g].definition, options.tolerance);
+    }, !options.parallel);
+
+    // Instances of b are placed relative to b's definition, which is a's
+    // definition moved by the motion, so each placement gains it
+    std::vector<PartGroup> parts;
+    std::vector<int> partSignature;
+    for (int g = 0; g < static_cast<int>(groups.size()); ++g) {
+        bool merged = false;
+        for (size_t p = 0; p < parts.size() && !merged; ++p) {
+            gp_Trsf motion;
+            if (!findRigidMotion(signatures[partSignature[p]], signatures[g],
+                                 options.tolerance, &motion)) {
+                continue;
+            }
+            for (const auto& instance : groups[g].instances) {
+                parts[p].instances.emplace_back(instance.first, instance.second * motion);
+            }
+            merged = true;
+        }
+        if (!merged) {
+            parts.push_back(std::move(groups[g]));
+            partSignature.push_back(g);
+        }
+    }
+
+    for (PartGroup& part : parts) {
+        std::sort(part.instances.begin(), part.instances.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+    }
+    return parts;
+}
+
+// =====================================================================
+//  XDE Document
+// =====================================================================
+
+void setName(const TDF_Label& label, const std::string& name)
+{
+    TDataStd_Name::Set(label, TCollection_ExtendedString(name.c_str(), Standard_True));
+}
+
+void setColor(const Handle(XCAFDoc_ColorTool)& colorTool, const TDF_Label& label,
+              const AssemblyBody& body)
+{
+    if (!body.hasColor) return;
+    colorTool->SetColor(label, Quantity_Color(body.red, body.green, body.blue, Quantity_TOC_sRGB),
+                        XCAFDoc_ColorGen);
+}
+
+std::string bodyName(const std::vector<AssemblyBody>& bodies, int index)
+{
+    return bodies[index].name.empty() ? "Body " + std::to_string(index + 1) : bodies[index].name;
+}
+
+bool sameColor(const AssemblyBody& a, const AssemblyBody& b)
+{
+    return a.hasColor == b.hasColor &&
+           (!a.hasColor || (a.red == b.red && a.green == b.green && a.blue == b.blue));
+}
+
+/// Closes the XDE document however the export ends
+struct DocumentGuard {
+    Handle(TDocStd_Application) application;
+    Handle(TDocStd_Document) document;
+
+    ~DocumentGuard()
+    {
+        if (!document.IsNull() && document->IsOpened()) application->Close(document);
+    }
+};
+
+}  // namespace
+
+ReadResult readStep(const std::string& path, const Message_ProgressRange& progress)
 {
     ReadResult result;
 
@@ -36,6 +390,10 @@ ReadResult readStep(const std::string& path)
         return result;
     }
 
+    // Parsing has no progress hook in OCCT; give it a fixed share of
+    // the range and let the root transfer report the rest
+    Message_ProgressScope scope(progress, "Importing STEP", 10);
+
     STEPControl_Reader reader;
 
     // Read the file
@@ -59,11 +417,23 @@ ReadResult readStep(const std::string& path)
         return result;
     }
 
+    scope.Next(3);
+    if (scope.UserBreak()) {
+        result.cancelled = true;
+        result.errorMessage = "Import cancelled";
+        return result;
+    }
+
     // Get statistics
     result.rootCount = reader.NbRootsForTransfer();
 
     // Transfer all roots
-    reader.TransferRoots();
+    reader.TransferRoots(scope.Next(7));
+    if (scope.UserBreak()) {
+        result.cancelled = true;
+        result.errorMessage = "Import cancelled";
+        return result;
+    }
 
     // Get shapes
     int numShapes = reader.NbShapes();
@@ -98,7 +468,8 @@ std::vector<TopoDS_Shape> readStep(const std::string& path, std::string* errorMs
 WriteResult writeStep(
     const std::string& path,
     const std::vector<TopoDS_Shape>& shapes,
-    StepVersion version)
+    StepVersion version,
+    const Message_ProgressRange& progress)
 {
     WriteResult result;
 
@@ -107,30 +478,29 @@ WriteResult writeStep(
         return result;
     }
 
+    std::lock_guard<std::mutex> lock(stepWriteMutex());
+
+    // One step per shape to transfer, plus one for writing the file
+    Message_ProgressScope scope(progress, "Exporting STEP",
+                                static_cast<Standard_Real>(shapes.size() + 1));
+
     STEPControl_Writer writer;
 
     // Set STEP version
-    STEPControl_StepModelType modelType;
-    switch (version) {
-    case StepVersion::AP203:
-        modelType = STEPControl_AsIs;  // AP203 is default
-        Interface_Static::SetCVal("write.step.schema", "AP203");
-        break;
-    case StepVersion::AP214:
-        modelType = STEPControl_AsIs;
-        Interface_Static::SetCVal("write.step.schema", "AP214CD");
-        break;
-    case StepVersion::AP242:
-        modelType = STEPControl_AsIs;
-        Interface_Static::SetCVal("write.step.schema", "AP242DIS");
-        break;
-    }
+    const STEPControl_StepModelType modelType = STEPControl_AsIs;
+    selectSchema(version);
 
     // Transfer shapes to the writer
     for (const TopoDS_Shape& shape : shapes) {
+        Message_ProgressRange shapeRange = scope.Next();
         if (shape.IsNull()) continue;
 
-        IFSelect_ReturnStatus status = writer.Transfer(shape, modelType);
+        IFSelect_ReturnStatus status = writer.Transfer(shape, modelType, Standard_True, shapeRange);
+        if (scope.UserBreak()) {
+            result.cancelled = true;
+            result.errorMessage = "Export cancelled";
+            return result;
+        }
         if (status != IFSelect_RetDone) {
             result.errorMessage = "Failed to transfer shape to STEP";
             return result;
@@ -145,6 +515,7 @@ WriteResult writeStep(
         result.errorMessage = "Failed to write STEP file";
         return result;
     }
+    scope.Next();
 
     result.success = true;
     return result;
@@ -172,6 +543,126 @@ bool writeStep(
     return result.success;
 }
 
+WriteResult writeStepAssembly(
+    const std::string& path,
+    const std::vector<AssemblyBody>& bodies,
+    const AssemblyOptions& options,
+    const Message_ProgressRange& progress)
+{
+    WriteResult result;
+
+    if (bodies.empty()) {
+        result.errorMessage = "No shapes to write";
+        return result;
+    }
+
+    // Instance detection and building the document take a small share;
+    // the transfer dominates
+    Message_ProgressScope scope(progress, "Exporting STEP", 10);
+
+    std::vector<PartGroup> parts;
+    try {
+        parts = groupInstances(bodies, options);
+    } catch (const Standard_Failure& e) {
+        result.errorMessage = std::string("OCCT exception: ") + e.GetMessageString();
+        return result;
+    }
+    if (parts.empty()) {
+        result.errorMessage = "No valid shapes to export";
+        return result;
+    }
+
+    scope.Next();
+    if (scope.UserBreak()) {
+        result.cancelled = true;
+        result.errorMessage = "Export cancelled";
+        return result;
+    }
+
+    std::lock_guard<std::mutex> lock(stepWriteMutex());
+
+    try {
+        DocumentGuard guard;
+        guard.application = XCAFApp_Application::GetApplication();
+        guard.application->NewDocument("MDTV-XCAF", guard.document);
+
+        Handle(XCAFDoc_ShapeTool) shapeTool = XCAFDoc_DocumentTool::ShapeTool(guard.document->Main());
+        Handle(XCAFDoc_ColorTool) colorTool = XCAFDoc_DocumentTool::ColorTool(guard.document->Main());
+
+        const PartGroup& first = parts.front();
+        if (parts.size() == 1 && first.instances.size() == 1 &&
+            first.instances.front().second.Form() == gp_Identity) {
+            // A single body in place needs no assembly around it
+            const int body = first.instances.front().first;
+            TDF_Label label = shapeTool->AddShape(first.definition, Standard_False);
+            setName(label, bodyName(bodies, body));
+            setColor(colorTool, label, bodies[body]);
+        } else {
+            TDF_Label assembly = shapeTool->NewShape();
+            setName(assembly, options.assemblyName.empty()
+                                  ? std::filesystem::path(path).stem().string()
+                                  : options.assemblyName);
+
+            for (const PartGroup& part : parts) {
+                const int firstBody = part.instances.front().first;
+                TDF_Label partLabel = shapeTool->AddShape(part.definition, Standard_False);
+                setName(partLabel, bodyName(bodies, firstBody));
+
+                // One colour for every instance goes on the part; mixed
+                // colours go on the instances
+                bool uniform = std::all_of(part.instances.begin(), part.instances.end(),
+                    [&](const auto& instance) {
+                        return sameColor(bodies[instance.first], bodies[firstBody]);
+                    });
+                if (uniform) setColor(colorTool, partLabel, bodies[firstBody]);
+
+                for (const auto& instance : part.instances) {
+                    TDF_Label component = shapeTool->AddComponent(
+                        assembly, partLabel, TopLoc_Location(instance.second));
+                    setName(component, bodyName(bodies, instance.first));
+                    if (!uniform) setColor(colorTool, component, bodies[instance.first]);
+                }
+            }
+            shapeTool->UpdateAssemblies();
+        }
+
+        for (const PartGroup& part : parts) {
+            result.instanceCount += static_cast<int>(part.instances.size());
+        }
+        result.partCount = static_cast<int>(parts.size());
+        result.shapeCount = result.instanceCount;
+
+        STEPCAFControl_Writer writer;
+        writer.SetNameMode(Standard_True);
+        writer.SetColorMode(Standard_True);
+        selectSchema(options.version);
+
+        const bool transferred = writer.Transfer(guard.document, STEPControl_AsIs, nullptr,
+                                                 scope.Next(8));
+        if (scope.UserBreak()) {
+            result.cancelled = true;
+            result.errorMessage = "Export cancelled";
+            return result;
+        }
+        if (!transferred) {
+            result.errorMessage = "Failed to transfer assembly to STEP";
+            return result;
+        }
+
+        if (writer.Write(path.c_str()) != IFSelect_RetDone) {
+            result.errorMessage = "Failed to write STEP file";
+            return result;
+        }
+        scope.Next();
+    } catch (const Standard_Failure& e) {
+        result.errorMessage = std::string("OCCT exception: ") + e.GetMessageString();
+        return result;
+    }
+
+    result.success = true;
+    return result;
+}
+
 bool isStepFile(const std::string& path)
 {
     std::string lower = path;
@@ -8,6 +8,7 @@
 // =====================================================================
 
 #include <hobbycad/stl_io.h>
+#include <hobbycad/mesh/types.h>
 
 // OpenCASCADE STL I/O
 #include <StlAPI_Writer.hxx>
@@ -22,19 +23,31 @@
 #include <Poly_Triangulation.hxx>
 #include <OSD_Path.hxx>
 #include <Message_ProgressRange.hxx>
+#include <Message_ProgressScope.hxx>
+#include <IMeshTools_Parameters.hxx>
 
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <utility>
 
 namespace hobbycad {
 namespace stl_io {
 
+namespace {
+
+/// Face triangulations repeat the nodes of shared edges; weld them
+/// within this fraction of the bounding-box diagonal before decimating
+constexpr double kExportWeldTolerance = 1e-9;
+
+}  // namespace
+
 WriteResult writeStl(
     const std::string& path,
     const std::vector<TopoDS_Shape>& shapes,
     StlFormat format,
-    const MeshQuality& quality)
+    const MeshQuality& quality,
+    const Message_ProgressRange& progress)
 {
     WriteResult result;
 
@@ -67,14 +80,24 @@ WriteResult writeStl(
         return result;
     }
 
+    // Meshing dominates the cost; writing gets the remaining share
+    Message_ProgressScope scope(progress, "Exporting STL", 10);
+
     // Mesh the shape
     try {
-        BRepMesh_IncrementalMesh mesh(
-            shapeToExport,
-            quality.linearDeflection,
-            quality.relative,
-            quality.angularDeflection);
+        IMeshTools_Parameters params;
+        params.Deflection = quality.linearDeflection;
+        params.Angle = quality.angularDeflection;
+        params.Relative = quality.relative;
+        params.InParallel = Standard_True;
+
+        BRepMesh_IncrementalMesh mesh(shapeToExport, params, scope.Next(8));
 
+        if (scope.UserBreak()) {
+            result.cancelled = true;
+            result.errorMessage = "Export cancelled";
+            return result;
+        }
         if (!mesh.IsDone()) {
             result.errorMessage = "Failed to mesh shape";
             return result;
@@ -84,6 +107,31 @@ WriteResult writeStl(
         return result;
     }
 
+    // Decimation needs one connected mesh, so weld the faces and write
+    // the result directly instead of face by face
+    if (quality.maxTriangles > 0 || quality.maxError > 0.0) {
+        mesh::TriangleMesh triangles = mesh::fromShape(shapeToExport);
+        mesh::weldVertices(triangles, triangles.diagonal() * kExportWeldTolerance);
+
+        if (quality.maxError > 0.0 || triangles.triangleCount() > quality.maxTriangles) {
+            mesh::DecimateOptions options;
+            options.targetTriangles = quality.maxTriangles;
+            options.maxError = quality.maxError;
+            mesh::DecimateResult reduced = mesh::decimate(triangles, options);
+            if (!reduced.success) {
+                result.errorMessage = "Mesh decimation failed: " + reduced.errorMessage;
+                return result;
+            }
+            triangles = std::move(reduced.mesh);
+        }
+        if (scope.UserBreak()) {
+            result.cancelled = true;
+            result.errorMessage = "Export cancelled";
+            return result;
+        }
+        return writeStlMesh(path, mesh::toTriangulation(triangles), format);
+    }
+
     // Count triangles (approximate - count faces)
     for (TopExp_Explorer exp(shapeToExport, TopAbs_FACE); exp.More(); exp.Next()) {
         result.triangleCount++;
@@ -94,8 +142,15 @@ WriteResult writeStl(
     writer.ASCIIMode() = (format == StlFormat::Ascii);
 
     try {
-        if (!writer.Write(shapeToExport, path.c_str())) {
-            result.errorMessage = "Failed to write STL file";
+        if (!writer.Write(shapeToExport, path.c_str(), scope.Next(2))) {
+            if (scope.UserBreak()) {
+                result.cancelled = true;
+                result.errorMessage = "Export cancelled";
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+            } else {
+                result.errorMessage = "Failed to write STL file";
+            }
             return result;
         }
     } catch (...) {
@@ -130,6 +185,36 @@ bool writeStl(
     return result.success;
 }
 
+WriteResult writeStlMesh(
+    const std::string& path,
+    const Handle(Poly_Triangulation)& mesh,
+    StlFormat format)
+{
+    WriteResult result;
+
+    if (mesh.IsNull() || mesh->NbTriangles() == 0) {
+        result.errorMessage = "No triangles to write";
+        return result;
+    }
+
+    try {
+        OSD_Path osdPath(path.c_str());
+        bool ok = format == StlFormat::Ascii ? RWStl::WriteAscii(mesh, osdPath)
+                                             : RWStl::WriteBinary(mesh, osdPath);
+        if (!ok) {
+            result.errorMessage = "Failed to write STL file";
+            return result;
+        }
+    } catch (...) {
+        result.errorMessage = "Exception during STL export";
+        return result;
+    }
+
+    result.triangleCount = mesh->NbTriangles();
+    result.success = true;
+    return result;
+}
+
 bool isStlFile(const std::string& path)
 {
     std::string lower = path;
@@ -204,7 +289,7 @@ StlFormat detectStlFormat(const std::string& path)
     return StlFormat::Binary;
 }
 
-ReadResult readStl(const std::string& path)
+ReadResult readStl(const std::string& path, const ReadOptions& options)
 {
     ReadResult result;
 
@@ -232,17 +317,52 @@ ReadResult readStl(const std::string& path)
             return result;
         }
 
+        if (options.repair || options.decimate || options.buildSolid) {
+            mesh::TriangleMesh triangles = mesh::fromTriangulation(mesh);
+            if (options.repair) {
+                mesh::RepairResult repaired = mesh::repair(triangles, options.repairOptions);
+                if (!repaired.success) {
+                    result.errorMessage = "Mesh repair failed: " + repaired.errorMessage;
+                    return result;
+                }
+                triangles = std::move(repaired.mesh);
+                mesh = mesh::toTriangulation(triangles);
+                result.repaired = true;
+                result.repairSummary = repaired.summary;
+            }
+            if (options.decimate) {
+                mesh::DecimateResult reduced = mesh::decimate(triangles, options.decimateOptions);
+                if (!reduced.success) {
+                    result.errorMessage = "Mesh decimation failed: " + reduced.errorMessage;
+                    return result;
+                }
+                triangles = std::move(reduced.mesh);
+                mesh = mesh::toTriangulation(triangles);
+                result.decimatedFrom = reduced.inputTriangles;
+            }
+            if (options.buildSolid) {
+                std::string error;
+                result.shape = mesh::toSolid(triangles, &error);
+                if (result.shape.IsNull()) {
+                    result.errorMessage = "Failed to build solid: " + error;
+                    return result;
+                }
+            }
+        }
+
         result.mesh = mesh;
         result.triangleCount = mesh->NbTriangles();
         result.nodeCount = mesh->NbNodes();
 
         // Build a face from the triangulation
-        TopoDS_Face face;
-        BRep_Builder builder;
-        builder.MakeFace(face);
-        builder.UpdateFace(face, mesh);
+        if (result.shape.IsNull()) {
+            TopoDS_Face face;
+            BRep_Builder builder;
+            builder.MakeFace(face);
+            builder.UpdateFace(face, mesh);
+            result.shape = face;
+        }
 
-        result.shape = face;
         result.success = true;
 
     } catch (const Standard_Failure& e) {
@@ -0,0 +1,706 @@
+// =====================================================================
+//  src/libhobbycad/thumbnail.cpp — Headless thumbnail renderer
+// =====================================================================
+
+#include "hobbycad/thumbnail.h"
+#include "hobbycad/project.h"
+#include "hobbycad/sketch/queries.h"
+
+#include <BRepAdaptor_Curve.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRep_Tool.hxx>
+#include <Bnd_Box.hxx>
+#include <GCPnts_TangentialDeflection.hxx>
+#include <IMeshTools_Parameters.hxx>
+#include <OSD_Parallel.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_Face.hxx>
+#include <gp_Ax1.hxx>
+#include <gp_Dir.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Trsf.hxx>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace hobbycad {
+namespace thumbnail {
+
+namespace {
+
+// =====================================================================
+//  Scene
+// =====================================================================
+
+struct Vec3 {
+    double x = 0.0, y = 0.0, z = 0.0;
+
+    Vec3() = default;
+    Vec3(double x_, double y_, double z_) : x(x_), y(y_), z(z_) {}
+    explicit Vec3(const gp_Pnt& p) : x(p.X()), y(p.Y()), z(p.Z()) {}
+
+    Vec3 operator+(const Vec3& o) const { return {x + o.x, y + o.y, z + o.z}; }
+    Vec3 operator-(const Vec3& o) const { return {x - o.x, y - o.y, z - o.z}; }
+    Vec3 operator*(double s) const { return {x * s, y * s, z * s}; }
+    double dot(const Vec3& o) const { return x * o.x + y * o.y + z * o.z; }
+    Vec3 cross(const Vec3& o) const
+    {
+        return {y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x};
+    }
+    double length() const { return std::sqrt(dot(*this)); }
+    Vec3 normalized() const
+    {
+        double len = length();
+        return len > 0.0 ? *this * (1.0 / len) : Vec3(0, 0, 1);
+    }
+};
+
+/// Triangle with per-vertex normals (smoothed within its face)
+struct Triangle {
+    Vec3 p[3];
+    Vec3 n[3];
+};
+
+struct Segment {
+    Vec3 a, b;
+    Rgba color;
+};
+
+struct Scene {
+    std::vector<Triangle> triangles;
+    std::vector<Segment> segments;
+};
+
+/// Bounding-box diagonal of shapes and sketch points (0 if empty)
+double sceneSize(const std::vector<TopoDS_Shape>& shapes, const std::vector<Vec3>& extraPoints)
+{
+    Bnd_Box box;
+    for (const TopoDS_Shape& shape : shapes) {
+        if (!shape.IsNull()) BRepBndLib::Add(shape, box);
+    }
+    for (const Vec3& p : extraPoints) {
+        box.Add(gp_Pnt(p.x, p.y, p.z));
+    }
+    return box.IsVoid() ? 0.0 : std::sqrt(box.SquareExtent());
+}
+
+/// Mesh a shape and append its triangles and (optionally) edges
+bool addShape(Scene& scene, const TopoDS_Shape& shape, const RenderOptions& options,
+              double deflection, std::string* errorMsg)
+{
+    try {
+        IMeshTools_Parameters params;
+        params.Deflection = deflection;
+        params.Angle = options.angularDeflection;
+        params.InParallel = options.parallel ? Standard_True : Standard_False;
+        BRepMesh_IncrementalMesh mesh(shape, params);
+        if (!mesh.IsDone()) {
+            if (errorMsg) *errorMsg = "Failed to mesh shape";
+            return false;
+        }
+    } catch (...) {
+        if (errorMsg) *errorMsg = "Exception during meshing";
+        return false;
+    }
+
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        const TopoDS_Face& face = TopoDS::Face(exp.Current());
+        TopLoc_Location loc;
+        Handle(Poly_Triangulation) tri = BRep_Tool::Triangulation(face, loc);
+        if (tri.IsNull()) continue;
+
+        const gp_Trsf& trsf = loc.Transformation();
+        const bool transform = !loc.IsIdentity();
+        const bool reversed = face.Orientation() == TopAbs_REVERSED;
+
+        std::vector<Vec3> nodes(tri->NbNodes());
+        for (int i = 1; i <= tri->NbNodes(); ++i) {
+            gp_Pnt p = tri->Node(i);
+            if (transform) p.Transform(trsf);
+            nodes[i - 1] = Vec3(p);
+        }
+
+        // Area-weighted vertex normals give smooth shading on curved
+        // faces and flat shading on planar ones
+        std::vector<Vec3> normals(nodes.size());
+        size_t firstTriangle = scene.triangles.size();
+        for (int i = 1; i <= tri->NbTriangles(); ++i) {
+            int n1, n2, n3;
+            tri->Triangle(i).Get(n1, n2, n3);
+            if (reversed) std::swap(n2, n3);
+
+            Triangle t;
+            t.p[0] = nodes[n1 - 1];
+            t.p[1] = nodes[n2 - 1];
+            t.p[2] = nodes[n3 - 1];
+            Vec3 area = (t.p[1] - t.p[0]).cross(t.p[2] - t.p[0]);
+            normals[n1 - 1] = normals[n1 - 1] + area;
+            normals[n2 - 1] = normals[n2 - 1] + area;
+            normals[n3 - 1] = normals[n3 - 1] + area;
+            scene.triangles.push_back(t);
+        }
+        for (int i = 1; i <= tri->NbTriangles(); ++i) {
+            int n1, n2, n3;
+            tri->Triangle(i).Get(n1, n2, n3);
+            if (reversed) std::swap(n2, n3);
+            Triangle& t = scene.triangles[firstTriangle + i - 1];
+            t.n[0] = normals[n1 - 1].normalized();
+            t.n[1] = normals[n2 - 1].normalized();
+            t.n[2] = normals[n3 - 1].normalized();
+        }
+    }
+
+    if (options.drawEdges) {
+        TopTools_IndexedMapOfShape edges;
+        TopExp::MapShapes(shape, TopAbs_EDGE, edges);
+        for (int i = 1; i <= edges.Extent(); ++i) {
+            const TopoDS_Edge& edge = TopoDS::Edge(edges(i));
+            if (BRep_Tool::Degenerated(edge)) continue;
+            try {
+                BRepAdaptor_Curve curve(edge);
+                GCPnts_TangentialDeflection points(curve, options.angularDeflection, deflection);
+                for (int k = 1; k < points.NbPoints(); ++k) {
+                    scene.segments.push_back({Vec3(points.Value(k)),
+                                              Vec3(points.Value(k + 1)),
+                                              options.edgeColor});
+                }
+            } catch (...) {
+                // Skip edges without usable geometry
+            }
+        }
+    }
+    return true;
+}
+
+/// Maps sketch coordinates to 3D, following the sketch's inline plane
+/// parameters the same way the viewport's sketch wireframes do
+class SketchPlacement {
+public:
+    explicit SketchPlacement(const SketchData& sketch)
+        : m_plane(sketch.plane), m_offset(sketch.planeOffset)
+    {
+        if (m_plane != SketchPlane::Custom) return;
+
+        gp_Dir axisDir(1, 0, 0);
+        if (sketch.rotationAxis == PlaneRotationAxis::Y) axisDir = gp_Dir(0, 1, 0);
+        if (sketch.rotationAxis == PlaneRotationAxis::Z) axisDir = gp_Dir(0, 0, 1);
+        m_rotation.SetRotation(gp_Ax1(gp_Pnt(0, 0, 0), axisDir),
+                               sketch.rotationAngle * M_PI / 180.0);
+        m_normal = gp_Dir(0, 0, 1);
+        m_normal.Transform(m_rotation);
+    }
+
+    Vec3 map(const Point2D& p) const
+    {
+        switch (m_plane) {
+        case SketchPlane::XY: return {p.x, p.y, m_offset};
+        case SketchPlane::XZ: return {p.x, m_offset, p.y};
+        case SketchPlane::YZ: return {m_offset, p.x, p.y};
+        case SketchPlane::Custom:
+        default:
+            break;
+        }
+        gp_Pnt q(p.x, p.y, 0.0);
+        q.Transform(m_rotation);
+        return Vec3(q) + Vec3(m_normal.X(), m_normal.Y(), m_normal.Z()) * m_offset;
+    }
+
+private:
+    SketchPlane m_plane;
+    double m_offset;
+    gp_Trsf m_rotation;
+    gp_Dir m_normal;
+};
+
+/// Sketch curves as 3D polylines (construction geometry is skipped)
+std::vector<std::vector<Vec3>> sketchPolylines(const std::vector<SketchData>& sketches,
+                                               double tolerance)
+{
+    std::vector<std::vector<Vec3>> polylines;
+    for (const SketchData& sketch : sketches) {
+        SketchPlacement placement(sketch);
+        for (const sketch::Entity& entity : sketch.entities) {
+            if (entity.isConstruction) continue;
+            std::vector<Point2D> points = sketch::tessellate(entity, tolerance);
+            if (points.size() < 2) continue;
+
+            std::vector<Vec3> polyline;
+            polyline.reserve(points.size());
+            for (const Point2D& p : points) {
+                polyline.push_back(placement.map(p));
+            }
+            polylines.push_back(std::move(polyline));
+        }
+    }
+    return polylines;
+}
+
+// =====================================================================
+//  Camera
+// =====================================================================
+
+struct Camera {
+    Vec3 right, up, forward;     ///< forward points away from the viewer
+    double scale = 1.0;
+    double offsetX = 0.0;
+    double offsetY = 0.0;
+
+    /// Screen x, y (pixels, y down) and depth (larger = farther)
+    Vec3 project(const Vec3& p) const
+    {
+        return {p.dot(right) * scale + offsetX,
+                offsetY - p.dot(up) * scale,
+                p.dot(forward)};
+    }
+};
+
+Vec3 viewForward(const RenderOptions& options)
+{
+    double azimuth = -45.0;
+    double elevation = 35.264;
+    switch (options.view) {
+    case ViewDirection::Front:  return {0, 1, 0};
+    case ViewDirection::Back:   return {0, -1, 0};
+    case ViewDirection::Left:   return {1, 0, 0};
+    case ViewDirection::Right:  return {-1, 0, 0};
+    case ViewDirection::Top:    return {0, 0, -1};
+    case ViewDirection::Bottom: return {0, 0, 1};
+    case ViewDirection::Custom:
+        azimuth = options.azimuth;
+        elevation = options.elevation;
+        break;
+    case ViewDirection::Isometric:
+    default:
+        break;
+    }
+
+    double az = azimuth * M_PI / 180.0;
+    double el = elevation * M_PI / 180.0;
+    Vec3 eye(std::cos(el) * std::cos(az), std::cos(el) * std::sin(az), std::sin(el));
+    return (eye * -1.0).normalized();
+}
+
+Camera fitCamera(const Scene& scene, const RenderOptions& options, int width, int height)
+{
+    Camera cam;
+    cam.forward = viewForward(options);
+
+    // Z is up, except when looking straight along Z
+    Vec3 upHint(0, 0, 1);
+    if (std::abs(cam.forward.z) > 0.999) {
+        upHint = cam.forward.z < 0 ? Vec3(0, 1, 0) : Vec3(0, -1, 0);
+    }
+    cam.right = cam.forward.cross(upHint).normalized();
+    cam.up = cam.right.cross(cam.forward).normalized();
+
+    double minX = std::numeric_limits<double>::max(), maxX = -minX;
+    double minY = minX, maxY = -minX;
+    auto extend = [&](const Vec3& p) {
+        double x = p.dot(cam.right);
+        double y = p.dot(cam.up);
+        minX = std::min(minX, x); maxX = std::max(maxX, x);
+        minY = std::min(minY, y); maxY = std::max(maxY, y);
+    };
+    for (const Triangle& t : scene.triangles) {
+        for (const Vec3& p : t.p) extend(p);
+    }
+    for (const Segment& s : scene.segments) {
+        extend(s.a);
+        extend(s.b);
+    }
+    if (minX > maxX) return cam;
+
+    double margin = std::clamp(options.margin, 0.0, 0.45);
+    double usableW = width * (1.0 - 2.0 * margin);
+    double usableH = height * (1.0 - 2.0 * margin);
+    double spanX = maxX - minX;
+    double spanY = maxY - minY;
+    if (spanX <= 0.0 && spanY <= 0.0) {
+        cam.scale = 1.0;
+    } else if (spanX <= 0.0) {
+        cam.scale = usableH / spanY;
+    } else if (spanY <= 0.0) {
+        cam.scale = usableW / spanX;
+    } else {
+        cam.scale = std::min(usableW / spanX, usableH / spanY);
+    }
+    cam.offsetX = width * 0.5 - (minX + maxX) * 0.5 * cam.scale;
+    cam.offsetY = height * 0.5 + (minY + maxY) * 0.5 * cam.scale;
+    return cam;
+}
+
+// =====================================================================
+//  Rasterizer
+// =====================================================================
+
+struct ScreenTriangle {
+    double x[3], y[3], z[3];
+    Vec3 n[3];
+};
+
+struct ScreenSegment {
+    double x0, y0, z0, x1, y1, z1;
+    Rgba color;
+};
+
+struct Shader {
+    Vec3 key;        ///< Towards the key light
+    Vec3 headlight;  ///< Towards the viewer
+    Rgba color;
+
+    void shade(Vec3 n, uint8_t* out) const
+    {
+        // Two-sided: open shells and sketch-only bodies still shade
+        if (n.dot(headlight) < 0.0) n = n * -1.0;
+        double intensity = 0.3 + 0.5 * std::max(0.0, n.dot(key)) +
+                           0.3 * std::max(0.0, n.dot(headlight));
+        intensity = std::min(intensity, 1.0);
+        out[0] = static_cast<uint8_t>(color.r * intensity + 0.5);
+        out[1] = static_cast<uint8_t>(color.g * intensity + 0.5);
+        out[2] = static_cast<uint8_t>(color.b * intensity + 0.5);
+        out[3] = color.a;
+    }
+};
+
+/// Rasterize one tile: triangles with a z-buffer, then segments
+/// depth-tested against it (with a small bias so edges on a face win)
+void renderTile(ImageBuffer& target, int x0, int y0, int x1, int y1,
+                const std::vector<ScreenTriangle>& triangles, const std::vector<int>& triangleBin,
+                const std::vector<ScreenSegment>& segments, const std::vector<int>& segmentBin,
+                const Shader& shader, double depthBias, double halfWidth)
+{
+    const int tileW = x1 - x0;
+    std::vector<double> depth(static_cast<size_t>(tileW) * (y1 - y0),
+                              std::numeric_limits<double>::infinity());
+
+    for (int index : triangleBin) {
+        const ScreenTriangle& t = triangles[index];
+        double area = (t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) - (t.x[2] - t.x[0]) * (t.y[1] - t.y[0]);
+        if (std::abs(area) < 1e-12) continue;
+        double sign = area > 0.0 ? 1.0 : -1.0;
+        double invArea = 1.0 / area;
+
+        int bx0 = std::max(x0, static_cast<int>(std::floor(std::min({t.x[0], t.x[1], t.x[2]}))));
+        int bx1 = std::min(x1 - 1, static_cast<int>(std::ceil(std::max({t.x[0], t.x[1], t.x[2]}))));
+        int by0 = std::max(y0, static_cast<int>(std::floor(std::min({t.y[0], t.y[1], t.y[2]}))));
+        int by1 = std::min(y1 - 1, static_cast<int>(std::ceil(std::max({t.y[0], t.y[1], t.y[2]}))));
+
+        for (int py = by0; py <= by1; ++py) {
+            double sy = py + 0.5;
+            for (int px = bx0; px <= bx1; ++px) {
+                double sx = px + 0.5;
+                double w0 = (t.x[2] - t.x[1]) * (sy - t.y[1]) - (t.y[2] - t.y[1]) * (sx - t.x[1]);
+                double w1 = (t.x[0] - t.x[2]) * (sy - t.y[2]) - (t.y[0] - t.y[2]) * (sx - t.x[2]);
+                double w2 = (t.x[1] - t.x[0]) * (sy - t.y[0]) - (t.y[1] - t.y[0]) * (sx - t.x[0]);
+                if (w0 * sign < 0.0 || w1 * sign < 0.0 || w2 * sign < 0.0) continue;
+
+                w0 *= invArea;
+                w1 *= invArea;
+                w2 *= invArea;
+                double z = w0 * t.z[0] + w1 * t.z[1] + w2 * t.z[2];
+                double& zbuf = depth[static_cast<size_t>(py - y0) * tileW + (px - x0)];
+                if (z >= zbuf) continue;
+                zbuf = z;
+
+                Vec3 n = (t.n[0] * w0 + t.n[1] * w1 + t.n[2] * w2).normalized();
+                shader.shade(n, &target.pixels[static_cast<size_t>(target.offset(px, py))]);
+            }
+        }
+    }
+
+    for (int index : segmentBin) {
+        const ScreenSegment& s = segments[index];
+        double length = std::hypot(s.x1 - s.x0, s.y1 - s.y0);
+        int steps = static_cast<int>(std::ceil(length * 2.0)) + 1;
+        for (int i = 0; i <= steps; ++i) {
+            double f = static_cast<double>(i) / steps;
+            double sx = s.x0 + (s.x1 - s.x0) * f;
+            double sy = s.y0 + (s.y1 - s.y0) * f;
+            double z = s.z0 + (s.z1 - s.z0) * f;
+
+            int px0 = std::max(x0, static_cast<int>(std::floor(sx - halfWidth)));
+            int px1 = std::min(x1 - 1, static_cast<int>(std::floor(sx + halfWidth - 1e-9)));
+            int py0 = std::max(y0, static_cast<int>(std::floor(sy - halfWidth)));
+            int py1 = std::min(y1 - 1, static_cast<int>(std::floor(sy + halfWidth - 1e-9)));
+            for (int py = py0; py <= py1; ++py) {
+                for (int px = px0; px <= px1; ++px) {
+                    double zbuf = depth[static_cast<size_t>(py - y0) * tileW + (px - x0)];
+                    if (z > zbuf + depthBias) continue;
+                    target.setPixel(px, py, s.color.r, s.color.g, s.color.b, s.color.a);
+                }
+            }
+        }
+    }
+}
+
+/// Box-filter a supersampled image down (premultiplied, so transparent
+/// background samples don't tint edges)
+ImageBuffer downsample(const ImageBuffer& hi, int factor)
+{
+    if (factor == 1) return hi;
+
+    ImageBuffer out = ImageBuffer::create(hi.width / factor, hi.height / factor);
+    const int samples = factor * factor;
+    for (int y = 0; y < out.height; ++y) {
+        for (int x = 0; x < out.width; ++x) {
+            int r = 0, g = 0, b = 0, a = 0;
+            for (int sy = 0; sy < factor; ++sy) {
+                for (int sx = 0; sx < factor; ++sx) {
+                    int hx = x * factor + sx;
+                    int hy = y * factor + sy;
+                    int alpha = hi.alpha(hx, hy);
+                    r += hi.red(hx, hy) * alpha;
+                    g += hi.green(hx, hy) * alpha;
+                    b += hi.blue(hx, hy) * alpha;
+                    a += alpha;
+                }
+            }
+            if (a == 0) {
+                // Fully transparent: keep the (uniform) background colour
+                out.setPixel(x, y, hi.red(x * factor, y * factor), hi.green(x * factor, y * factor),
+                             hi.blue(x * factor, y * factor), 0);
+            } else {
+                out.setPixel(x, y,
+                             static_cast<uint8_t>((r + a / 2) / a),
+                             static_cast<uint8_t>((g + a / 2) / a),
+                             static_cast<uint8_t>((b + a / 2) / a),
+                             static_cast<uint8_t>((a + samples / 2) / samples));
+            }
+        }
+    }
+    return out;
+}
+
+ImageBuffer rasterize(const Scene& scene, const RenderOptions& options)
+{
+    const int factor = std::clamp(options.supersample, 1, 4);
+    const int width = options.width * factor;
+    const int height = options.height * factor;
+    const int tile = std::max(8, options.tileSize);
+
+    ImageBuffer image = ImageBuffer::create(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            image.setPixel(x, y, options.background.r, options.background.g,
+                           options.background.b, options.background.a);
+        }
+    }
+
+    Camera cam = fitCamera(scene, options, width, height);
+
+    // Project everything once
+    std::vector<ScreenTriangle> triangles(scene.triangles.size());
+    double minDepth = std::numeric_limits<double>::max();
+    double maxDepth = -minDepth;
+    for (size_t i = 0; i < scene.triangles.size(); ++i) {
+        for (int k = 0; k < 3; ++k) {
+            Vec3 s = cam.project(scene.triangles[i].p[k]);
+            triangles[i].x[k] = s.x;
+            triangles[i].y[k] = s.y;
+            triangles[i].z[k] = s.z;
+            triangles[i].n[k] = scene.triangles[i].n[k];
+            minDepth = std::min(minDepth, s.z);
+            maxDepth = std::max(maxDepth, s.z);
+        }
+    }
+    std::vector<ScreenSegment> segments(scene.segments.size());
+    for (size_t i = 0; i < scene.segments.size(); ++i) {
+        Vec3 a = cam.project(scene.segments[i].a);
+        Vec3 b = cam.project(scene.segments[i].b);
+        segments[i] = {a.x, a.y, a.z, b.x, b.y, b.z, scene.segments[i].color};
+        minDepth = std::min({minDepth, a.z, b.z});
+        maxDepth = std::max({maxDepth, a.z, b.z});
+    }
+    double depthBias = maxDepth > minDepth ? (maxDepth - minDepth) * 2e-3 : 1e-9;
+    double halfWidth = std::max(0.5, options.lineWidth * factor * 0.5);
+
+    // Bin primitives into tiles by screen bounding box
+    const int tilesX = (width + tile - 1) / tile;
+    const int tilesY = (height + tile - 1) / tile;
+    std::vector<std::vector<int>> triangleBins(static_cast<size_t>(tilesX) * tilesY);
+    std::vector<std::vector<int>> segmentBins(triangleBins.size());
+
+    auto binBox = [&](double minX, double minY, double maxX, double maxY,
+                      std::vector<std::vector<int>>& bins, int index) {
+        int tx0 = std::max(0, static_cast<int>(std::floor(minX)) / tile);
+        int tx1 = std::min(tilesX - 1, static_cast<int>(std::ceil(maxX)) / tile);
+        int ty0 = std::max(0, static_cast<int>(std::floor(minY)) / tile);
+        int ty1 = std::min(tilesY - 1, static_cast<int>(std::ceil(maxY)) / tile);
+        if (maxX < 0 || maxY < 0) return;
+        for (int ty = ty0; ty <= ty1; ++ty) {
+            for (int tx = tx0; tx <= tx1; ++tx) {
+                bins[static_cast<size_t>(ty) * tilesX + tx].push_back(index);
+            }
+        }
+    };
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        const ScreenTriangle& t = triangles[i];
+        binBox(std::min({t.x[0], t.x[1], t.x[2]}), std::min({t.y[0], t.y[1], t.y[2]}),
+               std::max({t.x[0], t.x[1], t.x[2]}), std::max({t.y[0], t.y[1], t.y[2]}),
+               triangleBins, static_cast<int>(i));
+    }
+    for (size_t i = 0; i < segments.size(); ++i) {
+        const ScreenSegment& s = segments[i];
+        binBox(std::min(s.x0, s.x1) - halfWidth, std::min(s.y0, s.y1) - halfWidth,
+               std::max(s.x0, s.x1) + halfWidth, std::max(s.y0, s.y1) + halfWidth,
+               segmentBins, static_cast<int>(i));
+    }
+
+    Shader shader;
+    shader.headlight = cam.forward * -1.0;
+    shader.key = (cam.forward * -1.0 + cam.up * 0.6 - cam.right * 0.4).normalized();
+    shader.color = options.bodyColor;
+
+    // Tiles cover disjoint pixels, so they can be shaded concurrently
+    OSD_Parallel::For(0, tilesX * tilesY, [&](int index) {
+        int tx = index % tilesX;
+        int ty = index / tilesX;
+        renderTile(image, tx * tile, ty * tile,
+                   std::min(width, (tx + 1) * tile), std::min(height, (ty + 1) * tile),
+                   triangles, triangleBins[index], segments, segmentBins[index],
+                   shader, depthBias, halfWidth);
+    }, !options.parallel);
+
+    return downsample(image, factor);
+}
+
+/// Build the scene for shapes and sketches, then rasterize it
+RenderResult render(const std::vector<TopoDS_Shape>& shapes,
+                    const std::vector<SketchData>* sketches,
+                    const RenderOptions& options)
+{
+    auto start = std::chrono::steady_clock::now();
+    RenderResult result;
+
+    if (options.width <= 0 || options.height <= 0 ||
+        options.width > 16384 || options.height > 16384) {
+        result.errorMessage = "Invalid image size";
+        return result;
+    }
+
+    // Sketch geometry is tessellated twice: coarsely for the scene
+    // bounds, then at the final tolerance
+    std::vector<Vec3> sketchPoints;
+    if (sketches) {
+        for (const auto& polyline : sketchPolylines(*sketches, 1.0)) {
+            sketchPoints.insert(sketchPoints.end(), polyline.begin(), polyline.end());
+        }
+    }
+
+    double size = sceneSize(shapes, sketchPoints);
+    double deflection = options.linearDeflection;
+    if (deflection <= 0.0) {
+        // About half a pixel at the fitted scale
+        int pixels = std::max(1, std::min(options.width, options.height));
+        deflection = size > 0.0 ? 0.5 * size / pixels : 0.1;
+    }
+
+    Scene scene;
+    for (const TopoDS_Shape& shape : shapes) {
+        if (shape.IsNull()) continue;
+        if (!addShape(scene, shape, options, deflection, &result.errorMessage)) {
+            return result;
+        }
+    }
+    if (sketches) {
+        for (const auto& polyline : sketchPolylines(*sketches, deflection)) {
+            for (size_t i = 0; i + 1 < polyline.size(); ++i) {
+                scene.segments.push_back({polyline[i], polyline[i + 1], options.sketchColor});
+            }
+        }
+    }
+
+    result.image = rasterize(scene, options);
+    result.triangleCount = static_cast<int>(scene.triangles.size());
+    result.segmentCount = static_cast<int>(scene.segments.size());
+    result.success = true;
+    result.milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+}  // namespace
+
+// =====================================================================
+//  Public API
+// =====================================================================
+
+RenderResult renderShapes(const std::vector<TopoDS_Shape>& shapes, const RenderOptions& options)
+{
+    return render(shapes, nullptr, options);
+}
+
+RenderResult renderProject(const Project& project, const RenderOptions& options)
+{
+    return render(project.shapes(), options.drawSketches ? &project.sketches() : nullptr, options);
+}
+
+ImageDifference compareImages(const ImageBuffer& a, const ImageBuffer& b, int channelTolerance)
+{
+    ImageDifference diff;
+    diff.sameSize = a.width == b.width && a.height == b.height &&
+                    a.pixels.size() == b.pixels.size();
+    if (!diff.sameSize) return diff;
+
+    long long total = 0;
+    for (int i = 0; i < a.pixelCount(); ++i) {
+        bool differs = false;
+        for (int c = 0; c < 4; ++c) {
+            int d = std::abs(int(a.pixels[i * 4 + c]) - int(b.pixels[i * 4 + c]));
+            total += d;
+            diff.maxChannelError = std::max(diff.maxChannelError, d);
+            if (d > channelTolerance) differs = true;
+        }
+        if (differs) ++diff.differingPixels;
+    }
+    if (a.pixelCount() > 0) {
+        diff.meanChannelError = static_cast<double>(total) / (a.pixelCount() * 4.0);
+    }
+    return diff;
+}
+
+std::string viewDirectionName(ViewDirection view)
+{
+    switch (view) {
+    case ViewDirection::Isometric: return "iso";
+    case ViewDirection::Front:     return "front";
+    case ViewDirection::Back:      return "back";
+    case ViewDirection::Left:      return "left";
+    case ViewDirection::Right:     return "right";
+    case ViewDirection::Top:       return "top";
+    case ViewDirection::Bottom:    return "bottom";
+    case ViewDirection::Custom:    return "custom";
+    }
+    return "iso";
+}
+
+bool viewDirectionFromName(const std::string& name, ViewDirection* view)
+{
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (lower == "isometric") lower = "iso";
+
+    for (ViewDirection v : {ViewDirection::Isometric, ViewDirection::Front, ViewDirection::Back,
+                            ViewDirection::Left, ViewDirection::Right, ViewDirection::Top,
+                            ViewDirection::Bottom, ViewDirection::Custom}) {
+        if (viewDirectionName(v) == lower) {
+            if (view) *view = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace thumbnail
+}  // namespace hobbycad
@@ -0,0 +1,166 @@
+// =====================================================================
+//  tests/bench_drag_session.cpp — Headless drag replay
+// =====================================================================
+//
+//  Replays a mouse path over a constrained linkage without the GUI and
+//  reports per-step solve latency, as the sketch canvas would see it
+//  during a handle drag.  Each frame is solved twice: by a DragSession
+//  (built once, warm-started, capped iterations; timed with
+//  lastStep()) and by a full Solver::solve() from scratch, which is
+//  what every mouse move cost before drag sessions existed.
+//
+//  Usage:  bench_drag_session [links] [frames] [path-file]
+//
+//  The optional path file holds one "x y" target per line (e.g. mouse
+//  positions logged from a real session); otherwise the free end of
+//  the linkage is dragged around a circle.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/sketch/drag_session.h>
+#include <hobbycad/sketch/solver.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace hobbycad;
+using namespace hobbycad::sketch;
+
+namespace {
+
+constexpr double kLinkLength = 10.0;
+
+/// Chain of equal-length links pinned at the origin, laid out along X
+void makeLinkage(int links, std::vector<Entity>& entities, std::vector<Constraint>& constraints)
+{
+    int nextConstraint = 1;
+    auto add = [&](ConstraintType type, std::vector<int> ids, std::vector<int> points, double value) {
+        Constraint c;
+        c.id = nextConstraint++;
+        c.type = type;
+        c.entityIds = std::move(ids);
+        c.pointIndices = std::move(points);
+        c.value = value;
+        constraints.push_back(c);
+    };
+
+    for (int i = 0; i < links; ++i) {
+        const int id = i + 1;
+        entities.push_back(createLine(id, {i * kLinkLength, 0.0}, {(i + 1) * kLinkLength, 0.0}));
+        add(ConstraintType::Distance, {id, id}, {0, 1}, kLinkLength);
+        if (i > 0) add(ConstraintType::Coincident, {id - 1, id}, {1, 0}, 0.0);
+    }
+    add(ConstraintType::FixedPoint, {1}, {0}, 0.0);
+}
+
+/// Circle through the current free end, inside the linkage's reach
+std::vector<Point2D> circlePath(int links, int frames)
+{
+    const double reach = links * kLinkLength;
+    const Point2D center{reach * 0.6, 0.0};
+    const double radius = reach * 0.4;
+    std::vector<Point2D> path;
+    path.reserve(frames);
+    for (int i = 0; i < frames; ++i) {
+        const double a = 2.0 * M_PI * i / frames;
+        path.push_back({center.x + radius * std::cos(a), center.y + radius * std::sin(a)});
+    }
+    return path;
+}
+
+std::vector<Point2D> readPath(const char* file)
+{
+    std::vector<Point2D> path;
+    std::ifstream in(file);
+    double x = 0.0, y = 0.0;
+    while (in >> x >> y) path.push_back({x, y});
+    return path;
+}
+
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    const size_t i = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    return values[i];
+}
+
+void report(const char* label, const std::vector<double>& ms)
+{
+    double total = 0.0;
+    for (double v : ms) total += v;
+    std::printf("  %-16s mean %8.3f  p50 %8.3f  p95 %8.3f  p99 %8.3f  max %8.3f ms\n",
+                label, total / ms.size(), percentile(ms, 0.50), percentile(ms, 0.95),
+                percentile(ms, 0.99), percentile(ms, 1.0));
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const int links = argc > 1 ? std::max(1, std::atoi(argv[1])) : 50;
+    const int frames = argc > 2 ? std::max(1, std::atoi(argv[2])) : 600;
+    const std::vector<Point2D> path = argc > 3 ? readPath(argv[3]) : circlePath(links, frames);
+    if (path.empty()) {
+        std::fprintf(stderr, "No targets in %s\n", argv[3]);
+        return 1;
+    }
+
+    std::vector<Entity> entities;
+    std::vector<Constraint> constraints;
+    makeLinkage(links, entities, constraints);
+    const DraggedPoint handle{links, 1};
+
+    // ---- Drag session: what the canvas does per mouse move ----
+
+    std::vector<Entity> dragEntities = entities;
+    DragSession drag;
+    drag.begin(dragEntities, constraints, {handle});
+
+    std::vector<double> dragMs;
+    dragMs.reserve(path.size());
+    int iterations = 0;
+    int converged = 0;
+    for (const Point2D& target : path) {
+        drag.step({target});
+        drag.applyTo(dragEntities);
+        const DragStepInfo& info = drag.lastStep();
+        dragMs.push_back(info.milliseconds);
+        iterations += info.iterations;
+        converged += info.converged ? 1 : 0;
+    }
+    drag.end();
+
+    // ---- Full solve per frame, for comparison ----
+
+    using Clock = std::chrono::steady_clock;
+    std::vector<Entity> fullEntities = entities;
+    Solver solver(SolverBackend::Native);
+    std::vector<double> fullMs;
+    fullMs.reserve(path.size());
+    for (const Point2D& target : path) {
+        fullEntities[handle.entityId - 1].points[handle.pointIndex] = target;
+        const auto start = Clock::now();
+        solver.solve(fullEntities, constraints);
+        fullMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+
+    std::printf("%d links, %zu constraints, %zu frames\n",
+                links, constraints.size(), path.size());
+    report("drag session", dragMs);
+    report("full solve", fullMs);
+    std::printf("  drag session: %.2f iterations/step, %d of %zu steps converged\n",
+                static_cast<double>(iterations) / path.size(), converged, path.size());
+    return 0;
+}
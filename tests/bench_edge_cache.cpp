@@ -0,0 +1,155 @@
+// =====================================================================
+//  tests/bench_edge_cache.cpp — Edge cache speedup
+// =====================================================================
+//
+//  Lays out rows of two-cell panels (seven lines each, the middle one
+//  shared by both cells) and times building every cell face three
+//  ways: each region converted on its own, as every profile was before
+//  the edge cache existed; all regions through one fresh
+//  SketchEdgeCache; and through a warm cache after moving one corner,
+//  which is what a feature recompute after a sketch edit costs.  Also
+//  reports the distinct edges in each result, to show the sharing.
+//
+//  Usage:  bench_edge_cache [panels] [repeats]
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/brep/edge_cache.h>
+#include <hobbycad/brep/operations.h>
+#include <hobbycad/sketch/profiles.h>
+
+#include <BRep_Builder.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS_Compound.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::sketch;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Panels of two 10x10 cells on a grid with gaps, with one region per
+/// cell (the profiles detectProfiles would report for them)
+void makePanels(int panels, std::vector<Entity>& entities, std::vector<ProfileRegion>& regions)
+{
+    const int perRow = 20;
+    int id = 1;
+    for (int p = 0; p < panels; ++p) {
+        const double x = (p % perRow) * 30.0;
+        const double y = (p / perRow) * 20.0;
+        const int first = id;
+        entities.push_back(createLine(id++, {x, y}, {x + 10, y}));
+        entities.push_back(createLine(id++, {x + 10, y}, {x + 20, y}));
+        entities.push_back(createLine(id++, {x + 20, y}, {x + 20, y + 10}));
+        entities.push_back(createLine(id++, {x + 20, y + 10}, {x + 10, y + 10}));
+        entities.push_back(createLine(id++, {x + 10, y + 10}, {x, y + 10}));
+        entities.push_back(createLine(id++, {x, y + 10}, {x, y}));
+        entities.push_back(createLine(id++, {x + 10, y}, {x + 10, y + 10}));
+
+        ProfileRegion left;
+        left.outer.id = static_cast<int>(regions.size()) + 1;
+        left.outer.entityIds = {first, first + 6, first + 4, first + 5};
+        left.outer.reversed = {false, false, false, false};
+        regions.push_back(left);
+
+        ProfileRegion right;
+        right.outer.id = static_cast<int>(regions.size()) + 1;
+        right.outer.entityIds = {first + 1, first + 2, first + 3, first + 6};
+        right.outer.reversed = {false, false, false, true};
+        regions.push_back(right);
+    }
+}
+
+int countEdges(const TopoDS_Shape& shape)
+{
+    TopTools_IndexedMapOfShape map;
+    TopExp::MapShapes(shape, TopAbs_EDGE, map);
+    return map.Extent();
+}
+
+template <typename Build>
+double timeBest(int repeats, Build build, int& edges)
+{
+    double best = 0.0;
+    for (int r = 0; r < repeats; ++r) {
+        const auto start = Clock::now();
+        const brep::OperationResult result = build();
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (!result.success) {
+            std::fprintf(stderr, "build failed: %s\n", result.errorMessage.c_str());
+            std::exit(1);
+        }
+        edges = countEdges(result.shape);
+        best = r == 0 ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const int panels = argc > 1 ? std::max(1, std::atoi(argv[1])) : 500;
+    const int repeats = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+
+    std::vector<Entity> entities;
+    std::vector<ProfileRegion> regions;
+    makePanels(panels, entities, regions);
+
+    int edges = 0;
+
+    const double uncachedMs = timeBest(repeats, [&] {
+        brep::OperationResult all;
+        BRep_Builder builder;
+        TopoDS_Compound compound;
+        builder.MakeCompound(compound);
+        for (const ProfileRegion& region : regions) {
+            const brep::OperationResult face = brep::buildRegionFaces({region}, entities);
+            if (!face.success) return face;
+            builder.Add(compound, face.shape);
+        }
+        all.success = true;
+        all.shape = compound;
+        return all;
+    }, edges);
+    const int uncachedEdges = edges;
+
+    const double coldMs = timeBest(repeats, [&] {
+        brep::SketchEdgeCache cache(entities);
+        return brep::buildRegionFaces(regions, cache);
+    }, edges);
+    const int cachedEdges = edges;
+
+    // Warm cache: move one corner back and forth between builds, which
+    // changes the two lines meeting there
+    brep::SketchEdgeCache cache(entities);
+    brep::buildRegionFaces(regions, cache);
+    std::vector<Entity> edited = entities;
+    bool moved = false;
+    const double warmMs = timeBest(repeats, [&] {
+        moved = !moved;
+        const Point2D corner{moved ? 20.5 : 20.0, 10.0};
+        edited[2] = createLine(3, {20, 0}, corner);
+        edited[3] = createLine(4, corner, {10, 10});
+        cache.update(edited);
+        return brep::buildRegionFaces(regions, cache);
+    }, edges);
+
+    std::printf("%d panels, %zu entities, %zu faces\n", panels, entities.size(), regions.size());
+    std::printf("  %-22s %9.2f ms  %6d edges\n", "each region alone", uncachedMs, uncachedEdges);
+    std::printf("  %-22s %9.2f ms  %6d edges  %5.2fx\n", "cold edge cache", coldMs, cachedEdges,
+                uncachedMs / coldMs);
+    std::printf("  %-22s %9.2f ms  %6s        %5.2fx\n", "warm cache, 1 corner", warmMs, "",
+                uncachedMs / warmMs);
+    return 0;
+}
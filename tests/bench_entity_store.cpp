@@ -0,0 +1,119 @@
+// =====================================================================
+//  tests/bench_entity_store.cpp — Snap query cost by entity container
+// =====================================================================
+//
+//  Times one findBestSnap query over a generated sketch three ways:
+//  copying the entities into a std::vector<Entity> first (what the
+//  canvas did before EntityStore), refilling an EntityStore first,
+//  and querying a store that is already up to date (what the canvas
+//  does between edits).  Also reports the memory held by each form.
+//
+//  Usage:  bench_entity_store [entities] [queries]
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/sketch/entity_store.h>
+#include <hobbycad/sketch/snap.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::sketch;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// A grid of mixed entities, roughly what a busy sketch looks like
+std::vector<Entity> makeSketch(int count)
+{
+    std::vector<Entity> entities;
+    entities.reserve(count);
+    const int side = static_cast<int>(std::ceil(std::sqrt(count)));
+    for (int i = 0; i < count; ++i) {
+        const double x = (i % side) * 20.0;
+        const double y = (i / side) * 20.0;
+        switch (i % 5) {
+        case 0: entities.push_back(createLine(i + 1, {x, y}, {x + 15, y + 5})); break;
+        case 1: entities.push_back(createCircle(i + 1, {x + 8, y + 8}, 6)); break;
+        case 2: entities.push_back(createArc(i + 1, {x + 8, y + 8}, 7, 20, 140)); break;
+        case 3: entities.push_back(createRectangle(i + 1, {x, y}, {x + 12, y + 9})); break;
+        default:
+            entities.push_back(createSpline(i + 1, {{x, y}, {x + 5, y + 9}, {x + 12, y + 2}, {x + 16, y + 8}}));
+            break;
+        }
+    }
+    return entities;
+}
+
+/// Nanoseconds per call of fn, over n calls
+template <typename Fn>
+double timePerCall(int n, Fn&& fn)
+{
+    const auto start = Clock::now();
+    for (int i = 0; i < n; ++i) fn(i);
+    const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start);
+    return elapsed.count() / n;
+}
+
+/// Vary the cursor so results are not trivially identical
+Point2D cursor(int i, int count)
+{
+    const double extent = std::sqrt(static_cast<double>(count)) * 20.0;
+    return {std::fmod(i * 7.31, extent), std::fmod(i * 3.17, extent)};
+}
+
+size_t vectorBytes(const std::vector<Entity>& entities)
+{
+    size_t bytes = entities.capacity() * sizeof(Entity);
+    for (const Entity& e : entities) {
+        bytes += e.points.capacity() * sizeof(Point2D);
+    }
+    return bytes;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const int count = argc > 1 ? std::atoi(argv[1]) : 500;
+    const int queries = argc > 2 ? std::atoi(argv[2]) : 200;
+    const std::vector<Entity> source = makeSketch(count);
+
+    int found = 0;  // Keeps the queries from being optimized away
+
+    std::vector<Entity> copy;
+    const double vectorNs = timePerCall(queries, [&](int i) {
+        copy.assign(source.begin(), source.end());
+        found += findBestSnap(copy, cursor(i, count), 2.0).found;
+    });
+
+    EntityStore store;
+    const double refillNs = timePerCall(queries, [&](int i) {
+        store.assign(source.begin(), source.end());
+        found += findBestSnap(store, cursor(i, count), 2.0).found;
+    });
+
+    const double cachedNs = timePerCall(queries, [&](int i) {
+        found += findBestSnap(store, cursor(i, count), 2.0).found;
+    });
+
+    const double assignNs = timePerCall(queries, [&](int) {
+        store.assign(source.begin(), source.end());
+    });
+
+    std::printf("%d entities, %d queries (%d snapped)\n", count, queries, found);
+    std::printf("  vector copy + snap   %10.1f us/query\n", vectorNs / 1000.0);
+    std::printf("  store refill + snap  %10.1f us/query\n", refillNs / 1000.0);
+    std::printf("  up-to-date store     %10.1f us/query\n", cachedNs / 1000.0);
+    std::printf("  store refill alone   %10.1f us\n", assignNs / 1000.0);
+    std::printf("  memory: vector %zu bytes, store %zu bytes\n",
+                vectorBytes(copy), store.memoryUsage());
+    return 0;
+}
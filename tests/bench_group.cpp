@@ -0,0 +1,120 @@
+// =====================================================================
+//  tests/bench_group.cpp — Group hierarchy queries at import scale
+// =====================================================================
+//
+//  Builds the two group shapes a DXF block import produces: a deep
+//  chain of nested blocks and a wide tree with a fixed fan-out, each
+//  holding a few entities per group.  Times building the hierarchy,
+//  then the queries the sketch tree and selection run: transitive
+//  entity sets (cold and cached), entity owners, ancestry, depth,
+//  common ancestors and cycle checks, plus one edit followed by the
+//  re-query it invalidates.
+//
+//  Usage:  bench_group [groups] [fanout] [queries]
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/sketch/group.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::sketch;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kEntitiesPerGroup = 4;
+
+/// Nanoseconds per call of fn, over n calls
+template <typename Fn>
+double timePerCall(int n, Fn&& fn)
+{
+    const auto start = Clock::now();
+    for (int i = 0; i < n; ++i) fn(i);
+    const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start);
+    return elapsed.count() / n;
+}
+
+double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/// groups groups, each under the one fanout places before it (fanout 1
+/// is a single chain), nested in import order: parents first
+std::vector<int> build(GroupManager& m, int groups, int fanout)
+{
+    std::vector<int> ids;
+    ids.reserve(groups);
+    int entity = 1;
+    for (int i = 0; i < groups; ++i) {
+        ids.push_back(m.createGroup());
+        for (int k = 0; k < kEntitiesPerGroup; ++k) m.addEntityToGroup(entity++, ids[i]);
+        if (i > 0) m.addGroupToGroup(ids[i], ids[(i - 1) / fanout]);
+    }
+    return ids;
+}
+
+void run(const char* label, int groups, int fanout, int queries)
+{
+    GroupManager m;
+    auto start = Clock::now();
+    const std::vector<int> ids = build(m, groups, fanout);
+    const double buildMs = millisecondsSince(start);
+
+    volatile size_t sink = 0;   // Keeps the work from being optimized away
+    const int root = ids[0];
+    const int leaf = ids.back();
+    auto any = [&](int i) { return ids[(static_cast<size_t>(i) * 7919) % ids.size()]; };
+
+    start = Clock::now();
+    sink += m.entityClosure(root).size();
+    const double coldMs = millisecondsSince(start);
+    const double warmNs = timePerCall(queries, [&](int) { sink += m.entityClosure(root).size(); });
+
+    const double ownersNs = timePerCall(queries, [&](int i) {
+        sink += m.groupsContainingEntity(1 + i % (groups * kEntitiesPerGroup)).size();
+    });
+    const double ancestorNs = timePerCall(queries, [&](int i) { sink += m.isAncestorOf(any(i), any(i + 1)); });
+    const double depthNs = timePerCall(queries, [&](int i) { sink += m.groupDepth(any(i)); });
+    const double commonNs = timePerCall(queries, [&](int i) { sink += m.commonAncestor(any(i), any(i + 3)); });
+    const double cycleNs = timePerCall(queries, [&](int i) { sink += m.wouldCreateCycle(any(i), leaf); });
+
+    // An edit at the leaf drops the closures along its ancestor chain
+    start = Clock::now();
+    m.addEntityToGroup(groups * kEntitiesPerGroup + 1, leaf);
+    sink += m.entityClosure(root).size();
+    const double editMs = millisecondsSince(start);
+
+    std::printf("%s: %d groups, fan-out %d, depth %d\n", label, groups, fanout, m.groupDepth(leaf));
+    std::printf("  %-28s %12.2f ms\n", "build", buildMs);
+    std::printf("  %-28s %12.2f ms\n", "root entity set, cold", coldMs);
+    std::printf("  %-28s %12.1f ns\n", "root entity set, cached", warmNs);
+    std::printf("  %-28s %12.1f ns\n", "groupsContainingEntity", ownersNs);
+    std::printf("  %-28s %12.1f ns\n", "isAncestorOf", ancestorNs);
+    std::printf("  %-28s %12.1f ns\n", "groupDepth", depthNs);
+    std::printf("  %-28s %12.1f ns\n", "commonAncestor", commonNs);
+    std::printf("  %-28s %12.1f ns\n", "wouldCreateCycle", cycleNs);
+    std::printf("  %-28s %12.2f ms\n", "leaf edit + root re-query", editMs);
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const int groups = argc > 1 ? std::max(2, std::atoi(argv[1])) : 5000;
+    const int fanout = argc > 2 ? std::max(2, std::atoi(argv[2])) : 8;
+    const int queries = argc > 3 ? std::max(1, std::atoi(argv[3])) : 100000;
+
+    run("deep chain", groups, 1, queries);
+    run("wide tree", groups, fanout, queries);
+    return 0;
+}
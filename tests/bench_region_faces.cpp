@@ -0,0 +1,132 @@
+// =====================================================================
+//  tests/bench_region_faces.cpp — Hole-heavy plate extrusion
+// =====================================================================
+//
+//  A plate drilled with a grid of round holes, as a perforated panel
+//  or a PCB outline with its mounting and via holes.  Times detecting
+//  the regions, building the region face with every hole as an inner
+//  wire, and extruding it in one prism, against extruding the plate
+//  and cutting one extruded hole at a time, which is what each hole
+//  cost before regions.  Both volumes are printed as a cross-check.
+//
+//  Usage:  bench_region_faces [cols] [rows] [cut-holes]
+//
+//  cut-holes caps the holes cut on the boolean path (default 200), as
+//  a thousand sequential cuts take minutes; its time is scaled up to
+//  the full hole count linearly, which flatters it, since each cut
+//  slows down as the body collects holes.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/brep/operations.h>
+#include <hobbycad/sketch/profiles.h>
+
+#include <BRepGProp.hxx>
+#include <GProp_GProps.hxx>
+#include <gp_Dir.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::sketch;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double kPitch = 5.0;
+constexpr double kHoleRadius = 1.5;
+constexpr double kThickness = 2.0;
+
+std::vector<Entity> makePlate(int cols, int rows)
+{
+    std::vector<Entity> entities;
+    int id = 1;
+    entities.push_back(createRectangle(id++, {0, 0}, {cols * kPitch, rows * kPitch}));
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            entities.push_back(createCircle(id++, {(c + 0.5) * kPitch, (r + 0.5) * kPitch}, kHoleRadius));
+        }
+    }
+    return entities;
+}
+
+double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double volumeOf(const TopoDS_Shape& shape)
+{
+    GProp_GProps props;
+    BRepGProp::VolumeProperties(shape, props);
+    return props.Mass();
+}
+
+void fail(const char* what, const brep::OperationResult& result)
+{
+    std::fprintf(stderr, "%s failed: %s\n", what, result.errorMessage.c_str());
+    std::exit(1);
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const int cols = argc > 1 ? std::max(1, std::atoi(argv[1])) : 40;
+    const int rows = argc > 2 ? std::max(1, std::atoi(argv[2])) : 25;
+    const int holes = cols * rows;
+    const int cutHoles = std::min(holes, argc > 3 ? std::max(1, std::atoi(argv[3])) : 200);
+    const std::vector<Entity> entities = makePlate(cols, rows);
+
+    auto start = Clock::now();
+    const std::vector<ProfileRegion> regions = detectProfileRegions(entities);
+    const double detectMs = millisecondsSince(start);
+    if (regions.size() != 1 || static_cast<int>(regions[0].holes.size()) != holes) {
+        std::fprintf(stderr, "expected 1 region with %d holes, found %zu regions\n", holes, regions.size());
+        return 1;
+    }
+
+    start = Clock::now();
+    const brep::OperationResult face = brep::buildRegionFaces(regions, entities);
+    const double faceMs = millisecondsSince(start);
+    if (!face.success) fail("region face", face);
+
+    start = Clock::now();
+    const brep::OperationResult solid = brep::extrudeRegions(regions, entities, gp::DZ(), kThickness);
+    const double extrudeMs = millisecondsSince(start);
+    if (!solid.success) fail("region extrusion", solid);
+
+    // The plate with the first cutHoles holes cut one at a time
+    const ProfileRegion& region = regions[0];
+    start = Clock::now();
+    brep::OperationResult body = brep::extrudeProfile(region.outer, entities, gp::DZ(), kThickness);
+    for (int i = 0; i < cutHoles && body.success; ++i) {
+        const brep::OperationResult tool = brep::extrudeProfile(region.holes[i], entities, gp::DZ(), kThickness);
+        if (!tool.success) fail("hole extrusion", tool);
+        body = brep::cutShape(body.shape, tool.shape);
+    }
+    const double cutMs = millisecondsSince(start);
+    if (!body.success) fail("cut", body);
+    const double cutAllMs = cutMs * holes / cutHoles;
+
+    const double holeVolume = 3.14159265358979323846 * kHoleRadius * kHoleRadius * kThickness;
+    const double regionVolume = volumeOf(solid.shape);
+    // Holes left uncut are taken off in closed form
+    const double cutVolume = volumeOf(body.shape) - (holes - cutHoles) * holeVolume;
+
+    std::printf("%dx%d plate, %d holes, %zu entities\n", cols, rows, holes, entities.size());
+    std::printf("  %-28s %10.2f ms\n", "detect regions", detectMs);
+    std::printf("  %-28s %10.2f ms\n", "region face alone", faceMs);
+    std::printf("  %-28s %10.2f ms  volume %.4f\n", "region extrusion", extrudeMs, regionVolume);
+    std::printf("  %-28s %10.2f ms  (%d holes cut)\n", "prism + sequential cuts", cutMs, cutHoles);
+    std::printf("  %-28s %10.2f ms  volume %.4f  %6.1fx\n", "  scaled to all holes", cutAllMs,
+                cutVolume, cutAllMs / extrudeMs);
+    return 0;
+}
@@ -0,0 +1,147 @@
+// =====================================================================
+//  tests/bench_scratch.cpp — Scratch arena allocations per call
+// =====================================================================
+//
+//  Runs the kernels that keep their temporaries in scratch arenas
+//  with the arenas in use and with them bypassed to the heap
+//  (setScratchBypass), and reports time and heap allocations per call
+//  for both.  Allocations come from memory::heapStats(), so they are
+//  only counted in builds configured with HOBBYCAD_MEMORY_HOOKS;
+//  other builds print times alone.
+//
+//  Usage:  bench_scratch [calls]
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/geometry/algorithms.h>
+#include <hobbycad/geometry/scratch.h>
+#include <hobbycad/memory.h>
+#include <hobbycad/sketch/operations.h>
+#include <hobbycad/sketch/profiles.h>
+#include <hobbycad/sketch/snap.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::geometry;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double kPi = 3.14159265358979323846;
+
+/// A wavy closed outline of n points around center
+std::vector<Point2D> makePolygon(const Point2D& center, double radius, int n)
+{
+    std::vector<Point2D> pts;
+    for (int i = 0; i < n; ++i) {
+        const double a = 2.0 * kPi * i / n;
+        const double r = radius * (1.0 + 0.15 * std::sin(7.0 * a));
+        pts.push_back({center.x + r * std::cos(a), center.y + r * std::sin(a)});
+    }
+    return pts;
+}
+
+/// A grid of mixed overlapping entities
+std::vector<sketch::Entity> makeSketch(int count)
+{
+    std::vector<sketch::Entity> entities;
+    const int side = static_cast<int>(std::ceil(std::sqrt(count)));
+    for (int i = 0; i < count; ++i) {
+        const double x = (i % side) * 12.0;
+        const double y = (i / side) * 12.0;
+        switch (i % 4) {
+        case 0: entities.push_back(sketch::createLine(i + 1, {x, y}, {x + 18, y + 7})); break;
+        case 1: entities.push_back(sketch::createCircle(i + 1, {x + 8, y + 8}, 6)); break;
+        case 2: entities.push_back(sketch::createArc(i + 1, {x + 8, y + 8}, 7, 20, 140)); break;
+        default: entities.push_back(sketch::createRectangle(i + 1, {x, y}, {x + 12, y + 9})); break;
+        }
+    }
+    return entities;
+}
+
+struct Cost {
+    double microseconds = 0.0;
+    double allocations = 0.0;     ///< Heap allocations per call (hooks only)
+};
+
+Cost measure(int calls, bool bypass, const std::function<void()>& fn)
+{
+    setScratchBypass(bypass);
+    fn();  // Warm the thread buffer
+    const memory::HeapStats before = memory::heapStats();
+    const auto start = Clock::now();
+    for (int i = 0; i < calls; ++i) fn();
+    const auto elapsed = std::chrono::duration<double, std::micro>(Clock::now() - start);
+    const memory::HeapStats after = memory::heapStats();
+    setScratchBypass(false);
+
+    Cost cost;
+    cost.microseconds = elapsed.count() / calls;
+    cost.allocations = static_cast<double>(after.allocations - before.allocations) / calls;
+    return cost;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const int calls = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200;
+    const bool hooks = memory::heapStats().enabled;
+
+    const std::vector<Point2D> a = makePolygon({0, 0}, 30.0, 400);
+    const std::vector<Point2D> b = makePolygon({15, 5}, 25.0, 300);
+    const std::vector<Point2D> hole = makePolygon({-5, 0}, 6.0, 40);
+    const std::vector<Point2D> holeCw(hole.rbegin(), hole.rend());
+    const std::vector<sketch::Entity> entities = makeSketch(400);
+
+    volatile std::size_t sink = 0;  // Keeps the work from being optimized away
+
+    struct Kernel {
+        const char* name;
+        std::function<void()> fn;
+    };
+    const std::vector<Kernel> kernels = {
+        {"convexHull", [&] { sink += convexHull(a).size(); }},
+        {"polygonUnion", [&] { sink += polygonUnion(a, b).polygons.size(); }},
+        {"polygonIntersection", [&] { sink += polygonIntersection(a, b).polygons.size(); }},
+        {"polygonDifference", [&] { sink += polygonDifference(a, hole).polygons.size(); }},
+        {"offsetPolygon", [&] { sink += offsetPolygon(a, 1.5).size(); }},
+        {"triangulateWithHoles", [&] { sink += triangulatePolygonWithHoles(a, {holeCw}).second.size(); }},
+        {"smoothPolyline", [&] { sink += smoothPolyline(a, 3).size(); }},
+        {"findAllIntersections", [&] { sink += sketch::findAllIntersections(entities).size(); }},
+        {"collectAllSnapPoints", [&] { sink += sketch::collectAllSnapPoints(entities).size(); }},
+        {"detectProfilesWithHoles", [&] { sink += sketch::detectProfilesWithHoles(entities).size(); }},
+    };
+
+    std::printf("%d calls each%s\n", calls, hooks ? "" : " (allocation counts need HOBBYCAD_MEMORY_HOOKS)");
+    if (hooks) {
+        std::printf("  %-24s %11s %11s %9s %9s\n", "", "heap us", "arena us", "heap new", "arena new");
+    } else {
+        std::printf("  %-24s %11s %11s\n", "", "heap us", "arena us");
+    }
+    for (const Kernel& k : kernels) {
+        const Cost heap = measure(calls, true, k.fn);
+        const Cost arena = measure(calls, false, k.fn);
+        if (hooks) {
+            std::printf("  %-24s %11.1f %11.1f %9.1f %9.1f\n", k.name, heap.microseconds,
+                        arena.microseconds, heap.allocations, arena.allocations);
+        } else {
+            std::printf("  %-24s %11.1f %11.1f\n", k.name, heap.microseconds, arena.microseconds);
+        }
+    }
+
+    const ScratchStats stats = scratchStats();
+    std::printf("  scratch buffer: %zu bytes reserved, peak %zu bytes used\n",
+                stats.reservedBytes, stats.peakUsedBytes);
+    return 0;
+}
@@ -0,0 +1,170 @@
+// =====================================================================
+//  tests/bench_spline.cpp — B-spline kernel throughput
+// =====================================================================
+//
+//  The large-import case: a spline entity through 10k digitized
+//  points, as DXF import produces from a traced outline.  Times
+//  building the curve, point and derivative evaluation, arc length,
+//  closest-point queries and tessellation, with OCCT's
+//  Geom2d_BSplineCurve on the same poles and knots for comparison
+//  where it offers the same operation.
+//
+//  Usage:  bench_spline [points] [queries]
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/geometry/spline.h>
+
+#include <GCPnts_AbscissaPoint.hxx>
+#include <Geom2dAdaptor_Curve.hxx>
+#include <Geom2d_BSplineCurve.hxx>
+#include <TColStd_Array1OfInteger.hxx>
+#include <TColStd_Array1OfReal.hxx>
+#include <TColgp_Array1OfPnt2d.hxx>
+#include <gp_Pnt2d.hxx>
+#include <gp_Vec2d.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::geometry;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// A wobbly spiral sampled like a digitized outline
+std::vector<Point2D> makePoints(int count)
+{
+    std::vector<Point2D> points;
+    points.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const double a = i * 0.01;
+        const double r = 20.0 + 0.02 * i + 0.5 * std::sin(i * 0.37);
+        points.push_back({r * std::cos(a), r * std::sin(a)});
+    }
+    return points;
+}
+
+Handle(Geom2d_BSplineCurve) toOcct(const BSplineCurve2D& curve)
+{
+    std::vector<double> values;
+    std::vector<int> mults;
+    curve.knotMultiplicities(&values, &mults);
+    const int n = static_cast<int>(curve.poles().size());
+    const int k = static_cast<int>(values.size());
+    TColgp_Array1OfPnt2d poles(1, n);
+    TColStd_Array1OfReal knots(1, k);
+    TColStd_Array1OfInteger multiplicities(1, k);
+    for (int i = 0; i < n; ++i) {
+        poles.SetValue(i + 1, gp_Pnt2d(curve.poles()[i].x, curve.poles()[i].y));
+    }
+    for (int i = 0; i < k; ++i) {
+        knots.SetValue(i + 1, values[i]);
+        multiplicities.SetValue(i + 1, mults[i]);
+    }
+    return new Geom2d_BSplineCurve(poles, knots, multiplicities, curve.degree());
+}
+
+/// Nanoseconds per call of fn, over n calls
+template <typename Fn>
+double timePerCall(int n, Fn&& fn)
+{
+    const auto start = Clock::now();
+    for (int i = 0; i < n; ++i) fn(i);
+    const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start);
+    return elapsed.count() / n;
+}
+
+void printRow(const char* what, double oursNs, double occtNs)
+{
+    if (occtNs > 0.0) {
+        std::printf("  %-22s %12.1f us  %12.1f us  %6.2fx\n", what, oursNs / 1000.0,
+                    occtNs / 1000.0, occtNs / oursNs);
+    } else {
+        std::printf("  %-22s %12.1f us\n", what, oursNs / 1000.0);
+    }
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const int count = argc > 1 ? std::max(4, std::atoi(argv[1])) : 10000;
+    const int queries = argc > 2 ? std::max(1, std::atoi(argv[2])) : 100000;
+    const std::vector<Point2D> points = makePoints(count);
+
+    volatile double sink = 0.0;  // Keeps the work from being optimized away
+
+    BSplineCurve2D curve;
+    const double buildNs = timePerCall(10, [&](int) {
+        curve = BSplineCurve2D::fromCatmullRom(points);
+        sink += curve.poles().size();
+    });
+    Handle(Geom2d_BSplineCurve) occt;
+    const double occtBuildNs = timePerCall(10, [&](int) {
+        occt = toOcct(curve);
+        sink += occt->NbPoles();
+    });
+
+    const double first = curve.firstParameter();
+    const double range = curve.lastParameter() - first;
+    auto param = [&](int i) { return first + std::fmod(i * 0.618033988749895, 1.0) * range; };
+
+    const double pointNs = timePerCall(queries, [&](int i) { sink += curve.point(param(i)).x; });
+    const double occtPointNs = timePerCall(queries, [&](int i) { sink += occt->Value(param(i)).X(); });
+
+    const double d2Ns = timePerCall(queries, [&](int i) { sink += curve.derivatives(param(i)).second.x; });
+    const double occtD2Ns = timePerCall(queries, [&](int i) {
+        gp_Pnt2d p;
+        gp_Vec2d d1, d2;
+        occt->D2(param(i), p, d1, d2);
+        sink += d2.X();
+    });
+
+    // Total length from cold (freshly built curves have no length table)
+    std::vector<BSplineCurve2D> fresh(5, BSplineCurve2D(curve.degree(), curve.poles(), curve.knots()));
+    const double lengthNs = timePerCall(5, [&](int i) { sink += fresh[i].length(); });
+    const Geom2dAdaptor_Curve adaptor(occt);
+    const double occtLengthNs = timePerCall(5, [&](int) {
+        sink += GCPnts_AbscissaPoint::Length(adaptor, first, curve.lastParameter(), 1e-7);
+    });
+
+    // With the table built, lengths and their inverse are per-span work
+    const double total = curve.length();
+    const double lengthAtNs = timePerCall(queries / 10, [&](int i) { sink += curve.lengthAt(param(i)); });
+    const double paramAtNs = timePerCall(queries / 10, [&](int i) {
+        sink += curve.parameterAtLength(std::fmod(i * 0.618033988749895, 1.0) * total);
+    });
+
+    const double closestNs = timePerCall(queries / 10, [&](int i) {
+        const Point2D p = curve.point(param(i));
+        sink += curve.distanceTo({p.x + 0.3, p.y - 0.2});
+    });
+
+    size_t tessellated = 0;
+    const double tessellateNs = timePerCall(5, [&](int) {
+        tessellated = curve.tessellate(0.01).size();
+    });
+
+    std::printf("%d points, %d poles, %d spans, length %.1f\n", count,
+                static_cast<int>(curve.poles().size()), curve.spanCount(), total);
+    std::printf("  %-22s %15s  %15s  %7s\n", "", "kernel", "OCCT", "speedup");
+    printRow("build", buildNs, occtBuildNs);
+    printRow("point", pointNs, occtPointNs);
+    printRow("point + 2 derivatives", d2Ns, occtD2Ns);
+    printRow("total length (cold)", lengthNs, occtLengthNs);
+    printRow("length at parameter", lengthAtNs, 0.0);
+    printRow("parameter at length", paramAtNs, 0.0);
+    printRow("closest point", closestNs, 0.0);
+    printRow("tessellate 0.01 mm", tessellateNs, 0.0);
+    std::printf("  tessellation: %zu points; curve memory %zu bytes\n", tessellated, curve.memoryUsage());
+    return 0;
+}
@@ -0,0 +1,235 @@
+// =====================================================================
+//  tests/test_auto_constrain.cpp — Bulk constraint inference
+// =====================================================================
+//
+//  Runs inferConstraints() on generated sketches (grids of rectangles,
+//  rotated polygons, concentric and equal circles, tangent lines and
+//  slots built from lines and arcs), then solves with the inferred set
+//  and checks that no entity moved, that the solver reports neither
+//  redundant nor conflicting equations, and that every inferred
+//  constraint removes at least one degree of freedom.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/sketch/auto_constrain.h>
+#include <hobbycad/sketch/solver.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::sketch;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+/// Largest movement allowed when solving an inferred set
+constexpr double kTolerance = 1e-6;
+
+/// Random sketch with every relation kind inferConstraints() looks for
+std::vector<Entity> makeSketch(unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> sizeDist(5.0, 20.0);
+    std::uniform_real_distribution<double> angleDist(0.0, 2.0 * kPi);
+    std::vector<Entity> entities;
+    int id = 1;
+
+    // A row of rectangles sharing their vertical sides; the first and
+    // third have the same width
+    const double height = sizeDist(rng);
+    const double widths[3] = {10.0, sizeDist(rng), 10.0};
+    double x = 0.0;
+    for (double w : widths) {
+        entities.push_back(createLine(id++, {x, 0}, {x + w, 0}));
+        entities.push_back(createLine(id++, {x + w, 0}, {x + w, height}));
+        entities.push_back(createLine(id++, {x + w, height}, {x, height}));
+        if (x == 0.0) entities.push_back(createLine(id++, {x, height}, {x, 0}));
+        x += w;
+    }
+
+    // A closed regular hexagon at a random rotation
+    {
+        const Point2D c{80.0, 10.0};
+        const double r = sizeDist(rng);
+        const double a0 = angleDist(rng);
+        for (int i = 0; i < 6; ++i) {
+            const double a = a0 + i * kPi / 3.0;
+            const double b = a0 + (i + 1) * kPi / 3.0;
+            entities.push_back(createLine(id++, {c.x + r * std::cos(a), c.y + r * std::sin(a)},
+                                          {c.x + r * std::cos(b), c.y + r * std::sin(b)}));
+        }
+    }
+
+    // Concentric rings, and a second circle equal to the inner one
+    {
+        const Point2D c{0.0, 60.0};
+        const double r = sizeDist(rng) * 0.5;
+        entities.push_back(createCircle(id++, c, r));
+        entities.push_back(createCircle(id++, c, 2.0 * r));
+        entities.push_back(createCircle(id++, {50.0, 60.0}, r));
+    }
+
+    // A line leaving a circle tangentially at a random point
+    {
+        const Point2D c{100.0, 60.0};
+        const double r = 7.0;
+        const double a = angleDist(rng);
+        const Point2D touch{c.x + r * std::cos(a), c.y + r * std::sin(a)};
+        const Point2D dir{-std::sin(a), std::cos(a)};
+        entities.push_back(createCircle(id++, c, r));
+        entities.push_back(createLine(id++, touch, touch + dir * sizeDist(rng)));
+    }
+
+    // A slot: two parallel lines joined by half circles at their ends
+    {
+        const Point2D a{0.0, 110.0};
+        const double len = sizeDist(rng) * 2.0;
+        const double r = 4.0;
+        entities.push_back(createLine(id++, {a.x, a.y - r}, {a.x + len, a.y - r}));
+        entities.push_back(createArc(id++, {a.x + len, a.y}, r, -90.0, 180.0));
+        entities.push_back(createLine(id++, {a.x + len, a.y + r}, {a.x, a.y + r}));
+        entities.push_back(createArc(id++, a, r, 90.0, 180.0));
+    }
+
+    // A loose point on a line end
+    entities.push_back(createPoint(id++, entities[0].points[0]));
+    return entities;
+}
+
+void expectSameGeometry(const std::vector<Entity>& before, const std::vector<Entity>& after,
+                        double tolerance)
+{
+    ASSERT_EQ(before.size(), after.size());
+    for (size_t i = 0; i < before.size(); ++i) {
+        SCOPED_TRACE("entity " + std::to_string(before[i].id));
+        ASSERT_EQ(before[i].points.size(), after[i].points.size());
+        for (size_t k = 0; k < before[i].points.size(); ++k) {
+            EXPECT_NEAR(before[i].points[k].x, after[i].points[k].x, tolerance);
+            EXPECT_NEAR(before[i].points[k].y, after[i].points[k].y, tolerance);
+        }
+        EXPECT_NEAR(before[i].radius, after[i].radius, tolerance);
+    }
+}
+
+/// Every constraint of the set must remove degrees of freedom
+void expectEachConstraintNeeded(const std::vector<Entity>& entities,
+                                const std::vector<Constraint>& constraints)
+{
+    Solver solver(SolverBackend::Native);
+    const int dof = solver.degreesOfFreedom(entities, constraints);
+    for (size_t i = 0; i < constraints.size(); ++i) {
+        std::vector<Constraint> without = constraints;
+        without.erase(without.begin() + i);
+        EXPECT_GT(solver.degreesOfFreedom(entities, without), dof)
+            << "constraint " << constraints[i].id << " is redundant";
+    }
+}
+
+}  // anonymous namespace
+
+// ---- Inferred sets --------------------------------------------------
+
+TEST(AutoConstrain, SolvingInferredSetLeavesGeometryUnchanged)
+{
+    for (unsigned seed = 1; seed <= 20; ++seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        const std::vector<Entity> source = makeSketch(seed);
+        const AutoConstrainResult inferred = inferConstraints(source);
+        ASSERT_TRUE(inferred.success) << inferred.errorMessage;
+        EXPECT_GT(inferred.constraints.size(), 20u);
+        EXPECT_EQ(inferred.candidates, static_cast<int>(inferred.constraints.size()) + inferred.redundant);
+
+        std::vector<Entity> solved = source;
+        Solver solver(SolverBackend::Native);
+        const SolveResult result = solver.solve(solved, inferred.constraints);
+        ASSERT_TRUE(result.success) << result.errorMessage;
+        EXPECT_EQ(result.resultCode, SolveResult::Okay) << solveResultName(result.resultCode);
+        EXPECT_TRUE(result.failedConstraintIds.empty());
+        EXPECT_EQ(result.dof, inferred.dof);
+        expectSameGeometry(source, solved, kTolerance);
+    }
+}
+
+TEST(AutoConstrain, InferredSetIsNeverOverConstrained)
+{
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        const std::vector<Entity> source = makeSketch(seed);
+        const AutoConstrainResult inferred = inferConstraints(source);
+        ASSERT_TRUE(inferred.success);
+        EXPECT_GE(inferred.dof, 0);
+        expectEachConstraintNeeded(source, inferred.constraints);
+    }
+}
+
+TEST(AutoConstrain, RespectsExistingConstraints)
+{
+    const std::vector<Entity> source = makeSketch(7);
+    const AutoConstrainResult first = inferConstraints(source);
+    ASSERT_TRUE(first.success);
+
+    // Keep every other inferred constraint and infer again: the rest
+    // come back, nothing duplicates what is kept, and the total
+    // removes the same freedom as before
+    std::vector<Constraint> existing;
+    for (size_t i = 0; i < first.constraints.size(); i += 2) existing.push_back(first.constraints[i]);
+    const AutoConstrainResult second = inferConstraints(source, existing);
+    ASSERT_TRUE(second.success);
+    EXPECT_EQ(existing.size() + second.constraints.size(), first.constraints.size());
+    EXPECT_EQ(second.dof, first.dof);
+    for (const Constraint& c : second.constraints) {
+        EXPECT_GT(c.id, existing.back().id);
+    }
+
+    std::vector<Constraint> all = existing;
+    all.insert(all.end(), second.constraints.begin(), second.constraints.end());
+    std::vector<Entity> solved = source;
+    const SolveResult result = Solver(SolverBackend::Native).solve(solved, all);
+    EXPECT_EQ(result.resultCode, SolveResult::Okay) << solveResultName(result.resultCode);
+    expectSameGeometry(source, solved, kTolerance);
+    expectEachConstraintNeeded(source, all);
+}
+
+TEST(AutoConstrain, NoiseWithinToleranceSolvesClose)
+{
+    // Drawn relations that hold only to within the tolerance are still
+    // found, and solving pulls the geometry by less than the tolerance
+    AutoConstrainOptions options;
+    options.tolerance = 1e-4;
+    options.angleTolerance = 1e-5;
+    std::mt19937 rng(97);
+    std::uniform_real_distribution<double> noise(-1e-5, 1e-5);
+    for (unsigned seed = 1; seed <= 10; ++seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        std::vector<Entity> source = makeSketch(seed);
+        for (Entity& e : source) {
+            for (Point2D& p : e.points) p = p + Point2D(noise(rng), noise(rng));
+        }
+        const AutoConstrainResult inferred = inferConstraints(source, {}, options);
+        ASSERT_TRUE(inferred.success);
+        const AutoConstrainResult exact = inferConstraints(makeSketch(seed));
+        EXPECT_EQ(inferred.constraints.size(), exact.constraints.size());
+
+        std::vector<Entity> solved = source;
+        const SolveResult result = Solver(SolverBackend::Native).solve(solved, inferred.constraints);
+        ASSERT_TRUE(result.success) << result.errorMessage;
+        EXPECT_EQ(result.resultCode, SolveResult::Okay) << solveResultName(result.resultCode);
+        expectSameGeometry(source, solved, options.tolerance);
+    }
+}
+
+TEST(AutoConstrain, CountsArcJoinsItCannotHold)
+{
+    // The slot's four line-to-arc joins have no coincident constraint
+    const AutoConstrainResult inferred = inferConstraints(makeSketch(3));
+    ASSERT_TRUE(inferred.success);
+    EXPECT_EQ(inferred.unheldJoins, 4);
+}
@@ -0,0 +1,421 @@
+// =====================================================================
+//  tests/test_chain_offset.cpp — Chain offset
+// =====================================================================
+//
+//  Offsets chains of lines, arcs, slots, polygons, ellipses and
+//  splines with round and miter joins, to both sides, and inward far
+//  enough that loops collapse or split.  Every result is sampled and
+//  measured against the source geometry (computed here, not through
+//  the offset code), and every pair of result entities is checked to
+//  meet only at shared end points.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/geometry/intersections.h>
+#include <hobbycad/geometry/utils.h>
+#include <hobbycad/sketch/operations.h>
+#include <hobbycad/sketch/snap.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::sketch;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+/// Distance error allowed where the source is offset exactly
+constexpr double kExact = 1e-6;
+
+/// How close a crossing must be to an end point to count as the join
+constexpr double kJoinTolerance = 1e-5;
+
+/// Samples taken along each result entity
+constexpr int kSamples = 40;
+
+/// Sequential IDs after the source entities
+struct IdSource {
+    int next = 1000;
+    int operator()() { return next++; }
+};
+
+std::vector<int> idsOf(const std::vector<Entity>& entities)
+{
+    std::vector<int> ids;
+    for (const Entity& e : entities) ids.push_back(e.id);
+    return ids;
+}
+
+double distanceToLoop(const Point2D& p, const std::vector<Point2D>& corners)
+{
+    double best = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < corners.size(); ++i) {
+        best = std::min(best, geometry::pointToLineDistance(p, corners[i],
+                                                            corners[(i + 1) % corners.size()]));
+    }
+    return best;
+}
+
+/// Distance from p to the source entity, from its definition
+double referenceDistance(const Entity& e, const Point2D& p)
+{
+    switch (e.type) {
+    case EntityType::Line:
+        return geometry::pointToLineDistance(p, e.points[0], e.points[1]);
+    case EntityType::Arc:
+        return geometry::pointToArcDistance(p, {e.points[0], e.radius, e.startAngle, e.sweepAngle});
+    case EntityType::Circle:
+        return geometry::pointToCircleDistance(p, e.points[0], e.radius);
+    case EntityType::Rectangle: {
+        const Point2D& a = e.points[0];
+        const Point2D& c = e.points[1];
+        return distanceToLoop(p, {a, {c.x, a.y}, c, {a.x, c.y}});
+    }
+    case EntityType::Polygon: {
+        std::vector<Point2D> corners;
+        for (int i = 0; i < e.sides; ++i) {
+            const double a = 2.0 * kPi * i / e.sides - kPi / 2.0;
+            corners.push_back({e.points[0].x + e.radius * std::cos(a),
+                               e.points[0].y + e.radius * std::sin(a)});
+        }
+        return distanceToLoop(p, corners);
+    }
+    case EntityType::Slot:
+        // A stadium is the set at the half width from its center segment
+        return std::abs(geometry::pointToLineDistance(p, e.points[0], e.points[1]) - e.radius);
+    case EntityType::Ellipse: {
+        // Closest parameter from a coarse scan, polished by Newton steps
+        // on (E(t) - p) . E'(t) = 0
+        const double a = e.majorRadius;
+        const double b = e.minorRadius;
+        const Point2D q = p - e.points[0];
+        auto at = [&](double t) { return Point2D(a * std::cos(t), b * std::sin(t)); };
+        double best = 0.0;
+        for (int i = 1; i < 180; ++i) {
+            const double t = 2.0 * kPi * i / 180;
+            if (geometry::length(at(t) - q) < geometry::length(at(best) - q)) best = t;
+        }
+        for (int i = 0; i < 20; ++i) {
+            const double c = std::cos(best);
+            const double s = std::sin(best);
+            const double f = (a * c - q.x) * (-a * s) + (b * s - q.y) * (b * c);
+            const double df = (b * b - a * a) * (c * c - s * s) + a * c * q.x + b * s * q.y;
+            if (df == 0.0) break;
+            best -= f / df;
+        }
+        return geometry::length(at(best) - q);
+    }
+    default:
+        return e.distanceTo(p);  // Splines: closest point on the fitted curve
+    }
+}
+
+double referenceDistance(const std::vector<Entity>& source, const Point2D& p)
+{
+    double best = std::numeric_limits<double>::max();
+    for (const Entity& e : source) best = std::min(best, referenceDistance(e, p));
+    return best;
+}
+
+std::vector<Point2D> samplesOf(const Entity& e)
+{
+    std::vector<Point2D> pts;
+    for (int i = 0; i <= kSamples; ++i) {
+        const double t = static_cast<double>(i) / kSamples;
+        if (e.type == EntityType::Line) {
+            pts.push_back(e.points[0] + (e.points[1] - e.points[0]) * t);
+        } else if (e.type == EntityType::Arc) {
+            pts.push_back(geometry::Arc{e.points[0], e.radius, e.startAngle, e.sweepAngle}.pointAt(t));
+        } else if (e.type == EntityType::Circle) {
+            pts.push_back({e.points[0].x + e.radius * std::cos(2.0 * kPi * t),
+                           e.points[0].y + e.radius * std::sin(2.0 * kPi * t)});
+        } else {
+            ADD_FAILURE() << "offset produced entity type " << static_cast<int>(e.type);
+        }
+    }
+    return pts;
+}
+
+/// Every sampled point of the result is within [low, high] of the source
+void expectDistances(const std::vector<Entity>& source, const ChainOffsetResult& result,
+                     double low, double high)
+{
+    for (const Entity& e : result.newEntities) {
+        for (const Point2D& p : samplesOf(e)) {
+            const double d = referenceDistance(source, p);
+            EXPECT_GE(d, low) << "entity " << e.id << " at (" << p.x << ", " << p.y << ")";
+            EXPECT_LE(d, high) << "entity " << e.id << " at (" << p.x << ", " << p.y << ")";
+        }
+    }
+}
+
+bool nearAny(const Point2D& p, const std::vector<Point2D>& ends)
+{
+    for (const Point2D& q : ends) {
+        if (geometry::length(p - q) <= kJoinTolerance) return true;
+    }
+    return false;
+}
+
+/// Result entities meet only where one ends and another starts
+void expectNoCrossings(const ChainOffsetResult& result)
+{
+    const std::vector<Entity>& out = result.newEntities;
+    for (size_t i = 0; i < out.size(); ++i) {
+        const std::vector<Point2D> endsI = out[i].endpoints();
+        for (size_t j = i + 1; j < out.size(); ++j) {
+            const std::vector<Point2D> endsJ = out[j].endpoints();
+            for (const Point2D& hit : computeEntityIntersectionPoints(out[i], out[j])) {
+                EXPECT_TRUE(nearAny(hit, endsI) && nearAny(hit, endsJ))
+                    << "entities " << out[i].id << " and " << out[j].id << " cross at ("
+                    << hit.x << ", " << hit.y << ")";
+            }
+        }
+    }
+}
+
+/// Chains are runs of entities joined end to end; count the breaks
+int countChains(const ChainOffsetResult& result)
+{
+    const std::vector<Entity>& out = result.newEntities;
+    int chains = out.empty() ? 0 : 1;
+    for (size_t i = 1; i < out.size(); ++i) {
+        bool joined = false;
+        for (const Point2D& p : out[i].endpoints()) joined = joined || nearAny(p, out[i - 1].endpoints());
+        if (!joined) ++chains;
+    }
+    return chains;
+}
+
+/// Offset to both sides with both joins, checking each result
+void checkOffsets(const std::vector<Entity>& source, double distance, double slack)
+{
+    for (OffsetJoin join : {OffsetJoin::Round, OffsetJoin::Miter}) {
+        for (int side : {1, -1}) {
+            SCOPED_TRACE(std::string(join == OffsetJoin::Round ? "round" : "miter") +
+                         (side > 0 ? " right/outward" : " left/inward"));
+            ChainOffsetOptions options;
+            options.join = join;
+            IdSource ids;
+            const ChainOffsetResult result =
+                offsetChain(idsOf(source), source, distance, side, std::ref(ids), options);
+            ASSERT_TRUE(result.success) << result.errorMessage;
+            EXPECT_EQ(countChains(result), result.chainCount);
+
+            // Miter points sit further out, but never past the limit
+            const double high = (join == OffsetJoin::Miter) ? options.miterLimit * distance
+                                                            : distance + slack;
+            expectDistances(source, result, distance - slack, high);
+            expectNoCrossings(result);
+        }
+    }
+}
+
+/// Closed outline of line segments through the given corners
+std::vector<Entity> lineLoop(const std::vector<Point2D>& corners)
+{
+    std::vector<Entity> loop;
+    for (size_t i = 0; i < corners.size(); ++i) {
+        loop.push_back(createLine(static_cast<int>(i) + 1, corners[i], corners[(i + 1) % corners.size()]));
+    }
+    return loop;
+}
+
+}  // anonymous namespace
+
+// ---- Chains of lines and arcs ---------------------------------------
+
+TEST(ChainOffset, OpenLineChain)
+{
+    // A zigzag with sharp and shallow corners on both sides
+    const std::vector<Entity> source = {
+        createLine(1, {0, 0}, {10, 0}),
+        createLine(2, {10, 0}, {14, 8}),
+        createLine(3, {14, 8}, {20, 1}),
+        createLine(4, {20, 1}, {30, 2}),
+        createLine(5, {30, 2}, {26, 12}),
+    };
+    checkOffsets(source, 1.5, kExact);
+}
+
+TEST(ChainOffset, RoundedRectangleLoop)
+{
+    // Lines joined by quarter arcs; inward past the corner radius the
+    // arcs vanish and the corners turn sharp
+    const double r = 2.0;
+    const std::vector<Entity> source = {
+        createLine(1, {r, 0}, {20 - r, 0}),
+        createArc(2, {20 - r, r}, r, -90.0, 90.0),
+        createLine(3, {20, r}, {20, 10 - r}),
+        createArc(4, {20 - r, 10 - r}, r, 0.0, 90.0),
+        createLine(5, {20 - r, 10}, {r, 10}),
+        createArc(6, {r, 10 - r}, r, 90.0, 90.0),
+        createLine(7, {0, 10 - r}, {0, r}),
+        createArc(8, {r, r}, r, 180.0, 90.0),
+    };
+    checkOffsets(source, 1.0, kExact);
+    checkOffsets(source, 3.0, kExact);
+}
+
+TEST(ChainOffset, ReflexCornersSelfIntersect)
+{
+    // An L with a notch: the inward offset of the short notch edges
+    // crosses itself and must be trimmed
+    checkOffsets(lineLoop({{0, 0}, {20, 0}, {20, 4}, {11, 4}, {11, 3}, {9, 3}, {9, 4},
+                           {4, 4}, {4, 16}, {0, 16}}), 1.2, kExact);
+}
+
+// ---- Closed entities ------------------------------------------------
+
+TEST(ChainOffset, ClosedEntities)
+{
+    {
+        SCOPED_TRACE("rectangle");
+        checkOffsets({createRectangle(1, {0, 0}, {12, 7})}, 2.0, kExact);
+    }
+    {
+        SCOPED_TRACE("polygon");
+        checkOffsets({createPolygon(1, {5, 5}, 10.0, 7)}, 1.5, kExact);
+    }
+    {
+        SCOPED_TRACE("slot");
+        checkOffsets({createSlot(1, {0, 0}, {15, 6}, 3.0)}, 1.0, kExact);
+    }
+    {
+        SCOPED_TRACE("circle");
+        checkOffsets({createCircle(1, {3, 4}, 5.0)}, 2.0, kExact);
+    }
+}
+
+TEST(ChainOffset, ClosedEntityKeepsItsShape)
+{
+    // A slot offset outward is another slot: two lines, two half circles
+    const std::vector<Entity> source = {createSlot(1, {0, 0}, {10, 0}, 2.0)};
+    IdSource ids;
+    const ChainOffsetResult result = offsetChain({1}, source, 1.0, 1, std::ref(ids));
+    ASSERT_TRUE(result.success);
+    ASSERT_EQ(result.newEntities.size(), 4u);
+    int arcs = 0;
+    for (const Entity& e : result.newEntities) {
+        if (e.type == EntityType::Arc) {
+            ++arcs;
+            EXPECT_NEAR(e.radius, 3.0, kExact);
+            EXPECT_NEAR(std::abs(e.sweepAngle), 180.0, 1e-9);
+        }
+    }
+    EXPECT_EQ(arcs, 2);
+
+    // A circle stays a single circle
+    const std::vector<Entity> circle = {createCircle(1, {0, 0}, 4.0)};
+    const ChainOffsetResult inward = offsetChain({1}, circle, 1.5, -1, std::ref(ids));
+    ASSERT_TRUE(inward.success);
+    ASSERT_EQ(inward.newEntities.size(), 1u);
+    EXPECT_EQ(inward.newEntities[0].type, EntityType::Circle);
+    EXPECT_NEAR(inward.newEntities[0].radius, 2.5, kExact);
+}
+
+// ---- Flattened curves -----------------------------------------------
+
+TEST(ChainOffset, Ellipse)
+{
+    // Flattened within the tolerance: results are within it of the offset
+    checkOffsets({createEllipse(1, {0, 0}, 20.0, 8.0)}, 2.0, ChainOffsetOptions{}.tolerance);
+}
+
+TEST(ChainOffset, OpenSpline)
+{
+    const std::vector<Entity> source = {
+        createSpline(1, {{0, 0}, {8, 6}, {16, -2}, {24, 5}, {30, 0}}),
+    };
+    checkOffsets(source, 1.0, ChainOffsetOptions{}.tolerance);
+}
+
+TEST(ChainOffset, SplineJoinedToLines)
+{
+    const std::vector<Entity> source = {
+        createLine(1, {-10, 0}, {0, 0}),
+        createSpline(2, {{0, 0}, {6, 5}, {12, -3}, {18, 0}}),
+        createLine(3, {18, 0}, {18, 10}),
+    };
+    checkOffsets(source, 0.8, ChainOffsetOptions{}.tolerance);
+}
+
+// ---- Collapsing loops -----------------------------------------------
+
+TEST(ChainOffset, InwardOffsetCollapsesLoop)
+{
+    // Nothing is left of a 10 x 4 rectangle 2.5 in from its edges
+    for (OffsetJoin join : {OffsetJoin::Round, OffsetJoin::Miter}) {
+        ChainOffsetOptions options;
+        options.join = join;
+        IdSource ids;
+        const std::vector<Entity> rect = {createRectangle(1, {0, 0}, {10, 4})};
+        const ChainOffsetResult result = offsetChain({1}, rect, 2.5, -1, std::ref(ids), options);
+        EXPECT_FALSE(result.success);
+        EXPECT_TRUE(result.newEntities.empty());
+        EXPECT_EQ(result.chainCount, 0);
+        EXPECT_FALSE(result.errorMessage.empty());
+
+        const std::vector<Entity> loop = lineLoop({{0, 0}, {10, 0}, {10, 4}, {0, 4}});
+        EXPECT_FALSE(offsetChain(idsOf(loop), loop, 2.5, -1, std::ref(ids), options).success);
+
+        const std::vector<Entity> circle = {createCircle(1, {0, 0}, 2.0)};
+        EXPECT_FALSE(offsetChain({1}, circle, 2.5, -1, std::ref(ids), options).success);
+    }
+}
+
+TEST(ChainOffset, InwardOffsetSplitsLoop)
+{
+    // Two 10 x 10 squares joined by a 2 wide neck: 1.5 inward closes
+    // the neck and leaves one loop in each square
+    const std::vector<Entity> source = lineLoop({{0, 0}, {10, 0}, {10, 4}, {14, 4}, {14, 0},
+                                                 {24, 0}, {24, 10}, {14, 10}, {14, 6},
+                                                 {10, 6}, {10, 10}, {0, 10}});
+    checkOffsets(source, 1.5, kExact);
+
+    IdSource ids;
+    const ChainOffsetResult result = offsetChain(idsOf(source), source, 1.5, -1, std::ref(ids));
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(result.chainCount, 2);
+    for (const Entity& e : result.newEntities) {
+        for (const Point2D& p : samplesOf(e)) {
+            EXPECT_TRUE(p.x < 10.0 || p.x > 14.0) << "offset runs through the neck";
+        }
+    }
+}
+
+// ---- Side selection and errors --------------------------------------
+
+TEST(ChainOffset, ClickPicksSide)
+{
+    const std::vector<Entity> source = lineLoop({{0, 0}, {10, 0}, {10, 10}, {0, 10}});
+    IdSource ids;
+    const ChainOffsetResult inside = offsetChain(idsOf(source), source, 1.0, Point2D{5, 5}, std::ref(ids));
+    const ChainOffsetResult outside = offsetChain(idsOf(source), source, 1.0, Point2D{15, 5}, std::ref(ids));
+    ASSERT_TRUE(inside.success);
+    ASSERT_TRUE(outside.success);
+    for (const Entity& e : inside.newEntities) {
+        for (const Point2D& p : e.endpoints()) EXPECT_TRUE(p.x > 0 && p.x < 10 && p.y > 0 && p.y < 10);
+    }
+    for (const Entity& e : outside.newEntities) {
+        for (const Point2D& p : e.endpoints()) EXPECT_FALSE(p.x > 0 && p.x < 10 && p.y > 0 && p.y < 10);
+    }
+}
+
+TEST(ChainOffset, RejectsBadInput)
+{
+    const std::vector<Entity> source = {createLine(1, {0, 0}, {10, 0})};
+    IdSource ids;
+    EXPECT_FALSE(offsetChain({1}, source, 0.0, 1, std::ref(ids)).success);
+    EXPECT_FALSE(offsetChain({1}, source, -1.0, 1, std::ref(ids)).success);
+    EXPECT_FALSE(offsetChain({42}, source, 1.0, 1, std::ref(ids)).success);
+}
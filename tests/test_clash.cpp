@@ -0,0 +1,346 @@
+// =====================================================================
+//  tests/test_clash.cpp — Clash and clearance detection
+// =====================================================================
+//
+//  Lays out grids of boxes and spheres at known gaps and overlaps —
+//  interfering, touching, inside the clearance and beyond it — and
+//  checks that findClashes() reports exactly the expected pairs, in
+//  order, with their analytic distances and interference volumes.
+//  Runs the triangle-mesh front end and, on the same layouts, the
+//  B-rep front end with both its exact and mesh methods.  Parallel
+//  and serial runs must give identical reports.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/brep/clash.h>
+#include <hobbycad/mesh/clash.h>
+
+#include <gtest/gtest.h>
+
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeSphere.hxx>
+#include <gp_Pnt.hxx>
+
+#include <cmath>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace hobbycad;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+constexpr double kBoxSide = 10.0;
+constexpr double kRadius = 5.0;
+constexpr double kClearance = 2.0;
+
+/// An axis-aligned box or a sphere
+struct Body {
+    bool sphere = false;
+    mesh::MeshPoint origin;     ///< Min corner, or centre
+    double size = kBoxSide;     ///< Side, or radius
+};
+
+/// What findClashes() should report for one pair
+struct Expected {
+    mesh::ClashType type = mesh::ClashType::Interference;
+    double distance = 0.0;
+    double volume = 0.0;
+};
+
+using ExpectedPairs = std::map<std::pair<int, int>, Expected>;
+
+/// A layout and the pairs it must report
+struct Scene {
+    std::vector<Body> bodies;
+    ExpectedPairs pairs;
+};
+
+// ---- Layouts --------------------------------------------------------
+
+/// Rows of boxes; neighbours in a row are spaced by each gap in turn
+/// (negative gaps overlap), rows far enough apart never to meet.  One
+/// small box sits inside a large one at the end of each row.
+Scene boxRows(int rows)
+{
+    const double gaps[] = {-2.0, 0.0, 0.5, 1.5, kClearance + 1.0, -4.0};
+    Scene s;
+    for (int r = 0; r < rows; ++r) {
+        const double y = r * 3.0 * kBoxSide;
+        double x = 0.0;
+        for (int k = 0; k <= 6; ++k) {
+            s.bodies.push_back({false, {x, y, 0.0}, kBoxSide});
+            if (k == 6) break;
+            const double gap = gaps[(k + r) % 6];
+            const int i = static_cast<int>(s.bodies.size()) - 1;
+            if (gap < 0.0) {
+                s.pairs[{i, i + 1}] = {mesh::ClashType::Interference, 0.0, -gap * kBoxSide * kBoxSide};
+            } else if (gap == 0.0) {
+                s.pairs[{i, i + 1}] = {mesh::ClashType::Contact, 0.0, 0.0};
+            } else if (gap <= kClearance) {
+                s.pairs[{i, i + 1}] = {mesh::ClashType::Clearance, gap, 0.0};
+            }
+            x += kBoxSide + gap;
+        }
+        // Containment: no faces meet, but the volume is shared
+        const int outer = static_cast<int>(s.bodies.size());
+        s.bodies.push_back({false, {x + 2.0 * kBoxSide, y, 0.0}, 2.0 * kBoxSide});
+        s.bodies.push_back({false, {x + 2.5 * kBoxSide, y + 0.5 * kBoxSide, 0.5 * kBoxSide}, kBoxSide / 2.0});
+        s.pairs[{outer, outer + 1}] = {mesh::ClashType::Interference, 0.0, std::pow(kBoxSide / 2.0, 3)};
+    }
+    return s;
+}
+
+/// Volume of the lens two spheres of radius r share at distance d
+double lensVolume(double r, double d)
+{
+    return d >= 2.0 * r ? 0.0 : kPi * (4.0 * r + d) * (2.0 * r - d) * (2.0 * r - d) / 12.0;
+}
+
+/// An nx x ny x nz lattice of spheres: x neighbours inside the
+/// clearance, y neighbours beyond it, z neighbours overlapping.  All
+/// diagonal neighbours are beyond the clearance.
+Scene sphereLattice(int nx, int ny, int nz)
+{
+    const double px = 2.0 * kRadius + 0.5;
+    const double py = 2.0 * kRadius + kClearance + 1.0;
+    const double pz = 2.0 * kRadius - 1.0;
+    Scene s;
+    auto index = [&](int i, int j, int k) { return (k * ny + j) * nx + i; };
+    for (int k = 0; k < nz; ++k) {
+        for (int j = 0; j < ny; ++j) {
+            for (int i = 0; i < nx; ++i) {
+                s.bodies.push_back({true, {i * px, j * py, k * pz}, kRadius});
+                if (i > 0) s.pairs[{index(i - 1, j, k), index(i, j, k)}] = {mesh::ClashType::Clearance, px - 2.0 * kRadius, 0.0};
+                if (k > 0) s.pairs[{index(i, j, k - 1), index(i, j, k)}] = {mesh::ClashType::Interference, 0.0, lensVolume(kRadius, pz)};
+            }
+        }
+    }
+    return s;
+}
+
+// ---- Meshes ---------------------------------------------------------
+
+mesh::TriangleMesh boxMesh(const mesh::MeshPoint& o, double side)
+{
+    mesh::TriangleMesh m;
+    for (int k = 0; k < 8; ++k) {
+        m.vertices.push_back({o.x + ((k & 1) ? side : 0.0), o.y + ((k & 2) ? side : 0.0),
+                              o.z + ((k & 4) ? side : 0.0)});
+    }
+    // Outward, counter-clockwise seen from outside
+    m.triangles = {{0, 2, 3}, {0, 3, 1}, {4, 5, 7}, {4, 7, 6},
+                   {0, 1, 5}, {0, 5, 4}, {2, 6, 7}, {2, 7, 3},
+                   {0, 4, 6}, {0, 6, 2}, {1, 3, 7}, {1, 7, 5}};
+    return m;
+}
+
+/// UV sphere with its vertices on the sphere.  A multiple of four
+/// segments and an even ring count put vertices at the six axis
+/// extremes, so the polyhedron reaches the sphere exactly where
+/// lattice neighbours come closest and mesh distances are analytic.
+mesh::TriangleMesh sphereMesh(const mesh::MeshPoint& c, double r, int segments = 48, int rings = 24)
+{
+    mesh::TriangleMesh m;
+    m.vertices.push_back({c.x, c.y, c.z - r});
+    for (int i = 1; i < rings; ++i) {
+        const double phi = -kPi / 2.0 + kPi * i / rings;
+        for (int j = 0; j < segments; ++j) {
+            const double theta = 2.0 * kPi * j / segments;
+            m.vertices.push_back({c.x + r * std::cos(phi) * std::cos(theta),
+                                  c.y + r * std::cos(phi) * std::sin(theta), c.z + r * std::sin(phi)});
+        }
+    }
+    m.vertices.push_back({c.x, c.y, c.z + r});
+    const int top = static_cast<int>(m.vertices.size()) - 1;
+    auto at = [&](int ring, int j) { return 1 + (ring - 1) * segments + (j % segments); };
+    for (int j = 0; j < segments; ++j) {
+        m.triangles.push_back({0, at(1, j + 1), at(1, j)});
+        for (int i = 1; i < rings - 1; ++i) {
+            m.triangles.push_back({at(i, j), at(i, j + 1), at(i + 1, j + 1)});
+            m.triangles.push_back({at(i, j), at(i + 1, j + 1), at(i + 1, j)});
+        }
+        m.triangles.push_back({top, at(rings - 1, j), at(rings - 1, j + 1)});
+    }
+    return m;
+}
+
+std::vector<mesh::TriangleMesh> toMeshes(const Scene& s)
+{
+    std::vector<mesh::TriangleMesh> meshes;
+    for (const Body& b : s.bodies) {
+        meshes.push_back(b.sphere ? sphereMesh(b.origin, b.size) : boxMesh(b.origin, b.size));
+    }
+    return meshes;
+}
+
+std::vector<TopoDS_Shape> toShapes(const Scene& s)
+{
+    std::vector<TopoDS_Shape> shapes;
+    for (const Body& b : s.bodies) {
+        const gp_Pnt p(b.origin.x, b.origin.y, b.origin.z);
+        shapes.push_back(b.sphere ? BRepPrimAPI_MakeSphere(p, b.size).Shape()
+                                  : BRepPrimAPI_MakeBox(p, b.size, b.size, b.size).Shape());
+    }
+    return shapes;
+}
+
+// ---- Checks ---------------------------------------------------------
+
+/// The report holds exactly the expected pairs, in order, with their
+/// distances and volumes (relative volume tolerance)
+void expectPairs(const mesh::ClashReport& report, const ExpectedPairs& expected,
+                 double distanceTol, double volumeTol)
+{
+    ASSERT_TRUE(report.success) << report.errorMessage;
+    std::vector<std::pair<int, int>> found;
+    for (const mesh::ClashPair& c : report.clashes) found.push_back({c.bodyA, c.bodyB});
+    std::vector<std::pair<int, int>> wanted;
+    for (const auto& e : expected) wanted.push_back(e.first);
+    ASSERT_EQ(found, wanted);
+
+    for (const mesh::ClashPair& c : report.clashes) {
+        SCOPED_TRACE("pair " + std::to_string(c.bodyA) + "-" + std::to_string(c.bodyB));
+        const Expected& e = expected.at({c.bodyA, c.bodyB});
+        EXPECT_EQ(c.type, e.type) << mesh::clashTypeName(c.type);
+        if (c.type == mesh::ClashType::Interference) {
+            EXPECT_NEAR(c.volume, e.volume, volumeTol * e.volume);
+        } else {
+            EXPECT_NEAR(c.distance, e.distance, distanceTol);
+            EXPECT_NEAR((c.pointB - c.pointA).length(), c.distance, distanceTol);
+        }
+    }
+}
+
+void expectSameReports(const mesh::ClashReport& a, const mesh::ClashReport& b)
+{
+    ASSERT_EQ(a.clashes.size(), b.clashes.size());
+    EXPECT_EQ(a.candidatePairs, b.candidatePairs);
+    for (size_t k = 0; k < a.clashes.size(); ++k) {
+        const mesh::ClashPair& p = a.clashes[k];
+        const mesh::ClashPair& q = b.clashes[k];
+        EXPECT_EQ(p.bodyA, q.bodyA);
+        EXPECT_EQ(p.bodyB, q.bodyB);
+        EXPECT_EQ(p.type, q.type);
+        EXPECT_EQ(p.distance, q.distance);
+        EXPECT_EQ(p.volume, q.volume);
+        EXPECT_EQ((p.pointA - q.pointA).length(), 0.0);
+        EXPECT_EQ((p.pointB - q.pointB).length(), 0.0);
+    }
+}
+
+}  // anonymous namespace
+
+// ---- Mesh bodies ----------------------------------------------------
+
+TEST(MeshClash, BoxRows)
+{
+    const Scene s = boxRows(6);
+    mesh::ClashOptions options;
+    options.clearance = kClearance;
+    options.volumeSamples = 16;
+    const mesh::ClashReport report = mesh::findClashes(toMeshes(s), options);
+    EXPECT_EQ(report.bodies, static_cast<int>(s.bodies.size()));
+    // Boxes are axis-aligned, so ray sampling measures them exactly
+    expectPairs(report, s.pairs, 1e-9, 1e-9);
+}
+
+TEST(MeshClash, SphereLattice)
+{
+    const Scene s = sphereLattice(4, 3, 3);
+    mesh::ClashOptions options;
+    options.clearance = kClearance;
+    options.volumeSamples = 64;
+    const mesh::ClashReport report = mesh::findClashes(toMeshes(s), options);
+    // Polyhedral spheres fall a little short of the lens volume
+    expectPairs(report, s.pairs, 1e-9, 0.05);
+    for (const mesh::ClashPair& c : report.clashes) {
+        if (c.type == mesh::ClashType::Interference) EXPECT_LT(c.volume, lensVolume(kRadius, 2.0 * kRadius - 1.0));
+    }
+}
+
+TEST(MeshClash, ClearanceZeroReportsTouchingOnly)
+{
+    const Scene s = boxRows(3);
+    ExpectedPairs touching;
+    for (const auto& e : s.pairs) {
+        if (e.second.type != mesh::ClashType::Clearance) touching.insert(e);
+    }
+    mesh::ClashOptions options;
+    options.volumeSamples = 16;
+    expectPairs(mesh::findClashes(toMeshes(s), options), touching, 1e-9, 1e-9);
+}
+
+TEST(MeshClash, ParallelMatchesSerial)
+{
+    for (const Scene& s : {boxRows(8), sphereLattice(5, 3, 3)}) {
+        mesh::ClashOptions options;
+        options.clearance = kClearance;
+        options.parallel = true;
+        const std::vector<mesh::TriangleMesh> meshes = toMeshes(s);
+        const mesh::ClashReport parallel = mesh::findClashes(meshes, options);
+        options.parallel = false;
+        const mesh::ClashReport serial = mesh::findClashes(meshes, options);
+        expectSameReports(parallel, serial);
+    }
+}
+
+TEST(MeshClash, RejectsNegativeClearance)
+{
+    mesh::ClashOptions options;
+    options.clearance = -1.0;
+    const mesh::ClashReport report = mesh::findClashes(toMeshes(boxRows(1)), options);
+    EXPECT_FALSE(report.success);
+    EXPECT_FALSE(report.errorMessage.empty());
+}
+
+// ---- B-rep bodies ---------------------------------------------------
+
+TEST(BrepClash, ExactBoxesAndSpheres)
+{
+    brep::ClashOptions options;
+    options.clearance = kClearance;
+
+    const Scene boxes = boxRows(4);
+    expectPairs(brep::findClashes(toShapes(boxes), options), boxes.pairs, 1e-7, 1e-6);
+
+    const Scene spheres = sphereLattice(3, 2, 2);
+    expectPairs(brep::findClashes(toShapes(spheres), options), spheres.pairs, 1e-7, 1e-4);
+}
+
+TEST(BrepClash, MeshMethodAgreesWithinDeflection)
+{
+    brep::ClashOptions options;
+    options.clearance = kClearance;
+    options.method = brep::ClashMethod::Mesh;
+    options.deflection = 0.01;
+
+    const Scene boxes = boxRows(4);
+    expectPairs(brep::findClashes(toShapes(boxes), options), boxes.pairs, 1e-7, 0.02);
+
+    // Tessellated spheres sit inside the true ones by up to the
+    // deflection, so gaps can grow by twice that
+    const Scene spheres = sphereLattice(3, 2, 2);
+    expectPairs(brep::findClashes(toShapes(spheres), options), spheres.pairs, 2.0 * options.deflection, 0.05);
+}
+
+TEST(BrepClash, ParallelMatchesSerial)
+{
+    for (brep::ClashMethod method : {brep::ClashMethod::Exact, brep::ClashMethod::Mesh}) {
+        const Scene s = boxRows(3);
+        const std::vector<TopoDS_Shape> shapes = toShapes(s);
+        brep::ClashOptions options;
+        options.clearance = kClearance;
+        options.method = method;
+        options.parallel = true;
+        const mesh::ClashReport parallel = brep::findClashes(shapes, options);
+        options.parallel = false;
+        const mesh::ClashReport serial = brep::findClashes(shapes, options);
+        expectSameReports(parallel, serial);
+    }
+}
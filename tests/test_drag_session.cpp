@@ -0,0 +1,119 @@
+// =====================================================================
+//  tests/test_drag_session.cpp — Interactive drag solving
+// =====================================================================
+//
+//  Replays a short drag over a pinned linkage and checks, step by
+//  step, that the dragged point follows the cursor, the constraints
+//  hold, and lastStep() reports the step's cost.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/sketch/drag_session.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::sketch;
+
+namespace {
+
+constexpr double kLinkLength = 10.0;
+constexpr double kTolerance = 1e-6;
+
+/// Three links pinned at the origin, bent in a zigzag so the drag
+/// does not start from the singular fully stretched pose
+void makeLinkage(std::vector<Entity>& entities, std::vector<Constraint>& constraints)
+{
+    const Point2D joints[] = {{0, 0}, {8, 6}, {16, 0}, {24, 6}};
+    for (int id = 1; id <= 3; ++id) {
+        entities.push_back(createLine(id, joints[id - 1], joints[id]));
+
+        Constraint length;
+        length.id = static_cast<int>(constraints.size()) + 1;
+        length.type = ConstraintType::Distance;
+        length.entityIds = {id, id};
+        length.pointIndices = {0, 1};
+        length.value = kLinkLength;
+        constraints.push_back(length);
+
+        if (id > 1) {
+            Constraint joint;
+            joint.id = static_cast<int>(constraints.size()) + 1;
+            joint.type = ConstraintType::Coincident;
+            joint.entityIds = {id - 1, id};
+            joint.pointIndices = {1, 0};
+            constraints.push_back(joint);
+        }
+    }
+
+    Constraint pin;
+    pin.id = static_cast<int>(constraints.size()) + 1;
+    pin.type = ConstraintType::FixedPoint;
+    pin.entityIds = {1};
+    pin.pointIndices = {0};
+    constraints.push_back(pin);
+}
+
+double length(const Entity& line)
+{
+    return std::hypot(line.points[1].x - line.points[0].x, line.points[1].y - line.points[0].y);
+}
+
+}  // anonymous namespace
+
+TEST(DragSession, ReplayKeepsConstraints)
+{
+    std::vector<Entity> entities;
+    std::vector<Constraint> constraints;
+    makeLinkage(entities, constraints);
+
+    DragSession drag;
+    drag.begin(entities, constraints, {{3, 1}});
+    ASSERT_TRUE(drag.isActive());
+
+    // Pull the free end in toward the pin in small mouse moves
+    for (int i = 1; i <= 20; ++i) {
+        SCOPED_TRACE("step " + std::to_string(i));
+        const Point2D target{24.0 - i * 0.4, 6.0 + i * 0.3};
+        const SolveResult result = drag.step({target});
+        drag.applyTo(entities);
+
+        const DragStepInfo& info = drag.lastStep();
+        EXPECT_TRUE(result.success);
+        EXPECT_TRUE(info.converged);
+        EXPECT_GE(info.iterations, 1);
+        EXPECT_LE(info.iterations, drag.maxIterationsPerStep());
+        EXPECT_GE(info.milliseconds, 0.0);
+
+        // Dragged points are weighted, not pinned, so they may trail
+        // the cursor slightly
+        EXPECT_NEAR(entities[2].points[1].x, target.x, 1e-2);
+        EXPECT_NEAR(entities[2].points[1].y, target.y, 1e-2);
+        EXPECT_NEAR(entities[0].points[0].x, 0.0, kTolerance);
+        EXPECT_NEAR(entities[0].points[0].y, 0.0, kTolerance);
+        for (int l = 0; l < 3; ++l) {
+            EXPECT_NEAR(length(entities[l]), kLinkLength, kTolerance);
+        }
+        for (int l = 0; l < 2; ++l) {
+            EXPECT_NEAR(entities[l].points[1].x, entities[l + 1].points[0].x, kTolerance);
+            EXPECT_NEAR(entities[l].points[1].y, entities[l + 1].points[0].y, kTolerance);
+        }
+    }
+
+    drag.end();
+    EXPECT_FALSE(drag.isActive());
+}
+
+TEST(DragSession, StepWithoutBeginFails)
+{
+    DragSession drag;
+    const SolveResult result = drag.step({Point2D{1.0, 2.0}});
+    EXPECT_FALSE(result.success);
+    EXPECT_FALSE(result.errorMessage.empty());
+}
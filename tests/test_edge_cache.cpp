@@ -0,0 +1,227 @@
+// =====================================================================
+//  tests/test_edge_cache.cpp — Sketch edge cache
+// =====================================================================
+//
+//  Builds two rectangular cells that share one line and checks that
+//  wires and faces built through a SketchEdgeCache share that edge
+//  and its vertices, while building each cell separately duplicates
+//  them.  Sharing is checked twice: pairwise with IsSame (the two
+//  profiles hold the identical TopoDS_Edge) and by counting distinct
+//  sub-shapes with TopExp::MapShapes.  Also checks that update() only
+//  invalidates the entities that actually changed.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/brep/edge_cache.h>
+#include <hobbycad/brep/operations.h>
+#include <hobbycad/sketch/profiles.h>
+
+#include <gtest/gtest.h>
+
+#include <BRep_Builder.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS_Compound.hxx>
+
+#include <algorithm>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::sketch;
+
+namespace {
+
+constexpr int kSharedLine = 7;
+
+/// Two 10x10 cells side by side; line 7 is the wall between them
+std::vector<Entity> makeCells()
+{
+    return {
+        createLine(1, {0, 0}, {10, 0}),
+        createLine(2, {10, 0}, {20, 0}),
+        createLine(3, {20, 0}, {20, 10}),
+        createLine(4, {20, 10}, {10, 10}),
+        createLine(5, {10, 10}, {0, 10}),
+        createLine(6, {0, 10}, {0, 0}),
+        createLine(kSharedLine, {10, 0}, {10, 10}),
+    };
+}
+
+/// The two single-cell profiles, leaving out the outline around both
+std::vector<Profile> cellProfiles(const std::vector<Entity>& entities)
+{
+    std::vector<Profile> cells;
+    for (const Profile& profile : detectProfiles(entities)) {
+        if (std::find(profile.entityIds.begin(), profile.entityIds.end(), kSharedLine)
+            != profile.entityIds.end()) {
+            cells.push_back(profile);
+        }
+    }
+    return cells;
+}
+
+int countSubShapes(const TopoDS_Shape& shape, TopAbs_ShapeEnum type)
+{
+    TopTools_IndexedMapOfShape map;
+    TopExp::MapShapes(shape, type, map);
+    return map.Extent();
+}
+
+/// Sub-shapes of a that IsSame() one of b's, each listed once
+std::vector<TopoDS_Shape> sharedSubShapes(const TopoDS_Shape& a, const TopoDS_Shape& b,
+                                          TopAbs_ShapeEnum type)
+{
+    std::vector<TopoDS_Shape> shared;
+    for (TopExp_Explorer ea(a, type); ea.More(); ea.Next()) {
+        const TopoDS_Shape& candidate = ea.Current();
+        bool listed = std::any_of(shared.begin(), shared.end(), [&](const TopoDS_Shape& s) {
+            return s.IsSame(candidate);
+        });
+        if (listed) continue;
+        for (TopExp_Explorer eb(b, type); eb.More(); eb.Next()) {
+            if (eb.Current().IsSame(candidate)) {
+                shared.push_back(candidate);
+                break;
+            }
+        }
+    }
+    return shared;
+}
+
+/// The faces of a shape, in exploration order
+std::vector<TopoDS_Shape> faces(const TopoDS_Shape& shape)
+{
+    std::vector<TopoDS_Shape> result;
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        result.push_back(exp.Current());
+    }
+    return result;
+}
+
+}  // anonymous namespace
+
+// ---- Sharing --------------------------------------------------------
+
+TEST(SketchEdgeCache, AdjacentWiresShareEdgeAndVertices)
+{
+    const std::vector<Entity> entities = makeCells();
+    const std::vector<Profile> cells = cellProfiles(entities);
+    ASSERT_EQ(cells.size(), 2u);
+
+    brep::SketchEdgeCache cache(entities);
+    const TopoDS_Wire left = cache.wire(cells[0]);
+    const TopoDS_Wire right = cache.wire(cells[1]);
+    ASSERT_FALSE(left.IsNull());
+    ASSERT_FALSE(right.IsNull());
+
+    ASSERT_EQ(cache.edges(kSharedLine).size(), 1u);
+    const TopoDS_Edge& shared = cache.edges(kSharedLine).front();
+    int found = 0;
+    for (const TopoDS_Wire& wire : {left, right}) {
+        TopTools_IndexedMapOfShape edges;
+        TopExp::MapShapes(wire, TopAbs_EDGE, edges);
+        if (edges.Contains(shared)) ++found;
+    }
+    EXPECT_EQ(found, 2);
+
+    // Exactly one edge of the left wire is the identical TopoDS_Edge
+    // in the right wire, and it is the wall; its two end vertices are
+    // the only shared vertices
+    const std::vector<TopoDS_Shape> sharedEdges = sharedSubShapes(left, right, TopAbs_EDGE);
+    ASSERT_EQ(sharedEdges.size(), 1u);
+    EXPECT_TRUE(sharedEdges.front().IsSame(shared));
+    EXPECT_EQ(sharedSubShapes(left, right, TopAbs_VERTEX).size(), 2u);
+
+    BRep_Builder builder;
+    TopoDS_Compound both;
+    builder.MakeCompound(both);
+    builder.Add(both, left);
+    builder.Add(both, right);
+    EXPECT_EQ(countSubShapes(both, TopAbs_EDGE), 7);
+    EXPECT_EQ(countSubShapes(both, TopAbs_VERTEX), 6);
+
+    const brep::EdgeCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.builtEntities, 7u);
+    EXPECT_EQ(stats.edges, 7u);
+    EXPECT_EQ(stats.vertices, 6u);
+}
+
+TEST(SketchEdgeCache, RegionFacesShareEdges)
+{
+    const std::vector<Entity> entities = makeCells();
+    std::vector<ProfileRegion> regions;
+    for (const Profile& cell : cellProfiles(entities)) {
+        ProfileRegion region;
+        region.outer = cell;
+        regions.push_back(region);
+    }
+    ASSERT_EQ(regions.size(), 2u);
+
+    brep::SketchEdgeCache cache(entities);
+    const brep::OperationResult cached = brep::buildRegionFaces(regions, cache);
+    ASSERT_TRUE(cached.success) << cached.errorMessage;
+    EXPECT_EQ(countSubShapes(cached.shape, TopAbs_FACE), 2);
+    EXPECT_EQ(countSubShapes(cached.shape, TopAbs_EDGE), 7);
+    EXPECT_EQ(countSubShapes(cached.shape, TopAbs_VERTEX), 6);
+
+    const std::vector<TopoDS_Shape> cachedFaces = faces(cached.shape);
+    ASSERT_EQ(cachedFaces.size(), 2u);
+    const std::vector<TopoDS_Shape> sharedEdges =
+        sharedSubShapes(cachedFaces[0], cachedFaces[1], TopAbs_EDGE);
+    ASSERT_EQ(sharedEdges.size(), 1u);
+    EXPECT_TRUE(sharedEdges.front().IsSame(cache.edges(kSharedLine).front()));
+    EXPECT_EQ(sharedSubShapes(cachedFaces[0], cachedFaces[1], TopAbs_VERTEX).size(), 2u);
+
+    // Converting each region on its own, as before the cache, gives
+    // each face its own copy of the wall and its end vertices
+    BRep_Builder builder;
+    TopoDS_Compound separate;
+    builder.MakeCompound(separate);
+    for (const ProfileRegion& region : regions) {
+        const brep::OperationResult face = brep::buildRegionFaces({region}, entities);
+        ASSERT_TRUE(face.success) << face.errorMessage;
+        builder.Add(separate, face.shape);
+    }
+    EXPECT_EQ(countSubShapes(separate, TopAbs_EDGE), 8);
+    EXPECT_EQ(countSubShapes(separate, TopAbs_VERTEX), 8);
+
+    const std::vector<TopoDS_Shape> separateFaces = faces(separate);
+    ASSERT_EQ(separateFaces.size(), 2u);
+    EXPECT_TRUE(sharedSubShapes(separateFaces[0], separateFaces[1], TopAbs_EDGE).empty());
+    EXPECT_TRUE(sharedSubShapes(separateFaces[0], separateFaces[1], TopAbs_VERTEX).empty());
+}
+
+// ---- Invalidation ---------------------------------------------------
+
+TEST(SketchEdgeCache, UpdateRebuildsOnlyChangedEntities)
+{
+    std::vector<Entity> entities = makeCells();
+    const std::vector<Profile> cells = cellProfiles(entities);
+    ASSERT_EQ(cells.size(), 2u);
+
+    brep::SketchEdgeCache cache(entities);
+    ASSERT_FALSE(cache.wire(cells[0]).IsNull());
+    ASSERT_FALSE(cache.wire(cells[1]).IsNull());
+    const TopoDS_Edge wall = cache.edges(kSharedLine).front();
+
+    // Unchanged entities keep their edges
+    EXPECT_EQ(cache.update(entities), 0);
+    EXPECT_TRUE(cache.edges(kSharedLine).front().IsSame(wall));
+
+    // Stretch the right cell: the three lines at its far end change,
+    // the wall between the cells keeps its edge
+    entities[2] = createLine(3, {30, 0}, {30, 10});
+    entities[1] = createLine(2, {10, 0}, {30, 0});
+    entities[3] = createLine(4, {30, 10}, {10, 10});
+    EXPECT_EQ(cache.update(entities), 3);
+    EXPECT_TRUE(cache.edges(kSharedLine).front().IsSame(wall));
+
+    // Removing an entity invalidates it as well
+    entities.pop_back();
+    EXPECT_EQ(cache.update(entities), 1);
+    EXPECT_EQ(cache.entity(kSharedLine), nullptr);
+    EXPECT_EQ(cache.stats().entities, 6u);
+}
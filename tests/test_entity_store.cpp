@@ -0,0 +1,430 @@
+// =====================================================================
+//  tests/test_entity_store.cpp — Struct-of-arrays entity store
+// =====================================================================
+//
+//  Checks that EntityStore reconstructs the entities it was built
+//  from exactly, and that every snap, profile and read-only operation
+//  query over a store returns the same result as the
+//  std::vector<Entity> version.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/sketch/entity_store.h>
+#include <hobbycad/sketch/operations.h>
+#include <hobbycad/sketch/profiles.h>
+#include <hobbycad/sketch/snap.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::sketch;
+
+namespace {
+
+/// One entity of every type, overlapping so intersections exist
+std::vector<Entity> makeEntities()
+{
+    std::vector<Entity> entities;
+    entities.push_back(createPoint(1, {-5, 3}));
+    entities.push_back(createLine(2, {-20, -10}, {30, 15}));
+    entities.push_back(createRectangle(3, {-8, -6}, {12, 9}));
+    entities.push_back(createCircle(4, {5, 0}, 7.5));
+    entities.push_back(createArc(5, {-4, 2}, 6, 30, 200));
+    entities.push_back(createSpline(6, {{-15, 5}, {-5, 12}, {5, -4}, {18, 6}}));
+    entities.push_back(createPolygon(7, {20, -12}, 5, 6));
+    entities.push_back(createSlot(8, {-18, -15}, {-2, -15}, 3));
+    entities.push_back(createEllipse(9, {0, 20}, 9, 4));
+    entities.push_back(createText(10, {2, -20}, "Größe", "DejaVu Sans", 4.0));
+    entities.back().fontBold = true;
+    entities.back().textRotation = 15.0;
+    entities[1].isConstruction = true;
+    entities[3].constrained = true;
+    entities[4].arcFlipped = true;
+    entities[7].groupId = 2;
+    return entities;
+}
+
+/// Loops for profile detection: a square of lines with a circle hole
+/// holding a rectangle island, a lens of two arcs, and a construction
+/// triangle
+std::vector<Entity> makeProfileEntities()
+{
+    std::vector<Entity> entities;
+    entities.push_back(createLine(1, {0, 0}, {40, 0}));
+    entities.push_back(createLine(2, {40, 0}, {40, 40}));
+    entities.push_back(createLine(3, {40, 40}, {0, 40}));
+    entities.push_back(createLine(4, {0, 40}, {0, 0}));
+    entities.push_back(createCircle(5, {20, 20}, 12));
+    entities.push_back(createRectangle(6, {16, 16}, {24, 24}));
+    entities.push_back(createArc(7, {60, 0}, 10, 0, 180));
+    entities.push_back(createArc(8, {60, 0}, 10, 180, 180));
+    entities.push_back(createLine(9, {-10, -10}, {-20, -10}));
+    entities.push_back(createLine(10, {-20, -10}, {-15, -2}));
+    entities.push_back(createLine(11, {-15, -2}, {-10, -10}));
+    for (int i = 8; i < 11; ++i) entities[i].isConstruction = true;
+    return entities;
+}
+
+void expectSameProfiles(const std::vector<Profile>& a, const std::vector<Profile>& b)
+{
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        SCOPED_TRACE("profile " + std::to_string(i));
+        EXPECT_EQ(a[i].id, b[i].id);
+        EXPECT_EQ(a[i].entityIds, b[i].entityIds);
+        EXPECT_EQ(a[i].reversed, b[i].reversed);
+        EXPECT_EQ(a[i].isOuter, b[i].isOuter);
+        EXPECT_EQ(a[i].parentId, b[i].parentId);
+        EXPECT_DOUBLE_EQ(a[i].area, b[i].area);
+        ASSERT_EQ(a[i].polygon.size(), b[i].polygon.size());
+        for (size_t k = 0; k < a[i].polygon.size(); ++k) {
+            EXPECT_DOUBLE_EQ(a[i].polygon[k].x, b[i].polygon[k].x);
+            EXPECT_DOUBLE_EQ(a[i].polygon[k].y, b[i].polygon[k].y);
+        }
+    }
+}
+
+void expectSameIntersections(const std::vector<Intersection>& a,
+                             const std::vector<Intersection>& b)
+{
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        SCOPED_TRACE("intersection " + std::to_string(i));
+        EXPECT_EQ(a[i].entityId1, b[i].entityId1);
+        EXPECT_EQ(a[i].entityId2, b[i].entityId2);
+        EXPECT_DOUBLE_EQ(a[i].point.x, b[i].point.x);
+        EXPECT_DOUBLE_EQ(a[i].point.y, b[i].point.y);
+        EXPECT_DOUBLE_EQ(a[i].param1, b[i].param1);
+        EXPECT_DOUBLE_EQ(a[i].param2, b[i].param2);
+    }
+}
+
+void expectSameEntity(const Entity& a, const Entity& b)
+{
+    SCOPED_TRACE("entity " + std::to_string(a.id));
+    EXPECT_EQ(a.id, b.id);
+    EXPECT_EQ(a.type, b.type);
+    ASSERT_EQ(a.points.size(), b.points.size());
+    for (size_t i = 0; i < a.points.size(); ++i) {
+        EXPECT_EQ(a.points[i].x, b.points[i].x);
+        EXPECT_EQ(a.points[i].y, b.points[i].y);
+    }
+    EXPECT_EQ(a.radius, b.radius);
+    EXPECT_EQ(a.startAngle, b.startAngle);
+    EXPECT_EQ(a.sweepAngle, b.sweepAngle);
+    EXPECT_EQ(a.sides, b.sides);
+    EXPECT_EQ(a.majorRadius, b.majorRadius);
+    EXPECT_EQ(a.minorRadius, b.minorRadius);
+    EXPECT_EQ(a.arcFlipped, b.arcFlipped);
+    EXPECT_EQ(a.isConstruction, b.isConstruction);
+    EXPECT_EQ(a.constrained, b.constrained);
+    EXPECT_EQ(a.groupId, b.groupId);
+    EXPECT_EQ(a.text, b.text);
+    EXPECT_EQ(a.fontFamily, b.fontFamily);
+    EXPECT_EQ(a.fontSize, b.fontSize);
+    EXPECT_EQ(a.fontBold, b.fontBold);
+    EXPECT_EQ(a.fontItalic, b.fontItalic);
+    EXPECT_EQ(a.textRotation, b.textRotation);
+}
+
+void expectSameSnaps(const std::vector<SnapPoint>& a, const std::vector<SnapPoint>& b)
+{
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        SCOPED_TRACE("snap " + std::to_string(i));
+        EXPECT_EQ(a[i].type, b[i].type);
+        EXPECT_EQ(a[i].entityId, b[i].entityId);
+        EXPECT_DOUBLE_EQ(a[i].position.x, b[i].position.x);
+        EXPECT_DOUBLE_EQ(a[i].position.y, b[i].position.y);
+    }
+}
+
+}  // anonymous namespace
+
+// ---- Storage --------------------------------------------------------
+
+TEST(EntityStore, RoundTripsEveryEntityType)
+{
+    const std::vector<Entity> entities = makeEntities();
+    const EntityStore store(entities);
+    ASSERT_EQ(store.size(), entities.size());
+
+    const std::vector<Entity> restored = store.toEntities();
+    for (size_t i = 0; i < entities.size(); ++i) {
+        expectSameEntity(entities[i], restored[i]);
+    }
+}
+
+TEST(EntityStore, ViewsMatchEntities)
+{
+    const std::vector<Entity> entities = makeEntities();
+    const EntityStore store(entities);
+
+    for (size_t i = 0; i < entities.size(); ++i) {
+        const Entity& e = entities[i];
+        const EntityView v = store[i];
+        SCOPED_TRACE("entity " + std::to_string(e.id));
+        EXPECT_EQ(v.id, e.id);
+        EXPECT_EQ(v.type, e.type);
+        EXPECT_EQ(v.points.toVector().size(), e.points.size());
+        EXPECT_EQ(v.radius, e.radius);
+        EXPECT_EQ(v.text(), e.text);
+        EXPECT_EQ(v.fontBold(), e.fontBold);
+        EXPECT_EQ(v.textRotation(), e.textRotation);
+        EXPECT_EQ(store.indexOf(e.id), static_cast<int>(i));
+    }
+    EXPECT_EQ(store.indexOf(999), -1);
+}
+
+TEST(EntityStore, AssignReplacesContents)
+{
+    EntityStore store(makeEntities());
+    const std::vector<Entity> smaller = {createLine(42, {1, 2}, {3, 4})};
+    store.assign(smaller.begin(), smaller.end());
+
+    ASSERT_EQ(store.size(), 1u);
+    expectSameEntity(smaller[0], store.entity(0));
+    EXPECT_EQ(store.indexOf(42), 0);
+    EXPECT_EQ(store.indexOf(2), -1);
+    EXPECT_EQ(store.pointPool().size(), 2u);
+}
+
+TEST(EntityStore, SetPointMovesOnePoint)
+{
+    const std::vector<Entity> entities = makeEntities();
+    EntityStore store(entities);
+    const int line = store.indexOf(2);
+
+    store.setPoint(line, 1, {7, 8});
+    EXPECT_EQ(store.points(line)[1].x, 7);
+    EXPECT_EQ(store.points(line)[1].y, 8);
+    EXPECT_EQ(store.points(line)[0].x, entities[1].points[0].x);
+
+    // Out-of-range point indices are ignored
+    store.setPoint(line, 5, {0, 0});
+    EXPECT_EQ(store.points(line).size(), 2u);
+}
+
+TEST(EntityStore, SplineCurveIsCachedUntilPointsMove)
+{
+    const std::vector<Entity> entities = makeEntities();
+    EntityStore store(entities);
+    const int spline = store.indexOf(6);
+
+    // Repeated queries, and the source entity, share one fitted curve
+    const auto first = store[spline].splineCurve();
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(store[spline].splineCurve(), first);
+    EXPECT_EQ(entities[5].splineCurve(), first);
+    EXPECT_EQ(store[store.indexOf(2)].splineCurve(), nullptr);
+
+    // Moving a point refits the curve through the new point
+    store.setPoint(spline, 1, {-5, 20});
+    const auto moved = store[spline].splineCurve();
+    ASSERT_NE(moved, nullptr);
+    EXPECT_NE(moved, first);
+    EXPECT_EQ(store[spline].splineCurve(), moved);
+
+    Entity expected = entities[5];
+    expected.points[1] = {-5, 20};
+    const auto refit = expected.splineCurve();
+    for (double t : {0.0, 0.3, 0.5, 0.8, 1.0}) {
+        const double u = refit->firstParameter() + t * (refit->lastParameter() - refit->firstParameter());
+        EXPECT_DOUBLE_EQ(moved->point(u).x, refit->point(u).x);
+        EXPECT_DOUBLE_EQ(moved->point(u).y, refit->point(u).y);
+    }
+
+    // Refilling takes the curves from the entities again
+    store.assign(entities.begin(), entities.end());
+    EXPECT_EQ(store[spline].splineCurve(), first);
+}
+
+// ---- Snap equivalence -----------------------------------------------
+
+TEST(EntityStore, SnapPointsMatchVectorVersion)
+{
+    const std::vector<Entity> entities = makeEntities();
+    const EntityStore store(entities);
+
+    for (size_t i = 0; i < entities.size(); ++i) {
+        expectSameSnaps(collectSnapPoints(entities[i]), collectSnapPoints(store[i]));
+    }
+    for (int exclude : {-1, 4}) {
+        SCOPED_TRACE("exclude " + std::to_string(exclude));
+        expectSameSnaps(collectAllSnapPoints(entities, exclude),
+                        collectAllSnapPoints(store, exclude));
+        expectSameSnaps(collectIntersectionSnapPoints(entities, exclude),
+                        collectIntersectionSnapPoints(store, exclude));
+        expectSameSnaps(collectAxisCrossingSnapPoints(entities, exclude),
+                        collectAxisCrossingSnapPoints(store, exclude));
+    }
+}
+
+TEST(EntityStore, BestSnapMatchesVectorVersion)
+{
+    const std::vector<Entity> entities = makeEntities();
+    const EntityStore store(entities);
+
+    // Sweep the cursor over the sketch on a grid that is not aligned
+    // with any entity, so every snap type gets a chance to win
+    for (double y = -25.0; y <= 25.0; y += 1.7) {
+        for (double x = -25.0; x <= 25.0; x += 1.3) {
+            const Point2D pos{x, y};
+            const SnapResult a = findBestSnap(entities, pos, 2.0);
+            const SnapResult b = findBestSnap(store, pos, 2.0);
+            SCOPED_TRACE("at " + std::to_string(x) + ", " + std::to_string(y));
+            ASSERT_EQ(a.found, b.found);
+            if (!a.found) continue;
+            EXPECT_EQ(a.snap.type, b.snap.type);
+            EXPECT_EQ(a.snap.entityId, b.snap.entityId);
+            EXPECT_DOUBLE_EQ(a.snap.position.x, b.snap.position.x);
+            EXPECT_DOUBLE_EQ(a.snap.position.y, b.snap.position.y);
+
+            const SnapPoint na = findNearestOnPerimeter(entities, pos, 2.0);
+            const SnapPoint nb = findNearestOnPerimeter(store, pos, 2.0);
+            EXPECT_EQ(na.entityId, nb.entityId);
+            EXPECT_DOUBLE_EQ(na.position.x, nb.position.x);
+            EXPECT_DOUBLE_EQ(na.position.y, nb.position.y);
+        }
+    }
+}
+
+TEST(EntityStore, IntersectionsMatchVectorVersion)
+{
+    const std::vector<Entity> entities = makeEntities();
+    const EntityStore store(entities);
+
+    for (size_t i = 0; i < entities.size(); ++i) {
+        for (size_t j = i + 1; j < entities.size(); ++j) {
+            SCOPED_TRACE(std::to_string(entities[i].id) + " x " + std::to_string(entities[j].id));
+            expectSameIntersections(findIntersection(entities[i], entities[j]),
+                                    findIntersection(store[i], store[j]));
+            const auto a = computeEntityIntersectionPoints(entities[i], entities[j]);
+            const auto b = computeEntityIntersectionPoints(store[i], store[j]);
+            ASSERT_EQ(a.size(), b.size());
+            for (size_t k = 0; k < a.size(); ++k) {
+                EXPECT_DOUBLE_EQ(a[k].x, b[k].x);
+                EXPECT_DOUBLE_EQ(a[k].y, b[k].y);
+            }
+        }
+    }
+}
+
+// ---- Profile and operation equivalence ------------------------------
+
+TEST(EntityStore, ViewGeometryMatchesEntities)
+{
+    const std::vector<Entity> entities = makeEntities();
+    const EntityStore store(entities);
+
+    for (size_t i = 0; i < entities.size(); ++i) {
+        SCOPED_TRACE("entity " + std::to_string(entities[i].id));
+        const geometry::BoundingBox a = entities[i].boundingBox();
+        const geometry::BoundingBox b = store[i].boundingBox();
+        EXPECT_EQ(a.valid, b.valid);
+        EXPECT_DOUBLE_EQ(a.minX, b.minX);
+        EXPECT_DOUBLE_EQ(a.minY, b.minY);
+        EXPECT_DOUBLE_EQ(a.maxX, b.maxX);
+        EXPECT_DOUBLE_EQ(a.maxY, b.maxY);
+
+        const auto ea = entities[i].endpoints();
+        const auto eb = store[i].endpoints();
+        ASSERT_EQ(ea.size(), eb.size());
+        for (size_t k = 0; k < ea.size(); ++k) {
+            EXPECT_DOUBLE_EQ(ea[k].x, eb[k].x);
+            EXPECT_DOUBLE_EQ(ea[k].y, eb[k].y);
+        }
+        for (size_t j = 0; j < entities.size(); ++j) {
+            EXPECT_EQ(entitiesConnected(entities[i], entities[j]),
+                      entitiesConnected(store[i], store[j]));
+        }
+    }
+}
+
+TEST(EntityStore, ProfilesMatchVectorVersion)
+{
+    const std::vector<Entity> entities = makeProfileEntities();
+    const EntityStore store(entities);
+
+    for (bool excludeConstruction : {true, false}) {
+        SCOPED_TRACE(excludeConstruction ? "without construction" : "with construction");
+        ProfileDetectionOptions options;
+        options.excludeConstruction = excludeConstruction;
+
+        const std::vector<Profile> a = detectProfilesWithHoles(entities, options);
+        const std::vector<Profile> b = detectProfilesWithHoles(store, options);
+        expectSameProfiles(a, b);
+        expectSameProfiles(detectProfiles(entities, options), detectProfiles(store, options));
+
+        // Square, circle and rectangle.  The detector never closes a
+        // loop of two edges (the lens) or walks construction edges.
+        ASSERT_EQ(a.size(), 3u);
+        EXPECT_TRUE(a[0].isOuter);
+        EXPECT_FALSE(a[1].isOuter);
+        EXPECT_TRUE(a[2].isOuter);
+
+        const auto ra = detectProfileRegions(entities, options);
+        const auto rb = detectProfileRegions(store, options);
+        ASSERT_EQ(ra.size(), rb.size());
+        for (size_t i = 0; i < ra.size(); ++i) {
+            EXPECT_EQ(ra[i].outer.id, rb[i].outer.id);
+            EXPECT_EQ(ra[i].holes.size(), rb[i].holes.size());
+        }
+
+        for (const Profile& profile : a) {
+            SCOPED_TRACE("profile " + std::to_string(profile.id));
+            const auto pa = profileToPolygon(profile, entities, 16);
+            const auto pb = profileToPolygon(profile, store, 16);
+            ASSERT_EQ(pa.size(), pb.size());
+            for (size_t k = 0; k < pa.size(); ++k) {
+                EXPECT_DOUBLE_EQ(pa[k].x, pb[k].x);
+                EXPECT_DOUBLE_EQ(pa[k].y, pb[k].y);
+            }
+            EXPECT_DOUBLE_EQ(profileArea(profile, entities), profileArea(profile, store));
+            const Point2D ca = profileCentroid(profile, entities);
+            const Point2D cb = profileCentroid(profile, store);
+            EXPECT_DOUBLE_EQ(ca.x, cb.x);
+            EXPECT_DOUBLE_EQ(ca.y, cb.y);
+        }
+    }
+
+    const ConnectivityGraph ga = buildConnectivityGraph(entities);
+    const ConnectivityGraph gb = buildConnectivityGraph(store);
+    ASSERT_EQ(ga.nodes.size(), gb.nodes.size());
+    ASSERT_EQ(ga.edges.size(), gb.edges.size());
+    for (size_t i = 0; i < ga.edges.size(); ++i) {
+        EXPECT_EQ(ga.edges[i].entityId, gb.edges[i].entityId);
+        EXPECT_EQ(ga.edges[i].startNode, gb.edges[i].startNode);
+        EXPECT_EQ(ga.edges[i].endNode, gb.edges[i].endNode);
+    }
+    EXPECT_EQ(ga.adjacency, gb.adjacency);
+}
+
+TEST(EntityStore, OperationQueriesMatchVectorVersion)
+{
+    const std::vector<Entity> entities = makeEntities();
+    const EntityStore store(entities);
+
+    const std::vector<Intersection> all = findAllIntersections(entities);
+    EXPECT_FALSE(all.empty());
+    expectSameIntersections(all, findAllIntersections(store));
+    for (size_t i = 0; i < entities.size(); ++i) {
+        SCOPED_TRACE("entity " + std::to_string(entities[i].id));
+        expectSameIntersections(findIntersections(entities[i], entities),
+                                findIntersections(store[i], store));
+    }
+
+    const std::vector<Entity> loops = makeProfileEntities();
+    const EntityStore loopStore(loops);
+    for (const Entity& start : loops) {
+        SCOPED_TRACE("chain from " + std::to_string(start.id));
+        EXPECT_EQ(findConnectedChain(start.id, loops), findConnectedChain(start.id, loopStore));
+    }
+    EXPECT_EQ(findConnectedChain(1, loopStore).size(), 4u);
+    EXPECT_EQ(findConnectedChain(7, loopStore).size(), 2u);
+}
@@ -0,0 +1,374 @@
+// =====================================================================
+//  tests/test_group.cpp — Group hierarchy indexes
+// =====================================================================
+//
+//  Drives a GroupManager through random sequences of creating,
+//  nesting, moving, ungrouping and deleting groups and of adding and
+//  removing entities, alongside a naive model that keeps only parent
+//  links and member lists and answers every query by recursion.  After
+//  each step the manager's indexed answers (transitive entity sets,
+//  ancestry, depth, paths, common ancestors, cycle checks and entity
+//  owners) must match the model's.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/sketch/group.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::sketch;
+
+namespace {
+
+constexpr int kEntityCount = 60;
+
+// ---- Reference model ------------------------------------------------
+
+struct RefGroup {
+    int parent = -1;
+    std::vector<int> children;
+    std::set<int> entities;
+};
+
+/// Groups as plain parent links and member lists; every query recurses
+struct Reference {
+    std::vector<int> order;            ///< Group IDs in creation order
+    std::map<int, RefGroup> groups;
+
+    void create(int id)
+    {
+        order.push_back(id);
+        groups[id];
+    }
+
+    void detach(int id)
+    {
+        RefGroup& g = groups[id];
+        if (g.parent >= 0) {
+            std::vector<int>& siblings = groups[g.parent].children;
+            siblings.erase(std::find(siblings.begin(), siblings.end(), id));
+        }
+        g.parent = -1;
+    }
+
+    void nest(int child, int parent)
+    {
+        detach(child);
+        groups[child].parent = parent;
+        groups[parent].children.push_back(child);
+    }
+
+    void eraseSubtree(int id)
+    {
+        const std::vector<int> children = groups[id].children;
+        for (int child : children) eraseSubtree(child);
+        groups.erase(id);
+        order.erase(std::find(order.begin(), order.end(), id));
+    }
+
+    void remove(int id, bool withChildren)
+    {
+        const int parent = groups[id].parent;
+        detach(id);
+        if (withChildren) {
+            eraseSubtree(id);
+            return;
+        }
+        for (int child : groups[id].children) {
+            groups[child].parent = parent;
+            if (parent >= 0) groups[parent].children.push_back(child);
+        }
+        groups.erase(id);
+        order.erase(std::find(order.begin(), order.end(), id));
+    }
+
+    std::unordered_set<int> allEntities(int id) const
+    {
+        const RefGroup& g = groups.at(id);
+        std::unordered_set<int> result(g.entities.begin(), g.entities.end());
+        for (int child : g.children) {
+            const std::unordered_set<int> sub = allEntities(child);
+            result.insert(sub.begin(), sub.end());
+        }
+        return result;
+    }
+
+    bool isAncestor(int ancestor, int id) const
+    {
+        const int parent = groups.at(id).parent;
+        return parent >= 0 && (parent == ancestor || isAncestor(ancestor, parent));
+    }
+
+    int depth(int id) const
+    {
+        const int parent = groups.at(id).parent;
+        return parent < 0 ? 0 : 1 + depth(parent);
+    }
+
+    std::vector<int> path(int id) const
+    {
+        const int parent = groups.at(id).parent;
+        std::vector<int> result = parent < 0 ? std::vector<int>() : path(parent);
+        result.push_back(id);
+        return result;
+    }
+
+    int common(int a, int b) const
+    {
+        const std::vector<int> pa = path(a);
+        const std::vector<int> pb = path(b);
+        int result = -1;
+        for (size_t i = 0; i < std::min(pa.size(), pb.size()) && pa[i] == pb[i]; ++i) result = pa[i];
+        return result;
+    }
+
+    std::vector<int> owners(int entity) const
+    {
+        std::vector<int> result;
+        for (int id : order) {
+            if (groups.at(id).entities.count(entity)) result.push_back(id);
+        }
+        return result;
+    }
+};
+
+// ---- Comparison -----------------------------------------------------
+
+std::vector<int> sorted(std::vector<int> v)
+{
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+void expectSameStructure(const GroupManager& m, const Reference& ref)
+{
+    std::vector<int> ids;
+    for (const Group& g : m.groups()) ids.push_back(g.id);
+    ASSERT_EQ(ids, ref.order);
+
+    for (const Group& g : m.groups()) {
+        SCOPED_TRACE("group " + std::to_string(g.id));
+        const RefGroup& r = ref.groups.at(g.id);
+        EXPECT_EQ(g.parentGroupId, r.parent);
+        EXPECT_EQ(sorted(g.childGroupIds), sorted(r.children));
+        EXPECT_EQ(sorted(g.entityIds), std::vector<int>(r.entities.begin(), r.entities.end()));
+    }
+}
+
+void expectSameQueries(const GroupManager& m, const Reference& ref, std::mt19937& rng)
+{
+    const std::vector<int>& ids = ref.order;
+    for (int id : ids) {
+        SCOPED_TRACE("group " + std::to_string(id));
+        EXPECT_EQ(m.allEntityIds(id), ref.allEntities(id));
+        EXPECT_EQ(m.groupDepth(id), ref.depth(id));
+        EXPECT_EQ(groupDepth(m, id), ref.depth(id));
+        EXPECT_EQ(m.groupPath(id), ref.path(id));
+        for (int other : ids) {
+            ASSERT_EQ(m.isAncestorOf(id, other), ref.isAncestor(id, other)) << "ancestor of " << other;
+        }
+    }
+
+    std::vector<int> top;
+    for (int id : ids) {
+        if (ref.groups.at(id).parent < 0) top.push_back(id);
+    }
+    EXPECT_EQ(m.topLevelGroupIds(), top);
+
+    for (int entity = 1; entity <= kEntityCount; ++entity) {
+        EXPECT_EQ(m.groupsContainingEntity(entity), ref.owners(entity)) << "entity " << entity;
+    }
+
+    if (ids.empty()) return;
+    std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+    for (int k = 0; k < 20; ++k) {
+        const int a = ids[pick(rng)];
+        const int b = ids[pick(rng)];
+        EXPECT_EQ(m.commonAncestor(a, b), ref.common(a, b)) << a << ", " << b;
+        EXPECT_EQ(commonAncestor(m, a, b), ref.common(a, b)) << a << ", " << b;
+        EXPECT_EQ(m.wouldCreateCycle(a, b), a != b && ref.isAncestor(a, b)) << a << " under " << b;
+    }
+}
+
+/// One random edit applied to both; queries in between are left to
+/// the caller so some edits land on a stale hierarchy numbering
+void randomEdit(GroupManager& m, Reference& ref, std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> op(0, 99);
+    std::uniform_int_distribution<int> entity(1, kEntityCount);
+    const int roll = op(rng);
+    const std::vector<int>& ids = ref.order;
+    auto anyGroup = [&] { return ids[rng() % ids.size()]; };
+
+    if (ids.size() < 3 || roll < 15) {
+        ref.create(m.createGroup());
+    } else if (roll < 40) {
+        const int group = anyGroup();
+        const int e = entity(rng);
+        m.addEntityToGroup(e, group);
+        ref.groups[group].entities.insert(e);
+    } else if (roll < 50) {
+        const int group = anyGroup();
+        const int e = entity(rng);
+        m.removeEntityFromGroup(e, group);
+        ref.groups[group].entities.erase(e);
+    } else if (roll < 80) {
+        // Nest or move; a cycle must be refused and change nothing
+        const int child = anyGroup();
+        const int parent = anyGroup();
+        const bool allowed = child != parent && !ref.isAncestor(child, parent);
+        EXPECT_EQ(m.addGroupToGroup(child, parent), allowed) << child << " under " << parent;
+        if (allowed) ref.nest(child, parent);
+    } else if (roll < 87) {
+        const int group = anyGroup();
+        m.ungroupFromParent(group);
+        ref.detach(group);
+    } else {
+        const int group = anyGroup();
+        const bool withChildren = roll >= 94;
+        m.deleteGroup(group, withChildren);
+        ref.remove(group, withChildren);
+    }
+}
+
+}  // anonymous namespace
+
+// ---- Random sequences -----------------------------------------------
+
+TEST(GroupManager, RandomEditsMatchReference)
+{
+    for (unsigned seed = 1; seed <= 20; ++seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        std::mt19937 rng(seed);
+        GroupManager m;
+        Reference ref;
+        for (int step = 0; step < 300; ++step) {
+            randomEdit(m, ref, rng);
+            ASSERT_NO_FATAL_FAILURE(expectSameStructure(m, ref)) << "step " << step;
+            // Query only now and then so edits also run against stale
+            // hierarchy numbering and partly invalidated closures
+            if (rng() % 3 == 0) {
+                ASSERT_NO_FATAL_FAILURE(expectSameQueries(m, ref, rng)) << "step " << step;
+            }
+        }
+        expectSameQueries(m, ref, rng);
+    }
+}
+
+TEST(GroupManager, EntityClosureTracksEdits)
+{
+    // A cached closure must not survive a change deep in its subtree
+    GroupManager m;
+    std::vector<int> chain{m.createGroup()};
+    for (int i = 1; i < 8; ++i) {
+        chain.push_back(m.createGroup());
+        ASSERT_TRUE(m.addGroupToGroup(chain[i], chain[i - 1]));
+    }
+    m.addEntityToGroup(1, chain.back());
+    EXPECT_EQ(m.entityClosure(chain[0]), std::unordered_set<int>{1});
+
+    m.addEntityToGroup(2, chain[5]);
+    EXPECT_EQ(m.entityClosure(chain[0]), (std::unordered_set<int>{1, 2}));
+
+    m.ungroupFromParent(chain[3]);
+    EXPECT_TRUE(m.entityClosure(chain[0]).empty());
+    EXPECT_EQ(m.entityClosure(chain[3]), (std::unordered_set<int>{1, 2}));
+
+    m.deleteGroup(chain[5]);
+    EXPECT_EQ(m.entityClosure(chain[3]), std::unordered_set<int>{1});
+    EXPECT_EQ(m.groupById(chain[6])->parentGroupId, chain[4]);
+}
+
+// ---- Deletion -------------------------------------------------------
+
+TEST(GroupManager, RecursiveDeleteRemovesWholeSubtree)
+{
+    // Deleting with children used to skip every other child, as it
+    // erased from the child list it was iterating
+    GroupManager m;
+    const int keep = m.createGroup("keep");
+    const int root = m.createGroup("root");
+    for (int i = 0; i < 6; ++i) {
+        const int child = m.createGroup();
+        ASSERT_TRUE(m.addGroupToGroup(child, root));
+        m.addEntityToGroup(100 + i, child);
+        for (int j = 0; j < 4; ++j) {
+            const int grandchild = m.createGroup();
+            ASSERT_TRUE(m.addGroupToGroup(grandchild, child));
+            m.addEntityToGroup(200 + 10 * i + j, grandchild);
+        }
+    }
+    m.addEntityToGroup(100, keep);
+
+    m.deleteGroup(root, true);
+    ASSERT_EQ(m.groups().size(), 1u);
+    EXPECT_EQ(m.groups()[0].id, keep);
+    EXPECT_EQ(m.groupsContainingEntity(100), std::vector<int>{keep});
+    EXPECT_TRUE(m.groupsContainingEntity(101).empty());
+    EXPECT_TRUE(m.groupsContainingEntity(253).empty());
+}
+
+TEST(GroupManager, DeleteMovesChildrenToParent)
+{
+    GroupManager m;
+    const int top = m.createGroup();
+    const int middle = m.createGroup();
+    const int a = m.createGroup();
+    const int b = m.createGroup();
+    ASSERT_TRUE(m.addGroupToGroup(middle, top));
+    ASSERT_TRUE(m.addGroupToGroup(a, middle));
+    ASSERT_TRUE(m.addGroupToGroup(b, middle));
+    m.addEntityToGroup(1, a);
+    m.addEntityToGroup(2, middle);
+    EXPECT_EQ(m.groupDepth(b), 2);
+
+    m.deleteGroup(middle);
+    EXPECT_EQ(sorted(m.groupById(top)->childGroupIds), sorted({a, b}));
+    EXPECT_EQ(m.groupDepth(b), 1);
+    EXPECT_EQ(m.allEntityIds(top), std::unordered_set<int>{1});
+
+    // Without a parent they become top-level
+    m.deleteGroup(top);
+    EXPECT_EQ(m.topLevelGroupIds(), (std::vector<int>{a, b}));
+    EXPECT_EQ(m.commonAncestor(a, b), -1);
+}
+
+// ---- Deep hierarchies -----------------------------------------------
+
+TEST(GroupManager, DeepChainHasNoRecursionLimit)
+{
+    const int depth = 20000;
+    GroupManager m;
+    std::vector<int> chain;
+    for (int i = 0; i < depth; ++i) {
+        chain.push_back(m.createGroup());
+        if (i > 0) m.addEntityToGroup(i, chain[i]);
+    }
+    // Bottom-up, so each parent is still top-level when it is nested
+    // into and neither the cycle check nor invalidation walks far
+    for (int i = depth - 1; i > 0; --i) {
+        ASSERT_TRUE(m.addGroupToGroup(chain[i], chain[i - 1]));
+    }
+
+    EXPECT_EQ(m.groupDepth(chain.back()), depth - 1);
+    EXPECT_EQ(m.allEntityIds(chain[0]).size(), static_cast<size_t>(depth - 1));
+    EXPECT_TRUE(m.isAncestorOf(chain[0], chain.back()));
+    EXPECT_FALSE(m.isAncestorOf(chain.back(), chain[0]));
+    EXPECT_EQ(m.commonAncestor(chain[depth / 2], chain[depth - 3]), chain[depth / 2]);
+    EXPECT_TRUE(m.wouldCreateCycle(chain[10], chain[depth - 10]));
+    EXPECT_EQ(m.groupPath(chain[100]), std::vector<int>(chain.begin(), chain.begin() + 101));
+
+    m.deleteGroup(chain[1], true);
+    EXPECT_EQ(m.groups().size(), 1u);
+}
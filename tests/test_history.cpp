@@ -0,0 +1,318 @@
+// =====================================================================
+//  tests/test_history.cpp — Project-level undo/redo
+// =====================================================================
+//
+//  Replays the operations the full-mode window records (extrude,
+//  suppress, delete, timeline move) on model states built from real
+//  OCCT bodies, then checks that undo and redo restore every step
+//  exactly, that each step retains only what it changed, and that
+//  the memory budget and step limit trim the history.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/history.h>
+#include <hobbycad/memory.h>
+
+#include <gtest/gtest.h>
+
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <gp.hxx>
+#include <gp_Ax2.hxx>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::history;
+
+namespace {
+
+/// Slack for step overhead: handles, feature records and text
+constexpr std::int64_t kOverheadSlack = 16 * 1024;
+
+/// A meshed cylinder, so the body carries tessellation like a
+/// displayed one
+TopoDS_Shape makeBody(double offset, double radius = 5.0)
+{
+    TopoDS_Shape body =
+        BRepPrimAPI_MakeCylinder(gp_Ax2(gp_Pnt(offset, 0, 0), gp::DZ()), radius, 10.0).Shape();
+    BRepMesh_IncrementalMesh(body, 0.01);
+    return body;
+}
+
+std::shared_ptr<const SketchData> makeSketch(const std::string& name, int lines)
+{
+    auto sketch = std::make_shared<SketchData>();
+    sketch->name = name;
+    for (int i = 0; i < lines; ++i) {
+        sketch->entities.push_back(sketch::createLine(i + 1, {0.0, i * 1.0}, {10.0, i * 1.0}));
+    }
+    return sketch;
+}
+
+FeatureData makeFeature(int id, FeatureType type, const std::string& name)
+{
+    FeatureData feature;
+    feature.id = id;
+    feature.type = type;
+    feature.name = name;
+    return feature;
+}
+
+/// A project of sketch + extrude pairs, one body per extrude
+ModelState makeProject(int bodies)
+{
+    ModelState state;
+    for (int i = 0; i < bodies; ++i) {
+        const int sketchId = state.nextFeatureId++;
+        const int extrudeId = state.nextFeatureId++;
+        state.bodies.push_back(makeBody(i * 20.0));
+        state.sketches.push_back({sketchId, makeSketch("Sketch" + std::to_string(i + 1), 4)});
+        state.features.push_back(makeFeature(sketchId, FeatureType::Sketch, "Sketch"));
+        state.features.push_back(makeFeature(extrudeId, FeatureType::Extrude, "Extrude"));
+    }
+    return state;
+}
+
+std::int64_t bodyBytes(const TopoDS_Shape& body)
+{
+    const memory::ShapeFootprint fp = memory::shapeFootprint(body);
+    return fp.geometryBytes + fp.tessellationBytes;
+}
+
+void expectSameState(const ModelState& a, const ModelState& b)
+{
+    ASSERT_EQ(a.bodies.size(), b.bodies.size());
+    for (size_t i = 0; i < a.bodies.size(); ++i) {
+        EXPECT_TRUE(a.bodies[i].IsSame(b.bodies[i])) << "body " << i;
+    }
+    ASSERT_EQ(a.sketches.size(), b.sketches.size());
+    for (size_t i = 0; i < a.sketches.size(); ++i) {
+        EXPECT_EQ(a.sketches[i].featureId, b.sketches[i].featureId);
+        EXPECT_EQ(a.sketches[i].data, b.sketches[i].data) << "sketch " << i;
+    }
+    ASSERT_EQ(a.features.size(), b.features.size());
+    for (size_t i = 0; i < a.features.size(); ++i) {
+        EXPECT_EQ(a.features[i].id, b.features[i].id) << "feature " << i;
+        EXPECT_EQ(a.features[i].suppressed, b.features[i].suppressed) << "feature " << i;
+    }
+    EXPECT_EQ(a.nextFeatureId, b.nextFeatureId);
+}
+
+/// The operations FullModeWindow records, applied to a state
+struct Operation {
+    std::string description;
+    ModelState state;
+};
+
+std::vector<Operation> replayOperations(const ModelState& start)
+{
+    std::vector<Operation> ops;
+    ModelState s = start;
+
+    // Extrude: a new sketch, feature and body
+    {
+        const int sketchId = s.nextFeatureId++;
+        const int extrudeId = s.nextFeatureId++;
+        s.sketches.push_back({sketchId, makeSketch("Sketch new", 8)});
+        s.features.push_back(makeFeature(sketchId, FeatureType::Sketch, "Sketch"));
+        s.features.push_back(makeFeature(extrudeId, FeatureType::Extrude, "Extrude"));
+        s.bodies.push_back(makeBody(-40.0, 7.0));
+        ops.push_back({"Extrude", s});
+    }
+
+    // Sketch edit: one sketch gets a new version, its body is rebuilt
+    {
+        auto edited = std::make_shared<SketchData>(*s.sketches[0].data);
+        edited->entities.push_back(sketch::createLine(100, {0, 0}, {5, 5}));
+        s.sketches[0].data = edited;
+        s.bodies[0] = makeBody(0.0, 6.0);
+        ops.push_back({"Edit Sketch", s});
+    }
+
+    // Suppress: the extrude is flagged and its body leaves the model
+    {
+        s.features[3].suppressed = true;
+        s.bodies.erase(s.bodies.begin() + 1);
+        ops.push_back({"Suppress Extrude", s});
+    }
+
+    // Delete: a sketch and its feature go away
+    {
+        const int id = s.sketches[2].featureId;
+        s.sketches.erase(s.sketches.begin() + 2);
+        s.features.erase(std::find_if(s.features.begin(), s.features.end(),
+                                      [id](const FeatureData& f) { return f.id == id; }));
+        ops.push_back({"Delete Sketch", s});
+    }
+
+    // Move: a feature changes place in the timeline
+    {
+        std::rotate(s.features.begin(), s.features.begin() + 1, s.features.begin() + 3);
+        ops.push_back({"Move Feature", s});
+    }
+    return ops;
+}
+
+}  // anonymous namespace
+
+// ---- Round trip -----------------------------------------------------
+
+TEST(ProjectHistory, UndoRedoRestoresEveryStep)
+{
+    const ModelState start = makeProject(6);
+    const std::vector<Operation> ops = replayOperations(start);
+
+    ProjectHistory history(0);
+    history.reset(start);
+    EXPECT_TRUE(history.isClean());
+    for (const Operation& op : ops) history.record(op.description, op.state);
+    EXPECT_EQ(history.undoLevels(), static_cast<int>(ops.size()));
+    EXPECT_FALSE(history.isClean());
+
+    for (int k = static_cast<int>(ops.size()) - 1; k >= 0; --k) {
+        SCOPED_TRACE("undo " + ops[k].description);
+        EXPECT_EQ(history.undoDescription(), ops[k].description);
+        const ModelState* state = history.undo();
+        ASSERT_NE(state, nullptr);
+        expectSameState(*state, k > 0 ? ops[k - 1].state : start);
+    }
+    EXPECT_EQ(history.undo(), nullptr);
+    EXPECT_TRUE(history.isClean());
+
+    for (size_t k = 0; k < ops.size(); ++k) {
+        SCOPED_TRACE("redo " + ops[k].description);
+        EXPECT_EQ(history.redoDescription(), ops[k].description);
+        const ModelState* state = history.redo();
+        ASSERT_NE(state, nullptr);
+        expectSameState(*state, ops[k].state);
+    }
+    EXPECT_EQ(history.redo(), nullptr);
+}
+
+TEST(ProjectHistory, RecordAfterUndoDropsRedo)
+{
+    const ModelState start = makeProject(3);
+    const std::vector<Operation> ops = replayOperations(start);
+
+    ProjectHistory history(0);
+    history.reset(start);
+    for (const Operation& op : ops) history.record(op.description, op.state);
+    history.undo();
+    history.undo();
+    EXPECT_EQ(history.redoLevels(), 2);
+
+    history.record("Extrude", ops[0].state);
+    EXPECT_FALSE(history.canRedo());
+    expectSameState(history.current(), ops[0].state);
+    EXPECT_EQ(history.undoLevels(), static_cast<int>(ops.size()) - 1);
+}
+
+// ---- Memory ---------------------------------------------------------
+
+TEST(ProjectHistory, StepRetainsOnlyWhatChanged)
+{
+    const int bodies = 20;
+    ModelState state = makeProject(bodies);
+
+    ProjectHistory history(0);
+    history.reset(state);
+    const HistoryMemory initial = history.memoryUsage();
+    EXPECT_EQ(initial.retainedBytes, 0);
+    EXPECT_EQ(initial.bodies, bodies);
+    EXPECT_GT(initial.liveBytes, 0);
+
+    // Each step rebuilds one body; the old one is all undo has to keep
+    std::int64_t retained = 0;
+    for (int k = 0; k < 10; ++k) {
+        SCOPED_TRACE("step " + std::to_string(k));
+        const std::int64_t replaced = bodyBytes(state.bodies[k]);
+        state.bodies[k] = makeBody(k * 20.0, 5.5);
+        history.record("Extrude", state);
+
+        const HistoryMemory usage = history.memoryUsage();
+        const std::int64_t step = usage.retainedBytes - retained;
+        EXPECT_GE(step, replaced);
+        EXPECT_LE(step, replaced + kOverheadSlack);
+        EXPECT_LT(step, initial.liveBytes / 5);
+        EXPECT_EQ(usage.bodies, bodies + k + 1);
+        EXPECT_EQ(usage.sketches, bodies);
+        retained = usage.retainedBytes;
+    }
+}
+
+TEST(ProjectHistory, ChargesRetainedBytesToUndoHistory)
+{
+    const std::int64_t before = memory::tagStats(memory::Tag::UndoHistory).bytes;
+    {
+        ModelState state = makeProject(5);
+        ProjectHistory history(0);
+        history.reset(state);
+        for (int k = 0; k < 5; ++k) {
+            state.bodies[k] = makeBody(k * 20.0, 4.5);
+            history.record("Extrude", state);
+            EXPECT_EQ(memory::tagStats(memory::Tag::UndoHistory).bytes - before,
+                      history.memoryUsage().retainedBytes);
+        }
+
+        // Undo moves bytes between live and retained, not in or out
+        history.undo();
+        EXPECT_EQ(memory::tagStats(memory::Tag::UndoHistory).bytes - before,
+                  history.memoryUsage().retainedBytes);
+
+        history.reset(state);
+        EXPECT_EQ(history.memoryUsage().retainedBytes, 0);
+    }
+    EXPECT_EQ(memory::tagStats(memory::Tag::UndoHistory).bytes, before);
+}
+
+TEST(ProjectHistory, BudgetDropsOldestStepsFirst)
+{
+    ModelState state = makeProject(8);
+    std::vector<ModelState> states{state};
+
+    ProjectHistory history(0);
+    history.reset(state);
+    for (int k = 0; k < 8; ++k) {
+        state.bodies[k] = makeBody(k * 20.0, 4.5);
+        history.record("Extrude", state);
+        states.push_back(state);
+    }
+
+    // A budget of about three steps keeps the newest three
+    const std::int64_t perStep = history.memoryUsage().retainedBytes / 8;
+    history.setMemoryBudget(perStep * 3 + perStep / 2);
+    EXPECT_EQ(history.undoLevels(), 3);
+    EXPECT_LE(history.memoryUsage().retainedBytes, history.memoryBudget());
+    for (int k = 0; k < 3; ++k) {
+        const ModelState* undone = history.undo();
+        ASSERT_NE(undone, nullptr);
+        expectSameState(*undone, states[7 - k]);
+    }
+    EXPECT_FALSE(history.canUndo());
+
+    // With the cursor at the oldest step, a lower budget trims redo
+    history.setMemoryBudget(perStep + perStep / 2);
+    EXPECT_EQ(history.redoLevels(), 1);
+    EXPECT_LE(history.memoryUsage().retainedBytes, history.memoryBudget());
+}
+
+TEST(ProjectHistory, StepLimitDropsOldestSteps)
+{
+    ModelState state = makeProject(4);
+    ProjectHistory history(0, 2);
+    history.reset(state);
+    for (int k = 0; k < 4; ++k) {
+        state.bodies[k] = makeBody(k * 20.0, 4.5);
+        history.record("Extrude", state);
+    }
+    EXPECT_EQ(history.undoLevels(), 2);
+    EXPECT_EQ(history.memoryUsage().bodies, 4 + 2);
+    EXPECT_FALSE(history.isClean());
+}
@@ -0,0 +1,271 @@
+// =====================================================================
+//  tests/test_lint.cpp — Sketch lint and batch fixes
+// =====================================================================
+//
+//  Builds clean sketches of squares, circles, arcs and polygons, then
+//  injects a known number of exact duplicates, near duplicates,
+//  collinear overlaps and near-miss endpoint gaps, each into a
+//  different shape.  lintSketch() must report exactly what was
+//  injected, fixLint() must fix exactly that, and linting the fixed
+//  sketch must come back clean.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/sketch/lint.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::sketch;
+
+namespace {
+
+/// Shapes are laid out on a grid this far apart, far beyond any tolerance
+constexpr double kPitch = 10.0;
+
+/// What to inject into a clean sketch
+struct Defects {
+    int duplicates = 0;
+    int nearDuplicates = 0;
+    int overlaps = 0;
+    int gaps = 0;
+};
+
+struct Sketch {
+    std::vector<Entity> entities;
+    std::vector<std::vector<size_t>> shapes;  ///< Entity indices of each shape
+    std::vector<size_t> squares;              ///< Shapes that are line squares
+    int nextId = 1;
+};
+
+/// A clean sketch of count shapes: closed line squares, circles, arcs
+/// and polygons in turn
+Sketch makeSketch(int count)
+{
+    Sketch s;
+    for (int i = 0; i < count; ++i) {
+        const Point2D o((i % 20) * kPitch, (i / 20) * kPitch);
+        std::vector<size_t> shape;
+        switch (i % 4) {
+        case 0: {
+            const Point2D c[4] = {o, o + Point2D(4, 0), o + Point2D(4, 4), o + Point2D(0, 4)};
+            for (int k = 0; k < 4; ++k) {
+                shape.push_back(s.entities.size());
+                s.entities.push_back(createLine(s.nextId++, c[k], c[(k + 1) % 4]));
+            }
+            s.squares.push_back(s.shapes.size());
+            break;
+        }
+        case 1:
+            shape.push_back(s.entities.size());
+            s.entities.push_back(createCircle(s.nextId++, o + Point2D(2, 2), 2.0));
+            break;
+        case 2:
+            shape.push_back(s.entities.size());
+            s.entities.push_back(createArc(s.nextId++, o + Point2D(2, 2), 2.0, 30.0, 200.0));
+            break;
+        default:
+            shape.push_back(s.entities.size());
+            s.entities.push_back(createPolygon(s.nextId++, o + Point2D(2, 2), 2.0, 6));
+            break;
+        }
+        s.shapes.push_back(shape);
+    }
+    return s;
+}
+
+Entity copyOf(Sketch& s, size_t index)
+{
+    Entity e = s.entities[index];
+    e.id = s.nextId++;
+    return e;
+}
+
+/// Inject the defects, each into a shape no other defect touches
+void inject(Sketch& s, const Defects& d, std::mt19937& rng)
+{
+    std::vector<size_t> squares = s.squares;
+    std::shuffle(squares.begin(), squares.end(), rng);
+    ASSERT_LE(static_cast<size_t>(d.overlaps + d.gaps), squares.size());
+
+    // Squares for overlaps and gaps; duplicates go anywhere else
+    std::vector<size_t> others;
+    for (size_t i = 0; i < s.shapes.size(); ++i) {
+        if (std::find(squares.begin(), squares.begin() + d.overlaps + d.gaps, i) ==
+            squares.begin() + d.overlaps + d.gaps) {
+            others.push_back(i);
+        }
+    }
+    std::shuffle(others.begin(), others.end(), rng);
+    ASSERT_LE(static_cast<size_t>(d.duplicates + d.nearDuplicates), others.size());
+
+    std::uniform_int_distribution<int> side(0, 3);
+    std::vector<Entity> added;
+    for (int k = 0; k < d.duplicates + d.nearDuplicates; ++k) {
+        const std::vector<size_t>& shape = s.shapes[others[k]];
+        Entity e = copyOf(s, shape[rng() % shape.size()]);
+        if (e.type == EntityType::Line && rng() % 2) std::swap(e.points[0], e.points[1]);
+        if (k >= d.duplicates) {
+            // Inside the near tolerance, outside the exact one
+            for (Point2D& p : e.points) p = p + Point2D(3e-4, -2e-4);
+        }
+        added.push_back(e);
+    }
+
+    for (int k = 0; k < d.overlaps; ++k) {
+        // The middle half of one side, drawn again
+        const Entity& edge = s.entities[s.shapes[squares[k]][side(rng)]];
+        const Point2D a = edge.points[0];
+        const Point2D b = edge.points[1];
+        Entity e = createLine(s.nextId++, a + (b - a) * 0.25, a + (b - a) * 0.75);
+        added.push_back(e);
+    }
+
+    for (int k = 0; k < d.gaps; ++k) {
+        // One corner pulled apart, well within the gap tolerance
+        Entity& edge = s.entities[s.shapes[squares[d.overlaps + k]][side(rng)]];
+        edge.points[1] = edge.points[1] + Point2D(0.004, 0.003);
+    }
+
+    // Appended in random order; the originals still come first
+    std::shuffle(added.begin(), added.end(), rng);
+    s.entities.insert(s.entities.end(), added.begin(), added.end());
+}
+
+int countIssues(const LintReport& report, LintIssueType type)
+{
+    return static_cast<int>(std::count_if(report.issues.begin(), report.issues.end(),
+                                          [&](const LintIssue& i) { return i.type == type; }));
+}
+
+}  // anonymous namespace
+
+// ---- Reports --------------------------------------------------------
+
+TEST(Lint, CleanSketchIsClean)
+{
+    const Sketch s = makeSketch(200);
+    const LintReport report = lintSketch(s.entities);
+    EXPECT_TRUE(report.clean());
+    EXPECT_EQ(report.duplicates + report.nearDuplicates + report.overlaps + report.gaps, 0);
+}
+
+TEST(Lint, ReportsExactlyWhatWasInjected)
+{
+    for (unsigned seed = 1; seed <= 10; ++seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        std::mt19937 rng(seed);
+        Defects d;
+        d.duplicates = 5 + static_cast<int>(rng() % 20);
+        d.nearDuplicates = 3 + static_cast<int>(rng() % 15);
+        d.overlaps = 2 + static_cast<int>(rng() % 12);
+        d.gaps = 2 + static_cast<int>(rng() % 12);
+        Sketch s = makeSketch(240);
+        inject(s, d, rng);
+
+        const LintReport report = lintSketch(s.entities);
+        EXPECT_EQ(report.duplicates, d.duplicates);
+        EXPECT_EQ(report.nearDuplicates, d.nearDuplicates);
+        EXPECT_EQ(report.overlaps, d.overlaps);
+        EXPECT_EQ(report.gaps, d.gaps);
+
+        // Each defect sits in its own shape, so each is its own issue
+        EXPECT_EQ(countIssues(report, LintIssueType::DuplicateEntity), d.duplicates);
+        EXPECT_EQ(countIssues(report, LintIssueType::NearDuplicateEntity), d.nearDuplicates);
+        EXPECT_EQ(countIssues(report, LintIssueType::CollinearOverlap), d.overlaps);
+        EXPECT_EQ(countIssues(report, LintIssueType::EndpointGap), d.gaps);
+        EXPECT_EQ(static_cast<int>(report.issues.size()),
+                  d.duplicates + d.nearDuplicates + d.overlaps + d.gaps);
+
+        for (const LintIssue& issue : report.issues) {
+            EXPECT_EQ(issue.entityIds.size(), 2u);
+            EXPECT_FALSE(lintIssueMessage(issue, s.entities).empty());
+            if (issue.type == LintIssueType::NearDuplicateEntity) {
+                EXPECT_NEAR(issue.size, std::hypot(3e-4, 2e-4), 1e-9);
+            } else if (issue.type == LintIssueType::CollinearOverlap) {
+                EXPECT_NEAR(issue.size, 2.0, 1e-9);
+            } else if (issue.type == LintIssueType::EndpointGap) {
+                EXPECT_NEAR(issue.size, 0.005, 1e-9);
+            }
+        }
+    }
+}
+
+TEST(Lint, StackedCopiesAreOneIssue)
+{
+    // N copies of one entity are N duplicates of the first
+    Sketch s = makeSketch(8);
+    const int copies = 7;
+    for (int k = 0; k < copies; ++k) s.entities.push_back(copyOf(s, 1));
+    const LintReport report = lintSketch(s.entities);
+    EXPECT_EQ(report.duplicates, copies);
+    ASSERT_EQ(report.issues.size(), 1u);
+    EXPECT_EQ(report.issues[0].entityIds.size(), static_cast<size_t>(copies + 1));
+    EXPECT_EQ(report.issues[0].entityIds.front(), s.entities[1].id);
+}
+
+// ---- Fixes ----------------------------------------------------------
+
+TEST(Lint, FixLeavesCleanSketch)
+{
+    for (unsigned seed = 1; seed <= 10; ++seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        std::mt19937 rng(seed + 100);
+        Defects d;
+        d.duplicates = 1 + static_cast<int>(rng() % 25);
+        d.nearDuplicates = 1 + static_cast<int>(rng() % 25);
+        d.overlaps = 1 + static_cast<int>(rng() % 15);
+        d.gaps = 1 + static_cast<int>(rng() % 15);
+        Sketch s = makeSketch(240);
+        const size_t cleanCount = s.entities.size();
+        inject(s, d, rng);
+
+        const LintFixResult fixed = fixLint(s.entities, {});
+        ASSERT_TRUE(fixed.success) << fixed.errorMessage;
+        EXPECT_EQ(fixed.duplicatesRemoved, d.duplicates + d.nearDuplicates);
+        EXPECT_EQ(fixed.linesMerged, d.overlaps);
+        EXPECT_EQ(fixed.endpointsWelded, d.gaps);
+        EXPECT_EQ(fixed.removedIds.size(),
+                  static_cast<size_t>(d.duplicates + d.nearDuplicates + d.overlaps));
+        EXPECT_EQ(fixed.entities.size(), cleanCount);
+
+        const LintReport again = lintSketch(fixed.entities);
+        EXPECT_TRUE(again.clean()) << again.issues.size() << " issues left, first: "
+                                   << lintIssueMessage(again.issues.front(), fixed.entities);
+    }
+}
+
+TEST(Lint, FixHandsConstraintsToKeptEntity)
+{
+    Sketch s = makeSketch(4);
+    const int circleId = s.entities[4].id;
+    const Entity copy = copyOf(s, 4);
+    s.entities.push_back(copy);
+
+    Constraint radius;
+    radius.id = 1;
+    radius.type = ConstraintType::Radius;
+    radius.entityIds = {copy.id};
+    radius.value = 2.0;
+    Constraint equal;
+    equal.id = 2;
+    equal.type = ConstraintType::Equal;
+    equal.entityIds = {circleId, copy.id};
+
+    const LintFixResult fixed = fixLint(s.entities, {radius, equal});
+    ASSERT_TRUE(fixed.success);
+    EXPECT_EQ(fixed.removedIds, std::vector<int>{copy.id});
+
+    // The radius moves to the kept circle; equal-to-itself is dropped
+    ASSERT_EQ(fixed.constraints.size(), 1u);
+    EXPECT_EQ(fixed.constraints[0].id, 1);
+    EXPECT_EQ(fixed.constraints[0].entityIds, std::vector<int>{circleId});
+}
@@ -0,0 +1,101 @@
+// =====================================================================
+//  tests/test_memory_hooks.cpp — Global allocation hooks
+// =====================================================================
+//
+//  Checks the operator new/delete replacements installed with
+//  HOBBYCAD_MEMORY_HOOKS: heap accounting, oversized requests that
+//  would overflow the size header, and the new_handler loop for both
+//  throwing and non-throwing new.  Skipped when the library was built
+//  without hooks.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/memory.h>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+using namespace hobbycad;
+
+namespace {
+
+/// Larger than any allocator can satisfy, and close enough to
+/// SIZE_MAX that adding the size header would wrap around.  Volatile
+/// so the compiler does not reject the requests at build time.
+volatile std::size_t g_hugeSize = std::numeric_limits<std::size_t>::max() - 1;
+
+int g_handlerCalls = 0;
+
+/// Gives up on the third call, as a handler with nothing left to free
+void countingHandler()
+{
+    if (++g_handlerCalls >= 3) std::set_new_handler(nullptr);
+}
+
+class MemoryHooksTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        if (!memory::heapStats().enabled) {
+            GTEST_SKIP() << "Built without HOBBYCAD_MEMORY_HOOKS";
+        }
+        g_handlerCalls = 0;
+    }
+
+    void TearDown() override { std::set_new_handler(nullptr); }
+};
+
+}  // anonymous namespace
+
+TEST_F(MemoryHooksTest, CountsAllocationsAndFrees)
+{
+    const memory::HeapStats before = memory::heapStats();
+    void* p = ::operator new(1000);
+    const memory::HeapStats during = memory::heapStats();
+    ::operator delete(p);
+    const memory::HeapStats after = memory::heapStats();
+
+    EXPECT_GE(during.bytes - before.bytes, 1000);
+    EXPECT_GE(during.allocations - before.allocations, 1);
+    EXPECT_GE(during.peakBytes, during.bytes);
+    EXPECT_GE(after.deallocations - during.deallocations, 1);
+}
+
+TEST_F(MemoryHooksTest, OversizedRequestsFailCleanly)
+{
+    const memory::HeapStats before = memory::heapStats();
+
+    EXPECT_EQ(::operator new(g_hugeSize, std::nothrow), nullptr);
+    EXPECT_EQ(::operator new[](g_hugeSize, std::nothrow), nullptr);
+    EXPECT_THROW(static_cast<void>(::operator new(g_hugeSize)), std::bad_alloc);
+    EXPECT_THROW(static_cast<void>(::operator new[](g_hugeSize)), std::bad_alloc);
+
+    // Nothing was counted for the failed requests
+    EXPECT_LT(memory::heapStats().peakBytes - before.peakBytes,
+              static_cast<std::int64_t>(1) << 30);
+}
+
+TEST_F(MemoryHooksTest, ThrowingNewRunsNewHandler)
+{
+    std::set_new_handler(countingHandler);
+    EXPECT_THROW(static_cast<void>(::operator new(g_hugeSize)), std::bad_alloc);
+    EXPECT_EQ(g_handlerCalls, 3);
+}
+
+TEST_F(MemoryHooksTest, NothrowNewRunsNewHandler)
+{
+    std::set_new_handler(countingHandler);
+    EXPECT_EQ(::operator new(g_hugeSize, std::nothrow), nullptr);
+    EXPECT_EQ(g_handlerCalls, 3);
+}
+
+TEST_F(MemoryHooksTest, NothrowNewSwallowsHandlerException)
+{
+    std::set_new_handler([] { throw std::bad_alloc(); });
+    EXPECT_EQ(::operator new(g_hugeSize, std::nothrow), nullptr);
+}
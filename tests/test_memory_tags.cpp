@@ -0,0 +1,217 @@
+// =====================================================================
+//  tests/test_memory_tags.cpp — Tagged memory accounting
+// =====================================================================
+//
+//  Constructs and destroys the owners that charge memory tags — a
+//  Project with bodies, sketches and a background image, a sketch
+//  UndoStack, a meshed shape and bare Charge objects — and checks that
+//  each tag's bytes and owner count rise while the owner lives and
+//  return to their baseline when it goes.  Does not need the heap
+//  hooks; the tag counters are always on.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/memory.h>
+#include <hobbycad/project.h>
+#include <hobbycad/sketch/undo.h>
+
+#include <gtest/gtest.h>
+
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+
+#include <memory>
+#include <utility>
+
+using namespace hobbycad;
+
+namespace {
+
+using memory::Tag;
+
+/// Bytes and owners of a tag relative to a baseline taken earlier
+struct Delta {
+    std::int64_t bytes = 0;
+    std::int64_t owners = 0;
+};
+
+class MemoryTagsTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        for (int i = 0; i < memory::kTagCount; ++i) m_baseline[i] = memory::tagStats(static_cast<Tag>(i));
+    }
+
+    Delta delta(Tag tag) const
+    {
+        const memory::TagStats now = memory::tagStats(tag);
+        const memory::TagStats& base = m_baseline[static_cast<int>(tag)];
+        return {now.bytes - base.bytes, now.owners - base.owners};
+    }
+
+    /// Every tag back where SetUp() found it
+    void expectBaseline() const
+    {
+        for (int i = 0; i < memory::kTagCount; ++i) {
+            const Tag tag = static_cast<Tag>(i);
+            EXPECT_EQ(delta(tag).bytes, 0) << memory::tagName(tag);
+            EXPECT_EQ(delta(tag).owners, 0) << memory::tagName(tag);
+        }
+    }
+
+private:
+    memory::TagStats m_baseline[memory::kTagCount];
+};
+
+SketchData makeSketch(int lines, bool withImage)
+{
+    SketchData sketch;
+    sketch.name = "a sketch with a name too long for the inline buffer";
+    for (int i = 0; i < lines; ++i) {
+        sketch.entities.push_back(sketch::createLine(i + 1, {0.0, i * 1.0}, {10.0, i * 1.0}));
+    }
+    ConstraintData horizontal;
+    horizontal.id = 1;
+    horizontal.type = ConstraintType::Horizontal;
+    horizontal.entityIds = {1};
+    sketch.constraints.push_back(horizontal);
+    if (withImage) {
+        sketch.backgroundImage.storage = sketch::BackgroundStorage::Embedded;
+        sketch.backgroundImage.imageData.assign(64 * 1024, 0x5a);
+        sketch.backgroundImage.mimeType = "image/png";
+    }
+    return sketch;
+}
+
+}  // anonymous namespace
+
+// ---- Owners ---------------------------------------------------------
+
+TEST_F(MemoryTagsTest, ProjectChargesWhileAlive)
+{
+    {
+        auto project = std::make_unique<Project>();
+        EXPECT_EQ(delta(Tag::ProjectBodies).owners, 1);
+        EXPECT_EQ(delta(Tag::SketchEntities).owners, 1);
+        EXPECT_EQ(delta(Tag::BackgroundImages).owners, 1);
+        EXPECT_EQ(delta(Tag::ProjectBodies).bytes, 0);
+
+        project->addShape(BRepPrimAPI_MakeBox(10, 20, 30).Shape());
+        const std::int64_t oneBody = delta(Tag::ProjectBodies).bytes;
+        EXPECT_GT(oneBody, 0);
+        project->addShape(BRepPrimAPI_MakeCylinder(5, 20).Shape());
+        EXPECT_GT(delta(Tag::ProjectBodies).bytes, oneBody);
+
+        project->addSketch(makeSketch(10, false));
+        const std::int64_t small = delta(Tag::SketchEntities).bytes;
+        EXPECT_GT(small, 10 * static_cast<std::int64_t>(sizeof(sketch::Entity)));
+        EXPECT_EQ(delta(Tag::BackgroundImages).bytes, 0);
+
+        project->addSketch(makeSketch(200, true));
+        EXPECT_GT(delta(Tag::SketchEntities).bytes, small + 200 * static_cast<std::int64_t>(sizeof(sketch::Entity)));
+        EXPECT_GE(delta(Tag::BackgroundImages).bytes, 64 * 1024);
+
+        // Removing a sketch takes back exactly what adding it charged
+        project->removeSketch(1);
+        EXPECT_EQ(delta(Tag::SketchEntities).bytes, small);
+        EXPECT_EQ(delta(Tag::BackgroundImages).bytes, 0);
+
+        project->clearShapes();
+        EXPECT_EQ(delta(Tag::ProjectBodies).bytes, 0);
+        project->addShape(BRepPrimAPI_MakeBox(1, 2, 3).Shape());
+        EXPECT_GT(delta(Tag::ProjectBodies).bytes, 0);
+    }
+    expectBaseline();
+}
+
+TEST_F(MemoryTagsTest, UndoStackChargesHeldCommands)
+{
+    {
+        sketch::UndoStack stack(50);
+        EXPECT_EQ(delta(Tag::UndoHistory).owners, 1);
+        EXPECT_EQ(delta(Tag::UndoHistory).bytes, 0);
+
+        for (int i = 0; i < 20; ++i) {
+            stack.push(sketch::UndoCommand::addEntity(sketch::createLine(i + 1, {0, 0}, {i + 1.0, 0})));
+        }
+        const std::int64_t twenty = delta(Tag::UndoHistory).bytes;
+        EXPECT_GT(twenty, 20 * static_cast<std::int64_t>(sizeof(sketch::UndoCommand)));
+
+        // Undone commands move to the redo stack and stay charged
+        stack.undoMultiple(5);
+        EXPECT_EQ(delta(Tag::UndoHistory).bytes, twenty);
+        stack.clearRedo();
+        EXPECT_LT(delta(Tag::UndoHistory).bytes, twenty);
+
+        stack.beginCompound("compound");
+        stack.push(sketch::UndoCommand::addEntity(sketch::createCircle(100, {0, 0}, 5)));
+        stack.endCompound();
+        EXPECT_GT(delta(Tag::UndoHistory).bytes, 0);
+
+        stack.clear();
+        EXPECT_EQ(delta(Tag::UndoHistory).bytes, 0);
+        for (int i = 0; i < 10; ++i) {
+            stack.push(sketch::UndoCommand::addEntity(sketch::createLine(i + 1, {0, 0}, {1, 1})));
+        }
+        EXPECT_GT(delta(Tag::UndoHistory).bytes, 0);
+    }
+    expectBaseline();
+}
+
+TEST_F(MemoryTagsTest, MeshedShapeChargesTessellation)
+{
+    TopoDS_Shape shape = BRepPrimAPI_MakeCylinder(10, 30).Shape();
+    EXPECT_EQ(memory::shapeFootprint(shape).tessellationBytes, 0);
+
+    BRepMesh_IncrementalMesh mesher(shape, 0.05);
+    const memory::ShapeFootprint meshed = memory::shapeFootprint(shape);
+    EXPECT_GT(meshed.tessellationBytes, 0);
+    EXPECT_GT(meshed.geometryBytes, 0);
+    {
+        // As the display and the stats command hold their meshes
+        memory::Charge charge(Tag::Tessellations, meshed.tessellationBytes);
+        EXPECT_EQ(delta(Tag::Tessellations).bytes, meshed.tessellationBytes);
+        EXPECT_EQ(delta(Tag::Tessellations).owners, 1);
+    }
+    expectBaseline();
+}
+
+// ---- Charge ---------------------------------------------------------
+
+TEST_F(MemoryTagsTest, ChargeCopyMoveAndPeak)
+{
+    memory::resetPeaks();
+    const std::int64_t peakBefore = memory::tagStats(Tag::Tessellations).peakBytes;
+    {
+        memory::Charge a(Tag::Tessellations, 1000);
+        memory::Charge b(a);
+        EXPECT_EQ(delta(Tag::Tessellations).bytes, 2000);
+        EXPECT_EQ(delta(Tag::Tessellations).owners, 2);
+
+        // Moving hands the bytes over without charging them twice
+        memory::Charge c(std::move(a));
+        EXPECT_EQ(a.bytes(), 0);
+        EXPECT_EQ(delta(Tag::Tessellations).bytes, 2000);
+        EXPECT_EQ(delta(Tag::Tessellations).owners, 3);
+
+        b.set(100);
+        c.add(-400);
+        EXPECT_EQ(delta(Tag::Tessellations).bytes, 700);
+
+        // A charge never goes below zero
+        c.add(-10000);
+        EXPECT_EQ(c.bytes(), 0);
+        EXPECT_EQ(delta(Tag::Tessellations).bytes, 100);
+
+        // Assignment keeps the target's tag
+        memory::Charge d(Tag::UndoHistory, 50);
+        d = b;
+        EXPECT_EQ(d.tag(), Tag::UndoHistory);
+        EXPECT_EQ(delta(Tag::UndoHistory).bytes, 100);
+    }
+    EXPECT_GE(memory::tagStats(Tag::Tessellations).peakBytes, peakBefore + 2000);
+    expectBaseline();
+}
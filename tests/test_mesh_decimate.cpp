@@ -0,0 +1,324 @@
+// =====================================================================
+//  tests/test_mesh_decimate.cpp — Triangle mesh decimation
+// =====================================================================
+//
+//  Decimates closed and open test meshes and checks that the result
+//  stays within the requested error bound of the input (measured as
+//  the symmetric Hausdorff distance), that closed manifold input stays
+//  closed, manifold and of the same topology, and that open boundaries
+//  keep their shape and corners.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/mesh/decimate.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::mesh;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+/// Closed torus (genus 1) of rings x segments quads, split into triangles
+TriangleMesh makeTorus(double major, double minor, int rings, int segments)
+{
+    TriangleMesh mesh;
+    for (int i = 0; i < rings; ++i) {
+        const double u = 2.0 * kPi * i / rings;
+        for (int j = 0; j < segments; ++j) {
+            const double v = 2.0 * kPi * j / segments;
+            const double r = major + minor * std::cos(v);
+            mesh.vertices.push_back({r * std::cos(u), r * std::sin(u), minor * std::sin(v)});
+        }
+    }
+    auto index = [&](int i, int j) { return (i % rings) * segments + (j % segments); };
+    for (int i = 0; i < rings; ++i) {
+        for (int j = 0; j < segments; ++j) {
+            const int a = index(i, j), b = index(i + 1, j);
+            const int c = index(i + 1, j + 1), d = index(i, j + 1);
+            mesh.triangles.push_back({a, b, c});
+            mesh.triangles.push_back({a, c, d});
+        }
+    }
+    return mesh;
+}
+
+/// Open square patch of a gentle bump, n x n quads
+TriangleMesh makeBump(int n)
+{
+    TriangleMesh mesh;
+    for (int i = 0; i <= n; ++i) {
+        for (int j = 0; j <= n; ++j) {
+            const double x = static_cast<double>(i) / n, y = static_cast<double>(j) / n;
+            mesh.vertices.push_back({x, y, 0.1 * std::sin(kPi * x) * std::sin(kPi * y)});
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            const int a = i * (n + 1) + j, b = (i + 1) * (n + 1) + j;
+            mesh.triangles.push_back({a, b, b + 1});
+            mesh.triangles.push_back({a, b + 1, a + 1});
+        }
+    }
+    return mesh;
+}
+
+// ---- Topology -------------------------------------------------------
+
+struct EdgeUse {
+    int forward = 0;    ///< Uses as (low, high)
+    int backward = 0;   ///< Uses as (high, low)
+};
+
+std::map<std::pair<int, int>, EdgeUse> edgeUses(const TriangleMesh& mesh)
+{
+    std::map<std::pair<int, int>, EdgeUse> edges;
+    for (const MeshTriangle& t : mesh.triangles) {
+        for (int k = 0; k < 3; ++k) {
+            const int a = t[k], b = t[(k + 1) % 3];
+            EdgeUse& use = edges[{std::min(a, b), std::max(a, b)}];
+            (a < b ? use.forward : use.backward) += 1;
+        }
+    }
+    return edges;
+}
+
+/// Every edge is used once in each direction, no triangle repeats a
+/// vertex, and V - E + F matches the expected Euler characteristic
+void expectClosedManifold(const TriangleMesh& mesh, int eulerCharacteristic)
+{
+    for (const MeshTriangle& t : mesh.triangles) {
+        EXPECT_TRUE(t[0] != t[1] && t[1] != t[2] && t[0] != t[2]) << "degenerate triangle";
+    }
+    const auto edges = edgeUses(mesh);
+    int bad = 0;
+    for (const auto& [edge, use] : edges) {
+        if (use.forward != 1 || use.backward != 1) ++bad;
+    }
+    EXPECT_EQ(bad, 0) << "edges not shared by exactly two consistently oriented triangles";
+    EXPECT_EQ(mesh.vertexCount() - static_cast<int>(edges.size()) + mesh.triangleCount(),
+              eulerCharacteristic);
+}
+
+/// Edges used by a single triangle
+std::vector<std::pair<int, int>> boundaryEdges(const TriangleMesh& mesh)
+{
+    std::vector<std::pair<int, int>> edges;
+    for (const auto& [edge, use] : edgeUses(mesh)) {
+        if (use.forward + use.backward == 1) edges.push_back(edge);
+    }
+    return edges;
+}
+
+// ---- Distance -------------------------------------------------------
+
+double pointSegmentDistance(const MeshPoint& p, const MeshPoint& a, const MeshPoint& b)
+{
+    const MeshPoint ab = b - a;
+    const double len2 = ab.dot(ab);
+    const double t = len2 > 0.0 ? std::clamp((p - a).dot(ab) / len2, 0.0, 1.0) : 0.0;
+    return (p - (a + ab * t)).length();
+}
+
+/// Distance from a point to a triangle (Ericson, Real-Time Collision
+/// Detection, 5.1.5)
+double pointTriangleDistance(const MeshPoint& p, const MeshPoint& a,
+                             const MeshPoint& b, const MeshPoint& c)
+{
+    const MeshPoint ab = b - a, ac = c - a, ap = p - a;
+    const double d1 = ab.dot(ap), d2 = ac.dot(ap);
+    if (d1 <= 0 && d2 <= 0) return ap.length();
+
+    const MeshPoint bp = p - b;
+    const double d3 = ab.dot(bp), d4 = ac.dot(bp);
+    if (d3 >= 0 && d4 <= d3) return bp.length();
+
+    const double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0) return (p - (a + ab * (d1 / (d1 - d3)))).length();
+
+    const MeshPoint cp = p - c;
+    const double d5 = ab.dot(cp), d6 = ac.dot(cp);
+    if (d6 >= 0 && d5 <= d6) return cp.length();
+
+    const double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0) return (p - (a + ac * (d2 / (d2 - d6)))).length();
+
+    const double va = d3 * d6 - d5 * d4;
+    if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+        const double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        return (p - (b + (c - b) * w)).length();
+    }
+
+    const double denom = 1.0 / (va + vb + vc);
+    return (p - (a + ab * (vb * denom) + ac * (vc * denom))).length();
+}
+
+double distanceToMesh(const MeshPoint& p, const TriangleMesh& mesh)
+{
+    double best = std::numeric_limits<double>::infinity();
+    for (const MeshTriangle& t : mesh.triangles) {
+        best = std::min(best, pointTriangleDistance(p, mesh.vertices[t[0]],
+                                                    mesh.vertices[t[1]], mesh.vertices[t[2]]));
+    }
+    return best;
+}
+
+/// Largest distance from samples of `from` (vertices, edge midpoints
+/// and centroids) to the surface of `to`
+double directedHausdorff(const TriangleMesh& from, const TriangleMesh& to)
+{
+    double worst = 0.0;
+    for (const MeshTriangle& t : from.triangles) {
+        const MeshPoint& a = from.vertices[t[0]];
+        const MeshPoint& b = from.vertices[t[1]];
+        const MeshPoint& c = from.vertices[t[2]];
+        for (const MeshPoint& p : {a, (a + b) * 0.5, (a + c) * 0.5, (a + b + c) * (1.0 / 3.0)}) {
+            worst = std::max(worst, distanceToMesh(p, to));
+        }
+    }
+    return worst;
+}
+
+double hausdorff(const TriangleMesh& a, const TriangleMesh& b)
+{
+    return std::max(directedHausdorff(a, b), directedHausdorff(b, a));
+}
+
+}  // anonymous namespace
+
+// ---- Error bound ----------------------------------------------------
+
+TEST(MeshDecimate, ErrorBoundLimitsHausdorffDistance)
+{
+    const TriangleMesh torus = makeTorus(10.0, 3.0, 64, 32);
+
+    for (double bound : {0.02, 0.1}) {
+        SCOPED_TRACE("maxError " + std::to_string(bound));
+        DecimateOptions options;
+        options.maxError = bound;
+        const DecimateResult result = decimate(torus, options);
+        ASSERT_TRUE(result.success) << result.errorMessage;
+
+        EXPECT_LT(result.outputTriangles, torus.triangleCount());
+        EXPECT_LE(result.maxError, bound);
+
+        // Quadrics measure distance to the planes of the original
+        // faces, which can be a little closer than the faces
+        // themselves, so allow a small margin over the bound
+        EXPECT_LE(hausdorff(torus, result.mesh), 1.5 * bound);
+    }
+}
+
+TEST(MeshDecimate, TriangleBudgetIsReached)
+{
+    const TriangleMesh torus = makeTorus(10.0, 3.0, 64, 32);
+    DecimateOptions options;
+    options.targetRatio = 0.2;
+    const DecimateResult result = decimate(torus, options);
+    ASSERT_TRUE(result.success) << result.errorMessage;
+    EXPECT_LE(result.outputTriangles, static_cast<int>(std::ceil(torus.triangleCount() * 0.2)));
+    EXPECT_EQ(result.inputTriangles, torus.triangleCount());
+    EXPECT_LE(hausdorff(torus, result.mesh), 1.5 * result.maxError);
+}
+
+// ---- Manifoldness ---------------------------------------------------
+
+TEST(MeshDecimate, ClosedManifoldStaysClosedManifold)
+{
+    const TriangleMesh torus = makeTorus(10.0, 3.0, 64, 32);
+    expectClosedManifold(torus, 0);
+
+    for (double ratio : {0.5, 0.1, 0.02}) {
+        SCOPED_TRACE("ratio " + std::to_string(ratio));
+        DecimateOptions options;
+        options.targetRatio = ratio;
+        const DecimateResult result = decimate(torus, options);
+        ASSERT_TRUE(result.success) << result.errorMessage;
+        expectClosedManifold(result.mesh, 0);
+    }
+}
+
+TEST(MeshDecimate, PartitionedDecimationStaysClosedManifold)
+{
+    // Large enough to be split, so the seam pass is exercised
+    const TriangleMesh torus = makeTorus(10.0, 3.0, 256, 96);
+    DecimateOptions options;
+    options.targetRatio = 0.1;
+    options.partitionTriangles = 10000;
+    const DecimateResult result = decimate(torus, options);
+    ASSERT_TRUE(result.success) << result.errorMessage;
+    EXPECT_GT(result.partitions, 1);
+    expectClosedManifold(result.mesh, 0);
+}
+
+TEST(MeshDecimate, TriangleSoupIsWelded)
+{
+    // Unshared corners, as read from an STL file
+    const TriangleMesh torus = makeTorus(10.0, 3.0, 32, 16);
+    TriangleMesh soup;
+    for (const MeshTriangle& t : torus.triangles) {
+        const int base = soup.vertexCount();
+        for (int v : t) soup.vertices.push_back(torus.vertices[v]);
+        soup.triangles.push_back({base, base + 1, base + 2});
+    }
+
+    DecimateOptions options;
+    options.targetRatio = 0.5;
+    const DecimateResult result = decimate(soup, options);
+    ASSERT_TRUE(result.success) << result.errorMessage;
+    expectClosedManifold(result.mesh, 0);
+}
+
+// ---- Boundaries -----------------------------------------------------
+
+TEST(MeshDecimate, OpenBoundaryStaysInPlace)
+{
+    const TriangleMesh bump = makeBump(40);
+    DecimateOptions options;
+    options.targetRatio = 0.1;
+    const DecimateResult result = decimate(bump, options);
+    ASSERT_TRUE(result.success) << result.errorMessage;
+
+    // Boundary vertices may slide along the boundary as open edges
+    // shorten, but never off it
+    const auto before = boundaryEdges(bump);
+    const auto after = boundaryEdges(result.mesh);
+    ASSERT_FALSE(after.empty());
+    std::set<std::pair<double, double>> corners;
+    for (const auto& edge : after) {
+        for (int v : {edge.first, edge.second}) {
+            const MeshPoint& p = result.mesh.vertices[v];
+            double best = std::numeric_limits<double>::infinity();
+            for (const auto& [a, b] : before) {
+                best = std::min(best, pointSegmentDistance(p, bump.vertices[a], bump.vertices[b]));
+            }
+            EXPECT_LT(best, 1e-9) << p.x << ", " << p.y << ", " << p.z;
+            corners.insert({p.x, p.y});
+        }
+    }
+
+    // The four corners are locked
+    for (const auto& corner : {std::make_pair(0.0, 0.0), std::make_pair(1.0, 0.0),
+                               std::make_pair(0.0, 1.0), std::make_pair(1.0, 1.0)}) {
+        EXPECT_TRUE(corners.count(corner)) << corner.first << ", " << corner.second;
+    }
+}
+
+TEST(MeshDecimate, RejectsMissingLimits)
+{
+    const DecimateResult result = decimate(makeTorus(10.0, 3.0, 8, 4), DecimateOptions{});
+    EXPECT_FALSE(result.success);
+    EXPECT_FALSE(result.errorMessage.empty());
+}
@@ -0,0 +1,450 @@
+// =====================================================================
+//  tests/test_mesh_repair.cpp — Triangle mesh repair
+// =====================================================================
+//
+//  Breaks closed test meshes on purpose — unwelded triangle soup,
+//  flipped and inside-out faces, holes, duplicate, collapsed and sliver
+//  triangles, non-manifold fins and small debris components — and
+//  checks that analyze() counts each defect exactly, and that repair()
+//  returns a closed, consistently and outwardly oriented mesh of the
+//  right volume.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/mesh/repair.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::mesh;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+constexpr int kSegments = 24;
+constexpr int kRings = 12;
+
+/// Closed box from (0, 0, 0) to (a, b, c), outward, 12 triangles
+TriangleMesh makeBox(double a, double b, double c, const MeshPoint& origin = {})
+{
+    TriangleMesh mesh;
+    for (int k = 0; k < 8; ++k) {
+        mesh.vertices.push_back(origin + MeshPoint((k & 1) ? a : 0.0, (k & 2) ? b : 0.0, (k & 4) ? c : 0.0));
+    }
+    mesh.triangles = {{0, 2, 3}, {0, 3, 1}, {4, 5, 7}, {4, 7, 6},
+                      {0, 1, 5}, {0, 5, 4}, {2, 6, 7}, {2, 7, 3},
+                      {0, 4, 6}, {0, 6, 2}, {1, 3, 7}, {1, 7, 5}};
+    return mesh;
+}
+
+/// Closed UV sphere, outward.  The first kSegments triangles are the
+/// fan round the south pole and the last kSegments the north one.
+TriangleMesh makeSphere(double r)
+{
+    TriangleMesh mesh;
+    mesh.vertices.push_back({0.0, 0.0, -r});
+    for (int i = 1; i < kRings; ++i) {
+        const double phi = -kPi / 2.0 + kPi * i / kRings;
+        for (int j = 0; j < kSegments; ++j) {
+            const double theta = 2.0 * kPi * j / kSegments;
+            mesh.vertices.push_back({r * std::cos(phi) * std::cos(theta), r * std::cos(phi) * std::sin(theta),
+                                     r * std::sin(phi)});
+        }
+    }
+    mesh.vertices.push_back({0.0, 0.0, r});
+    const int top = mesh.vertexCount() - 1;
+    auto at = [&](int ring, int j) { return 1 + (ring - 1) * kSegments + (j % kSegments); };
+    for (int j = 0; j < kSegments; ++j) mesh.triangles.push_back({0, at(1, j + 1), at(1, j)});
+    for (int i = 1; i < kRings - 1; ++i) {
+        for (int j = 0; j < kSegments; ++j) {
+            mesh.triangles.push_back({at(i, j), at(i, j + 1), at(i + 1, j + 1)});
+            mesh.triangles.push_back({at(i, j), at(i + 1, j + 1), at(i + 1, j)});
+        }
+    }
+    for (int j = 0; j < kSegments; ++j) mesh.triangles.push_back({top, at(kRings - 1, j), at(kRings - 1, j + 1)});
+    return mesh;
+}
+
+/// Every triangle with its own three vertices, as raw STL stores them
+TriangleMesh toSoup(const TriangleMesh& mesh)
+{
+    TriangleMesh soup;
+    for (const MeshTriangle& t : mesh.triangles) {
+        const int base = soup.vertexCount();
+        for (int v : t) soup.vertices.push_back(mesh.vertices[v]);
+        soup.triangles.push_back({base, base + 1, base + 2});
+    }
+    return soup;
+}
+
+/// Append a mesh's vertices and triangles to another
+void append(TriangleMesh& to, const TriangleMesh& from)
+{
+    const int base = to.vertexCount();
+    to.vertices.insert(to.vertices.end(), from.vertices.begin(), from.vertices.end());
+    for (MeshTriangle t : from.triangles) {
+        for (int& v : t) v += base;
+        to.triangles.push_back(t);
+    }
+}
+
+void flip(MeshTriangle& t)
+{
+    std::swap(t[1], t[2]);
+}
+
+/// Signed volume enclosed by the triangles (positive when outward)
+double signedVolume(const TriangleMesh& mesh)
+{
+    double volume = 0.0;
+    for (const MeshTriangle& t : mesh.triangles) {
+        volume += mesh.vertices[t[0]].dot(mesh.vertices[t[1]].cross(mesh.vertices[t[2]]));
+    }
+    return volume / 6.0;
+}
+
+// ---- Topology -------------------------------------------------------
+
+struct EdgeUse {
+    int forward = 0;    ///< Uses as (low, high)
+    int backward = 0;   ///< Uses as (high, low)
+};
+
+std::map<std::pair<int, int>, EdgeUse> edgeUses(const TriangleMesh& mesh)
+{
+    std::map<std::pair<int, int>, EdgeUse> edges;
+    for (const MeshTriangle& t : mesh.triangles) {
+        for (int k = 0; k < 3; ++k) {
+            const int a = t[k], b = t[(k + 1) % 3];
+            EdgeUse& use = edges[{std::min(a, b), std::max(a, b)}];
+            (a < b ? use.forward : use.backward) += 1;
+        }
+    }
+    return edges;
+}
+
+/// Every edge is used once in each direction, no triangle repeats a
+/// vertex, and every component's normals point outward
+void expectWatertight(const RepairResult& result)
+{
+    ASSERT_TRUE(result.success) << result.errorMessage;
+    const TriangleMesh& mesh = result.mesh;
+    for (const MeshTriangle& t : mesh.triangles) {
+        EXPECT_TRUE(t[0] != t[1] && t[1] != t[2] && t[0] != t[2]) << "degenerate triangle";
+    }
+    int bad = 0;
+    for (const auto& [edge, use] : edgeUses(mesh)) {
+        if (use.forward != 1 || use.backward != 1) ++bad;
+    }
+    EXPECT_EQ(bad, 0) << "edges not shared by exactly two consistently oriented triangles";
+    for (const TriangleMesh& part : splitComponents(mesh)) EXPECT_GT(signedVolume(part), 0.0);
+
+    EXPECT_TRUE(result.summary.watertight);
+    EXPECT_EQ(result.summary.openEdges, 0);
+    EXPECT_EQ(result.summary.outputVertices, mesh.vertexCount());
+    EXPECT_EQ(result.summary.outputTriangles, mesh.triangleCount());
+}
+
+/// Volume of the repaired sphere: the intact polyhedron, less at most
+/// the flattening of the caps the holes removed
+void expectSphereVolume(const RepairResult& result, double r)
+{
+    const double intact = signedVolume(makeSphere(r));
+    EXPECT_LE(signedVolume(result.mesh), intact * (1.0 + 1e-12));
+    EXPECT_GT(signedVolume(result.mesh), intact * 0.98);
+}
+
+}  // anonymous namespace
+
+// ---- Single defects -------------------------------------------------
+
+TEST(MeshRepair, CleanMeshHasNoDefects)
+{
+    const TriangleMesh sphere = makeSphere(10.0);
+    const DefectSummary summary = analyze(sphere);
+    EXPECT_FALSE(summary.hasDefects());
+    EXPECT_TRUE(summary.watertight);
+    EXPECT_EQ(summary.components, 1);
+    EXPECT_EQ(summary.selfIntersectingTriangles, 0);
+
+    const RepairResult result = repair(sphere);
+    expectWatertight(result);
+    EXPECT_EQ(result.mesh.triangleCount(), sphere.triangleCount());
+    EXPECT_EQ(result.mesh.vertexCount(), sphere.vertexCount());
+    EXPECT_EQ(result.summary.fillTriangles, 0);
+    EXPECT_NEAR(signedVolume(result.mesh), signedVolume(sphere), 1e-9);
+}
+
+TEST(MeshRepair, TriangleSoupIsWelded)
+{
+    const TriangleMesh box = makeBox(10.0, 20.0, 30.0);
+    const TriangleMesh soup = toSoup(box);
+    const DefectSummary summary = analyze(soup);
+    EXPECT_EQ(summary.inputVertices, 36);
+    EXPECT_EQ(summary.weldedVertices, 36 - 8);
+    EXPECT_EQ(summary.outputVertices, 8);
+    EXPECT_TRUE(summary.watertight);     // Once welded
+
+    const RepairResult result = repair(soup);
+    expectWatertight(result);
+    EXPECT_EQ(result.mesh.vertexCount(), 8);
+    EXPECT_EQ(result.mesh.triangleCount(), 12);
+    EXPECT_NEAR(signedVolume(result.mesh), 6000.0, 1e-9);
+}
+
+TEST(MeshRepair, FlippedTrianglesAreReoriented)
+{
+    TriangleMesh sphere = makeSphere(10.0);
+    const std::vector<int> flipped = {kSegments + 5, kSegments + 6, 100, 200, sphere.triangleCount() - 1};
+    for (int i : flipped) flip(sphere.triangles[i]);
+
+    const DefectSummary summary = analyze(sphere);
+    EXPECT_EQ(summary.flippedTriangles, static_cast<int>(flipped.size()));
+    EXPECT_EQ(summary.holes, 0);
+    EXPECT_FALSE(summary.watertight);
+
+    const RepairResult result = repair(sphere);
+    expectWatertight(result);
+    EXPECT_EQ(result.summary.flippedTriangles, static_cast<int>(flipped.size()));
+    EXPECT_NEAR(signedVolume(result.mesh), signedVolume(makeSphere(10.0)), 1e-9);
+
+    // A mesh turned inside out flips every triangle
+    TriangleMesh inverted = makeSphere(10.0);
+    for (MeshTriangle& t : inverted.triangles) flip(t);
+    EXPECT_EQ(analyze(inverted).flippedTriangles, inverted.triangleCount());
+    const RepairResult outward = repair(inverted);
+    expectWatertight(outward);
+    EXPECT_NEAR(signedVolume(outward.mesh), signedVolume(makeSphere(10.0)), 1e-9);
+}
+
+TEST(MeshRepair, HolesAreCountedAndFilled)
+{
+    // The north cap, and two single triangles far apart on the side
+    TriangleMesh sphere = makeSphere(10.0);
+    const int n = sphere.triangleCount();
+    std::vector<char> dead(n, 0);
+    for (int i = n - kSegments; i < n; ++i) dead[i] = 1;
+    dead[kSegments + 10] = 1;
+    dead[kSegments + 4 * kSegments + 30] = 1;
+    TriangleMesh holed = sphere;
+    holed.triangles.clear();
+    for (int i = 0; i < n; ++i) {
+        if (!dead[i]) holed.triangles.push_back(sphere.triangles[i]);
+    }
+    holed.removeUnusedVertices();
+
+    const DefectSummary summary = analyze(holed);
+    EXPECT_EQ(summary.holes, 3);
+    EXPECT_EQ(summary.openEdges, kSegments + 3 + 3);
+    EXPECT_FALSE(summary.watertight);
+
+    const RepairResult result = repair(holed);
+    expectWatertight(result);
+    EXPECT_EQ(result.summary.holes, 3);
+    EXPECT_EQ(result.summary.filledHoles, 3);
+    EXPECT_EQ(result.summary.fillTriangles, (kSegments - 2) + 1 + 1);
+    expectSphereVolume(result, 10.0);
+
+    // Holes above the size limit stay open
+    RepairOptions options;
+    options.maxHoleEdges = 3;
+    const RepairResult partial = repair(holed, options);
+    ASSERT_TRUE(partial.success);
+    EXPECT_EQ(partial.summary.filledHoles, 2);
+    EXPECT_EQ(partial.summary.openEdges, kSegments);
+    EXPECT_FALSE(partial.summary.watertight);
+}
+
+TEST(MeshRepair, DuplicateTrianglesAreRemoved)
+{
+    TriangleMesh box = makeBox(10.0, 10.0, 10.0);
+    MeshTriangle rotated = box.triangles[2];
+    std::rotate(rotated.begin(), rotated.begin() + 1, rotated.end());
+    MeshTriangle reversed = box.triangles[7];
+    flip(reversed);
+    box.triangles.push_back(box.triangles[0]);
+    box.triangles.push_back(rotated);
+    box.triangles.push_back(reversed);
+
+    const DefectSummary summary = analyze(box);
+    EXPECT_EQ(summary.duplicateTriangles, 3);
+    EXPECT_FALSE(summary.watertight);
+
+    const RepairResult result = repair(box);
+    expectWatertight(result);
+    EXPECT_EQ(result.summary.duplicateTriangles, 3);
+    EXPECT_EQ(result.mesh.triangleCount(), 12);
+    EXPECT_NEAR(signedVolume(result.mesh), 1000.0, 1e-9);
+}
+
+TEST(MeshRepair, DegenerateTrianglesAreRemoved)
+{
+    // Split the y = 0 side's triangle (0, 1, 5) at the middle m of the
+    // edge 0-1 and close the T-junction with a zero-area sliver
+    // (0, 1, m), then add two collapsed triangles
+    TriangleMesh box = makeBox(10.0, 10.0, 10.0);
+    const int m = box.vertexCount();
+    box.vertices.push_back({5.0, 0.0, 0.0});
+    box.triangles[4] = {0, m, 5};
+    box.triangles.push_back({m, 1, 5});
+    box.triangles.push_back({0, 1, m});
+    box.triangles.push_back({2, 2, 6});
+    box.triangles.push_back({3, 7, 3});
+
+    const DefectSummary summary = analyze(box);
+    EXPECT_EQ(summary.degenerateTriangles, 3);
+    EXPECT_EQ(summary.holes, 0);
+    EXPECT_FALSE(summary.watertight);
+
+    // The sliver's neighbour across 0-1 is split at m, so nothing opens
+    const RepairResult result = repair(box);
+    expectWatertight(result);
+    EXPECT_EQ(result.summary.degenerateTriangles, 3);
+    EXPECT_EQ(result.summary.holes, 0);
+    EXPECT_EQ(result.mesh.triangleCount(), 14);
+    EXPECT_NEAR(signedVolume(result.mesh), 1000.0, 1e-9);
+}
+
+TEST(MeshRepair, NonManifoldFinIsRemoved)
+{
+    // A fin on the edge 0-1 makes it the edge of three triangles
+    TriangleMesh box = makeBox(10.0, 10.0, 10.0);
+    box.vertices.push_back({5.0, -20.0, -20.0});
+    box.triangles.push_back({1, 0, box.vertexCount() - 1});
+
+    const DefectSummary summary = analyze(box);
+    EXPECT_EQ(summary.nonManifoldEdges, 1);
+    EXPECT_EQ(summary.nonManifoldTriangles, 1);
+    EXPECT_FALSE(summary.watertight);
+
+    const RepairResult result = repair(box);
+    expectWatertight(result);
+    EXPECT_EQ(result.mesh.triangleCount(), 12);
+    EXPECT_EQ(result.mesh.vertexCount(), 8);
+    EXPECT_NEAR(signedVolume(result.mesh), 1000.0, 1e-9);
+}
+
+TEST(MeshRepair, ComponentsAreSplitAndFiltered)
+{
+    TriangleMesh scene = makeSphere(10.0);
+    append(scene, makeBox(5.0, 5.0, 5.0, {30.0, 0.0, 0.0}));
+    TriangleMesh debris;
+    debris.vertices = {{50.0, 0.0, 0.0}, {51.0, 0.0, 0.0}, {50.0, 1.0, 0.0}};
+    debris.triangles = {{0, 1, 2}};
+    append(scene, debris);
+
+    const std::vector<TriangleMesh> parts = splitComponents(scene);
+    ASSERT_EQ(parts.size(), 3u);
+    EXPECT_EQ(parts[0].triangleCount(), makeSphere(10.0).triangleCount());
+    EXPECT_EQ(parts[1].triangleCount(), 12);
+    EXPECT_EQ(parts[1].vertexCount(), 8);
+    EXPECT_EQ(parts[2].triangleCount(), 1);
+    EXPECT_EQ(analyze(scene).components, 3);
+
+    RepairOptions options;
+    options.minComponentTriangles = 4;
+    const RepairResult result = repair(scene, options);
+    expectWatertight(result);
+    EXPECT_EQ(result.summary.components, 3);
+    EXPECT_EQ(result.summary.removedComponents, 1);
+    EXPECT_NEAR(signedVolume(result.mesh), signedVolume(makeSphere(10.0)) + 125.0, 1e-9);
+
+    options.keepLargestComponentOnly = true;
+    const RepairResult largest = repair(scene, options);
+    expectWatertight(largest);
+    EXPECT_EQ(largest.summary.removedComponents, 2);
+    EXPECT_EQ(largest.mesh.triangleCount(), makeSphere(10.0).triangleCount());
+}
+
+// ---- Corpus ---------------------------------------------------------
+
+/// Several components, each with several kinds of damage, as soup
+TriangleMesh brokenCorpus()
+{
+    TriangleMesh corpus;
+
+    // A sphere with its south cap cut off, two faces flipped, one
+    // triangle doubled and one collapsed
+    TriangleMesh sphere = makeSphere(10.0);
+    sphere.triangles.erase(sphere.triangles.begin(), sphere.triangles.begin() + kSegments);
+    flip(sphere.triangles[40]);
+    flip(sphere.triangles[41]);
+    sphere.triangles.push_back(sphere.triangles[60]);
+    sphere.triangles.push_back({5, 5, 9});
+    sphere.removeUnusedVertices();
+    append(corpus, toSoup(sphere));
+
+    // Boxes turned inside out, with a fin and a missing triangle
+    for (int i = 0; i < 4; ++i) {
+        TriangleMesh box = makeBox(4.0, 5.0, 6.0, {30.0 + 10.0 * i, 0.0, 0.0});
+        for (MeshTriangle& t : box.triangles) flip(t);
+        box.vertices.push_back(MeshPoint(30.0 + 10.0 * i, -8.0, -8.0));
+        box.triangles.push_back({0, 1, box.vertexCount() - 1});
+        box.triangles.erase(box.triangles.begin() + 10);
+        append(corpus, box);
+    }
+    return corpus;
+}
+
+TEST(MeshRepair, BrokenCorpusBecomesWatertight)
+{
+    const TriangleMesh corpus = brokenCorpus();
+    const DefectSummary summary = analyze(corpus);
+    EXPECT_TRUE(summary.hasDefects());
+    EXPECT_GT(summary.weldedVertices, 0);
+    EXPECT_EQ(summary.components, 5);
+    EXPECT_EQ(summary.duplicateTriangles, 1);
+    EXPECT_EQ(summary.degenerateTriangles, 1);
+    EXPECT_EQ(summary.nonManifoldEdges, 4);
+    EXPECT_EQ(summary.holes, 5);
+    EXPECT_FALSE(summary.watertight);
+
+    // The boxes face inward even though each is still open; of their
+    // twelve triangles one is missing and the fin goes
+    const int flipped = 2 + 4 * 11;
+    EXPECT_EQ(summary.flippedTriangles, flipped);
+
+    const RepairResult result = repair(corpus);
+    expectWatertight(result);
+    EXPECT_EQ(result.summary.components, 5);
+    EXPECT_EQ(result.summary.filledHoles, 5);
+    EXPECT_EQ(result.summary.flippedTriangles, flipped);
+    EXPECT_EQ(splitComponents(result.mesh).size(), 5u);
+    EXPECT_NEAR(signedVolume(result.mesh), signedVolume(makeSphere(10.0)) + 4 * 120.0, 0.02 * 4000.0);
+}
+
+TEST(MeshRepair, ParallelMatchesSerial)
+{
+    const TriangleMesh corpus = brokenCorpus();
+    RepairOptions options;
+    options.parallel = true;
+    const RepairResult parallel = repair(corpus, options);
+    options.parallel = false;
+    const RepairResult serial = repair(corpus, options);
+    ASSERT_TRUE(parallel.success && serial.success);
+    EXPECT_EQ(parallel.mesh.triangles, serial.mesh.triangles);
+    ASSERT_EQ(parallel.mesh.vertexCount(), serial.mesh.vertexCount());
+    for (int i = 0; i < parallel.mesh.vertexCount(); ++i) {
+        EXPECT_EQ((parallel.mesh.vertices[i] - serial.mesh.vertices[i]).length(), 0.0);
+    }
+    EXPECT_EQ(parallel.summary.flippedTriangles, serial.summary.flippedTriangles);
+    EXPECT_EQ(parallel.summary.fillTriangles, serial.summary.fillTriangles);
+}
+
+TEST(MeshRepair, RejectsVertexOutOfRange)
+{
+    TriangleMesh box = makeBox(1.0, 1.0, 1.0);
+    box.triangles.push_back({0, 1, 8});
+    const RepairResult result = repair(box);
+    EXPECT_FALSE(result.success);
+    EXPECT_FALSE(result.errorMessage.empty());
+}
@@ -0,0 +1,224 @@
+// =====================================================================
+//  tests/test_region_faces.cpp — Hole-aware region faces
+// =====================================================================
+//
+//  Builds plates drilled with round holes, some replaced by square
+//  pockets holding a drilled island, and checks that extruding and
+//  revolving the detected regions in one sweep gives the same volume
+//  (measured with GProp) as extruding the outer profile and cutting
+//  each extruded hole from it, and the closed-form volume of the
+//  sketch.  Region faces must carry one inner wire per hole.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/brep/operations.h>
+#include <hobbycad/sketch/profiles.h>
+
+#include <gtest/gtest.h>
+
+#include <BRepBndLib.hxx>
+#include <BRepGProp.hxx>
+#include <Bnd_Box.hxx>
+#include <GProp_GProps.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <gp_Ax1.hxx>
+#include <gp_Dir.hxx>
+#include <gp_Pnt.hxx>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::sketch;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+constexpr double kPitch = 10.0;         ///< Hole spacing
+constexpr double kHoleRadius = 3.0;
+constexpr double kPocketHalf = 4.0;     ///< Half side of a square pocket
+constexpr double kIslandRadius = 3.0;   ///< Island standing in a pocket
+constexpr double kBoreRadius = 1.5;     ///< Hole drilled through an island
+constexpr double kThickness = 5.0;
+
+/// A drilled plate and its closed-form area moments
+struct Plate {
+    std::vector<Entity> entities;
+    int holes = 0;                      ///< Holes in the plate itself
+    int islands = 0;
+    double area = 0.0;                  ///< Net area of material
+    double momentX = 0.0;               ///< Net first moment about the Y axis
+};
+
+/// cols x rows cells, each a round hole or (every pocketEvery-th cell)
+/// a square pocket with a drilled island in it
+Plate makePlate(int cols, int rows, int pocketEvery)
+{
+    Plate p;
+    int id = 1;
+    auto add = [&](double area, double x) {
+        p.area += area;
+        p.momentX += area * x;
+    };
+
+    const double w = cols * kPitch;
+    const double h = rows * kPitch;
+    p.entities.push_back(createRectangle(id++, {0, 0}, {w, h}));
+    add(w * h, w / 2.0);
+
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const Point2D o((c + 0.5) * kPitch, (r + 0.5) * kPitch);
+            ++p.holes;
+            if (pocketEvery > 0 && (r * cols + c) % pocketEvery == pocketEvery - 1) {
+                p.entities.push_back(createRectangle(id++, o - Point2D(kPocketHalf, kPocketHalf),
+                                                     o + Point2D(kPocketHalf, kPocketHalf)));
+                p.entities.push_back(createCircle(id++, o, kIslandRadius));
+                p.entities.push_back(createCircle(id++, o, kBoreRadius));
+                add(-4.0 * kPocketHalf * kPocketHalf, o.x);
+                add(kPi * kIslandRadius * kIslandRadius, o.x);
+                add(-kPi * kBoreRadius * kBoreRadius, o.x);
+                ++p.islands;
+            } else {
+                p.entities.push_back(createCircle(id++, o, kHoleRadius));
+                add(-kPi * kHoleRadius * kHoleRadius, o.x);
+            }
+        }
+    }
+    return p;
+}
+
+double volumeOf(const TopoDS_Shape& shape)
+{
+    GProp_GProps props;
+    BRepGProp::VolumeProperties(shape, props);
+    return props.Mass();
+}
+
+int countSubShapes(const TopoDS_Shape& shape, TopAbs_ShapeEnum type)
+{
+    TopTools_IndexedMapOfShape map;
+    TopExp::MapShapes(shape, type, map);
+    return map.Extent();
+}
+
+/// The volume without inner wires: each region's outer profile
+/// extruded, with every hole extruded and cut away one at a time
+double cutVolume(const std::vector<ProfileRegion>& regions, const std::vector<Entity>& entities)
+{
+    double total = 0.0;
+    for (const ProfileRegion& region : regions) {
+        brep::OperationResult body = brep::extrudeProfile(region.outer, entities, gp::DZ(), kThickness);
+        EXPECT_TRUE(body.success) << body.errorMessage;
+        for (const Profile& hole : region.holes) {
+            if (!body.success) break;
+            const brep::OperationResult tool = brep::extrudeProfile(hole, entities, gp::DZ(), kThickness);
+            EXPECT_TRUE(tool.success) << tool.errorMessage;
+            body = brep::cutShape(body.shape, tool.shape);
+            EXPECT_TRUE(body.success) << body.errorMessage;
+        }
+        if (body.success) total += volumeOf(body.shape);
+    }
+    return total;
+}
+
+}  // anonymous namespace
+
+// ---- Regions --------------------------------------------------------
+
+TEST(RegionFaces, RegionsFollowNesting)
+{
+    const Plate plate = makePlate(4, 3, 5);
+    const std::vector<ProfileRegion> regions = detectProfileRegions(plate.entities);
+
+    // The plate, then one region per island; each island has its bore
+    ASSERT_EQ(static_cast<int>(regions.size()), 1 + plate.islands);
+    EXPECT_EQ(static_cast<int>(regions[0].holes.size()), plate.holes);
+    for (size_t i = 1; i < regions.size(); ++i) {
+        ASSERT_EQ(regions[i].holes.size(), 1u);
+        EXPECT_EQ(regions[i].holes[0].parentId, regions[i].outer.id);
+        EXPECT_NE(regions[i].outer.parentId, 0);
+    }
+}
+
+TEST(RegionFaces, OneInnerWirePerHole)
+{
+    const Plate plate = makePlate(4, 3, 5);
+    const std::vector<ProfileRegion> regions = detectProfileRegions(plate.entities);
+    const brep::OperationResult faces = brep::buildRegionFaces(regions, plate.entities);
+    ASSERT_TRUE(faces.success) << faces.errorMessage;
+
+    ASSERT_EQ(countSubShapes(faces.shape, TopAbs_FACE), static_cast<int>(regions.size()));
+    size_t i = 0;
+    for (TopExp_Explorer it(faces.shape, TopAbs_FACE); it.More(); it.Next(), ++i) {
+        SCOPED_TRACE("region " + std::to_string(i));
+        EXPECT_EQ(countSubShapes(it.Current(), TopAbs_WIRE),
+                  1 + static_cast<int>(regions[i].holes.size()));
+    }
+}
+
+// ---- Volumes --------------------------------------------------------
+
+TEST(RegionFaces, ExtrudedVolumeMatchesCutHoles)
+{
+    struct Case {
+        int cols;
+        int rows;
+        int pocketEvery;
+    };
+    for (const Case& c : {Case{1, 1, 0}, Case{1, 1, 1}, Case{5, 3, 0}, Case{6, 4, 3}}) {
+        SCOPED_TRACE(std::to_string(c.cols) + "x" + std::to_string(c.rows) +
+                     " pockets every " + std::to_string(c.pocketEvery));
+        const Plate plate = makePlate(c.cols, c.rows, c.pocketEvery);
+        const std::vector<ProfileRegion> regions = detectProfileRegions(plate.entities);
+
+        const brep::OperationResult solid =
+            brep::extrudeRegions(regions, plate.entities, gp::DZ(), kThickness);
+        ASSERT_TRUE(solid.success) << solid.errorMessage;
+        EXPECT_EQ(countSubShapes(solid.shape, TopAbs_SOLID), 1 + plate.islands);
+
+        const double volume = volumeOf(solid.shape);
+        const double expected = plate.area * kThickness;
+        EXPECT_NEAR(volume, expected, 1e-6 * expected);
+        EXPECT_NEAR(volume, cutVolume(regions, plate.entities), 1e-6 * expected);
+    }
+}
+
+TEST(RegionFaces, SymmetricExtrusionIsCentred)
+{
+    const Plate plate = makePlate(3, 2, 2);
+    const std::vector<ProfileRegion> regions = detectProfileRegions(plate.entities);
+    const brep::OperationResult solid =
+        brep::extrudeRegions(regions, plate.entities, gp::DZ(), kThickness, true);
+    ASSERT_TRUE(solid.success) << solid.errorMessage;
+
+    EXPECT_NEAR(volumeOf(solid.shape), plate.area * kThickness, 1e-6 * plate.area * kThickness);
+    Bnd_Box box;
+    BRepBndLib::Add(solid.shape, box);
+    double x0, y0, z0, x1, y1, z1;
+    box.Get(x0, y0, z0, x1, y1, z1);
+    EXPECT_NEAR(z0, -kThickness / 2.0, 1e-6);
+    EXPECT_NEAR(z1, kThickness / 2.0, 1e-6);
+}
+
+TEST(RegionFaces, RevolvedVolumeFollowsPappus)
+{
+    // A quarter turn about a Y axis left of the plate sweeps each area
+    // element along an arc of its distance from the axis
+    const double axisX = -20.0;
+    const double angle = 90.0;
+    const Plate plate = makePlate(4, 2, 3);
+    const std::vector<ProfileRegion> regions = detectProfileRegions(plate.entities);
+    const brep::OperationResult solid = brep::revolveRegions(
+        regions, plate.entities, gp_Ax1(gp_Pnt(axisX, 0, 0), gp::DY()), angle);
+    ASSERT_TRUE(solid.success) << solid.errorMessage;
+
+    const double expected = (plate.momentX - axisX * plate.area) * angle * kPi / 180.0;
+    EXPECT_NEAR(volumeOf(solid.shape), expected, 1e-5 * expected);
+}
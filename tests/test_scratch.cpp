@@ -0,0 +1,328 @@
+// =====================================================================
+//  tests/test_scratch.cpp — Scratch arenas
+// =====================================================================
+//
+//  Runs the geometry and sketch kernels that keep their temporaries in
+//  scratch arenas on randomized polygons, point sets and sketches,
+//  three ways: with the arenas bypassed to the heap, with a fresh
+//  thread buffer, and nested inside a crowded outer arena.  Every
+//  result is printed with %.17g and must be byte-identical across the
+//  three.  Also checks the arena bookkeeping: rewinding, reuse of the
+//  thread buffer and heap overflow while nested.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/geometry/algorithms.h>
+#include <hobbycad/geometry/scratch.h>
+#include <hobbycad/sketch/operations.h>
+#include <hobbycad/sketch/profiles.h>
+#include <hobbycad/sketch/snap.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::geometry;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// ---- Printing -------------------------------------------------------
+
+template <typename T>
+void print(std::string& out, const std::vector<T>& v);
+template <typename T, typename U>
+void print(std::string& out, const std::pair<T, U>& p);
+
+void print(std::string& out, double v)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.17g ", v);
+    out += buf;
+}
+
+void print(std::string& out, int v)
+{
+    out += std::to_string(v) + " ";
+}
+
+void print(std::string& out, const Point2D& p)
+{
+    print(out, p.x);
+    print(out, p.y);
+}
+
+void print(std::string& out, const Triangle& t)
+{
+    print(out, t.i0);
+    print(out, t.i1);
+    print(out, t.i2);
+}
+
+void print(std::string& out, const PolygonWithHoles& p)
+{
+    print(out, p.outer);
+    print(out, p.holes);
+}
+
+void print(std::string& out, const BooleanResult& r)
+{
+    print(out, r.success ? 1 : 0);
+    print(out, r.polygons);
+}
+
+void print(std::string& out, const sketch::Intersection& i)
+{
+    print(out, i.entityId1);
+    print(out, i.entityId2);
+    print(out, i.point);
+    print(out, i.param1);
+    print(out, i.param2);
+}
+
+void print(std::string& out, const sketch::SnapPoint& s)
+{
+    print(out, s.position);
+    print(out, static_cast<int>(s.type));
+    print(out, s.entityId);
+}
+
+void print(std::string& out, const sketch::Profile& p)
+{
+    print(out, p.id);
+    print(out, p.entityIds);
+    print(out, p.polygon);
+    print(out, p.area);
+    print(out, p.isOuter ? 1 : 0);
+    print(out, p.parentId);
+}
+
+template <typename T>
+void print(std::string& out, const std::vector<T>& v)
+{
+    out += "[";
+    for (const T& x : v) print(out, x);
+    out += "] ";
+}
+
+template <typename T, typename U>
+void print(std::string& out, const std::pair<T, U>& p)
+{
+    print(out, p.first);
+    print(out, p.second);
+}
+
+template <typename T>
+std::string printed(const T& value)
+{
+    std::string out;
+    print(out, value);
+    return out;
+}
+
+// ---- Inputs ---------------------------------------------------------
+
+/// Star-shaped (so simple) counter-clockwise polygon
+std::vector<Point2D> randomPolygon(std::mt19937& rng, const Point2D& center, double radius, int n)
+{
+    std::uniform_real_distribution<double> jitter(0.0, 0.8);
+    std::uniform_real_distribution<double> reach(0.5, 1.0);
+    std::vector<Point2D> pts;
+    for (int i = 0; i < n; ++i) {
+        const double a = 2.0 * kPi * (i + jitter(rng)) / n;
+        const double r = radius * reach(rng);
+        pts.push_back({center.x + r * std::cos(a), center.y + r * std::sin(a)});
+    }
+    return pts;
+}
+
+std::vector<Point2D> randomPoints(std::mt19937& rng, int n)
+{
+    std::uniform_real_distribution<double> coord(-50.0, 50.0);
+    std::vector<Point2D> pts;
+    for (int i = 0; i < n; ++i) pts.push_back({coord(rng), coord(rng)});
+    return pts;
+}
+
+/// Overlapping lines, circles, arcs and closed shapes
+std::vector<sketch::Entity> randomSketch(std::mt19937& rng, int n)
+{
+    std::uniform_real_distribution<double> coord(-40.0, 40.0);
+    std::uniform_real_distribution<double> size(2.0, 15.0);
+    std::uniform_real_distribution<double> angle(0.0, 360.0);
+    std::vector<sketch::Entity> entities;
+    for (int id = 1; id <= n; ++id) {
+        const Point2D p(coord(rng), coord(rng));
+        switch (id % 5) {
+        case 0: entities.push_back(sketch::createLine(id, p, {coord(rng), coord(rng)})); break;
+        case 1: entities.push_back(sketch::createCircle(id, p, size(rng))); break;
+        case 2: entities.push_back(sketch::createArc(id, p, size(rng), angle(rng), angle(rng) - 180.0)); break;
+        case 3: entities.push_back(sketch::createRectangle(id, p, p + Point2D(size(rng), size(rng)))); break;
+        default: entities.push_back(sketch::createPolygon(id, p, size(rng), 3 + id % 6)); break;
+        }
+    }
+    return entities;
+}
+
+// ---- Modes ----------------------------------------------------------
+
+/// Result of fn with arenas bypassed, with a fresh buffer, and nested
+/// in an outer arena that already holds several buffer blocks
+std::vector<std::string> runThreeWays(const std::function<std::string()>& fn)
+{
+    std::vector<std::string> results;
+
+    setScratchBypass(true);
+    results.push_back(fn());
+    setScratchBypass(false);
+
+    results.push_back(fn());
+
+    ScratchArena outer;
+    ScratchVector<double> crowd(outer.resource());
+    for (int i = 0; i < 100000; ++i) crowd.push_back(i);
+    results.push_back(fn());
+    return results;
+}
+
+void expectSameEverywhere(const char* kernel, const std::function<std::string()>& fn)
+{
+    const std::vector<std::string> r = runThreeWays(fn);
+    EXPECT_GT(r[0].size(), 8u) << kernel << ": nothing to compare";
+    EXPECT_EQ(r[0], r[1]) << kernel << ": arena result differs from heap";
+    EXPECT_EQ(r[0], r[2]) << kernel << ": nested arena result differs from heap";
+}
+
+}  // anonymous namespace
+
+// ---- Kernels --------------------------------------------------------
+
+TEST(ScratchArena, GeometryKernelsMatchHeap)
+{
+    for (unsigned seed = 1; seed <= 25; ++seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        std::mt19937 rng(seed);
+        const int n = 8 + static_cast<int>(rng() % 60);
+        const std::vector<Point2D> a = randomPolygon(rng, {0, 0}, 30.0, n);
+        const std::vector<Point2D> b = randomPolygon(rng, {12, 7}, 25.0, n / 2 + 3);
+        const std::vector<Point2D> hole1 = randomPolygon(rng, {-8, 0}, 5.0, 7);
+        const std::vector<Point2D> hole2 = randomPolygon(rng, {8, 2}, 4.0, 5);
+        const std::vector<Point2D> cloud = randomPoints(rng, 50 + n);
+
+        expectSameEverywhere("convexHull", [&] { return printed(convexHull(cloud)); });
+        expectSameEverywhere("simplifyPolygon", [&] { return printed(simplifyPolygon(a, 2.0)); });
+        expectSameEverywhere("simplifyByArea", [&] { return printed(simplifyByArea(a, 4.0)); });
+        expectSameEverywhere("polygonUnion", [&] { return printed(polygonUnion(a, b)); });
+        expectSameEverywhere("polygonIntersection", [&] { return printed(polygonIntersection(a, b)); });
+        expectSameEverywhere("polygonDifference", [&] { return printed(polygonDifference(a, hole1)); });
+        expectSameEverywhere("triangulatePolygon", [&] { return printed(triangulatePolygon(a)); });
+        expectSameEverywhere("triangulatePolygonWithHoles", [&] {
+            std::vector<Point2D> h1(hole1.rbegin(), hole1.rend());
+            std::vector<Point2D> h2(hole2.rbegin(), hole2.rend());
+            return printed(triangulatePolygonWithHoles(a, {h1, h2}));
+        });
+        expectSameEverywhere("voronoiDiagram", [&] {
+            return printed(voronoiDiagram(cloud, Rect2D{-60.0, -60.0, 120.0, 120.0}));
+        });
+        expectSameEverywhere("smoothPolyline", [&] { return printed(smoothPolyline(a, 3)); });
+
+        for (int join = 0; join <= 2; ++join) {
+            for (double d : {-3.0, -0.5, 0.5, 4.0}) {
+                SCOPED_TRACE("join " + std::to_string(join) + " distance " + std::to_string(d));
+                expectSameEverywhere("offsetPolygon", [&] { return printed(offsetPolygon(a, d, join)); });
+            }
+        }
+    }
+}
+
+TEST(ScratchArena, SketchKernelsMatchHeap)
+{
+    for (unsigned seed = 1; seed <= 10; ++seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        std::mt19937 rng(seed);
+        const std::vector<sketch::Entity> entities = randomSketch(rng, 40);
+
+        expectSameEverywhere("findAllIntersections", [&] { return printed(sketch::findAllIntersections(entities)); });
+        expectSameEverywhere("collectAllSnapPoints", [&] { return printed(sketch::collectAllSnapPoints(entities)); });
+        expectSameEverywhere("detectProfilesWithHoles", [&] {
+            return printed(sketch::detectProfilesWithHoles(entities));
+        });
+        expectSameEverywhere("entityToPolygon", [&] {
+            std::string out;
+            for (const sketch::Entity& e : entities) print(out, sketch::entityToPolygon(e));
+            return out;
+        });
+    }
+}
+
+// ---- Bookkeeping ----------------------------------------------------
+
+#if HOBBYCAD_SCRATCH_PMR
+
+TEST(ScratchArena, RewindsAndReusesTheBuffer)
+{
+    std::mt19937 rng(3);
+    const std::vector<Point2D> a = randomPolygon(rng, {0, 0}, 30.0, 200);
+    const std::vector<Point2D> b = randomPolygon(rng, {10, 0}, 30.0, 200);
+
+    const std::size_t usedBefore = scratchStats().usedBytes;
+    polygonUnion(a, b);
+    const ScratchStats warm = scratchStats();
+    EXPECT_EQ(warm.usedBytes, usedBefore);
+    EXPECT_GT(warm.peakUsedBytes, 0u);
+    EXPECT_GT(warm.reservedBytes, 0u);
+
+    // The second call fits in the buffer the first one left behind
+    polygonUnion(a, b);
+    EXPECT_EQ(scratchStats().bufferAllocations, warm.bufferAllocations);
+    EXPECT_EQ(scratchStats().usedBytes, usedBefore);
+}
+
+TEST(ScratchArena, NestedGrowthOverflowsToHeap)
+{
+    const std::size_t usedBefore = scratchStats().usedBytes;
+    {
+        ScratchArena outer;
+        ScratchVector<int> values(outer.resource());
+        values.push_back(0);
+        const std::size_t heapBefore = scratchStats().bufferAllocations;
+        {
+            ScratchArena inner;
+            ScratchVector<int> local(inner.resource());
+            local.assign(1000, 7);
+
+            // Growing the outer vector now cannot take buffer memory the
+            // inner arena will rewind over
+            for (int i = 1; i < 5000; ++i) values.push_back(i);
+            EXPECT_GT(scratchStats().bufferAllocations, heapBefore);
+            EXPECT_EQ(local[999], 7);
+        }
+        for (int i = 0; i < 5000; ++i) ASSERT_EQ(values[i], i);
+    }
+    EXPECT_EQ(scratchStats().usedBytes, usedBefore);
+}
+
+TEST(ScratchArena, BypassLeavesBufferUntouched)
+{
+    setScratchBypass(true);
+    const ScratchStats before = scratchStats();
+    {
+        ScratchArena arena;
+        ScratchVector<double> values(arena.resource());
+        values.assign(50000, 1.0);
+        EXPECT_EQ(scratchStats().usedBytes, before.usedBytes);
+    }
+    setScratchBypass(false);
+    EXPECT_EQ(scratchStats().usedBytes, before.usedBytes);
+}
+
+#endif
@@ -0,0 +1,231 @@
+// =====================================================================
+//  tests/test_sketch_io.cpp — Binary sketch encoding and project files
+// =====================================================================
+//
+//  Round-trips sketches through the binary encoding, through sketch
+//  files on a non-ASCII path, and through whole projects saved with
+//  binary and JSON sketches.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/project.h>
+#include <hobbycad/sketch_io.h>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using namespace hobbycad;
+namespace fs = std::filesystem;
+
+namespace {
+
+SketchData makeSketch()
+{
+    SketchData sketch;
+    sketch.name = "Bracket";
+    sketch.plane = SketchPlane::XZ;
+    sketch.planeOffset = 12.5;
+    sketch.gridSpacing = 5.0;
+
+    sketch.entities.push_back(sketch::createLine(1, {0, 0}, {40, 0}));
+    sketch.entities.push_back(sketch::createArc(2, {40, 10}, 10, -90, 180));
+    sketch.entities.push_back(sketch::createCircle(3, {20, 10}, 4.25));
+    sketch.entities.push_back(sketch::createSpline(4, {{0, 20}, {10, 25}, {30, 18}, {40, 20}}));
+    sketch.entities.push_back(sketch::createText(5, {5, 5}, "Größe 1", "DejaVu Sans", 3.5));
+    sketch.entities.back().isConstruction = true;
+
+    ConstraintData horizontal;
+    horizontal.id = 1;
+    horizontal.type = ConstraintType::Horizontal;
+    horizontal.entityIds = {1};
+    sketch.constraints.push_back(horizontal);
+
+    ConstraintData radius;
+    radius.id = 2;
+    radius.type = ConstraintType::Radius;
+    radius.entityIds = {3};
+    radius.value = 4.25;
+    radius.labelPosition = {26, 14};
+    sketch.constraints.push_back(radius);
+    return sketch;
+}
+
+void expectSameSketch(const SketchData& a, const SketchData& b)
+{
+    EXPECT_EQ(a.name, b.name);
+    EXPECT_EQ(a.plane, b.plane);
+    EXPECT_DOUBLE_EQ(a.planeOffset, b.planeOffset);
+    EXPECT_DOUBLE_EQ(a.gridSpacing, b.gridSpacing);
+
+    ASSERT_EQ(a.entities.size(), b.entities.size());
+    for (size_t i = 0; i < a.entities.size(); ++i) {
+        const auto& ea = a.entities[i];
+        const auto& eb = b.entities[i];
+        SCOPED_TRACE("entity " + std::to_string(ea.id));
+        EXPECT_EQ(ea.id, eb.id);
+        EXPECT_EQ(ea.type, eb.type);
+        ASSERT_EQ(ea.points.size(), eb.points.size());
+        for (size_t p = 0; p < ea.points.size(); ++p) {
+            EXPECT_DOUBLE_EQ(ea.points[p].x, eb.points[p].x);
+            EXPECT_DOUBLE_EQ(ea.points[p].y, eb.points[p].y);
+        }
+        EXPECT_DOUBLE_EQ(ea.radius, eb.radius);
+        if (ea.type == sketch::EntityType::Arc) {
+            // JSON stores angles for arcs only
+            EXPECT_DOUBLE_EQ(ea.startAngle, eb.startAngle);
+            EXPECT_DOUBLE_EQ(ea.sweepAngle, eb.sweepAngle);
+        }
+        EXPECT_EQ(ea.text, eb.text);
+        EXPECT_EQ(ea.fontFamily, eb.fontFamily);
+        EXPECT_DOUBLE_EQ(ea.fontSize, eb.fontSize);
+        EXPECT_EQ(ea.isConstruction, eb.isConstruction);
+    }
+
+    ASSERT_EQ(a.constraints.size(), b.constraints.size());
+    for (size_t i = 0; i < a.constraints.size(); ++i) {
+        const auto& ca = a.constraints[i];
+        const auto& cb = b.constraints[i];
+        SCOPED_TRACE("constraint " + std::to_string(ca.id));
+        EXPECT_EQ(ca.id, cb.id);
+        EXPECT_EQ(ca.type, cb.type);
+        EXPECT_EQ(ca.entityIds, cb.entityIds);
+        EXPECT_EQ(ca.pointIndices, cb.pointIndices);
+        EXPECT_DOUBLE_EQ(ca.value, cb.value);
+        EXPECT_DOUBLE_EQ(ca.labelPosition.x, cb.labelPosition.x);
+        EXPECT_DOUBLE_EQ(ca.labelPosition.y, cb.labelPosition.y);
+    }
+}
+
+/// The "format_version" recorded in a project's manifest (-1 if absent)
+int manifestFormatVersion(const fs::path& projectDir)
+{
+    const fs::path manifest = projectDir / (projectDir.filename().string() + ".hcad");
+    std::ifstream ifs(manifest);
+    std::string text((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+    const std::string key = "\"format_version\"";
+    size_t pos = text.find(key);
+    if (pos == std::string::npos) return -1;
+    pos = text.find(':', pos + key.size());
+    if (pos == std::string::npos) return -1;
+    return std::stoi(text.substr(pos + 1));
+}
+
+class SketchIoTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        m_dir = fs::temp_directory_path() /
+                (std::string("hobbycad_") + info->test_suite_name() + "_" + info->name());
+        fs::remove_all(m_dir);
+        fs::create_directories(m_dir);
+    }
+
+    void TearDown() override { fs::remove_all(m_dir); }
+
+    fs::path m_dir;
+};
+
+}  // anonymous namespace
+
+// ---- Binary encoding ------------------------------------------------
+
+TEST(SketchIo, EncodeDecodeRoundTrip)
+{
+    const SketchData original = makeSketch();
+    const std::vector<uint8_t> data = sketch_io::encodeSketch(original);
+    ASSERT_TRUE(sketch_io::isBinarySketch(data.data(), data.size()));
+
+    SketchData decoded;
+    std::string error;
+    ASSERT_TRUE(sketch_io::decodeSketch(data.data(), data.size(), decoded, &error)) << error;
+    expectSameSketch(original, decoded);
+}
+
+TEST(SketchIo, RejectsTruncatedData)
+{
+    const std::vector<uint8_t> data = sketch_io::encodeSketch(makeSketch());
+    SketchData decoded;
+    EXPECT_FALSE(sketch_io::decodeSketch(data.data(), data.size() / 2, decoded));
+}
+
+// ---- Sketch files ---------------------------------------------------
+
+TEST_F(SketchIoTest, FileRoundTripOnUtf8Path)
+{
+    // Paths are UTF-8 on every platform, including Windows
+    const std::string path = (m_dir / fs::u8path(u8"Skizze_Größe.hsk")).u8string();
+    const SketchData original = makeSketch();
+
+    std::string error;
+    ASSERT_TRUE(sketch_io::writeSketchFile(path, original, &error)) << error;
+    EXPECT_TRUE(sketch_io::isBinarySketchFile(path));
+
+    SketchData loaded;
+    ASSERT_TRUE(sketch_io::readSketchFile(path, loaded, &error)) << error;
+    expectSameSketch(original, loaded);
+}
+
+// ---- Projects -------------------------------------------------------
+
+TEST_F(SketchIoTest, ProjectWithBinarySketchesWritesFormat2)
+{
+    const fs::path dir = m_dir / "binary";
+    Project project;
+    project.createNew("binary");
+    project.setSketchFileFormat(SketchFileFormat::Binary);
+    project.addSketch(makeSketch());
+
+    std::string error;
+    ASSERT_TRUE(project.save(dir.string(), &error)) << error;
+    EXPECT_EQ(manifestFormatVersion(dir), Project::FORMAT_VERSION);
+    EXPECT_TRUE(fs::exists(dir / "sketches" / "sketch_001.hsk"));
+
+    Project loaded;
+    ASSERT_TRUE(loaded.load(dir.string(), &error)) << error;
+    ASSERT_EQ(loaded.sketches().size(), 1u);
+    expectSameSketch(project.sketches()[0], loaded.sketches()[0]);
+}
+
+TEST_F(SketchIoTest, ProjectWithJsonSketchesWritesFormat1)
+{
+    const fs::path dir = m_dir / "json";
+    Project project;
+    project.createNew("json");
+    project.setSketchFileFormat(SketchFileFormat::Json);
+    project.addSketch(makeSketch());
+
+    std::string error;
+    ASSERT_TRUE(project.save(dir.string(), &error)) << error;
+    EXPECT_EQ(manifestFormatVersion(dir), Project::FORMAT_VERSION_JSON_SKETCHES);
+    EXPECT_TRUE(fs::exists(dir / "sketches" / "sketch_001.json"));
+
+    Project loaded;
+    ASSERT_TRUE(loaded.load(dir.string(), &error)) << error;
+    ASSERT_EQ(loaded.sketches().size(), 1u);
+    expectSameSketch(project.sketches()[0], loaded.sketches()[0]);
+}
+
+TEST_F(SketchIoTest, SwitchingToJsonDropsBackToFormat1)
+{
+    const fs::path dir = m_dir / "switch";
+    Project project;
+    project.createNew("switch");
+    project.addSketch(makeSketch());
+
+    std::string error;
+    ASSERT_TRUE(project.save(dir.string(), &error)) << error;
+    EXPECT_EQ(manifestFormatVersion(dir), Project::FORMAT_VERSION);
+
+    project.setSketchFileFormat(SketchFileFormat::Json);
+    ASSERT_TRUE(project.save(dir.string(), &error)) << error;
+    EXPECT_EQ(manifestFormatVersion(dir), Project::FORMAT_VERSION_JSON_SKETCHES);
+    EXPECT_FALSE(fs::exists(dir / "sketches" / "sketch_001.hsk"));
+}
@@ -0,0 +1,416 @@
+// =====================================================================
+//  tests/test_slice.cpp — Multi-plane slicing
+// =====================================================================
+//
+//  Slices boxes, cylinders, tubes and spheres at several heights and
+//  checks each section's area against the closed form: through the
+//  triangle-mesh path (sliceMesh() and buildContours()) on meshes
+//  built here, and through sliceShape() on OCCT primitives with both
+//  the exact and the mesh method.  Checks that round sections come
+//  back as circles of the right radius, that planes outside the solid
+//  give empty layers, that layers follow the order of the offsets,
+//  and that parallel and serial runs agree.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/brep/slice.h>
+#include <hobbycad/geometry/utils.h>
+#include <hobbycad/mesh/slice.h>
+#include <hobbycad/sketch/contour_fit.h>
+
+#include <gtest/gtest.h>
+
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <BRepPrimAPI_MakeSphere.hxx>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace hobbycad;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+constexpr double kRadius = 10.0;
+constexpr double kHeight = 30.0;
+constexpr int kSegments = 128;
+
+/// Area of a regular n-gon with circumradius r
+double polygonArea(double r, int n)
+{
+    return 0.5 * n * r * r * std::sin(2.0 * kPi / n);
+}
+
+/// Area of the sphere's section at height z from its centre
+double sphereSectionArea(double r, double z)
+{
+    return std::abs(z) >= r ? 0.0 : kPi * (r * r - z * z);
+}
+
+/// Largest distance between a regular n-gon's edges and its circle
+double sagitta(double r, int n)
+{
+    return r * (1.0 - std::cos(kPi / n));
+}
+
+// ---- Meshes ---------------------------------------------------------
+
+mesh::TriangleMesh boxMesh(double a, double b, double c)
+{
+    mesh::TriangleMesh m;
+    for (int k = 0; k < 8; ++k) {
+        m.vertices.push_back({(k & 1) ? a : 0.0, (k & 2) ? b : 0.0, (k & 4) ? c : 0.0});
+    }
+    m.triangles = {{0, 2, 3}, {0, 3, 1}, {4, 5, 7}, {4, 7, 6},
+                   {0, 1, 5}, {0, 5, 4}, {2, 6, 7}, {2, 7, 3},
+                   {0, 4, 6}, {0, 6, 2}, {1, 3, 7}, {1, 7, 5}};
+    return m;
+}
+
+/// Prism over a regular n-gon about the Z axis from z = 0 to height,
+/// with a coaxial n-gon hole when inner > 0
+mesh::TriangleMesh tubeMesh(double outer, double inner, double height, int n)
+{
+    mesh::TriangleMesh m;
+    auto ring = [&](double r, double z) {
+        const int first = static_cast<int>(m.vertices.size());
+        for (int j = 0; j < n; ++j) {
+            const double a = 2.0 * kPi * j / n;
+            m.vertices.push_back({r * std::cos(a), r * std::sin(a), z});
+        }
+        return first;
+    };
+    const int ob = ring(outer, 0.0);
+    const int ot = ring(outer, height);
+    for (int j = 0; j < n; ++j) {
+        const int k = (j + 1) % n;
+        m.triangles.push_back({ob + j, ob + k, ot + k});
+        m.triangles.push_back({ob + j, ot + k, ot + j});
+    }
+    if (inner > 0.0) {
+        const int ib = ring(inner, 0.0);
+        const int it = ring(inner, height);
+        for (int j = 0; j < n; ++j) {
+            const int k = (j + 1) % n;
+            m.triangles.push_back({ib + j, it + k, ib + k});
+            m.triangles.push_back({ib + j, it + j, it + k});
+            m.triangles.push_back({ob + j, ib + k, ob + k});
+            m.triangles.push_back({ob + j, ib + j, ib + k});
+            m.triangles.push_back({ot + j, ot + k, it + k});
+            m.triangles.push_back({ot + j, it + k, it + j});
+        }
+    } else {
+        m.vertices.push_back({0.0, 0.0, 0.0});
+        m.vertices.push_back({0.0, 0.0, height});
+        const int cb = static_cast<int>(m.vertices.size()) - 2;
+        for (int j = 0; j < n; ++j) {
+            const int k = (j + 1) % n;
+            m.triangles.push_back({cb, ob + k, ob + j});
+            m.triangles.push_back({cb + 1, ot + j, ot + k});
+        }
+    }
+    return m;
+}
+
+/// UV sphere about the origin with its vertices on the sphere
+mesh::TriangleMesh sphereMesh(double r, int segments, int rings)
+{
+    mesh::TriangleMesh m;
+    m.vertices.push_back({0.0, 0.0, -r});
+    for (int i = 1; i < rings; ++i) {
+        const double phi = -kPi / 2.0 + kPi * i / rings;
+        for (int j = 0; j < segments; ++j) {
+            const double theta = 2.0 * kPi * j / segments;
+            m.vertices.push_back({r * std::cos(phi) * std::cos(theta), r * std::cos(phi) * std::sin(theta),
+                                  r * std::sin(phi)});
+        }
+    }
+    m.vertices.push_back({0.0, 0.0, r});
+    const int top = static_cast<int>(m.vertices.size()) - 1;
+    auto at = [&](int ring, int j) { return 1 + (ring - 1) * segments + (j % segments); };
+    for (int j = 0; j < segments; ++j) {
+        m.triangles.push_back({0, at(1, j + 1), at(1, j)});
+        for (int i = 1; i < rings - 1; ++i) {
+            m.triangles.push_back({at(i, j), at(i, j + 1), at(i + 1, j + 1)});
+            m.triangles.push_back({at(i, j), at(i + 1, j + 1), at(i + 1, j)});
+        }
+        m.triangles.push_back({top, at(rings - 1, j), at(rings - 1, j + 1)});
+    }
+    return m;
+}
+
+mesh::SlicePlanes zPlanes(const std::vector<double>& offsets)
+{
+    mesh::SlicePlanes planes;
+    planes.offsets = offsets;
+    return planes;
+}
+
+/// Net area of a mesh section's loops: outer loops minus holes
+double loopArea(const mesh::MeshSection& section)
+{
+    std::vector<sketch::Contour> contours = sketch::buildContours(section.loops, {});
+    double area = 0.0;
+    for (const sketch::Contour& c : contours) area += geometry::polygonArea(c.points);
+    return area;
+}
+
+/// Entities of one type over all the contours
+int countEntities(const std::vector<sketch::Contour>& contours, sketch::EntityType type)
+{
+    int count = 0;
+    for (const sketch::Contour& c : contours) {
+        for (const sketch::Entity& e : c.entities) count += e.type == type ? 1 : 0;
+    }
+    return count;
+}
+
+/// Every closed contour is one circle of radius r about the origin
+void expectCircles(const std::vector<sketch::Contour>& contours, const std::vector<double>& radii,
+                   double tol)
+{
+    ASSERT_EQ(contours.size(), radii.size());
+    for (size_t i = 0; i < contours.size(); ++i) {
+        SCOPED_TRACE("contour " + std::to_string(i));
+        const sketch::Contour& c = contours[i];
+        EXPECT_TRUE(c.closed);
+        ASSERT_EQ(c.entities.size(), 1u);
+        ASSERT_EQ(c.entities[0].type, sketch::EntityType::Circle);
+        EXPECT_NEAR(c.entities[0].radius, radii[i], tol);
+        EXPECT_NEAR(geometry::length(c.entities[0].points[0]), 0.0, tol);
+        EXPECT_EQ(c.hole, i > 0);
+    }
+}
+
+void expectSameLayers(const brep::SliceResult& a, const brep::SliceResult& b)
+{
+    ASSERT_EQ(a.layers.size(), b.layers.size());
+    for (size_t i = 0; i < a.layers.size(); ++i) {
+        EXPECT_EQ(a.layers[i].offset, b.layers[i].offset);
+        ASSERT_EQ(a.layers[i].contours.size(), b.layers[i].contours.size());
+        for (size_t k = 0; k < a.layers[i].contours.size(); ++k) {
+            EXPECT_EQ(a.layers[i].contours[k].points, b.layers[i].contours[k].points);
+            EXPECT_EQ(a.layers[i].contours[k].area, b.layers[i].contours[k].area);
+        }
+    }
+}
+
+}  // anonymous namespace
+
+// ---- Mesh path ------------------------------------------------------
+
+TEST(MeshSlice, BoxSectionsAlongEachAxis)
+{
+    const mesh::TriangleMesh box = boxMesh(10.0, 20.0, 30.0);
+    const std::vector<mesh::MeshSection> z = mesh::sliceMesh(box, zPlanes({0.5, 15.0, 29.5, 31.0}));
+    ASSERT_EQ(z.size(), 4u);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(z[i].loops.size(), 1u);
+        EXPECT_TRUE(z[i].chains.empty());
+        EXPECT_NEAR(loopArea(z[i]), 200.0, 1e-9);
+    }
+    EXPECT_TRUE(z[3].loops.empty());
+    EXPECT_EQ(z[1].offset, 15.0);
+
+    // Planes normal to X map onto the YZ sketch plane
+    mesh::SlicePlanes x = zPlanes({4.0});
+    x.normal = {1.0, 0.0, 0.0};
+    const std::vector<mesh::MeshSection> yz = mesh::sliceMesh(box, x);
+    ASSERT_EQ(yz.size(), 1u);
+    ASSERT_EQ(yz[0].loops.size(), 1u);
+    EXPECT_NEAR(loopArea(yz[0]), 600.0, 1e-9);
+    for (const Point2D& p : yz[0].loops[0]) {
+        const bool onSide = std::abs(p.x) < 1e-9 || std::abs(p.x - 20.0) < 1e-9;
+        const bool onEnd = std::abs(p.y) < 1e-9 || std::abs(p.y - 30.0) < 1e-9;
+        EXPECT_TRUE(onSide || onEnd) << p.x << ", " << p.y;
+        EXPECT_TRUE(p.x > -1e-9 && p.x < 20.0 + 1e-9 && p.y > -1e-9 && p.y < 30.0 + 1e-9);
+    }
+}
+
+TEST(MeshSlice, CylinderAndTubeSectionsRecoverCircles)
+{
+    const std::vector<double> heights = {0.1, 7.5, 15.0, 22.5, 29.9};
+    sketch::ContourFitOptions fit;
+    fit.tolerance = 2.0 * sagitta(kRadius, kSegments);
+
+    const std::vector<mesh::MeshSection> solid =
+        mesh::sliceMesh(tubeMesh(kRadius, 0.0, kHeight, kSegments), zPlanes(heights));
+    const std::vector<mesh::MeshSection> tube =
+        mesh::sliceMesh(tubeMesh(kRadius, kRadius / 2.0, kHeight, kSegments), zPlanes(heights));
+    ASSERT_EQ(solid.size(), heights.size());
+    ASSERT_EQ(tube.size(), heights.size());
+    for (size_t i = 0; i < heights.size(); ++i) {
+        SCOPED_TRACE("z = " + std::to_string(heights[i]));
+        // The polygons are exact; the fitted circles are within the fit
+        EXPECT_NEAR(loopArea(solid[i]), polygonArea(kRadius, kSegments), 1e-9);
+        EXPECT_NEAR(loopArea(tube[i]), polygonArea(kRadius, kSegments) - polygonArea(kRadius / 2.0, kSegments),
+                    1e-9);
+
+        const std::vector<sketch::Contour> disc = sketch::buildContours(solid[i].loops, solid[i].chains, fit);
+        expectCircles(disc, {kRadius}, fit.tolerance);
+        EXPECT_NEAR(disc[0].area, kPi * kRadius * kRadius, 2.0 * kPi * kRadius * fit.tolerance);
+
+        const std::vector<sketch::Contour> ring = sketch::buildContours(tube[i].loops, tube[i].chains, fit);
+        expectCircles(ring, {kRadius, kRadius / 2.0}, fit.tolerance);
+        EXPECT_NEAR(ring[0].area + ring[1].area, 0.75 * kPi * kRadius * kRadius,
+                    3.0 * kPi * kRadius * fit.tolerance);
+    }
+
+    // Without arc recovery the same sections stay polygons of lines
+    fit.recoverArcs = false;
+    const std::vector<sketch::Contour> lines = sketch::buildContours(solid[2].loops, {}, fit);
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(countEntities(lines, sketch::EntityType::Circle), 0);
+    EXPECT_EQ(countEntities(lines, sketch::EntityType::Line), kSegments);
+}
+
+TEST(MeshSlice, SphereSectionsApproachTheCircle)
+{
+    const mesh::TriangleMesh sphere = sphereMesh(kRadius, 96, 48);
+    std::vector<double> heights;
+    for (int i = -8; i <= 8; ++i) heights.push_back(i * kRadius / 10.0 + 0.01);
+    const std::vector<mesh::MeshSection> sections = mesh::sliceMesh(sphere, zPlanes(heights));
+    ASSERT_EQ(sections.size(), heights.size());
+    for (size_t i = 0; i < heights.size(); ++i) {
+        SCOPED_TRACE("z = " + std::to_string(heights[i]));
+        ASSERT_EQ(sections[i].loops.size(), 1u);
+        EXPECT_TRUE(sections[i].chains.empty());
+        // An inscribed polyhedron: a little under the true section
+        const double area = loopArea(sections[i]);
+        const double exact = sphereSectionArea(kRadius, heights[i]);
+        EXPECT_LT(area, exact);
+        EXPECT_GT(area, 0.99 * exact);
+    }
+}
+
+TEST(MeshSlice, OpenMeshGivesChains)
+{
+    mesh::TriangleMesh box = boxMesh(10.0, 10.0, 10.0);
+    box.triangles.erase(box.triangles.begin() + 4, box.triangles.begin() + 6);   // The y = 0 side
+    const std::vector<mesh::MeshSection> sections = mesh::sliceMesh(box, zPlanes({5.0}));
+    ASSERT_EQ(sections.size(), 1u);
+    EXPECT_TRUE(sections[0].loops.empty());
+    ASSERT_EQ(sections[0].chains.size(), 1u);
+
+    // The chain runs round the three remaining sides, ending at the gap
+    const std::vector<Point2D>& chain = sections[0].chains[0];
+    EXPECT_NEAR(chain.front().y, 0.0, 1e-9);
+    EXPECT_NEAR(chain.back().y, 0.0, 1e-9);
+    EXPECT_NEAR(std::abs(chain.back().x - chain.front().x), 10.0, 1e-9);
+    double length = 0.0;
+    for (size_t i = 1; i < chain.size(); ++i) length += geometry::length(chain[i] - chain[i - 1]);
+    EXPECT_NEAR(length, 30.0, 1e-9);
+}
+
+TEST(MeshSlice, ParallelMatchesSerialInOffsetOrder)
+{
+    const mesh::TriangleMesh sphere = sphereMesh(kRadius, 64, 32);
+    const mesh::SlicePlanes planes = zPlanes({3.0, -9.0, 0.5, 12.0, -2.5, 7.25});
+    const std::vector<mesh::MeshSection> parallel = mesh::sliceMesh(sphere, planes, true);
+    const std::vector<mesh::MeshSection> serial = mesh::sliceMesh(sphere, planes, false);
+    ASSERT_EQ(parallel.size(), planes.offsets.size());
+    ASSERT_EQ(serial.size(), planes.offsets.size());
+    for (size_t i = 0; i < planes.offsets.size(); ++i) {
+        EXPECT_EQ(parallel[i].offset, planes.offsets[i]);
+        EXPECT_EQ(parallel[i].loops, serial[i].loops);
+        EXPECT_EQ(parallel[i].chains, serial[i].chains);
+    }
+    EXPECT_TRUE(parallel[3].loops.empty());
+    EXPECT_GT(loopArea(parallel[2]), loopArea(parallel[0]));
+}
+
+// ---- B-rep path -----------------------------------------------------
+
+TEST(BrepSlice, ExactSectionsMatchClosedForms)
+{
+    const std::vector<double> heights = {-1.0, 0.5, 5.0, 15.0, 29.5};
+    const mesh::SlicePlanes planes = zPlanes(heights);
+
+    const brep::SliceResult box = brep::sliceShape(BRepPrimAPI_MakeBox(10.0, 20.0, kHeight).Shape(), planes);
+    ASSERT_TRUE(box.success) << box.errorMessage;
+    EXPECT_EQ(box.openContours, 0);
+    ASSERT_EQ(box.layers.size(), heights.size());
+    EXPECT_TRUE(box.layers[0].contours.empty());
+    for (size_t i = 1; i < heights.size(); ++i) {
+        EXPECT_EQ(box.layers[i].offset, heights[i]);
+        EXPECT_NEAR(box.layers[i].area(), 200.0, 1e-6);
+        EXPECT_EQ(countEntities(box.layers[i].contours, sketch::EntityType::Line), 4);
+    }
+
+    const brep::SliceResult cylinder =
+        brep::sliceShape(BRepPrimAPI_MakeCylinder(kRadius, kHeight).Shape(), planes);
+    ASSERT_TRUE(cylinder.success) << cylinder.errorMessage;
+    EXPECT_TRUE(cylinder.layers[0].contours.empty());
+    for (size_t i = 1; i < heights.size(); ++i) {
+        SCOPED_TRACE("z = " + std::to_string(heights[i]));
+        expectCircles(cylinder.layers[i].contours, {kRadius}, 1e-3);
+        EXPECT_NEAR(cylinder.layers[i].area(), kPi * kRadius * kRadius, 1e-2);
+    }
+
+    std::vector<double> sphereHeights;
+    for (int i = -9; i <= 9; ++i) sphereHeights.push_back(i * kRadius / 10.0);
+    const brep::SliceResult sphere =
+        brep::sliceShape(BRepPrimAPI_MakeSphere(kRadius).Shape(), zPlanes(sphereHeights));
+    ASSERT_TRUE(sphere.success) << sphere.errorMessage;
+    for (size_t i = 0; i < sphereHeights.size(); ++i) {
+        SCOPED_TRACE("z = " + std::to_string(sphereHeights[i]));
+        const double r = std::sqrt(kRadius * kRadius - sphereHeights[i] * sphereHeights[i]);
+        expectCircles(sphere.layers[i].contours, {r}, 1e-3);
+        EXPECT_NEAR(sphere.layers[i].area(), sphereSectionArea(kRadius, sphereHeights[i]), 1e-2);
+    }
+}
+
+TEST(BrepSlice, MeshMethodMatchesWithinDeflection)
+{
+    brep::SliceOptions options;
+    options.method = brep::SliceMethod::Mesh;
+    options.deflection = 0.01;
+    const double tol = 2.0 * options.deflection;
+
+    const std::vector<double> heights = {0.5, 15.0, 29.5};
+    const brep::SliceResult box =
+        brep::sliceShape(BRepPrimAPI_MakeBox(10.0, 20.0, kHeight).Shape(), zPlanes(heights), options);
+    ASSERT_TRUE(box.success) << box.errorMessage;
+    for (const brep::SliceLayer& layer : box.layers) EXPECT_NEAR(layer.area(), 200.0, 1e-6);
+
+    const brep::SliceResult cylinder =
+        brep::sliceShape(BRepPrimAPI_MakeCylinder(kRadius, kHeight).Shape(), zPlanes(heights), options);
+    ASSERT_TRUE(cylinder.success) << cylinder.errorMessage;
+    for (const brep::SliceLayer& layer : cylinder.layers) {
+        SCOPED_TRACE("z = " + std::to_string(layer.offset));
+        expectCircles(layer.contours, {kRadius}, tol);
+        EXPECT_NEAR(layer.area(), kPi * kRadius * kRadius, 2.0 * kPi * kRadius * tol);
+    }
+
+    const std::vector<double> sphereHeights = {-7.5, -2.5, 0.3, 4.0, 8.0};
+    const brep::SliceResult sphere =
+        brep::sliceShape(BRepPrimAPI_MakeSphere(kRadius).Shape(), zPlanes(sphereHeights), options);
+    ASSERT_TRUE(sphere.success) << sphere.errorMessage;
+    for (size_t i = 0; i < sphereHeights.size(); ++i) {
+        SCOPED_TRACE("z = " + std::to_string(sphereHeights[i]));
+        const double r = std::sqrt(kRadius * kRadius - sphereHeights[i] * sphereHeights[i]);
+        EXPECT_NEAR(sphere.layers[i].area(), kPi * r * r, 2.0 * kPi * r * tol);
+    }
+}
+
+TEST(BrepSlice, ParallelMatchesSerial)
+{
+    const TopoDS_Shape sphere = BRepPrimAPI_MakeSphere(kRadius).Shape();
+    const mesh::SlicePlanes planes = zPlanes({3.0, -9.0, 0.5, 12.0, -2.5, 7.25});
+    for (brep::SliceMethod method : {brep::SliceMethod::Exact, brep::SliceMethod::Mesh}) {
+        brep::SliceOptions options;
+        options.method = method;
+        options.parallel = true;
+        const brep::SliceResult parallel = brep::sliceShape(sphere, planes, options);
+        options.parallel = false;
+        const brep::SliceResult serial = brep::sliceShape(sphere, planes, options);
+        ASSERT_TRUE(parallel.success && serial.success);
+        expectSameLayers(parallel, serial);
+        EXPECT_TRUE(parallel.layers[3].contours.empty());
+    }
+}
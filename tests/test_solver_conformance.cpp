@@ -0,0 +1,233 @@
+// =====================================================================
+//  tests/test_solver_conformance.cpp — Native vs. libslvs solver
+// =====================================================================
+//
+//  Solves the same fixed sketches with every available backend and
+//  checks that each reaches the known solution with the expected
+//  degrees of freedom, and that the backends agree with each other.
+//  The libslvs half is skipped when the library was built without it.
+//
+//  Both backends model arcs as center + radius, so the sketches use
+//  points, lines and circles.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/sketch/solver.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::sketch;
+
+namespace {
+
+constexpr double kTolerance = 1e-6;
+
+struct Sketch {
+    std::vector<Entity> entities;
+    std::vector<Constraint> constraints;
+
+    void add(ConstraintType type, std::vector<int> entityIds,
+             std::vector<int> pointIndices = {}, double value = 0.0)
+    {
+        Constraint c;
+        c.id = static_cast<int>(constraints.size()) + 1;
+        c.type = type;
+        c.entityIds = std::move(entityIds);
+        c.pointIndices = std::move(pointIndices);
+        c.value = value;
+        constraints.push_back(c);
+    }
+};
+
+/// 40 x 25 rectangle anchored at the origin, drawn slightly off
+Sketch rectangle()
+{
+    Sketch s;
+    s.entities.push_back(createLine(1, {0.3, -0.2}, {38.0, 1.1}));
+    s.entities.push_back(createLine(2, {38.4, 0.7}, {41.0, 24.0}));
+    s.entities.push_back(createLine(3, {40.6, 24.8}, {-0.5, 26.0}));
+    s.entities.push_back(createLine(4, {-0.9, 25.3}, {0.6, 0.4}));
+
+    s.add(ConstraintType::Coincident, {1, 2}, {1, 0});
+    s.add(ConstraintType::Coincident, {2, 3}, {1, 0});
+    s.add(ConstraintType::Coincident, {3, 4}, {1, 0});
+    s.add(ConstraintType::Coincident, {4, 1}, {1, 0});
+    s.add(ConstraintType::Horizontal, {1});
+    s.add(ConstraintType::Horizontal, {3});
+    s.add(ConstraintType::Vertical, {2});
+    s.add(ConstraintType::Vertical, {4});
+    s.add(ConstraintType::FixedPoint, {1}, {0});
+    s.entities[0].points[0] = {0, 0};
+    s.add(ConstraintType::Distance, {1, 1}, {0, 1}, 40.0);
+    s.add(ConstraintType::Distance, {2, 2}, {0, 1}, 25.0);
+    return s;
+}
+
+/// Circle of radius 5 tangent to a fixed circle of radius 10, its
+/// center held on the X axis by a horizontal line from the origin
+Sketch tangentCircles()
+{
+    Sketch s;
+    s.entities.push_back(createCircle(1, {0, 0}, 9.0));
+    s.entities.push_back(createLine(2, {0, 0}, {13.5, 0.8}));
+    s.entities.push_back(createCircle(3, {14.0, 1.0}, 4.0));
+
+    s.add(ConstraintType::FixedPoint, {1}, {0});
+    s.add(ConstraintType::Radius, {1}, {}, 10.0);
+    s.add(ConstraintType::Radius, {3}, {}, 5.0);
+    s.add(ConstraintType::Coincident, {2, 1}, {0, 0});
+    s.add(ConstraintType::Horizontal, {2});
+    s.add(ConstraintType::Coincident, {2, 3}, {1, 0});
+    s.add(ConstraintType::Tangent, {1, 3});
+    return s;
+}
+
+/// Triangle with one fixed corner: 12 parameters, 2 locked, 6 equations
+Sketch looseTriangle()
+{
+    Sketch s;
+    s.entities.push_back(createLine(1, {0, 0}, {30, 1}));
+    s.entities.push_back(createLine(2, {29, 0}, {14, 20}));
+    s.entities.push_back(createLine(3, {15, 21}, {1, -1}));
+
+    s.add(ConstraintType::FixedPoint, {1}, {0});
+    s.add(ConstraintType::Coincident, {1, 2}, {1, 0});
+    s.add(ConstraintType::Coincident, {2, 3}, {1, 0});
+    s.add(ConstraintType::Coincident, {3, 1}, {1, 0});
+    return s;
+}
+
+struct Outcome {
+    SolveResult result;
+    int dof = 0;
+    std::vector<Entity> entities;
+};
+
+Outcome solveWith(SolverBackend backend, const Sketch& sketch)
+{
+    Solver solver(backend);
+    EXPECT_EQ(solver.activeBackend(), backend);
+
+    Outcome out;
+    out.entities = sketch.entities;
+    out.dof = solver.degreesOfFreedom(sketch.entities, sketch.constraints);
+    out.result = solver.solve(out.entities, sketch.constraints);
+    return out;
+}
+
+/// Backends to compare: native always, libslvs when compiled in
+std::vector<SolverBackend> backends()
+{
+    std::vector<SolverBackend> list = {SolverBackend::Native};
+    if (Solver::isBackendAvailable(SolverBackend::SolveSpace)) {
+        list.push_back(SolverBackend::SolveSpace);
+    }
+    return list;
+}
+
+void expectPoint(const Point2D& p, double x, double y)
+{
+    EXPECT_NEAR(p.x, x, kTolerance);
+    EXPECT_NEAR(p.y, y, kTolerance);
+}
+
+void expectSameGeometry(const std::vector<Entity>& a, const std::vector<Entity>& b)
+{
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        SCOPED_TRACE("entity " + std::to_string(a[i].id));
+        ASSERT_EQ(a[i].points.size(), b[i].points.size());
+        for (size_t p = 0; p < a[i].points.size(); ++p) {
+            EXPECT_NEAR(a[i].points[p].x, b[i].points[p].x, kTolerance);
+            EXPECT_NEAR(a[i].points[p].y, b[i].points[p].y, kTolerance);
+        }
+        EXPECT_NEAR(a[i].radius, b[i].radius, kTolerance);
+    }
+}
+
+/// Solve with every backend, run per-backend checks, and compare
+/// solutions and DOF across backends when more than one is present
+template <typename Check>
+void conformance(const Sketch& sketch, bool compareGeometry, Check&& check)
+{
+    std::vector<Outcome> outcomes;
+    for (SolverBackend backend : backends()) {
+        SCOPED_TRACE(solverBackendName(backend));
+        outcomes.push_back(solveWith(backend, sketch));
+        check(outcomes.back());
+    }
+    for (size_t i = 1; i < outcomes.size(); ++i) {
+        SCOPED_TRACE("native vs " + solverBackendName(backends()[i]));
+        EXPECT_EQ(outcomes[0].result.success, outcomes[i].result.success);
+        EXPECT_EQ(outcomes[0].result.dof, outcomes[i].result.dof);
+        EXPECT_EQ(outcomes[0].dof, outcomes[i].dof);
+        if (compareGeometry) {
+            expectSameGeometry(outcomes[0].entities, outcomes[i].entities);
+        }
+    }
+}
+
+}  // anonymous namespace
+
+// ---- Fully constrained ----------------------------------------------
+
+TEST(SolverConformance, Rectangle)
+{
+    conformance(rectangle(), true, [](const Outcome& out) {
+        ASSERT_TRUE(out.result.success) << out.result.errorMessage;
+        EXPECT_EQ(out.result.dof, 0);
+        EXPECT_EQ(out.dof, 0);
+        expectPoint(out.entities[0].points[0], 0, 0);
+        expectPoint(out.entities[0].points[1], 40, 0);
+        expectPoint(out.entities[1].points[1], 40, 25);
+        expectPoint(out.entities[2].points[1], 0, 25);
+    });
+}
+
+TEST(SolverConformance, TangentCircles)
+{
+    conformance(tangentCircles(), true, [](const Outcome& out) {
+        ASSERT_TRUE(out.result.success) << out.result.errorMessage;
+        EXPECT_EQ(out.result.dof, 0);
+        EXPECT_EQ(out.dof, 0);
+        EXPECT_NEAR(out.entities[0].radius, 10.0, kTolerance);
+        EXPECT_NEAR(out.entities[2].radius, 5.0, kTolerance);
+        expectPoint(out.entities[2].points[0], 15, 0);
+    });
+}
+
+// ---- Under- and over-constrained ------------------------------------
+
+TEST(SolverConformance, UnderConstrainedDof)
+{
+    // Free solutions may legitimately differ, so only the constraints
+    // and the remaining freedom are compared
+    conformance(looseTriangle(), false, [](const Outcome& out) {
+        ASSERT_TRUE(out.result.success) << out.result.errorMessage;
+        EXPECT_EQ(out.result.dof, 4);
+        EXPECT_EQ(out.dof, 4);
+        const auto& e = out.entities;
+        expectPoint(e[0].points[0], 0, 0);
+        expectPoint(e[1].points[0], e[0].points[1].x, e[0].points[1].y);
+        expectPoint(e[2].points[0], e[1].points[1].x, e[1].points[1].y);
+        expectPoint(e[0].points[0], e[2].points[1].x, e[2].points[1].y);
+    });
+}
+
+TEST(SolverConformance, ConflictingDimensionFails)
+{
+    Sketch sketch = rectangle();
+    sketch.add(ConstraintType::Distance, {3, 3}, {0, 1}, 55.0);  // Opposite side is 40
+
+    conformance(sketch, false, [&](const Outcome& out) {
+        EXPECT_FALSE(out.result.success);
+        // Failed solves leave the entities as drawn
+        expectSameGeometry(out.entities, sketch.entities);
+    });
+}
@@ -0,0 +1,299 @@
+// =====================================================================
+//  tests/test_spline.cpp — B-spline / NURBS kernel against OCCT
+// =====================================================================
+//
+//  Builds random B-spline and NURBS curves (degree 1 to 5, random
+//  knot vectors with interior multiplicities up to the degree) both
+//  as geometry::BSplineCurve2D and as OCCT's Geom2d_BSplineCurve, and
+//  checks that de Boor evaluation, derivatives, knot insertion and
+//  arc length agree.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/geometry/spline.h>
+#include <hobbycad/geometry/utils.h>
+
+#include <gtest/gtest.h>
+
+#include <GCPnts_AbscissaPoint.hxx>
+#include <Geom2dAdaptor_Curve.hxx>
+#include <Geom2d_BSplineCurve.hxx>
+#include <TColStd_Array1OfInteger.hxx>
+#include <TColStd_Array1OfReal.hxx>
+#include <TColgp_Array1OfPnt2d.hxx>
+#include <gp_Pnt2d.hxx>
+#include <gp_Vec2d.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::geometry;
+
+namespace {
+
+constexpr int kCurves = 200;
+constexpr int kSamples = 40;
+
+/// Pole coordinates are within ±kExtent, so point errors are judged
+/// against it
+constexpr double kExtent = 50.0;
+
+/// A curve definition in the distinct-knot form OCCT takes
+struct RandomCurve {
+    int degree = 1;
+    std::vector<Point2D> poles;
+    std::vector<double> weights;        ///< Empty for a non-rational curve
+    std::vector<double> knots;          ///< Distinct, ascending
+    std::vector<int> mults;
+};
+
+/// Clamped ends, random interior knots with multiplicity 1..degree
+RandomCurve randomCurve(std::mt19937& rng, bool rational)
+{
+    std::uniform_int_distribution<int> degreeDist(1, 5);
+    std::uniform_int_distribution<int> interiorDist(0, 6);
+    std::uniform_real_distribution<double> gapDist(0.2, 2.0);
+    std::uniform_real_distribution<double> coordDist(-kExtent, kExtent);
+    std::uniform_real_distribution<double> weightDist(0.3, 3.0);
+
+    RandomCurve c;
+    c.degree = degreeDist(rng);
+    std::uniform_int_distribution<int> multDist(1, c.degree);
+
+    const int interior = interiorDist(rng);
+    double knot = std::uniform_real_distribution<double>(-3.0, 3.0)(rng);
+    c.knots.push_back(knot);
+    c.mults.push_back(c.degree + 1);
+    for (int i = 0; i < interior; ++i) {
+        knot += gapDist(rng);
+        c.knots.push_back(knot);
+        c.mults.push_back(multDist(rng));
+    }
+    c.knots.push_back(knot + gapDist(rng));
+    c.mults.push_back(c.degree + 1);
+
+    int flat = 0;
+    for (int m : c.mults) flat += m;
+    const int poles = flat - c.degree - 1;
+    for (int i = 0; i < poles; ++i) {
+        c.poles.push_back({coordDist(rng), coordDist(rng)});
+        if (rational) c.weights.push_back(weightDist(rng));
+    }
+    return c;
+}
+
+BSplineCurve2D toKernel(const RandomCurve& c)
+{
+    std::vector<double> flat;
+    for (size_t i = 0; i < c.knots.size(); ++i) {
+        flat.insert(flat.end(), c.mults[i], c.knots[i]);
+    }
+    return BSplineCurve2D(c.degree, c.poles, flat, c.weights);
+}
+
+Handle(Geom2d_BSplineCurve) toOcct(const RandomCurve& c)
+{
+    const int n = static_cast<int>(c.poles.size());
+    const int k = static_cast<int>(c.knots.size());
+    TColgp_Array1OfPnt2d poles(1, n);
+    TColStd_Array1OfReal weights(1, n);
+    TColStd_Array1OfReal knots(1, k);
+    TColStd_Array1OfInteger mults(1, k);
+    for (int i = 0; i < n; ++i) {
+        poles.SetValue(i + 1, gp_Pnt2d(c.poles[i].x, c.poles[i].y));
+        weights.SetValue(i + 1, c.weights.empty() ? 1.0 : c.weights[i]);
+    }
+    for (int i = 0; i < k; ++i) {
+        knots.SetValue(i + 1, c.knots[i]);
+        mults.SetValue(i + 1, c.mults[i]);
+    }
+    if (c.weights.empty()) {
+        return new Geom2d_BSplineCurve(poles, knots, mults, c.degree);
+    }
+    return new Geom2d_BSplineCurve(poles, weights, knots, mults, c.degree);
+}
+
+/// Random parameters inside the domain, plus both ends
+std::vector<double> sampleParameters(std::mt19937& rng, const RandomCurve& c)
+{
+    std::uniform_real_distribution<double> dist(c.knots.front(), c.knots.back());
+    std::vector<double> ts{c.knots.front(), c.knots.back()};
+    for (int i = 0; i < kSamples; ++i) ts.push_back(dist(rng));
+    return ts;
+}
+
+void expectNear(const Point2D& ours, double x, double y, double tolerance)
+{
+    EXPECT_NEAR(ours.x, x, tolerance);
+    EXPECT_NEAR(ours.y, y, tolerance);
+}
+
+/// Relative to the vector's size, since derivatives of rational
+/// curves with small weights get large
+void expectNear(const Point2D& ours, const gp_Vec2d& occt, double tolerance)
+{
+    const double scale = std::max(1.0, occt.Magnitude());
+    EXPECT_NEAR(ours.x, occt.X(), tolerance * scale);
+    EXPECT_NEAR(ours.y, occt.Y(), tolerance * scale);
+}
+
+std::string describe(int index, const RandomCurve& c)
+{
+    return "curve " + std::to_string(index) + ", degree " + std::to_string(c.degree) + ", " +
+           std::to_string(c.poles.size()) + " poles" + (c.weights.empty() ? "" : ", rational");
+}
+
+}  // anonymous namespace
+
+// ---- Evaluation -----------------------------------------------------
+
+TEST(BSplineCurve2D, PointsMatchOcct)
+{
+    std::mt19937 rng(94);
+    for (int i = 0; i < kCurves; ++i) {
+        const RandomCurve c = randomCurve(rng, i % 2 == 1);
+        const BSplineCurve2D ours = toKernel(c);
+        const Handle(Geom2d_BSplineCurve) occt = toOcct(c);
+        SCOPED_TRACE(describe(i, c));
+        ASSERT_TRUE(ours.isValid());
+        EXPECT_DOUBLE_EQ(ours.firstParameter(), occt->FirstParameter());
+        EXPECT_DOUBLE_EQ(ours.lastParameter(), occt->LastParameter());
+
+        // Every knot as well, where the span lookup changes
+        std::vector<double> ts = sampleParameters(rng, c);
+        ts.insert(ts.end(), c.knots.begin(), c.knots.end());
+        for (double t : ts) {
+            const gp_Pnt2d p = occt->Value(t);
+            expectNear(ours.point(t), p.X(), p.Y(), 1e-10 * kExtent);
+        }
+    }
+}
+
+TEST(BSplineCurve2D, DerivativesMatchOcct)
+{
+    std::mt19937 rng(1094);
+    for (int i = 0; i < kCurves; ++i) {
+        const RandomCurve c = randomCurve(rng, i % 2 == 1);
+        const BSplineCurve2D ours = toKernel(c);
+        const Handle(Geom2d_BSplineCurve) occt = toOcct(c);
+        SCOPED_TRACE(describe(i, c));
+
+        // Random parameters only: at an interior knot of full
+        // multiplicity the derivatives jump, and either side is right
+        for (double t : sampleParameters(rng, c)) {
+            gp_Pnt2d p;
+            gp_Vec2d d1, d2;
+            occt->D2(t, p, d1, d2);
+            const SplineDerivatives d = ours.derivatives(t);
+            expectNear(d.point, p.X(), p.Y(), 1e-10 * kExtent);
+            expectNear(d.first, d1, 1e-9);
+            if (c.degree >= 2) expectNear(d.second, d2, 1e-8);
+        }
+    }
+}
+
+// ---- Knot insertion -------------------------------------------------
+
+TEST(BSplineCurve2D, KnotInsertionMatchesOcct)
+{
+    std::mt19937 rng(2094);
+    for (int i = 0; i < kCurves; ++i) {
+        const RandomCurve c = randomCurve(rng, i % 2 == 1);
+        BSplineCurve2D ours = toKernel(c);
+        const BSplineCurve2D original = ours;
+        Handle(Geom2d_BSplineCurve) occt = toOcct(c);
+        SCOPED_TRACE(describe(i, c));
+
+        // Alternate between a new knot and raising an existing one,
+        // sometimes past the degree so both cap the multiplicity
+        double t = std::uniform_real_distribution<double>(c.knots.front(), c.knots.back())(rng);
+        if (i % 3 == 0 && c.knots.size() > 2) t = c.knots[1 + i % (c.knots.size() - 2)];
+        const int times = std::uniform_int_distribution<int>(1, c.degree + 1)(rng);
+
+        const int before = occt->NbPoles();
+        occt->InsertKnot(t, times);
+        const int inserted = ours.insertKnot(t, times);
+        EXPECT_EQ(inserted, occt->NbPoles() - before);
+
+        ASSERT_EQ(static_cast<int>(ours.poles().size()), occt->NbPoles());
+        for (int k = 0; k < occt->NbPoles(); ++k) {
+            const gp_Pnt2d pole = occt->Pole(k + 1);
+            expectNear(ours.poles()[k], pole.X(), pole.Y(), 1e-10 * kExtent);
+            if (ours.isRational()) EXPECT_NEAR(ours.weights()[k], occt->Weight(k + 1), 1e-12);
+        }
+
+        std::vector<double> values;
+        std::vector<int> mults;
+        ours.knotMultiplicities(&values, &mults);
+        ASSERT_EQ(static_cast<int>(values.size()), occt->NbKnots());
+        for (int k = 0; k < occt->NbKnots(); ++k) {
+            EXPECT_DOUBLE_EQ(values[k], occt->Knot(k + 1));
+            EXPECT_EQ(mults[k], occt->Multiplicity(k + 1));
+        }
+
+        // The shape is unchanged
+        for (double s : sampleParameters(rng, c)) {
+            const Point2D a = original.point(s);
+            expectNear(ours.point(s), a.x, a.y, 1e-10 * kExtent);
+        }
+    }
+}
+
+// ---- Arc length -----------------------------------------------------
+
+TEST(BSplineCurve2D, ArcLengthMatchesOcct)
+{
+    std::mt19937 rng(3094);
+    for (int i = 0; i < kCurves; ++i) {
+        const RandomCurve c = randomCurve(rng, i % 2 == 1);
+        const BSplineCurve2D ours = toKernel(c);
+        const Handle(Geom2d_BSplineCurve) occt = toOcct(c);
+        const Geom2dAdaptor_Curve adaptor(occt);
+        SCOPED_TRACE(describe(i, c));
+
+        const double first = occt->FirstParameter();
+        const double total = GCPnts_AbscissaPoint::Length(adaptor, first, occt->LastParameter(), 1e-10);
+        EXPECT_NEAR(ours.length(), total, 1e-7 * total);
+
+        for (double t : sampleParameters(rng, c)) {
+            const double expected = GCPnts_AbscissaPoint::Length(adaptor, first, t, 1e-10);
+            EXPECT_NEAR(ours.lengthAt(t), expected, 1e-7 * total);
+
+            // parameterAtLength inverts it, wherever the curve moves
+            if (geometry::length(ours.derivatives(t).first) > 1e-6) {
+                EXPECT_NEAR(ours.lengthAt(ours.parameterAtLength(expected)), expected, 1e-7 * total);
+            }
+        }
+    }
+}
+
+// ---- Catmull-Rom ----------------------------------------------------
+
+TEST(BSplineCurve2D, CatmullRomPassesThroughItsPoints)
+{
+    std::mt19937 rng(4094);
+    std::uniform_real_distribution<double> coordDist(-kExtent, kExtent);
+    std::vector<Point2D> points;
+    for (int i = 0; i < 30; ++i) points.push_back({coordDist(rng), coordDist(rng)});
+
+    const BSplineCurve2D curve = BSplineCurve2D::fromCatmullRom(points);
+    ASSERT_TRUE(curve.isValid());
+    RandomCurve c;
+    c.degree = curve.degree();
+    c.poles = curve.poles();
+    curve.knotMultiplicities(&c.knots, &c.mults);
+    const Handle(Geom2d_BSplineCurve) occt = toOcct(c);
+
+    for (size_t i = 0; i < points.size(); ++i) {
+        SCOPED_TRACE("point " + std::to_string(i));
+        expectNear(curve.point(static_cast<double>(i)), points[i].x, points[i].y, 1e-12 * kExtent);
+        const gp_Pnt2d p = occt->Value(static_cast<double>(i));
+        expectNear(points[i], p.X(), p.Y(), 1e-12 * kExtent);
+    }
+}
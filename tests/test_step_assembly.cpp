@@ -0,0 +1,344 @@
+// =====================================================================
+//  tests/test_step_assembly.cpp — STEP assembly export
+// =====================================================================
+//
+//  Exports generated pattern projects with writeStepAssembly() and
+//  reads them back through XDE (STEPCAFControl_Reader): a circular
+//  pattern of one part, made both from shared-TShape copies and from
+//  independent transformed copies, must come back as one shared part
+//  definition with one located instance per body, each where the body
+//  was, with its names and colour.  The file must be much smaller than
+//  the flat writeStep() export of the same bodies.  Also covers
+//  mirror images, turning deduplication off and a single body.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/step_io.h>
+
+#include <gtest/gtest.h>
+
+#include <BRepBuilderAPI_Transform.hxx>
+#include <BRepGProp.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <BRepPrimAPI_MakeWedge.hxx>
+#include <GProp_GProps.hxx>
+#include <IFSelect_ReturnStatus.hxx>
+#include <Quantity_Color.hxx>
+#include <STEPCAFControl_Reader.hxx>
+#include <TCollection_AsciiString.hxx>
+#include <TDF_Label.hxx>
+#include <TDF_LabelSequence.hxx>
+#include <TDataStd_Name.hxx>
+#include <TDocStd_Document.hxx>
+#include <TopLoc_Location.hxx>
+#include <XCAFApp_Application.hxx>
+#include <XCAFDoc_ColorTool.hxx>
+#include <XCAFDoc_DocumentTool.hxx>
+#include <XCAFDoc_ShapeTool.hxx>
+#include <gp_Ax1.hxx>
+#include <gp_Ax2.hxx>
+#include <gp_Trsf.hxx>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace hobbycad;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+constexpr int kInstances = 16;
+constexpr double kPatternRadius = 60.0;
+
+/// A three-quarter cylinder: its curved faces make a part definition
+/// large next to an instance
+TopoDS_Shape makePart()
+{
+    return BRepPrimAPI_MakeCylinder(gp_Ax2(), 8.0, 20.0, 1.5 * kPi).Shape();
+}
+
+/// Placement of instance i on the circular pattern
+gp_Trsf patternPlacement(int i)
+{
+    gp_Trsf rotation;
+    rotation.SetRotation(gp_Ax1(gp_Pnt(), gp_Dir(0, 0, 1)), 2.0 * kPi * i / kInstances);
+    gp_Trsf offset;
+    offset.SetTranslation(gp_Vec(kPatternRadius, 0.0, 0.0));
+    return rotation * offset;
+}
+
+/// A circular pattern as the 3D pattern feature builds it: even
+/// instances share the part's TShape under a location, odd ones are
+/// transformed copies with geometry of their own
+std::vector<step_io::AssemblyBody> patternBodies()
+{
+    const TopoDS_Shape part = makePart();
+    std::vector<step_io::AssemblyBody> bodies(kInstances);
+    for (int i = 0; i < kInstances; ++i) {
+        bodies[i].shape = i % 2 == 0
+            ? part.Moved(TopLoc_Location(patternPlacement(i)))
+            : BRepBuilderAPI_Transform(part, patternPlacement(i), Standard_True).Shape();
+        bodies[i].name = "Bracket " + std::to_string(i + 1);
+        bodies[i].hasColor = true;
+        bodies[i].red = 0.8;
+        bodies[i].green = 0.4;
+        bodies[i].blue = 0.1;
+    }
+    return bodies;
+}
+
+gp_Pnt centreOfMass(const TopoDS_Shape& shape)
+{
+    GProp_GProps props;
+    BRepGProp::VolumeProperties(shape, props);
+    return props.CentreOfMass();
+}
+
+std::string nameOf(const TDF_Label& label)
+{
+    Handle(TDataStd_Name) name;
+    if (!label.FindAttribute(TDataStd_Name::GetID(), name)) return {};
+    return TCollection_AsciiString(name->Get()).ToCString();
+}
+
+/// Output file in the temp directory, removed with the test
+class StepAssemblyTest : public ::testing::Test {
+protected:
+    void TearDown() override
+    {
+        for (const std::string& path : m_paths) std::filesystem::remove(path);
+        if (!m_document.IsNull() && m_document->IsOpened()) {
+            XCAFApp_Application::GetApplication()->Close(m_document);
+        }
+    }
+
+    std::string tempPath(const std::string& name)
+    {
+        const ::testing::TestInfo* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        m_paths.push_back((std::filesystem::temp_directory_path() /
+                           (std::string("hobbycad_") + info->name() + "_" + name + ".step")).string());
+        return m_paths.back();
+    }
+
+    /// Read a file into a fresh XDE document, with names and colours
+    Handle(XCAFDoc_ShapeTool) readBack(const std::string& path)
+    {
+        if (!m_document.IsNull() && m_document->IsOpened()) {
+            XCAFApp_Application::GetApplication()->Close(m_document);
+        }
+        XCAFApp_Application::GetApplication()->NewDocument("MDTV-XCAF", m_document);
+        STEPCAFControl_Reader reader;
+        reader.SetNameMode(Standard_True);
+        reader.SetColorMode(Standard_True);
+        EXPECT_EQ(reader.ReadFile(path.c_str()), IFSelect_RetDone);
+        EXPECT_TRUE(reader.Transfer(m_document));
+        m_colors = XCAFDoc_DocumentTool::ColorTool(m_document->Main());
+        return XCAFDoc_DocumentTool::ShapeTool(m_document->Main());
+    }
+
+    /// Colour found on a label or on its shape
+    bool colorOf(const TDF_Label& label, Quantity_Color* color) const
+    {
+        for (XCAFDoc_ColorType type : {XCAFDoc_ColorGen, XCAFDoc_ColorSurf}) {
+            if (m_colors->GetColor(label, type, *color)) return true;
+        }
+        const TopoDS_Shape shape = XCAFDoc_ShapeTool::GetShape(label);
+        return m_colors->GetColor(shape, XCAFDoc_ColorSurf, *color) ||
+               m_colors->GetColor(shape, XCAFDoc_ColorGen, *color);
+    }
+
+    /// Parts (simple shapes) among the document's top-level shapes
+    static int countParts(const Handle(XCAFDoc_ShapeTool)& shapes)
+    {
+        TDF_LabelSequence labels;
+        shapes->GetShapes(labels);
+        int parts = 0;
+        for (int i = 1; i <= labels.Length(); ++i) {
+            if (XCAFDoc_ShapeTool::IsSimpleShape(labels(i))) ++parts;
+        }
+        return parts;
+    }
+
+private:
+    std::vector<std::string> m_paths;
+    Handle(TDocStd_Document) m_document;
+    Handle(XCAFDoc_ColorTool) m_colors;
+};
+
+}  // anonymous namespace
+
+// ---- Shared instances -----------------------------------------------
+
+TEST_F(StepAssemblyTest, PatternSharesOneDefinition)
+{
+    const std::vector<step_io::AssemblyBody> bodies = patternBodies();
+    step_io::AssemblyOptions options;
+    options.assemblyName = "Pattern";
+    const std::string path = tempPath("assembly");
+    const step_io::WriteResult written = step_io::writeStepAssembly(path, bodies, options);
+    ASSERT_TRUE(written.success) << written.errorMessage;
+    EXPECT_EQ(written.partCount, 1);
+    EXPECT_EQ(written.instanceCount, kInstances);
+
+    const Handle(XCAFDoc_ShapeTool) shapes = readBack(path);
+    TDF_LabelSequence roots;
+    shapes->GetFreeShapes(roots);
+    ASSERT_EQ(roots.Length(), 1);
+    ASSERT_TRUE(XCAFDoc_ShapeTool::IsAssembly(roots(1)));
+    EXPECT_EQ(nameOf(roots(1)), "Pattern");
+    EXPECT_EQ(countParts(shapes), 1);
+
+    TDF_LabelSequence components;
+    XCAFDoc_ShapeTool::GetComponents(roots(1), components);
+    ASSERT_EQ(components.Length(), kInstances);
+
+    TDF_Label definition;
+    ASSERT_TRUE(XCAFDoc_ShapeTool::GetReferredShape(components(1), definition));
+    EXPECT_EQ(nameOf(definition), "Bracket 1");
+
+    // Every instance refers to the one definition, and together they
+    // put a copy where each body was
+    std::vector<bool> placed(kInstances, false);
+    std::set<std::string> names;
+    for (int i = 1; i <= components.Length(); ++i) {
+        TDF_Label referred;
+        ASSERT_TRUE(XCAFDoc_ShapeTool::GetReferredShape(components(i), referred));
+        EXPECT_TRUE(referred.IsEqual(definition)) << "component " << i;
+        names.insert(nameOf(components(i)));
+
+        const gp_Pnt centre = centreOfMass(XCAFDoc_ShapeTool::GetShape(components(i)));
+        for (int b = 0; b < kInstances; ++b) {
+            if (centre.Distance(centreOfMass(bodies[b].shape)) < 1e-6) placed[b] = true;
+        }
+    }
+    for (int b = 0; b < kInstances; ++b) {
+        EXPECT_TRUE(placed[b]) << bodies[b].name;
+        EXPECT_EQ(names.count(bodies[b].name), 1u) << bodies[b].name;
+    }
+
+    Quantity_Color color;
+    ASSERT_TRUE(colorOf(definition, &color));
+    double red = 0.0, green = 0.0, blue = 0.0;
+    color.Values(red, green, blue, Quantity_TOC_sRGB);
+    EXPECT_NEAR(red, 0.8, 1e-3);
+    EXPECT_NEAR(green, 0.4, 1e-3);
+    EXPECT_NEAR(blue, 0.1, 1e-3);
+}
+
+TEST_F(StepAssemblyTest, SharedDefinitionShrinksTheFile)
+{
+    const std::vector<step_io::AssemblyBody> bodies = patternBodies();
+    std::vector<TopoDS_Shape> shapes;
+    for (const step_io::AssemblyBody& body : bodies) shapes.push_back(body.shape);
+
+    const std::string flatPath = tempPath("flat");
+    ASSERT_TRUE(step_io::writeStep(flatPath, shapes).success);
+    const std::string assemblyPath = tempPath("assembly");
+    ASSERT_TRUE(step_io::writeStepAssembly(assemblyPath, bodies).success);
+
+    // The flat file repeats the curved-face geometry once per body; the
+    // assembly holds it once plus a placement per instance
+    const auto flat = std::filesystem::file_size(flatPath);
+    const auto assembly = std::filesystem::file_size(assemblyPath);
+    std::printf("flat %ju bytes, assembly %ju bytes for %d bodies\n",
+                static_cast<std::uintmax_t>(flat), static_cast<std::uintmax_t>(assembly), kInstances);
+    EXPECT_LT(assembly * 2, flat);
+
+    // The flat file holds every body as a root of its own
+    const step_io::ReadResult flatRead = step_io::readStep(flatPath);
+    ASSERT_TRUE(flatRead.success) << flatRead.errorMessage;
+    EXPECT_EQ(flatRead.shapeCount, kInstances);
+}
+
+// ---- Distinct parts -------------------------------------------------
+
+TEST_F(StepAssemblyTest, MirroredBodiesAreSeparateParts)
+{
+    // A wedge with its top face off centre has no mirror symmetry, so
+    // its mirror image cannot be placed by a rigid motion
+    const TopoDS_Shape wedge = BRepPrimAPI_MakeWedge(10.0, 10.0, 10.0, 2.0, 3.0, 5.0, 9.0).Shape();
+    gp_Trsf mirror;
+    mirror.SetMirror(gp_Ax2(gp_Pnt(-20.0, 0.0, 0.0), gp_Dir(1, 0, 0)));
+
+    std::vector<step_io::AssemblyBody> bodies(6);
+    for (int i = 0; i < 4; ++i) {
+        bodies[i].shape = BRepBuilderAPI_Transform(wedge, patternPlacement(i), Standard_True).Shape();
+    }
+    // One mirror image baked into its geometry, one under a mirroring
+    // location; both have the same handedness, so they share a part
+    bodies[4].shape = BRepBuilderAPI_Transform(wedge, mirror, Standard_True).Shape();
+    gp_Trsf lift;
+    lift.SetTranslation(gp_Vec(0.0, 0.0, 30.0));
+    bodies[5].shape = wedge.Moved(TopLoc_Location(lift * mirror));
+
+    const std::string path = tempPath("mirrored");
+    const step_io::WriteResult written = step_io::writeStepAssembly(path, bodies);
+    ASSERT_TRUE(written.success) << written.errorMessage;
+    EXPECT_EQ(written.partCount, 2);
+    EXPECT_EQ(written.instanceCount, 6);
+
+    const Handle(XCAFDoc_ShapeTool) shapes = readBack(path);
+    EXPECT_EQ(countParts(shapes), 2);
+    TDF_LabelSequence roots;
+    shapes->GetFreeShapes(roots);
+    ASSERT_EQ(roots.Length(), 1);
+    TDF_LabelSequence components;
+    XCAFDoc_ShapeTool::GetComponents(roots(1), components);
+    ASSERT_EQ(components.Length(), 6);
+
+    // Every body, mirrored or not, is where it was
+    for (const step_io::AssemblyBody& body : bodies) {
+        const gp_Pnt expected = centreOfMass(body.shape);
+        bool found = false;
+        for (int i = 1; i <= components.Length(); ++i) {
+            found = found || centreOfMass(XCAFDoc_ShapeTool::GetShape(components(i))).Distance(expected) < 1e-6;
+        }
+        EXPECT_TRUE(found) << expected.X() << ", " << expected.Y() << ", " << expected.Z();
+    }
+}
+
+TEST_F(StepAssemblyTest, DeduplicationOffWritesEveryCopy)
+{
+    step_io::AssemblyOptions options;
+    options.deduplicate = false;
+    const std::string path = tempPath("copies");
+    const step_io::WriteResult written = step_io::writeStepAssembly(path, patternBodies(), options);
+    ASSERT_TRUE(written.success) << written.errorMessage;
+    EXPECT_EQ(written.partCount, kInstances);
+    EXPECT_EQ(written.instanceCount, kInstances);
+    EXPECT_EQ(countParts(readBack(path)), kInstances);
+}
+
+TEST_F(StepAssemblyTest, SingleBodyIsAPlainPart)
+{
+    step_io::AssemblyBody body;
+    body.shape = makePart();
+    body.name = "Bracket";
+    const std::string path = tempPath("single");
+    const step_io::WriteResult written = step_io::writeStepAssembly(path, {body});
+    ASSERT_TRUE(written.success) << written.errorMessage;
+    EXPECT_EQ(written.partCount, 1);
+    EXPECT_EQ(written.instanceCount, 1);
+
+    const Handle(XCAFDoc_ShapeTool) shapes = readBack(path);
+    TDF_LabelSequence roots;
+    shapes->GetFreeShapes(roots);
+    ASSERT_EQ(roots.Length(), 1);
+    EXPECT_TRUE(XCAFDoc_ShapeTool::IsSimpleShape(roots(1)));
+    EXPECT_EQ(nameOf(roots(1)), "Bracket");
+}
+
+TEST_F(StepAssemblyTest, RejectsEmptyInput)
+{
+    const step_io::WriteResult written = step_io::writeStepAssembly(tempPath("empty"), {});
+    EXPECT_FALSE(written.success);
+    EXPECT_FALSE(written.errorMessage.empty());
+}
@@ -0,0 +1,235 @@
+// =====================================================================
+//  tests/test_text.cpp — Text outlines and the glyph cache
+// =====================================================================
+//
+//  Lays out text in Lato Regular, vendored under tests/data/fonts with
+//  its OFL license, and checks glyph contours: counts for letters with
+//  and without counters, exact signed areas against the flattened
+//  polygons, orientation (outer CCW, holes CW), and that scaling,
+//  rotation and synthetic italics transform the areas as they should.
+//  Also checks that the glyph cache decomposes each distinct glyph
+//  once.  Skipped when the library was built without FreeType.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/geometry/utils.h>
+#include <hobbycad/sketch/text.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::sketch;
+
+namespace {
+
+const char* const kFontPath = HOBBYCAD_TEST_DATA_DIR "/fonts/Lato-Regular.ttf";
+
+constexpr double kSize = 10.0;          ///< Em size in mm
+
+class TextTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        if (!textOutlinesAvailable()) {
+            GTEST_SKIP() << "Built without FreeType";
+        }
+        // Each file is indexed once per process; later adds report false
+        static std::string error;
+        static const bool added = addFontFile(kFontPath, &error);
+        ASSERT_TRUE(added) << error;
+        m_style.fontFamily = "Lato";
+    }
+
+    TextOutline layout(const std::string& text, double size = kSize, double rotation = 0.0) const
+    {
+        TextOutline outline = layoutText(text, {0.0, 0.0}, m_style, size, rotation);
+        EXPECT_TRUE(outline.success) << outline.errorMessage;
+        EXPECT_FALSE(outline.fontSubstituted);
+        return outline;
+    }
+
+    TextStyle m_style;
+};
+
+int countHoles(const TextOutline& outline)
+{
+    int holes = 0;
+    for (const OutlineContour& c : outline.contours) holes += c.isHole ? 1 : 0;
+    return holes;
+}
+
+double netArea(const TextOutline& outline)
+{
+    double area = 0.0;
+    for (const OutlineContour& c : outline.contours) area += c.area;
+    return area;
+}
+
+}  // anonymous namespace
+
+// ---- Contours -------------------------------------------------------
+
+TEST_F(TextTest, ContourCountsFollowCounters)
+{
+    struct Case {
+        const char* text;
+        int contours;
+        int holes;
+    };
+    for (const Case& c : {Case{"B", 3, 2}, Case{"o", 2, 1}, Case{"A", 2, 1}, Case{"8", 3, 2},
+                          Case{"l", 1, 0}, Case{"i", 2, 0}, Case{"%", 5, 2}}) {
+        SCOPED_TRACE(c.text);
+        const TextOutline outline = layout(c.text);
+        EXPECT_EQ(static_cast<int>(outline.contours.size()), c.contours);
+        EXPECT_EQ(countHoles(outline), c.holes);
+        EXPECT_EQ(outline.glyphCount, 1);
+    }
+}
+
+TEST_F(TextTest, AreasAndOrientation)
+{
+    const TextOutline outline = layout("Bo8%gQ");
+    ASSERT_FALSE(outline.contours.empty());
+    for (size_t i = 0; i < outline.contours.size(); ++i) {
+        SCOPED_TRACE("contour " + std::to_string(i));
+        const OutlineContour& c = outline.contours[i];
+
+        // Outer contours run CCW and holes CW
+        EXPECT_EQ(c.area < 0.0, c.isHole);
+
+        // The exact Bézier area matches a fine flattening of the contour
+        const std::vector<Point2D> polygon = contourToPolygon(c, 1e-4);
+        EXPECT_NEAR(geometry::polygonArea(polygon), c.area, 1e-3 * std::abs(c.area));
+
+        // Contours close on themselves
+        EXPECT_LT(geometry::length(c.segments.back().end - c.segments.front().start), 1e-9);
+        for (size_t k = 1; k < c.segments.size(); ++k) {
+            EXPECT_LT(geometry::length(c.segments[k].start - c.segments[k - 1].end), 1e-9);
+        }
+    }
+
+    // Each hole lies within an outer contour of the same glyph that is
+    // larger than it
+    for (const OutlineContour& hole : outline.contours) {
+        if (!hole.isHole) continue;
+        bool enclosed = false;
+        for (const OutlineContour& outer : outline.contours) {
+            if (outer.isHole || outer.glyph != hole.glyph || outer.area <= -hole.area) continue;
+            enclosed = enclosed || geometry::pointInPolygon(hole.segments[0].start, contourToPolygon(outer, 1e-3));
+        }
+        EXPECT_TRUE(enclosed) << "hole in glyph " << hole.glyph;
+    }
+}
+
+TEST_F(TextTest, TransformsKeepOrScaleArea)
+{
+    const double base = netArea(layout("Bo"));
+    EXPECT_GT(base, 0.0);
+
+    // Area grows with the square of the size; rotation keeps it
+    EXPECT_NEAR(netArea(layout("Bo", 2.0 * kSize)), 4.0 * base, 1e-9 * base);
+    const TextOutline upright = layout("Bo");
+    const TextOutline rotated = layout("Bo", kSize, 90.0);
+    EXPECT_NEAR(netArea(rotated), base, 1e-9 * base);
+
+    // A quarter turn maps (x, y) to (-y, x)
+    EXPECT_NEAR(rotated.bounds.minX, -upright.bounds.maxY, 1e-9);
+    EXPECT_NEAR(rotated.bounds.maxX, -upright.bounds.minY, 1e-9);
+    EXPECT_NEAR(rotated.bounds.minY, upright.bounds.minX, 1e-9);
+    EXPECT_NEAR(rotated.bounds.maxY, upright.bounds.maxX, 1e-9);
+
+    // A synthetic slant shears, which keeps area; bold adds to it
+    m_style.italic = true;
+    EXPECT_NEAR(netArea(layout("Bo")), base, 1e-9 * base);
+    m_style.italic = false;
+    m_style.bold = true;
+    EXPECT_GT(netArea(layout("Bo")), base * 1.05);
+}
+
+TEST_F(TextTest, LayoutAdvancesAndBreaksLines)
+{
+    const TextOutline one = layout("o");
+    const TextOutline two = layout("o o\no");
+    EXPECT_EQ(two.glyphCount, 4);                       // The space counts
+    ASSERT_EQ(two.contours.size(), 3 * one.contours.size());
+
+    const OutlineContour& first = two.contours[0];
+    const OutlineContour& second = two.contours[one.contours.size()];
+    const OutlineContour& third = two.contours[2 * one.contours.size()];
+    EXPECT_NEAR(first.segments[0].start.y, second.segments[0].start.y, 1e-9);
+    EXPECT_GT(second.segments[0].start.x, first.segments[0].start.x + kSize * 0.5);
+    EXPECT_NEAR(third.segments[0].start.x, first.segments[0].start.x, 1e-9);
+    EXPECT_LT(third.segments[0].start.y, first.segments[0].start.y - kSize * 0.8);
+
+    // A text entity lays out the same as its fields
+    const Entity entity = createText(1, {5.0, 2.0}, "Bo", "Lato", kSize, false, false, 30.0);
+    const TextOutline fromEntity = textOutline(entity);
+    const TextOutline direct = layoutText("Bo", {5.0, 2.0}, m_style, kSize, 30.0);
+    ASSERT_TRUE(fromEntity.success) << fromEntity.errorMessage;
+    ASSERT_EQ(fromEntity.contours.size(), direct.contours.size());
+    EXPECT_EQ(fromEntity.contours[0].segments[0].start, direct.contours[0].segments[0].start);
+}
+
+TEST_F(TextTest, UnknownFamilyIsSubstituted)
+{
+    TextStyle style;
+    style.fontFamily = "No Such Family";
+    const TextOutline outline = layoutText("B", {0.0, 0.0}, style, kSize);
+    ASSERT_TRUE(outline.success) << outline.errorMessage;
+    EXPECT_TRUE(outline.fontSubstituted);
+    EXPECT_EQ(outline.contours.size(), 3u);
+
+    EXPECT_FALSE(layoutText("B", {0.0, 0.0}, m_style, 0.0).success);
+}
+
+// ---- Glyph cache ----------------------------------------------------
+
+TEST_F(TextTest, GlyphCacheDecomposesEachGlyphOnce)
+{
+    clearGlyphCache();
+    GlyphCacheStats stats = glyphCacheStats();
+    EXPECT_EQ(stats.glyphs, 0u);
+    EXPECT_EQ(stats.openFaces, 0u);
+    const size_t hits = stats.hits;
+    const size_t misses = stats.misses;
+
+    layout("oooo");
+    stats = glyphCacheStats();
+    EXPECT_EQ(stats.misses - misses, 1u);
+    EXPECT_EQ(stats.hits - hits, 3u);
+    EXPECT_EQ(stats.glyphs, 1u);
+    EXPECT_EQ(stats.openFaces, 1u);
+
+    // A serial-number plate: a thousand digits, ten distinct glyphs
+    std::string serials;
+    for (int i = 0; i < 1000; ++i) serials += static_cast<char>('0' + (i * 7) % 10);
+    layout(serials);
+    stats = glyphCacheStats();
+    EXPECT_EQ(stats.misses - misses, 11u);
+    EXPECT_EQ(stats.hits - hits, 3u + 990u);
+    EXPECT_EQ(stats.glyphs, 11u);
+
+    // A synthetic bold glyph is cached apart from the regular one
+    m_style.bold = true;
+    layout("o");
+    EXPECT_EQ(glyphCacheStats().misses - misses, 12u);
+    EXPECT_EQ(glyphCacheStats().glyphs, 12u);
+
+    // Cleared glyphs are decomposed again, to the same outline
+    m_style.bold = false;
+    const TextOutline before = layout("B");
+    clearGlyphCache();
+    EXPECT_EQ(glyphCacheStats().glyphs, 0u);
+    const TextOutline after = layout("B");
+    ASSERT_EQ(after.contours.size(), before.contours.size());
+    for (size_t i = 0; i < after.contours.size(); ++i) {
+        EXPECT_EQ(after.contours[i].area, before.contours[i].area);
+    }
+    EXPECT_EQ(glyphCacheStats().glyphs, 1u);
+}
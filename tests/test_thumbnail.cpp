@@ -0,0 +1,240 @@
+// =====================================================================
+//  tests/test_thumbnail.cpp — Headless thumbnail renderer
+// =====================================================================
+//
+//  Renders a box and a cylinder from every ViewDirection at 64x64 and
+//  compares each image with a reference PNG in tests/data/thumbnails
+//  through compareImages.  The tolerance absorbs anti-aliasing along
+//  silhouettes, where a different BRepMesh tessellation moves a few
+//  edge pixels, but not a shape seen from the wrong side: the cylinder
+//  seam on +X makes its side views distinct.  Also checks that tiles
+//  shaded in parallel give exactly the serial image.
+//
+//  After an intentional change to the renderer, regenerate the
+//  references with HOBBYCAD_UPDATE_REFERENCES=1 (see tests/README.txt)
+//  and review the new images before committing them.
+//
+//  SPDX-License-Identifier: GPL-3.0-only
+//
+// =====================================================================
+
+#include <hobbycad/png_writer.h>
+#include <hobbycad/thumbnail.h>
+
+#include <gtest/gtest.h>
+
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <TopoDS_Shape.hxx>
+
+#include <png.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace hobbycad;
+using namespace hobbycad::thumbnail;
+
+namespace {
+
+constexpr int kSize = 64;                  ///< Reference images are kSize x kSize
+constexpr int kChannelTolerance = 48;      ///< Per-channel slack before a pixel counts
+constexpr int kMaxDifferingPixels = kSize * kSize / 50;
+constexpr double kMaxMeanChannelError = 3.0;
+
+const ViewDirection kViews[] = {
+    ViewDirection::Isometric, ViewDirection::Front, ViewDirection::Back,
+    ViewDirection::Left,      ViewDirection::Right, ViewDirection::Top,
+    ViewDirection::Bottom,    ViewDirection::Custom,
+};
+
+TopoDS_Shape makeBox()
+{
+    // Unequal sides so the front, side and top views differ
+    return BRepPrimAPI_MakeBox(40.0, 25.0, 15.0).Shape();
+}
+
+TopoDS_Shape makeCylinder()
+{
+    return BRepPrimAPI_MakeCylinder(10.0, 30.0).Shape();
+}
+
+RenderOptions optionsFor(ViewDirection view)
+{
+    RenderOptions options;
+    options.width = kSize;
+    options.height = kSize;
+    options.view = view;
+    options.azimuth = 30.0;     // Custom only
+    options.elevation = 20.0;
+    return options;
+}
+
+ImageBuffer render(const TopoDS_Shape& shape, const RenderOptions& options)
+{
+    RenderResult result = renderShapes({shape}, options);
+    EXPECT_TRUE(result.success) << result.errorMessage;
+    EXPECT_GT(result.triangleCount, 0);
+    EXPECT_GT(result.segmentCount, 0);
+    return result.image;
+}
+
+std::string referencePath(const std::string& name)
+{
+    return std::string(HOBBYCAD_TEST_DATA_DIR) + "/thumbnails/" + name + ".png";
+}
+
+/// Decode a PNG to RGBA (empty buffer if the file is missing or bad)
+ImageBuffer readPng(const std::string& path)
+{
+    png_image png{};
+    png.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_file(&png, path.c_str())) return {};
+
+    png.format = PNG_FORMAT_RGBA;
+    ImageBuffer image = ImageBuffer::create(static_cast<int>(png.width),
+                                            static_cast<int>(png.height));
+    if (!png_image_finish_read(&png, nullptr, image.pixels.data(), 0, nullptr)) {
+        png_image_free(&png);
+        return {};
+    }
+    return image;
+}
+
+bool updatingReferences()
+{
+    const char* value = std::getenv("HOBBYCAD_UPDATE_REFERENCES");
+    return value && *value && std::string(value) != "0";
+}
+
+void expectMatchesReference(const ImageBuffer& image, const std::string& name)
+{
+    const std::string path = referencePath(name);
+    if (updatingReferences()) {
+        std::string error;
+        EXPECT_TRUE(writePng(path, image, &error)) << error;
+        return;
+    }
+
+    ImageBuffer reference = readPng(path);
+    ASSERT_TRUE(reference.isValid())
+        << "Cannot read " << path << "; run with HOBBYCAD_UPDATE_REFERENCES=1 to create it";
+
+    ImageDifference diff = compareImages(image, reference, kChannelTolerance);
+    ASSERT_TRUE(diff.sameSize) << name;
+    EXPECT_LE(diff.differingPixels, kMaxDifferingPixels) << name;
+    EXPECT_LE(diff.meanChannelError, kMaxMeanChannelError) << name;
+}
+
+void expectViewsMatchReferences(const TopoDS_Shape& shape, const std::string& shapeName)
+{
+    for (ViewDirection view : kViews) {
+        SCOPED_TRACE(viewDirectionName(view));
+        ImageBuffer image = render(shape, optionsFor(view));
+        ASSERT_TRUE(image.isValid());
+        EXPECT_EQ(image.width, kSize);
+        EXPECT_EQ(image.height, kSize);
+        expectMatchesReference(image, shapeName + "_" + viewDirectionName(view));
+    }
+}
+
+}  // anonymous namespace
+
+// ---- Reference images -----------------------------------------------
+
+TEST(Thumbnail, BoxMatchesReferenceInEveryView)
+{
+    expectViewsMatchReferences(makeBox(), "box");
+}
+
+TEST(Thumbnail, CylinderMatchesReferenceInEveryView)
+{
+    expectViewsMatchReferences(makeCylinder(), "cylinder");
+}
+
+TEST(Thumbnail, OppositeSideViewsOfTheCylinderDiffer)
+{
+    // The seam edge faces the Right view and hides from the Left one,
+    // so comparing them shows the tolerance still catches a wrong view
+    TopoDS_Shape cylinder = makeCylinder();
+    ImageBuffer left = render(cylinder, optionsFor(ViewDirection::Left));
+    ImageBuffer right = render(cylinder, optionsFor(ViewDirection::Right));
+
+    ImageDifference diff = compareImages(left, right, kChannelTolerance);
+    ASSERT_TRUE(diff.sameSize);
+    EXPECT_GT(diff.differingPixels, kMaxDifferingPixels);
+}
+
+// ---- Rendering ------------------------------------------------------
+
+TEST(Thumbnail, ParallelTilesMatchSerial)
+{
+    for (const TopoDS_Shape& shape : {makeBox(), makeCylinder()}) {
+        for (ViewDirection view : kViews) {
+            SCOPED_TRACE(viewDirectionName(view));
+            RenderOptions options = optionsFor(view);
+            options.tileSize = 16;
+            options.parallel = false;
+            ImageBuffer serial = render(shape, options);
+            options.parallel = true;
+            ImageBuffer parallel = render(shape, options);
+
+            ImageDifference diff = compareImages(serial, parallel);
+            ASSERT_TRUE(diff.sameSize);
+            EXPECT_EQ(diff.differingPixels, 0);
+        }
+    }
+}
+
+TEST(Thumbnail, BackgroundStaysTransparentAroundTheBody)
+{
+    ImageBuffer image = render(makeBox(), optionsFor(ViewDirection::Front));
+    ASSERT_TRUE(image.isValid());
+
+    // The default 5% margin keeps the corners clear; the centre is body
+    EXPECT_EQ(image.alpha(0, 0), 0);
+    EXPECT_EQ(image.alpha(kSize - 1, kSize - 1), 0);
+    EXPECT_EQ(image.alpha(kSize / 2, kSize / 2), 255);
+}
+
+TEST(Thumbnail, RejectsInvalidSize)
+{
+    RenderOptions options = optionsFor(ViewDirection::Isometric);
+    options.width = 0;
+    RenderResult result = renderShapes({makeBox()}, options);
+    EXPECT_FALSE(result.success);
+    EXPECT_FALSE(result.errorMessage.empty());
+}
+
+// ---- Helpers --------------------------------------------------------
+
+TEST(Thumbnail, CompareImagesCountsPixelsBeyondTolerance)
+{
+    ImageBuffer a = ImageBuffer::create(4, 4);
+    ImageBuffer b = ImageBuffer::create(4, 4);
+    b.setPixel(1, 1, 10, 0, 0, 0);
+    b.setPixel(2, 3, 0, 0, 200, 0);
+
+    ImageDifference diff = compareImages(a, b, 10);
+    EXPECT_TRUE(diff.sameSize);
+    EXPECT_EQ(diff.differingPixels, 1);
+    EXPECT_EQ(diff.maxChannelError, 200);
+    EXPECT_DOUBLE_EQ(diff.meanChannelError, 210.0 / 64.0);
+
+    EXPECT_FALSE(compareImages(a, ImageBuffer::create(4, 5)).sameSize);
+}
+
+TEST(Thumbnail, ViewNamesRoundTrip)
+{
+    for (ViewDirection view : kViews) {
+        ViewDirection parsed = ViewDirection::Custom;
+        EXPECT_TRUE(viewDirectionFromName(viewDirectionName(view), &parsed));
+        EXPECT_EQ(parsed, view);
+    }
+
+    ViewDirection parsed = ViewDirection::Front;
+    EXPECT_TRUE(viewDirectionFromName("Isometric", &parsed));
+    EXPECT_EQ(parsed, ViewDirection::Isometric);
+    EXPECT_FALSE(viewDirectionFromName("sideways", &parsed));
+}